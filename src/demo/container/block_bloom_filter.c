@@ -0,0 +1,186 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * test
+ */
+static tb_void_t tb_demo_test_perf(tb_size_t probability, tb_size_t count)
+{
+    // make the keys, the first half will be inserted and the second half is used to compute the false positives
+    tb_long_t* keys = tb_nalloc_type(count << 1, tb_long_t);
+    tb_assert_and_check_return(keys);
+    tb_size_t i = 0;
+    for (i = 0; i < (count << 1); i++) keys[i] = (tb_long_t)(i * 0x9e3779b1 + 1);
+
+    // init filters
+    tb_bloom_filter_ref_t       filter = tb_bloom_filter_init(probability, 3, count, tb_element_long());
+    tb_block_bloom_filter_ref_t bfilter = tb_block_bloom_filter_init(TB_BLOCK_BLOOM_FILTER_MODE_NONE, probability, count, tb_element_long());
+    if (filter && bfilter)
+    {
+        // set the classic filter
+        tb_hong_t t = tb_mclock();
+        for (i = 0; i < count; i++) tb_bloom_filter_set(filter, (tb_cpointer_t)keys[i]);
+        tb_hong_t t_set = tb_mclock() - t;
+
+        // get the classic filter
+        tb_size_t fp = 0;
+        t = tb_mclock();
+        for (i = count; i < (count << 1); i++) if (tb_bloom_filter_get(filter, (tb_cpointer_t)keys[i])) fp++;
+        tb_hong_t t_get = tb_mclock() - t;
+
+        // trace
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+        tb_trace_i("bloom_filter: p: 1/2^%lu, set: %lld ms, get: %lld ms, fpp: %lf", probability, t_set, t_get, (tb_double_t)fp / count);
+#else
+        tb_trace_i("bloom_filter: p: 1/2^%lu, set: %lld ms, get: %lld ms, fp: %lu", probability, t_set, t_get, fp);
+#endif
+
+        // set the block filter
+        t = tb_mclock();
+        for (i = 0; i < count; i++) tb_block_bloom_filter_set(bfilter, (tb_cpointer_t)keys[i]);
+        t_set = tb_mclock() - t;
+
+        // get the block filter
+        fp = 0;
+        t = tb_mclock();
+        for (i = count; i < (count << 1); i++) if (tb_block_bloom_filter_get(bfilter, (tb_cpointer_t)keys[i])) fp++;
+        t_get = tb_mclock() - t;
+
+        // get the block filter with the list
+        t = tb_mclock();
+        tb_size_t fp_list = tb_block_bloom_filter_get_list(bfilter, (tb_cpointer_t const*)(keys + count), count, tb_null);
+        tb_hong_t t_list = tb_mclock() - t;
+
+        // all inserted keys must exist
+        tb_assert(tb_block_bloom_filter_get_list(bfilter, (tb_cpointer_t const*)keys, count, tb_null) == count);
+
+        // trace
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+        tb_trace_i("block_bloom_filter: p: 1/2^%lu, set: %lld ms, get: %lld ms, get_list: %lld ms, fpp: %lf, fpp_list: %lf", probability, t_set, t_get, t_list, (tb_double_t)fp / count, (tb_double_t)fp_list / count);
+#else
+        tb_trace_i("block_bloom_filter: p: 1/2^%lu, set: %lld ms, get: %lld ms, get_list: %lld ms, fp: %lu, fp_list: %lu", probability, t_set, t_get, t_list, fp, fp_list);
+#endif
+    }
+
+    // exit filters
+    if (filter) tb_bloom_filter_exit(filter);
+    if (bfilter) tb_block_bloom_filter_exit(bfilter);
+    tb_free(keys);
+}
+static tb_void_t tb_demo_test_counting()
+{
+    // init filter
+    tb_block_bloom_filter_ref_t filter = tb_block_bloom_filter_init(TB_BLOCK_BLOOM_FILTER_MODE_COUNTING, TB_BLOOM_FILTER_PROBABILITY_0_001, 10000, tb_element_str(tb_true));
+    if (filter)
+    {
+        // set items
+        tb_size_t i = 0;
+        tb_char_t s[64] = {0};
+        for (i = 0; i < 10000; i++)
+        {
+            tb_snprintf(s, sizeof(s) - 1, "item_%lu", i);
+            tb_block_bloom_filter_set(filter, s);
+        }
+
+        // remove the even items
+        tb_size_t removed = 0;
+        for (i = 0; i < 10000; i += 2)
+        {
+            tb_snprintf(s, sizeof(s) - 1, "item_%lu", i);
+            if (tb_block_bloom_filter_del(filter, s)) removed++;
+        }
+
+        // check them
+        tb_size_t odd = 0;
+        tb_size_t even = 0;
+        for (i = 0; i < 10000; i++)
+        {
+            tb_snprintf(s, sizeof(s) - 1, "item_%lu", i);
+            if (tb_block_bloom_filter_get(filter, s)) 
+            {
+                if (i & 1) odd++;
+                else even++;
+            }
+        }
+
+        // trace
+        tb_trace_i("counting: size: %lu, removed: %lu, odd: %lu/5000, even (false positives): %lu", tb_block_bloom_filter_size(filter), removed, odd, even);
+
+        // exit filter
+        tb_block_bloom_filter_exit(filter);
+    }
+}
+static tb_void_t tb_demo_test_scalable()
+{
+    // init filter with a small capacity
+    tb_block_bloom_filter_ref_t filter = tb_block_bloom_filter_init(TB_BLOCK_BLOOM_FILTER_MODE_SCALABLE, TB_BLOOM_FILTER_PROBABILITY_0_01, 1000, tb_element_size());
+    if (filter)
+    {
+        // set items
+        tb_size_t i = 0;
+        tb_size_t n = 1000000;
+        for (i = 0; i < n; i++) tb_block_bloom_filter_set(filter, (tb_cpointer_t)(i + 1));
+
+        // check them
+        tb_size_t ok = 0;
+        for (i = 0; i < n; i++) if (tb_block_bloom_filter_get(filter, (tb_cpointer_t)(i + 1))) ok++;
+
+        // compute the false positives
+        tb_size_t fp = 0;
+        for (i = 0; i < n; i++) if (tb_block_bloom_filter_get(filter, (tb_cpointer_t)(i + n + 1))) fp++;
+
+        // trace
+        tb_trace_i("scalable: size: %lu, exists: %lu/%lu, false positives: %lu", tb_block_bloom_filter_size(filter), ok, n, fp);
+
+        // save it
+        tb_long_t size = tb_block_bloom_filter_save(filter, tb_null, 0);
+        if (size > 0)
+        {
+            tb_byte_t* data = tb_malloc_bytes(size);
+            if (data && tb_block_bloom_filter_save(filter, data, size) == size)
+            {
+                // load it
+                tb_block_bloom_filter_ref_t loaded = tb_block_bloom_filter_init_from_data(data, size, tb_element_size());
+                if (loaded)
+                {
+                    // check them
+                    tb_size_t ok2 = 0;
+                    tb_size_t fp2 = 0;
+                    for (i = 0; i < n; i++) if (tb_block_bloom_filter_get(loaded, (tb_cpointer_t)(i + 1))) ok2++;
+                    for (i = 0; i < n; i++) if (tb_block_bloom_filter_get(loaded, (tb_cpointer_t)(i + n + 1))) fp2++;
+
+                    // trace
+                    tb_trace_i("scalable: saved: %ld bytes, loaded: size: %lu, exists: %lu/%lu, false positives: %lu", size, tb_block_bloom_filter_size(loaded), ok2, n, fp2);
+
+                    // exit it
+                    tb_block_bloom_filter_exit(loaded);
+                }
+            }
+            if (data) tb_free(data);
+        }
+
+        // exit filter
+        tb_block_bloom_filter_exit(filter);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_container_block_bloom_filter_main(tb_int_t argc, tb_char_t** argv)
+{
+    tb_trace_i("===========================================================");
+    tb_demo_test_perf(TB_BLOOM_FILTER_PROBABILITY_0_01, 1000000);
+    tb_demo_test_perf(TB_BLOOM_FILTER_PROBABILITY_0_001, 1000000);
+    tb_demo_test_perf(TB_BLOOM_FILTER_PROBABILITY_0_0001, 1000000);
+    tb_demo_test_perf(TB_BLOOM_FILTER_PROBABILITY_0_001, 10000000);
+
+    tb_trace_i("===========================================================");
+    tb_demo_test_counting();
+
+    tb_trace_i("===========================================================");
+    tb_demo_test_scalable();
+    return 0;
+}
@@ -0,0 +1,137 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default coroutine count
+#define TB_DEMO_FILE_COUNT      (8)
+
+// the default rounds for each coroutine
+#define TB_DEMO_FILE_ROUNDS     (100)
+
+// the block size
+#define TB_DEMO_FILE_BLOCK      (65536)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the file path prefix
+static tb_char_t const* g_prefix = "/tmp/tbox_file_offload";
+
+// the rounds
+static tb_size_t        g_rounds = TB_DEMO_FILE_ROUNDS;
+
+// the running file coroutines
+static tb_size_t        g_running = 0;
+
+// the failed count
+static tb_size_t        g_failed = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_file_func(tb_cpointer_t priv)
+{
+    // init data
+    tb_byte_t* data = tb_malloc_bytes(TB_DEMO_FILE_BLOCK << 1);
+    tb_assert_and_check_return(data);
+    tb_memset(data, (tb_int_t)(tb_size_t)priv, TB_DEMO_FILE_BLOCK);
+
+    // init file
+    tb_char_t path[TB_PATH_MAXN];
+    tb_snprintf(path, sizeof(path), "%s_%lu", g_prefix, (tb_size_t)priv);
+    tb_file_ref_t file = tb_file_init(path, TB_FILE_MODE_RW | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC);
+    if (file)
+    {
+        /* write, sync and read it back, all blocking file io will be offloaded to the io workers
+         * and only the current coroutine will be suspended
+         */
+        tb_size_t i = 0;
+        for (i = 0; i < g_rounds; i++)
+        {
+            tb_hize_t offset = (tb_hize_t)(i & 15) * TB_DEMO_FILE_BLOCK;
+            if (tb_file_pwrit(file, data, TB_DEMO_FILE_BLOCK, offset) != TB_DEMO_FILE_BLOCK) break;
+            if (!tb_file_sync(file)) break;
+            if (tb_file_pread(file, data + TB_DEMO_FILE_BLOCK, TB_DEMO_FILE_BLOCK, offset) != TB_DEMO_FILE_BLOCK) break;
+            if (tb_memcmp(data, data + TB_DEMO_FILE_BLOCK, TB_DEMO_FILE_BLOCK)) break;
+        }
+        if (i != g_rounds) g_failed++;
+
+        // exit file
+        tb_file_exit(file);
+        tb_file_remove(path);
+    }
+    else g_failed++;
+
+    // exit data
+    tb_free(data);
+    g_running--;
+}
+static tb_void_t tb_demo_file_ticker(tb_cpointer_t priv)
+{
+    // the scheduler will not be blocked by the file io, so the 1ms ticks will be on time
+    tb_size_t ticks = 0;
+    tb_hong_t lag_max = 0;
+    tb_hong_t lag_total = 0;
+    while (g_running)
+    {
+        tb_hong_t time = tb_uclock();
+        tb_coroutine_sleep(1);
+        tb_hong_t lag = tb_max(tb_uclock() - time - 1000, 0);
+        if (lag > lag_max) lag_max = lag;
+        lag_total += lag;
+        ticks++;
+    }
+
+    // trace
+    tb_trace_i("[ticker]: ticks: %lu, lag: %lld us (avg), %lld us (max)", ticks, ticks? lag_total / (tb_hong_t)ticks : 0, lag_max);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_file_offload_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the coroutine count and rounds
+    tb_size_t count = argc > 1? tb_atoi(argv[1]) : TB_DEMO_FILE_COUNT;
+    if (argc > 2) g_rounds = tb_atoi(argv[2]);
+    if (argc > 3) g_prefix = argv[3];
+    tb_assert_and_check_return_val(count && g_rounds, -1);
+
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // start coroutines
+        tb_size_t i = 0;
+        g_running = count;
+        for (i = 0; i < count; i++)
+            tb_coroutine_start(scheduler, tb_demo_file_func, (tb_cpointer_t)(i + 1), 0);
+        tb_coroutine_start(scheduler, tb_demo_file_ticker, tb_null, 0);
+
+        // run scheduler
+        tb_hong_t time = tb_mclock();
+        tb_co_scheduler_loop(scheduler, tb_true);
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("[file]: coroutines: %lu, rounds: %lu, failed: %lu, %lld ms", count, g_rounds, g_failed, time);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+
+    // dump the offload statistics
+    tb_file_offload_stats_t stats;
+    if (tb_file_offload_stats(&stats))
+    {
+        tb_trace_i("[offload]: workers: %lu, total: %llu, queue_peak: %lu, latency: %llu us (avg), %llu us (max)"
+            , stats.workers, stats.total, stats.queue_peak, stats.total? stats.latency / stats.total : 0, stats.latency_peak);
+    }
+    return 0;
+}
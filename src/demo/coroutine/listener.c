@@ -0,0 +1,161 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */ 
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */ 
+
+// the client thread count
+#define TB_DEMO_CLIENTS     (4)
+
+// timeout
+#define TB_DEMO_TIMEOUT     (5000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */ 
+
+// the demo context type
+typedef struct __tb_demo_context_t
+{
+    // the server address
+    tb_ipaddr_t         addr;
+
+    // the connection count of each client
+    tb_size_t           count;
+
+    // the accepted connection count
+    tb_atomic_t         accepted;
+
+    // the finished connection count of all clients
+    tb_atomic_t         finished;
+
+}tb_demo_context_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */ 
+static tb_void_t tb_demo_listener_conn(tb_socket_ref_t sock, tb_cpointer_t priv)
+{
+    // check
+    tb_demo_context_t* context = (tb_demo_context_t*)priv;
+    tb_assert_and_check_return(context);
+
+    // accept it and close it immediately after returning
+    tb_atomic_fetch_and_inc(&context->accepted);
+}
+static tb_bool_t tb_demo_listener_client_once(tb_ipaddr_ref_t addr)
+{
+    // init socket
+    tb_socket_ref_t sock = tb_socket_init(TB_SOCKET_TYPE_TCP, tb_ipaddr_family(addr));
+    tb_assert_and_check_return_val(sock, tb_false);
+
+    // done
+    tb_bool_t ok = tb_false;
+    do
+    {
+        // connect it
+        tb_long_t real = 0;
+        while (!(real = tb_socket_connect(sock, addr)))
+        {
+            if (tb_socket_wait(sock, TB_SOCKET_EVENT_CONN, TB_DEMO_TIMEOUT) <= 0) break;
+        }
+        tb_check_break(real > 0);
+
+        // wait the server to close it first, so the client port will not be kept by TIME_WAIT
+        tb_byte_t data[16];
+        while (!(real = tb_socket_recv(sock, data, sizeof(data))))
+        {
+            if (tb_socket_wait(sock, TB_SOCKET_EVENT_RECV, TB_DEMO_TIMEOUT) <= 0) break;
+            if (!(real = tb_socket_recv(sock, data, sizeof(data)))) real = -1;
+            break;
+        }
+        tb_check_break(real < 0);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // exit socket
+    tb_socket_exit(sock);
+    return ok;
+}
+static tb_int_t tb_demo_listener_client(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_context_t* context = (tb_demo_context_t*)priv;
+    tb_assert_and_check_return_val(context, -1);
+
+    // connect to the server and wait the server to close it
+    tb_size_t i = 0;
+    for (i = 0; i < context->count; i++)
+    {
+        if (!tb_demo_listener_client_once(&context->addr)) break;
+        tb_atomic_fetch_and_inc(&context->finished);
+    }
+    return 0;
+}
+static tb_void_t tb_demo_listener_bench(tb_size_t workers, tb_size_t flags, tb_size_t count)
+{
+    // init context
+    tb_demo_context_t context;
+    tb_memset(&context, 0, sizeof(context));
+    context.count = count / TB_DEMO_CLIENTS;
+
+    // init listener
+    tb_ipaddr_t addr;
+    tb_ipaddr_set(&addr, "127.0.0.1", 0, TB_IPADDR_FAMILY_IPV4);
+    tb_co_listener_ref_t listener = tb_co_listener_init(&addr, workers, flags, tb_demo_listener_conn, &context);
+    if (listener && tb_co_listener_addr(listener, &context.addr) && tb_co_listener_start(listener))
+    {
+        // start clients
+        tb_size_t       i = 0;
+        tb_thread_ref_t clients[TB_DEMO_CLIENTS] = {0};
+        tb_hong_t       time = tb_mclock();
+        for (i = 0; i < TB_DEMO_CLIENTS; i++)
+            clients[i] = tb_thread_init(tb_null, tb_demo_listener_client, &context, 0);
+
+        // wait clients
+        for (i = 0; i < TB_DEMO_CLIENTS; i++)
+        {
+            if (clients[i])
+            {
+                tb_thread_wait(clients[i], -1, tb_null);
+                tb_thread_exit(clients[i]);
+            }
+        }
+        time = tb_max(tb_mclock() - time, 1);
+
+        // trace
+        tb_char_t data[128];
+        tb_size_t finished = (tb_size_t)tb_atomic_get(&context.finished);
+        tb_trace_i("workers: %lu, steer: %s, addr: %s, accepted: %ld, finished: %lu, %lld ms, %lld conns/s"
+                    , tb_co_listener_workers(listener), (flags & TB_CO_LISTENER_FLAG_STEER_CPU)? "cpu" : "none"
+                    , tb_ipaddr_cstr(&context.addr, data, sizeof(data)), tb_atomic_get(&context.accepted)
+                    , finished, time, ((tb_hong_t)finished * 1000) / time);
+    }
+
+    // exit listener
+    if (listener) tb_co_listener_exit(listener);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */ 
+tb_int_t tb_demo_coroutine_listener_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the connection count
+    tb_size_t count = argv[1]? tb_atoi(argv[1]) : 20000;
+
+    // the worker count, using the processor count by default
+    tb_size_t workers = (argv[1] && argv[2])? tb_atoi(argv[2]) : 0;
+
+    // bench one worker and the multiple workers
+    tb_demo_listener_bench(1, TB_CO_LISTENER_FLAG_NONE, count);
+    tb_demo_listener_bench(workers, TB_CO_LISTENER_FLAG_NONE, count);
+    tb_demo_listener_bench(workers, TB_CO_LISTENER_FLAG_STEER_CPU, count);
+    return 0;
+}
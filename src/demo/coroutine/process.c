@@ -0,0 +1,145 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default process count
+#define TB_DEMO_PROCESS_COUNT       (10000)
+
+// the default parallel jobs
+#define TB_DEMO_PROCESS_JOBS        (16)
+
+// the maximum parallel jobs
+#define TB_DEMO_PROCESS_JOBS_MAXN   (64)
+
+/* the wait timeout, we do not wait it infinitely because it will block the whole coroutine scheduler
+ * if the process fd is not supported, and it is also the common usage for supervising the processes
+ */
+#define TB_DEMO_PROCESS_TIMEOUT     (1000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the process argv
+static tb_char_t const* g_argv[] = {"true", tb_null};
+
+// the left process count for coroutines
+static tb_size_t        g_left = 0;
+
+// the finished process count for coroutines
+static tb_size_t        g_finished = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_size_t tb_demo_process_waitlist(tb_size_t count, tb_size_t jobs)
+{
+    // done
+    tb_size_t           started = 0;
+    tb_size_t           finished = 0;
+    tb_size_t           running = 0;
+    tb_process_ref_t    processes[TB_DEMO_PROCESS_JOBS_MAXN + 1] = {0};
+    while (finished < count)
+    {
+        // start processes
+        while (running < jobs && started < count)
+        {
+            tb_process_ref_t process = tb_process_init(g_argv[0], g_argv, tb_null);
+            tb_assert_and_check_break(process);
+            processes[running++] = process;
+            processes[running] = tb_null;
+            started++;
+        }
+        tb_assert_and_check_break(running);
+
+        // wait processes
+        tb_process_waitinfo_t infolist[TB_DEMO_PROCESS_JOBS_MAXN];
+        tb_long_t infosize = tb_process_waitlist(processes, infolist, tb_arrayn(infolist), TB_DEMO_PROCESS_TIMEOUT);
+        tb_assert_and_check_break(infosize >= 0);
+
+        // exit the exited processes
+        tb_long_t i = 0;
+        for (i = 0; i < infosize; i++)
+        {
+            tb_process_exit(infolist[i].process);
+            processes[infolist[i].index] = tb_null;
+        }
+        finished += infosize;
+
+        // compact the process list
+        tb_size_t j = 0;
+        tb_size_t k = 0;
+        for (j = 0; j < running; j++)
+        {
+            if (processes[j]) processes[k++] = processes[j];
+        }
+        processes[k] = tb_null;
+        running = k;
+    }
+    return finished;
+}
+static tb_void_t tb_demo_process_coroutine_func(tb_cpointer_t priv)
+{
+    // spawn and wait processes one by one, it will only suspend the current coroutine
+    while (g_left)
+    {
+        g_left--;
+
+        // init process
+        tb_process_ref_t process = tb_process_init(g_argv[0], g_argv, tb_null);
+        tb_assert_and_check_break(process);
+
+        // wait it
+        tb_long_t ok = 0;
+        tb_long_t status = -1;
+        while (!(ok = tb_process_wait(process, &status, TB_DEMO_PROCESS_TIMEOUT))) ;
+        if (ok > 0 && !status) g_finished++;
+
+        // exit it
+        tb_process_exit(process);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_process_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the process count and parallel jobs
+    tb_size_t count = argc > 1? tb_atoi(argv[1]) : TB_DEMO_PROCESS_COUNT;
+    tb_size_t jobs  = argc > 2? tb_atoi(argv[2]) : TB_DEMO_PROCESS_JOBS;
+    tb_assert_and_check_return_val(count && jobs && jobs <= TB_DEMO_PROCESS_JOBS_MAXN, -1);
+
+    // wait processes in the current thread
+    tb_hong_t time = tb_mclock();
+    tb_size_t finished = tb_demo_process_waitlist(count, jobs);
+    time = tb_mclock() - time;
+    tb_trace_i("[waitlist]: processes: %lu, jobs: %lu, %lld ms, %lld processes/s", finished, jobs, time, time? (tb_hong_t)finished * 1000 / time : 0);
+
+    // wait processes in coroutines
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // start coroutines
+        tb_size_t i = 0;
+        g_left = count;
+        g_finished = 0;
+        for (i = 0; i < jobs; i++)
+            tb_coroutine_start(scheduler, tb_demo_process_coroutine_func, tb_null, 0);
+
+        // run scheduler
+        time = tb_mclock();
+        tb_co_scheduler_loop(scheduler, tb_true);
+        time = tb_mclock() - time;
+        tb_trace_i("[coroutine]: processes: %lu, jobs: %lu, %lld ms, %lld processes/s", g_finished, jobs, time, time? (tb_hong_t)g_finished * 1000 / time : 0);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+    return 0;
+}
@@ -0,0 +1,292 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */ 
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */ 
+
+// port
+#define TB_DEMO_PORT        (9091)
+
+// the datagram size
+#define TB_DEMO_DATA_SIZE   (64)
+
+// the gso segment size
+#define TB_DEMO_SEGSIZE     (1024)
+
+// the receiving timeout after the sender has been finished
+#define TB_DEMO_TIMEOUT     (200)
+
+// the send window, the sender will wait the receiver if there are too many datagrams in flight
+#define TB_DEMO_WINDOW      (8)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */ 
+
+// the demo context type
+typedef struct __tb_demo_context_t
+{
+    // the receiver socket
+    tb_socket_ref_t     sock;
+
+    // the receiver address
+    tb_ipaddr_t         addr;
+
+    // the send window semaphore, one credit for TB_SOCKET_BATCH_MAXN datagrams
+    tb_co_semaphore_ref_t window;
+
+    // use the batched io?
+    tb_bool_t           batch;
+
+    // the datagram count
+    tb_size_t           count;
+
+    // the received count
+    tb_size_t           recv;
+
+    // the start time
+    tb_hong_t           start;
+
+    // the time of the last received datagram
+    tb_hong_t           stop;
+
+}tb_demo_context_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */ 
+static tb_void_t tb_demo_coroutine_sender(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_context_t* context = (tb_demo_context_t*)priv;
+    tb_assert_and_check_return(context);
+
+    // init socket
+    tb_socket_ref_t sock = tb_socket_init(TB_SOCKET_TYPE_UDP, TB_IPADDR_FAMILY_IPV4);
+    tb_assert_and_check_return(sock);
+
+    // init messages
+    tb_size_t       i = 0;
+    tb_byte_t       data[TB_SOCKET_BATCH_MAXN][TB_DEMO_DATA_SIZE];
+    tb_iovec_t      list[TB_SOCKET_BATCH_MAXN];
+    tb_socket_msg_t msgs[TB_SOCKET_BATCH_MAXN];
+    tb_memset(msgs, 0, sizeof(msgs));
+    for (i = 0; i < TB_SOCKET_BATCH_MAXN; i++)
+    {
+        tb_memset(data[i], 'a' + i, TB_DEMO_DATA_SIZE);
+        list[i].data    = data[i];
+        list[i].size    = TB_DEMO_DATA_SIZE;
+        msgs[i].list    = &list[i];
+        msgs[i].size    = 1;
+        msgs[i].addr    = context->addr;
+    }
+
+    // send datagrams
+    tb_size_t sent = 0;
+    while (sent < context->count)
+    {
+        // wait the receiver to avoid overflowing the socket buffer
+        if (tb_co_semaphore_wait(context->window, -1) <= 0) break;
+
+        // send them
+        tb_size_t n = tb_min(context->count - sent, TB_SOCKET_BATCH_MAXN);
+        if (context->batch)
+        {
+            // send them using one system call
+            tb_long_t real = tb_socket_usend_batch_wait(sock, msgs, n, -1);
+            tb_assert_and_check_break(real > 0);
+            sent += real;
+        }
+        else
+        {
+            // send them one by one
+            for (i = 0; i < n; i++)
+            {
+                tb_long_t real = 0;
+                while (!(real = tb_socket_usend(sock, &context->addr, data[i], TB_DEMO_DATA_SIZE)))
+                {
+                    if (tb_socket_wait(sock, TB_SOCKET_EVENT_SEND, -1) <= 0) break;
+                }
+                if (real <= 0) break;
+                sent++;
+            }
+            tb_assert_and_check_break(i == n);
+        }
+    }
+
+    // exit socket
+    tb_socket_exit(sock);
+}
+static tb_void_t tb_demo_coroutine_receiver(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_context_t* context = (tb_demo_context_t*)priv;
+    tb_assert_and_check_return(context && context->sock);
+
+    // init messages
+    tb_size_t       i = 0;
+    tb_byte_t       data[TB_SOCKET_BATCH_MAXN][TB_DEMO_DATA_SIZE];
+    tb_iovec_t      list[TB_SOCKET_BATCH_MAXN];
+    tb_socket_msg_t msgs[TB_SOCKET_BATCH_MAXN];
+    tb_memset(msgs, 0, sizeof(msgs));
+    for (i = 0; i < TB_SOCKET_BATCH_MAXN; i++)
+    {
+        list[i].data    = data[i];
+        list[i].size    = TB_DEMO_DATA_SIZE;
+        msgs[i].list    = &list[i];
+        msgs[i].size    = 1;
+    }
+
+    // recv datagrams until timeout
+    tb_size_t pending = 0;
+    context->start = tb_mclock();
+    while (context->recv < context->count)
+    {
+        if (context->batch)
+        {
+            // recv them using one system call
+            tb_long_t real = tb_socket_urecv_batch_wait(context->sock, msgs, TB_SOCKET_BATCH_MAXN, TB_DEMO_TIMEOUT);
+            if (real <= 0) break;
+            context->recv += real;
+            pending += real;
+        }
+        else
+        {
+            // recv it
+            tb_long_t real = tb_socket_urecv(context->sock, tb_null, data[0], TB_DEMO_DATA_SIZE);
+            if (real > 0) 
+            {
+                context->recv++;
+                pending++;
+            }
+            else if (!real && tb_socket_wait(context->sock, TB_SOCKET_EVENT_RECV, TB_DEMO_TIMEOUT) > 0) continue;
+            else break;
+        }
+        context->stop = tb_mclock();
+
+        // give the send credits back
+        if (pending >= TB_SOCKET_BATCH_MAXN)
+        {
+            tb_co_semaphore_post(context->window, pending / TB_SOCKET_BATCH_MAXN);
+            pending %= TB_SOCKET_BATCH_MAXN;
+        }
+    }
+}
+static tb_void_t tb_demo_udp_batch_bench(tb_bool_t batch, tb_size_t count)
+{
+    // init context
+    tb_demo_context_t context = {0};
+    context.batch = batch;
+    context.count = count;
+
+    // init scheduler and the receiver socket
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    context.sock = tb_socket_init(TB_SOCKET_TYPE_UDP, TB_IPADDR_FAMILY_IPV4);
+    context.window = tb_co_semaphore_init(TB_DEMO_WINDOW);
+    if (scheduler && context.sock && context.window)
+    {
+        // bind socket
+        tb_ipaddr_set(&context.addr, "127.0.0.1", TB_DEMO_PORT, TB_IPADDR_FAMILY_IPV4);
+        tb_socket_ctrl(context.sock, TB_SOCKET_CTRL_SET_RECV_BUFF_SIZE, (tb_size_t)(1024 * 1024));
+        if (tb_socket_bind(context.sock, &context.addr))
+        {
+            // start the receiver and sender
+            tb_coroutine_start(scheduler, tb_demo_coroutine_receiver, &context, 0);
+            tb_coroutine_start(scheduler, tb_demo_coroutine_sender, &context, 0);
+
+            // run scheduler
+            tb_co_scheduler_loop(scheduler, tb_true);
+
+            // trace
+            tb_hong_t time = tb_max(context.stop - context.start, 1);
+            tb_trace_i("%s: recv %lu/%lu datagrams, %lld ms, %lld pps", batch? "batch" : "single", context.recv, count, time, ((tb_hong_t)context.recv * 1000) / time);
+        }
+    }
+
+    // exit socket, semaphore and scheduler
+    if (context.window) tb_co_semaphore_exit(context.window);
+    if (context.sock) tb_socket_exit(context.sock);
+    if (scheduler) tb_co_scheduler_exit(scheduler);
+}
+static tb_void_t tb_demo_udp_batch_gso()
+{
+    // init sockets
+    tb_socket_ref_t sender = tb_socket_init(TB_SOCKET_TYPE_UDP, TB_IPADDR_FAMILY_IPV4);
+    tb_socket_ref_t receiver = tb_socket_init(TB_SOCKET_TYPE_UDP, TB_IPADDR_FAMILY_IPV4);
+    do
+    {
+        // bind the receiver
+        tb_ipaddr_t addr;
+        tb_ipaddr_set(&addr, "127.0.0.1", TB_DEMO_PORT, TB_IPADDR_FAMILY_IPV4);
+        tb_assert_and_check_break(sender && receiver && tb_socket_bind(receiver, &addr));
+
+        // enable gso and gro
+        tb_bool_t gso = tb_socket_ctrl(sender, TB_SOCKET_CTRL_SET_UDP_GSO, (tb_size_t)TB_DEMO_SEGSIZE);
+        tb_bool_t gro = tb_socket_ctrl(receiver, TB_SOCKET_CTRL_SET_UDP_GRO, tb_true);
+        tb_trace_i("gso: %s, gro: %s", gso? "ok" : "no", gro? "ok" : "no");
+        tb_check_break(gso);
+
+        // send 16 segments using one datagram
+        tb_byte_t       data[TB_DEMO_SEGSIZE * 16];
+        tb_iovec_t      list[1] = {{0}};
+        tb_socket_msg_t msg;
+        tb_memset(data, 'x', sizeof(data));
+        tb_memset(&msg, 0, sizeof(msg));
+        list[0].data    = data;
+        list[0].size    = sizeof(data);
+        msg.list        = list;
+        msg.size        = 1;
+        msg.addr        = addr;
+        msg.segsize     = TB_DEMO_SEGSIZE;
+        if (tb_socket_usend_batch_wait(sender, &msg, 1, 1000) != 1) break;
+
+        // recv them
+        tb_size_t       i = 0;
+        tb_long_t       real = 0;
+        tb_size_t       recv = 0;
+        tb_iovec_t      rlists[4];
+        tb_socket_msg_t rmsgs[4];
+        tb_memset(rmsgs, 0, sizeof(rmsgs));
+        for (i = 0; i < tb_arrayn(rmsgs); i++)
+        {
+            rlists[i].data  = data;
+            rlists[i].size  = sizeof(data);
+            rmsgs[i].list   = &rlists[i];
+            rmsgs[i].size   = 1;
+        }
+        while (recv < sizeof(data) && (real = tb_socket_urecv_batch_wait(receiver, rmsgs, tb_arrayn(rmsgs), 1000)) > 0)
+        {
+            for (i = 0; i < (tb_size_t)real; i++)
+            {
+                tb_trace_i("gso: recv %lu bytes, segsize: %lu", rmsgs[i].real, rmsgs[i].segsize);
+                recv += rmsgs[i].real;
+            }
+        }
+        tb_trace_i("gso: recv %lu/%lu bytes", recv, sizeof(data));
+
+    } while (0);
+
+    // exit sockets
+    if (sender) tb_socket_exit(sender);
+    if (receiver) tb_socket_exit(receiver);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */ 
+tb_int_t tb_demo_coroutine_udp_batch_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the datagram count
+    tb_size_t count = argv[1]? tb_atoi(argv[1]) : 1000000;
+
+    // bench the single and batched io
+    tb_demo_udp_batch_bench(tb_false, count);
+    tb_demo_udp_batch_bench(tb_true, count);
+
+    // test gso and gro
+    tb_demo_udp_batch_gso();
+    return 0;
+}
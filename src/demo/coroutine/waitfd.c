@@ -0,0 +1,263 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+#if defined(TB_CONFIG_OS_LINUX) && defined(TB_CONFIG_POSIX_HAVE_EVENTFD)
+#   include <unistd.h>
+#   include <fcntl.h>
+#   include <errno.h>
+#   include <sys/eventfd.h>
+#   include <sys/timerfd.h>
+#   define TB_DEMO_WAITFD_ENABLE
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default count of the pipe bytes, eventfd and spak posts
+#define TB_DEMO_WAITFD_COUNT        (100000)
+
+// the timer ticks
+#define TB_DEMO_WAITFD_TICKS        (10)
+
+// the timer interval (ms)
+#define TB_DEMO_WAITFD_INTERVAL     (10)
+
+#ifdef TB_DEMO_WAITFD_ENABLE
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the count
+static tb_size_t        g_count = TB_DEMO_WAITFD_COUNT;
+
+// the pipe fds
+static tb_int_t         g_pipe[2] = {-1, -1};
+
+// the eventfd
+static tb_int_t         g_evfd = -1;
+
+// the spak poller
+static tb_poller_ref_t  g_poller = tb_null;
+
+// the spak posts are finished?
+static tb_atomic_t      g_spak_finished = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_pipe_reader(tb_cpointer_t priv)
+{
+    // read all data until the write end is closed
+    tb_size_t   size = 0;
+    tb_byte_t   data[4096];
+    tb_int_t    fd = g_pipe[0];
+    while (1)
+    {
+        tb_long_t real = (tb_long_t)read(fd, data, sizeof(data));
+        if (real > 0) size += real;
+        else if (!real) break;
+        else if (errno == EAGAIN)
+        {
+            // wait it, only suspend the current coroutine
+            if (tb_coroutine_waitfd(fd, TB_SOCKET_EVENT_RECV, -1) <= 0) break;
+        }
+        else break;
+    }
+
+    // trace
+    tb_trace_i("[pipe]: read %lu bytes", size);
+
+    // exit it
+    tb_coroutine_cancelfd(fd);
+    close(fd);
+}
+static tb_void_t tb_demo_pipe_writer(tb_cpointer_t priv)
+{
+    // write data with small chunks
+    tb_size_t   writ = 0;
+    tb_byte_t   data[256] = {0};
+    tb_int_t    fd = g_pipe[1];
+    while (writ < g_count)
+    {
+        tb_long_t real = (tb_long_t)write(fd, data, tb_min(sizeof(data), g_count - writ));
+        if (real > 0) writ += real;
+        else if (real < 0 && errno == EAGAIN)
+        {
+            // wait it
+            if (tb_coroutine_waitfd(fd, TB_SOCKET_EVENT_SEND, -1) <= 0) break;
+        }
+        else break;
+
+        // yield it to the reader sometimes
+        if (!(writ & 0xffff)) tb_coroutine_yield();
+    }
+
+    // trace
+    tb_trace_i("[pipe]: writ %lu bytes", writ);
+
+    // exit it, the reader will get eof
+    tb_coroutine_cancelfd(fd);
+    close(fd);
+}
+static tb_int_t tb_demo_eventfd_poster(tb_cpointer_t priv)
+{
+    // post events from the other thread
+    tb_size_t i = 0;
+    tb_uint64_t value = 1;
+    for (i = 0; i < g_count; i++)
+    {
+        if (write(g_evfd, &value, sizeof(value)) != sizeof(value)) break;
+    }
+    return 0;
+}
+static tb_void_t tb_demo_eventfd_waiter(tb_cpointer_t priv)
+{
+    // wait the posted events, the posts are coalesced into the eventfd counter
+    tb_size_t   wakeups = 0;
+    tb_uint64_t total = 0;
+    tb_hong_t   time = tb_mclock();
+    while (total < g_count)
+    {
+        tb_uint64_t value = 0;
+        if (read(g_evfd, &value, sizeof(value)) == sizeof(value)) total += value;
+        else if (errno == EAGAIN)
+        {
+            if (tb_coroutine_waitfd(g_evfd, TB_SOCKET_EVENT_RECV, 1000) <= 0) break;
+            wakeups++;
+        }
+        else break;
+    }
+
+    // trace
+    tb_trace_i("[eventfd]: posts: %llu, wakeups: %lu, %lld ms", total, wakeups, tb_mclock() - time);
+
+    // exit it
+    tb_coroutine_cancelfd(g_evfd);
+}
+static tb_void_t tb_demo_timerfd_waiter(tb_cpointer_t priv)
+{
+    // init timerfd
+    tb_int_t fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    tb_assert_and_check_return(fd >= 0);
+
+    // start a periodic timer
+    struct itimerspec spec = {{0}};
+    spec.it_interval.tv_nsec    = TB_DEMO_WAITFD_INTERVAL * 1000000;
+    spec.it_value.tv_nsec       = TB_DEMO_WAITFD_INTERVAL * 1000000;
+    if (!timerfd_settime(fd, 0, &spec, tb_null))
+    {
+        // wait ticks
+        tb_uint64_t ticks = 0;
+        tb_hong_t   time = tb_mclock();
+        while (ticks < TB_DEMO_WAITFD_TICKS)
+        {
+            tb_uint64_t value = 0;
+            if (read(fd, &value, sizeof(value)) == sizeof(value)) ticks += value;
+            else if (errno != EAGAIN || tb_coroutine_waitfd(fd, TB_SOCKET_EVENT_RECV, -1) <= 0) break;
+        }
+
+        // trace
+        tb_trace_i("[timerfd]: ticks: %llu, %lld ms", ticks, tb_mclock() - time);
+    }
+
+    // exit it
+    tb_coroutine_cancelfd(fd);
+    close(fd);
+}
+static tb_int_t tb_demo_spak_poster(tb_cpointer_t priv)
+{
+    // post spak and kill it at last
+    tb_size_t i = 0;
+    for (i = 0; i < g_count; i++) tb_poller_spak(g_poller);
+    tb_atomic_set(&g_spak_finished, 1);
+    tb_poller_kill(g_poller);
+    return 0;
+}
+static tb_void_t tb_demo_spak_event(tb_poller_ref_t poller, tb_socket_ref_t sock, tb_size_t events, tb_cpointer_t priv)
+{
+}
+static tb_void_t tb_demo_spak_test()
+{
+    // init poller
+    g_poller = tb_poller_init(tb_null);
+    tb_assert_and_check_return(g_poller);
+
+    // post spak from the other thread
+    tb_hong_t       time = tb_mclock();
+    tb_thread_ref_t thread = tb_thread_init(tb_null, tb_demo_spak_poster, tb_null, 0);
+    if (thread)
+    {
+        // wait it until it is killed
+        tb_size_t wakeups = 0;
+        tb_long_t ok = 0;
+        while ((ok = tb_poller_wait(g_poller, tb_demo_spak_event, 1000)) >= 0) wakeups++;
+
+        // trace
+        tb_trace_i("[spak]: posts: %lu, wakeups: %lu, killed: %s, %lld ms", g_count, wakeups, tb_atomic_get(&g_spak_finished)? "ok" : "no", tb_mclock() - time);
+
+        // exit thread
+        tb_thread_wait(thread, -1, tb_null);
+        tb_thread_exit(thread);
+    }
+
+    // exit poller
+    tb_poller_exit(g_poller);
+    g_poller = tb_null;
+}
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_waitfd_main(tb_int_t argc, tb_char_t** argv)
+{
+#ifdef TB_DEMO_WAITFD_ENABLE
+    // the count
+    if (argc > 1) g_count = tb_atoi(argv[1]);
+    tb_assert_and_check_return_val(g_count, -1);
+
+    // init pipe and eventfd
+    if (pipe2(g_pipe, O_NONBLOCK | O_CLOEXEC) < 0) return -1;
+    g_evfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    tb_assert_and_check_return_val(g_evfd >= 0, -1);
+
+    // wait pipe, eventfd and timerfd in coroutines
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // start coroutines
+        tb_coroutine_start(scheduler, tb_demo_pipe_reader, tb_null, 0);
+        tb_coroutine_start(scheduler, tb_demo_pipe_writer, tb_null, 0);
+        tb_coroutine_start(scheduler, tb_demo_eventfd_waiter, tb_null, 0);
+        tb_coroutine_start(scheduler, tb_demo_timerfd_waiter, tb_null, 0);
+
+        // post eventfd from the other thread
+        tb_thread_ref_t thread = tb_thread_init(tb_null, tb_demo_eventfd_poster, tb_null, 0);
+
+        // run scheduler
+        tb_co_scheduler_loop(scheduler, tb_true);
+
+        // exit thread
+        if (thread)
+        {
+            tb_thread_wait(thread, -1, tb_null);
+            tb_thread_exit(thread);
+        }
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+
+    // exit eventfd
+    close(g_evfd);
+    g_evfd = -1;
+
+    // spak the poller from the other thread
+    tb_demo_spak_test();
+#else
+    tb_trace_i("waitfd is not supported on this platform!");
+#endif
+    return 0;
+}
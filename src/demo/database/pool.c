@@ -0,0 +1,181 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */ 
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */ 
+
+// the client count
+#define TB_DEMO_CLIENT_COUNT        (16)
+
+// the insert count of each client
+#define TB_DEMO_INSERT_COUNT        (100)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */ 
+
+// the insert type
+typedef struct __tb_demo_insert_t
+{
+    // the client
+    tb_size_t                   client;
+
+    // the index
+    tb_size_t                   index;
+
+}tb_demo_insert_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */ 
+
+// the pool
+static tb_database_sql_pool_ref_t   g_pool = tb_null;
+
+// the finished client count
+static tb_size_t                    g_finished = 0;
+
+// the ticks of the ticker coroutine
+static tb_size_t                    g_ticks = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */ 
+static tb_bool_t tb_demo_database_pool_done(tb_database_sql_ref_t database, tb_cpointer_t priv)
+{
+    // done sql
+    tb_char_t const* sql = (tb_char_t const*)priv;
+    if (!tb_database_sql_done(database, sql))
+    {
+        // trace
+        tb_trace_e("done %s failed, error: %s", sql, tb_state_cstr(tb_database_sql_state(database)));
+        return tb_false;
+    }
+
+    // ok
+    return tb_true;
+}
+static tb_bool_t tb_demo_database_pool_insert(tb_database_sql_ref_t database, tb_cpointer_t priv)
+{
+    // the insert
+    tb_demo_insert_t const* insert = (tb_demo_insert_t const*)priv;
+    tb_assert_and_check_return_val(insert, tb_false);
+
+    // make sql
+    tb_char_t sql[256];
+    tb_snprintf(sql, sizeof(sql), "insert into pool1 values(%lu, %lu, 'name%lu')", insert->index, insert->client, insert->index);
+
+    // done it
+    return tb_demo_database_pool_done(database, sql);
+}
+static tb_bool_t tb_demo_database_pool_count(tb_database_sql_ref_t database, tb_cpointer_t priv)
+{
+    // done sql
+    if (!tb_demo_database_pool_done(database, "select count(*) from pool1")) return tb_false;
+
+    // load result
+    tb_iterator_ref_t result = tb_database_sql_result_load(database, tb_false);
+    tb_check_return_val(result, tb_false);
+
+    // get the count
+    tb_iterator_ref_t               row = (tb_iterator_ref_t)tb_iterator_item(result, tb_iterator_head(result));
+    tb_database_sql_value_t const*  value = row? (tb_database_sql_value_t const*)tb_iterator_item(row, 0) : tb_null;
+    if (value) *((tb_size_t*)priv) = (tb_size_t)tb_database_sql_value_int64(value);
+
+    // exit result
+    tb_database_sql_result_exit(database, result);
+    return tb_true;
+}
+static tb_void_t tb_demo_database_pool_client(tb_cpointer_t priv)
+{
+    // insert rows, it will only suspend the current coroutine
+    tb_size_t           i = 0;
+    tb_demo_insert_t    insert;
+    insert.client = (tb_size_t)priv;
+    for (i = 0; i < TB_DEMO_INSERT_COUNT; i++)
+    {
+        insert.index = insert.client * TB_DEMO_INSERT_COUNT + i;
+        if (!tb_database_sql_pool_done(g_pool, tb_demo_database_pool_insert, &insert, -1)) break;
+    }
+
+    // trace
+    tb_size_t idle = 0;
+    tb_size_t size = tb_database_sql_pool_size(g_pool, &idle);
+    tb_trace_i("[client: %lu]: inserted: %lu, connections: %lu, idle: %lu", insert.client, i, size, idle);
+
+    // finished
+    g_finished++;
+}
+#ifdef TB_CONFIG_MODULE_HAVE_COROUTINE
+static tb_void_t tb_demo_database_pool_ticker(tb_cpointer_t priv)
+{
+    // the scheduler is not blocked by the database calls
+    while (g_finished < TB_DEMO_CLIENT_COUNT)
+    {
+        tb_msleep(1);
+        g_ticks++;
+    }
+}
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */ 
+tb_int_t tb_demo_database_pool_main(tb_int_t argc, tb_char_t** argv)
+{
+    // check
+    tb_assert_and_check_return_val(argc > 1, -1);
+
+    // init pool
+    g_pool = tb_database_sql_pool_init(argv[1], 2, 8, 1000);
+    if (g_pool)
+    {
+        // init table
+        tb_database_sql_pool_done(g_pool, tb_demo_database_pool_done, "drop table if exists pool1", -1);
+        tb_database_sql_pool_done(g_pool, tb_demo_database_pool_done, "create table pool1(id int, client int, name text)", -1);
+
+        // done clients
+        tb_size_t i = 0;
+        tb_hong_t time = tb_mclock();
+#ifdef TB_CONFIG_MODULE_HAVE_COROUTINE
+        tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+        if (scheduler)
+        {
+            // start clients
+            for (i = 0; i < TB_DEMO_CLIENT_COUNT; i++)
+                tb_coroutine_start(scheduler, tb_demo_database_pool_client, (tb_cpointer_t)i, 0);
+
+            // start ticker
+            tb_coroutine_start(scheduler, tb_demo_database_pool_ticker, tb_null, 0);
+
+            // run scheduler, @note not exclusive, because the blocking calls will be done in the other worker threads
+            tb_co_scheduler_loop(scheduler, tb_false);
+
+            // exit scheduler
+            tb_co_scheduler_exit(scheduler);
+        }
+#else
+        for (i = 0; i < TB_DEMO_CLIENT_COUNT; i++)
+            tb_demo_database_pool_client((tb_cpointer_t)i);
+#endif
+        time = tb_mclock() - time;
+
+        // trace
+        tb_size_t count = 0;
+        tb_database_sql_pool_done(g_pool, tb_demo_database_pool_count, &count, -1);
+        tb_trace_i("inserted: %lu rows, ticks: %lu, %lld ms", count, g_ticks, time);
+
+        // evict the idle connections
+        tb_msleep(1500);
+        tb_size_t evicted = tb_database_sql_pool_evict(g_pool);
+        tb_trace_i("evicted: %lu, connections: %lu", evicted, tb_database_sql_pool_size(g_pool, tb_null));
+
+        // exit pool
+        tb_database_sql_pool_exit(g_pool);
+        g_pool = tb_null;
+    }
+    return 0;
+}
@@ -29,7 +29,8 @@ static tb_void_t tb_demo_database_sql_test_done(tb_database_sql_ref_t database,
 
         // trace
         tb_trace_i("==============================================================================");
-        tb_trace_i("row: size: %lu", tb_iterator_size(result));
+        if (tb_iterator_mode(result) & TB_ITERATOR_MODE_RACCESS) tb_trace_i("row: size: %lu", tb_iterator_size(result));
+        else tb_trace_i("row: size: unknown, the result is only forward iterable before loading all");
 
         // walk result
         tb_for_all_if (tb_iterator_ref_t, row, result, row)
@@ -41,7 +42,13 @@ static tb_void_t tb_demo_database_sql_test_done(tb_database_sql_ref_t database,
             tb_for_all_if (tb_database_sql_value_t*, value, row, value)
             {
                 // trace
-                tb_tracet_i("[%s:%s] ", tb_database_sql_value_name(value), tb_database_sql_value_text(value));
+                if (tb_database_sql_value_is_integer(value))
+                    tb_tracet_i("[%s:%lld] ", tb_database_sql_value_name(value), tb_database_sql_value_int64(value));
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+                else if (tb_database_sql_value_is_float(value))
+                    tb_tracet_i("[%s:%f] ", tb_database_sql_value_name(value), tb_database_sql_value_double(value));
+#endif
+                else tb_tracet_i("[%s:%s] ", tb_database_sql_value_name(value), tb_database_sql_value_text(value));
             }
 
             // trace
@@ -85,7 +92,8 @@ static tb_void_t tb_demo_database_sql_test_statement_done(tb_database_sql_ref_t
 
         // trace
         tb_trace_i("==============================================================================");
-        tb_trace_i("row: size: %lu", tb_iterator_size(result));
+        if (tb_iterator_mode(result) & TB_ITERATOR_MODE_RACCESS) tb_trace_i("row: size: %lu", tb_iterator_size(result));
+        else tb_trace_i("row: size: unknown, the result is only forward iterable before loading all");
 
         // walk result
         tb_for_all_if (tb_iterator_ref_t, row, result, row)
@@ -249,6 +257,158 @@ static tb_void_t tb_demo_database_sql_test_statement_done_insert(tb_database_sql
     if (stream) tb_stream_exit(stream);
 }
 
+static tb_void_t tb_demo_database_sql_test_select_bench(tb_database_sql_ref_t database, tb_char_t const* sql, tb_bool_t try_all)
+{
+    // done sql
+    tb_hong_t time = tb_mclock();
+    if (!tb_database_sql_done(database, sql))
+    {
+        // trace
+        tb_trace_e("done %s failed, error: %s", sql, tb_state_cstr(tb_database_sql_state(database)));
+        return ;
+    }
+
+    // load result
+    tb_iterator_ref_t result = tb_database_sql_result_load(database, try_all);
+    tb_check_return(result);
+
+    // walk result
+    tb_size_t   rows = 0;
+    tb_size_t   size = 0;
+    tb_int64_t  sum = 0;
+    tb_for_all_if (tb_iterator_ref_t, row, result, row)
+    {
+        // sum id, @note the value will be overwritten by the next item
+        tb_database_sql_value_t const* id = (tb_database_sql_value_t const*)tb_iterator_item(row, 0);
+        tb_assert_and_check_break(id);
+        sum += tb_database_sql_value_int64(id);
+
+        // sum the name size
+        tb_database_sql_value_t const* name = (tb_database_sql_value_t const*)tb_iterator_item(row, 1);
+        tb_assert_and_check_break(name);
+        size += tb_database_sql_value_text(name)? tb_strlen(tb_database_sql_value_text(name)) : 0;
+
+        // sum number
+        tb_database_sql_value_t const* number = (tb_database_sql_value_t const*)tb_iterator_item(row, 2);
+        tb_assert_and_check_break(number);
+        sum += tb_database_sql_value_int64(number);
+        rows++;
+    }
+
+    // exit result
+    tb_database_sql_result_exit(database, result);
+
+    // trace
+    tb_trace_i("select: %s: %lu rows, sum: %lld, size: %lu, %lld ms", try_all? "load all" : "stream", rows, sum, size, tb_mclock() - time);
+}
+static tb_void_t tb_demo_database_sql_test_bench(tb_database_sql_ref_t database, tb_size_t count)
+{
+    // check
+    tb_assert_and_check_return(database && count);
+
+    // init table
+    if (    !tb_database_sql_done(database, "drop table if exists table3")
+        ||  !tb_database_sql_done(database, "create table table3(id integer primary key, name text, number integer)"))
+    {
+        // trace
+        tb_trace_e("create table3 failed, error: %s", tb_state_cstr(tb_database_sql_state(database)));
+        return ;
+    }
+
+    // done
+    tb_database_sql_statement_ref_t statement = tb_null;
+    do
+    {
+        // init statement
+        tb_char_t const* sql = "insert into table3 values(?, ?, ?)";
+        if (!(statement = tb_database_sql_statement_init(database, sql)))
+        {
+            // trace
+            tb_trace_e("statement: init %s failed, error: %s", sql, tb_state_cstr(tb_database_sql_state(database)));
+            break ;
+        }
+
+        // insert all rows, 1000 rows for each batch in one transaction
+        tb_size_t                   i = 0;
+        tb_size_t                   j = 0;
+        tb_char_t                   names[1000][32];
+        tb_database_sql_value_t     list[1000 * 3];
+        tb_hong_t                   time = tb_mclock();
+        for (i = 0; i < count; i += j)
+        {
+            // bind the arguments of this batch
+            for (j = 0; j < tb_arrayn(names) && i + j < count; j++)
+            {
+                tb_snprintf(names[j], sizeof(names[j]), "name%lu", i + j);
+                tb_database_sql_value_set_int64(&list[j * 3], (tb_int64_t)(i + j));
+                tb_database_sql_value_set_text(&list[j * 3 + 1], names[j], 0);
+                tb_database_sql_value_set_int64(&list[j * 3 + 2], (tb_int64_t)(i + j) * 3);
+            }
+
+            // done this batch
+            if (!tb_database_sql_statement_done_batch(database, statement, list, 3, j))
+            {
+                // trace
+                tb_trace_e("statement: done batch %s failed, error: %s", sql, tb_state_cstr(tb_database_sql_state(database)));
+                break ;
+            }
+        }
+        tb_check_break(i >= count);
+
+        // trace
+        tb_trace_i("insert: batch: %lu rows, %lld ms", count, tb_mclock() - time);
+
+        // exit statement
+        tb_database_sql_statement_exit(database, statement);
+        statement = tb_null;
+
+        // select all rows by the streaming iterator and loading all into memory
+        tb_demo_database_sql_test_select_bench(database, "select * from table3", tb_false);
+        tb_demo_database_sql_test_select_bench(database, "select * from table3", tb_true);
+
+        // select some rows by the primary key, the prepared statement will be reused from the cache
+        tb_size_t   n = tb_min(count, 100000);
+        tb_int64_t  sum = 0;
+        time = tb_mclock();
+        for (i = 0; i < n; i++)
+        {
+            // init statement
+            sql = "select number from table3 where id = ?";
+            if (!(statement = tb_database_sql_statement_init(database, sql))) break;
+
+            // bind and done it
+            tb_database_sql_value_t value;
+            tb_database_sql_value_set_int64(&value, (tb_int64_t)tb_random_range(0, count));
+            if (tb_database_sql_statement_bind(database, statement, &value, 1) && tb_database_sql_statement_done(database, statement))
+            {
+                // load result
+                tb_iterator_ref_t result = tb_database_sql_result_load(database, tb_false);
+                if (result)
+                {
+                    // the number
+                    tb_iterator_ref_t row = (tb_iterator_ref_t)tb_iterator_item(result, tb_iterator_head(result));
+                    tb_database_sql_value_t const* number = row? (tb_database_sql_value_t const*)tb_iterator_item(row, 0) : tb_null;
+                    if (number) sum += tb_database_sql_value_int64(number);
+
+                    // exit result
+                    tb_database_sql_result_exit(database, result);
+                }
+            }
+
+            // exit statement
+            tb_database_sql_statement_exit(database, statement);
+            statement = tb_null;
+        }
+
+        // trace
+        tb_trace_i("select: statement: %lu queries, sum: %lld, %lld ms", i, sum, tb_mclock() - time);
+
+    } while (0);
+
+    // exit statement
+    if (statement) tb_database_sql_statement_exit(database, statement);
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
  */
@@ -296,6 +456,9 @@ tb_int_t tb_demo_database_sql_main(tb_int_t argc, tb_char_t** argv)
                 // select
                 tb_demo_database_sql_test_statement_done(database, "select * from table2");
             }
+
+            // done benchmark
+            tb_demo_database_sql_test_bench(database, argc > 3? tb_atoi(argv[3]) : 1000000);
         }
         else
         {
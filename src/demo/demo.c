@@ -37,6 +37,7 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(libc_wchar)
 ,   TB_DEMO_MAIN_ITEM(libc_string)
 ,   TB_DEMO_MAIN_ITEM(libc_stdlib)
+,   TB_DEMO_MAIN_ITEM(libc_stdio)
 ,   TB_DEMO_MAIN_ITEM(libc_wcstombs)
 ,   TB_DEMO_MAIN_ITEM(libc_mbstowcs)
 
@@ -50,6 +51,7 @@ static tb_demo_t g_demo[] =
     // database
 #ifdef TB_CONFIG_MODULE_HAVE_DATABASE
 ,   TB_DEMO_MAIN_ITEM(database_sql)
+,   TB_DEMO_MAIN_ITEM(database_pool)
 #endif
 
     // xml
@@ -122,6 +124,7 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(object_bplist)
 ,   TB_DEMO_MAIN_ITEM(object_xplist)
 ,   TB_DEMO_MAIN_ITEM(object_dump)
+,   TB_DEMO_MAIN_ITEM(object_mbin)
 #endif
 
     // stream
@@ -130,6 +133,8 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(stream_cache)
 ,   TB_DEMO_MAIN_ITEM(stream_charset)
 ,   TB_DEMO_MAIN_ITEM(stream_zip)
+,   TB_DEMO_MAIN_ITEM(stream_zip_benchmark)
+,   TB_DEMO_MAIN_ITEM(stream_downloader)
 #ifdef TB_CONFIG_API_HAVE_DEPRECATED
 ,   TB_DEMO_MAIN_ITEM(stream_transfer_pool)
 ,   TB_DEMO_MAIN_ITEM(stream_async_transfer)
@@ -149,11 +154,14 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(memory_fixed_pool)
 ,   TB_DEMO_MAIN_ITEM(memory_string_pool)
 ,   TB_DEMO_MAIN_ITEM(memory_large_allocator)
+,   TB_DEMO_MAIN_ITEM(memory_arena_allocator)
+,   TB_DEMO_MAIN_ITEM(memory_heap_profiler)
 ,   TB_DEMO_MAIN_ITEM(memory_small_allocator)
 ,   TB_DEMO_MAIN_ITEM(memory_default_allocator)
 ,   TB_DEMO_MAIN_ITEM(memory_memops)
 ,   TB_DEMO_MAIN_ITEM(memory_buffer)
 ,   TB_DEMO_MAIN_ITEM(memory_queue_buffer)
+,   TB_DEMO_MAIN_ITEM(memory_iobuf)
 ,   TB_DEMO_MAIN_ITEM(memory_static_buffer)
 ,   TB_DEMO_MAIN_ITEM(memory_impl_static_fixed_pool)
 
@@ -166,6 +174,8 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(network_ipaddr)
 ,   TB_DEMO_MAIN_ITEM(network_hwaddr)
 ,   TB_DEMO_MAIN_ITEM(network_http)
+,   TB_DEMO_MAIN_ITEM(network_http_server)
+,   TB_DEMO_MAIN_ITEM(network_http_cache)
 ,   TB_DEMO_MAIN_ITEM(network_whois)
 ,   TB_DEMO_MAIN_ITEM(network_cookies)
 ,   TB_DEMO_MAIN_ITEM(network_impl_date)
@@ -184,6 +194,7 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(platform_processor)
 ,   TB_DEMO_MAIN_ITEM(platform_backtrace)
 ,   TB_DEMO_MAIN_ITEM(platform_directory)
+,   TB_DEMO_MAIN_ITEM(platform_directory_walk)
 ,   TB_DEMO_MAIN_ITEM(platform_cache_time)
 ,   TB_DEMO_MAIN_ITEM(platform_environment)
 ,   TB_DEMO_MAIN_ITEM(platform_lock)
@@ -191,6 +202,7 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(platform_ltimer)
 ,   TB_DEMO_MAIN_ITEM(platform_event)
 ,   TB_DEMO_MAIN_ITEM(platform_semaphore)
+,   TB_DEMO_MAIN_ITEM(platform_shaper)
 ,   TB_DEMO_MAIN_ITEM(platform_thread)
 ,   TB_DEMO_MAIN_ITEM(platform_thread_pool)
 ,   TB_DEMO_MAIN_ITEM(platform_thread_local)
@@ -214,6 +226,7 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(container_single_list)
 ,   TB_DEMO_MAIN_ITEM(container_single_list_entry)
 ,   TB_DEMO_MAIN_ITEM(container_bloom_filter)
+,   TB_DEMO_MAIN_ITEM(container_block_bloom_filter)
 
     // algorithm
 ,   TB_DEMO_MAIN_ITEM(algorithm_find)
@@ -232,6 +245,11 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(coroutine_file_server)
 ,   TB_DEMO_MAIN_ITEM(coroutine_file_client)
 ,   TB_DEMO_MAIN_ITEM(coroutine_http_server)
+,   TB_DEMO_MAIN_ITEM(coroutine_udp_batch)
+,   TB_DEMO_MAIN_ITEM(coroutine_listener)
+,   TB_DEMO_MAIN_ITEM(coroutine_process)
+,   TB_DEMO_MAIN_ITEM(coroutine_waitfd)
+,   TB_DEMO_MAIN_ITEM(coroutine_file_offload)
 #   ifdef TB_CONFIG_MODULE_HAVE_XML
 ,   TB_DEMO_MAIN_ITEM(coroutine_spider)
 #   endif
@@ -45,6 +45,7 @@
 
 // database
 TB_DEMO_MAIN_DECL(database_sql);
+TB_DEMO_MAIN_DECL(database_pool);
 
 // regex
 TB_DEMO_MAIN_DECL(regex);
@@ -59,6 +60,7 @@ TB_DEMO_MAIN_DECL(libc_time);
 TB_DEMO_MAIN_DECL(libc_wchar);
 TB_DEMO_MAIN_DECL(libc_string);
 TB_DEMO_MAIN_DECL(libc_stdlib);
+TB_DEMO_MAIN_DECL(libc_stdio);
 TB_DEMO_MAIN_DECL(libc_mbstowcs);
 TB_DEMO_MAIN_DECL(libc_wcstombs);
 
@@ -114,6 +116,7 @@ TB_DEMO_MAIN_DECL(object_xml);
 TB_DEMO_MAIN_DECL(object_xplist);
 TB_DEMO_MAIN_DECL(object_bplist);
 TB_DEMO_MAIN_DECL(object_dump);
+TB_DEMO_MAIN_DECL(object_mbin);
 
 // stream
 TB_DEMO_MAIN_DECL(stream_transfer_pool);
@@ -121,6 +124,8 @@ TB_DEMO_MAIN_DECL(stream_async_transfer);
 TB_DEMO_MAIN_DECL(stream_async_stream);
 TB_DEMO_MAIN_DECL(stream);
 TB_DEMO_MAIN_DECL(stream_zip);
+TB_DEMO_MAIN_DECL(stream_zip_benchmark);
+TB_DEMO_MAIN_DECL(stream_downloader);
 TB_DEMO_MAIN_DECL(stream_null);
 TB_DEMO_MAIN_DECL(stream_cache);
 TB_DEMO_MAIN_DECL(stream_charset);
@@ -138,11 +143,14 @@ TB_DEMO_MAIN_DECL(memory_check);
 TB_DEMO_MAIN_DECL(memory_fixed_pool);
 TB_DEMO_MAIN_DECL(memory_string_pool);
 TB_DEMO_MAIN_DECL(memory_large_allocator);
+TB_DEMO_MAIN_DECL(memory_arena_allocator);
+TB_DEMO_MAIN_DECL(memory_heap_profiler);
 TB_DEMO_MAIN_DECL(memory_small_allocator);
 TB_DEMO_MAIN_DECL(memory_default_allocator);
 TB_DEMO_MAIN_DECL(memory_memops);
 TB_DEMO_MAIN_DECL(memory_buffer);
 TB_DEMO_MAIN_DECL(memory_queue_buffer);
+TB_DEMO_MAIN_DECL(memory_iobuf);
 TB_DEMO_MAIN_DECL(memory_static_buffer);
 TB_DEMO_MAIN_DECL(memory_impl_static_fixed_pool);
 
@@ -155,6 +163,8 @@ TB_DEMO_MAIN_DECL(network_ping);
 TB_DEMO_MAIN_DECL(network_ipaddr);
 TB_DEMO_MAIN_DECL(network_hwaddr);
 TB_DEMO_MAIN_DECL(network_http);
+TB_DEMO_MAIN_DECL(network_http_server);
+TB_DEMO_MAIN_DECL(network_http_cache);
 TB_DEMO_MAIN_DECL(network_whois);
 TB_DEMO_MAIN_DECL(network_cookies);
 TB_DEMO_MAIN_DECL(network_impl_date);
@@ -177,8 +187,10 @@ TB_DEMO_MAIN_DECL(platform_hostname);
 TB_DEMO_MAIN_DECL(platform_processor);
 TB_DEMO_MAIN_DECL(platform_backtrace);
 TB_DEMO_MAIN_DECL(platform_directory);
+TB_DEMO_MAIN_DECL(platform_directory_walk);
 TB_DEMO_MAIN_DECL(platform_exception);
 TB_DEMO_MAIN_DECL(platform_semaphore);
+TB_DEMO_MAIN_DECL(platform_shaper);
 TB_DEMO_MAIN_DECL(platform_cache_time);
 TB_DEMO_MAIN_DECL(platform_environment);
 TB_DEMO_MAIN_DECL(platform_thread);
@@ -199,6 +211,7 @@ TB_DEMO_MAIN_DECL(container_list_entry);
 TB_DEMO_MAIN_DECL(container_single_list);
 TB_DEMO_MAIN_DECL(container_single_list_entry);
 TB_DEMO_MAIN_DECL(container_bloom_filter);
+TB_DEMO_MAIN_DECL(container_block_bloom_filter);
 
 // algorithm
 TB_DEMO_MAIN_DECL(algorithm_find);
@@ -217,6 +230,11 @@ TB_DEMO_MAIN_DECL(coroutine_echo_server);
 TB_DEMO_MAIN_DECL(coroutine_file_client);
 TB_DEMO_MAIN_DECL(coroutine_file_server);
 TB_DEMO_MAIN_DECL(coroutine_http_server);
+TB_DEMO_MAIN_DECL(coroutine_udp_batch);
+TB_DEMO_MAIN_DECL(coroutine_listener);
+TB_DEMO_MAIN_DECL(coroutine_process);
+TB_DEMO_MAIN_DECL(coroutine_waitfd);
+TB_DEMO_MAIN_DECL(coroutine_file_offload);
 
 // stackless coroutine
 TB_DEMO_MAIN_DECL(lo_coroutine_nest);
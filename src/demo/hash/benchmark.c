@@ -18,6 +18,28 @@ typedef struct __tb_demo_hash32_entry_t
 
 }tb_demo_hash32_entry_t, *tb_demo_hash32_entry_ref_t;
 
+// the hash64 entry type
+typedef struct __tb_demo_hash64_entry_t
+{
+    // the hash name
+    tb_char_t const*        name;
+
+    // the hash function
+    tb_uint64_t             (*hash)(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed);
+
+}tb_demo_hash64_entry_t, *tb_demo_hash64_entry_ref_t;
+
+// the digest entry type
+typedef struct __tb_demo_digest_entry_t
+{
+    // the digest name
+    tb_char_t const*        name;
+
+    // the sha mode, md5 if be zero
+    tb_size_t               mode;
+
+}tb_demo_digest_entry_t, *tb_demo_digest_entry_ref_t;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * wrapers
  */
@@ -49,6 +71,15 @@ static tb_uint32_t tb_demo_blizzard_make(tb_byte_t const* data, tb_size_t size,
 {
     return (tb_uint32_t)tb_blizzard_make(data, size, seed);
 }
+static tb_uint32_t tb_demo_xxh3_make32(tb_byte_t const* data, tb_size_t size, tb_uint32_t seed)
+{
+    return (tb_uint32_t)tb_xxh3_make(data, size, seed);
+}
+static tb_uint64_t tb_demo_xxh3_make128(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed)
+{
+    tb_xxh3_128_t value = tb_xxh3_make128(data, size, seed);
+    return value.low ^ value.high;
+}
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * globals
@@ -67,9 +98,27 @@ static tb_demo_hash32_entry_t g_hash32_entries[] =
 ,   { "bkdr    ",   tb_demo_bkdr_make       }
 ,   { "murmur  ",   tb_demo_murmur_make     }
 ,   { "blizzard",   tb_demo_blizzard_make   }
+,   { "xxh3    ",   tb_demo_xxh3_make32     }
+,   { tb_null,      tb_null                 }
+};
+static tb_demo_hash64_entry_t g_hash64_entries[] =
+{
+    { "fnv64   ",   tb_fnv64_make           }
+,   { "fnv64-1a",   tb_fnv64_1a_make        }
+,   { "xxh3    ",   tb_xxh3_make            }
+,   { "xxh3-128",   tb_demo_xxh3_make128    }
 ,   { tb_null,      tb_null                 }
 };
 
+static tb_demo_digest_entry_t g_digest_entries[] =
+{
+    { "md5     ",   0                       }
+,   { "sha1    ",   TB_SHA_MODE_SHA1_160    }
+,   { "sha256  ",   TB_SHA_MODE_SHA2_256    }
+,   { "sha512  ",   TB_SHA_MODE_SHA2_512    }
+,   { tb_null,      0                       }
+};
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * test
  */
@@ -125,11 +174,151 @@ static tb_void_t tb_demo_hash32_test()
     tb_free(data);
 }
 
+static tb_void_t tb_demo_hash64_test()
+{
+    // init data
+    tb_size_t   size = 1024 * 1024;
+    tb_byte_t*  data = tb_malloc_bytes(size);
+    tb_assert_and_check_return(data);
+
+    // make data
+    tb_size_t i = 0;
+    for (i = 0; i < size; i++) data[i] = (tb_byte_t)tb_random_range(0, 0xff);
+
+    // done (small keys)
+    static tb_size_t s_keys[] = {8, 16, 32, 64, 128};
+    tb_demo_hash64_entry_ref_t entry = g_hash64_entries;
+    for (; entry && entry->name; entry++)
+    {
+        for (i = 0; i < tb_arrayn(s_keys); i++)
+        {
+            __tb_volatile__ tb_uint64_t v = 0;
+            __tb_volatile__ tb_size_t   n = 10000000;
+            __tb_volatile__ tb_hong_t   t = tb_mclock();
+            while (n--)
+            {
+                v = entry->hash(data + (n & 0xffff), s_keys[i], n);
+            }
+            t = tb_mclock() - t;
+
+            // trace
+            tb_trace_i("[hash(%lu)]: %s: %016llx %lld ms", s_keys[i], entry->name, v, t);
+        }
+    }
+
+    // trace
+    tb_trace_i("");
+
+    // done (1M)
+    entry = g_hash64_entries;
+    for (; entry && entry->name; entry++)
+    {
+        __tb_volatile__ tb_uint64_t v = 0;
+        __tb_volatile__ tb_size_t   n = 1000;
+        __tb_volatile__ tb_hong_t   t = tb_mclock();
+        while (n--)
+        {
+            v = entry->hash(data, size, n);
+        }
+        t = tb_mclock() - t;
+
+        // trace
+        tb_trace_i("[hash(1M)]: %s: %016llx %lld ms, %lld MB/s", entry->name, v, t, t? (1000 * 1000) / t : 0);
+    }
+
+    // exit data
+    tb_free(data);
+}
+static tb_void_t tb_demo_digest_make(tb_size_t mode, tb_byte_t const* data, tb_size_t size, tb_byte_t* digest)
+{
+    if (mode) tb_sha_make(mode, data, size, digest, 64);
+    else tb_md5_make(data, size, digest, 16);
+}
+static tb_void_t tb_demo_digest_test()
+{
+    // init data
+    tb_size_t   size = 1024 * 1024;
+    tb_byte_t*  data = tb_malloc_bytes(size);
+    tb_assert_and_check_return(data);
+
+    // make data
+    tb_size_t i = 0;
+    for (i = 0; i < size; i++) data[i] = (tb_byte_t)tb_random_range(0, 0xff);
+
+    // done (1M x 256)
+    tb_byte_t                   digest[64];
+    tb_demo_digest_entry_ref_t  entry = g_digest_entries;
+    for (; entry && entry->name; entry++)
+    {
+        __tb_volatile__ tb_size_t   n = 256;
+        __tb_volatile__ tb_hong_t   t = tb_mclock();
+        while (n--) tb_demo_digest_make(entry->mode, data, size, digest);
+        t = tb_mclock() - t;
+
+        // trace
+        tb_trace_i("[digest(1M)]: %s: %lld ms, %lld MB/s", entry->name, t, t? (256 * 1000) / t : 0);
+    }
+
+    // trace
+    tb_trace_i("");
+
+    // the small messages 
+    tb_size_t           count = 1024;
+    tb_byte_t const**   ibs = tb_nalloc0_type(count, tb_byte_t const*);
+    tb_size_t*          ins = tb_nalloc0_type(count, tb_size_t);
+    tb_byte_t**         obs = tb_nalloc0_type(count, tb_byte_t*);
+    tb_byte_t*          out = tb_malloc_bytes(count * 64);
+    if (ibs && ins && obs && out)
+    {
+        for (i = 0; i < count; i++)
+        {
+            ins[i] = 64 + (i & 63);
+            ibs[i] = data + i * 128;
+            obs[i] = out + i * 64;
+        }
+
+        // done (1K x (64 - 127) bytes x 1000), one by one and multi-buffer
+        for (entry = g_digest_entries; entry && entry->name; entry++)
+        {
+            __tb_volatile__ tb_size_t   n = 1000;
+            __tb_volatile__ tb_hong_t   t1 = tb_mclock();
+            while (n--)
+            {
+                for (i = 0; i < count; i++) tb_demo_digest_make(entry->mode, ibs[i], ins[i], obs[i]);
+            }
+            t1 = tb_mclock() - t1;
+
+            n = 1000;
+            __tb_volatile__ tb_hong_t   t2 = tb_mclock();
+            while (n--)
+            {
+                if (entry->mode) tb_sha_make_multi(entry->mode, ibs, ins, obs, 64, count);
+                else tb_md5_make_multi(ibs, ins, obs, count);
+            }
+            t2 = tb_mclock() - t2;
+
+            // trace
+            tb_trace_i("[digest(1K x 64-127)]: %s: one: %lld ms, multi: %lld ms", entry->name, t1, t2);
+        }
+    }
+
+    // exit data
+    if (ibs) tb_free(ibs);
+    if (ins) tb_free(ins);
+    if (obs) tb_free(obs);
+    if (out) tb_free(out);
+    tb_free(data);
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
  */
 tb_int_t tb_demo_hash_benchmark_main(tb_int_t argc, tb_char_t** argv)
 {
     tb_demo_hash32_test();
+    tb_trace_i("");
+    tb_demo_hash64_test();
+    tb_trace_i("");
+    tb_demo_digest_test();
     return 0;
 }
@@ -0,0 +1,152 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */ 
+#include "../demo.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */ 
+
+// the values count
+#define TB_DEMO_VALUES_MAXN         (100000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */ 
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+static tb_void_t tb_demo_libc_stdio_format(tb_char_t const* format, tb_double_t value)
+{
+    tb_char_t data0[256];
+    tb_char_t data1[256];
+    tb_snprintf(data0, sizeof(data0), format, value);
+    snprintf(data1, sizeof(data1), format, value);
+    tb_trace_i("%s: tbox: %s, libc: %s", format, data0, data1);
+}
+static tb_void_t tb_demo_libc_stdio_bench_printf(tb_char_t const* format, tb_double_t const* values, tb_size_t count)
+{
+    // bench tb_snprintf
+    tb_size_t       i = 0;
+    tb_size_t       size0 = 0;
+    tb_char_t       data[256];
+    tb_hong_t       time0 = tb_mclock();
+    for (i = 0; i < count; i++) size0 += tb_snprintf(data, sizeof(data), format, values[i]);
+    time0 = tb_mclock() - time0;
+
+    // bench snprintf
+    tb_size_t       size1 = 0;
+    tb_hong_t       time1 = tb_mclock();
+    for (i = 0; i < count; i++) size1 += snprintf(data, sizeof(data), format, values[i]);
+    time1 = tb_mclock() - time1;
+
+    // trace
+    tb_trace_i("%s: tb_snprintf: %lld ms, snprintf: %lld ms, size: %lu, %lu", format, time0, time1, size0, size1);
+}
+static tb_void_t tb_demo_libc_stdio_bench_printf_int(tb_long_t const* values, tb_size_t count)
+{
+    // bench tb_snprintf
+    tb_size_t       i = 0;
+    tb_size_t       size0 = 0;
+    tb_char_t       data[256];
+    tb_hong_t       time0 = tb_mclock();
+    for (i = 0; i < count; i++) size0 += tb_snprintf(data, sizeof(data), "%ld", values[i]);
+    time0 = tb_mclock() - time0;
+
+    // bench snprintf
+    tb_size_t       size1 = 0;
+    tb_hong_t       time1 = tb_mclock();
+    for (i = 0; i < count; i++) size1 += snprintf(data, sizeof(data), "%ld", values[i]);
+    time1 = tb_mclock() - time1;
+
+    // trace
+    tb_trace_i("%%ld: tb_snprintf: %lld ms, snprintf: %lld ms, size: %lu, %lu", time0, time1, size0, size1);
+}
+static tb_void_t tb_demo_libc_stdio_bench_strtod(tb_double_t const* values, tb_size_t count)
+{
+    // make strings
+    tb_size_t   i = 0;
+    tb_char_t*  strings = tb_nalloc0_cstr(count, 32);
+    tb_assert_and_check_return(strings);
+    for (i = 0; i < count; i++) tb_snprintf(strings + i * 32, 32, "%~lg", values[i]);
+
+    // bench tb_s10tod and check the round-trip
+    tb_size_t   errors = 0;
+    tb_double_t sum0 = 0;
+    tb_hong_t   time0 = tb_mclock();
+    for (i = 0; i < count; i++) sum0 += tb_s10tod(strings + i * 32);
+    time0 = tb_mclock() - time0;
+    for (i = 0; i < count; i++) 
+    {
+        if (tb_s10tod(strings + i * 32) != values[i]) errors++;
+    }
+
+    // bench strtod
+    tb_double_t sum1 = 0;
+    tb_hong_t   time1 = tb_mclock();
+    for (i = 0; i < count; i++) sum1 += strtod(strings + i * 32, tb_null);
+    time1 = tb_mclock() - time1;
+
+    // trace
+    tb_trace_i("tb_s10tod: %lld ms, strtod: %lld ms, sum: %lg, %lg, round-trip errors: %lu", time0, time1, sum0, sum1, errors);
+
+    // exit strings
+    tb_free(strings);
+}
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */ 
+tb_int_t tb_demo_libc_stdio_main(tb_int_t argc, tb_char_t** argv)
+{
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+    // format
+    tb_demo_libc_stdio_format("%lf", 3.1415926535897932384626433832795);
+    tb_demo_libc_stdio_format("%.20lf", 0.1);
+    tb_demo_libc_stdio_format("%lf", 1e23);
+    tb_demo_libc_stdio_format("%.0lf", 2.5);
+    tb_demo_libc_stdio_format("%le", 6.02214076e23);
+    tb_demo_libc_stdio_format("%.3le", -1.0005);
+    tb_demo_libc_stdio_format("%lg", 0.1);
+    tb_demo_libc_stdio_format("%lg", 1.0 / 3.0);
+    tb_demo_libc_stdio_format("%lg", 5e-324);
+    tb_demo_libc_stdio_format("%.3lg", 1234567.0);
+    tb_demo_libc_stdio_format("%#.3lg", 1.0);
+    tb_demo_libc_stdio_format("%#lg", 5.0);
+    tb_demo_libc_stdio_format("%12.4lf|", -2.71828);
+
+    // parse
+    tb_trace_i("tb_s10tod: %lg, %lg, %lg, %lg", tb_s10tod("1e23"), tb_s10tod("-2.5e-3"), tb_s10tod("2.2250738585072011e-308"), tb_s10tod("1e400"));
+
+    // make values
+    tb_size_t       i = 0;
+    tb_size_t       count = TB_DEMO_VALUES_MAXN;
+    tb_double_t*    values = tb_nalloc0_type(count, tb_double_t);
+    tb_long_t*      integers = tb_nalloc0_type(count, tb_long_t);
+    if (values && integers)
+    {
+        for (i = 0; i < count; i++) 
+        {
+            values[i] = (tb_double_t)tb_random_range(-1000000000, 1000000000) / (tb_double_t)tb_random_range(1, 1000000);
+            integers[i] = tb_random_range(-1000000000, 1000000000);
+        }
+
+        // bench printf
+        tb_demo_libc_stdio_bench_printf("%lf", values, count);
+        tb_demo_libc_stdio_bench_printf("%.3lf", values, count);
+        tb_demo_libc_stdio_bench_printf("%le", values, count);
+        tb_demo_libc_stdio_bench_printf("%lg", values, count);
+        tb_demo_libc_stdio_bench_printf("%.17lg", values, count);
+        tb_demo_libc_stdio_bench_printf_int(integers, count);
+
+        // bench strtod
+        tb_demo_libc_stdio_bench_strtod(values, count);
+    }
+
+    // exit values
+    if (values) tb_free(values);
+    if (integers) tb_free(integers);
+#endif
+    return 0;
+}
@@ -0,0 +1,234 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */ 
+
+// the demo node type
+typedef struct __tb_demo_node_t
+{
+    // the next node
+    struct __tb_demo_node_t*    next;
+
+    // the child node
+    struct __tb_demo_node_t*    child;
+
+    // the name
+    tb_char_t*                  name;
+
+}tb_demo_node_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * demo
+ */ 
+static tb_demo_node_t* tb_demo_arena_allocator_make(tb_allocator_ref_t allocator, tb_size_t maxn)
+{
+    // make the node tree, like the object or xml document
+    tb_demo_node_t*             root = tb_null;
+    tb_demo_node_t*             parent = tb_null;
+    __tb_volatile__ tb_size_t   indx = 0;
+    __tb_volatile__ tb_size_t   rand = 0xbeaf;
+    for (indx = 0; indx < maxn; indx++)
+    {
+        // make node
+        tb_demo_node_t* node = (tb_demo_node_t*)tb_allocator_malloc0(allocator, sizeof(tb_demo_node_t));
+        tb_assert_and_check_break(node);
+
+        // make name
+        tb_size_t size = (rand & 63) + 1;
+        node->name = (tb_char_t*)tb_allocator_malloc(allocator, size);
+        tb_assert_and_check_break(node->name);
+        tb_memset(node->name, 'x', size - 1);
+        node->name[size - 1] = '\0';
+
+        // insert node
+        if (!root) root = parent = node;
+        else if (!(indx & 15))
+        {
+            node->next = root->child;
+            root->child = node;
+            parent = node;
+        }
+        else 
+        {
+            node->next = parent->child;
+            parent->child = node;
+        }
+
+        // make rand
+        rand = (rand * 10807 + 1) & 0xffffffff;
+    }
+
+    // ok
+    return root;
+}
+static tb_void_t tb_demo_arena_allocator_free(tb_allocator_ref_t allocator, tb_demo_node_t* node)
+{
+    while (node)
+    {
+        // free children
+        tb_demo_arena_allocator_free(allocator, node->child);
+
+        // free node
+        tb_demo_node_t* next = node->next;
+        tb_allocator_free(allocator, node->name);
+        tb_allocator_free(allocator, node);
+        node = next;
+    }
+}
+tb_void_t tb_demo_arena_allocator_perf(tb_noarg_t);
+tb_void_t tb_demo_arena_allocator_perf()
+{
+    // done
+    tb_size_t           maxn = 1000000;
+    tb_allocator_ref_t  small_allocator = tb_null;
+    tb_allocator_ref_t  arena_allocator = tb_null;
+    do
+    {
+        // init small allocator
+        small_allocator = tb_small_allocator_init(tb_null);
+        tb_assert_and_check_break(small_allocator);
+
+        // init arena allocator
+        arena_allocator = tb_arena_allocator_init(tb_null, 0);
+        tb_assert_and_check_break(arena_allocator);
+
+        // make and free the tree with the small allocator
+        tb_hong_t time = tb_mclock();
+        tb_demo_node_t* root = tb_demo_arena_allocator_make(small_allocator, maxn);
+        tb_hong_t make = tb_mclock() - time;
+        tb_demo_arena_allocator_free(small_allocator, root);
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("small: make: %lld ms, total: %lld ms", make, time);
+
+        // make and release the tree with the arena allocator
+        time = tb_mclock();
+        root = tb_demo_arena_allocator_make(arena_allocator, maxn);
+        make = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("arena: size: %lu", tb_arena_allocator_size(arena_allocator));
+
+#ifdef __tb_debug__
+        // dump arena allocator
+        tb_allocator_dump(arena_allocator);
+#endif
+
+        // release all nodes
+        tb_allocator_clear(arena_allocator);
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("arena: make: %lld ms, total: %lld ms", make, time);
+
+    } while (0);
+
+    // exit small allocator
+    if (small_allocator) tb_allocator_exit(small_allocator);
+    small_allocator = tb_null;
+
+    // exit arena allocator
+    if (arena_allocator) tb_allocator_exit(arena_allocator);
+    arena_allocator = tb_null;
+}
+tb_void_t tb_demo_arena_allocator_checkpoint(tb_noarg_t);
+tb_void_t tb_demo_arena_allocator_checkpoint()
+{
+    // done
+    tb_allocator_ref_t arena_allocator = tb_null;
+    do
+    {
+        // init arena allocator with the small chunk
+        arena_allocator = tb_arena_allocator_init(tb_null, 4096);
+        tb_assert_and_check_break(arena_allocator);
+
+        // make the persistent data
+        tb_char_t* data = (tb_char_t*)tb_allocator_malloc(arena_allocator, 64);
+        tb_assert_and_check_break(data);
+        tb_strlcpy(data, "hello arena", 64);
+
+        // grow the last data in place
+        tb_char_t* data_new = (tb_char_t*)tb_allocator_ralloc(arena_allocator, data, 128);
+        tb_trace_i("ralloc: %p => %p, in place: %s", data, data_new, data == data_new? "ok" : "no");
+        data = data_new;
+        tb_assert_and_check_break(data);
+
+        // save the checkpoint
+        tb_arena_allocator_checkpoint_t checkpoint;
+        tb_arena_allocator_save(arena_allocator, &checkpoint);
+        tb_size_t size = tb_arena_allocator_size(arena_allocator);
+
+        // make the temporary data across some chunks
+        tb_size_t i = 0;
+        for (i = 0; i < 1000; i++)
+        {
+            tb_pointer_t temp = tb_allocator_malloc(arena_allocator, 100);
+            tb_assert_and_check_break(temp);
+        }
+        tb_trace_i("size: %lu => %lu", size, tb_arena_allocator_size(arena_allocator));
+
+        // release the temporary data
+        tb_arena_allocator_rollback(arena_allocator, &checkpoint);
+        tb_trace_i("rollback: %lu, data: %s", tb_arena_allocator_size(arena_allocator), data);
+
+#ifdef __tb_debug__
+        // dump arena allocator
+        tb_allocator_dump(arena_allocator);
+#endif
+
+    } while (0);
+
+    // exit arena allocator
+    if (arena_allocator) tb_allocator_exit(arena_allocator);
+    arena_allocator = tb_null;
+}
+tb_void_t tb_demo_arena_allocator_free2(tb_noarg_t);
+tb_void_t tb_demo_arena_allocator_free2()
+{
+    // done
+    tb_allocator_ref_t arena_allocator = tb_null;
+    do
+    {
+        // init arena allocator
+        arena_allocator = tb_arena_allocator_init(tb_null, 0);
+        tb_assert_and_check_break(arena_allocator);
+
+        // make data
+        tb_pointer_t data = tb_allocator_malloc(arena_allocator, 10);
+        tb_assert_and_check_break(data);
+    
+        // exit data
+        tb_allocator_free(arena_allocator, data);
+        tb_allocator_free(arena_allocator, data);
+
+    } while (0);
+
+    // exit arena allocator
+    if (arena_allocator) tb_allocator_exit(arena_allocator);
+    arena_allocator = tb_null;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */ 
+tb_int_t tb_demo_memory_arena_allocator_main(tb_int_t argc, tb_char_t** argv)
+{
+#if 1
+    tb_demo_arena_allocator_perf();
+#endif
+
+#if 1
+    tb_demo_arena_allocator_checkpoint();
+#endif
+
+#if 0
+    tb_demo_arena_allocator_free2();
+#endif
+
+    return 0;
+}
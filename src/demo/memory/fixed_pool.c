@@ -187,6 +187,71 @@ tb_void_t tb_demo_fixed_pool_perf(tb_size_t item_size)
     // exit pool
     if (pool) tb_fixed_pool_exit(pool);
 }
+static tb_bool_t tb_demo_fixed_pool_walk_func(tb_pointer_t data, tb_cpointer_t priv)
+{
+    // count it
+    if (priv) (*((tb_size_t*)priv))++;
+    return tb_true;
+}
+tb_void_t tb_demo_fixed_pool_live(tb_size_t item_size, tb_size_t count);
+tb_void_t tb_demo_fixed_pool_live(tb_size_t item_size, tb_size_t count)
+{
+    // done
+    tb_fixed_pool_ref_t pool = tb_null;
+    tb_pointer_t*       list = tb_null;
+    do
+    {
+        // init pool
+        pool = tb_fixed_pool_init(tb_null, 0, item_size, tb_null, tb_null, tb_null);
+        tb_assert_and_check_break(pool);
+
+        // make data list
+        list = tb_nalloc0_type(count, tb_pointer_t);
+        tb_assert_and_check_break(list);
+
+        // make all items, they are all alive now
+        tb_size_t indx = 0;
+        tb_hong_t time = tb_mclock();
+        for (indx = 0; indx < count; indx++)
+        {
+            list[indx] = tb_fixed_pool_malloc(pool);
+            tb_assert_and_check_break(list[indx]);
+        }
+        tb_hong_t malloc_time = tb_mclock() - time;
+
+        // walk all items
+        tb_size_t walk_count = 0;
+        time = tb_mclock();
+        tb_fixed_pool_walk(pool, tb_demo_fixed_pool_walk_func, &walk_count);
+        tb_hong_t walk_time = tb_mclock() - time;
+
+        // shuffle the data list
+        tb_size_t rand = 0xbeaf;
+        for (indx = count - 1; indx > 0; indx--)
+        {
+            rand = (rand * 10807 + 1) & 0xffffffff;
+            tb_size_t swap = rand % (indx + 1);
+            tb_pointer_t data = list[indx];
+            list[indx] = list[swap];
+            list[swap] = data;
+        }
+
+        // free all items in the random order, the owner slot of every item need be found
+        time = tb_mclock();
+        for (indx = 0; indx < count; indx++) tb_fixed_pool_free(pool, list[indx]);
+        tb_hong_t free_time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("live[%lu]: count: %lu, malloc: %lld ms, walk: %lu items, %lld ms, free: %lld ms, left: %lu", item_size, count, malloc_time, walk_count, walk_time, free_time, tb_fixed_pool_size(pool));
+
+    } while (0);
+
+    // exit list
+    if (list) tb_free(list);
+
+    // exit pool
+    if (pool) tb_fixed_pool_exit(pool);
+}
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
@@ -208,6 +273,11 @@ tb_int_t tb_demo_memory_fixed_pool_main(tb_int_t argc, tb_char_t** argv)
     tb_demo_fixed_pool_perf(3072);
 #endif
 
+#if 1
+    tb_demo_fixed_pool_live(16, 10000000);
+    tb_demo_fixed_pool_live(64, 10000000);
+#endif
+
 #if 0
     tb_demo_fixed_pool_leak();
 #endif
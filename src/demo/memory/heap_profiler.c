@@ -0,0 +1,65 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * demo
+ */ 
+tb_pointer_t tb_demo_heap_profiler_make_small(tb_size_t size);
+tb_pointer_t tb_demo_heap_profiler_make_small(tb_size_t size)
+{
+    return tb_malloc(size);
+}
+tb_pointer_t tb_demo_heap_profiler_make_large(tb_size_t size);
+tb_pointer_t tb_demo_heap_profiler_make_large(tb_size_t size)
+{
+    return tb_malloc(size);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */ 
+tb_int_t tb_demo_memory_heap_profiler_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the profile path
+    tb_char_t const* path = argv[1]? argv[1] : "/tmp/tbox.heap";
+
+    // start the heap profiler of the global allocator, sample one allocation per 64KB 
+    if (!tb_allocator_profile_start(tb_allocator(), 64 * 1024)) return -1;
+
+    // make data
+    tb_size_t       i = 0;
+    tb_size_t       maxn = 100000;
+    tb_pointer_t*   list = (tb_pointer_t*)tb_nalloc0(maxn, sizeof(tb_pointer_t));
+    if (list)
+    {
+        // the small data will be freed, the large data will be leaked until the end
+        for (i = 0; i < maxn; i++)
+        {
+            if (i & 7) list[i] = tb_demo_heap_profiler_make_small((i & 255) + 1);
+            else list[i] = tb_demo_heap_profiler_make_large(4096 + (i & 4095));
+        }
+        for (i = 0; i < maxn; i++)
+        {
+            if (list[i] && (i & 7)) tb_free(list[i]);
+        }
+
+        // dump the allocator statistics
+        tb_allocator_stat_dump(tb_allocator());
+
+        // dump the heap profile, and show it by `pprof --text demo /tmp/tbox.heap`
+        if (tb_allocator_profile_dump(tb_allocator(), path)) tb_trace_i("dump: %s ok", path);
+
+        // free the large data
+        for (i = 0; i < maxn; i++)
+        {
+            if (list[i] && !(i & 7)) tb_free(list[i]);
+        }
+        tb_free(list);
+    }
+
+    // stop the heap profiler
+    tb_allocator_profile_stop(tb_allocator());
+    return 0;
+}
@@ -0,0 +1,120 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_demo_iobuf_dump(tb_char_t const* name, tb_iobuf_ref_t iobuf)
+{
+    tb_char_t data[256];
+    tb_size_t size = tb_iobuf_peek(iobuf, (tb_byte_t*)data, sizeof(data) - 1);
+    data[size] = '\0';
+    tb_trace_i("%s: size: %lu, slices: %lu, data: %s", name, tb_iobuf_size(iobuf), tb_iobuf_slices(iobuf), data);
+}
+static tb_void_t tb_demo_iobuf_test_split()
+{
+    // init iobufs
+    tb_iobuf_ref_t iobuf = tb_iobuf_init(16);
+    tb_iobuf_ref_t head = tb_iobuf_init(16);
+    tb_iobuf_ref_t copy = tb_iobuf_init(16);
+    if (iobuf && head && copy)
+    {
+        // append and prepend data
+        tb_iobuf_append(iobuf, (tb_byte_t const*)"hello world, ", 13);
+        tb_iobuf_append(iobuf, (tb_byte_t const*)"this is a chained buffer!", 25);
+        tb_iobuf_prepend(iobuf, (tb_byte_t const*)"[header]", 8);
+        tb_demo_iobuf_dump("iobuf", iobuf);
+
+        // share all blocks
+        tb_iobuf_append_iobuf(copy, iobuf);
+        tb_demo_iobuf_dump("copy", copy);
+
+        // split the header and the first word without copying
+        tb_iobuf_split(iobuf, head, 13);
+        tb_demo_iobuf_dump("head", head);
+        tb_demo_iobuf_dump("iobuf", iobuf);
+
+        // trim the head and tail
+        tb_iobuf_trim_head(iobuf, 1);
+        tb_iobuf_trim_tail(iobuf, 1);
+        tb_demo_iobuf_dump("trim", iobuf);
+
+        // append data to the shared iobuf, it will not overwrite the data of copy
+        tb_iobuf_append(iobuf, (tb_byte_t const*)"?", 1);
+        tb_demo_iobuf_dump("iobuf", iobuf);
+        tb_demo_iobuf_dump("copy", copy);
+
+        // get the contiguous data across the slices
+        tb_byte_t const* data = tb_iobuf_contiguous(copy, 20);
+        if (data) tb_trace_i("contiguous: %.*s, slices: %lu", 20, data, tb_iobuf_slices(copy));
+    }
+
+    // exit iobufs
+    if (copy) tb_iobuf_exit(copy);
+    if (head) tb_iobuf_exit(head);
+    if (iobuf) tb_iobuf_exit(iobuf);
+}
+static tb_void_t tb_demo_iobuf_test_file(tb_char_t const* path)
+{
+    // init iobuf and file
+    tb_iobuf_ref_t iobuf = tb_iobuf_init(0);
+    tb_file_ref_t  file = tb_file_init(path, TB_FILE_MODE_RW | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC);
+    if (iobuf && file)
+    {
+        // make data
+        tb_size_t i = 0;
+        tb_char_t line[64];
+        for (i = 0; i < 10000; i++)
+        {
+            tb_long_t size = tb_snprintf(line, sizeof(line), "line: %lu\n", i);
+            if (size > 0) tb_iobuf_append(iobuf, (tb_byte_t const*)line, size);
+        }
+        tb_size_t size = tb_iobuf_size(iobuf);
+
+        // write all data
+        tb_hong_t time = tb_mclock();
+        tb_size_t writ = 0;
+        while (tb_iobuf_size(iobuf))
+        {
+            tb_long_t real = tb_iobuf_writv(iobuf, file);
+            if (real <= 0) break;
+            writ += real;
+        }
+        time = tb_mclock() - time;
+        tb_trace_i("writv: %lu/%lu bytes, %lld ms", writ, size, time);
+
+        // read all data
+        tb_file_seek(file, 0, TB_FILE_SEEK_BEG);
+        tb_size_t read = 0;
+        while (1)
+        {
+            tb_long_t real = tb_iobuf_readv(iobuf, file, 65536);
+            if (real <= 0) break;
+            read += real;
+        }
+        tb_trace_i("readv: %lu/%lu bytes, slices: %lu", read, size, tb_iobuf_slices(iobuf));
+
+        // check the last line
+        tb_iobuf_trim_head(iobuf, size - 11);
+        tb_demo_iobuf_dump("last", iobuf);
+    }
+
+    // exit iobuf and file
+    if (file) tb_file_exit(file);
+    if (iobuf) tb_iobuf_exit(iobuf);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */ 
+tb_int_t tb_demo_memory_iobuf_main(tb_int_t argc, tb_char_t** argv)
+{
+    // test split, share and trim
+    tb_demo_iobuf_test_split();
+
+    // test vectored io
+    tb_demo_iobuf_test_file(argc > 1? argv[1] : "/tmp/tbox.iobuf");
+    return 0;
+}
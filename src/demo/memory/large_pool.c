@@ -10,6 +10,8 @@
 // init pool
 #if 1
 #   define tb_demo_init_pool()      tb_large_allocator_init((tb_byte_t*)malloc(500 * 1024 * 1024), 500 * 1024 * 1024)
+#elif 0
+#   define tb_demo_init_pool()      tb_large_allocator_init_with_flags(TB_LARGE_ALLOCATOR_FLAG_HUGE_PAGE, 0)
 #else
 #   define tb_demo_init_pool()      tb_large_allocator_init(tb_null, 0)
 #endif
@@ -227,6 +229,94 @@ tb_void_t tb_demo_large_allocator_perf()
     if (pool) tb_allocator_exit(pool);
 }
 
+tb_void_t tb_demo_large_allocator_decay(tb_noarg_t);
+tb_void_t tb_demo_large_allocator_decay()
+{
+    // init pool, the idle spans will be purged after 100ms
+    tb_allocator_ref_t pool = tb_large_allocator_init_with_flags(TB_LARGE_ALLOCATOR_FLAG_NONE, 100);
+    tb_assert_and_check_return(pool);
+
+    // make data
+    tb_size_t       i = 0;
+    tb_pointer_t    list[256];
+    for (i = 0; i < tb_arrayn(list); i++)
+    {
+        list[i] = tb_allocator_large_malloc(pool, 256 * 1024, tb_null);
+        tb_assert_and_check_break(list[i]);
+        tb_memset(list[i], 0, 256 * 1024);
+    }
+
+    // free data, the idle spans are still resident
+    for (i = 0; i < tb_arrayn(list); i++)
+    {
+        if (list[i]) tb_allocator_large_free(pool, list[i]);
+    }
+
+    // wait the decay time and purge the idle spans on the next free
+    tb_msleep(200);
+    tb_pointer_t data = tb_allocator_large_malloc(pool, 8192, tb_null);
+    if (data) tb_allocator_large_free(pool, data);
+
+#ifdef __tb_debug__
+    // dump pool, the purged size should be not zero
+    tb_allocator_dump(pool);
+#endif
+
+    // exit pool
+    tb_allocator_exit(pool);
+}
+
+static tb_hong_t tb_demo_large_allocator_ralloc_grow(tb_allocator_ref_t pool, tb_size_t size, tb_size_t step)
+{
+    // grow one block in small steps, e.g. appending data to a large buffer
+    tb_size_t       grow = step;
+    tb_hong_t       time = tb_mclock();
+    tb_pointer_t    data = tb_allocator_large_malloc(pool, step, tb_null);
+    tb_assert_and_check_return_val(data, 0);
+    for (grow = step + step; grow <= size; grow += step)
+    {
+        data = tb_allocator_large_ralloc(pool, data, grow, tb_null);
+        tb_assert_and_check_break(data);
+        ((tb_byte_t*)data)[grow - 1] = (tb_byte_t)grow;
+    }
+    time = tb_mclock() - time;
+
+    // free data
+    if (data) tb_allocator_large_free(pool, data);
+    return time;
+}
+tb_void_t tb_demo_large_allocator_ralloc(tb_size_t size, tb_size_t step);
+tb_void_t tb_demo_large_allocator_ralloc(tb_size_t size, tb_size_t step)
+{
+    // grow it by the span allocator
+    tb_allocator_ref_t pool = tb_large_allocator_init_with_flags(TB_LARGE_ALLOCATOR_FLAG_NONE, 0);
+    tb_assert_and_check_return(pool);
+    tb_hong_t span_time = tb_demo_large_allocator_ralloc_grow(pool, size, step);
+    tb_allocator_exit(pool);
+
+    // grow it by the native allocator
+    tb_hong_t native_time = tb_demo_large_allocator_ralloc_grow(tb_native_allocator(), size, step);
+
+    // append data to the buffer by the default allocator
+    tb_buffer_t buffer;
+    if (tb_buffer_init(&buffer))
+    {
+        tb_byte_t   piece[64] = {0};
+        tb_size_t   append = 0;
+        tb_hong_t   time = tb_mclock();
+        for (append = 0; append < size; append += sizeof(piece))
+        {
+            if (!tb_buffer_memncat(&buffer, piece, sizeof(piece))) break;
+        }
+        time = tb_mclock() - time;
+        tb_trace_i("ralloc: buffer: append %lu bytes by %lu bytes: %lld ms", size, sizeof(piece), time);
+        tb_buffer_exit(&buffer);
+    }
+
+    // trace
+    tb_trace_i("ralloc: grow to %lu bytes by %lu bytes, span: %lld ms, native: %lld ms", size, step, span_time, native_time);
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
  */ 
@@ -236,6 +326,14 @@ tb_int_t tb_demo_memory_large_allocator_main(tb_int_t argc, tb_char_t** argv)
     tb_demo_large_allocator_perf();
 #endif
 
+#if 1
+    tb_demo_large_allocator_decay();
+#endif
+
+#if 1
+    tb_demo_large_allocator_ralloc(24 * 1024 * 1024, 64);
+#endif
+
 #if 0
     tb_demo_large_allocator_leak();
 #endif
@@ -67,6 +67,10 @@ tb_int_t tb_demo_network_http_main(tb_int_t argc, tb_char_t** argv)
         t = tb_mclock() - t;
         tb_trace_i("open: %llu ms", t);
 
+        // trace the response header
+        tb_char_t const* server = tb_http_response_header(http, "Server");
+        if (server) tb_trace_i("server: %s", server);
+
         // read data
         tb_byte_t       data[8192];
         tb_size_t       read = 0;
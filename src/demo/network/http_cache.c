@@ -0,0 +1,75 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default request count
+#define TB_DEMO_HTTP_CACHE_COUNT        (10)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_hize_t tb_demo_http_cache_fetch(tb_http_ref_t http, tb_char_t const* url)
+{
+    // open it
+    tb_hize_t read = 0;
+    if (!tb_http_ctrl(http, TB_HTTP_OPTION_SET_URL, url)) return 0;
+    if (!tb_http_open(http)) return 0;
+
+    // read all data
+    tb_byte_t data[TB_STREAM_BLOCK_MAXN];
+    tb_hong_t size = tb_http_status(http)->content_size;
+    while (size < 0 || read < (tb_hize_t)size)
+    {
+        tb_size_t need = size < 0? sizeof(data) : (tb_size_t)tb_min((tb_hize_t)size - read, (tb_hize_t)sizeof(data));
+        if (!tb_http_bread(http, data, need)) break;
+        read += need;
+    }
+
+    // close it
+    tb_http_clos(http);
+    return read;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_network_http_cache_main(tb_int_t argc, tb_char_t** argv)
+{
+    // check
+    tb_assert_and_check_return_val(argc > 1 && argv[1], -1);
+
+    // the request count and the disk store directory
+    tb_size_t           count = argc > 2? tb_atoi(argv[2]) : TB_DEMO_HTTP_CACHE_COUNT;
+    tb_char_t const*    rootdir = argc > 3? argv[3] : tb_null;
+
+    // init cache and http
+    tb_http_cache_ref_t cache = tb_http_cache_init(rootdir, 0);
+    tb_http_ref_t       http = tb_http_init();
+    if (cache && http && tb_http_ctrl(http, TB_HTTP_OPTION_SET_CACHE, cache))
+    {
+        // fetch it repeatedly, only the first request need the network if it is fresh
+        tb_size_t i = 0;
+        for (i = 0; i < count; i++)
+        {
+            tb_hong_t time = tb_uclock();
+            tb_hize_t size = tb_demo_http_cache_fetch(http, argv[1]);
+            tb_trace_i("[%lu]: code: %lu, size: %llu, %lld us", i, tb_http_status(http)->code, size, tb_uclock() - time);
+        }
+
+        // trace stats
+        tb_http_cache_stats_t stats;
+        tb_http_cache_stats(cache, &stats);
+        tb_trace_i("stats: hits: %lu, misses: %lu, revalidations: %lu, stores: %lu, evictions: %lu, count: %lu, size: %lu"
+            , stats.hits, stats.misses, stats.revalidations, stats.stores, stats.evictions, stats.count, stats.size);
+    }
+
+    // exit http and cache
+    if (http) tb_http_exit(http);
+    if (cache) tb_http_cache_exit(cache);
+    return 0;
+}
@@ -0,0 +1,388 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+#   define TB_DEMO_HTTP_SERVER_ENABLE
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the port
+#define TB_DEMO_PORT                (8080)
+
+// timeout
+#define TB_DEMO_TIMEOUT             (5000)
+
+// the default connection count of the benchmark
+#define TB_DEMO_BENCH_CONNS         (64)
+
+// the default pipelined requests of each round
+#define TB_DEMO_BENCH_DEPTH         (16)
+
+// the default rounds of each connection
+#define TB_DEMO_BENCH_ROUNDS        (200)
+
+// the root directory for the static files of the benchmark
+#define TB_DEMO_BENCH_ROOTDIR       "/tmp/tbox_http_server"
+
+#ifdef TB_DEMO_HTTP_SERVER_ENABLE
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the benchmark context type
+typedef struct __tb_demo_bench_t
+{
+    // the server address
+    tb_ipaddr_t         addr;
+
+    // the rounds of each connection
+    tb_size_t           rounds;
+
+    // the pipelined requests of each round
+    tb_size_t           depth;
+
+    // the finished requests
+    tb_size_t           finished;
+
+    // the failed connections
+    tb_size_t           failed;
+
+    // the total latency (us) of all rounds
+    tb_hong_t           latency;
+
+    // the maximum latency (us)
+    tb_hong_t           latency_max;
+
+}tb_demo_bench_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * routes
+ */
+static tb_bool_t tb_demo_http_hello(tb_http_server_request_t const* request, tb_http_server_response_ref_t response, tb_cpointer_t priv)
+{
+    static tb_char_t const s_hello[] = "hello world!";
+    tb_http_server_response_header(response, "Content-Type", "text/plain");
+    return tb_http_server_response_body(response, (tb_byte_t const*)s_hello, sizeof(s_hello) - 1);
+}
+static tb_bool_t tb_demo_http_echo(tb_http_server_request_t const* request, tb_http_server_response_ref_t response, tb_cpointer_t priv)
+{
+    // echo the request body, the chunked body has been decoded
+    tb_char_t const* type = tb_http_server_request_header(request, "Content-Type");
+    tb_http_server_response_header(response, "Content-Type", type? type : "application/octet-stream");
+    return tb_http_server_response_body(response, request->body, request->body_size);
+}
+static tb_bool_t tb_demo_http_stream(tb_http_server_request_t const* request, tb_http_server_response_ref_t response, tb_cpointer_t priv)
+{
+    // stream the query string three times with the chunked encoding
+    tb_size_t i = 0;
+    tb_http_server_response_header(response, "Content-Type", "text/plain");
+    for (i = 0; i < 3; i++)
+    {
+        if (!tb_http_server_response_chunk(response, (tb_byte_t const*)request->query, request->query_size)) return tb_false;
+    }
+    return tb_http_server_response_chunk(response, tb_null, 0);
+}
+static tb_http_server_ref_t tb_demo_http_server_init(tb_ipaddr_ref_t addr, tb_char_t const* rootdir)
+{
+    // init server
+    tb_http_server_ref_t server = tb_http_server_init(addr, 0);
+    tb_assert_and_check_return_val(server, tb_null);
+
+    // add routes
+    if (    !tb_http_server_route(server, TB_HTTP_METHOD_GET, "/hello", tb_demo_http_hello, tb_null)
+        ||  !tb_http_server_route(server, TB_HTTP_METHOD_POST, "/echo", tb_demo_http_echo, tb_null)
+        ||  !tb_http_server_route(server, TB_HTTP_METHOD_GET, "/stream", tb_demo_http_stream, tb_null)
+        ||  !tb_http_server_route_static(server, "/", rootdir)
+        ||  !tb_http_server_start(server))
+    {
+        tb_http_server_exit(server);
+        server = tb_null;
+    }
+    return server;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * client
+ */
+static tb_socket_ref_t tb_demo_client_connect(tb_ipaddr_ref_t addr)
+{
+    // init socket
+    tb_socket_ref_t sock = tb_socket_init(TB_SOCKET_TYPE_TCP, tb_ipaddr_family(addr));
+    tb_assert_and_check_return_val(sock, tb_null);
+
+    // connect it
+    tb_long_t ok = 0;
+    while (!(ok = tb_socket_connect(sock, addr)))
+    {
+        if (tb_socket_wait(sock, TB_SOCKET_EVENT_CONN, TB_DEMO_TIMEOUT) <= 0) break;
+    }
+    if (ok <= 0)
+    {
+        tb_socket_exit(sock);
+        sock = tb_null;
+    }
+    return sock;
+}
+static tb_bool_t tb_demo_client_send(tb_socket_ref_t sock, tb_char_t const* data, tb_size_t size)
+{
+    tb_size_t send = 0;
+    tb_long_t wait = 0;
+    while (send < size)
+    {
+        tb_long_t real = tb_socket_send(sock, (tb_byte_t const*)data + send, size - send);
+        if (real > 0)
+        {
+            send += real;
+            wait = 0;
+        }
+        else if (!real && !wait)
+        {
+            wait = tb_socket_wait(sock, TB_SOCKET_EVENT_SEND, TB_DEMO_TIMEOUT);
+            tb_check_break(wait > 0);
+        }
+        else break;
+    }
+    return send == size;
+}
+static tb_long_t tb_demo_client_recv(tb_socket_ref_t sock, tb_char_t* data, tb_size_t size)
+{
+    tb_long_t real = 0;
+    tb_long_t wait = 0;
+    while (!(real = tb_socket_recv(sock, (tb_byte_t*)data, size)) && !wait)
+    {
+        wait = tb_socket_wait(sock, TB_SOCKET_EVENT_RECV, TB_DEMO_TIMEOUT);
+        tb_check_break(wait > 0);
+    }
+    return real > 0? real : -1;
+}
+static tb_bool_t tb_demo_client_check(tb_ipaddr_ref_t addr, tb_char_t const* request, tb_char_t const* body, tb_char_t const* expected)
+{
+    // connect it
+    tb_socket_ref_t sock = tb_demo_client_connect(addr);
+    tb_assert_and_check_return_val(sock, tb_false);
+
+    // send the request and read the response until the server closes it
+    tb_size_t size = 0;
+    tb_long_t real = 0;
+    tb_char_t data[8192];
+    if (tb_demo_client_send(sock, request, tb_strlen(request)))
+    {
+        // send the body after receiving the interim response
+        if (body && (real = tb_demo_client_recv(sock, data, sizeof(data) - 1)) > 0)
+        {
+            size += real;
+            if (!tb_demo_client_send(sock, body, tb_strlen(body))) real = -1;
+        }
+        while (real >= 0 && size + 1 < sizeof(data) && (real = tb_demo_client_recv(sock, data + size, sizeof(data) - size - 1)) > 0)
+            size += real;
+    }
+    data[size] = '\0';
+    tb_socket_exit(sock);
+
+    // check it
+    tb_char_t line[64];
+    tb_bool_t ok = tb_strstr(data, expected) != tb_null;
+    tb_strlcpy(line, request, sizeof(line));
+    tb_char_t* end = tb_strchr(line, '\r');
+    if (end) *end = '\0';
+    tb_trace_i("[check]: %s: %s", line, ok? "ok" : "failed");
+    if (!ok) tb_trace_i("%s", data);
+    return ok;
+}
+static tb_size_t tb_demo_client_parse(tb_char_t* data, tb_size_t* psize)
+{
+    // parse and remove all complete responses
+    tb_size_t count = 0;
+    tb_char_t* p = data;
+    tb_char_t* e = data + *psize;
+    while (p < e)
+    {
+        *e = '\0';
+        tb_char_t* head = tb_strstr(p, "\r\n\r\n");
+        tb_check_break(head);
+        tb_char_t* clen = tb_stristr(p, "Content-Length:");
+        tb_size_t  size = (head + 4 - p) + ((clen && clen < head)? tb_atoi(clen + 15) : 0);
+        tb_check_break(size <= (tb_size_t)(e - p));
+        p += size;
+        count++;
+    }
+    *psize = e - p;
+    if (*psize) tb_memmov(data, p, *psize);
+    return count;
+}
+static tb_void_t tb_demo_client_bench(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_bench_t* bench = (tb_demo_bench_t*)priv;
+    tb_assert_and_check_return(bench);
+
+    // make the pipelined requests
+    static tb_char_t const s_request[] = "GET /hello HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    tb_size_t   i = 0;
+    tb_size_t   size = 0;
+    tb_char_t*  requests = tb_malloc_cstr(bench->depth * (sizeof(s_request) - 1) + 1);
+    tb_char_t*  data = tb_malloc_cstr(65536 + 1);
+    tb_socket_ref_t sock = tb_demo_client_connect(&bench->addr);
+    if (requests && data && sock)
+    {
+        for (i = 0; i < bench->depth; i++)
+            tb_memcpy(requests + i * (sizeof(s_request) - 1), s_request, sizeof(s_request) - 1);
+
+        // send all requests of each round together and wait all responses
+        for (i = 0; i < bench->rounds; i++)
+        {
+            tb_hong_t time = tb_uclock();
+            if (!tb_demo_client_send(sock, requests, bench->depth * (sizeof(s_request) - 1))) break;
+
+            tb_size_t count = 0;
+            while (count < bench->depth)
+            {
+                tb_long_t real = tb_demo_client_recv(sock, data + size, 65536 - size);
+                if (real <= 0) break;
+                size += real;
+                count += tb_demo_client_parse(data, &size);
+            }
+            if (count != bench->depth) break;
+
+            time = tb_uclock() - time;
+            bench->finished += count;
+            bench->latency += time;
+            if (time > bench->latency_max) bench->latency_max = time;
+        }
+    }
+    if (i != bench->rounds) bench->failed++;
+
+    // exit it
+    if (sock) tb_socket_exit(sock);
+    if (data) tb_free(data);
+    if (requests) tb_free(requests);
+}
+static tb_int_t tb_demo_client_thread(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_bench_t* bench = (tb_demo_bench_t*)priv;
+    tb_assert_and_check_return_val(bench, -1);
+
+    // check the routes
+    tb_ipaddr_ref_t addr = &bench->addr;
+    tb_demo_client_check(addr, "GET /hello HTTP/1.1\r\nConnection: close\r\n\r\n", tb_null, "\r\n\r\nhello world!");
+    tb_demo_client_check(addr, "HEAD /hello HTTP/1.1\r\nConnection: close\r\n\r\n", tb_null, "Content-Length: 12\r\n");
+    tb_demo_client_check(addr, "POST /echo HTTP/1.1\r\nConnection: close\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhello\r\n7;ext=1\r\n world!\r\n0\r\n\r\n", tb_null, "Content-Length: 12\r\n\r\nhello world!");
+    tb_demo_client_check(addr, "POST /echo HTTP/1.1\r\nConnection: close\r\nContent-Length: 5\r\nExpect: 100-continue\r\n\r\n", "hello", "HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 200 OK");
+    tb_demo_client_check(addr, "GET /stream?abc HTTP/1.1\r\nConnection: close\r\n\r\n", tb_null, "\r\n\r\n3\r\nabc\r\n3\r\nabc\r\n3\r\nabc\r\n0\r\n\r\n");
+    tb_demo_client_check(addr, "GET /stream?abc HTTP/1.0\r\n\r\n", tb_null, "\r\n\r\nabcabcabc");
+    tb_demo_client_check(addr, "GET /hello HTTP/1.1\r\n\r\nGET /index.html HTTP/1.1\r\n\r\nDELETE /hello HTTP/1.1\r\nConnection: close\r\n\r\n", tb_null, "hello world!HTTP/1.1 200 OK");
+    tb_demo_client_check(addr, "GET / HTTP/1.1\r\nConnection: close\r\n\r\n", tb_null, "Content-Type: text/html\r\n");
+    tb_demo_client_check(addr, "GET /index.html HTTP/1.1\r\nConnection: close\r\nIf-Modified-Since: Fri, 31 Dec 2100 23:59:59 GMT\r\n\r\n", tb_null, "HTTP/1.1 304 Not Modified");
+    tb_demo_client_check(addr, "GET /../etc/passwd HTTP/1.1\r\nConnection: close\r\n\r\n", tb_null, "HTTP/1.1 403 Forbidden");
+    tb_demo_client_check(addr, "GET /missing HTTP/1.1\r\nConnection: close\r\n\r\n", tb_null, "HTTP/1.1 404 Not Found");
+    tb_demo_client_check(addr, "DELETE /hello HTTP/1.1\r\nConnection: close\r\n\r\n", tb_null, "HTTP/1.1 405 Method Not Allowed");
+    tb_demo_client_check(addr, "BREW /hello HTTP/1.1\r\n\r\n", tb_null, "HTTP/1.1 501 Not Implemented");
+    tb_demo_client_check(addr, "GET /hello HTTP/1.1\r\nContent-Length: 1\r\nTransfer-Encoding: chunked\r\n\r\n", tb_null, "HTTP/1.1 400 Bad Request");
+
+    // run the benchmark connections in the coroutines
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        tb_size_t i = 0;
+        tb_size_t conns = bench->finished;
+        bench->finished = 0;
+        for (i = 0; i < conns; i++)
+            tb_coroutine_start(scheduler, tb_demo_client_bench, bench, 0);
+
+        // the server workers are running in the other threads, so it cannot be the exclusive scheduler
+        tb_co_scheduler_loop(scheduler, tb_false);
+        tb_co_scheduler_exit(scheduler);
+    }
+    return 0;
+}
+static tb_void_t tb_demo_http_server_bench(tb_size_t conns, tb_size_t depth, tb_size_t rounds)
+{
+    // make the index file for the static route
+    static tb_char_t const s_index[] = "<html><body>hello tbox!</body></html>";
+    tb_directory_create(TB_DEMO_BENCH_ROOTDIR);
+    tb_file_ref_t file = tb_file_init(TB_DEMO_BENCH_ROOTDIR "/index.html", TB_FILE_MODE_WO | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC);
+    if (file)
+    {
+        tb_file_writ(file, (tb_byte_t const*)s_index, sizeof(s_index) - 1);
+        tb_file_exit(file);
+    }
+
+    // init server with a random port
+    tb_ipaddr_t addr;
+    tb_ipaddr_set(&addr, "127.0.0.1", 0, TB_IPADDR_FAMILY_IPV4);
+    tb_http_server_ref_t server = tb_demo_http_server_init(&addr, TB_DEMO_BENCH_ROOTDIR);
+    if (server)
+    {
+        // init bench, the connection count is passed by the finished count before running
+        tb_demo_bench_t bench;
+        tb_memset(&bench, 0, sizeof(bench));
+        bench.depth     = depth;
+        bench.rounds    = rounds;
+        bench.finished  = conns;
+        tb_http_server_addr(server, &bench.addr);
+
+        // run the clients in the other thread
+        tb_hong_t       time = tb_mclock();
+        tb_thread_ref_t thread = tb_thread_init(tb_null, tb_demo_client_thread, &bench, 0);
+        if (thread)
+        {
+            tb_thread_wait(thread, -1, tb_null);
+            tb_thread_exit(thread);
+        }
+        time = tb_max(tb_mclock() - time, 1);
+
+        // trace
+        tb_size_t rounds_total = bench.finished / tb_max(depth, 1);
+        tb_trace_i("[bench]: conns: %lu, depth: %lu, requests: %lu, failed: %lu, %lld ms, %lld requests/s, latency: %lld us (avg), %lld us (max)"
+                    , conns, depth, bench.finished, bench.failed, time, ((tb_hong_t)bench.finished * 1000) / time
+                    , rounds_total? bench.latency / (tb_hong_t)rounds_total : 0, bench.latency_max);
+
+        // exit server
+        tb_http_server_exit(server);
+    }
+
+    // remove the index file
+    tb_directory_remove(TB_DEMO_BENCH_ROOTDIR);
+}
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_network_http_server_main(tb_int_t argc, tb_char_t** argv)
+{
+#ifdef TB_DEMO_HTTP_SERVER_ENABLE
+    // run the benchmark with the local clients, e.g. http_server bench [conns] [depth] [rounds]
+    if (argc > 1 && !tb_strcmp(argv[1], "bench"))
+    {
+        tb_size_t conns     = argc > 2? tb_atoi(argv[2]) : TB_DEMO_BENCH_CONNS;
+        tb_size_t depth     = argc > 3? tb_atoi(argv[3]) : TB_DEMO_BENCH_DEPTH;
+        tb_size_t rounds    = argc > 4? tb_atoi(argv[4]) : TB_DEMO_BENCH_ROUNDS;
+        tb_assert_and_check_return_val(conns && depth && rounds, -1);
+        tb_demo_http_server_bench(conns, depth, rounds);
+        return 0;
+    }
+
+    // serve the given directory for the given seconds or forever, e.g. http_server [rootdir] [seconds]
+    tb_size_t   seconds = argc > 2? tb_atoi(argv[2]) : 0;
+    tb_ipaddr_t addr;
+    tb_ipaddr_set(&addr, tb_null, TB_DEMO_PORT, TB_IPADDR_FAMILY_IPV4);
+    tb_http_server_ref_t server = tb_demo_http_server_init(&addr, argc > 1? argv[1] : ".");
+    if (server)
+    {
+        tb_trace_i("listening %{ipaddr} ..", &addr);
+        tb_bool_t forever = !seconds;
+        while (forever || seconds--) tb_sleep(1);
+        tb_http_server_exit(server);
+    }
+#else
+    tb_trace_i("http server is not supported without the coroutine module!");
+#endif
+    return 0;
+}
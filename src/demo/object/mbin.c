@@ -0,0 +1,164 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default item count of the snapshot
+#define TB_DEMO_MBIN_COUNT          (20000)
+
+// the default lookup count
+#define TB_DEMO_MBIN_LOOKUPS        (10000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the format type
+typedef struct __tb_demo_mbin_format_t
+{
+    // the name
+    tb_char_t const*    name;
+
+    // the format
+    tb_size_t           format;
+
+}tb_demo_mbin_format_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the formats
+static tb_demo_mbin_format_t g_formats[] =
+{
+    {"bin",     TB_OBJECT_FORMAT_BIN    }
+,   {"bplist",  TB_OBJECT_FORMAT_BPLIST }
+,   {"json",    TB_OBJECT_FORMAT_JSON   }
+,   {"mbin",    TB_OBJECT_FORMAT_MBIN   }
+};
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_object_ref_t tb_demo_mbin_snapshot(tb_size_t count)
+{
+    // init root
+    tb_object_ref_t root = tb_oc_dictionary_init(TB_OC_DICTIONARY_SIZE_LARGE, tb_false);
+    tb_assert_and_check_return_val(root, tb_null);
+
+    // {"item_0": {"id": 0, "name": "name_0", "enabled": true, "tags": ["tag_0", "tag_1", "tag_2"]}, ...}
+    tb_size_t i = 0;
+    tb_char_t key[64];
+    for (i = 0; i < count; i++)
+    {
+        tb_object_ref_t item = tb_oc_dictionary_init(TB_OC_DICTIONARY_SIZE_MICRO, tb_false);
+        tb_object_ref_t tags = tb_oc_array_init(8, tb_false);
+        tb_assert_and_check_break(item && tags);
+
+        tb_size_t j = 0;
+        for (j = 0; j < 3; j++)
+        {
+            tb_snprintf(key, sizeof(key), "tag_%lu", (i + j) & 0xff);
+            tb_oc_array_append(tags, tb_oc_string_init_from_cstr(key));
+        }
+        tb_snprintf(key, sizeof(key), "name_%lu", i);
+        tb_oc_dictionary_insert(item, "id", tb_oc_number_init_from_sint64((tb_sint64_t)i));
+        tb_oc_dictionary_insert(item, "name", tb_oc_string_init_from_cstr(key));
+        tb_oc_dictionary_insert(item, "enabled", tb_oc_boolean_init(i & 1));
+        tb_oc_dictionary_insert(item, "tags", tags);
+
+        tb_snprintf(key, sizeof(key), "item_%lu", i);
+        tb_oc_dictionary_insert(root, key, item);
+    }
+    return root;
+}
+static tb_size_t tb_demo_mbin_lookup(tb_object_ref_t root, tb_size_t count, tb_size_t lookups)
+{
+    // lookup the random items and check them
+    tb_size_t i = 0;
+    tb_size_t failed = 0;
+    tb_char_t key[64];
+    for (i = 0; i < lookups; i++)
+    {
+        tb_size_t index = (tb_size_t)(((tb_uint64_t)i * 2654435761ul) % count);
+        tb_snprintf(key, sizeof(key), "item_%lu", index);
+        tb_object_ref_t item = tb_oc_dictionary_value(root, key);
+        tb_object_ref_t id = item? tb_oc_dictionary_value(item, "id") : tb_null;
+        tb_object_ref_t tags = item? tb_oc_dictionary_value(item, "tags") : tb_null;
+        if (!id || tb_oc_number_sint64(id) != (tb_sint64_t)index || !tags || tb_oc_array_size(tags) != 3) failed++;
+    }
+    return failed;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_object_mbin_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the item count and lookups
+    tb_size_t count = argc > 1? tb_atoi(argv[1]) : TB_DEMO_MBIN_COUNT;
+    tb_size_t lookups = argc > 2? tb_atoi(argv[2]) : TB_DEMO_MBIN_LOOKUPS;
+    tb_assert_and_check_return_val(count, -1);
+
+    // make snapshot
+    tb_hong_t time = tb_mclock();
+    tb_object_ref_t snapshot = tb_demo_mbin_snapshot(count);
+    tb_assert_and_check_return_val(snapshot, -1);
+    tb_trace_i("[snapshot]: items: %lu, %lld ms", count, tb_mclock() - time);
+
+    // writ and read all formats
+    tb_size_t i = 0;
+    tb_char_t path[TB_PATH_MAXN];
+    for (i = 0; i < tb_arrayn(g_formats); i++)
+    {
+        // writ it
+        tb_snprintf(path, sizeof(path), "/tmp/tbox_object_snapshot.%s", g_formats[i].name);
+        time = tb_mclock();
+        tb_long_t size = tb_object_writ_to_url(snapshot, path, g_formats[i].format);
+        tb_hong_t writ_time = tb_mclock() - time;
+
+        // read it and lookup items
+        time = tb_mclock();
+        tb_object_ref_t object = tb_object_read_from_url(path);
+        tb_hong_t read_time = tb_mclock() - time;
+        time = tb_mclock();
+        tb_size_t failed = object? tb_demo_mbin_lookup(object, count, lookups) : lookups;
+        tb_hong_t lookup_time = tb_mclock() - time;
+        if (object) tb_object_exit(object);
+
+        // trace
+        tb_trace_i("[%s]: size: %ld, writ: %lld ms, read: %lld ms, lookup %lu: %lld ms, failed: %lu"
+            , g_formats[i].name, size, writ_time, read_time, lookups, lookup_time, failed);
+    }
+
+    // map the mbin file and lookup items lazily
+    time = tb_mclock();
+    tb_object_ref_t object = tb_object_read_from_map("/tmp/tbox_object_snapshot.mbin");
+    tb_hong_t map_time = tb_mclock() - time;
+    if (object)
+    {
+        // lookup items
+        time = tb_mclock();
+        tb_size_t failed = tb_demo_mbin_lookup(object, count, lookups);
+        tb_hong_t lookup_time = tb_mclock() - time;
+        tb_trace_i("[mbin(map)]: map: %lld ms, lookup %lu: %lld ms, failed: %lu", map_time, lookups, lookup_time, failed);
+
+        // load all items
+        time = tb_mclock();
+        tb_object_ref_t copy = tb_object_copy(object);
+        tb_hong_t load_time = tb_mclock() - time;
+        tb_trace_i("[mbin(map)]: load all %lu items: %lld ms", copy? tb_oc_dictionary_size(copy) : 0, load_time);
+        if (copy) tb_object_exit(copy);
+
+        // exit object
+        tb_object_exit(object);
+    }
+
+    // exit snapshot
+    tb_object_exit(snapshot);
+    return 0;
+}
@@ -0,0 +1,98 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the walk statistics type
+typedef struct __tb_demo_walk_stats_t
+{
+    // the file count
+    tb_atomic_t         files;
+
+    // the directory count
+    tb_atomic_t         directories;
+
+    // the path hash for checking the walking order
+    tb_size_t           hash;
+
+}tb_demo_walk_stats_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * callback
+ */
+static tb_bool_t tb_demo_directory_walk_func(tb_char_t const* path, tb_file_info_t const* info, tb_cpointer_t priv)
+{
+    // check
+    tb_demo_walk_stats_t* stats = (tb_demo_walk_stats_t*)priv;
+    tb_assert_and_check_return_val(path && info && stats, tb_false);
+
+    // count it
+    if (info->type == TB_FILE_TYPE_DIRECTORY) tb_atomic_fetch_and_inc(&stats->directories);
+    else tb_atomic_fetch_and_inc(&stats->files);
+
+    // continue
+    return tb_true;
+}
+static tb_bool_t tb_demo_directory_walk_func_ordered(tb_char_t const* path, tb_file_info_t const* info, tb_cpointer_t priv)
+{
+    // check
+    tb_demo_walk_stats_t* stats = (tb_demo_walk_stats_t*)priv;
+    tb_assert_and_check_return_val(path && info && stats, tb_false);
+
+    // update the path hash, it depends on the walking order
+    stats->hash = stats->hash * 31 + tb_bkdr_make_from_cstr(path, 0);
+
+    // count it
+    return tb_demo_directory_walk_func(path, info, priv);
+}
+static tb_void_t tb_demo_directory_walk_trace(tb_char_t const* name, tb_demo_walk_stats_t* stats, tb_hong_t time)
+{
+    tb_trace_i("%s: files: %ld, directories: %ld, hash: %lx, %lld ms", name, tb_atomic_get(&stats->files), tb_atomic_get(&stats->directories), stats->hash, time);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_platform_directory_walk_main(tb_int_t argc, tb_char_t** argv)
+{
+    // check
+    tb_assert_and_check_return_val(argc > 1 && argv[1], -1);
+
+    // the worker count
+    tb_size_t workers = argc > 2? tb_atoi(argv[2]) : 0;
+
+    // walk it serially
+    tb_demo_walk_stats_t stats = {0};
+    tb_hong_t time = tb_mclock();
+    tb_directory_walk(argv[1], tb_true, tb_true, tb_demo_directory_walk_func_ordered, &stats);
+    tb_demo_directory_walk_trace("walk", &stats, tb_mclock() - time);
+
+    // walk it in parallel with the same order
+    tb_memset(&stats, 0, sizeof(stats));
+    time = tb_mclock();
+    tb_directory_walk_parallel(argv[1], TB_DIRECTORY_WALK_FLAG_RECURSION | TB_DIRECTORY_WALK_FLAG_PREFIX | TB_DIRECTORY_WALK_FLAG_ORDERED, workers, tb_demo_directory_walk_func_ordered, &stats);
+    tb_demo_directory_walk_trace("walk_parallel(ordered)", &stats, tb_mclock() - time);
+
+    // walk it in parallel and get the file type only
+    tb_memset(&stats, 0, sizeof(stats));
+    time = tb_mclock();
+    tb_directory_walk_parallel(argv[1], TB_DIRECTORY_WALK_FLAG_RECURSION | TB_DIRECTORY_WALK_FLAG_TYPEONLY, workers, tb_demo_directory_walk_func, &stats);
+    tb_demo_directory_walk_trace("walk_parallel(typeonly)", &stats, tb_mclock() - time);
+
+    // copy and remove it
+    if (argc > 3 && argv[3])
+    {
+        time = tb_mclock();
+        tb_bool_t ok = tb_directory_copy(argv[1], argv[3]);
+        tb_trace_i("copy: %s => %s: %s, %lld ms", argv[1], argv[3], ok? "ok" : "failed", tb_mclock() - time);
+
+        time = tb_mclock();
+        ok = tb_directory_remove(argv[3]);
+        tb_trace_i("remove: %s: %s, %lld ms", argv[3], ok? "ok" : "failed", tb_mclock() - time);
+    }
+    return 0;
+}
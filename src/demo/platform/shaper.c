@@ -0,0 +1,136 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default global rate, bytes/s
+#define TB_DEMO_SHAPER_RATE         (8 << 20)
+
+// the default tenant count
+#define TB_DEMO_SHAPER_TENANTS      (4)
+
+// the maximum tenant count
+#define TB_DEMO_SHAPER_TENANTS_MAXN (16)
+
+// the default seconds
+#define TB_DEMO_SHAPER_SECONDS      (3)
+
+// the block size
+#define TB_DEMO_SHAPER_BLOCK        (65536)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the tenant type
+typedef struct __tb_demo_tenant_t
+{
+    // the shaper
+    tb_shaper_ref_t     shaper;
+
+    // the thread
+    tb_thread_ref_t     thread;
+
+    // the transferred size
+    tb_hize_t           size;
+
+    // the maximum size in 100ms
+    tb_size_t           burst;
+
+}tb_demo_tenant_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the stop time
+static tb_hong_t        g_stop = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_int_t tb_demo_tenant_func(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_tenant_t* tenant = (tb_demo_tenant_t*)priv;
+    tb_assert_and_check_return_val(tenant, -1);
+
+    // send the dummy data until it is stopped
+    tb_hong_t time = tb_mclock();
+    tb_size_t size100ms = 0;
+    while (1)
+    {
+        tb_hong_t now = tb_mclock();
+        tb_check_break(now < g_stop);
+
+        // update the maximum size in 100ms
+        if (now >= time + 100)
+        {
+            if (size100ms > tenant->burst) tenant->burst = size100ms;
+            size100ms = 0;
+            time = now;
+        }
+
+        // send it and wait the shaper
+        tb_size_t size = tb_shaper_quota(tenant->shaper, TB_DEMO_SHAPER_BLOCK);
+        tb_shaper_wait(tenant->shaper, size);
+        tenant->size += size;
+        size100ms += size;
+    }
+    return 0;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_platform_shaper_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the global rate, tenants and seconds
+    tb_size_t rate      = argc > 1? tb_atoi(argv[1]) : TB_DEMO_SHAPER_RATE;
+    tb_size_t tenants   = argc > 2? tb_atoi(argv[2]) : TB_DEMO_SHAPER_TENANTS;
+    tb_size_t seconds   = argc > 3? tb_atoi(argv[3]) : TB_DEMO_SHAPER_SECONDS;
+    tb_assert_and_check_return_val(rate && tenants && tenants <= TB_DEMO_SHAPER_TENANTS_MAXN && seconds, -1);
+
+    // init the global shaper
+    tb_shaper_ref_t global = tb_shaper_init(rate, 0, tb_null);
+    tb_assert_and_check_return_val(global, -1);
+
+    /* init tenants, the first tenant is limited to 1/8 of the global rate, 
+     * and the others share the left rate of the global shaper
+     */
+    tb_size_t           i = 0;
+    tb_demo_tenant_t    list[TB_DEMO_SHAPER_TENANTS_MAXN] = {{0}};
+    g_stop = tb_mclock() + seconds * 1000;
+    for (i = 0; i < tenants; i++)
+    {
+        list[i].shaper = tb_shaper_init(i? 0 : rate >> 3, 0, global);
+        if (list[i].shaper) list[i].thread = tb_thread_init(tb_null, tb_demo_tenant_func, &list[i], 0);
+    }
+
+    // wait tenants
+    tb_hize_t total = 0;
+    for (i = 0; i < tenants; i++)
+    {
+        if (list[i].thread)
+        {
+            tb_thread_wait(list[i].thread, -1, tb_null);
+            tb_thread_exit(list[i].thread);
+        }
+        if (list[i].shaper) tb_shaper_exit(list[i].shaper);
+        total += list[i].size;
+
+        // trace
+        tb_trace_i("[tenant: %lu]: limit: %lu, rate: %llu bytes/s, burst: %lu bytes/100ms", i, i? 0 : rate >> 3, list[i].size / seconds, list[i].burst);
+    }
+
+    // trace
+    tb_trace_i("[global]: limit: %lu, rate: %llu bytes/s", rate, total / seconds);
+
+    // exit the global shaper
+    tb_shaper_exit(global);
+    return 0;
+}
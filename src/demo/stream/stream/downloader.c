@@ -0,0 +1,72 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_downloader_func(tb_size_t state, tb_char_t const* url, tb_char_t const* path, tb_hong_t size, tb_hize_t save, tb_cpointer_t priv)
+{
+    tb_trace_i("[downloader]: %s => %s: %s, size: %lld, save: %llu", url, path, tb_state_cstr(state), size, save);
+}
+static tb_int_t tb_demo_downloader_killer(tb_cpointer_t priv)
+{
+    // kill the downloader after a while, the progress will be kept for resuming it next time
+    tb_msleep(1000);
+    tb_downloader_kill((tb_downloader_ref_t)priv);
+    return 0;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_stream_downloader_main(tb_int_t argc, tb_char_t** argv)
+{
+    // check
+    tb_assert_and_check_return_val(argc > 2 && argv[1] && argv[2], -1);
+
+    // the option
+    tb_downloader_option_t option = {0};
+    if (argc > 3) option.task_connections = tb_atoi(argv[3]);
+    if (argc > 4) option.limitrate = tb_atoi(argv[4]);
+
+    // download it sequentially with one stream first
+    tb_char_t path[TB_PATH_MAXN];
+    tb_snprintf(path, sizeof(path), "%s.transfer", argv[2]);
+    tb_hong_t time = tb_mclock();
+    tb_hong_t save = tb_transfer_url(argv[1], path, option.limitrate, tb_null, tb_null);
+    time = tb_mclock() - time;
+    tb_trace_i("[transfer]: save: %lld bytes, %lld ms, %lld KB/s", save, time, time? save / time : 0);
+    tb_file_remove(path);
+
+    // download it concurrently with the ranged requests
+    tb_downloader_ref_t downloader = tb_downloader_init(&option);
+    if (downloader)
+    {
+        // add task
+        tb_downloader_add(downloader, argv[1], argv[2], tb_demo_downloader_func, tb_null);
+
+        // kill it after 1s for testing the resuming? e.g. xmake r demo stream_downloader url path 4 0 kill
+        tb_thread_ref_t thread = tb_null;
+        if (argc > 5 && !tb_strcmp(argv[5], "kill"))
+            thread = tb_thread_init(tb_null, tb_demo_downloader_killer, downloader, 0);
+
+        // done it
+        time = tb_mclock();
+        tb_bool_t ok = tb_downloader_done(downloader);
+        time = tb_mclock() - time;
+        tb_trace_i("[downloader]: %s, %lld ms", ok? "ok" : "failed", time);
+
+        // exit thread
+        if (thread)
+        {
+            tb_thread_wait(thread, -1, tb_null);
+            tb_thread_exit(thread);
+        }
+
+        // exit downloader
+        tb_downloader_exit(downloader);
+    }
+    return 0;
+}
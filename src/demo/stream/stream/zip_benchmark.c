@@ -0,0 +1,198 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */ 
+#ifdef TB_CONFIG_MODULE_HAVE_ZIP
+static tb_bool_t tb_demo_stream_zip_load(tb_char_t const* url, tb_buffer_ref_t data)
+{
+    // init stream
+    tb_stream_ref_t stream = tb_stream_init_from_url(url);
+    tb_assert_and_check_return_val(stream, tb_false);
+
+    // load data
+    tb_bool_t ok = tb_false;
+    if (tb_stream_open(stream))
+    {
+        tb_byte_t block[TB_STREAM_BLOCK_MAXN];
+        while (!tb_stream_beof(stream))
+        {
+            tb_long_t real = tb_stream_read(stream, block, sizeof(block));
+            if (real > 0) tb_buffer_memncat(data, block, real);
+            else if (!real)
+            {
+                real = tb_stream_wait(stream, TB_STREAM_WAIT_READ, tb_stream_timeout(stream));
+                tb_check_break(real > 0);
+            }
+            else break;
+        }
+        ok = tb_buffer_size(data)? tb_true : tb_false;
+    }
+
+    // exit stream
+    tb_stream_exit(stream);
+    return ok;
+}
+static tb_void_t tb_demo_stream_zip_make(tb_buffer_ref_t data, tb_size_t size)
+{
+    // make some compressible text data
+    static tb_char_t const* s_words[] = {"tbox", "stream", "zip", "filter", "coroutine", "http", "buffer", "object", " ", "\n", "1234", "{\"key\": \"value\"}, "};
+    while (tb_buffer_size(data) < size)
+    {
+        tb_char_t const* word = s_words[tb_random_range(0, tb_arrayn(s_words))];
+        tb_buffer_memncat(data, (tb_byte_t const*)word, tb_strlen(word));
+    }
+}
+static tb_bool_t tb_demo_stream_zip_spak(tb_size_t algo, tb_size_t action, tb_long_t level, tb_size_t workers, tb_byte_t const* idata, tb_size_t isize, tb_buffer_ref_t odata)
+{
+    // init streams
+    tb_stream_ref_t istream = tb_stream_init_from_data(idata, isize);
+    tb_stream_ref_t fstream = istream? tb_stream_init_filter_from_zip(istream, algo, action) : tb_null;
+
+    // done
+    tb_bool_t ok = tb_false;
+    do
+    {
+        // check
+        tb_assert_and_check_break(istream && fstream);
+
+        // set level
+        tb_filter_ref_t filter = tb_null;
+        if (!tb_stream_ctrl(fstream, TB_STREAM_CTRL_FLTR_GET_FILTER, &filter) || !filter) break;
+        if (!tb_filter_ctrl(filter, TB_FILTER_CTRL_ZIP_SET_LEVEL, level)) break;
+
+        // set the parallel deflater
+        if (workers > 1 && !tb_filter_ctrl(filter, TB_FILTER_CTRL_ZIP_SET_PARALLEL, workers, (tb_size_t)0)) break;
+
+        // open stream
+        if (!tb_stream_open(fstream)) break;
+
+        // spak data
+        tb_buffer_clear(odata);
+        tb_byte_t block[TB_STREAM_BLOCK_MAXN];
+        while (!tb_stream_beof(fstream))
+        {
+            tb_long_t real = tb_stream_read(fstream, block, sizeof(block));
+            if (real > 0) tb_buffer_memncat(odata, block, real);
+            else if (!real)
+            {
+                real = tb_stream_wait(fstream, TB_STREAM_WAIT_READ, tb_stream_timeout(fstream));
+                tb_check_break(real > 0);
+            }
+            else break;
+        }
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // exit streams
+    if (fstream) tb_stream_exit(fstream);
+    if (istream) tb_stream_exit(istream);
+    return ok;
+}
+static tb_hong_t tb_demo_stream_zip_rate(tb_size_t size, tb_hong_t time)
+{
+    // the rate: MB/s
+    return (((tb_hong_t)size * 1000) / tb_max(time, 1)) >> 20;
+}
+static tb_void_t tb_demo_stream_zip_test(tb_size_t algo, tb_long_t level, tb_size_t workers, tb_buffer_ref_t data)
+{
+    // init buffers
+    tb_buffer_t zdata;
+    tb_buffer_t udata;
+    if (!tb_buffer_init(&zdata)) return ;
+    if (!tb_buffer_init(&udata)) 
+    {
+        tb_buffer_exit(&zdata);
+        return ;
+    }
+
+    // deflate data
+    tb_hong_t dtime = tb_mclock();
+    tb_bool_t ok = tb_demo_stream_zip_spak(algo, TB_ZIP_ACTION_DEFLATE, level, workers, tb_buffer_data(data), tb_buffer_size(data), &zdata);
+    dtime = tb_mclock() - dtime;
+
+    // inflate data
+    tb_hong_t itime = tb_mclock();
+    if (ok) ok = tb_demo_stream_zip_spak(algo, TB_ZIP_ACTION_INFLATE, level, 0, tb_buffer_data(&zdata), tb_buffer_size(&zdata), &udata);
+    itime = tb_mclock() - itime;
+
+    // check data
+    if (ok) ok = (tb_buffer_size(&udata) == tb_buffer_size(data) && !tb_memcmp(tb_buffer_data(&udata), tb_buffer_data(data), tb_buffer_size(data)))? tb_true : tb_false;
+
+    // trace
+    tb_size_t ratio = (tb_size_t)(((tb_hize_t)tb_buffer_size(&zdata) * 10000) / tb_max(tb_buffer_size(data), 1));
+    tb_trace_i("%-8s x%-2lu: %lu => %lu bytes, ratio: %lu.%02lu%%, deflate: %lld MB/s, inflate: %lld MB/s, %s"
+            , tb_zip_algo_name(algo)
+            , tb_max(workers, 1)
+            , tb_buffer_size(data)
+            , tb_buffer_size(&zdata)
+            , ratio / 100, ratio % 100
+            , tb_demo_stream_zip_rate(tb_buffer_size(data), dtime)
+            , tb_demo_stream_zip_rate(tb_buffer_size(data), itime)
+            , ok? "ok" : "failed");
+
+    // exit buffers
+    tb_buffer_exit(&zdata);
+    tb_buffer_exit(&udata);
+}
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */ 
+#ifdef TB_CONFIG_MODULE_HAVE_ZIP
+tb_int_t tb_demo_stream_zip_benchmark_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init data
+    tb_buffer_t data;
+    if (!tb_buffer_init(&data)) return -1;
+
+    // load data from the given url or make 16MB text data
+    if (argc > 1 && argv[1]) 
+    {
+        if (!tb_demo_stream_zip_load(argv[1], &data))
+        {
+            tb_trace_e("load %s failed!", argv[1]);
+            tb_buffer_exit(&data);
+            return -1;
+        }
+    }
+    else tb_demo_stream_zip_make(&data, 16 * 1024 * 1024);
+
+    // the level
+    tb_long_t level = argc > 2 && argv[2]? tb_atoi(argv[2]) : TB_ZIP_LEVEL_DEFAULT;
+
+    // the worker count of the parallel deflater
+    tb_size_t workers = argc > 3 && argv[3]? tb_atoi(argv[3]) : tb_processor_count();
+
+    // test all supported algorithms
+    tb_size_t algo = TB_ZIP_ALGO_ZLIBRAW;
+    for (; algo <= TB_ZIP_ALGO_BROTLI; algo++)
+    {
+        if (tb_zip_algo_supported(algo)) 
+        {
+            // test it
+            tb_demo_stream_zip_test(algo, level, 1, &data);
+
+            // test the parallel deflater
+            if (workers > 1 && algo <= TB_ZIP_ALGO_GZIP) tb_demo_stream_zip_test(algo, level, workers, &data);
+        }
+        else tb_trace_i("%-8s: not supported", tb_zip_algo_name(algo));
+    }
+
+    // exit data
+    tb_buffer_exit(&data);
+    return 0;
+}
+#else
+tb_int_t tb_demo_stream_zip_benchmark_main(tb_int_t argc, tb_char_t** argv)
+{
+    return 0;
+}
+#endif
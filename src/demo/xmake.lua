@@ -85,5 +85,5 @@ target("demo")
     if is_option("charset") then add_files("other/charset.c") end
 
     -- add the source files for the database module
-    if is_option("database") then add_files("database/sql.c") end
+    if is_option("database") then add_files("database/*.c") end
     
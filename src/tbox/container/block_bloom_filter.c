@@ -0,0 +1,872 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        block_bloom_filter.c
+ * @ingroup     container
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "block_bloom_filter"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "block_bloom_filter.h"
+#include "../libc/libc.h"
+#include "../hash/xxh3.h"
+#include "../utils/utils.h"
+#include "../memory/memory.h"
+#include "../platform/platform.h"
+
+/* enable the avx2 probes with the function target attributes, 
+ * and we will check the cpu features at runtime
+ */
+#if (defined(TB_ARCH_x86) || defined(TB_ARCH_x64)) \
+        && ((defined(TB_COMPILER_IS_GCC) && TB_COMPILER_VERSION_BE(5, 0)) || defined(TB_COMPILER_IS_CLANG))
+#   define TB_BLOCK_BLOOM_FILTER_AVX2
+#   include <immintrin.h>
+#elif defined(TB_ARCH_ARM64)
+#   define TB_BLOCK_BLOOM_FILTER_NEON
+#   include <arm_neon.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the block words, 8 x 32-bits words, one block is 256-bits
+#define TB_BLOCK_BLOOM_FILTER_BLOCK_WORDS           (8)
+
+// the block size
+#define TB_BLOCK_BLOOM_FILTER_BLOCK_SIZE            (TB_BLOCK_BLOOM_FILTER_BLOCK_WORDS << 2)
+
+// the counters size of one block, 4-bits counter for every bit
+#define TB_BLOCK_BLOOM_FILTER_COUNTERS_SIZE         (TB_BLOCK_BLOOM_FILTER_BLOCK_SIZE << 2)
+
+// the counter maxn, it will be sticky if the counter is saturated
+#define TB_BLOCK_BLOOM_FILTER_COUNTER_MAXN          (15)
+
+// the probability maxn
+#define TB_BLOCK_BLOOM_FILTER_PROBABILITY_MAXN      (24)
+
+// the layer maxn for the scalable mode
+#define TB_BLOCK_BLOOM_FILTER_LAYER_MAXN            (32)
+
+// the batch size for the list operations
+#define TB_BLOCK_BLOOM_FILTER_BATCH_SIZE            (16)
+
+// the item default maxn
+#ifdef __tb_small__
+#   define TB_BLOCK_BLOOM_FILTER_ITEM_MAXN_DEFAULT  TB_BLOOM_FILTER_ITEM_MAXN_MICRO
+#else
+#   define TB_BLOCK_BLOOM_FILTER_ITEM_MAXN_DEFAULT  TB_BLOOM_FILTER_ITEM_MAXN_SMALL
+#endif
+
+// the serialized data magic and version
+#define TB_BLOCK_BLOOM_FILTER_DATA_MAGIC            "TBBF"
+#define TB_BLOCK_BLOOM_FILTER_DATA_VERSION          (1)
+
+// the serialized header size: magic(4) version(1) mode(1) probability(1) layers(1) type(4) size(4) seed(8)
+#define TB_BLOCK_BLOOM_FILTER_DATA_HEAD_SIZE        (24)
+
+// the serialized layer header size: capacity(8) count(8) blocks(8)
+#define TB_BLOCK_BLOOM_FILTER_DATA_LAYER_SIZE       (24)
+
+// prefetch the block
+#if defined(TB_COMPILER_IS_GCC) || defined(TB_COMPILER_IS_CLANG)
+#   define tb_block_bloom_filter_prefetch(p)        __builtin_prefetch(p)
+#else
+#   define tb_block_bloom_filter_prefetch(p)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the block bloom filter layer type
+typedef struct __tb_block_bloom_filter_layer_t
+{
+    // the blocks, 32-bytes aligned
+    tb_uint32_t*            blocks;
+
+    // the 4-bits counters, only for the counting mode
+    tb_byte_t*              counters;
+
+    // the blocks count
+    tb_size_t               nblocks;
+
+    // the capacity
+    tb_size_t               capacity;
+
+    // the items count
+    tb_size_t               count;
+
+}tb_block_bloom_filter_layer_t;
+
+// the block bloom filter type
+typedef struct __tb_block_bloom_filter_t
+{
+    // the mode
+    tb_size_t                       mode;
+
+    // the probability
+    tb_size_t                       probability;
+
+    // the element
+    tb_element_t                    element;
+
+    // the hash seed
+    tb_uint64_t                     seed;
+
+    // the layers count
+    tb_size_t                       layer_count;
+
+    // the layers, only the scalable mode has more than one layer
+    tb_block_bloom_filter_layer_t   layers[TB_BLOCK_BLOOM_FILTER_LAYER_MAXN];
+
+    // probe the block, return tb_true if all bits have been set
+    tb_bool_t                       (*probe_get)(tb_uint32_t const* block, tb_uint32_t hash);
+
+    // set the block bits, return tb_true if there are new bits
+    tb_bool_t                       (*probe_set)(tb_uint32_t* block, tb_uint32_t hash);
+
+}tb_block_bloom_filter_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the salts for selecting the bit of every word
+static tb_uint32_t const g_salts[TB_BLOCK_BLOOM_FILTER_BLOCK_WORDS] = 
+{
+    0x47b6137b, 0x44974d91, 0x8824ad5b, 0xa2b7289d, 0x705495c7, 0x2df1424b, 0x9efc4947, 0x5c6bfb31
+};
+
+/* the bits per item (x16) for the probability 1/2^p, p: [1, 24]
+ *
+ * fpp(b) = sum(poisson(k, 256 / b) * (1 - (31/32)^k)^8)
+ */
+static tb_uint16_t const g_bits_per_item[TB_BLOCK_BLOOM_FILTER_PROBABILITY_MAXN] = 
+{
+    52,     72,     90,     110,    130,    153,    178,    206
+,   237,    272,    311,    356,    406,    464,    529,    605
+,   692,    792,    909,    1045,   1205,   1393,   1616,   1881
+};
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * probes
+ */
+static tb_bool_t tb_block_bloom_filter_probe_get_generic(tb_uint32_t const* block, tb_uint32_t hash)
+{
+    tb_size_t i = 0;
+    for (i = 0; i < TB_BLOCK_BLOOM_FILTER_BLOCK_WORDS; i++)
+    {
+        if (!(block[i] & ((tb_uint32_t)1 << ((hash * g_salts[i]) >> 27)))) return tb_false;
+    }
+    return tb_true;
+}
+static tb_bool_t tb_block_bloom_filter_probe_set_generic(tb_uint32_t* block, tb_uint32_t hash)
+{
+    tb_size_t i = 0;
+    tb_uint32_t news = 0;
+    for (i = 0; i < TB_BLOCK_BLOOM_FILTER_BLOCK_WORDS; i++)
+    {
+        tb_uint32_t mask = (tb_uint32_t)1 << ((hash * g_salts[i]) >> 27);
+        news |= ~block[i] & mask;
+        block[i] |= mask;
+    }
+    return news? tb_true : tb_false;
+}
+#if defined(TB_BLOCK_BLOOM_FILTER_AVX2)
+static __tb_inline__ tb_bool_t tb_block_bloom_filter_has_avx2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2")? tb_true : tb_false;
+}
+__attribute__((target("avx2"))) static __tb_inline__ __m256i tb_block_bloom_filter_probe_mask_avx2(tb_uint32_t hash)
+{
+    // bit = (hash * salt) >> 27, mask = 1 << bit
+    __m256i salts   = _mm256_loadu_si256((__m256i const*)g_salts);
+    __m256i bits    = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32((tb_int_t)hash), salts), 27);
+    return _mm256_sllv_epi32(_mm256_set1_epi32(1), bits);
+}
+__attribute__((target("avx2"))) static tb_bool_t tb_block_bloom_filter_probe_get_avx2(tb_uint32_t const* block, tb_uint32_t hash)
+{
+    // (~block & mask) == 0?
+    return _mm256_testc_si256(_mm256_load_si256((__m256i const*)block), tb_block_bloom_filter_probe_mask_avx2(hash))? tb_true : tb_false;
+}
+__attribute__((target("avx2"))) static tb_bool_t tb_block_bloom_filter_probe_set_avx2(tb_uint32_t* block, tb_uint32_t hash)
+{
+    __m256i mask = tb_block_bloom_filter_probe_mask_avx2(hash);
+    __m256i data = _mm256_load_si256((__m256i const*)block);
+    _mm256_store_si256((__m256i*)block, _mm256_or_si256(data, mask));
+    return _mm256_testc_si256(data, mask)? tb_false : tb_true;
+}
+#elif defined(TB_BLOCK_BLOOM_FILTER_NEON)
+static __tb_inline__ tb_void_t tb_block_bloom_filter_probe_mask_neon(tb_uint32_t hash, uint32x4_t* mask0, uint32x4_t* mask1)
+{
+    // bit = (hash * salt) >> 27, mask = 1 << bit
+    uint32x4_t h = vdupq_n_u32(hash);
+    uint32x4_t b = vdupq_n_u32(1);
+    *mask0 = vshlq_u32(b, vreinterpretq_s32_u32(vshrq_n_u32(vmulq_u32(h, vld1q_u32(g_salts)), 27)));
+    *mask1 = vshlq_u32(b, vreinterpretq_s32_u32(vshrq_n_u32(vmulq_u32(h, vld1q_u32(g_salts + 4)), 27)));
+}
+static tb_bool_t tb_block_bloom_filter_probe_get_neon(tb_uint32_t const* block, tb_uint32_t hash)
+{
+    uint32x4_t mask0;
+    uint32x4_t mask1;
+    tb_block_bloom_filter_probe_mask_neon(hash, &mask0, &mask1);
+
+    // (~block & mask) == 0?
+    uint32x4_t miss = vorrq_u32(vbicq_u32(mask0, vld1q_u32(block)), vbicq_u32(mask1, vld1q_u32(block + 4)));
+    return vmaxvq_u32(miss)? tb_false : tb_true;
+}
+static tb_bool_t tb_block_bloom_filter_probe_set_neon(tb_uint32_t* block, tb_uint32_t hash)
+{
+    uint32x4_t mask0;
+    uint32x4_t mask1;
+    tb_block_bloom_filter_probe_mask_neon(hash, &mask0, &mask1);
+
+    // set bits
+    uint32x4_t data0 = vld1q_u32(block);
+    uint32x4_t data1 = vld1q_u32(block + 4);
+    vst1q_u32(block, vorrq_u32(data0, mask0));
+    vst1q_u32(block + 4, vorrq_u32(data1, mask1));
+    return vmaxvq_u32(vorrq_u32(vbicq_u32(mask0, data0), vbicq_u32(mask1, data1)))? tb_true : tb_false;
+}
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static __tb_inline__ tb_uint64_t tb_block_bloom_filter_hash_mix(tb_uint64_t value)
+{
+    // the murmur3 finalizer
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+static tb_uint64_t tb_block_bloom_filter_hash(tb_block_bloom_filter_t* filter, tb_cpointer_t data)
+{
+    /* we use the stable xxh3 hash with the filter seed for the str, mem and integer elements,
+     * so the saved filter can be loaded and used in the other process
+     */
+    switch (filter->element.type)
+    {
+    case TB_ELEMENT_TYPE_STR:
+        return tb_xxh3_make_from_cstr((tb_char_t const*)data, filter->seed);
+    case TB_ELEMENT_TYPE_MEM:
+        return tb_xxh3_make((tb_byte_t const*)data, filter->element.size, filter->seed);
+    case TB_ELEMENT_TYPE_LONG:
+    case TB_ELEMENT_TYPE_SIZE:
+    case TB_ELEMENT_TYPE_UINT8:
+    case TB_ELEMENT_TYPE_UINT16:
+    case TB_ELEMENT_TYPE_UINT32:
+    case TB_ELEMENT_TYPE_PTR:
+        return tb_block_bloom_filter_hash_mix((tb_uint64_t)(tb_size_t)data ^ filter->seed);
+    default:
+        break;
+    }
+
+    // the other elements
+    tb_assert(filter->element.hash);
+    return tb_block_bloom_filter_hash_mix((tb_uint64_t)filter->element.hash(&filter->element, data, (tb_size_t)-1, 0) ^ filter->seed);
+}
+static __tb_inline__ tb_size_t tb_block_bloom_filter_block(tb_block_bloom_filter_layer_t const* layer, tb_uint64_t hash)
+{
+    // map the high 32-bits to [0, nblocks) without the modulo
+    return (tb_size_t)(((hash >> 32) * (tb_uint64_t)layer->nblocks) >> 32);
+}
+static tb_size_t tb_block_bloom_filter_layer_nblocks(tb_size_t probability, tb_size_t capacity)
+{
+    // check
+    tb_assert_and_check_return_val(probability && probability <= TB_BLOCK_BLOOM_FILTER_PROBABILITY_MAXN && capacity, 0);
+
+    // compute the blocks count
+    tb_uint64_t bits    = ((tb_uint64_t)capacity * g_bits_per_item[probability - 1] + 15) >> 4;
+    tb_uint64_t nblocks = (bits + 255) >> 8;
+    tb_assert_and_check_return_val(nblocks && nblocks < TB_MAXU32 && nblocks <= (tb_size_t)-1 / TB_BLOCK_BLOOM_FILTER_COUNTERS_SIZE, 0);
+
+    // ok
+    return (tb_size_t)nblocks;
+}
+static tb_bool_t tb_block_bloom_filter_layer_init(tb_block_bloom_filter_t* filter, tb_block_bloom_filter_layer_t* layer, tb_size_t probability, tb_size_t capacity)
+{
+    // compute the blocks count
+    tb_size_t nblocks = tb_block_bloom_filter_layer_nblocks(probability, capacity);
+    tb_check_return_val(nblocks, tb_false);
+
+    // init layer
+    layer->capacity = capacity;
+    layer->nblocks  = nblocks;
+    layer->count    = 0;
+
+    // make blocks
+    layer->blocks = (tb_uint32_t*)tb_allocator_align_malloc0(tb_allocator(), layer->nblocks * TB_BLOCK_BLOOM_FILTER_BLOCK_SIZE, TB_BLOCK_BLOOM_FILTER_BLOCK_SIZE);
+    tb_assert_and_check_return_val(layer->blocks, tb_false);
+
+    // make counters
+    if (filter->mode == TB_BLOCK_BLOOM_FILTER_MODE_COUNTING)
+    {
+        layer->counters = tb_malloc0_bytes(layer->nblocks * TB_BLOCK_BLOOM_FILTER_COUNTERS_SIZE);
+        tb_assert_and_check_return_val(layer->counters, tb_false);
+    }
+
+    // trace
+    tb_trace_d("layer: probability: %lu, capacity: %lu, blocks: %lu", probability, capacity, layer->nblocks);
+
+    // ok
+    return tb_true;
+}
+static tb_void_t tb_block_bloom_filter_layer_exit(tb_block_bloom_filter_layer_t* layer)
+{
+    // exit blocks
+    if (layer->blocks) tb_allocator_align_free(tb_allocator(), layer->blocks);
+    layer->blocks = tb_null;
+
+    // exit counters
+    if (layer->counters) tb_free(layer->counters);
+    layer->counters = tb_null;
+}
+static tb_size_t tb_block_bloom_filter_layer_probability(tb_block_bloom_filter_t* filter, tb_size_t index)
+{
+    /* the probability of the layer i is p / 2^(i + 1) for the scalable mode, 
+     * so the total probability is less than p
+     */
+    tb_size_t probability = filter->probability;
+    if (filter->mode == TB_BLOCK_BLOOM_FILTER_MODE_SCALABLE) probability += index + 1;
+    return tb_min(probability, TB_BLOCK_BLOOM_FILTER_PROBABILITY_MAXN);
+}
+static tb_bool_t tb_block_bloom_filter_grow(tb_block_bloom_filter_t* filter)
+{
+    // check
+    tb_assert_and_check_return_val(filter->layer_count, tb_false);
+
+    // full?
+    tb_size_t index = filter->layer_count;
+    tb_check_return_val(index < TB_BLOCK_BLOOM_FILTER_LAYER_MAXN, tb_false);
+
+    // the capacity, x2
+    tb_size_t capacity = filter->layers[index - 1].capacity;
+    tb_check_return_val(capacity <= ((tb_size_t)-1 >> 1), tb_false);
+    capacity <<= 1;
+
+    // init the new layer
+    tb_block_bloom_filter_layer_t* layer = &filter->layers[index];
+    if (!tb_block_bloom_filter_layer_init(filter, layer, tb_block_bloom_filter_layer_probability(filter, index), capacity))
+    {
+        tb_block_bloom_filter_layer_exit(layer);
+        return tb_false;
+    }
+    filter->layer_count++;
+
+    // ok
+    return tb_true;
+}
+static __tb_inline__ tb_void_t tb_block_bloom_filter_prefetch_hash(tb_block_bloom_filter_t* filter, tb_uint64_t hash)
+{
+    tb_size_t i = 0;
+    for (i = 0; i < filter->layer_count; i++)
+    {
+        tb_block_bloom_filter_layer_t const* layer = &filter->layers[i];
+        tb_block_bloom_filter_prefetch(layer->blocks + tb_block_bloom_filter_block(layer, hash) * TB_BLOCK_BLOOM_FILTER_BLOCK_WORDS);
+    }
+}
+static tb_bool_t tb_block_bloom_filter_get_hash(tb_block_bloom_filter_t* filter, tb_uint64_t hash)
+{
+    // probe all layers, the newest layer first
+    tb_size_t i = filter->layer_count;
+    while (i--)
+    {
+        tb_block_bloom_filter_layer_t const* layer = &filter->layers[i];
+        if (filter->probe_get(layer->blocks + tb_block_bloom_filter_block(layer, hash) * TB_BLOCK_BLOOM_FILTER_BLOCK_WORDS, (tb_uint32_t)hash)) 
+            return tb_true;
+    }
+    return tb_false;
+}
+static tb_bool_t tb_block_bloom_filter_set_hash(tb_block_bloom_filter_t* filter, tb_uint64_t hash)
+{
+    // check
+    tb_assert_and_check_return_val(filter->layer_count, tb_false);
+
+    // the counting mode?
+    tb_bool_t ok = tb_false;
+    if (filter->mode == TB_BLOCK_BLOOM_FILTER_MODE_COUNTING)
+    {
+        // the block
+        tb_block_bloom_filter_layer_t*  layer   = &filter->layers[0];
+        tb_size_t                       index   = tb_block_bloom_filter_block(layer, hash);
+        tb_uint32_t*                    block   = layer->blocks + index * TB_BLOCK_BLOOM_FILTER_BLOCK_WORDS;
+        tb_byte_t*                      counters = layer->counters + index * TB_BLOCK_BLOOM_FILTER_COUNTERS_SIZE;
+
+        // increase the counters, the saturated counter will be sticky
+        tb_size_t i = 0;
+        for (i = 0; i < TB_BLOCK_BLOOM_FILTER_BLOCK_WORDS; i++)
+        {
+            tb_size_t   bit     = (i << 5) + (((tb_uint32_t)hash * g_salts[i]) >> 27);
+            tb_byte_t*  pcount  = counters + (bit >> 1);
+            tb_size_t   shift   = (bit & 1) << 2;
+            tb_size_t   count   = (*pcount >> shift) & 0xf;
+            if (count < TB_BLOCK_BLOOM_FILTER_COUNTER_MAXN) *pcount += (tb_byte_t)(1 << shift);
+        }
+
+        // set bits
+        ok = filter->probe_set(block, (tb_uint32_t)hash);
+
+        // the duplicate items are counted too
+        layer->count++;
+        return ok;
+    }
+
+    // the scalable mode? we need check all layers first
+    if (filter->mode == TB_BLOCK_BLOOM_FILTER_MODE_SCALABLE)
+    {
+        // exists?
+        if (tb_block_bloom_filter_get_hash(filter, hash)) return tb_false;
+
+        // grow it if the newest layer is full, we will continue to use the full layer if grow failed
+        if (filter->layers[filter->layer_count - 1].count >= filter->layers[filter->layer_count - 1].capacity)
+            tb_block_bloom_filter_grow(filter);
+    }
+
+    // set bits to the newest layer
+    tb_block_bloom_filter_layer_t* layer = &filter->layers[filter->layer_count - 1];
+    ok = filter->probe_set(layer->blocks + tb_block_bloom_filter_block(layer, hash) * TB_BLOCK_BLOOM_FILTER_BLOCK_WORDS, (tb_uint32_t)hash);
+    if (ok) layer->count++;
+    return ok;
+}
+static tb_bool_t tb_block_bloom_filter_init_probes(tb_block_bloom_filter_t* filter)
+{
+    // init the default probes
+    filter->probe_get = tb_block_bloom_filter_probe_get_generic;
+    filter->probe_set = tb_block_bloom_filter_probe_set_generic;
+
+#if defined(TB_BLOCK_BLOOM_FILTER_AVX2)
+    if (tb_block_bloom_filter_has_avx2())
+    {
+        filter->probe_get = tb_block_bloom_filter_probe_get_avx2;
+        filter->probe_set = tb_block_bloom_filter_probe_set_avx2;
+    }
+#elif defined(TB_BLOCK_BLOOM_FILTER_NEON)
+    filter->probe_get = tb_block_bloom_filter_probe_get_neon;
+    filter->probe_set = tb_block_bloom_filter_probe_set_neon;
+#endif
+
+    // ok
+    return tb_true;
+}
+static tb_block_bloom_filter_t* tb_block_bloom_filter_make(tb_size_t mode, tb_size_t probability, tb_element_t element)
+{
+    // check
+    tb_assert_and_check_return_val(mode <= TB_BLOCK_BLOOM_FILTER_MODE_SCALABLE, tb_null);
+    tb_assert_and_check_return_val(probability && probability <= TB_BLOCK_BLOOM_FILTER_PROBABILITY_MAXN, tb_null);
+    tb_assert_and_check_return_val(element.type == TB_ELEMENT_TYPE_MEM? element.size : tb_true, tb_null);
+
+    // make filter
+    tb_block_bloom_filter_t* filter = tb_malloc0_type(tb_block_bloom_filter_t);
+    tb_assert_and_check_return_val(filter, tb_null);
+
+    // init filter
+    filter->mode        = mode;
+    filter->element     = element;
+    filter->probability = probability;
+    tb_block_bloom_filter_init_probes(filter);
+
+    // ok
+    return filter;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_block_bloom_filter_ref_t tb_block_bloom_filter_init(tb_size_t mode, tb_size_t probability, tb_size_t item_maxn, tb_element_t element)
+{
+    // done
+    tb_bool_t                   ok = tb_false;
+    tb_block_bloom_filter_t*    filter = tb_null;
+    do
+    {
+        // make filter
+        filter = tb_block_bloom_filter_make(mode, probability, element);
+        tb_assert_and_check_break(filter);
+
+        // init the random seed
+        tb_hong_t now = tb_uclock();
+        filter->seed = tb_xxh3_make((tb_byte_t const*)&now, sizeof(now), (tb_uint64_t)(tb_size_t)filter);
+
+        // init the first layer
+        if (!item_maxn) item_maxn = TB_BLOCK_BLOOM_FILTER_ITEM_MAXN_DEFAULT;
+        if (!tb_block_bloom_filter_layer_init(filter, &filter->layers[0], tb_block_bloom_filter_layer_probability(filter, 0), item_maxn)) break;
+        filter->layer_count = 1;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (filter) 
+        {
+            tb_block_bloom_filter_layer_exit(&filter->layers[0]);
+            tb_block_bloom_filter_exit((tb_block_bloom_filter_ref_t)filter);
+        }
+        filter = tb_null;
+    }
+
+    // ok?
+    return (tb_block_bloom_filter_ref_t)filter;
+}
+tb_block_bloom_filter_ref_t tb_block_bloom_filter_init_from_data(tb_byte_t const* data, tb_size_t size, tb_element_t element)
+{
+    // check
+    tb_assert_and_check_return_val(data && size >= TB_BLOCK_BLOOM_FILTER_DATA_HEAD_SIZE, tb_null);
+
+    // done
+    tb_bool_t                   ok = tb_false;
+    tb_block_bloom_filter_t*    filter = tb_null;
+    do
+    {
+        // check the magic and version
+        tb_byte_t const* p = data;
+        tb_byte_t const* e = data + size;
+        tb_check_break(!tb_memcmp(p, TB_BLOCK_BLOOM_FILTER_DATA_MAGIC, 4));
+        tb_check_break(p[4] == TB_BLOCK_BLOOM_FILTER_DATA_VERSION);
+
+        // check the element
+        tb_size_t layer_count = p[7];
+        tb_assert_and_check_break(layer_count && layer_count <= TB_BLOCK_BLOOM_FILTER_LAYER_MAXN);
+        tb_assert_and_check_break(tb_bits_get_u32_le(p + 8) == element.type);
+        tb_assert_and_check_break(element.type != TB_ELEMENT_TYPE_MEM || tb_bits_get_u32_le(p + 12) == element.size);
+
+        // make filter
+        filter = tb_block_bloom_filter_make(p[5], p[6], element);
+        tb_assert_and_check_break(filter);
+
+        // init seed
+        filter->seed = tb_bits_get_u64_le(p + 16);
+        p += TB_BLOCK_BLOOM_FILTER_DATA_HEAD_SIZE;
+        
+        // load layers
+        tb_size_t i = 0;
+        for (i = 0; i < layer_count; i++)
+        {
+            // the layer info
+            tb_assert_and_check_break(p + TB_BLOCK_BLOOM_FILTER_DATA_LAYER_SIZE <= e);
+            tb_uint64_t capacity    = tb_bits_get_u64_le(p);
+            tb_uint64_t count       = tb_bits_get_u64_le(p + 8);
+            tb_uint64_t nblocks     = tb_bits_get_u64_le(p + 16);
+            tb_assert_and_check_break(capacity && capacity <= (tb_uint64_t)(tb_size_t)-1);
+            p += TB_BLOCK_BLOOM_FILTER_DATA_LAYER_SIZE;
+
+            // check the blocks count and the layer data size before allocating the layer, the capacity is untrusted
+            tb_size_t probability = tb_block_bloom_filter_layer_probability(filter, i);
+            tb_assert_and_check_break(nblocks == (tb_uint64_t)tb_block_bloom_filter_layer_nblocks(probability, (tb_size_t)capacity));
+            tb_size_t blocks_size   = (tb_size_t)nblocks * TB_BLOCK_BLOOM_FILTER_BLOCK_SIZE;
+            tb_size_t counters_size = filter->mode == TB_BLOCK_BLOOM_FILTER_MODE_COUNTING? (tb_size_t)nblocks * TB_BLOCK_BLOOM_FILTER_COUNTERS_SIZE : 0;
+            tb_assert_and_check_break(blocks_size <= (tb_size_t)(e - p) && counters_size <= (tb_size_t)(e - p) - blocks_size);
+
+            // init layer
+            tb_block_bloom_filter_layer_t* layer = &filter->layers[i];
+            filter->layer_count = i + 1;
+            if (!tb_block_bloom_filter_layer_init(filter, layer, probability, (tb_size_t)capacity)) break;
+            layer->count = (tb_size_t)count;
+
+            // load blocks
+#ifdef TB_WORDS_BIGENDIAN
+            tb_size_t j = 0;
+            tb_size_t n = layer->nblocks * TB_BLOCK_BLOOM_FILTER_BLOCK_WORDS;
+            for (j = 0; j < n; j++) layer->blocks[j] = tb_bits_get_u32_le(p + (j << 2));
+#else
+            tb_memcpy(layer->blocks, p, blocks_size);
+#endif
+            p += blocks_size;
+
+            // load counters
+            if (layer->counters)
+            {
+                tb_memcpy(layer->counters, p, counters_size);
+                p += counters_size;
+            }
+        }
+        tb_check_break(i == layer_count);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (filter) tb_block_bloom_filter_exit((tb_block_bloom_filter_ref_t)filter);
+        filter = tb_null;
+    }
+
+    // ok?
+    return (tb_block_bloom_filter_ref_t)filter;
+}
+tb_void_t tb_block_bloom_filter_exit(tb_block_bloom_filter_ref_t self)
+{
+    // check
+    tb_block_bloom_filter_t* filter = (tb_block_bloom_filter_t*)self;
+    tb_assert_and_check_return(filter);
+
+    // exit layers
+    tb_size_t i = 0;
+    for (i = 0; i < filter->layer_count; i++) 
+        tb_block_bloom_filter_layer_exit(&filter->layers[i]);
+    filter->layer_count = 0;
+
+    // exit it
+    tb_free(filter);
+}
+tb_void_t tb_block_bloom_filter_clear(tb_block_bloom_filter_ref_t self)
+{
+    // check
+    tb_block_bloom_filter_t* filter = (tb_block_bloom_filter_t*)self;
+    tb_assert_and_check_return(filter && filter->layer_count);
+
+    // only keep the first layer
+    tb_size_t i = 0;
+    for (i = 1; i < filter->layer_count; i++) 
+        tb_block_bloom_filter_layer_exit(&filter->layers[i]);
+    filter->layer_count = 1;
+
+    // clear it
+    tb_block_bloom_filter_layer_t* layer = &filter->layers[0];
+    tb_memset(layer->blocks, 0, layer->nblocks * TB_BLOCK_BLOOM_FILTER_BLOCK_SIZE);
+    if (layer->counters) tb_memset(layer->counters, 0, layer->nblocks * TB_BLOCK_BLOOM_FILTER_COUNTERS_SIZE);
+    layer->count = 0;
+}
+tb_size_t tb_block_bloom_filter_size(tb_block_bloom_filter_ref_t self)
+{
+    // check
+    tb_block_bloom_filter_t* filter = (tb_block_bloom_filter_t*)self;
+    tb_assert_and_check_return_val(filter, 0);
+
+    // the items count of all layers
+    tb_size_t i = 0;
+    tb_size_t size = 0;
+    for (i = 0; i < filter->layer_count; i++) size += filter->layers[i].count;
+    return size;
+}
+tb_bool_t tb_block_bloom_filter_set(tb_block_bloom_filter_ref_t self, tb_cpointer_t data)
+{
+    // check
+    tb_block_bloom_filter_t* filter = (tb_block_bloom_filter_t*)self;
+    tb_assert_and_check_return_val(filter, tb_false);
+
+    // set it
+    return tb_block_bloom_filter_set_hash(filter, tb_block_bloom_filter_hash(filter, data));
+}
+tb_bool_t tb_block_bloom_filter_get(tb_block_bloom_filter_ref_t self, tb_cpointer_t data)
+{
+    // check
+    tb_block_bloom_filter_t* filter = (tb_block_bloom_filter_t*)self;
+    tb_assert_and_check_return_val(filter, tb_false);
+
+    // get it
+    return tb_block_bloom_filter_get_hash(filter, tb_block_bloom_filter_hash(filter, data));
+}
+tb_bool_t tb_block_bloom_filter_del(tb_block_bloom_filter_ref_t self, tb_cpointer_t data)
+{
+    // check
+    tb_block_bloom_filter_t* filter = (tb_block_bloom_filter_t*)self;
+    tb_assert_and_check_return_val(filter && filter->layer_count, tb_false);
+    tb_assertf_and_check_return_val(filter->mode == TB_BLOCK_BLOOM_FILTER_MODE_COUNTING, tb_false, "only the counting filter supports to remove items!");
+
+    // not exists?
+    tb_uint64_t hash = tb_block_bloom_filter_hash(filter, data);
+    tb_check_return_val(tb_block_bloom_filter_get_hash(filter, hash), tb_false);
+
+    // the block
+    tb_block_bloom_filter_layer_t*  layer   = &filter->layers[0];
+    tb_size_t                       index   = tb_block_bloom_filter_block(layer, hash);
+    tb_uint32_t*                    block   = layer->blocks + index * TB_BLOCK_BLOOM_FILTER_BLOCK_WORDS;
+    tb_byte_t*                      counters = layer->counters + index * TB_BLOCK_BLOOM_FILTER_COUNTERS_SIZE;
+
+    // decrease the counters and clear the bit if the counter becomes zero
+    tb_size_t i = 0;
+    for (i = 0; i < TB_BLOCK_BLOOM_FILTER_BLOCK_WORDS; i++)
+    {
+        tb_size_t   pos     = ((tb_uint32_t)hash * g_salts[i]) >> 27;
+        tb_size_t   bit     = (i << 5) + pos;
+        tb_byte_t*  pcount  = counters + (bit >> 1);
+        tb_size_t   shift   = (bit & 1) << 2;
+        tb_size_t   count   = (*pcount >> shift) & 0xf;
+
+        // the saturated counter is sticky, we cannot know the real count
+        if (count && count < TB_BLOCK_BLOOM_FILTER_COUNTER_MAXN)
+        {
+            *pcount -= (tb_byte_t)(1 << shift);
+            if (count == 1) block[i] &= ~((tb_uint32_t)1 << pos);
+        }
+    }
+
+    // update count
+    if (layer->count) layer->count--;
+
+    // ok
+    return tb_true;
+}
+tb_size_t tb_block_bloom_filter_set_list(tb_block_bloom_filter_ref_t self, tb_cpointer_t const* list, tb_size_t size, tb_bool_t* results)
+{
+    // check
+    tb_block_bloom_filter_t* filter = (tb_block_bloom_filter_t*)self;
+    tb_assert_and_check_return_val(filter && list, 0);
+
+    // done
+    tb_size_t   i = 0;
+    tb_size_t   ok = 0;
+    tb_uint64_t hashes[TB_BLOCK_BLOOM_FILTER_BATCH_SIZE];
+    while (i < size)
+    {
+        // compute the hashes of this batch and prefetch the blocks
+        tb_size_t j = 0;
+        tb_size_t n = tb_min(size - i, TB_BLOCK_BLOOM_FILTER_BATCH_SIZE);
+        for (j = 0; j < n; j++)
+        {
+            hashes[j] = tb_block_bloom_filter_hash(filter, list[i + j]);
+            tb_block_bloom_filter_prefetch_hash(filter, hashes[j]);
+        }
+
+        // set them
+        for (j = 0; j < n; j++, i++)
+        {
+            tb_bool_t r = tb_block_bloom_filter_set_hash(filter, hashes[j]);
+            if (results) results[i] = r;
+            if (r) ok++;
+        }
+    }
+
+    // ok?
+    return ok;
+}
+tb_size_t tb_block_bloom_filter_get_list(tb_block_bloom_filter_ref_t self, tb_cpointer_t const* list, tb_size_t size, tb_bool_t* results)
+{
+    // check
+    tb_block_bloom_filter_t* filter = (tb_block_bloom_filter_t*)self;
+    tb_assert_and_check_return_val(filter && list, 0);
+
+    // done
+    tb_size_t   i = 0;
+    tb_size_t   ok = 0;
+    tb_uint64_t hashes[TB_BLOCK_BLOOM_FILTER_BATCH_SIZE];
+    while (i < size)
+    {
+        // compute the hashes of this batch and prefetch the blocks
+        tb_size_t j = 0;
+        tb_size_t n = tb_min(size - i, TB_BLOCK_BLOOM_FILTER_BATCH_SIZE);
+        for (j = 0; j < n; j++)
+        {
+            hashes[j] = tb_block_bloom_filter_hash(filter, list[i + j]);
+            tb_block_bloom_filter_prefetch_hash(filter, hashes[j]);
+        }
+
+        // get them
+        for (j = 0; j < n; j++, i++)
+        {
+            tb_bool_t r = tb_block_bloom_filter_get_hash(filter, hashes[j]);
+            if (results) results[i] = r;
+            if (r) ok++;
+        }
+    }
+
+    // ok?
+    return ok;
+}
+tb_long_t tb_block_bloom_filter_save(tb_block_bloom_filter_ref_t self, tb_byte_t* data, tb_size_t size)
+{
+    // check
+    tb_block_bloom_filter_t* filter = (tb_block_bloom_filter_t*)self;
+    tb_assert_and_check_return_val(filter && filter->layer_count, -1);
+
+    // compute the needed size
+    tb_size_t i = 0;
+    tb_size_t need = TB_BLOCK_BLOOM_FILTER_DATA_HEAD_SIZE;
+    for (i = 0; i < filter->layer_count; i++)
+    {
+        tb_block_bloom_filter_layer_t const* layer = &filter->layers[i];
+        need += TB_BLOCK_BLOOM_FILTER_DATA_LAYER_SIZE + layer->nblocks * TB_BLOCK_BLOOM_FILTER_BLOCK_SIZE;
+        if (layer->counters) need += layer->nblocks * TB_BLOCK_BLOOM_FILTER_COUNTERS_SIZE;
+    }
+
+    // only get the needed size?
+    tb_check_return_val(data, (tb_long_t)need);
+    tb_check_return_val(size >= need, -1);
+
+    // save the header
+    tb_byte_t* p = data;
+    tb_memcpy(p, TB_BLOCK_BLOOM_FILTER_DATA_MAGIC, 4);
+    p[4] = TB_BLOCK_BLOOM_FILTER_DATA_VERSION;
+    p[5] = (tb_byte_t)filter->mode;
+    p[6] = (tb_byte_t)filter->probability;
+    p[7] = (tb_byte_t)filter->layer_count;
+    tb_bits_set_u32_le(p + 8, (tb_uint32_t)filter->element.type);
+    tb_bits_set_u32_le(p + 12, (tb_uint32_t)filter->element.size);
+    tb_bits_set_u64_le(p + 16, filter->seed);
+    p += TB_BLOCK_BLOOM_FILTER_DATA_HEAD_SIZE;
+
+    // save layers
+    for (i = 0; i < filter->layer_count; i++)
+    {
+        // save the layer info
+        tb_block_bloom_filter_layer_t const* layer = &filter->layers[i];
+        tb_bits_set_u64_le(p, (tb_uint64_t)layer->capacity);
+        tb_bits_set_u64_le(p + 8, (tb_uint64_t)layer->count);
+        tb_bits_set_u64_le(p + 16, (tb_uint64_t)layer->nblocks);
+        p += TB_BLOCK_BLOOM_FILTER_DATA_LAYER_SIZE;
+
+        // save blocks
+        tb_size_t blocks_size = layer->nblocks * TB_BLOCK_BLOOM_FILTER_BLOCK_SIZE;
+#ifdef TB_WORDS_BIGENDIAN
+        tb_size_t j = 0;
+        tb_size_t n = layer->nblocks * TB_BLOCK_BLOOM_FILTER_BLOCK_WORDS;
+        for (j = 0; j < n; j++) tb_bits_set_u32_le(p + (j << 2), layer->blocks[j]);
+#else
+        tb_memcpy(p, layer->blocks, blocks_size);
+#endif
+        p += blocks_size;
+
+        // save counters
+        if (layer->counters)
+        {
+            tb_size_t counters_size = layer->nblocks * TB_BLOCK_BLOOM_FILTER_COUNTERS_SIZE;
+            tb_memcpy(p, layer->counters, counters_size);
+            p += counters_size;
+        }
+    }
+
+    // ok
+    tb_assert(p == data + need);
+    return (tb_long_t)need;
+}
@@ -0,0 +1,202 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        block_bloom_filter.h
+ * @ingroup     container
+ *
+ */
+#ifndef TB_CONTAINER_BLOCK_BLOOM_FILTER_H
+#define TB_CONTAINER_BLOCK_BLOOM_FILTER_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "element.h"
+#include "bloom_filter.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the block bloom filter type
+ *
+ * It is a split block bloom filter, each item is mapped to one 256-bits block (32-bytes aligned, 
+ * so it never crosses the cache line) and sets one bit in each of the eight 32-bits words of this block.
+ *
+ * So every query only touches one cache line and the eight bits can be tested with one simd instruction (e.g. avx2),
+ * it is much faster than tb_bloom_filter which need k random memory accesses, 
+ * but it need a few more bits for the same probability of false positives, e.g.
+ *
+ * - 0.01:      ~9.6 bits/item
+ * - 0.001:     ~14.8 bits/item
+ * - 0.0001:    ~19.4 bits/item
+ *
+ * The counting mode keeps a 4-bits counter for every bit and supports to remove items,
+ * and the scalable mode will add a new larger layer with a tighter probability if the current layer is full.
+ */
+typedef __tb_typeref__(block_bloom_filter);
+
+/// the block bloom filter mode enum
+typedef enum __tb_block_bloom_filter_mode_e
+{
+    TB_BLOCK_BLOOM_FILTER_MODE_NONE         = 0 //!< the fixed capacity
+,   TB_BLOCK_BLOOM_FILTER_MODE_COUNTING     = 1 //!< the counting filter, supports to remove items
+,   TB_BLOCK_BLOOM_FILTER_MODE_SCALABLE     = 2 //!< the scalable filter, the capacity will be grown
+
+}tb_block_bloom_filter_mode_e;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init block bloom filter
+ *
+ * @param mode          the mode
+ * @param probability   the probability of false positives, e.g. TB_BLOOM_FILTER_PROBABILITY_0_001, < 24
+ * @param item_maxn     the item maxn, it is the initial capacity for the scalable mode
+ * @param element       the element only for hash
+ *
+ * @return              the block bloom filter
+ */
+tb_block_bloom_filter_ref_t tb_block_bloom_filter_init(tb_size_t mode, tb_size_t probability, tb_size_t item_maxn, tb_element_t element);
+
+/*! init block bloom filter from the data saved by tb_block_bloom_filter_save()
+ *
+ * @param data          the data
+ * @param size          the size
+ * @param element       the element only for hash, it must be same as the saved filter
+ *
+ * @return              the block bloom filter
+ */
+tb_block_bloom_filter_ref_t tb_block_bloom_filter_init_from_data(tb_byte_t const* data, tb_size_t size, tb_element_t element);
+
+/*! exit block bloom filter
+ *
+ * @param filter        the block bloom filter
+ */
+tb_void_t               tb_block_bloom_filter_exit(tb_block_bloom_filter_ref_t filter);
+
+/*! clear block bloom filter
+ *
+ * @param filter        the block bloom filter
+ */
+tb_void_t               tb_block_bloom_filter_clear(tb_block_bloom_filter_ref_t filter);
+
+/*! the inserted items count 
+ *
+ * @param filter        the block bloom filter
+ *
+ * @return              the items count
+ */
+tb_size_t               tb_block_bloom_filter_size(tb_block_bloom_filter_ref_t filter);
+
+/*! set data to the block bloom filter 
+ *
+ * @note the counters will be always increased for the counting mode even if the data have been existed
+ *
+ * @param filter        the block bloom filter
+ * @param data          the item data 
+ *
+ * @return              return tb_false if the data have been existed, otherwise set it and return tb_true
+ */
+tb_bool_t               tb_block_bloom_filter_set(tb_block_bloom_filter_ref_t filter, tb_cpointer_t data);
+
+/*! get data from the block bloom filter 
+ *
+ * @param filter        the block bloom filter
+ * @param data          the item data 
+ *
+ * @return              return tb_true if the data exists (maybe false positives), otherwise return tb_false
+ */
+tb_bool_t               tb_block_bloom_filter_get(tb_block_bloom_filter_ref_t filter, tb_cpointer_t data);
+
+/*! remove data from the block bloom filter, only for the counting mode
+ *
+ * @note we must only remove the data which has been set, otherwise it will cause false negatives
+ *
+ * @param filter        the block bloom filter
+ * @param data          the item data 
+ *
+ * @return              return tb_true if the data exists and has been removed
+ */
+tb_bool_t               tb_block_bloom_filter_del(tb_block_bloom_filter_ref_t filter, tb_cpointer_t data);
+
+/*! set the data list to the block bloom filter 
+ *
+ * the blocks of the data list will be prefetched before accessing them, so it is faster than tb_block_bloom_filter_set()
+ *
+ * @param filter        the block bloom filter
+ * @param list          the data list
+ * @param size          the list size
+ * @param results       the results of tb_block_bloom_filter_set() for every data, maybe null
+ *
+ * @return              the count of the new data
+ */
+tb_size_t               tb_block_bloom_filter_set_list(tb_block_bloom_filter_ref_t filter, tb_cpointer_t const* list, tb_size_t size, tb_bool_t* results);
+
+/*! get the data list from the block bloom filter 
+ *
+ * @param filter        the block bloom filter
+ * @param list          the data list
+ * @param size          the list size
+ * @param results       the results of tb_block_bloom_filter_get() for every data, maybe null
+ *
+ * @return              the count of the existed data
+ */
+tb_size_t               tb_block_bloom_filter_get_list(tb_block_bloom_filter_ref_t filter, tb_cpointer_t const* list, tb_size_t size, tb_bool_t* results);
+
+/*! save the block bloom filter to the given buffer
+ *
+ * @note the hash of the str, mem and integer elements is stable, 
+ * but the saved data of other elements may be only used in the current process.
+ *
+ * @code
+    tb_long_t size = tb_block_bloom_filter_save(filter, tb_null, 0);
+    if (size > 0)
+    {
+        tb_byte_t* data = tb_malloc_bytes(size);
+        if (data && tb_block_bloom_filter_save(filter, data, size) == size)
+        {
+            // ...
+        }
+    }
+ * @endcode
+ *
+ * @param filter        the block bloom filter
+ * @param data          the buffer data, only return the needed size if be null
+ * @param size          the buffer size
+ *
+ * @return              the saved size, -1: failed or the buffer is too small
+ */
+tb_long_t               tb_block_bloom_filter_save(tb_block_bloom_filter_ref_t filter, tb_byte_t* data, tb_size_t size);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -45,5 +45,6 @@
 #include "single_list.h"
 #include "single_list_entry.h"
 #include "bloom_filter.h"
+#include "block_bloom_filter.h"
 
 #endif
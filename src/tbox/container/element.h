@@ -291,6 +291,17 @@ tb_element_t        tb_element_uint32(tb_noarg_t);
  */
 tb_element_t        tb_element_str(tb_bool_t is_case); 
 
+/*! the string element with the randomized hash
+ *
+ * the hash seed is chosen randomly once per process, it resists the hash flooding of the untrusted keys,
+ * but the iteration order of the hash map will be changed from run to run.
+ *
+ * @param is_case   is case?
+ *
+ * @return          the element
+ */
+tb_element_t        tb_element_str_seeded(tb_bool_t is_case); 
+
 /*! the pointer element
  *
  * @note if the free function have been hooked, the nfree need hook too.
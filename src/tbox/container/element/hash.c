@@ -28,12 +28,43 @@
 #include "hash.h"
 #include "../../hash/hash.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the random seed of the seeded data and cstr hash, it will be initialized lazily
+static tb_atomic_t      g_seed = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * seed implementation
+ */
+static tb_uint64_t tb_element_hash_seed_init()
+{
+    // make a random seed from the current time and the addresses (aslr)
+    tb_byte_t   stack = 0;
+    tb_uint64_t value[3];
+    value[0] = (tb_uint64_t)tb_uclock();
+    value[1] = (tb_uint64_t)(tb_size_t)&stack;
+    value[2] = (tb_uint64_t)(tb_size_t)&g_seed;
+    tb_long_t seed = (tb_long_t)tb_xxh3_make((tb_byte_t const*)value, sizeof(value), 0) | 1;
+
+    // only one seed can be used for all threads
+    tb_long_t prev = tb_atomic_fetch_and_pset(&g_seed, 0, seed);
+    return (tb_uint64_t)(prev? prev : seed);
+}
+static __tb_inline__ tb_uint64_t tb_element_hash_seed()
+{
+    // the seed is only written once and it is randomized for resisting the hash flooding
+    tb_long_t seed = tb_atomic_get(&g_seed);
+    return seed? (tb_uint64_t)seed : tb_element_hash_seed_init();
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * data hash implementation
  */
 static tb_size_t tb_element_hash_data_func_0(tb_byte_t const* data, tb_size_t size)
 {
-    return tb_bkdr_make(data, size, 0);
+    return (tb_size_t)tb_xxh3_make(data, size, 0);
 }
 static tb_size_t tb_element_hash_data_func_1(tb_byte_t const* data, tb_size_t size)
 {
@@ -92,13 +123,12 @@ static tb_size_t tb_element_hash_data_func_12(tb_byte_t const* data, tb_size_t s
 }
 static tb_size_t tb_element_hash_data_func_13(tb_byte_t const* data, tb_size_t size)
 {
-    tb_trace_noimpl();
-    return 0;
+    return tb_bkdr_make(data, size, 0);
 }
 static tb_size_t tb_element_hash_data_func_14(tb_byte_t const* data, tb_size_t size)
 {
-    tb_trace_noimpl();
-    return 0;
+    // using the high 64-bits of xxh3-128 
+    return (tb_size_t)tb_xxh3_make128(data, size, 0).high;
 }
 static tb_size_t tb_element_hash_data_func_15(tb_byte_t const* data, tb_size_t size)
 {
@@ -112,7 +142,7 @@ static tb_size_t tb_element_hash_data_func_15(tb_byte_t const* data, tb_size_t s
  */
 static tb_size_t tb_element_hash_cstr_func_0(tb_char_t const* data)
 {
-    return tb_bkdr_make_from_cstr(data, 0);
+    return (tb_size_t)tb_xxh3_make_from_cstr(data, 0);
 }
 static tb_size_t tb_element_hash_cstr_func_1(tb_char_t const* data)
 {
@@ -327,3 +357,14 @@ tb_size_t tb_element_hash_cstr(tb_char_t const* cstr, tb_size_t mask, tb_size_t
     // using the data hash
     return tb_element_hash_data((tb_byte_t const*)cstr, tb_strlen(cstr), mask, index);
 }
+tb_size_t tb_element_hash_cstr_seeded(tb_char_t const* cstr, tb_size_t mask, tb_size_t index)
+{
+    // check
+    tb_assert_and_check_return_val(cstr && mask, 0);
+
+    // using xxh3 with the random seed for the first hash func
+    if (!index) return (tb_size_t)tb_xxh3_make_from_cstr(cstr, tb_element_hash_seed()) & mask;
+
+    // using the cstr hash
+    return tb_element_hash_cstr(cstr, mask, index);
+}
@@ -100,6 +100,16 @@ tb_size_t           tb_element_hash_data(tb_byte_t const* data, tb_size_t size,
  */
 tb_size_t           tb_element_hash_cstr(tb_char_t const* cstr, tb_size_t mask, tb_size_t index);
 
+/* compute the cstring hash with the random seed of the current process
+ *
+ * @param cstr      the cstring
+ * @param mask      the mask
+ * @param index     the hash func index
+ *
+ * @return          the hash value
+ */
+tb_size_t           tb_element_hash_cstr_seeded(tb_char_t const* cstr, tb_size_t mask, tb_size_t index);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
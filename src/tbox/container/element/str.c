@@ -37,6 +37,10 @@ static tb_size_t tb_element_str_hash(tb_element_ref_t element, tb_cpointer_t dat
 {
     return tb_element_hash_cstr((tb_char_t const*)data, mask, index);
 }
+static tb_size_t tb_element_str_hash_seeded(tb_element_ref_t element, tb_cpointer_t data, tb_size_t mask, tb_size_t index)
+{
+    return tb_element_hash_cstr_seeded((tb_char_t const*)data, mask, index);
+}
 static tb_long_t tb_element_str_comp(tb_element_ref_t element, tb_cpointer_t ldata, tb_cpointer_t rdata)
 {
     // check
@@ -210,3 +214,12 @@ tb_element_t tb_element_str(tb_bool_t bcase)
     // ok?
     return element;
 }
+tb_element_t tb_element_str_seeded(tb_bool_t bcase)
+{
+    // init element
+    tb_element_t element = tb_element_str(bcase);
+    element.hash   = tb_element_str_hash_seeded;
+
+    // ok?
+    return element;
+}
@@ -88,6 +88,36 @@ tb_long_t tb_coroutine_waitio(tb_socket_ref_t sock, tb_size_t events, tb_long_t
     // wait events
     return scheduler? tb_co_scheduler_wait(scheduler, sock, events, timeout) : -1;
 }
+tb_long_t tb_coroutine_waitfd(tb_int_t fd, tb_size_t events, tb_long_t timeout)
+{
+#ifdef TB_CONFIG_OS_WINDOWS
+    tb_trace_noimpl();
+    return -1;
+#else
+    // check
+    tb_assert_and_check_return_val(fd >= 0 && events, -1);
+
+    // wait events, the file descriptor and socket are the same handle on posix
+    return tb_coroutine_waitio(tb_fd2sock(fd), events, timeout);
+#endif
+}
+tb_bool_t tb_coroutine_cancelfd(tb_int_t fd)
+{
+#ifdef TB_CONFIG_OS_WINDOWS
+    tb_trace_noimpl();
+    return tb_false;
+#else
+    // check
+    tb_assert_and_check_return_val(fd >= 0, tb_false);
+
+    // get the current io scheduler
+    tb_co_scheduler_io_ref_t scheduler_io = tb_co_scheduler_io_self();
+    tb_check_return_val(scheduler_io, tb_false);
+
+    // cancel it, the closed fd may be reused and we need remove it from the poller first
+    return tb_co_scheduler_io_cancel(scheduler_io, tb_fd2sock(fd));
+#endif
+}
 tb_coroutine_ref_t tb_coroutine_self()
 {
     // get coroutine
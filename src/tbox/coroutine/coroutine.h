@@ -31,6 +31,7 @@
  */
 #include "lock.h"
 #include "channel.h"
+#include "listener.h"
 #include "semaphore.h"
 #include "scheduler.h"
 #include "stackless/stackless.h"
@@ -106,6 +107,26 @@ tb_pointer_t            tb_coroutine_sleep(tb_long_t interval);
  */
 tb_long_t               tb_coroutine_waitio(tb_socket_ref_t sock, tb_size_t events, tb_long_t timeout);
 
+/*! wait io events for the given file descriptor, e.g. pipe, eventfd, timerfd, signalfd and inotify
+ *
+ * @note it is not supported on windows, and we need call tb_coroutine_cancelfd() before closing this fd
+ *
+ * @param fd            the file descriptor
+ * @param events        the waited events, only recv and send
+ * @param timeout       the timeout, infinity: -1
+ *
+ * @return              > 0: the events, 0: timeout, -1: failed
+ */
+tb_long_t               tb_coroutine_waitfd(tb_int_t fd, tb_size_t events, tb_long_t timeout);
+
+/*! cancel the waited file descriptor for the current coroutine
+ *
+ * @param fd            the file descriptor
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_coroutine_cancelfd(tb_int_t fd);
+
 /*! get the current coroutine
  *
  * @return              the current coroutine
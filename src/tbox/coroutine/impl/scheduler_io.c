@@ -450,6 +450,9 @@ tb_bool_t tb_co_scheduler_io_cancel(tb_co_scheduler_io_ref_t scheduler_io, tb_so
             return tb_false;
         }
 
+        // clear the waiting socket, the same socket handle may be reused after it has been closed
+        coroutine->rs.wait.sock = tb_null;
+
         // remove ok
         return tb_true;
     }
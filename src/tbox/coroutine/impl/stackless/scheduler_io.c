@@ -465,6 +465,9 @@ tb_bool_t tb_lo_scheduler_io_cancel(tb_lo_scheduler_io_ref_t scheduler_io, tb_so
             return tb_false;
         }
 
+        // clear the waiting socket, the same socket handle may be reused after it has been closed
+        coroutine->rs.wait.sock = tb_null;
+
         // remove ok
         coroutine->rs.wait.events_result = 0;
         return tb_true;
@@ -0,0 +1,380 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        listener.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "listener"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "listener.h"
+#include "coroutine.h"
+#include "scheduler.h"
+#include "../platform/platform.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the interval of checking the stopped state when waiting the new connections
+#define TB_CO_LISTENER_STOP_INTERVAL    (100)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the listener type
+struct __tb_co_listener_t;
+
+// the listener worker type
+typedef struct __tb_co_listener_worker_t
+{
+    // the listener
+    struct __tb_co_listener_t*      listener;
+
+    // the listening socket
+    tb_socket_ref_t                 sock;
+
+    // the scheduler
+    tb_co_scheduler_ref_t           scheduler;
+
+    // the thread
+    tb_thread_ref_t                 thread;
+
+}tb_co_listener_worker_t;
+
+// the listener connection type
+typedef struct __tb_co_listener_conn_t
+{
+    // the listener
+    struct __tb_co_listener_t*      listener;
+
+    // the connection socket
+    tb_socket_ref_t                 sock;
+
+}tb_co_listener_conn_t;
+
+// the listener type
+typedef struct __tb_co_listener_t
+{
+    // the connection function
+    tb_co_listener_func_t           func;
+
+    // the user private data
+    tb_cpointer_t                   priv;
+
+    // the bound address
+    tb_ipaddr_t                     addr;
+
+    // all workers share the first listening socket?
+    tb_bool_t                       shared;
+
+    // have been started?
+    tb_bool_t                       started;
+
+    // have been stopped?
+    tb_atomic_t                     stopped;
+
+    // the worker count
+    tb_size_t                       count;
+
+    // the workers
+    tb_co_listener_worker_t*        workers;
+
+}tb_co_listener_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_socket_ref_t tb_co_listener_sock_init(tb_ipaddr_ref_t addr, tb_bool_t* preuseport)
+{
+    // done
+    tb_bool_t       ok = tb_false;
+    tb_socket_ref_t sock = tb_null;
+    do
+    {
+        // init socket
+        sock = tb_socket_init(TB_SOCKET_TYPE_TCP, tb_ipaddr_family(addr));
+        tb_assert_and_check_break(sock);
+
+        // enable reuseport before binding
+        if (preuseport) *preuseport = tb_socket_ctrl(sock, TB_SOCKET_CTRL_SET_REUSEPORT, tb_true);
+
+        // bind and listen it
+        if (!tb_socket_bind(sock, addr)) break;
+        if (!tb_socket_listen(sock, 1024)) break;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        if (sock) tb_socket_exit(sock);
+        sock = tb_null;
+    }
+    return sock;
+}
+static tb_void_t tb_co_listener_conn(tb_cpointer_t priv)
+{
+    // check
+    tb_co_listener_conn_t* conn = (tb_co_listener_conn_t*)priv;
+    tb_assert_and_check_return(conn && conn->listener && conn->sock);
+
+    // do the connection
+    tb_co_listener_t* listener = conn->listener;
+    listener->func(conn->sock, listener->priv);
+
+    // exit the connection
+    tb_socket_exit(conn->sock);
+    tb_free(conn);
+}
+static tb_void_t tb_co_listener_accept(tb_cpointer_t priv)
+{
+    // check
+    tb_co_listener_worker_t* worker = (tb_co_listener_worker_t*)priv;
+    tb_assert_and_check_return(worker && worker->listener && worker->sock);
+
+    // wait accept events until the listener is stopped
+    tb_co_listener_t* listener = worker->listener;
+    while (!tb_atomic_get(&listener->stopped))
+    {
+        // wait it
+        tb_long_t wait = tb_socket_wait(worker->sock, TB_SOCKET_EVENT_ACPT, TB_CO_LISTENER_STOP_INTERVAL);
+        tb_assert_and_check_break(wait >= 0);
+        tb_check_continue(wait);
+
+        // accept all connections
+        tb_socket_ref_t sock = tb_null;
+        while ((sock = tb_socket_accept(worker->sock, tb_null)))
+        {
+            // make connection
+            tb_co_listener_conn_t* conn = tb_malloc0_type(tb_co_listener_conn_t);
+            if (conn)
+            {
+                conn->listener  = listener;
+                conn->sock      = sock;
+            }
+
+            // start the connection coroutine in the current scheduler
+            if (!conn || !tb_coroutine_start(tb_null, tb_co_listener_conn, conn, 0))
+            {
+                tb_trace_e("start connection failed!");
+                tb_socket_exit(sock);
+                if (conn) tb_free(conn);
+            }
+        }
+    }
+}
+static tb_int_t tb_co_listener_loop(tb_cpointer_t priv)
+{
+    // check
+    tb_co_listener_worker_t* worker = (tb_co_listener_worker_t*)priv;
+    tb_assert_and_check_return_val(worker && worker->scheduler, -1);
+
+    // start the accept coroutine and run the scheduler of this worker
+    if (tb_coroutine_start(worker->scheduler, tb_co_listener_accept, worker, 0))
+        tb_co_scheduler_loop(worker->scheduler, tb_false);
+    return 0;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_co_listener_ref_t tb_co_listener_init(tb_ipaddr_ref_t addr, tb_size_t workers, tb_size_t flags, tb_co_listener_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(addr && func, tb_null);
+
+    // done
+    tb_bool_t           ok = tb_false;
+    tb_co_listener_t*   listener = tb_null;
+    do
+    {
+        // make listener
+        listener = tb_malloc0_type(tb_co_listener_t);
+        tb_assert_and_check_break(listener);
+
+        // init listener
+        listener->func  = func;
+        listener->priv  = priv;
+        listener->count = workers? workers : tb_processor_count();
+        listener->addr  = *addr;
+
+        // make workers
+        listener->workers = tb_nalloc0_type(listener->count, tb_co_listener_worker_t);
+        tb_assert_and_check_break(listener->workers);
+
+        // init the first listening socket
+        tb_bool_t reuseport = tb_false;
+        tb_co_listener_worker_t* first = &listener->workers[0];
+        first->sock = tb_co_listener_sock_init(&listener->addr, &reuseport);
+        tb_assert_and_check_break(first->sock);
+
+        // save the bound address, we need bind the other sockets to the same port if the given port is zero
+        if (!tb_socket_local(first->sock, &listener->addr)) break;
+        listener->shared = !reuseport || listener->count == 1;
+
+        /* init the other listening sockets in order, 
+         * the reuseport group selects the socket by this order when steering connections by cpu
+         */
+        tb_size_t i = 0;
+        for (i = 1; i < listener->count && !listener->shared; i++)
+        {
+            listener->workers[i].sock = tb_co_listener_sock_init(&listener->addr, tb_null);
+            tb_assert_and_check_break(listener->workers[i].sock);
+        }
+        tb_check_break(i == listener->count || listener->shared);
+
+        // steer the connections by cpu?
+        if ((flags & TB_CO_LISTENER_FLAG_STEER_CPU) && !listener->shared)
+        {
+            if (!tb_socket_ctrl(first->sock, TB_SOCKET_CTRL_SET_REUSEPORT_CPU, listener->count))
+                tb_trace_w("steer connections by cpu: not supported");
+        }
+
+        // init workers
+        for (i = 0; i < listener->count; i++)
+        {
+            tb_co_listener_worker_t* worker = &listener->workers[i];
+            worker->listener    = listener;
+            worker->scheduler   = tb_co_scheduler_init();
+            tb_assert_and_check_break(worker->scheduler);
+            if (listener->shared) worker->sock = first->sock;
+        }
+        tb_check_break(i == listener->count);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (listener) tb_co_listener_exit((tb_co_listener_ref_t)listener);
+        listener = tb_null;
+    }
+
+    // ok?
+    return (tb_co_listener_ref_t)listener;
+}
+tb_void_t tb_co_listener_exit(tb_co_listener_ref_t self)
+{
+    // check
+    tb_co_listener_t* listener = (tb_co_listener_t*)self;
+    tb_assert_and_check_return(listener);
+
+    // exit workers
+    if (listener->workers)
+    {
+        // stop all workers
+        tb_co_listener_kill(self);
+
+        // wait and exit all workers
+        tb_size_t i = 0;
+        for (i = 0; i < listener->count; i++)
+        {
+            tb_co_listener_worker_t* worker = &listener->workers[i];
+            if (worker->thread)
+            {
+                tb_thread_wait(worker->thread, -1, tb_null);
+                tb_thread_exit(worker->thread);
+                worker->thread = tb_null;
+            }
+            if (worker->scheduler)
+            {
+                // mark it as stopped if the scheduler loop has been not started
+                tb_co_scheduler_kill(worker->scheduler);
+                tb_co_scheduler_exit(worker->scheduler);
+                worker->scheduler = tb_null;
+            }
+            if (worker->sock && (!listener->shared || !i)) tb_socket_exit(worker->sock);
+            worker->sock = tb_null;
+        }
+
+        // free workers
+        tb_free(listener->workers);
+        listener->workers = tb_null;
+    }
+
+    // free it
+    tb_free(listener);
+}
+tb_bool_t tb_co_listener_start(tb_co_listener_ref_t self)
+{
+    // check
+    tb_co_listener_t* listener = (tb_co_listener_t*)self;
+    tb_assert_and_check_return_val(listener && listener->workers && !listener->started, tb_false);
+
+    // start all workers
+    tb_size_t i = 0;
+    listener->started = tb_true;
+    for (i = 0; i < listener->count; i++)
+    {
+        tb_co_listener_worker_t* worker = &listener->workers[i];
+        worker->thread = tb_thread_init(tb_null, tb_co_listener_loop, worker, 0);
+        tb_assert_and_check_break(worker->thread);
+    }
+
+    // ok?
+    return i == listener->count;
+}
+tb_void_t tb_co_listener_kill(tb_co_listener_ref_t self)
+{
+    // check
+    tb_co_listener_t* listener = (tb_co_listener_t*)self;
+    tb_assert_and_check_return(listener && listener->workers);
+
+    /* stop accepting the new connections, 
+     * and the scheduler loop of each worker will exit after all connections in progress are finished
+     */
+    tb_atomic_set(&listener->stopped, 1);
+}
+tb_size_t tb_co_listener_workers(tb_co_listener_ref_t self)
+{
+    // check
+    tb_co_listener_t* listener = (tb_co_listener_t*)self;
+    tb_assert_and_check_return_val(listener, 0);
+
+    return listener->count;
+}
+tb_bool_t tb_co_listener_addr(tb_co_listener_ref_t self, tb_ipaddr_ref_t addr)
+{
+    // check
+    tb_co_listener_t* listener = (tb_co_listener_t*)self;
+    tb_assert_and_check_return_val(listener && addr, tb_false);
+
+    // save it
+    *addr = listener->addr;
+    return tb_true;
+}
@@ -0,0 +1,133 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        listener.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_LISTENER_H
+#define TB_COROUTINE_LISTENER_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../network/ipaddr.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the coroutine listener flag enum
+typedef enum __tb_co_listener_flag_e
+{
+    TB_CO_LISTENER_FLAG_NONE        = 0
+,   TB_CO_LISTENER_FLAG_STEER_CPU   = 1     //!< steer the new connections to the worker of the current cpu, only for linux
+
+}tb_co_listener_flag_e;
+
+/// the coroutine listener ref type
+typedef __tb_typeref__(co_listener);
+
+/*! the connection function type
+ *
+ * it will be called in a new coroutine of the worker scheduler for each accepted connection,
+ * and the connection socket will be closed after returning
+ *
+ * @param sock          the connection socket
+ * @param priv          the user private data
+ */
+typedef tb_void_t       (*tb_co_listener_func_t)(tb_socket_ref_t sock, tb_cpointer_t priv);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the multi-acceptor listener
+ *
+ * it opens one listening socket with SO_REUSEPORT for each worker, 
+ * and each worker runs its own coroutine scheduler in its own thread,
+ * so the kernel balances the new connections between the workers.
+ *
+ * all workers will share the same listening socket if SO_REUSEPORT is not supported.
+ *
+ * @param addr          the listening address, it will bind a random port if the port is zero
+ * @param workers       the worker count, using the processor count if be zero
+ * @param flags         the listener flags
+ * @param func          the connection function
+ * @param priv          the user private data
+ *
+ * @return              the listener
+ */
+tb_co_listener_ref_t    tb_co_listener_init(tb_ipaddr_ref_t addr, tb_size_t workers, tb_size_t flags, tb_co_listener_func_t func, tb_cpointer_t priv);
+
+/*! exit the listener
+ *
+ * it will stop and wait all workers if the listener has been started
+ *
+ * @param listener      the listener
+ */
+tb_void_t               tb_co_listener_exit(tb_co_listener_ref_t listener);
+
+/*! start all workers
+ *
+ * @param listener      the listener
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_co_listener_start(tb_co_listener_ref_t listener);
+
+/*! stop accepting the new connections
+ *
+ * the workers will exit after all connections in progress are finished
+ *
+ * @param listener      the listener
+ */
+tb_void_t               tb_co_listener_kill(tb_co_listener_ref_t listener);
+
+/*! get the worker count
+ *
+ * @param listener      the listener
+ *
+ * @return              the worker count
+ */
+tb_size_t               tb_co_listener_workers(tb_co_listener_ref_t listener);
+
+/*! get the listening address
+ *
+ * @param listener      the listener
+ * @param addr          the bound address
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_co_listener_addr(tb_co_listener_ref_t listener, tb_ipaddr_ref_t addr);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -902,6 +902,26 @@ static tb_bool_t tb_database_mysql_begin(tb_database_sql_impl_t* database)
     // ok
     return tb_true;
 }
+static tb_bool_t tb_database_mysql_ping(tb_database_sql_impl_t* database)
+{
+    // check
+    tb_database_mysql_t* mysql = tb_database_mysql_cast(database);
+    tb_assert_and_check_return_val(mysql && mysql->database, tb_false);
+
+    // done ping, it will reconnect it if MYSQL_OPT_RECONNECT is enabled
+    if (mysql_ping(mysql->database))
+    {
+        // save state
+        mysql->base.state = tb_database_mysql_state_from_errno(mysql_errno(mysql->database));
+
+        // trace
+        tb_trace_e("ping: failed, error[%d]: %s", mysql_errno(mysql->database), mysql_error(mysql->database));
+        return tb_false;
+    }
+
+    // ok
+    return tb_true;
+}
 static tb_bool_t tb_database_mysql_commit(tb_database_sql_impl_t* database)
 {
     // check
@@ -1641,6 +1661,7 @@ tb_database_sql_ref_t tb_database_mysql_init(tb_url_ref_t url)
         mysql->base.begin           = tb_database_mysql_begin;
         mysql->base.commit          = tb_database_mysql_commit;
         mysql->base.rollback        = tb_database_mysql_rollback;
+        mysql->base.ping            = tb_database_mysql_ping;
         mysql->base.result_load     = tb_database_mysql_result_load;
         mysql->base.result_exit     = tb_database_mysql_result_exit;
         mysql->base.statement_init  = tb_database_mysql_statement_init;
@@ -52,6 +52,9 @@ typedef struct __tb_database_sql_impl_t
     // is opened?
     tb_bool_t                       bopened;
 
+    // is in the transaction?
+    tb_bool_t                       btransaction;
+
     // open
     tb_bool_t                       (*open)(struct __tb_database_sql_impl_t* database);
 
@@ -61,6 +64,9 @@ typedef struct __tb_database_sql_impl_t
     // exit
     tb_void_t                       (*exit)(struct __tb_database_sql_impl_t* database);
 
+    // ping
+    tb_bool_t                       (*ping)(struct __tb_database_sql_impl_t* database);
+
     // done
     tb_bool_t                       (*done)(struct __tb_database_sql_impl_t* database, tb_char_t const* sql);
 
@@ -73,6 +79,9 @@ typedef struct __tb_database_sql_impl_t
     // rollback
     tb_bool_t                       (*rollback)(struct __tb_database_sql_impl_t* database);
 
+    // is in the transaction? optional, it also knows the transaction begun by the raw sql
+    tb_bool_t                       (*transaction)(struct __tb_database_sql_impl_t* database);
+
     // load result
     tb_iterator_ref_t               (*result_load)(struct __tb_database_sql_impl_t* database, tb_bool_t try_all);
 
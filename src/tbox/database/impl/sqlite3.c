@@ -32,12 +32,43 @@
  * includes
  */
 #include "prefix.h"
+#include "../../hash/bkdr.h"
+#include "../../memory/memory.h"
+#include "../../container/list_entry.h"
 #include <sqlite3.h>
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the prepared statement cache maxn for each connection
+#ifdef __tb_small__
+#   define TB_DATABASE_SQLITE3_STATEMENT_CACHE_MAXN     (16)
+#else
+#   define TB_DATABASE_SQLITE3_STATEMENT_CACHE_MAXN     (64)
+#endif
+
+// the busy timeout (ms) for waiting the locked database by other connections, e.g. the pooled connections
+#define TB_DATABASE_SQLITE3_BUSY_TIMEOUT                (5000)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
 
+// the sqlite3 cached statement entry type
+typedef struct __tb_database_sqlite3_cache_entry_t
+{
+    // the list entry
+    tb_list_entry_t                     entry;
+
+    // the sql hash
+    tb_size_t                           hash;
+
+    // the statement
+    sqlite3_stmt*                       statement;
+
+}tb_database_sqlite3_cache_entry_t;
+
 // the sqlite3 result row type
 typedef struct __tb_database_sqlite3_result_row_t
 {
@@ -61,10 +92,19 @@ typedef struct __tb_database_sqlite3_result_t
     // the iterator
     tb_iterator_t                       itor;
 
-    // the result
-    tb_char_t**                         result;
+    // the loaded texts of all values, the first row is the column names and all texts are terminated by '\0'
+    tb_buffer_t                         table;
 
-    // the statement
+    // the text offsets of all loaded values, (tb_size_t)-1 for the null value
+    tb_buffer_t                         offsets;
+
+    // is loaded?
+    tb_bool_t                           loaded;
+
+    // the owner of the statement is done() and it will be put back to the statement cache after finishing it?
+    tb_bool_t                           owned;
+
+    // the streaming statement
     sqlite3_stmt*                       statement;
 
     // the row count
@@ -87,6 +127,9 @@ typedef struct __tb_database_sqlite3_t
     // the result
     tb_database_sqlite3_result_t        result;
 
+    // the idle prepared statements, the least recently used statement is at the tail
+    tb_list_entry_head_t                cache;
+
 }tb_database_sqlite3_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -134,6 +177,7 @@ static tb_size_t tb_database_sqlite3_state_from_errno(tb_size_t errno)
         break;
     case SQLITE_ERROR:
     case SQLITE_INTERNAL:
+    case SQLITE_CONSTRAINT:
         break;
     default:
         tb_trace_e("unknown errno: %lu", errno);
@@ -144,6 +188,203 @@ static tb_size_t tb_database_sqlite3_state_from_errno(tb_size_t errno)
     return state;
 }
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * cache implementation
+ */
+static tb_void_t tb_database_sqlite3_cache_put(tb_database_sqlite3_t* sqlite, sqlite3_stmt* statement)
+{
+    // check
+    tb_assert_and_check_return(sqlite && statement);
+
+    // reset it and clear all bound arguments, the error of reset() has been reported by step()
+    sqlite3_reset(statement);
+    sqlite3_clear_bindings(statement);
+
+    // make entry
+    tb_char_t const*                    sql = sqlite3_sql(statement);
+    tb_database_sqlite3_cache_entry_t*  entry = sql? tb_malloc0_type(tb_database_sqlite3_cache_entry_t) : tb_null;
+    if (!entry)
+    {
+        // exit statement
+        sqlite3_finalize(statement);
+        return ;
+    }
+
+    // cache it at the head
+    entry->hash         = tb_bkdr_make_from_cstr(sql, 0);
+    entry->statement    = statement;
+    tb_list_entry_insert_head(&sqlite->cache, &entry->entry);
+
+    // full? evict the least recently used statement
+    if (tb_list_entry_size(&sqlite->cache) > TB_DATABASE_SQLITE3_STATEMENT_CACHE_MAXN)
+    {
+        // remove the last entry
+        tb_database_sqlite3_cache_entry_t* last = (tb_database_sqlite3_cache_entry_t*)tb_list_entry(&sqlite->cache, tb_list_entry_last(&sqlite->cache));
+        tb_list_entry_remove_last(&sqlite->cache);
+
+        // trace
+        tb_trace_d("cache: evict %s", sqlite3_sql(last->statement));
+
+        // exit it
+        sqlite3_finalize(last->statement);
+        tb_free(last);
+    }
+}
+static sqlite3_stmt* tb_database_sqlite3_cache_get(tb_database_sqlite3_t* sqlite, tb_char_t const* sql)
+{
+    // check
+    tb_assert_and_check_return_val(sqlite && sql, tb_null);
+
+    // find the prepared statement with the same sql
+    tb_size_t           hash = tb_bkdr_make_from_cstr(sql, 0);
+    tb_list_entry_ref_t tail = tb_list_entry_tail(&sqlite->cache);
+    tb_list_entry_ref_t node = tb_list_entry_head(&sqlite->cache);
+    for (; node != tail; node = tb_list_entry_next(node))
+    {
+        // found?
+        tb_database_sqlite3_cache_entry_t* entry = (tb_database_sqlite3_cache_entry_t*)tb_list_entry(&sqlite->cache, node);
+        if (entry->hash == hash && !tb_strcmp(sqlite3_sql(entry->statement), sql))
+        {
+            // take it out of the cache, it will be put back to the head after using it
+            sqlite3_stmt* statement = entry->statement;
+            tb_list_entry_remove(&sqlite->cache, node);
+            tb_free(entry);
+            return statement;
+        }
+    }
+
+    // not found
+    return tb_null;
+}
+static tb_void_t tb_database_sqlite3_cache_clear(tb_database_sqlite3_t* sqlite)
+{
+    // check
+    tb_assert_and_check_return(sqlite);
+
+    // exit all cached statements
+    while (tb_list_entry_size(&sqlite->cache))
+    {
+        // remove the head entry
+        tb_database_sqlite3_cache_entry_t* entry = (tb_database_sqlite3_cache_entry_t*)tb_list_entry(&sqlite->cache, tb_list_entry_head(&sqlite->cache));
+        tb_list_entry_remove_head(&sqlite->cache);
+
+        // exit it
+        sqlite3_finalize(entry->statement);
+        tb_free(entry);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * result implementation
+ */
+static tb_void_t tb_database_sqlite3_result_clear(tb_database_sqlite3_t* sqlite)
+{
+    // check
+    tb_assert_and_check_return(sqlite);
+
+    // the result
+    tb_database_sqlite3_result_t* result = &sqlite->result;
+
+    // finish the streaming statement
+    if (result->statement)
+    {
+        // put the statement of done() back to the cache, or reset the user statement for the next binding
+        if (result->owned) tb_database_sqlite3_cache_put(sqlite, result->statement);
+        else sqlite3_reset(result->statement);
+    }
+    result->statement   = tb_null;
+    result->owned       = tb_false;
+
+    // exit the loaded result
+    tb_buffer_exit(&result->table);
+    tb_buffer_exit(&result->offsets);
+    result->loaded      = tb_false;
+
+    // clear the row and col count
+    result->count       = 0;
+    result->row.count   = 0;
+}
+static tb_bool_t tb_database_sqlite3_result_grow(tb_buffer_ref_t buffer, tb_size_t size)
+{
+    // enough?
+    tb_size_t used = tb_buffer_size(buffer);
+    tb_size_t maxn = tb_buffer_maxn(buffer);
+    tb_check_return_val(used + size > maxn, tb_true);
+
+    /* grow the buffer capacity geometrically and keep the used size, 
+     * because tb_buffer only grows by a fixed size and appending all cells will be quadratic
+     */
+    if (!tb_buffer_resize(buffer, tb_max(used + size, maxn << 1))) return tb_false;
+    if (used) tb_buffer_resize(buffer, used);
+    else tb_buffer_clear(buffer);
+    return tb_true;
+}
+static tb_bool_t tb_database_sqlite3_result_save(tb_database_sqlite3_result_t* result, tb_char_t const* text, tb_size_t size)
+{
+    // the text offset
+    tb_size_t offset = text? tb_buffer_size(&result->table) : (tb_size_t)-1;
+
+    // grow the table and offsets
+    if (text && !tb_database_sqlite3_result_grow(&result->table, size + 1)) return tb_false;
+    if (!tb_database_sqlite3_result_grow(&result->offsets, sizeof(tb_size_t))) return tb_false;
+
+    // save the text and offset
+    if (text && !tb_buffer_memncat(&result->table, (tb_byte_t const*)text, size)) return tb_false;
+    if (text && !tb_buffer_memncat(&result->table, (tb_byte_t const*)"", 1)) return tb_false;
+    return tb_buffer_memncat(&result->offsets, (tb_byte_t const*)&offset, sizeof(tb_size_t))? tb_true : tb_false;
+}
+static tb_bool_t tb_database_sqlite3_result_load_all(tb_database_sqlite3_t* sqlite)
+{
+    // check
+    tb_database_sqlite3_result_t* result = &sqlite->result;
+    tb_assert_and_check_return_val(result->statement && !result->loaded, tb_false);
+
+    // save the column names to the first row
+    tb_size_t       i = 0;
+    tb_size_t       col_count = result->row.count;
+    sqlite3_stmt*   statement = result->statement;
+    for (i = 0; i < col_count; i++)
+    {
+        tb_char_t const* name = sqlite3_column_name(statement, (tb_int_t)i);
+        if (!tb_database_sqlite3_result_save(result, name, name? tb_strlen(name) : 0)) return tb_false;
+    }
+
+    // save the texts of the current row and all remaining rows, like sqlite3_get_table()
+    tb_int_t    ok = SQLITE_ROW;
+    tb_size_t   row_count = 0;
+    for (; ok == SQLITE_ROW; ok = sqlite3_step(statement), row_count++)
+    {
+        for (i = 0; i < col_count; i++)
+        {
+            tb_char_t const* text = (tb_char_t const*)sqlite3_column_text(statement, (tb_int_t)i);
+            if (!tb_database_sqlite3_result_save(result, text, text? (tb_size_t)sqlite3_column_bytes(statement, (tb_int_t)i) : 0)) return tb_false;
+        }
+    }
+    if (ok != SQLITE_DONE)
+    {
+        // save state
+        sqlite->base.state = tb_database_sqlite3_state_from_errno(sqlite3_errcode(sqlite->database));
+
+        // trace
+        tb_trace_e("result: load failed, error[%d]: %s", sqlite3_errcode(sqlite->database), sqlite3_errmsg(sqlite->database));
+        return tb_false;
+    }
+
+    // finish the statement
+    if (result->owned) tb_database_sqlite3_cache_put(sqlite, statement);
+    else sqlite3_reset(statement);
+    result->statement   = tb_null;
+    result->owned       = tb_false;
+
+    // save the loaded result, it can be accessed randomly now
+    result->loaded      = tb_true;
+    result->count       = row_count;
+    result->itor.mode   = TB_ITERATOR_MODE_RACCESS | TB_ITERATOR_MODE_READONLY;
+
+    // ok
+    return tb_true;
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * iterator implementation
  */
@@ -177,8 +418,8 @@ static tb_size_t tb_database_sqlite3_result_row_iterator_prev(tb_iterator_ref_t
     tb_assert(result);
     tb_assert_and_check_return_val(itor && itor <= result->count, result->count);
 
-    // cannot be the statement result
-    tb_assert_and_check_return_val(!result->statement, result->count);
+    // only for the loaded result
+    tb_assert_and_check_return_val(result->loaded, result->count);
 
     // prev
     return itor - 1;
@@ -199,21 +440,26 @@ static tb_size_t tb_database_sqlite3_result_row_iterator_next(tb_iterator_ref_t
         // end?
         if (ok != SQLITE_ROW) 
         {
-            // reset it 
-            if (SQLITE_OK != sqlite3_reset(result->statement))
+            // the sqlite
+            tb_database_sqlite3_t* sqlite = (tb_database_sqlite3_t*)iterator->priv;
+            tb_assert_and_check_return_val(sqlite, result->count);
+
+            // failed?
+            if (ok != SQLITE_DONE)
             {
-                // the sqlite
-                tb_database_sqlite3_t* sqlite = (tb_database_sqlite3_t*)iterator->priv;
-                if (sqlite)
-                {
-                    // save state
-                    sqlite->base.state = tb_database_sqlite3_state_from_errno(sqlite3_errcode(sqlite->database));
+                // save state
+                sqlite->base.state = tb_database_sqlite3_state_from_errno(sqlite3_errcode(sqlite->database));
 
-                    // trace
-                    tb_trace_e("statement: reset failed, error[%d]: %s", sqlite3_errcode(sqlite->database), sqlite3_errmsg(sqlite->database));
-                }
+                // trace
+                tb_trace_e("statement: step failed, error[%d]: %s", sqlite3_errcode(sqlite->database), sqlite3_errmsg(sqlite->database));
             }
 
+            // finish the statement, the statement of done() will be put back to the cache
+            if (result->owned) tb_database_sqlite3_cache_put(sqlite, result->statement);
+            else sqlite3_reset(result->statement);
+            result->statement   = tb_null;
+            result->owned       = tb_false;
+
             // tail
             return result->count;
         }
@@ -226,7 +472,7 @@ static tb_pointer_t tb_database_sqlite3_result_row_iterator_item(tb_iterator_ref
 {
     // check
     tb_database_sqlite3_result_t* result = (tb_database_sqlite3_result_t*)iterator;
-    tb_assert_and_check_return_val(result && (result->result || result->statement) && itor < result->count, tb_null);
+    tb_assert_and_check_return_val(result && (result->loaded || result->statement) && itor < result->count, tb_null);
 
     // save the row
     result->row.row = itor;
@@ -289,12 +535,20 @@ static tb_pointer_t tb_database_sqlite3_result_col_iterator_item(tb_iterator_ref
     tb_database_sqlite3_t* sqlite = (tb_database_sqlite3_t*)iterator->priv;
     tb_assert_and_check_return_val(sqlite, tb_null);
 
-    // result?
-    if (sqlite->result.result)
+    // loaded result?
+    if (sqlite->result.loaded)
     {
+        // the texts and offsets, the first row is the column names
+        tb_char_t const*    table = (tb_char_t const*)tb_buffer_data(&sqlite->result.table);
+        tb_size_t const*    offsets = (tb_size_t const*)tb_buffer_data(&sqlite->result.offsets);
+        tb_assert_and_check_return_val(table && offsets, tb_null);
+
         // init value
-        tb_database_sql_value_name_set(&row->value, (tb_char_t const*)sqlite->result.result[itor]);
-        tb_database_sql_value_set_text(&row->value, (tb_char_t const*)sqlite->result.result[((1 + sqlite->result.row.row) * row->count) + itor], 0);
+        tb_size_t offset = offsets[itor];
+        tb_database_sql_value_name_set(&row->value, offset != (tb_size_t)-1? table + offset : tb_null);
+        offset = offsets[((1 + sqlite->result.row.row) * row->count) + itor];
+        if (offset != (tb_size_t)-1) tb_database_sql_value_set_text(&row->value, table + offset, 0);
+        else tb_database_sql_value_set_null(&row->value);
         return (tb_pointer_t)&row->value;
     }
     // statement result?
@@ -308,7 +562,12 @@ static tb_pointer_t tb_database_sqlite3_result_col_iterator_item(tb_iterator_ref
         switch (type)
         {
         case SQLITE_INTEGER:
-            tb_database_sql_value_set_int32(&row->value, sqlite3_column_int(sqlite->result.statement, itor));
+            {
+                // save it as int32 if it fits, otherwise int64
+                tb_int64_t number = (tb_int64_t)sqlite3_column_int64(sqlite->result.statement, itor);
+                if (number >= TB_MINS32 && number <= TB_MAXS32) tb_database_sql_value_set_int32(&row->value, (tb_int32_t)number);
+                else tb_database_sql_value_set_int64(&row->value, number);
+            }
             break;
         case SQLITE_TEXT:
             tb_database_sql_value_set_text(&row->value, (tb_char_t const*)sqlite3_column_text(sqlite->result.statement, itor), sqlite3_column_bytes(sqlite->result.statement, itor));
@@ -386,6 +645,9 @@ static tb_bool_t tb_database_sqlite3_open(tb_database_sql_impl_t* database)
             break;
         }
 
+        // wait for the lock of other connections instead of failing with SQLITE_BUSY directly
+        sqlite3_busy_timeout(sqlite->database, TB_DATABASE_SQLITE3_BUSY_TIMEOUT);
+
         // ok
         ok = tb_true;
 
@@ -404,8 +666,10 @@ static tb_void_t tb_database_sqlite3_clos(tb_database_sql_impl_t* database)
     tb_assert_and_check_return(sqlite);
     
     // exit result first if exists
-    if (sqlite->result.result) sqlite3_free_table(sqlite->result.result);
-    sqlite->result.result = tb_null;
+    tb_database_sqlite3_result_clear(sqlite);
+
+    // exit all cached statements
+    tb_database_sqlite3_cache_clear(sqlite);
 
     // close database
     if (sqlite->database) sqlite3_close(sqlite->database);
@@ -486,6 +750,24 @@ static tb_bool_t tb_database_sqlite3_rollback(tb_database_sql_impl_t* database)
     // ok
     return tb_true;
 }
+static tb_bool_t tb_database_sqlite3_transaction(tb_database_sql_impl_t* database)
+{
+    // check
+    tb_database_sqlite3_t* sqlite = tb_database_sqlite3_cast(database);
+    tb_assert_and_check_return_val(sqlite && sqlite->database, tb_false);
+
+    // it is not in the autocommit mode if the transaction has been begun, even if it is begun by the raw sql
+    return !sqlite3_get_autocommit(sqlite->database);
+}
+static tb_bool_t tb_database_sqlite3_ping(tb_database_sql_impl_t* database)
+{
+    // check
+    tb_database_sqlite3_t* sqlite = tb_database_sqlite3_cast(database);
+    tb_assert_and_check_return_val(sqlite, tb_false);
+
+    // the local database is always alive if it has been opened
+    return sqlite->database? tb_true : tb_false;
+}
 static tb_bool_t tb_database_sqlite3_done(tb_database_sql_impl_t* database, tb_char_t const* sql)
 {
     // check
@@ -493,62 +775,105 @@ static tb_bool_t tb_database_sqlite3_done(tb_database_sql_impl_t* database, tb_c
     tb_assert_and_check_return_val(sqlite && sqlite->database && sql, tb_false);
 
     // done
-    tb_bool_t ok = tb_false;
+    tb_bool_t       ok = tb_false;
+    tb_bool_t       failed = tb_false;
+    sqlite3_stmt*   statement = tb_null;
     do
     {
         // exit result first if exists
-        if (sqlite->result.result) sqlite3_free_table(sqlite->result.result);
-        sqlite->result.result = tb_null;
+        tb_database_sqlite3_result_clear(sqlite);
 
-        // clear the lasr statement first
-        sqlite->result.statement = tb_null;
+        // get the prepared statement from the cache first
+        statement = tb_database_sqlite3_cache_get(sqlite, sql);
 
-        // clear the result row count first
-        sqlite->result.count = 0;
+        // prepare it and done all statements before the last one, only the last statement may have the result
+        tb_char_t const* next = sql;
+        while (!statement && *next)
+        {
+            // prepare the next statement
+            tb_char_t const* tail = tb_null;
+            if (SQLITE_OK != sqlite3_prepare_v2(sqlite->database, next, -1, &statement, &tail))
+            {
+                // save state
+                sqlite->base.state = tb_database_sqlite3_state_from_errno(sqlite3_errcode(sqlite->database));
 
-        // clear the result col count first
-        sqlite->result.row.count = 0;
+                // trace
+                tb_trace_e("done: sql: %s failed, error[%d]: %s", sql, sqlite3_errcode(sqlite->database), sqlite3_errmsg(sqlite->database));
 
-        // done sql
-        tb_int_t    row_count = 0;
-        tb_int_t    col_count = 0;
-        tb_char_t*  error = tb_null;
-        if (SQLITE_OK != sqlite3_get_table(sqlite->database, sql, &sqlite->result.result, &row_count, &col_count, &error))
-        {
-            // save state
-            sqlite->base.state = tb_database_sqlite3_state_from_errno(sqlite3_errcode(sqlite->database));
+                // failed
+                statement = tb_null;
+                failed = tb_true;
+                break;
+            }
 
-            // trace
-            tb_trace_e("done: sql: %s failed, error[%d]: %s", sql, sqlite3_errcode(sqlite->database), error);
+            // the last statement?
+            while (tail && tb_isspace(*tail)) tail++;
+            if (!tail || !*tail) break;
 
-            // exit error
-            if (error) sqlite3_free(error);
-            break;
-        }
+            // done this statement, it may be null for the comment
+            if (statement)
+            {
+                // step it to the end
+                tb_int_t result = SQLITE_ROW;
+                while (result == SQLITE_ROW) result = sqlite3_step(statement);
+                if (result != SQLITE_DONE)
+                {
+                    // save state
+                    sqlite->base.state = tb_database_sqlite3_state_from_errno(sqlite3_errcode(sqlite->database));
 
-        // no result?
-        if (!row_count)
-        {
-            // exit result
-            if (sqlite->result.result) sqlite3_free_table(sqlite->result.result);
-            sqlite->result.result = tb_null;
+                    // trace
+                    tb_trace_e("done: sql: %s failed, error[%d]: %s", sql, sqlite3_errcode(sqlite->database), sqlite3_errmsg(sqlite->database));
 
-            // trace
-            tb_trace_d("done: sql: %s: ok", sql);
+                    // failed
+                    failed = tb_true;
+                    break;
+                }
+
+                // put it to the cache
+                tb_database_sqlite3_cache_put(sqlite, statement);
+                statement = tb_null;
+            }
 
+            // the next statement
+            next = tail;
+        }
+        tb_check_break(!failed);
+
+        // no statement? only spaces or comments
+        if (!statement)
+        {
             // ok
             ok = tb_true;
             break;
         }
 
-        // save the result iterator mode
-        sqlite->result.itor.mode = TB_ITERATOR_MODE_RACCESS | TB_ITERATOR_MODE_READONLY;
+        // step the first row
+        tb_int_t result = sqlite3_step(statement);
+        if (result == SQLITE_ROW)
+        {
+            // save the result iterator mode, the rows will be stepped lazily
+            sqlite->result.itor.mode = TB_ITERATOR_MODE_FORWARD | TB_ITERATOR_MODE_READONLY;
 
-        // save result row count
-        sqlite->result.count = row_count;
+            // save statement for iterating it, it will be put back to the cache after finishing it
+            sqlite->result.statement    = statement;
+            sqlite->result.owned        = tb_true;
+            statement                   = tb_null;
 
-        // save result col count
-        sqlite->result.row.count = col_count;
+            // save result row count, it is unknown now
+            sqlite->result.count = (tb_size_t)-1;
+
+            // save result col count
+            sqlite->result.row.count = sqlite3_column_count(sqlite->result.statement);
+        }
+        else if (result != SQLITE_DONE)
+        {
+            // save state
+            sqlite->base.state = tb_database_sqlite3_state_from_errno(sqlite3_errcode(sqlite->database));
+
+            // trace
+            tb_trace_e("done: sql: %s failed, error[%d]: %s", sql, sqlite3_errcode(sqlite->database), sqlite3_errmsg(sqlite->database));
+            break;
+        }
 
         // trace
         tb_trace_d("done: sql: %s: ok", sql);
@@ -557,6 +882,13 @@ static tb_bool_t tb_database_sqlite3_done(tb_database_sql_impl_t* database, tb_c
         ok = tb_true;
     
     } while (0);
+
+    // put the finished statement back to the cache
+    if (statement)
+    {
+        if (!failed) tb_database_sqlite3_cache_put(sqlite, statement);
+        else sqlite3_finalize(statement);
+    }
     
     // ok?
     return ok;
@@ -564,19 +896,11 @@ static tb_bool_t tb_database_sqlite3_done(tb_database_sql_impl_t* database, tb_c
 static tb_void_t tb_database_sqlite3_result_exit(tb_database_sql_impl_t* database, tb_iterator_ref_t result)
 {
     // check
-    tb_database_sqlite3_result_t* sqlite3_result = (tb_database_sqlite3_result_t*)result;
-    tb_assert_and_check_return(sqlite3_result);
+    tb_database_sqlite3_t* sqlite = tb_database_sqlite3_cast(database);
+    tb_assert_and_check_return(sqlite && result == (tb_iterator_ref_t)&sqlite->result);
 
     // exit result
-    if (sqlite3_result->result) sqlite3_free_table(sqlite3_result->result);
-    sqlite3_result->result = tb_null;
-
-    // clear the statement
-    sqlite3_result->statement = tb_null;
-
-    // clear result
-    sqlite3_result->count = 0;
-    sqlite3_result->row.count = 0;
+    tb_database_sqlite3_result_clear(sqlite);
 }
 static tb_iterator_ref_t tb_database_sqlite3_result_load(tb_database_sql_impl_t* database, tb_bool_t try_all)
 {
@@ -584,13 +908,31 @@ static tb_iterator_ref_t tb_database_sqlite3_result_load(tb_database_sql_impl_t*
     tb_database_sqlite3_t* sqlite = tb_database_sqlite3_cast(database);
     tb_assert_and_check_return_val(sqlite && sqlite->database, tb_null);
 
-    // ok?
-    return (sqlite->result.result || sqlite->result.statement)? (tb_iterator_ref_t)&sqlite->result : tb_null;
+    // no result?
+    tb_check_return_val(sqlite->result.loaded || sqlite->result.statement, tb_null);
+
+    // load all rows into memory for the random access? otherwise the rows will be stepped lazily
+    if (try_all && !sqlite->result.loaded && !tb_database_sqlite3_result_load_all(sqlite))
+    {
+        // exit result
+        tb_database_sqlite3_result_clear(sqlite);
+        return tb_null;
+    }
+
+    // ok
+    return (tb_iterator_ref_t)&sqlite->result;
 }
 static tb_void_t tb_database_sqlite3_statement_exit(tb_database_sql_impl_t* database, tb_database_sql_statement_ref_t statement)
 {
-    // exit statement
-    if (statement) sqlite3_finalize((sqlite3_stmt*)statement);
+    // check
+    tb_database_sqlite3_t* sqlite = tb_database_sqlite3_cast(database);
+    tb_assert_and_check_return(sqlite && statement);
+
+    // exit the result of this statement first
+    if (sqlite->result.statement == (sqlite3_stmt*)statement) tb_database_sqlite3_result_clear(sqlite);
+
+    // put it back to the cache for the next statement with the same sql
+    tb_database_sqlite3_cache_put(sqlite, (sqlite3_stmt*)statement);
 }
 static tb_database_sql_statement_ref_t tb_database_sqlite3_statement_init(tb_database_sql_impl_t* database, tb_char_t const* sql)
 {
@@ -598,9 +940,9 @@ static tb_database_sql_statement_ref_t tb_database_sqlite3_statement_init(tb_dat
     tb_database_sqlite3_t* sqlite = tb_database_sqlite3_cast(database);
     tb_assert_and_check_return_val(sqlite && sqlite->database && sql, tb_null);
 
-    // init statement
-    sqlite3_stmt* statement = tb_null;
-    if (SQLITE_OK != sqlite3_prepare_v2(sqlite->database, sql, -1, &statement, 0))
+    // get the prepared statement from the cache first, otherwise prepare it
+    sqlite3_stmt* statement = tb_database_sqlite3_cache_get(sqlite, sql);
+    if (!statement && SQLITE_OK != sqlite3_prepare_v2(sqlite->database, sql, -1, &statement, 0))
     {
         // save state
         sqlite->base.state = tb_database_sqlite3_state_from_errno(sqlite3_errcode(sqlite->database));
@@ -622,22 +964,23 @@ static tb_bool_t tb_database_sqlite3_statement_done(tb_database_sql_impl_t* data
     tb_bool_t ok = tb_false;
     do
     {
-        // exit result first if exists
-        if (sqlite->result.result) sqlite3_free_table(sqlite->result.result);
-        sqlite->result.result = tb_null;
-
-        // clear the last statement first
-        sqlite->result.statement = tb_null;
-
-        // clear the result row count first
-        sqlite->result.count = 0;
-
-        // clear the result col count first
-        sqlite->result.row.count = 0;
+        // exit result first if exists, the statement will be reset if it is being iterated
+        tb_database_sqlite3_result_clear(sqlite);
 
         // step statement
         tb_int_t result = sqlite3_step((sqlite3_stmt*)statement);
-        tb_assert_and_check_break(result == SQLITE_DONE || result == SQLITE_ROW);
+        if (result != SQLITE_DONE && result != SQLITE_ROW)
+        {
+            // save state
+            sqlite->base.state = tb_database_sqlite3_state_from_errno(sqlite3_errcode(sqlite->database));
+
+            // trace
+            tb_trace_e("statement: done failed, error[%d]: %s", sqlite3_errcode(sqlite->database), sqlite3_errmsg(sqlite->database));
+
+            // reset it for binding and doing it again, it will return the same error
+            sqlite3_reset((sqlite3_stmt*)statement);
+            break;
+        }
 
         // exists result?
         if (result == SQLITE_ROW)
@@ -695,7 +1038,10 @@ static tb_bool_t tb_database_sqlite3_statement_bind(tb_database_sql_impl_t* data
     // the param count
     tb_size_t param_count = (tb_size_t)sqlite3_bind_parameter_count((sqlite3_stmt*)statement);
     tb_assert_and_check_return_val(size == param_count, tb_false);
-   
+
+    // exit the result of this statement first, it cannot be bound while being iterated
+    if (sqlite->result.statement == (sqlite3_stmt*)statement) tb_database_sqlite3_result_clear(sqlite);
+
     // walk
     tb_size_t i = 0;
     for (i = 0; i < size; i++)
@@ -709,7 +1055,6 @@ static tb_bool_t tb_database_sqlite3_statement_bind(tb_database_sql_impl_t* data
         switch (value->type)
         {
         case TB_DATABASE_SQL_VALUE_TYPE_TEXT:
-            tb_trace_i("sqlite3: test %lu %s", i, value->u.text.data);
             ok = sqlite3_bind_text((sqlite3_stmt*)statement, (tb_int_t)(i + 1), value->u.text.data, (tb_int_t)tb_database_sql_value_size(value), tb_null);
             break;
         case TB_DATABASE_SQL_VALUE_TYPE_INT64:
@@ -874,6 +1219,8 @@ tb_database_sql_ref_t tb_database_sqlite3_init(tb_url_ref_t url)
         sqlite->base.begin          = tb_database_sqlite3_begin;
         sqlite->base.commit         = tb_database_sqlite3_commit;
         sqlite->base.rollback       = tb_database_sqlite3_rollback;
+        sqlite->base.transaction    = tb_database_sqlite3_transaction;
+        sqlite->base.ping           = tb_database_sqlite3_ping;
         sqlite->base.result_load    = tb_database_sqlite3_result_load;
         sqlite->base.result_exit    = tb_database_sqlite3_result_exit;
         sqlite->base.statement_init = tb_database_sqlite3_statement_init;
@@ -881,6 +1228,13 @@ tb_database_sql_ref_t tb_database_sqlite3_init(tb_url_ref_t url)
         sqlite->base.statement_done = tb_database_sqlite3_statement_done;
         sqlite->base.statement_bind = tb_database_sqlite3_statement_bind;
 
+        // init statement cache
+        tb_list_entry_init(&sqlite->cache, tb_database_sqlite3_cache_entry_t, entry, tb_null);
+
+        // init the loaded result
+        if (!tb_buffer_init(&sqlite->result.table)) break;
+        if (!tb_buffer_init(&sqlite->result.offsets)) break;
+
         // init result row iterator
         sqlite->result.itor.mode    = 0;
         sqlite->result.itor.priv    = (tb_pointer_t)sqlite;
@@ -0,0 +1,485 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        pool.c
+ * @ingroup     database
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "database_pool"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "pool.h"
+#include "../libc/libc.h"
+#include "../platform/platform.h"
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+#   include "../coroutine/coroutine.h"
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the idle interval (ms) for pinging the connection before pulling it
+#define TB_DATABASE_SQL_POOL_PING_INTERVAL      (5000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the idle connection type
+typedef struct __tb_database_sql_pool_item_t
+{
+    // the database
+    tb_database_sql_ref_t               database;
+
+    // the pushed time
+    tb_hong_t                           time;
+
+    // need ping it? it failed last time
+    tb_bool_t                           bcheck;
+
+}tb_database_sql_pool_item_t;
+
+// the database sql pool type
+typedef struct __tb_database_sql_pool_t
+{
+    // the url
+    tb_char_t*                          url;
+
+    // the min connection count
+    tb_size_t                           minn;
+
+    // the max connection count
+    tb_size_t                           maxn;
+
+    // the idle timeout
+    tb_long_t                           idle_timeout;
+
+    // the lock
+    tb_spinlock_t                       lock;
+
+    // the free connection slots
+    tb_semaphore_ref_t                  semaphore;
+
+    // the idle connections, the most recently pushed connection is at the top
+    tb_database_sql_pool_item_t*        idles;
+
+    // the idle connection count
+    tb_size_t                           idle_count;
+
+    // the opened connection count
+    tb_size_t                           count;
+
+}tb_database_sql_pool_t;
+
+// the offloaded task type
+typedef struct __tb_database_sql_pool_task_t
+{
+    // the pool
+    tb_database_sql_pool_t*             pool;
+
+    // the func
+    tb_database_sql_pool_done_func_t    func;
+
+    // the user private data
+    tb_cpointer_t                       priv;
+
+    // the timeout
+    tb_long_t                           timeout;
+
+    // the notification pair, the worker will send one byte to pair[0] and exit it after finishing it
+    tb_socket_ref_t                     pair[2];
+
+    // ok?
+    tb_bool_t                           ok;
+
+    // is finished? the task cannot be accessed by the worker after setting it
+    tb_atomic_t                         finished;
+
+}tb_database_sql_pool_task_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_database_sql_ref_t tb_database_sql_pool_open(tb_database_sql_pool_t* pool)
+{
+    // init database
+    tb_database_sql_ref_t database = tb_database_sql_init(pool->url);
+    tb_assert_and_check_return_val(database, tb_null);
+
+    // open it
+    if (!tb_database_sql_open(database))
+    {
+        // trace
+        tb_trace_e("open %s failed, error: %s", pool->url, tb_state_cstr(tb_database_sql_state(database)));
+
+        // exit it
+        tb_database_sql_exit(database);
+        return tb_null;
+    }
+
+    // ok
+    return database;
+}
+static tb_bool_t tb_database_sql_pool_done_impl(tb_database_sql_pool_t* pool, tb_database_sql_pool_done_func_t func, tb_cpointer_t priv, tb_long_t timeout)
+{
+    // pull a connection
+    tb_database_sql_ref_t database = tb_database_sql_pool_pull((tb_database_sql_pool_ref_t)pool, timeout);
+    tb_check_return_val(database, tb_false);
+
+    // done it
+    tb_bool_t ok = func(database, priv);
+
+    // push it back
+    tb_database_sql_pool_push((tb_database_sql_pool_ref_t)pool, database);
+
+    // ok?
+    return ok;
+}
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+static tb_void_t tb_database_sql_pool_done_task(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_database_sql_pool_task_t* task = (tb_database_sql_pool_task_t*)priv;
+    tb_assert_and_check_return(task);
+
+    // done it in the worker thread
+    tb_socket_ref_t sock = task->pair[0];
+    task->ok = tb_database_sql_pool_done_impl(task->pool, task->func, task->priv, task->timeout);
+
+    // finish it, @note the task cannot be accessed after finishing it
+    tb_atomic_set(&task->finished, 1);
+
+    // resume the waiting coroutine
+    tb_byte_t notified = 1;
+    if (1 != tb_socket_send(sock, &notified, 1))
+    {
+        // trace
+        tb_trace_e("notify the finished task failed!");
+    }
+
+    // exit the notification socket, the waiting coroutine will be also resumed if it is closed
+    tb_socket_exit(sock);
+}
+static tb_bool_t tb_database_sql_pool_done_offload(tb_database_sql_pool_t* pool, tb_database_sql_pool_done_func_t func, tb_cpointer_t priv, tb_long_t timeout, tb_bool_t* pok)
+{
+    // init task
+    tb_database_sql_pool_task_t task;
+    task.pool       = pool;
+    task.func       = func;
+    task.priv       = priv;
+    task.timeout    = timeout;
+    task.ok         = tb_false;
+    task.finished   = 0;
+    task.pair[0]    = tb_null;
+    task.pair[1]    = tb_null;
+
+    // init the notification pair
+    if (!tb_socket_pair(TB_SOCKET_TYPE_TCP, task.pair)) return tb_false;
+
+    // post it to the thread pool
+    tb_bool_t posted = tb_thread_pool_task_post(tb_thread_pool(), "database_sql_pool", tb_database_sql_pool_done_task, tb_null, &task, tb_false);
+    if (posted)
+    {
+        /* suspend the current coroutine until the task has been finished
+         *
+         * the task is on the stack of this coroutine, so we must wait the finished flag
+         * even if the notification is failed, only poll it if the io waiting is failed
+         */
+        tb_byte_t notified = 0;
+        while (!tb_atomic_get(&task.finished))
+        {
+            tb_long_t real = tb_socket_recv(task.pair[1], &notified, 1);
+            if (real > 0) continue;
+            if (real < 0 || tb_socket_wait(task.pair[1], TB_SOCKET_EVENT_RECV, -1) < 0) 
+                tb_coroutine_sleep(1);
+        }
+
+        // save result
+        *pok = task.ok;
+    }
+    // the notification socket of the worker has been exited if it is posted
+    else tb_socket_exit(task.pair[0]);
+
+    // exit the waiting socket, it will also remove the socket from the scheduler poller
+    tb_socket_exit(task.pair[1]);
+
+    // ok?
+    return posted;
+}
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_database_sql_pool_ref_t tb_database_sql_pool_init(tb_char_t const* url, tb_size_t minn, tb_size_t maxn, tb_long_t idle_timeout)
+{
+    // check
+    tb_assert_and_check_return_val(url && maxn && minn <= maxn, tb_null);
+
+    // done
+    tb_bool_t               ok = tb_false;
+    tb_database_sql_pool_t* pool = tb_null;
+    do
+    {
+        // make pool
+        pool = tb_malloc0_type(tb_database_sql_pool_t);
+        tb_assert_and_check_break(pool);
+
+        // init pool
+        pool->minn          = minn;
+        pool->maxn          = maxn;
+        pool->idle_timeout  = idle_timeout? idle_timeout : TB_DATABASE_SQL_POOL_IDLE_TIMEOUT;
+
+        // init url
+        pool->url = tb_strdup(url);
+        tb_assert_and_check_break(pool->url);
+
+        // init lock
+        if (!tb_spinlock_init(&pool->lock)) break;
+
+        // init semaphore
+        pool->semaphore = tb_semaphore_init(maxn);
+        tb_assert_and_check_break(pool->semaphore);
+
+        // init idle connections
+        pool->idles = tb_nalloc0_type(maxn, tb_database_sql_pool_item_t);
+        tb_assert_and_check_break(pool->idles);
+
+        // open the min connections
+        tb_hong_t now = tb_mclock();
+        for (; pool->idle_count < minn; pool->idle_count++)
+        {
+            // open it
+            tb_database_sql_ref_t database = tb_database_sql_pool_open(pool);
+            tb_check_break(database);
+
+            // save it
+            pool->idles[pool->idle_count].database  = database;
+            pool->idles[pool->idle_count].time      = now;
+        }
+        pool->count = pool->idle_count;
+        tb_check_break(pool->idle_count == minn);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (pool) tb_database_sql_pool_exit((tb_database_sql_pool_ref_t)pool);
+        pool = tb_null;
+    }
+
+    // ok?
+    return (tb_database_sql_pool_ref_t)pool;
+}
+tb_void_t tb_database_sql_pool_exit(tb_database_sql_pool_ref_t self)
+{
+    // check
+    tb_database_sql_pool_t* pool = (tb_database_sql_pool_t*)self;
+    tb_assert_and_check_return(pool);
+
+    // check the busy connections
+    tb_assertf(pool->count == pool->idle_count, "%lu connections have not been pushed back!", pool->count - pool->idle_count);
+
+    // exit all idle connections
+    if (pool->idles)
+    {
+        tb_size_t i = 0;
+        for (i = 0; i < pool->idle_count; i++)
+        {
+            if (pool->idles[i].database) tb_database_sql_exit(pool->idles[i].database);
+        }
+        tb_free(pool->idles);
+        pool->idles = tb_null;
+    }
+    pool->idle_count    = 0;
+    pool->count         = 0;
+
+    // exit semaphore
+    if (pool->semaphore) tb_semaphore_exit(pool->semaphore);
+    pool->semaphore = tb_null;
+
+    // exit lock
+    tb_spinlock_exit(&pool->lock);
+
+    // exit url
+    if (pool->url) tb_free(pool->url);
+    pool->url = tb_null;
+
+    // exit it
+    tb_free(pool);
+}
+tb_database_sql_ref_t tb_database_sql_pool_pull(tb_database_sql_pool_ref_t self, tb_long_t timeout)
+{
+    // check
+    tb_database_sql_pool_t* pool = (tb_database_sql_pool_t*)self;
+    tb_assert_and_check_return_val(pool && pool->semaphore && pool->idles, tb_null);
+
+    // wait a free connection slot
+    tb_long_t wait = tb_semaphore_wait(pool->semaphore, timeout);
+    tb_check_return_val(wait > 0, tb_null);
+
+    // evict the expired idle connections first
+    tb_database_sql_pool_evict(self);
+
+    // pop the most recently used idle connection, or reserve one slot for opening a new connection
+    tb_database_sql_pool_item_t item = {0};
+    tb_spinlock_enter(&pool->lock);
+    if (pool->idle_count) item = pool->idles[--pool->idle_count];
+    else pool->count++;
+    tb_spinlock_leave(&pool->lock);
+
+    // check it if it has been idle too long or failed last time, it will be reopened if it is broken
+    tb_database_sql_ref_t database = item.database;
+    if (database && (item.bcheck || tb_mclock() - item.time > TB_DATABASE_SQL_POOL_PING_INTERVAL) && !tb_database_sql_ping(database))
+    {
+        // trace
+        tb_trace_d("pull: the connection(%p) is broken, reopen it", database);
+
+        // exit it
+        tb_database_sql_exit(database);
+        database = tb_null;
+    }
+
+    // open a new connection
+    if (!database && !(database = tb_database_sql_pool_open(pool)))
+    {
+        // release this slot
+        tb_spinlock_enter(&pool->lock);
+        pool->count--;
+        tb_spinlock_leave(&pool->lock);
+        tb_semaphore_post(pool->semaphore, 1);
+    }
+
+    // trace
+    tb_trace_d("pull: %p", database);
+
+    // ok?
+    return database;
+}
+tb_void_t tb_database_sql_pool_push(tb_database_sql_pool_ref_t self, tb_database_sql_ref_t database)
+{
+    // check
+    tb_database_sql_pool_t* pool = (tb_database_sql_pool_t*)self;
+    tb_assert_and_check_return(pool && pool->semaphore && pool->idles && database);
+
+    // trace
+    tb_trace_d("push: %p", database);
+
+    // push it to the top of the idle connections
+    tb_spinlock_enter(&pool->lock);
+    tb_assert(pool->idle_count < pool->maxn);
+    if (pool->idle_count < pool->maxn)
+    {
+        tb_database_sql_pool_item_t* item = &pool->idles[pool->idle_count++];
+        item->database  = database;
+        item->time      = tb_mclock();
+        item->bcheck    = tb_database_sql_state(database) != TB_STATE_OK;
+    }
+    tb_spinlock_leave(&pool->lock);
+
+    // evict the expired idle connections
+    tb_database_sql_pool_evict(self);
+
+    // release this slot
+    tb_semaphore_post(pool->semaphore, 1);
+}
+tb_size_t tb_database_sql_pool_evict(tb_database_sql_pool_ref_t self)
+{
+    // check
+    tb_database_sql_pool_t* pool = (tb_database_sql_pool_t*)self;
+    tb_assert_and_check_return_val(pool && pool->idles, 0);
+
+    // never evict them?
+    tb_check_return_val(pool->idle_timeout >= 0, 0);
+
+    // evict the least recently used connections at the bottom one by one
+    tb_size_t evicted = 0;
+    tb_hong_t now = tb_mclock();
+    while (1)
+    {
+        // remove the bottom connection if it has been expired
+        tb_database_sql_ref_t database = tb_null;
+        tb_spinlock_enter(&pool->lock);
+        if (pool->idle_count && pool->count > pool->minn && now - pool->idles[0].time >= pool->idle_timeout)
+        {
+            database = pool->idles[0].database;
+            tb_memmov(pool->idles, pool->idles + 1, (--pool->idle_count) * sizeof(tb_database_sql_pool_item_t));
+            pool->count--;
+        }
+        tb_spinlock_leave(&pool->lock);
+        tb_check_break(database);
+
+        // trace
+        tb_trace_d("evict: %p", database);
+
+        // exit it
+        tb_database_sql_exit(database);
+        evicted++;
+    }
+
+    // ok?
+    return evicted;
+}
+tb_bool_t tb_database_sql_pool_done(tb_database_sql_pool_ref_t self, tb_database_sql_pool_done_func_t func, tb_cpointer_t priv, tb_long_t timeout)
+{
+    // check
+    tb_database_sql_pool_t* pool = (tb_database_sql_pool_t*)self;
+    tb_assert_and_check_return_val(pool && func, tb_false);
+
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+    // in coroutine? offload the blocking calls to the thread pool
+    tb_bool_t ok = tb_false;
+    if (tb_coroutine_self() && tb_database_sql_pool_done_offload(pool, func, priv, timeout, &ok)) return ok;
+#endif
+
+    // done it directly
+    return tb_database_sql_pool_done_impl(pool, func, priv, timeout);
+}
+tb_size_t tb_database_sql_pool_size(tb_database_sql_pool_ref_t self, tb_size_t* pidle)
+{
+    // check
+    tb_database_sql_pool_t* pool = (tb_database_sql_pool_t*)self;
+    tb_assert_and_check_return_val(pool, 0);
+
+    // get size
+    tb_spinlock_enter(&pool->lock);
+    tb_size_t count = pool->count;
+    if (pidle) *pidle = pool->idle_count;
+    tb_spinlock_leave(&pool->lock);
+
+    // ok?
+    return count;
+}
@@ -0,0 +1,174 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        pool.h
+ * @ingroup     database
+ */
+#ifndef TB_DATABASE_POOL_H
+#define TB_DATABASE_POOL_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "sql.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default idle timeout (ms) of the pooled connection
+#define TB_DATABASE_SQL_POOL_IDLE_TIMEOUT       (60000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the database sql pool ref type
+typedef __tb_typeref__(database_sql_pool);
+
+/*! the database sql pool done func type
+ *
+ * @param database                  the pulled and opened database connection
+ * @param priv                      the user private data
+ *
+ * @return                          tb_true or tb_false
+ */
+typedef tb_bool_t                   (*tb_database_sql_pool_done_func_t)(tb_database_sql_ref_t database, tb_cpointer_t priv);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the thread-safe connection pool 
+ *
+ * @param url                       the database url, see tb_database_sql_init()
+ * @param minn                      the min connection count, these connections will be opened first and never be evicted
+ * @param maxn                      the max connection count
+ * @param idle_timeout              the idle timeout (ms) of the connections over minn, 
+ *                                  -1: never evict them, 0: use TB_DATABASE_SQL_POOL_IDLE_TIMEOUT
+ *
+ * @return                          the pool 
+ */
+tb_database_sql_pool_ref_t          tb_database_sql_pool_init(tb_char_t const* url, tb_size_t minn, tb_size_t maxn, tb_long_t idle_timeout);
+
+/*! exit the pool, all connections must have been pushed back
+ *
+ * @param pool                      the pool
+ */
+tb_void_t                           tb_database_sql_pool_exit(tb_database_sql_pool_ref_t pool);
+
+/*! pull an opened connection from the pool
+ *
+ * it will open a new connection if no idle connection and the connection count does not reach maxn,
+ * otherwise wait for the pushed connection.
+ *
+ * the connection will be pinged first if it has been idle too long or it failed last time,
+ * and it will be reopened if the ping fails.
+ *
+ * @note it will block the current thread, please use tb_database_sql_pool_done() in coroutine
+ *
+ * @code
+    tb_database_sql_ref_t database = tb_database_sql_pool_pull(pool, -1);
+    if (database)
+    {
+        // done sql
+        if (tb_database_sql_done(database, "select * from table"))
+        {
+            // ...
+        }
+
+        // push it back to the pool
+        tb_database_sql_pool_push(pool, database);
+    }
+ * @endcode
+ *
+ * @param pool                      the pool
+ * @param timeout                   the timeout (ms) of waiting for the free connection, infinity: -1
+ *
+ * @return                          the database connection, tb_null if timeout or failed
+ */
+tb_database_sql_ref_t               tb_database_sql_pool_pull(tb_database_sql_pool_ref_t pool, tb_long_t timeout);
+
+/*! push the pulled connection back to the pool
+ *
+ * @param pool                      the pool
+ * @param database                  the database connection
+ */
+tb_void_t                           tb_database_sql_pool_push(tb_database_sql_pool_ref_t pool, tb_database_sql_ref_t database);
+
+/*! close all idle connections over minn which have been idle for over the idle timeout
+ *
+ * it will also be done automatically when pulling and pushing connections
+ *
+ * @param pool                      the pool
+ *
+ * @return                          the evicted connection count
+ */
+tb_size_t                           tb_database_sql_pool_evict(tb_database_sql_pool_ref_t pool);
+
+/*! done the func with a pulled connection 
+ *
+ * if it is called in a coroutine, the func will be done in the thread pool and 
+ * only the current coroutine will be suspended until it has been finished, 
+ * other coroutines in the same scheduler will continue to run.
+ * otherwise, it will be done in the current thread directly.
+ *
+ * @code
+    static tb_bool_t tb_demo_done(tb_database_sql_ref_t database, tb_cpointer_t priv)
+    {
+        // done sql, it will not block the coroutine scheduler
+        return tb_database_sql_done(database, (tb_char_t const*)priv);
+    }
+
+    // in coroutine
+    tb_database_sql_pool_done(pool, tb_demo_done, "insert into table values(1, 'name')", -1);
+ * @endcode
+ *
+ * @param pool                      the pool
+ * @param func                      the done func
+ * @param priv                      the user private data
+ * @param timeout                   the timeout (ms) of waiting for the free connection, infinity: -1
+ *
+ * @return                          the result of the func, tb_false if no connection
+ */
+tb_bool_t                           tb_database_sql_pool_done(tb_database_sql_pool_ref_t pool, tb_database_sql_pool_done_func_t func, tb_cpointer_t priv, tb_long_t timeout);
+
+/*! the connection count
+ *
+ * @param pool                      the pool
+ * @param pidle                     the idle connection count, optional
+ *
+ * @return                          the opened connection count
+ */
+tb_size_t                           tb_database_sql_pool_size(tb_database_sql_pool_ref_t pool, tb_size_t* pidle);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
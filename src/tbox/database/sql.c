@@ -198,6 +198,7 @@ tb_void_t tb_database_sql_clos(tb_database_sql_ref_t database)
     
     // closed
     impl->bopened = tb_false;
+    impl->btransaction = tb_false;
     
     // clear state
     impl->state = TB_STATE_OK;
@@ -227,7 +228,11 @@ tb_bool_t tb_database_sql_begin(tb_database_sql_ref_t database)
     tb_bool_t ok = impl->begin(impl);
 
     // save state
-    if (ok) impl->state = TB_STATE_OK;
+    if (ok) 
+    {
+        impl->state = TB_STATE_OK;
+        impl->btransaction = tb_true;
+    }
 
     // ok?
     return ok;
@@ -248,7 +253,11 @@ tb_bool_t tb_database_sql_commit(tb_database_sql_ref_t database)
     tb_bool_t ok = impl->commit(impl);
 
     // save state
-    if (ok) impl->state = TB_STATE_OK;
+    if (ok) 
+    {
+        impl->state = TB_STATE_OK;
+        impl->btransaction = tb_false;
+    }
 
     // ok?
     return ok;
@@ -268,6 +277,31 @@ tb_bool_t tb_database_sql_rollback(tb_database_sql_ref_t database)
     // rollback it
     tb_bool_t ok = impl->rollback(impl);
 
+    // save state
+    if (ok) 
+    {
+        impl->state = TB_STATE_OK;
+        impl->btransaction = tb_false;
+    }
+
+    // ok?
+    return ok;
+}
+tb_bool_t tb_database_sql_ping(tb_database_sql_ref_t database)
+{
+    // check
+    tb_database_sql_impl_t* impl = (tb_database_sql_impl_t*)database;
+    tb_assert_and_check_return_val(impl, tb_false);
+    
+    // init state
+    impl->state = TB_STATE_DATABASE_UNKNOWN_ERROR;
+        
+    // opened?
+    tb_check_return_val(impl->bopened, tb_false);
+
+    // ping it, it is alive if opened and the ping is not supported
+    tb_bool_t ok = impl->ping? impl->ping(impl) : tb_true;
+
     // save state
     if (ok) impl->state = TB_STATE_OK;
 
@@ -412,3 +446,58 @@ tb_bool_t tb_database_sql_statement_bind(tb_database_sql_ref_t database, tb_data
     // ok?
     return ok;
 }
+tb_bool_t tb_database_sql_statement_done_batch(tb_database_sql_ref_t database, tb_database_sql_statement_ref_t statement, tb_database_sql_value_t const* list, tb_size_t size, tb_size_t count)
+{
+    // check
+    tb_database_sql_impl_t* impl = (tb_database_sql_impl_t*)database;
+    tb_assert_and_check_return_val(impl && impl->statement_bind && impl->statement_done && statement && list && size, tb_false);
+
+    // init state
+    impl->state = TB_STATE_DATABASE_UNKNOWN_ERROR;
+
+    // opened?
+    tb_assert_and_check_return_val(impl->bopened, tb_false);
+
+    // not in the transaction? begin it for all rows, the rows will be written to the disk only once
+    tb_bool_t btransaction = tb_false;
+    if (impl->transaction? !impl->transaction(impl) : !impl->btransaction)
+    {
+        if (!impl->begin(impl)) return tb_false;
+        btransaction = tb_true;
+    }
+
+    // bind and done all rows
+    tb_size_t i = 0;
+    for (i = 0; i < count; i++)
+    {
+        // bind the arguments of this row
+        if (!impl->statement_bind(impl, statement, list + i * size, size)) break;
+
+        // done it
+        if (!impl->statement_done(impl, statement)) break;
+    }
+
+    // trace
+    tb_trace_d("done: batch: %lu/%lu rows: %s", i, count, i == count? "ok" : "no");
+
+    // end the transaction
+    tb_bool_t ok = (i == count)? tb_true : tb_false;
+    if (btransaction)
+    {
+        // commit all rows or rollback it
+        if (ok) ok = impl->commit(impl);
+        else 
+        {
+            // save state
+            tb_size_t state = impl->state;
+            impl->rollback(impl);
+            impl->state = state;
+        }
+    }
+
+    // save state
+    if (ok) impl->state = TB_STATE_OK;
+
+    // ok?
+    return ok;
+}
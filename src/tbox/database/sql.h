@@ -150,6 +150,14 @@ tb_bool_t                           tb_database_sql_rollback(tb_database_sql_ref
  */
 tb_size_t                           tb_database_sql_state(tb_database_sql_ref_t database);
 
+/*! ping database and check whether the connection is still alive
+ *
+ * @param database                  the database handle
+ *
+ * @return                          tb_true or tb_false
+ */
+tb_bool_t                           tb_database_sql_ping(tb_database_sql_ref_t database);
+
 /*! done database
  *
  * @code
@@ -260,7 +268,8 @@ tb_bool_t                           tb_database_sql_done(tb_database_sql_ref_t d
  * @endcode
  *
  * @param database                  the database handle
- * @param try_all                   try loading all result into memory
+ * @param try_all                   try loading all result into memory for the random access, 
+ *                                  otherwise the rows will be fetched lazily by the forward iterator
  *
  * @return                          the database result
  */
@@ -331,6 +340,41 @@ tb_bool_t                           tb_database_sql_statement_done(tb_database_s
  */
 tb_bool_t                           tb_database_sql_statement_bind(tb_database_sql_ref_t database, tb_database_sql_statement_ref_t statement, tb_database_sql_value_t const* list, tb_size_t size);
 
+/*! bind and done the database statement for multiple rows
+ *
+ * all rows will be done in one transaction if it is not in the transaction, 
+ * and it will be rollbacked if one row fails
+ *
+ * @code
+    tb_database_sql_statement_ref_t statement = tb_database_sql_statement_init(database, "insert into table values(?, ?)");
+    if (statement)
+    {
+        // bind arguments for two rows
+        tb_database_sql_value_t list[4];
+        tb_database_sql_value_set_int32(&list[0], 1);
+        tb_database_sql_value_set_text(&list[1], "name1", 0);
+        tb_database_sql_value_set_int32(&list[2], 2);
+        tb_database_sql_value_set_text(&list[3], "name2", 0);
+        if (tb_database_sql_statement_done_batch(database, statement, list, 2, 2))
+        {
+            // ...
+        }
+
+        // exit statement
+        tb_database_sql_statement_exit(database, statement);
+    }
+ * @endcode
+ *
+ * @param database                  the database handle
+ * @param statement                 the statement handle
+ * @param list                      the argument value list of all rows
+ * @param size                      the argument value count of each row
+ * @param count                     the row count
+ *
+ * @return                          tb_true or tb_false
+ */
+tb_bool_t                           tb_database_sql_statement_done_batch(tb_database_sql_ref_t database, tb_database_sql_statement_ref_t statement, tb_database_sql_value_t const* list, tb_size_t size, tb_size_t count);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -43,6 +43,7 @@
 #include "crc32.h"
 #include "fnv32.h"
 #include "fnv64.h"
+#include "xxh3.h"
 #include "murmur.h"
 #include "adler32.h"
 #include "blizzard.h"
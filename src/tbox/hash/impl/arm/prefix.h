@@ -0,0 +1,49 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        prefix.h
+ *
+ */
+#ifndef TB_HASH_IMPL_ARM_PREFIX_H
+#define TB_HASH_IMPL_ARM_PREFIX_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// enable neon, it is always available for arm64
+#if defined(TB_ARCH_ARM64) || defined(TB_ARCH_ARM_NEON)
+#   define TB_HASH_IMPL_ARM_NEON
+#   include <arm_neon.h>
+#endif
+
+// enable the armv8 sha1/sha2 crypto extension if the compiler targets it, e.g. -march=armv8-a+crypto
+#if defined(TB_ARCH_ARM64) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#   define TB_HASH_IMPL_ARM_CRYPTO
+#   include <arm_neon.h>
+#endif
+
+#endif
@@ -0,0 +1,190 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        sha.c
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+#ifdef TB_HASH_IMPL_ARM_CRYPTO
+#   define TB_HASH_IMPL_SHA_ARMV8
+
+// the sha1 rounds for the 4 message words
+#define TB_SHA_ARMV8_SHA1_ROUNDS(op, m, k) \
+    tmp = vaddq_u32(m, k); \
+    e1 = vsha1h_u32(vgetq_lane_u32(abcd, 0)); \
+    abcd = op(abcd, e0, tmp); \
+    e0 = e1
+
+// compute the next message words for sha1 
+#define TB_SHA_ARMV8_SHA1_MSG(m0, m1, m2, m3)   m0 = vsha1su1q_u32(vsha1su0q_u32(m0, m1, m2), m3)
+
+// the sha256 rounds for the 4 message words
+#define TB_SHA_ARMV8_SHA256_ROUNDS(m, i) \
+    tmp = vaddq_u32(m, vld1q_u32(g_sha_k256 + ((i) << 2))); \
+    abcd = state0; \
+    state0 = vsha256hq_u32(state0, state1, tmp); \
+    state1 = vsha256h2q_u32(state1, abcd, tmp)
+
+// compute the next message words for sha256
+#define TB_SHA_ARMV8_SHA256_MSG(m0, m1, m2, m3) m0 = vsha256su1q_u32(vsha256su0q_u32(m0, m1), m2, m3)
+
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+#ifdef TB_HASH_IMPL_SHA_ARMV8
+static tb_void_t tb_sha_impl_transform_sha1_armv8(tb_pointer_t state, tb_byte_t const* data, tb_size_t blocks)
+{
+    // the state
+    tb_uint32_t* sp = (tb_uint32_t*)state;
+
+    // the round constants
+    uint32x4_t const k0 = vdupq_n_u32(0x5a827999);
+    uint32x4_t const k1 = vdupq_n_u32(0x6ed9eba1);
+    uint32x4_t const k2 = vdupq_n_u32(0x8f1bbcdc);
+    uint32x4_t const k3 = vdupq_n_u32(0xca62c1d6);
+
+    // load state
+    uint32x4_t  abcd = vld1q_u32(sp);
+    tb_uint32_t e = sp[4];
+
+    // done
+    uint32x4_t  tmp;
+    tb_uint32_t e0;
+    tb_uint32_t e1;
+    while (blocks--)
+    {
+        // save state
+        uint32x4_t abcd_save = abcd;
+        e0 = e;
+
+        // load message
+        uint32x4_t m0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data +  0)));
+        uint32x4_t m1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16)));
+        uint32x4_t m2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 32)));
+        uint32x4_t m3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 48)));
+
+        // rounds: 0 - 19
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1cq_u32, m0, k0);  TB_SHA_ARMV8_SHA1_MSG(m0, m1, m2, m3);
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1cq_u32, m1, k0);  TB_SHA_ARMV8_SHA1_MSG(m1, m2, m3, m0);
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1cq_u32, m2, k0);  TB_SHA_ARMV8_SHA1_MSG(m2, m3, m0, m1);
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1cq_u32, m3, k0);  TB_SHA_ARMV8_SHA1_MSG(m3, m0, m1, m2);
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1cq_u32, m0, k0);  TB_SHA_ARMV8_SHA1_MSG(m0, m1, m2, m3);
+
+        // rounds: 20 - 39
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1pq_u32, m1, k1);  TB_SHA_ARMV8_SHA1_MSG(m1, m2, m3, m0);
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1pq_u32, m2, k1);  TB_SHA_ARMV8_SHA1_MSG(m2, m3, m0, m1);
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1pq_u32, m3, k1);  TB_SHA_ARMV8_SHA1_MSG(m3, m0, m1, m2);
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1pq_u32, m0, k1);  TB_SHA_ARMV8_SHA1_MSG(m0, m1, m2, m3);
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1pq_u32, m1, k1);  TB_SHA_ARMV8_SHA1_MSG(m1, m2, m3, m0);
+
+        // rounds: 40 - 59
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1mq_u32, m2, k2);  TB_SHA_ARMV8_SHA1_MSG(m2, m3, m0, m1);
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1mq_u32, m3, k2);  TB_SHA_ARMV8_SHA1_MSG(m3, m0, m1, m2);
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1mq_u32, m0, k2);  TB_SHA_ARMV8_SHA1_MSG(m0, m1, m2, m3);
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1mq_u32, m1, k2);  TB_SHA_ARMV8_SHA1_MSG(m1, m2, m3, m0);
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1mq_u32, m2, k2);  TB_SHA_ARMV8_SHA1_MSG(m2, m3, m0, m1);
+
+        // rounds: 60 - 79
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1pq_u32, m3, k3);  TB_SHA_ARMV8_SHA1_MSG(m3, m0, m1, m2);
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1pq_u32, m0, k3);
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1pq_u32, m1, k3);
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1pq_u32, m2, k3);
+        TB_SHA_ARMV8_SHA1_ROUNDS(vsha1pq_u32, m3, k3);
+
+        // update state
+        abcd = vaddq_u32(abcd, abcd_save);
+        e += e0;
+
+        // next block
+        data += 64;
+    }
+
+    // save state
+    vst1q_u32(sp, abcd);
+    sp[4] = e;
+}
+static tb_void_t tb_sha_impl_transform_sha256_armv8(tb_pointer_t state, tb_byte_t const* data, tb_size_t blocks)
+{
+    // the state
+    tb_uint32_t* sp = (tb_uint32_t*)state;
+
+    // load state
+    uint32x4_t state0 = vld1q_u32(sp);
+    uint32x4_t state1 = vld1q_u32(sp + 4);
+
+    // done
+    uint32x4_t tmp;
+    uint32x4_t abcd;
+    while (blocks--)
+    {
+        // save state
+        uint32x4_t abcd_save = state0;
+        uint32x4_t efgh_save = state1;
+
+        // load message
+        uint32x4_t m0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data +  0)));
+        uint32x4_t m1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16)));
+        uint32x4_t m2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 32)));
+        uint32x4_t m3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 48)));
+
+        // rounds: 0 - 47
+        TB_SHA_ARMV8_SHA256_ROUNDS(m0, 0);  TB_SHA_ARMV8_SHA256_MSG(m0, m1, m2, m3);
+        TB_SHA_ARMV8_SHA256_ROUNDS(m1, 1);  TB_SHA_ARMV8_SHA256_MSG(m1, m2, m3, m0);
+        TB_SHA_ARMV8_SHA256_ROUNDS(m2, 2);  TB_SHA_ARMV8_SHA256_MSG(m2, m3, m0, m1);
+        TB_SHA_ARMV8_SHA256_ROUNDS(m3, 3);  TB_SHA_ARMV8_SHA256_MSG(m3, m0, m1, m2);
+        TB_SHA_ARMV8_SHA256_ROUNDS(m0, 4);  TB_SHA_ARMV8_SHA256_MSG(m0, m1, m2, m3);
+        TB_SHA_ARMV8_SHA256_ROUNDS(m1, 5);  TB_SHA_ARMV8_SHA256_MSG(m1, m2, m3, m0);
+        TB_SHA_ARMV8_SHA256_ROUNDS(m2, 6);  TB_SHA_ARMV8_SHA256_MSG(m2, m3, m0, m1);
+        TB_SHA_ARMV8_SHA256_ROUNDS(m3, 7);  TB_SHA_ARMV8_SHA256_MSG(m3, m0, m1, m2);
+        TB_SHA_ARMV8_SHA256_ROUNDS(m0, 8);  TB_SHA_ARMV8_SHA256_MSG(m0, m1, m2, m3);
+        TB_SHA_ARMV8_SHA256_ROUNDS(m1, 9);  TB_SHA_ARMV8_SHA256_MSG(m1, m2, m3, m0);
+        TB_SHA_ARMV8_SHA256_ROUNDS(m2, 10); TB_SHA_ARMV8_SHA256_MSG(m2, m3, m0, m1);
+        TB_SHA_ARMV8_SHA256_ROUNDS(m3, 11); TB_SHA_ARMV8_SHA256_MSG(m3, m0, m1, m2);
+
+        // rounds: 48 - 63
+        TB_SHA_ARMV8_SHA256_ROUNDS(m0, 12);
+        TB_SHA_ARMV8_SHA256_ROUNDS(m1, 13);
+        TB_SHA_ARMV8_SHA256_ROUNDS(m2, 14);
+        TB_SHA_ARMV8_SHA256_ROUNDS(m3, 15);
+
+        // update state
+        state0 = vaddq_u32(state0, abcd_save);
+        state1 = vaddq_u32(state1, efgh_save);
+
+        // next block
+        data += 64;
+    }
+
+    // save state
+    vst1q_u32(sp, state0);
+    vst1q_u32(sp + 4, state1);
+}
+#endif
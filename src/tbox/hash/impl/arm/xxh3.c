@@ -0,0 +1,80 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        xxh3.c
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+#ifdef TB_HASH_IMPL_ARM_NEON
+#   define TB_HASH_IMPL_XXH3_NEON
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+#ifdef TB_HASH_IMPL_XXH3_NEON
+static tb_void_t tb_xxh3_impl_accumulate_neon(tb_uint64_t acc[8], tb_byte_t const* data, tb_byte_t const* secret, tb_size_t stripes)
+{
+    // load accumulators
+    uint64x2_t a[4];
+    tb_size_t  i = 0;
+    for (i = 0; i < 4; i++) a[i] = vld1q_u64(acc + (i << 1));
+
+    // done
+    while (stripes--)
+    {
+        for (i = 0; i < 4; i++)
+        {
+            // acc[i ^ 1] += data; acc[i] += (data ^ key).lo32 * (data ^ key).hi32
+            uint64x2_t  d   = vreinterpretq_u64_u8(vld1q_u8(data + (i << 4)));
+            uint64x2_t  dk  = veorq_u64(d, vreinterpretq_u64_u8(vld1q_u8(secret + (i << 4))));
+            uint64x2_t  p   = vmull_u32(vmovn_u64(dk), vshrn_n_u64(dk, 32));
+            a[i] = vaddq_u64(a[i], vaddq_u64(vextq_u64(d, d, 1), p));
+        }
+        data += 64;
+        secret += 8;
+    }
+
+    // save accumulators
+    for (i = 0; i < 4; i++) vst1q_u64(acc + (i << 1), a[i]);
+}
+static tb_void_t tb_xxh3_impl_scramble_neon(tb_uint64_t acc[8], tb_byte_t const* secret)
+{
+    uint32x2_t const    prime = vdup_n_u32(0x9e3779b1);
+    tb_size_t           i = 0;
+    for (i = 0; i < 4; i++)
+    {
+        // acc ^= acc >> 47; acc ^= key; acc *= prime32
+        uint64x2_t a = vld1q_u64(acc + (i << 1));
+        a = veorq_u64(veorq_u64(a, vshrq_n_u64(a, 47)), vreinterpretq_u64_u8(vld1q_u8(secret + (i << 4))));
+        uint64x2_t hi = vshlq_n_u64(vmull_u32(vshrn_n_u64(a, 32), prime), 32);
+        vst1q_u64(acc + (i << 1), vmlal_u32(hi, vmovn_u64(a), prime));
+    }
+}
+#endif
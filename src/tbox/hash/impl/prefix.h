@@ -0,0 +1,100 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        prefix.h
+ *
+ */
+#ifndef TB_HASH_IMPL_PREFIX_H
+#define TB_HASH_IMPL_PREFIX_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../prefix.h"
+#include "../../utils/bits.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the maximum lane count of the multi-buffer hash 
+#define TB_HASH_IMPL_LANE_MAXN          (8)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/* the lane type of the multi-buffer hash with 64-bytes block, e.g. md5, sha1 and sha256
+ *
+ * every lane feeds the blocks of one message, and the last one or two blocks are padded 
+ * with 0x80, zeros and the bits count of the message.
+ */
+typedef struct __tb_hash_impl_lane_t
+{
+    // the message data
+    tb_byte_t const*        data;
+
+    // the full blocks count of the message data
+    tb_size_t               full;
+
+    // the total blocks count with the padding blocks
+    tb_size_t               total;
+
+    // the current block index
+    tb_size_t               block;
+
+    // the message index
+    tb_size_t               index;
+
+    // the padding blocks
+    tb_byte_t               tail[128];
+
+}tb_hash_impl_lane_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * inlines
+ */
+static __tb_inline__ tb_void_t tb_hash_impl_lane_init(tb_hash_impl_lane_t* lane, tb_byte_t const* data, tb_size_t size, tb_size_t index, tb_bool_t bbe)
+{
+    // init lane
+    tb_size_t left  = size & 63;
+    lane->data      = data;
+    lane->full      = size >> 6;
+    lane->total     = lane->full + (left < 56? 1 : 2);
+    lane->block     = 0;
+    lane->index     = index;
+
+    // make the padding blocks
+    tb_size_t tail = (lane->total - lane->full) << 6;
+    if (left) tb_memcpy(lane->tail, data + (lane->full << 6), left);
+    lane->tail[left] = 0x80;
+    tb_memset(lane->tail + left + 1, 0, tail - left - 9);
+
+    // append the bits count 
+    if (bbe) tb_bits_set_u64_be(lane->tail + tail - 8, (tb_uint64_t)size << 3);
+    else tb_bits_set_u64_le(lane->tail + tail - 8, (tb_uint64_t)size << 3);
+}
+static __tb_inline__ tb_byte_t const* tb_hash_impl_lane_data(tb_hash_impl_lane_t* lane)
+{
+    return lane->block < lane->full? lane->data + (lane->block << 6) : lane->tail + ((lane->block - lane->full) << 6);
+}
+
+#endif
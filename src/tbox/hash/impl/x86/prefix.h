@@ -0,0 +1,99 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        prefix.h
+ *
+ */
+#ifndef TB_HASH_IMPL_x86_PREFIX_H
+#define TB_HASH_IMPL_x86_PREFIX_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/* enable the sha-ni and avx2 implementation with the function target attributes, 
+ * so we need not compile the whole library with -msha or -mavx2, 
+ * and we will check the cpu features at runtime
+ */
+#if (defined(TB_COMPILER_IS_GCC) && TB_COMPILER_VERSION_BE(5, 0)) \
+        || defined(TB_COMPILER_IS_CLANG)
+#   define TB_HASH_IMPL_x86_TARGET(x)       __attribute__((target(x)))
+#endif
+
+#ifdef TB_HASH_IMPL_x86_TARGET
+#   include <cpuid.h>
+#   include <immintrin.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * inlines
+ */
+#ifdef TB_HASH_IMPL_x86_TARGET
+static __tb_inline__ tb_bool_t tb_hash_impl_x86_cpuid(tb_uint32_t leaf, tb_uint32_t subleaf, tb_uint32_t regs[4])
+{
+    // the max leaf
+    if (__get_cpuid_max(0, tb_null) < leaf) return tb_false;
+
+    // get it
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+    return tb_true;
+}
+static __tb_inline__ tb_bool_t tb_hash_impl_x86_has_shani()
+{
+    static tb_int_t s_ok = -1;
+    if (s_ok < 0)
+    {
+        // sha-ni need ssse3 and sse4.1 too
+        tb_uint32_t regs1[4] = {0};
+        tb_uint32_t regs7[4] = {0};
+        s_ok = (    tb_hash_impl_x86_cpuid(1, 0, regs1) && tb_hash_impl_x86_cpuid(7, 0, regs7)
+                &&  (regs1[2] & (1 << 9)) && (regs1[2] & (1 << 19)) && (regs7[1] & (1 << 29)))? 1 : 0;
+    }
+    return s_ok > 0;
+}
+static __tb_inline__ tb_bool_t tb_hash_impl_x86_has_avx2()
+{
+    static tb_int_t s_ok = -1;
+    if (s_ok < 0)
+    {
+        s_ok = 0;
+        tb_uint32_t regs1[4] = {0};
+        tb_uint32_t regs7[4] = {0};
+        if (    tb_hash_impl_x86_cpuid(1, 0, regs1) && tb_hash_impl_x86_cpuid(7, 0, regs7)
+            &&  (regs1[2] & (1 << 27)) && (regs1[2] & (1 << 28)) && (regs7[1] & (1 << 5)))
+        {
+            // the os has enabled the xmm and ymm states?
+            tb_uint32_t xcr0_lo = 0;
+            tb_uint32_t xcr0_hi = 0;
+            __tb_asm__ __tb_volatile__ ("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0));
+            s_ok = (xcr0_lo & 0x6) == 0x6? 1 : 0;
+        }
+    }
+    return s_ok > 0;
+}
+#endif
+
+#endif
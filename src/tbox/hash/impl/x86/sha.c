@@ -0,0 +1,325 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        sha.c
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+#ifdef TB_HASH_IMPL_x86_TARGET
+#   define TB_HASH_IMPL_SHA_SHANI
+#   define TB_HASH_IMPL_SHA_SHA256_X8
+#endif
+
+#ifdef TB_HASH_IMPL_SHA_SHANI
+
+// the sha1 rounds for the 4 message words
+#define TB_SHA_SHANI_SHA1_ROUNDS(ea, eb, m, f) \
+    ea = _mm_sha1nexte_epu32(ea, m); \
+    eb = abcd; \
+    abcd = _mm_sha1rnds4_epu32(abcd, ea, f)
+
+// compute the next message words for sha1
+#define TB_SHA_SHANI_SHA1_MSG1(mp, mc)          mp = _mm_sha1msg1_epu32(mp, mc)
+#define TB_SHA_SHANI_SHA1_MSG2(mn, mc)          mn = _mm_sha1msg2_epu32(mn, mc)
+#define TB_SHA_SHANI_SHA1_MXOR(mn, mc)          mn = _mm_xor_si128(mn, mc)
+
+// the sha256 rounds for the 4 message words
+#define TB_SHA_SHANI_SHA256_ROUNDS(m, i) \
+    msg = _mm_add_epi32(m, _mm_loadu_si128((__m128i const*)(g_sha_k256 + ((i) << 2)))); \
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg); \
+    msg = _mm_shuffle_epi32(msg, 0x0e); \
+    state0 = _mm_sha256rnds2_epu32(state0, state1, msg)
+
+// compute the next message words for sha256
+#define TB_SHA_SHANI_SHA256_MSG1(mp, mc)        mp = _mm_sha256msg1_epu32(mp, mc)
+#define TB_SHA_SHANI_SHA256_MSG2(mn, mc, mp)    mn = _mm_sha256msg2_epu32(_mm_add_epi32(mn, _mm_alignr_epi8(mc, mp, 4)), mc)
+
+#endif
+
+#ifdef TB_HASH_IMPL_SHA_SHA256_X8
+
+// the 8-lanes operations
+#define TB_SHA_X8_ROR(x, n)                     _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+#define TB_SHA_X8_ADD(x, y)                     _mm256_add_epi32(x, y)
+#define TB_SHA_X8_XOR3(x, y, z)                 _mm256_xor_si256(_mm256_xor_si256(x, y), z)
+#define TB_SHA_X8_SIGMA0(x)                     TB_SHA_X8_XOR3(TB_SHA_X8_ROR(x, 2), TB_SHA_X8_ROR(x, 13), TB_SHA_X8_ROR(x, 22))
+#define TB_SHA_X8_SIGMA1(x)                     TB_SHA_X8_XOR3(TB_SHA_X8_ROR(x, 6), TB_SHA_X8_ROR(x, 11), TB_SHA_X8_ROR(x, 25))
+#define TB_SHA_X8_SIGMA0_(x)                    TB_SHA_X8_XOR3(TB_SHA_X8_ROR(x, 7), TB_SHA_X8_ROR(x, 18), _mm256_srli_epi32(x, 3))
+#define TB_SHA_X8_SIGMA1_(x)                    TB_SHA_X8_XOR3(TB_SHA_X8_ROR(x, 17), TB_SHA_X8_ROR(x, 19), _mm256_srli_epi32(x, 10))
+#define TB_SHA_X8_CH(x, y, z)                   _mm256_xor_si256(_mm256_and_si256(x, y), _mm256_andnot_si256(x, z))
+#define TB_SHA_X8_MAJ(x, y, z)                  _mm256_or_si256(_mm256_and_si256(x, y), _mm256_and_si256(z, _mm256_or_si256(x, y)))
+
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+#ifdef TB_HASH_IMPL_SHA_SHANI
+static __tb_inline__ tb_bool_t tb_sha_impl_shani_ok()
+{
+    return tb_hash_impl_x86_has_shani();
+}
+TB_HASH_IMPL_x86_TARGET("sha,sse4.1") static tb_void_t tb_sha_impl_transform_sha1_shani(tb_pointer_t state, tb_byte_t const* data, tb_size_t blocks)
+{
+    // the state
+    tb_uint32_t* sp = (tb_uint32_t*)state;
+
+    // the mask for converting the big-endian message words and reversing them 
+    __m128i const mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    // load state
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((__m128i const*)sp), 0x1b);
+    __m128i e0 = _mm_set_epi32((tb_int_t)sp[4], 0, 0, 0);
+    __m128i e1;
+
+    // done
+    while (blocks--)
+    {
+        // save state
+        __m128i abcd_save   = abcd;
+        __m128i e0_save     = e0;
+
+        // load message
+        __m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(data +  0)), mask);
+        __m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(data + 16)), mask);
+        __m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(data + 32)), mask);
+        __m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(data + 48)), mask);
+
+        // rounds: 0 - 3
+        e0 = _mm_add_epi32(e0, m0);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+        // rounds: 4 - 19
+        TB_SHA_SHANI_SHA1_ROUNDS(e1, e0, m1, 0);                                                        TB_SHA_SHANI_SHA1_MSG1(m0, m1);
+        TB_SHA_SHANI_SHA1_ROUNDS(e0, e1, m2, 0);                                                        TB_SHA_SHANI_SHA1_MSG1(m1, m2); TB_SHA_SHANI_SHA1_MXOR(m0, m2);
+        TB_SHA_SHANI_SHA1_ROUNDS(e1, e0, m3, 0);    TB_SHA_SHANI_SHA1_MSG2(m0, m3);     TB_SHA_SHANI_SHA1_MSG1(m2, m3); TB_SHA_SHANI_SHA1_MXOR(m1, m3);
+        TB_SHA_SHANI_SHA1_ROUNDS(e0, e1, m0, 0);    TB_SHA_SHANI_SHA1_MSG2(m1, m0);     TB_SHA_SHANI_SHA1_MSG1(m3, m0); TB_SHA_SHANI_SHA1_MXOR(m2, m0);
+
+        // rounds: 20 - 39
+        TB_SHA_SHANI_SHA1_ROUNDS(e1, e0, m1, 1);    TB_SHA_SHANI_SHA1_MSG2(m2, m1);     TB_SHA_SHANI_SHA1_MSG1(m0, m1); TB_SHA_SHANI_SHA1_MXOR(m3, m1);
+        TB_SHA_SHANI_SHA1_ROUNDS(e0, e1, m2, 1);    TB_SHA_SHANI_SHA1_MSG2(m3, m2);     TB_SHA_SHANI_SHA1_MSG1(m1, m2); TB_SHA_SHANI_SHA1_MXOR(m0, m2);
+        TB_SHA_SHANI_SHA1_ROUNDS(e1, e0, m3, 1);    TB_SHA_SHANI_SHA1_MSG2(m0, m3);     TB_SHA_SHANI_SHA1_MSG1(m2, m3); TB_SHA_SHANI_SHA1_MXOR(m1, m3);
+        TB_SHA_SHANI_SHA1_ROUNDS(e0, e1, m0, 1);    TB_SHA_SHANI_SHA1_MSG2(m1, m0);     TB_SHA_SHANI_SHA1_MSG1(m3, m0); TB_SHA_SHANI_SHA1_MXOR(m2, m0);
+        TB_SHA_SHANI_SHA1_ROUNDS(e1, e0, m1, 1);    TB_SHA_SHANI_SHA1_MSG2(m2, m1);     TB_SHA_SHANI_SHA1_MSG1(m0, m1); TB_SHA_SHANI_SHA1_MXOR(m3, m1);
+
+        // rounds: 40 - 59
+        TB_SHA_SHANI_SHA1_ROUNDS(e0, e1, m2, 2);    TB_SHA_SHANI_SHA1_MSG2(m3, m2);     TB_SHA_SHANI_SHA1_MSG1(m1, m2); TB_SHA_SHANI_SHA1_MXOR(m0, m2);
+        TB_SHA_SHANI_SHA1_ROUNDS(e1, e0, m3, 2);    TB_SHA_SHANI_SHA1_MSG2(m0, m3);     TB_SHA_SHANI_SHA1_MSG1(m2, m3); TB_SHA_SHANI_SHA1_MXOR(m1, m3);
+        TB_SHA_SHANI_SHA1_ROUNDS(e0, e1, m0, 2);    TB_SHA_SHANI_SHA1_MSG2(m1, m0);     TB_SHA_SHANI_SHA1_MSG1(m3, m0); TB_SHA_SHANI_SHA1_MXOR(m2, m0);
+        TB_SHA_SHANI_SHA1_ROUNDS(e1, e0, m1, 2);    TB_SHA_SHANI_SHA1_MSG2(m2, m1);     TB_SHA_SHANI_SHA1_MSG1(m0, m1); TB_SHA_SHANI_SHA1_MXOR(m3, m1);
+        TB_SHA_SHANI_SHA1_ROUNDS(e0, e1, m2, 2);    TB_SHA_SHANI_SHA1_MSG2(m3, m2);     TB_SHA_SHANI_SHA1_MSG1(m1, m2); TB_SHA_SHANI_SHA1_MXOR(m0, m2);
+
+        // rounds: 60 - 79
+        TB_SHA_SHANI_SHA1_ROUNDS(e1, e0, m3, 3);    TB_SHA_SHANI_SHA1_MSG2(m0, m3);     TB_SHA_SHANI_SHA1_MSG1(m2, m3); TB_SHA_SHANI_SHA1_MXOR(m1, m3);
+        TB_SHA_SHANI_SHA1_ROUNDS(e0, e1, m0, 3);    TB_SHA_SHANI_SHA1_MSG2(m1, m0);     TB_SHA_SHANI_SHA1_MSG1(m3, m0); TB_SHA_SHANI_SHA1_MXOR(m2, m0);
+        TB_SHA_SHANI_SHA1_ROUNDS(e1, e0, m1, 3);    TB_SHA_SHANI_SHA1_MSG2(m2, m1);                                     TB_SHA_SHANI_SHA1_MXOR(m3, m1);
+        TB_SHA_SHANI_SHA1_ROUNDS(e0, e1, m2, 3);    TB_SHA_SHANI_SHA1_MSG2(m3, m2);
+        TB_SHA_SHANI_SHA1_ROUNDS(e1, e0, m3, 3);
+
+        // update state
+        e0 = _mm_sha1nexte_epu32(e0, e0_save);
+        abcd = _mm_add_epi32(abcd, abcd_save);
+
+        // next block
+        data += 64;
+    }
+
+    // save state
+    _mm_storeu_si128((__m128i*)sp, _mm_shuffle_epi32(abcd, 0x1b));
+    sp[4] = (tb_uint32_t)_mm_extract_epi32(e0, 3);
+}
+TB_HASH_IMPL_x86_TARGET("sha,sse4.1") static tb_void_t tb_sha_impl_transform_sha256_shani(tb_pointer_t state, tb_byte_t const* data, tb_size_t blocks)
+{
+    // the state
+    tb_uint32_t* sp = (tb_uint32_t*)state;
+
+    // the mask for converting the big-endian message words
+    __m128i const mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // load state: abef and cdgh
+    __m128i tmp     = _mm_shuffle_epi32(_mm_loadu_si128((__m128i const*)sp), 0xb1);
+    __m128i state1  = _mm_shuffle_epi32(_mm_loadu_si128((__m128i const*)(sp + 4)), 0x1b);
+    __m128i state0  = _mm_alignr_epi8(tmp, state1, 8);
+    state1          = _mm_blend_epi16(state1, tmp, 0xf0);
+
+    // done
+    __m128i msg;
+    while (blocks--)
+    {
+        // save state
+        __m128i abef_save = state0;
+        __m128i cdgh_save = state1;
+
+        // load message
+        __m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(data +  0)), mask);
+        __m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(data + 16)), mask);
+        __m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(data + 32)), mask);
+        __m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(data + 48)), mask);
+
+        // rounds: 0 - 15
+        TB_SHA_SHANI_SHA256_ROUNDS(m0, 0);
+        TB_SHA_SHANI_SHA256_ROUNDS(m1, 1);                                              TB_SHA_SHANI_SHA256_MSG1(m0, m1);
+        TB_SHA_SHANI_SHA256_ROUNDS(m2, 2);                                              TB_SHA_SHANI_SHA256_MSG1(m1, m2);
+        TB_SHA_SHANI_SHA256_ROUNDS(m3, 3);      TB_SHA_SHANI_SHA256_MSG2(m0, m3, m2);   TB_SHA_SHANI_SHA256_MSG1(m2, m3);
+
+        // rounds: 16 - 51
+        TB_SHA_SHANI_SHA256_ROUNDS(m0, 4);      TB_SHA_SHANI_SHA256_MSG2(m1, m0, m3);   TB_SHA_SHANI_SHA256_MSG1(m3, m0);
+        TB_SHA_SHANI_SHA256_ROUNDS(m1, 5);      TB_SHA_SHANI_SHA256_MSG2(m2, m1, m0);   TB_SHA_SHANI_SHA256_MSG1(m0, m1);
+        TB_SHA_SHANI_SHA256_ROUNDS(m2, 6);      TB_SHA_SHANI_SHA256_MSG2(m3, m2, m1);   TB_SHA_SHANI_SHA256_MSG1(m1, m2);
+        TB_SHA_SHANI_SHA256_ROUNDS(m3, 7);      TB_SHA_SHANI_SHA256_MSG2(m0, m3, m2);   TB_SHA_SHANI_SHA256_MSG1(m2, m3);
+        TB_SHA_SHANI_SHA256_ROUNDS(m0, 8);      TB_SHA_SHANI_SHA256_MSG2(m1, m0, m3);   TB_SHA_SHANI_SHA256_MSG1(m3, m0);
+        TB_SHA_SHANI_SHA256_ROUNDS(m1, 9);      TB_SHA_SHANI_SHA256_MSG2(m2, m1, m0);   TB_SHA_SHANI_SHA256_MSG1(m0, m1);
+        TB_SHA_SHANI_SHA256_ROUNDS(m2, 10);     TB_SHA_SHANI_SHA256_MSG2(m3, m2, m1);   TB_SHA_SHANI_SHA256_MSG1(m1, m2);
+        TB_SHA_SHANI_SHA256_ROUNDS(m3, 11);     TB_SHA_SHANI_SHA256_MSG2(m0, m3, m2);   TB_SHA_SHANI_SHA256_MSG1(m2, m3);
+        TB_SHA_SHANI_SHA256_ROUNDS(m0, 12);     TB_SHA_SHANI_SHA256_MSG2(m1, m0, m3);   TB_SHA_SHANI_SHA256_MSG1(m3, m0);
+
+        // rounds: 52 - 63
+        TB_SHA_SHANI_SHA256_ROUNDS(m1, 13);     TB_SHA_SHANI_SHA256_MSG2(m2, m1, m0);
+        TB_SHA_SHANI_SHA256_ROUNDS(m2, 14);     TB_SHA_SHANI_SHA256_MSG2(m3, m2, m1);
+        TB_SHA_SHANI_SHA256_ROUNDS(m3, 15);
+
+        // update state
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+
+        // next block
+        data += 64;
+    }
+
+    // save state
+    tmp     = _mm_shuffle_epi32(state0, 0x1b);
+    state1  = _mm_shuffle_epi32(state1, 0xb1);
+    _mm_storeu_si128((__m128i*)sp, _mm_blend_epi16(tmp, state1, 0xf0));
+    _mm_storeu_si128((__m128i*)(sp + 4), _mm_alignr_epi8(state1, tmp, 8));
+}
+#endif
+
+#ifdef TB_HASH_IMPL_SHA_SHA256_X8
+static __tb_inline__ tb_bool_t tb_sha_impl_sha256_x8_ok()
+{
+    return tb_hash_impl_x86_has_avx2();
+}
+/* transform one block of 8 messages in the parallel lanes 
+ *
+ * @param state     the states of 8 lanes, state[word][lane]
+ * @param blocks    the block data of 8 lanes
+ */
+TB_HASH_IMPL_x86_TARGET("avx2") static tb_void_t tb_sha_impl_transform_sha256_x8(tb_uint32_t state[8][8], tb_byte_t const* blocks[8])
+{
+    // the mask for converting the big-endian message words
+    __m256i const mask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+    // load message words and transpose them, w[i] = the word i of all lanes
+    __m256i     w[16];
+    tb_size_t   i = 0;
+    tb_size_t   j = 0;
+    for (j = 0; j < 16; j += 8)
+    {
+        __m256i r0 = _mm256_loadu_si256((__m256i const*)(blocks[0] + (j << 2)));
+        __m256i r1 = _mm256_loadu_si256((__m256i const*)(blocks[1] + (j << 2)));
+        __m256i r2 = _mm256_loadu_si256((__m256i const*)(blocks[2] + (j << 2)));
+        __m256i r3 = _mm256_loadu_si256((__m256i const*)(blocks[3] + (j << 2)));
+        __m256i r4 = _mm256_loadu_si256((__m256i const*)(blocks[4] + (j << 2)));
+        __m256i r5 = _mm256_loadu_si256((__m256i const*)(blocks[5] + (j << 2)));
+        __m256i r6 = _mm256_loadu_si256((__m256i const*)(blocks[6] + (j << 2)));
+        __m256i r7 = _mm256_loadu_si256((__m256i const*)(blocks[7] + (j << 2)));
+
+        __m256i t0 = _mm256_unpacklo_epi32(r0, r1);
+        __m256i t1 = _mm256_unpackhi_epi32(r0, r1);
+        __m256i t2 = _mm256_unpacklo_epi32(r2, r3);
+        __m256i t3 = _mm256_unpackhi_epi32(r2, r3);
+        __m256i t4 = _mm256_unpacklo_epi32(r4, r5);
+        __m256i t5 = _mm256_unpackhi_epi32(r4, r5);
+        __m256i t6 = _mm256_unpacklo_epi32(r6, r7);
+        __m256i t7 = _mm256_unpackhi_epi32(r6, r7);
+
+        r0 = _mm256_unpacklo_epi64(t0, t2);
+        r1 = _mm256_unpackhi_epi64(t0, t2);
+        r2 = _mm256_unpacklo_epi64(t1, t3);
+        r3 = _mm256_unpackhi_epi64(t1, t3);
+        r4 = _mm256_unpacklo_epi64(t4, t6);
+        r5 = _mm256_unpackhi_epi64(t4, t6);
+        r6 = _mm256_unpacklo_epi64(t5, t7);
+        r7 = _mm256_unpackhi_epi64(t5, t7);
+
+        w[j + 0] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r0, r4, 0x20), mask);
+        w[j + 1] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r1, r5, 0x20), mask);
+        w[j + 2] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r2, r6, 0x20), mask);
+        w[j + 3] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r3, r7, 0x20), mask);
+        w[j + 4] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r0, r4, 0x31), mask);
+        w[j + 5] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r1, r5, 0x31), mask);
+        w[j + 6] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r2, r6, 0x31), mask);
+        w[j + 7] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r3, r7, 0x31), mask);
+    }
+
+    // load state
+    __m256i a = _mm256_loadu_si256((__m256i const*)state[0]);
+    __m256i b = _mm256_loadu_si256((__m256i const*)state[1]);
+    __m256i c = _mm256_loadu_si256((__m256i const*)state[2]);
+    __m256i d = _mm256_loadu_si256((__m256i const*)state[3]);
+    __m256i e = _mm256_loadu_si256((__m256i const*)state[4]);
+    __m256i f = _mm256_loadu_si256((__m256i const*)state[5]);
+    __m256i g = _mm256_loadu_si256((__m256i const*)state[6]);
+    __m256i h = _mm256_loadu_si256((__m256i const*)state[7]);
+
+    // done
+    for (i = 0; i < 64; i++)
+    {
+        // expand message words
+        if (i >= 16) 
+        {
+            w[i & 15] = TB_SHA_X8_ADD(TB_SHA_X8_ADD(w[i & 15], TB_SHA_X8_SIGMA0_(w[(i + 1) & 15])), 
+                                      TB_SHA_X8_ADD(w[(i + 9) & 15], TB_SHA_X8_SIGMA1_(w[(i + 14) & 15])));
+        }
+
+        // round
+        __m256i t1 = TB_SHA_X8_ADD(TB_SHA_X8_ADD(h, TB_SHA_X8_SIGMA1(e)), TB_SHA_X8_ADD(TB_SHA_X8_CH(e, f, g), TB_SHA_X8_ADD(_mm256_set1_epi32((tb_int_t)g_sha_k256[i]), w[i & 15])));
+        __m256i t2 = TB_SHA_X8_ADD(TB_SHA_X8_SIGMA0(a), TB_SHA_X8_MAJ(a, b, c));
+        h = g;
+        g = f;
+        f = e;
+        e = TB_SHA_X8_ADD(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = TB_SHA_X8_ADD(t1, t2);
+    }
+
+    // update state
+    _mm256_storeu_si256((__m256i*)state[0], TB_SHA_X8_ADD(a, _mm256_loadu_si256((__m256i const*)state[0])));
+    _mm256_storeu_si256((__m256i*)state[1], TB_SHA_X8_ADD(b, _mm256_loadu_si256((__m256i const*)state[1])));
+    _mm256_storeu_si256((__m256i*)state[2], TB_SHA_X8_ADD(c, _mm256_loadu_si256((__m256i const*)state[2])));
+    _mm256_storeu_si256((__m256i*)state[3], TB_SHA_X8_ADD(d, _mm256_loadu_si256((__m256i const*)state[3])));
+    _mm256_storeu_si256((__m256i*)state[4], TB_SHA_X8_ADD(e, _mm256_loadu_si256((__m256i const*)state[4])));
+    _mm256_storeu_si256((__m256i*)state[5], TB_SHA_X8_ADD(f, _mm256_loadu_si256((__m256i const*)state[5])));
+    _mm256_storeu_si256((__m256i*)state[6], TB_SHA_X8_ADD(g, _mm256_loadu_si256((__m256i const*)state[6])));
+    _mm256_storeu_si256((__m256i*)state[7], TB_SHA_X8_ADD(h, _mm256_loadu_si256((__m256i const*)state[7])));
+}
+#endif
@@ -0,0 +1,151 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        xxh3.c
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#ifdef TB_ARCH_SSE2
+#   include <emmintrin.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+#ifdef TB_ARCH_SSE2
+#   define TB_HASH_IMPL_XXH3_SSE2
+#endif
+#ifdef TB_HASH_IMPL_x86_TARGET
+#   define TB_HASH_IMPL_XXH3_AVX2
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+#ifdef TB_HASH_IMPL_XXH3_SSE2
+static tb_void_t tb_xxh3_impl_accumulate_sse2(tb_uint64_t acc[8], tb_byte_t const* data, tb_byte_t const* secret, tb_size_t stripes)
+{
+    // load accumulators
+    __m128i*    pacc = (__m128i*)acc;
+    __m128i     a0 = _mm_loadu_si128(pacc + 0);
+    __m128i     a1 = _mm_loadu_si128(pacc + 1);
+    __m128i     a2 = _mm_loadu_si128(pacc + 2);
+    __m128i     a3 = _mm_loadu_si128(pacc + 3);
+
+    // the accumulate step for one 16-bytes lane
+#define TB_XXH3_SSE2_STEP(a, i) \
+    do { \
+        __m128i d   = _mm_loadu_si128((__m128i const*)data + i); \
+        __m128i dk  = _mm_xor_si128(d, _mm_loadu_si128((__m128i const*)secret + i)); \
+        __m128i p   = _mm_mul_epu32(dk, _mm_shuffle_epi32(dk, _MM_SHUFFLE(0, 3, 0, 1))); \
+        a = _mm_add_epi64(a, _mm_add_epi64(_mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2)), p)); \
+    } while (0)
+
+    // done
+    while (stripes--)
+    {
+        TB_XXH3_SSE2_STEP(a0, 0);
+        TB_XXH3_SSE2_STEP(a1, 1);
+        TB_XXH3_SSE2_STEP(a2, 2);
+        TB_XXH3_SSE2_STEP(a3, 3);
+        data += 64;
+        secret += 8;
+    }
+#undef TB_XXH3_SSE2_STEP
+
+    // save accumulators
+    _mm_storeu_si128(pacc + 0, a0);
+    _mm_storeu_si128(pacc + 1, a1);
+    _mm_storeu_si128(pacc + 2, a2);
+    _mm_storeu_si128(pacc + 3, a3);
+}
+static tb_void_t tb_xxh3_impl_scramble_sse2(tb_uint64_t acc[8], tb_byte_t const* secret)
+{
+    __m128i*        pacc = (__m128i*)acc;
+    __m128i const   prime = _mm_set1_epi32((tb_int_t)0x9e3779b1);
+    tb_size_t       i = 0;
+    for (i = 0; i < 4; i++)
+    {
+        // acc ^= acc >> 47; acc ^= key; acc *= prime32
+        __m128i a = _mm_loadu_si128(pacc + i);
+        a = _mm_xor_si128(_mm_xor_si128(a, _mm_srli_epi64(a, 47)), _mm_loadu_si128((__m128i const*)secret + i));
+        __m128i lo = _mm_mul_epu32(a, prime);
+        __m128i hi = _mm_mul_epu32(_mm_shuffle_epi32(a, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+        _mm_storeu_si128(pacc + i, _mm_add_epi64(lo, _mm_slli_epi64(hi, 32)));
+    }
+}
+#endif
+
+#ifdef TB_HASH_IMPL_XXH3_AVX2
+static __tb_inline__ tb_bool_t tb_xxh3_impl_avx2_ok()
+{
+    return tb_hash_impl_x86_has_avx2();
+}
+TB_HASH_IMPL_x86_TARGET("avx2") static tb_void_t tb_xxh3_impl_accumulate_avx2(tb_uint64_t acc[8], tb_byte_t const* data, tb_byte_t const* secret, tb_size_t stripes)
+{
+    // load accumulators
+    __m256i*    pacc = (__m256i*)acc;
+    __m256i     a0 = _mm256_loadu_si256(pacc + 0);
+    __m256i     a1 = _mm256_loadu_si256(pacc + 1);
+
+    // the accumulate step for one 32-bytes lane
+#define TB_XXH3_AVX2_STEP(a, i) \
+    do { \
+        __m256i d   = _mm256_loadu_si256((__m256i const*)data + i); \
+        __m256i dk  = _mm256_xor_si256(d, _mm256_loadu_si256((__m256i const*)secret + i)); \
+        __m256i p   = _mm256_mul_epu32(dk, _mm256_srli_epi64(dk, 32)); \
+        a = _mm256_add_epi64(a, _mm256_add_epi64(_mm256_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2)), p)); \
+    } while (0)
+
+    // done
+    while (stripes--)
+    {
+        TB_XXH3_AVX2_STEP(a0, 0);
+        TB_XXH3_AVX2_STEP(a1, 1);
+        data += 64;
+        secret += 8;
+    }
+#undef TB_XXH3_AVX2_STEP
+
+    // save accumulators
+    _mm256_storeu_si256(pacc + 0, a0);
+    _mm256_storeu_si256(pacc + 1, a1);
+}
+TB_HASH_IMPL_x86_TARGET("avx2") static tb_void_t tb_xxh3_impl_scramble_avx2(tb_uint64_t acc[8], tb_byte_t const* secret)
+{
+    __m256i*        pacc = (__m256i*)acc;
+    __m256i const   prime = _mm256_set1_epi32((tb_int_t)0x9e3779b1);
+    tb_size_t       i = 0;
+    for (i = 0; i < 2; i++)
+    {
+        // acc ^= acc >> 47; acc ^= key; acc *= prime32
+        __m256i a = _mm256_loadu_si256(pacc + i);
+        a = _mm256_xor_si256(_mm256_xor_si256(a, _mm256_srli_epi64(a, 47)), _mm256_loadu_si256((__m256i const*)secret + i));
+        __m256i lo = _mm256_mul_epu32(a, prime);
+        __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+        _mm256_storeu_si256(pacc + i, _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32)));
+    }
+}
+#endif
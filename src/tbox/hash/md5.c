@@ -28,6 +28,7 @@
  * includes
  */
 #include "md5.h"
+#include "../utils/bits.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
@@ -84,6 +85,13 @@ static tb_byte_t g_md5_padding[64] =
 ,   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
 };
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * arch
+ */
+#if defined(TB_ARCH_x86) || defined(TB_ARCH_x64)
+#   include "impl/x86/md5.c"
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementaion
  */
@@ -174,6 +182,74 @@ static tb_void_t tb_md5_transform(tb_uint32_t* sp, tb_uint32_t* ip)
     sp[2] += c;
     sp[3] += d;
 }
+static __tb_inline__ tb_void_t tb_md5_transform_block(tb_uint32_t* sp, tb_byte_t const* data)
+{
+    // decode the little-endian words
+    tb_uint32_t ip[16];
+    tb_size_t   i = 0;
+    for (i = 0; i < 16; i++) ip[i] = tb_bits_get_u32_le(data + (i << 2));
+
+    // transform it
+    tb_md5_transform(sp, ip);
+}
+#ifdef TB_HASH_IMPL_MD5_X8
+static tb_void_t tb_md5_make_multi_x8(tb_byte_t const** ibs, tb_size_t const* ins, tb_byte_t** obs, tb_size_t count)
+{
+    // init lanes
+    tb_size_t               i = 0;
+    tb_size_t               k = 0;
+    tb_size_t               next = 0;
+    tb_size_t               active = 0;
+    tb_uint32_t             state[4][TB_HASH_IMPL_LANE_MAXN];
+    tb_byte_t const*        blocks[TB_HASH_IMPL_LANE_MAXN];
+    tb_hash_impl_lane_t     lanes[TB_HASH_IMPL_LANE_MAXN];
+    tb_uint32_t const       iv[4] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+    for (i = 0; i < TB_HASH_IMPL_LANE_MAXN; i++)
+    {
+        tb_hash_impl_lane_t* lane = &lanes[i];
+        if (next < count)
+        {
+            for (k = 0; k < 4; k++) state[k][i] = iv[k];
+            tb_hash_impl_lane_init(lane, ibs[next], ins[next], next, tb_false);
+            next++;
+            active++;
+        }
+        else lane->block = lane->total = 0;
+    }
+
+    // done
+    while (active)
+    {
+        // the block data of all lanes, the idle lanes only compute some trash data 
+        for (i = 0; i < TB_HASH_IMPL_LANE_MAXN; i++)
+            blocks[i] = lanes[i].block < lanes[i].total? tb_hash_impl_lane_data(&lanes[i]) : lanes[i].tail;
+
+        // transform one block for all lanes
+        tb_md5_impl_transform_x8(state, blocks);
+
+        // update lanes
+        for (i = 0; i < TB_HASH_IMPL_LANE_MAXN; i++)
+        {
+            // this lane is idle or not finished?
+            tb_hash_impl_lane_t* lane = &lanes[i];
+            if (lane->block >= lane->total || ++lane->block < lane->total) continue;
+
+            // save digest
+            for (k = 0; k < 4; k++) tb_bits_set_u32_le(obs[lane->index] + (k << 2), state[k][i]);
+            active--;
+
+            // feed the next message
+            if (next < count)
+            {
+                for (k = 0; k < 4; k++) state[k][i] = iv[k];
+                tb_hash_impl_lane_init(lane, ibs[next], ins[next], next, tb_false);
+                next++;
+                active++;
+            }
+        }
+    }
+}
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -200,12 +276,8 @@ tb_void_t tb_md5_spak(tb_md5_t* md5, tb_byte_t const* data, tb_size_t size)
     // check
     tb_assert_and_check_return(md5 && data);
 
-    // init
-    tb_uint32_t ip[16];
-    tb_size_t   i = 0, ii = 0;
-
     // compute number of bytes mod 64
-    tb_int_t mdi = (tb_int_t)((md5->i[0] >> 3) & 0x3F);
+    tb_size_t mdi = (tb_size_t)((md5->i[0] >> 3) & 0x3F);
 
     // update number of bits
     if ((md5->i[0] + ((tb_uint32_t)size << 3)) < md5->i[0]) md5->i[1]++;
@@ -213,26 +285,28 @@ tb_void_t tb_md5_spak(tb_md5_t* md5, tb_byte_t const* data, tb_size_t size)
     md5->i[0] += ((tb_uint32_t)size << 3);
     md5->i[1] += ((tb_uint32_t)size >> 29);
 
-    while (size--)
+    // fill the left buffer data first
+    if (mdi)
     {
-        // add new character to buffer, increment mdi
-        md5->ip[mdi++] = *data++;
-
-        // transform if necessary 
-        if (mdi == 0x40)
-        {
-            for (i = 0, ii = 0; i < 16; i++, ii += 4)
-            {
-                ip[i] =     (((tb_uint32_t)md5->ip[ii + 3]) << 24)
-                        |   (((tb_uint32_t)md5->ip[ii + 2]) << 16)
-                        |   (((tb_uint32_t)md5->ip[ii + 1]) << 8)
-                        |   ((tb_uint32_t)md5->ip[ii]);
-            }
+        tb_size_t n = tb_min(64 - mdi, size);
+        tb_memcpy(md5->ip + mdi, data, n);
+        data += n;
+        size -= n;
+        mdi += n;
+        if (mdi < 64) return ;
+        tb_md5_transform_block(md5->sp, md5->ip);
+    }
 
-            tb_md5_transform(md5->sp, ip);
-            mdi = 0;
-        }
+    // transform all full blocks directly
+    while (size >= 64)
+    {
+        tb_md5_transform_block(md5->sp, data);
+        data += 64;
+        size -= 64;
     }
+
+    // save the left data
+    if (size) tb_memcpy(md5->ip, data, size);
 }
 
 tb_void_t tb_md5_exit(tb_md5_t* md5, tb_byte_t* data, tb_size_t size)
@@ -299,4 +373,27 @@ tb_size_t tb_md5_make(tb_byte_t const* ib, tb_size_t in, tb_byte_t* ob, tb_size_
     // ok
     return 16;
 }
+tb_void_t tb_md5_make_multi(tb_byte_t const** ibs, tb_size_t const* ins, tb_byte_t** obs, tb_size_t count)
+{
+    // check
+    tb_assert_and_check_return(ibs && ins && obs && count);
 
+#ifdef TB_HASH_IMPL_MD5_X8
+    // make them in the parallel lanes
+    if (count > 1 && tb_md5_impl_x8_ok())
+    {
+        tb_md5_make_multi_x8(ibs, ins, obs, count);
+        return ;
+    }
+#endif
+
+    // make them one by one
+    tb_size_t i = 0;
+    for (i = 0; i < count; i++)
+    {
+        tb_md5_t md5;
+        tb_md5_init(&md5, 0);
+        if (ins[i]) tb_md5_spak(&md5, ibs[i], ins[i]);
+        tb_md5_exit(&md5, obs[i], 16);
+    }
+}
@@ -88,6 +88,18 @@ tb_void_t               tb_md5_spak(tb_md5_t* md5, tb_byte_t const* data, tb_siz
  */
 tb_size_t               tb_md5_make(tb_byte_t const* ib, tb_size_t in, tb_byte_t* ob, tb_size_t on);
 
+/*! make md5 for multiple messages 
+ *
+ * the messages will be hashed in the parallel lanes if the cpu supports it (e.g. avx2),
+ * it is faster than calling tb_md5_make() for each message if there are many small messages.
+ *
+ * @param ibs           the input data list
+ * @param ins           the input size list
+ * @param obs           the output data list, the size of each output data must be not less than 16 bytes
+ * @param count         the message count
+ */
+tb_void_t               tb_md5_make_multi(tb_byte_t const** ibs, tb_size_t const* ins, tb_byte_t** obs, tb_size_t count);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -73,6 +73,22 @@
     T1 = TB_SHA_BLK_(i); \
     TB_SHA_ROUND256(a,b,c,d,e,f,g,h)
 
+// ror64
+#define TB_SHA_ROR64(v, b)              (((v) >> (b)) | ((v) << (64 - (b))))
+
+// the sha512 operations
+#define TB_SHA_SIGMA0_512(x)            (TB_SHA_ROR64((x), 28) ^ TB_SHA_ROR64((x), 34) ^ TB_SHA_ROR64((x), 39))
+#define TB_SHA_SIGMA1_512(x)            (TB_SHA_ROR64((x), 14) ^ TB_SHA_ROR64((x), 18) ^ TB_SHA_ROR64((x), 41))
+#define TB_SHA_SIGMA0_512_(x)           (TB_SHA_ROR64((x),  1) ^ TB_SHA_ROR64((x),  8) ^ ((x) >> 7))
+#define TB_SHA_SIGMA1_512_(x)           (TB_SHA_ROR64((x), 19) ^ TB_SHA_ROR64((x), 61) ^ ((x) >> 6))
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the sha transform func type
+typedef tb_void_t                       (*tb_sha_transform_func_t)(tb_pointer_t state, tb_byte_t const* data, tb_size_t blocks);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * globals
  */
@@ -95,11 +111,43 @@ static tb_uint32_t const g_sha_k256[64] =
     0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
     0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
 };
+static tb_uint64_t const g_sha_k512[80] = 
+{
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+    0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+    0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+    0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+    0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+    0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+    0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+    0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+    0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+    0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+    0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+    0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+};
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * arch
+ */
+#if defined(TB_ARCH_x86) || defined(TB_ARCH_x64)
+#   include "impl/x86/sha.c"
+#elif defined(TB_ARCH_ARM)
+#   include "impl/arm/sha.c"
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
-static tb_void_t tb_sha_transform_sha1(tb_uint32_t state[5], tb_byte_t const buffer[64])
+static tb_void_t tb_sha_transform_sha1_block(tb_uint32_t state[5], tb_byte_t const buffer[64])
 {
     // init 
     tb_uint32_t block[80];
@@ -190,7 +238,7 @@ static tb_void_t tb_sha_transform_sha1(tb_uint32_t state[5], tb_byte_t const buf
     state[4] += e;
 }
 
-static tb_void_t tb_sha_transform_sha2(tb_uint32_t* state, tb_byte_t const buffer[64])
+static tb_void_t tb_sha_transform_sha2_block(tb_uint32_t* state, tb_byte_t const buffer[64])
 {
     // init
     tb_uint32_t T1;
@@ -264,6 +312,155 @@ static tb_void_t tb_sha_transform_sha2(tb_uint32_t* state, tb_byte_t const buffe
     state[6] += g;
     state[7] += h;
 }
+static tb_void_t tb_sha_transform_sha1(tb_pointer_t state, tb_byte_t const* data, tb_size_t blocks)
+{
+    while (blocks--)
+    {
+        tb_sha_transform_sha1_block((tb_uint32_t*)state, data);
+        data += 64;
+    }
+}
+static tb_void_t tb_sha_transform_sha2(tb_pointer_t state, tb_byte_t const* data, tb_size_t blocks)
+{
+    while (blocks--)
+    {
+        tb_sha_transform_sha2_block((tb_uint32_t*)state, data);
+        data += 64;
+    }
+}
+static tb_void_t tb_sha_transform_sha512(tb_pointer_t state, tb_byte_t const* data, tb_size_t blocks)
+{
+    // the state
+    tb_uint64_t* sp = (tb_uint64_t*)state;
+
+    // done
+    tb_uint64_t w[80];
+    while (blocks--)
+    {
+        // init message words
+        tb_size_t i = 0;
+        for (i = 0; i < 16; i++) w[i] = tb_bits_get_u64_be(data + (i << 3));
+        for (; i < 80; i++) w[i] = TB_SHA_SIGMA1_512_(w[i - 2]) + w[i - 7] + TB_SHA_SIGMA0_512_(w[i - 15]) + w[i - 16];
+
+        // init state
+        tb_uint64_t a = sp[0];
+        tb_uint64_t b = sp[1];
+        tb_uint64_t c = sp[2];
+        tb_uint64_t d = sp[3];
+        tb_uint64_t e = sp[4];
+        tb_uint64_t f = sp[5];
+        tb_uint64_t g = sp[6];
+        tb_uint64_t h = sp[7];
+
+        // done
+        for (i = 0; i < 80; i++)
+        {
+            tb_uint64_t t1 = h + TB_SHA_SIGMA1_512(e) + TB_SHA_CH(e, f, g) + g_sha_k512[i] + w[i];
+            tb_uint64_t t2 = TB_SHA_SIGMA0_512(a) + TB_SHA_MAJ(a, b, c);
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        // update state
+        sp[0] += a;
+        sp[1] += b;
+        sp[2] += c;
+        sp[3] += d;
+        sp[4] += e;
+        sp[5] += f;
+        sp[6] += g;
+        sp[7] += h;
+
+        // next block
+        data += 128;
+    }
+}
+static tb_sha_transform_func_t tb_sha_transform_sha1_func()
+{
+#if defined(TB_HASH_IMPL_SHA_SHANI)
+    if (tb_sha_impl_shani_ok()) return tb_sha_impl_transform_sha1_shani;
+#elif defined(TB_HASH_IMPL_SHA_ARMV8)
+    return tb_sha_impl_transform_sha1_armv8;
+#endif
+    return tb_sha_transform_sha1;
+}
+static tb_sha_transform_func_t tb_sha_transform_sha2_func()
+{
+#if defined(TB_HASH_IMPL_SHA_SHANI)
+    if (tb_sha_impl_shani_ok()) return tb_sha_impl_transform_sha256_shani;
+#elif defined(TB_HASH_IMPL_SHA_ARMV8)
+    return tb_sha_impl_transform_sha256_armv8;
+#endif
+    return tb_sha_transform_sha2;
+}
+#ifdef TB_HASH_IMPL_SHA_SHA256_X8
+static tb_void_t tb_sha_make_multi_sha256_x8(tb_size_t mode, tb_byte_t const** ibs, tb_size_t const* ins, tb_byte_t** obs, tb_size_t count)
+{
+    // the initial state
+    tb_sha_t sha;
+    tb_sha_init(&sha, mode);
+
+    // init lanes
+    tb_size_t               i = 0;
+    tb_size_t               next = 0;
+    tb_size_t               active = 0;
+    tb_uint32_t             state[8][TB_HASH_IMPL_LANE_MAXN];
+    tb_byte_t const*        blocks[TB_HASH_IMPL_LANE_MAXN];
+    tb_hash_impl_lane_t     lanes[TB_HASH_IMPL_LANE_MAXN];
+    for (i = 0; i < TB_HASH_IMPL_LANE_MAXN; i++)
+    {
+        tb_hash_impl_lane_t* lane = &lanes[i];
+        if (next < count) 
+        {
+            tb_size_t k = 0;
+            for (k = 0; k < 8; k++) state[k][i] = sha.state[k];
+            tb_hash_impl_lane_init(lane, ibs[next], ins[next], next, tb_true);
+            next++;
+            active++;
+        }
+        else lane->block = lane->total = 0;
+    }
+
+    // done
+    while (active)
+    {
+        // the block data of all lanes, the idle lanes only compute some trash data 
+        for (i = 0; i < TB_HASH_IMPL_LANE_MAXN; i++)
+            blocks[i] = lanes[i].block < lanes[i].total? tb_hash_impl_lane_data(&lanes[i]) : lanes[i].tail;
+
+        // transform one block for all lanes
+        tb_sha_impl_transform_sha256_x8(state, blocks);
+
+        // update lanes
+        for (i = 0; i < TB_HASH_IMPL_LANE_MAXN; i++)
+        {
+            // this lane is idle or not finished?
+            tb_hash_impl_lane_t* lane = &lanes[i];
+            if (lane->block >= lane->total || ++lane->block < lane->total) continue;
+
+            // save digest
+            tb_size_t k = 0;
+            for (k = 0; k < sha.digest_len; k++) tb_bits_set_u32_be(obs[lane->index] + (k << 2), state[k][i]);
+            active--;
+
+            // feed the next message
+            if (next < count)
+            {
+                for (k = 0; k < 8; k++) state[k][i] = sha.state[k];
+                tb_hash_impl_lane_init(lane, ibs[next], ins[next], next, tb_true);
+                next++;
+                active++;
+            }
+        }
+    }
+}
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -278,6 +475,7 @@ tb_void_t tb_sha_init(tb_sha_t* sha, tb_size_t mode)
 
     // done
     sha->digest_len = (mode >> 5) & 0xff;
+    sha->block_size = 64;
     switch (mode) 
     {
     case TB_SHA_MODE_SHA1_160:
@@ -286,7 +484,7 @@ tb_void_t tb_sha_init(tb_sha_t* sha, tb_size_t mode)
         sha->state[2] = 0x98badcfe;
         sha->state[3] = 0x10325476;
         sha->state[4] = 0xc3d2e1f0;
-        sha->transform = tb_sha_transform_sha1;
+        sha->transform = tb_sha_transform_sha1_func();
         break;
     case TB_SHA_MODE_SHA2_224:
         sha->state[0] = 0xc1059ed8;
@@ -297,7 +495,7 @@ tb_void_t tb_sha_init(tb_sha_t* sha, tb_size_t mode)
         sha->state[5] = 0x68581511;
         sha->state[6] = 0x64f98fa7;
         sha->state[7] = 0xbefa4fa4;
-        sha->transform = tb_sha_transform_sha2;
+        sha->transform = tb_sha_transform_sha2_func();
         break;
     case TB_SHA_MODE_SHA2_256: 
         sha->state[0] = 0x6a09e667;
@@ -308,7 +506,31 @@ tb_void_t tb_sha_init(tb_sha_t* sha, tb_size_t mode)
         sha->state[5] = 0x9b05688c;
         sha->state[6] = 0x1f83d9ab;
         sha->state[7] = 0x5be0cd19;
-        sha->transform = tb_sha_transform_sha2;
+        sha->transform = tb_sha_transform_sha2_func();
+        break;
+    case TB_SHA_MODE_SHA2_384: 
+        sha->state64[0] = 0xcbbb9d5dc1059ed8ULL;
+        sha->state64[1] = 0x629a292a367cd507ULL;
+        sha->state64[2] = 0x9159015a3070dd17ULL;
+        sha->state64[3] = 0x152fecd8f70e5939ULL;
+        sha->state64[4] = 0x67332667ffc00b31ULL;
+        sha->state64[5] = 0x8eb44a8768581511ULL;
+        sha->state64[6] = 0xdb0c2e0d64f98fa7ULL;
+        sha->state64[7] = 0x47b5481dbefa4fa4ULL;
+        sha->block_size = 128;
+        sha->transform = tb_sha_transform_sha512;
+        break;
+    case TB_SHA_MODE_SHA2_512: 
+        sha->state64[0] = 0x6a09e667f3bcc908ULL;
+        sha->state64[1] = 0xbb67ae8584caa73bULL;
+        sha->state64[2] = 0x3c6ef372fe94f82bULL;
+        sha->state64[3] = 0xa54ff53a5f1d36f1ULL;
+        sha->state64[4] = 0x510e527fade682d1ULL;
+        sha->state64[5] = 0x9b05688c2b3e6c1fULL;
+        sha->state64[6] = 0x1f83d9abfb41bd6bULL;
+        sha->state64[7] = 0x5be0cd19137e2179ULL;
+        sha->block_size = 128;
+        sha->transform = tb_sha_transform_sha512;
         break;
     default:
         tb_assert(0);
@@ -321,52 +543,82 @@ tb_void_t tb_sha_exit(tb_sha_t* sha, tb_byte_t* data, tb_size_t size)
     // check
     tb_assert_and_check_return(sha && data);
 
-    // the count
-    tb_hize_t count = tb_bits_be_to_ne_u64(sha->count << 3);
-
-    // spak 
-    tb_sha_spak(sha, (tb_byte_t const*)"\200", 1);
-    while ((sha->count & 63) != 56) tb_sha_spak(sha, (tb_byte_t const*)"", 1);
-    tb_sha_spak(sha, (tb_byte_t*)&count, 8);
+    /* pad out to (block_size - length_size) mod block_size and append the bits count, 
+     * the bits count is 64-bits for sha1/sha2-256 and 128-bits for sha2-512
+     */
+    tb_byte_t pad[256];
+    tb_size_t block = sha->block_size;
+    tb_size_t lsize = block >> 3;
+    tb_size_t used  = (tb_size_t)(sha->count & (block - 1));
+    tb_size_t padn  = used < block - lsize? block - lsize - used : (block << 1) - lsize - used;
+    pad[0] = 0x80;
+    tb_memset(pad + 1, 0, padn + lsize - 9);
+    if (lsize > 8) tb_bits_set_u64_be(pad + padn, (tb_uint64_t)(sha->count >> 61));
+    tb_bits_set_u64_be(pad + padn + lsize - 8, (tb_uint64_t)(sha->count << 3));
+    tb_sha_spak(sha, pad, padn + lsize);
 
     // done
     tb_uint32_t i = 0;
     tb_uint32_t n = sha->digest_len;
     tb_assert((n << 2) <= size);
-    for (i = 0; i < n; i++) tb_bits_set_u32_be(data + (i << 2), sha->state[i]);
+    if (block == 128)
+    {
+        for (i = 0; i < (n >> 1); i++) tb_bits_set_u64_be(data + (i << 3), sha->state64[i]);
+    }
+    else
+    {
+        for (i = 0; i < n; i++) tb_bits_set_u32_be(data + (i << 2), sha->state[i]);
+    }
 }
 tb_void_t tb_sha_spak(tb_sha_t* sha, tb_byte_t const* data, tb_size_t size)
 {
     // check
     tb_assert_and_check_return(sha && data);
 
+    // the state
+    tb_size_t       block = sha->block_size;
+    tb_pointer_t    state = block == 128? (tb_pointer_t)sha->state64 : (tb_pointer_t)sha->state;
+
     // update count
-    tb_uint32_t j = (tb_uint32_t)sha->count & 63;
+    tb_size_t j = (tb_size_t)sha->count & (block - 1);
     sha->count += size;
 
     // done
-    tb_uint32_t i;
 #ifdef __tb_small__
+    tb_size_t i;
     for (i = 0; i < size; i++) 
     {
         sha->buffer[j++] = data[i];
-        if (64 == j) 
+        if (block == j) 
         {
-            sha->transform(sha->state, sha->buffer);
+            sha->transform(state, sha->buffer, 1);
             j = 0;
         }
     }
 #else
-    if ((j + size) > 63)
+    // fill the left buffer data first
+    if (j)
+    {
+        tb_size_t n = tb_min(block - j, size);
+        tb_memcpy(&sha->buffer[j], data, n);
+        data += n;
+        size -= n;
+        j += n;
+        if (j < block) return ;
+        sha->transform(state, sha->buffer, 1);
+    }
+
+    // transform all full blocks directly
+    if (size >= block)
     {
-        tb_memcpy(&sha->buffer[j], data, (i = 64 - j));
-        sha->transform(sha->state, sha->buffer);
-        for (; i + 63 < size; i += 64)
-            sha->transform(sha->state, &data[i]);
-        j = 0;
-    } 
-    else i = 0;
-    tb_memcpy(&sha->buffer[j], &data[i], size - i);
+        tb_size_t n = size / block;
+        sha->transform(state, data, n);
+        data += n * block;
+        size -= n * block;
+    }
+
+    // save the left data
+    if (size) tb_memcpy(sha->buffer, data, size);
 #endif
 }
 tb_size_t tb_sha_make(tb_size_t mode, tb_byte_t const* ib, tb_size_t in, tb_byte_t* ob, tb_size_t on)
@@ -387,4 +639,37 @@ tb_size_t tb_sha_make(tb_size_t mode, tb_byte_t const* ib, tb_size_t in, tb_byte
     // ok?
     return (sha.digest_len << 2);
 }
+tb_size_t tb_sha_make_multi(tb_size_t mode, tb_byte_t const** ibs, tb_size_t const* ins, tb_byte_t** obs, tb_size_t on, tb_size_t count)
+{
+    // check
+    tb_assert_and_check_return_val(ibs && ins && obs && count, 0);
+
+    // the digest size
+    tb_size_t digest_size = (mode >> 5) << 2;
+    tb_assert_and_check_return_val(on >= digest_size, 0);
+
+#ifdef TB_HASH_IMPL_SHA_SHA256_X8
+    /* make sha256 in the parallel lanes, 
+     * but we need not use it if sha-ni is supported, because it is fast enough
+     */
+    if (    (mode == TB_SHA_MODE_SHA2_256 || mode == TB_SHA_MODE_SHA2_224) 
+        &&  count > 1 && tb_sha_impl_sha256_x8_ok() && !tb_sha_impl_shani_ok())
+    {
+        tb_sha_make_multi_sha256_x8(mode, ibs, ins, obs, count);
+        return digest_size;
+    }
+#endif
 
+    // make them one by one
+    tb_size_t i = 0;
+    for (i = 0; i < count; i++)
+    {
+        tb_sha_t sha;
+        tb_sha_init(&sha, mode);
+        if (ins[i]) tb_sha_spak(&sha, ibs[i], ins[i]);
+        tb_sha_exit(&sha, obs[i], on);
+    }
+
+    // ok
+    return digest_size;
+}
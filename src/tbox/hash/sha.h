@@ -44,10 +44,12 @@ __tb_extern_c_enter__
 typedef struct __tb_sha_t
 {
     tb_uint8_t      digest_len;  //!< digest length in 32-bit words
+    tb_uint8_t      block_size;  //!< block size in bytes, 64 for sha1/sha224/sha256 and 128 for sha384/sha512
     tb_hize_t       count;       //!< number of bytes in buffer
-    tb_uint8_t      buffer[64];  //!< 512-bit buffer of input values used in hash updating
+    tb_uint8_t      buffer[128]; //!< 512-bit (1024-bit for sha384/sha512) buffer of input values used in hash updating
     tb_uint32_t     state[8];    //!< current hash value
-    tb_void_t       (*transform)(tb_uint32_t *state, tb_uint8_t const buffer[64]);
+    tb_uint64_t     state64[8];  //!< current hash value for sha384/sha512
+    tb_void_t       (*transform)(tb_pointer_t state, tb_uint8_t const* data, tb_size_t blocks);
 
 }tb_sha_t;
 
@@ -57,6 +59,8 @@ typedef enum __tb_sha_mode_t
     TB_SHA_MODE_SHA1_160 = 160
 ,   TB_SHA_MODE_SHA2_224 = 224
 ,   TB_SHA_MODE_SHA2_256 = 256
+,   TB_SHA_MODE_SHA2_384 = 384
+,   TB_SHA_MODE_SHA2_512 = 512
 
 }tb_sha_mode_t;
 
@@ -98,6 +102,30 @@ tb_void_t               tb_sha_spak(tb_sha_t* sha, tb_byte_t const* data, tb_siz
  */
 tb_size_t               tb_sha_make(tb_size_t mode, tb_byte_t const* ib, tb_size_t ip, tb_byte_t* ob, tb_size_t on);
 
+/*! make sha for multiple messages 
+ *
+ * the messages will be hashed in the parallel lanes if the cpu supports it (e.g. avx2 for sha256),
+ * it is faster than calling tb_sha_make() for each message if there are many small messages.
+ *
+ * @code
+    tb_byte_t const*    ibs[] = {data1, data2, data3};
+    tb_size_t           ins[] = {size1, size2, size3};
+    tb_byte_t           digests[3][32];
+    tb_byte_t*          obs[] = {digests[0], digests[1], digests[2]};
+    tb_sha_make_multi(TB_SHA_MODE_SHA2_256, ibs, ins, obs, 32, 3);
+ * @endcode
+ *
+ * @param mode          the mode
+ * @param ibs           the input data list
+ * @param ins           the input size list
+ * @param obs           the output data list
+ * @param on            the output size of each output data
+ * @param count         the message count
+ *
+ * @return              the real size of each digest
+ */
+tb_size_t               tb_sha_make_multi(tb_size_t mode, tb_byte_t const** ibs, tb_size_t const* ins, tb_byte_t** obs, tb_size_t on, tb_size_t count);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -0,0 +1,633 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        xxh3.c
+ * @ingroup     hash
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "xxh3.h"
+#include "../utils/bits.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the primes
+#define TB_XXH3_PRIME32_1           (0x9e3779b1U)
+#define TB_XXH3_PRIME32_2           (0x85ebca77U)
+#define TB_XXH3_PRIME32_3           (0xc2b2ae3dU)
+#define TB_XXH3_PRIME64_1           (0x9e3779b185ebca87ULL)
+#define TB_XXH3_PRIME64_2           (0xc2b2ae3d27d4eb4fULL)
+#define TB_XXH3_PRIME64_3           (0x165667b19e3779f9ULL)
+#define TB_XXH3_PRIME64_4           (0x85ebca77c2b2ae63ULL)
+#define TB_XXH3_PRIME64_5           (0x27d4eb2f165667c5ULL)
+#define TB_XXH3_PRIME_MX1           (0x165667919e3779f9ULL)
+#define TB_XXH3_PRIME_MX2           (0x9fb21c651e98df25ULL)
+
+// the secret size
+#define TB_XXH3_SECRET_SIZE         (192)
+
+// the stripe size
+#define TB_XXH3_STRIPE_SIZE         (64)
+
+// the stripes count of one block: (secret_size - stripe_size) / 8
+#define TB_XXH3_BLOCK_STRIPES       ((TB_XXH3_SECRET_SIZE - TB_XXH3_STRIPE_SIZE) >> 3)
+
+// the block size
+#define TB_XXH3_BLOCK_SIZE          (TB_XXH3_BLOCK_STRIPES * TB_XXH3_STRIPE_SIZE)
+
+// the maximum size of the short and middle input
+#define TB_XXH3_MIDSIZE_MAX         (240)
+
+// read integer
+#define TB_XXH3_R32(p)              ((tb_uint64_t)tb_bits_get_u32_le(p))
+#define TB_XXH3_R64(p)              tb_bits_get_u64_le(p)
+
+// rotate left
+#define TB_XXH3_ROTL32(x, b)        (((x) << (b)) | ((x) >> (32 - (b))))
+#define TB_XXH3_ROTL64(x, b)        (((x) << (b)) | ((x) >> (64 - (b))))
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the accumulate func type
+typedef tb_void_t                   (*tb_xxh3_accumulate_func_t)(tb_uint64_t acc[8], tb_byte_t const* data, tb_byte_t const* secret, tb_size_t stripes);
+
+// the scramble func type
+typedef tb_void_t                   (*tb_xxh3_scramble_func_t)(tb_uint64_t acc[8], tb_byte_t const* secret);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the default secret
+static tb_byte_t const g_xxh3_secret[TB_XXH3_SECRET_SIZE] = 
+{
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c
+,   0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f
+,   0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21
+,   0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c
+,   0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3
+,   0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8
+,   0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d
+,   0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64
+,   0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb
+,   0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e
+,   0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce
+,   0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e
+};
+
+// the initial accumulators
+static tb_uint64_t const g_xxh3_acc_init[8] = 
+{
+    TB_XXH3_PRIME32_3
+,   TB_XXH3_PRIME64_1
+,   TB_XXH3_PRIME64_2
+,   TB_XXH3_PRIME64_3
+,   TB_XXH3_PRIME64_4
+,   TB_XXH3_PRIME32_2
+,   TB_XXH3_PRIME64_5
+,   TB_XXH3_PRIME32_1
+};
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * arch
+ */
+#if defined(TB_ARCH_x86) || defined(TB_ARCH_x64)
+#   include "impl/x86/xxh3.c"
+#elif defined(TB_ARCH_ARM)
+#   include "impl/arm/xxh3.c"
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static __tb_inline__ tb_uint64_t tb_xxh3_mul128(tb_uint64_t a, tb_uint64_t b, tb_uint64_t* phigh)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)a * b;
+    *phigh = (tb_uint64_t)(r >> 64);
+    return (tb_uint64_t)r;
+#else
+    tb_uint64_t lo_lo = (a & 0xffffffff) * (b & 0xffffffff);
+    tb_uint64_t hi_lo = (a >> 32) * (b & 0xffffffff);
+    tb_uint64_t lo_hi = (a & 0xffffffff) * (b >> 32);
+    tb_uint64_t hi_hi = (a >> 32) * (b >> 32);
+    tb_uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi;
+    *phigh = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    return (cross << 32) | (lo_lo & 0xffffffff);
+#endif
+}
+static __tb_inline__ tb_uint64_t tb_xxh3_mul128_fold64(tb_uint64_t a, tb_uint64_t b)
+{
+    tb_uint64_t high;
+    tb_uint64_t low = tb_xxh3_mul128(a, b, &high);
+    return low ^ high;
+}
+static __tb_inline__ tb_uint64_t tb_xxh3_xxh64_avalanche(tb_uint64_t h)
+{
+    h ^= h >> 33;
+    h *= TB_XXH3_PRIME64_2;
+    h ^= h >> 29;
+    h *= TB_XXH3_PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+static __tb_inline__ tb_uint64_t tb_xxh3_avalanche(tb_uint64_t h)
+{
+    h ^= h >> 37;
+    h *= TB_XXH3_PRIME_MX1;
+    h ^= h >> 32;
+    return h;
+}
+static __tb_inline__ tb_uint64_t tb_xxh3_rrmxmx(tb_uint64_t h, tb_uint64_t size)
+{
+    h ^= TB_XXH3_ROTL64(h, 49) ^ TB_XXH3_ROTL64(h, 24);
+    h *= TB_XXH3_PRIME_MX2;
+    h ^= (h >> 35) + size;
+    h *= TB_XXH3_PRIME_MX2;
+    h ^= h >> 28;
+    return h;
+}
+static __tb_inline__ tb_uint64_t tb_xxh3_mix16(tb_byte_t const* data, tb_byte_t const* secret, tb_uint64_t seed)
+{
+    return tb_xxh3_mul128_fold64(TB_XXH3_R64(data) ^ (TB_XXH3_R64(secret) + seed), TB_XXH3_R64(data + 8) ^ (TB_XXH3_R64(secret + 8) - seed));
+}
+static __tb_inline__ tb_void_t tb_xxh3_mix32(tb_xxh3_128_t* acc, tb_byte_t const* data1, tb_byte_t const* data2, tb_byte_t const* secret, tb_uint64_t seed)
+{
+    acc->low  += tb_xxh3_mix16(data1, secret, seed);
+    acc->low  ^= TB_XXH3_R64(data2) + TB_XXH3_R64(data2 + 8);
+    acc->high += tb_xxh3_mix16(data2, secret + 16, seed);
+    acc->high ^= TB_XXH3_R64(data1) + TB_XXH3_R64(data1 + 8);
+}
+static tb_void_t tb_xxh3_accumulate_scalar(tb_uint64_t acc[8], tb_byte_t const* data, tb_byte_t const* secret, tb_size_t stripes)
+{
+    tb_size_t i = 0;
+    while (stripes--)
+    {
+        for (i = 0; i < 8; i++)
+        {
+            tb_uint64_t value   = TB_XXH3_R64(data + (i << 3));
+            tb_uint64_t key     = value ^ TB_XXH3_R64(secret + (i << 3));
+            acc[i ^ 1]          += value;
+            acc[i]              += (key & 0xffffffff) * (key >> 32);
+        }
+        data += TB_XXH3_STRIPE_SIZE;
+        secret += 8;
+    }
+}
+static tb_void_t tb_xxh3_scramble_scalar(tb_uint64_t acc[8], tb_byte_t const* secret)
+{
+    tb_size_t i = 0;
+    for (i = 0; i < 8; i++)
+    {
+        tb_uint64_t a = acc[i];
+        a ^= a >> 47;
+        a ^= TB_XXH3_R64(secret + (i << 3));
+        a *= TB_XXH3_PRIME32_1;
+        acc[i] = a;
+    }
+}
+static tb_void_t tb_xxh3_accumulate(tb_uint64_t acc[8], tb_byte_t const* data, tb_byte_t const* secret, tb_size_t stripes)
+{
+    // select the accumulate implementation
+    static tb_xxh3_accumulate_func_t s_func = tb_null;
+    if (!s_func)
+    {
+        tb_xxh3_accumulate_func_t func = tb_xxh3_accumulate_scalar;
+#if defined(TB_HASH_IMPL_XXH3_SSE2)
+        func = tb_xxh3_impl_accumulate_sse2;
+#elif defined(TB_HASH_IMPL_XXH3_NEON)
+        func = tb_xxh3_impl_accumulate_neon;
+#endif
+#ifdef TB_HASH_IMPL_XXH3_AVX2
+        if (tb_xxh3_impl_avx2_ok()) func = tb_xxh3_impl_accumulate_avx2;
+#endif
+        s_func = func;
+    }
+
+    // done
+    s_func(acc, data, secret, stripes);
+}
+static tb_void_t tb_xxh3_scramble(tb_uint64_t acc[8], tb_byte_t const* secret)
+{
+    // select the scramble implementation
+    static tb_xxh3_scramble_func_t s_func = tb_null;
+    if (!s_func)
+    {
+        tb_xxh3_scramble_func_t func = tb_xxh3_scramble_scalar;
+#if defined(TB_HASH_IMPL_XXH3_SSE2)
+        func = tb_xxh3_impl_scramble_sse2;
+#elif defined(TB_HASH_IMPL_XXH3_NEON)
+        func = tb_xxh3_impl_scramble_neon;
+#endif
+#ifdef TB_HASH_IMPL_XXH3_AVX2
+        if (tb_xxh3_impl_avx2_ok()) func = tb_xxh3_impl_scramble_avx2;
+#endif
+        s_func = func;
+    }
+
+    // done
+    s_func(acc, secret);
+}
+static tb_void_t tb_xxh3_secret_init(tb_byte_t secret[TB_XXH3_SECRET_SIZE], tb_uint64_t seed)
+{
+    tb_size_t i = 0;
+    for (i = 0; i < TB_XXH3_SECRET_SIZE; i += 16)
+    {
+        tb_bits_set_u64_le(secret + i, TB_XXH3_R64(g_xxh3_secret + i) + seed);
+        tb_bits_set_u64_le(secret + i + 8, TB_XXH3_R64(g_xxh3_secret + i + 8) - seed);
+    }
+}
+static tb_uint64_t tb_xxh3_merge(tb_uint64_t const acc[8], tb_byte_t const* secret, tb_uint64_t start)
+{
+    tb_size_t   i = 0;
+    tb_uint64_t value = start;
+    for (i = 0; i < 4; i++)
+        value += tb_xxh3_mul128_fold64(acc[i << 1] ^ TB_XXH3_R64(secret + (i << 4)), acc[(i << 1) + 1] ^ TB_XXH3_R64(secret + (i << 4) + 8));
+    return tb_xxh3_avalanche(value);
+}
+static tb_void_t tb_xxh3_hash_long(tb_uint64_t acc[8], tb_byte_t const* data, tb_size_t size, tb_byte_t const* secret)
+{
+    // init accumulators
+    tb_memcpy(acc, g_xxh3_acc_init, sizeof(g_xxh3_acc_init));
+
+    // accumulate all full blocks
+    tb_size_t blocks = (size - 1) / TB_XXH3_BLOCK_SIZE;
+    tb_size_t i = 0;
+    for (i = 0; i < blocks; i++)
+    {
+        tb_xxh3_accumulate(acc, data + i * TB_XXH3_BLOCK_SIZE, secret, TB_XXH3_BLOCK_STRIPES);
+        tb_xxh3_scramble(acc, secret + TB_XXH3_SECRET_SIZE - TB_XXH3_STRIPE_SIZE);
+    }
+
+    // accumulate the last partial block
+    tb_size_t stripes = ((size - 1) - blocks * TB_XXH3_BLOCK_SIZE) / TB_XXH3_STRIPE_SIZE;
+    tb_xxh3_accumulate(acc, data + blocks * TB_XXH3_BLOCK_SIZE, secret, stripes);
+
+    // accumulate the last stripe
+    tb_xxh3_accumulate(acc, data + size - TB_XXH3_STRIPE_SIZE, secret + TB_XXH3_SECRET_SIZE - TB_XXH3_STRIPE_SIZE - 7, 1);
+}
+static tb_uint64_t tb_xxh3_make_short(tb_byte_t const* data, tb_size_t size, tb_byte_t const* secret, tb_uint64_t seed)
+{
+    // 0 bytes
+    tb_uint64_t len = (tb_uint64_t)size;
+    if (!size) return tb_xxh3_xxh64_avalanche(seed ^ TB_XXH3_R64(secret + 56) ^ TB_XXH3_R64(secret + 64));
+
+    // 1 - 3 bytes
+    if (size <= 3)
+    {
+        tb_uint32_t combined = ((tb_uint32_t)data[0] << 16) | ((tb_uint32_t)data[size >> 1] << 24) | (tb_uint32_t)data[size - 1] | ((tb_uint32_t)size << 8);
+        tb_uint64_t bitflip = (TB_XXH3_R32(secret) ^ TB_XXH3_R32(secret + 4)) + seed;
+        return tb_xxh3_xxh64_avalanche((tb_uint64_t)combined ^ bitflip);
+    }
+
+    // 4 - 8 bytes
+    if (size <= 8)
+    {
+        seed ^= (tb_uint64_t)tb_bits_swap_u32((tb_uint32_t)seed) << 32;
+        tb_uint64_t bitflip = (TB_XXH3_R64(secret + 8) ^ TB_XXH3_R64(secret + 16)) - seed;
+        tb_uint64_t value = TB_XXH3_R32(data + size - 4) + (TB_XXH3_R32(data) << 32);
+        return tb_xxh3_rrmxmx(value ^ bitflip, len);
+    }
+
+    // 9 - 16 bytes
+    if (size <= 16)
+    {
+        tb_uint64_t lo = TB_XXH3_R64(data) ^ ((TB_XXH3_R64(secret + 24) ^ TB_XXH3_R64(secret + 32)) + seed);
+        tb_uint64_t hi = TB_XXH3_R64(data + size - 8) ^ ((TB_XXH3_R64(secret + 40) ^ TB_XXH3_R64(secret + 48)) - seed);
+        return tb_xxh3_avalanche(len + tb_bits_swap_u64(lo) + hi + tb_xxh3_mul128_fold64(lo, hi));
+    }
+
+    // 17 - 128 bytes
+    tb_uint64_t acc = len * TB_XXH3_PRIME64_1;
+    if (size <= 128)
+    {
+        if (size > 32)
+        {
+            if (size > 64)
+            {
+                if (size > 96)
+                {
+                    acc += tb_xxh3_mix16(data + 48, secret + 96, seed);
+                    acc += tb_xxh3_mix16(data + size - 64, secret + 112, seed);
+                }
+                acc += tb_xxh3_mix16(data + 32, secret + 64, seed);
+                acc += tb_xxh3_mix16(data + size - 48, secret + 80, seed);
+            }
+            acc += tb_xxh3_mix16(data + 16, secret + 32, seed);
+            acc += tb_xxh3_mix16(data + size - 32, secret + 48, seed);
+        }
+        acc += tb_xxh3_mix16(data, secret, seed);
+        acc += tb_xxh3_mix16(data + size - 16, secret + 16, seed);
+        return tb_xxh3_avalanche(acc);
+    }
+
+    // 129 - 240 bytes
+    tb_size_t i = 0;
+    tb_size_t rounds = size >> 4;
+    for (i = 0; i < 8; i++) acc += tb_xxh3_mix16(data + (i << 4), secret + (i << 4), seed);
+    acc = tb_xxh3_avalanche(acc);
+    for (i = 8; i < rounds; i++) acc += tb_xxh3_mix16(data + (i << 4), secret + ((i - 8) << 4) + 3, seed);
+    acc += tb_xxh3_mix16(data + size - 16, secret + 136 - 17, seed);
+    return tb_xxh3_avalanche(acc);
+}
+static tb_xxh3_128_t tb_xxh3_make128_short(tb_byte_t const* data, tb_size_t size, tb_byte_t const* secret, tb_uint64_t seed)
+{
+    // 0 bytes
+    tb_xxh3_128_t   h;
+    tb_uint64_t     len = (tb_uint64_t)size;
+    if (!size)
+    {
+        h.low  = tb_xxh3_xxh64_avalanche(seed ^ TB_XXH3_R64(secret + 64) ^ TB_XXH3_R64(secret + 72));
+        h.high = tb_xxh3_xxh64_avalanche(seed ^ TB_XXH3_R64(secret + 80) ^ TB_XXH3_R64(secret + 88));
+        return h;
+    }
+
+    // 1 - 3 bytes
+    if (size <= 3)
+    {
+        tb_uint32_t combinedl = ((tb_uint32_t)data[0] << 16) | ((tb_uint32_t)data[size >> 1] << 24) | (tb_uint32_t)data[size - 1] | ((tb_uint32_t)size << 8);
+        tb_uint32_t swapped = tb_bits_swap_u32(combinedl);
+        tb_uint32_t combinedh = TB_XXH3_ROTL32(swapped, 13);
+        h.low  = tb_xxh3_xxh64_avalanche((tb_uint64_t)combinedl ^ ((TB_XXH3_R32(secret) ^ TB_XXH3_R32(secret + 4)) + seed));
+        h.high = tb_xxh3_xxh64_avalanche((tb_uint64_t)combinedh ^ ((TB_XXH3_R32(secret + 8) ^ TB_XXH3_R32(secret + 12)) - seed));
+        return h;
+    }
+
+    // 4 - 8 bytes
+    if (size <= 8)
+    {
+        seed ^= (tb_uint64_t)tb_bits_swap_u32((tb_uint32_t)seed) << 32;
+        tb_uint64_t value = TB_XXH3_R32(data) + (TB_XXH3_R32(data + size - 4) << 32);
+        tb_uint64_t keyed = value ^ ((TB_XXH3_R64(secret + 16) ^ TB_XXH3_R64(secret + 24)) + seed);
+        h.low = tb_xxh3_mul128(keyed, TB_XXH3_PRIME64_1 + (len << 2), &h.high);
+        h.high += h.low << 1;
+        h.low ^= h.high >> 3;
+        h.low ^= h.low >> 35;
+        h.low *= TB_XXH3_PRIME_MX2;
+        h.low ^= h.low >> 28;
+        h.high = tb_xxh3_avalanche(h.high);
+        return h;
+    }
+
+    // 9 - 16 bytes
+    if (size <= 16)
+    {
+        tb_uint64_t bitflipl = (TB_XXH3_R64(secret + 32) ^ TB_XXH3_R64(secret + 40)) - seed;
+        tb_uint64_t bitfliph = (TB_XXH3_R64(secret + 48) ^ TB_XXH3_R64(secret + 56)) + seed;
+        tb_uint64_t lo = TB_XXH3_R64(data);
+        tb_uint64_t hi = TB_XXH3_R64(data + size - 8);
+        tb_xxh3_128_t m;
+        m.low = tb_xxh3_mul128(lo ^ hi ^ bitflipl, TB_XXH3_PRIME64_1, &m.high);
+        m.low += (len - 1) << 54;
+        hi ^= bitfliph;
+        m.high += hi + (hi & 0xffffffff) * (TB_XXH3_PRIME32_2 - 1);
+        m.low ^= tb_bits_swap_u64(m.high);
+        h.low = tb_xxh3_mul128(m.low, TB_XXH3_PRIME64_2, &h.high);
+        h.high += m.high * TB_XXH3_PRIME64_2;
+        h.low = tb_xxh3_avalanche(h.low);
+        h.high = tb_xxh3_avalanche(h.high);
+        return h;
+    }
+
+    // 17 - 128 bytes
+    tb_xxh3_128_t acc;
+    acc.low = len * TB_XXH3_PRIME64_1;
+    acc.high = 0;
+    if (size <= 128)
+    {
+        if (size > 32)
+        {
+            if (size > 64)
+            {
+                if (size > 96) tb_xxh3_mix32(&acc, data + 48, data + size - 64, secret + 96, seed);
+                tb_xxh3_mix32(&acc, data + 32, data + size - 48, secret + 64, seed);
+            }
+            tb_xxh3_mix32(&acc, data + 16, data + size - 32, secret + 32, seed);
+        }
+        tb_xxh3_mix32(&acc, data, data + size - 16, secret, seed);
+    }
+    // 129 - 240 bytes
+    else
+    {
+        tb_size_t i = 0;
+        tb_size_t rounds = size >> 5;
+        for (i = 0; i < 4; i++) tb_xxh3_mix32(&acc, data + (i << 5), data + (i << 5) + 16, secret + (i << 5), seed);
+        acc.low = tb_xxh3_avalanche(acc.low);
+        acc.high = tb_xxh3_avalanche(acc.high);
+        for (i = 4; i < rounds; i++) tb_xxh3_mix32(&acc, data + (i << 5), data + (i << 5) + 16, secret + 3 + ((i - 4) << 5), seed);
+        tb_xxh3_mix32(&acc, data + size - 16, data + size - 32, secret + 136 - 17 - 16, 0 - seed);
+    }
+    h.low  = acc.low + acc.high;
+    h.high = acc.low * TB_XXH3_PRIME64_1 + acc.high * TB_XXH3_PRIME64_4 + (len - seed) * TB_XXH3_PRIME64_2;
+    h.low  = tb_xxh3_avalanche(h.low);
+    h.high = 0 - tb_xxh3_avalanche(h.high);
+    return h;
+}
+static tb_void_t tb_xxh3_consume(tb_xxh3_t* xxh3, tb_uint64_t acc[8], tb_size_t* pstripes, tb_byte_t const* data, tb_size_t stripes)
+{
+    // the current stripes
+    tb_size_t current = *pstripes;
+
+    // reach the end of the block? scramble it
+    if (TB_XXH3_BLOCK_STRIPES - current <= stripes)
+    {
+        tb_size_t left = TB_XXH3_BLOCK_STRIPES - current;
+        tb_xxh3_accumulate(acc, data, xxh3->secret + (current << 3), left);
+        tb_xxh3_scramble(acc, xxh3->secret + TB_XXH3_SECRET_SIZE - TB_XXH3_STRIPE_SIZE);
+        tb_xxh3_accumulate(acc, data + left * TB_XXH3_STRIPE_SIZE, xxh3->secret, stripes - left);
+        *pstripes = stripes - left;
+    }
+    else
+    {
+        tb_xxh3_accumulate(acc, data, xxh3->secret + (current << 3), stripes);
+        *pstripes = current + stripes;
+    }
+}
+static tb_void_t tb_xxh3_digest_long(tb_xxh3_t* xxh3, tb_uint64_t acc[8])
+{
+    // copy the accumulators, we need not modify the state
+    tb_memcpy(acc, xxh3->acc, sizeof(xxh3->acc));
+
+    // accumulate the buffered stripes and the last stripe
+    tb_byte_t const* last = tb_null;
+    tb_byte_t        stripe[TB_XXH3_STRIPE_SIZE];
+    if (xxh3->buffered >= TB_XXH3_STRIPE_SIZE)
+    {
+        tb_size_t stripes = xxh3->stripes;
+        tb_xxh3_consume(xxh3, acc, &stripes, xxh3->buffer, (xxh3->buffered - 1) / TB_XXH3_STRIPE_SIZE);
+        last = xxh3->buffer + xxh3->buffered - TB_XXH3_STRIPE_SIZE;
+    }
+    else
+    {
+        // the last stripe overlaps the previous consumed data
+        tb_size_t catchup = TB_XXH3_STRIPE_SIZE - xxh3->buffered;
+        tb_memcpy(stripe, xxh3->buffer + sizeof(xxh3->buffer) - catchup, catchup);
+        tb_memcpy(stripe + catchup, xxh3->buffer, xxh3->buffered);
+        last = stripe;
+    }
+    tb_xxh3_accumulate(acc, last, xxh3->secret + TB_XXH3_SECRET_SIZE - TB_XXH3_STRIPE_SIZE - 7, 1);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_uint64_t tb_xxh3_make(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed)
+{
+    // check
+    tb_assert_and_check_return_val(data || !size, 0);
+
+    // the short input
+    if (size <= TB_XXH3_MIDSIZE_MAX) return tb_xxh3_make_short(data, size, g_xxh3_secret, seed);
+
+    // the long input
+    tb_uint64_t acc[8];
+    tb_byte_t   secret[TB_XXH3_SECRET_SIZE];
+    if (seed) tb_xxh3_secret_init(secret, seed);
+    tb_byte_t const* psecret = seed? secret : g_xxh3_secret;
+    tb_xxh3_hash_long(acc, data, size, psecret);
+    return tb_xxh3_merge(acc, psecret + 11, (tb_uint64_t)size * TB_XXH3_PRIME64_1);
+}
+tb_uint64_t tb_xxh3_make_from_cstr(tb_char_t const* cstr, tb_uint64_t seed)
+{
+    // check
+    tb_assert_and_check_return_val(cstr, 0);
+
+    // make it
+    return tb_xxh3_make((tb_byte_t const*)cstr, tb_strlen(cstr), seed);
+}
+tb_xxh3_128_t tb_xxh3_make128(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed)
+{
+    // check
+    tb_xxh3_128_t h = {0, 0};
+    tb_assert_and_check_return_val(data || !size, h);
+
+    // the short input
+    if (size <= TB_XXH3_MIDSIZE_MAX) return tb_xxh3_make128_short(data, size, g_xxh3_secret, seed);
+
+    // the long input
+    tb_uint64_t acc[8];
+    tb_byte_t   secret[TB_XXH3_SECRET_SIZE];
+    if (seed) tb_xxh3_secret_init(secret, seed);
+    tb_byte_t const* psecret = seed? secret : g_xxh3_secret;
+    tb_xxh3_hash_long(acc, data, size, psecret);
+    h.low  = tb_xxh3_merge(acc, psecret + 11, (tb_uint64_t)size * TB_XXH3_PRIME64_1);
+    h.high = tb_xxh3_merge(acc, psecret + TB_XXH3_SECRET_SIZE - TB_XXH3_STRIPE_SIZE - 11, ~((tb_uint64_t)size * TB_XXH3_PRIME64_2));
+    return h;
+}
+tb_void_t tb_xxh3_init(tb_xxh3_t* xxh3, tb_uint64_t seed)
+{
+    // check
+    tb_assert_and_check_return(xxh3);
+
+    // init it
+    tb_memcpy(xxh3->acc, g_xxh3_acc_init, sizeof(g_xxh3_acc_init));
+    tb_xxh3_secret_init(xxh3->secret, seed);
+    xxh3->buffered  = 0;
+    xxh3->stripes   = 0;
+    xxh3->total     = 0;
+    xxh3->seed      = seed;
+}
+tb_void_t tb_xxh3_spak(tb_xxh3_t* xxh3, tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return(xxh3 && (data || !size));
+
+    // update the total size
+    xxh3->total += size;
+
+    // only buffer it? 
+    if (size <= sizeof(xxh3->buffer) - xxh3->buffered)
+    {
+        if (size) tb_memcpy(xxh3->buffer + xxh3->buffered, data, size);
+        xxh3->buffered += size;
+        return ;
+    }
+
+    /* fill and consume the buffer first
+     *
+     * @note we always keep some data in the buffer for the last stripe
+     */
+    tb_size_t stripes = sizeof(xxh3->buffer) / TB_XXH3_STRIPE_SIZE;
+    if (xxh3->buffered)
+    {
+        tb_size_t n = sizeof(xxh3->buffer) - xxh3->buffered;
+        tb_memcpy(xxh3->buffer + xxh3->buffered, data, n);
+        data += n;
+        size -= n;
+        tb_xxh3_consume(xxh3, xxh3->acc, &xxh3->stripes, xxh3->buffer, stripes);
+        xxh3->buffered = 0;
+    }
+
+    // consume the input data directly
+    if (size > sizeof(xxh3->buffer))
+    {
+        do
+        {
+            tb_xxh3_consume(xxh3, xxh3->acc, &xxh3->stripes, data, stripes);
+            data += sizeof(xxh3->buffer);
+            size -= sizeof(xxh3->buffer);
+
+        } while (size > sizeof(xxh3->buffer));
+
+        // save the last consumed stripe for the overlapped last stripe
+        tb_memcpy(xxh3->buffer + sizeof(xxh3->buffer) - TB_XXH3_STRIPE_SIZE, data - TB_XXH3_STRIPE_SIZE, TB_XXH3_STRIPE_SIZE);
+    }
+
+    // buffer the left data
+    tb_memcpy(xxh3->buffer, data, size);
+    xxh3->buffered = size;
+}
+tb_uint64_t tb_xxh3_exit(tb_xxh3_t* xxh3)
+{
+    // check
+    tb_assert_and_check_return_val(xxh3, 0);
+
+    // the short input, all data are buffered
+    if (xxh3->total <= TB_XXH3_MIDSIZE_MAX) return tb_xxh3_make_short(xxh3->buffer, (tb_size_t)xxh3->total, g_xxh3_secret, xxh3->seed);
+
+    // the long input
+    tb_uint64_t acc[8];
+    tb_xxh3_digest_long(xxh3, acc);
+    return tb_xxh3_merge(acc, xxh3->secret + 11, (tb_uint64_t)xxh3->total * TB_XXH3_PRIME64_1);
+}
+tb_xxh3_128_t tb_xxh3_exit128(tb_xxh3_t* xxh3)
+{
+    // check
+    tb_xxh3_128_t h = {0, 0};
+    tb_assert_and_check_return_val(xxh3, h);
+
+    // the short input, all data are buffered
+    if (xxh3->total <= TB_XXH3_MIDSIZE_MAX) return tb_xxh3_make128_short(xxh3->buffer, (tb_size_t)xxh3->total, g_xxh3_secret, xxh3->seed);
+
+    // the long input
+    tb_uint64_t acc[8];
+    tb_xxh3_digest_long(xxh3, acc);
+    h.low  = tb_xxh3_merge(acc, xxh3->secret + 11, (tb_uint64_t)xxh3->total * TB_XXH3_PRIME64_1);
+    h.high = tb_xxh3_merge(acc, xxh3->secret + TB_XXH3_SECRET_SIZE - TB_XXH3_STRIPE_SIZE - 11, ~((tb_uint64_t)xxh3->total * TB_XXH3_PRIME64_2));
+    return h;
+}
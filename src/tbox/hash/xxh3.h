@@ -0,0 +1,164 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        xxh3.h
+ * @ingroup     hash
+ *
+ */
+#ifndef TB_HASH_XXH3_H
+#define TB_HASH_XXH3_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the xxh3 128-bits hash value type
+typedef struct __tb_xxh3_128_t
+{
+    // the low 64-bits
+    tb_uint64_t     low;
+
+    // the high 64-bits
+    tb_uint64_t     high;
+
+}tb_xxh3_128_t;
+
+// the xxh3 streaming state type
+typedef struct __tb_xxh3_t
+{
+    // the accumulators
+    tb_uint64_t     acc[8];
+
+    // the secret derived from the seed
+    tb_byte_t       secret[192];
+
+    // the buffer of the pending stripes
+    tb_byte_t       buffer[256];
+
+    // the buffered size
+    tb_size_t       buffered;
+
+    // the consumed stripes count of the current block
+    tb_size_t       stripes;
+
+    // the total size
+    tb_hize_t       total;
+
+    // the seed
+    tb_uint64_t     seed;
+
+}tb_xxh3_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! make xxh3 64-bits hash
+ *
+ * a fast non-cryptographic hash compatible with XXH3_64bits_withSeed(), 
+ * the bulk data will be processed with sse2/avx2/neon if be supported.
+ *
+ * @param data      the data, maybe null if the size is zero
+ * @param size      the size
+ * @param seed      the seed
+ *
+ * @return          the xxh3 value
+ */
+tb_uint64_t         tb_xxh3_make(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed);
+
+/*! make xxh3 64-bits hash from c-string
+ *
+ * @param cstr      the c-string
+ * @param seed      the seed
+ *
+ * @return          the xxh3 value
+ */
+tb_uint64_t         tb_xxh3_make_from_cstr(tb_char_t const* cstr, tb_uint64_t seed);
+
+/*! make xxh3 128-bits hash, it is compatible with XXH3_128bits_withSeed()
+ *
+ * @param data      the data, maybe null if the size is zero
+ * @param size      the size
+ * @param seed      the seed
+ *
+ * @return          the xxh3 value
+ */
+tb_xxh3_128_t       tb_xxh3_make128(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed);
+
+/*! init xxh3 for streaming 
+ *
+ * @code
+    tb_xxh3_t xxh3;
+    tb_xxh3_init(&xxh3, seed);
+    tb_xxh3_spak(&xxh3, data1, size1);
+    tb_xxh3_spak(&xxh3, data2, size2);
+    tb_uint64_t value = tb_xxh3_exit(&xxh3);
+ * @endcode
+ *
+ * @param xxh3      the xxh3
+ * @param seed      the seed
+ */
+tb_void_t           tb_xxh3_init(tb_xxh3_t* xxh3, tb_uint64_t seed);
+
+/*! spak xxh3 
+ *
+ * @param xxh3      the xxh3
+ * @param data      the data
+ * @param size      the size
+ */
+tb_void_t           tb_xxh3_spak(tb_xxh3_t* xxh3, tb_byte_t const* data, tb_size_t size);
+
+/*! exit xxh3 and get the 64-bits value
+ *
+ * @note the state will not be modified, so we can continue to spak more data after it
+ *
+ * @param xxh3      the xxh3
+ *
+ * @return          the xxh3 value
+ */
+tb_uint64_t         tb_xxh3_exit(tb_xxh3_t* xxh3);
+
+/*! exit xxh3 and get the 128-bits value
+ *
+ * @note the state will not be modified, so we can continue to spak more data after it
+ *
+ * @param xxh3      the xxh3
+ *
+ * @return          the xxh3 value
+ */
+tb_xxh3_128_t       tb_xxh3_exit128(tb_xxh3_t* xxh3);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
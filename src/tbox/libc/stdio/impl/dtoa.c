@@ -0,0 +1,501 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        dtoa.c
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "dtoa.h"
+#include "../../../libm/libm.h"
+#include "../../../utils/utils.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the minimum and maximum binary exponent of the scaled value in grisu2
+#define TB_DTOA_GRISU_ALPHA             (-60)
+#define TB_DTOA_GRISU_GAMMA             (-32)
+
+// the decimal exponent of the first cached power and the step
+#define TB_DTOA_CACHED_POWER_MIN        (-300)
+#define TB_DTOA_CACHED_POWER_STEP       (8)
+
+// the maximum limbs count of the exact big integer, base: 1e9
+#define TB_DTOA_LIMBS_MAXN              (96)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+
+// the "do-it-yourself" floating point type: f * 2^e
+typedef struct __tb_dtoa_diyfp_t
+{
+    // the significand
+    tb_uint64_t         f;
+
+    // the binary exponent
+    tb_int_t            e;
+
+}tb_dtoa_diyfp_t;
+
+// the cached power type: f * 2^e ~= 10^k
+typedef struct __tb_dtoa_cached_power_t
+{
+    // the significand
+    tb_uint64_t         f;
+
+    // the binary exponent
+    tb_int16_t          e;
+
+    // the decimal exponent
+    tb_int16_t          k;
+
+}tb_dtoa_cached_power_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the normalized and rounded powers of ten: 10^-300, 10^-292, ..., 10^324
+static tb_dtoa_cached_power_t const g_cached_powers[] =
+{
+    {0xab70fe17c79ac6caULL, -1060,  -300}
+,   {0xff77b1fcbebcdc4fULL, -1034,  -292}
+,   {0xbe5691ef416bd60cULL, -1007,  -284}
+,   {0x8dd01fad907ffc3cULL,  -980,  -276}
+,   {0xd3515c2831559a83ULL,  -954,  -268}
+,   {0x9d71ac8fada6c9b5ULL,  -927,  -260}
+,   {0xea9c227723ee8bcbULL,  -901,  -252}
+,   {0xaecc49914078536dULL,  -874,  -244}
+,   {0x823c12795db6ce57ULL,  -847,  -236}
+,   {0xc21094364dfb5637ULL,  -821,  -228}
+,   {0x9096ea6f3848984fULL,  -794,  -220}
+,   {0xd77485cb25823ac7ULL,  -768,  -212}
+,   {0xa086cfcd97bf97f4ULL,  -741,  -204}
+,   {0xef340a98172aace5ULL,  -715,  -196}
+,   {0xb23867fb2a35b28eULL,  -688,  -188}
+,   {0x84c8d4dfd2c63f3bULL,  -661,  -180}
+,   {0xc5dd44271ad3cdbaULL,  -635,  -172}
+,   {0x936b9fcebb25c996ULL,  -608,  -164}
+,   {0xdbac6c247d62a584ULL,  -582,  -156}
+,   {0xa3ab66580d5fdaf6ULL,  -555,  -148}
+,   {0xf3e2f893dec3f126ULL,  -529,  -140}
+,   {0xb5b5ada8aaff80b8ULL,  -502,  -132}
+,   {0x87625f056c7c4a8bULL,  -475,  -124}
+,   {0xc9bcff6034c13053ULL,  -449,  -116}
+,   {0x964e858c91ba2655ULL,  -422,  -108}
+,   {0xdff9772470297ebdULL,  -396,  -100}
+,   {0xa6dfbd9fb8e5b88fULL,  -369,   -92}
+,   {0xf8a95fcf88747d94ULL,  -343,   -84}
+,   {0xb94470938fa89bcfULL,  -316,   -76}
+,   {0x8a08f0f8bf0f156bULL,  -289,   -68}
+,   {0xcdb02555653131b6ULL,  -263,   -60}
+,   {0x993fe2c6d07b7facULL,  -236,   -52}
+,   {0xe45c10c42a2b3b06ULL,  -210,   -44}
+,   {0xaa242499697392d3ULL,  -183,   -36}
+,   {0xfd87b5f28300ca0eULL,  -157,   -28}
+,   {0xbce5086492111aebULL,  -130,   -20}
+,   {0x8cbccc096f5088ccULL,  -103,   -12}
+,   {0xd1b71758e219652cULL,   -77,    -4}
+,   {0x9c40000000000000ULL,   -50,     4}
+,   {0xe8d4a51000000000ULL,   -24,    12}
+,   {0xad78ebc5ac620000ULL,     3,    20}
+,   {0x813f3978f8940984ULL,    30,    28}
+,   {0xc097ce7bc90715b3ULL,    56,    36}
+,   {0x8f7e32ce7bea5c70ULL,    83,    44}
+,   {0xd5d238a4abe98068ULL,   109,    52}
+,   {0x9f4f2726179a2245ULL,   136,    60}
+,   {0xed63a231d4c4fb27ULL,   162,    68}
+,   {0xb0de65388cc8ada8ULL,   189,    76}
+,   {0x83c7088e1aab65dbULL,   216,    84}
+,   {0xc45d1df942711d9aULL,   242,    92}
+,   {0x924d692ca61be758ULL,   269,   100}
+,   {0xda01ee641a708deaULL,   295,   108}
+,   {0xa26da3999aef774aULL,   322,   116}
+,   {0xf209787bb47d6b85ULL,   348,   124}
+,   {0xb454e4a179dd1877ULL,   375,   132}
+,   {0x865b86925b9bc5c2ULL,   402,   140}
+,   {0xc83553c5c8965d3dULL,   428,   148}
+,   {0x952ab45cfa97a0b3ULL,   455,   156}
+,   {0xde469fbd99a05fe3ULL,   481,   164}
+,   {0xa59bc234db398c25ULL,   508,   172}
+,   {0xf6c69a72a3989f5cULL,   534,   180}
+,   {0xb7dcbf5354e9beceULL,   561,   188}
+,   {0x88fcf317f22241e2ULL,   588,   196}
+,   {0xcc20ce9bd35c78a5ULL,   614,   204}
+,   {0x98165af37b2153dfULL,   641,   212}
+,   {0xe2a0b5dc971f303aULL,   667,   220}
+,   {0xa8d9d1535ce3b396ULL,   694,   228}
+,   {0xfb9b7cd9a4a7443cULL,   720,   236}
+,   {0xbb764c4ca7a44410ULL,   747,   244}
+,   {0x8bab8eefb6409c1aULL,   774,   252}
+,   {0xd01fef10a657842cULL,   800,   260}
+,   {0x9b10a4e5e9913129ULL,   827,   268}
+,   {0xe7109bfba19c0c9dULL,   853,   276}
+,   {0xac2820d9623bf429ULL,   880,   284}
+,   {0x80444b5e7aa7cf85ULL,   907,   292}
+,   {0xbf21e44003acdd2dULL,   933,   300}
+,   {0x8e679c2f5e44ff8fULL,   960,   308}
+,   {0xd433179d9c8cb841ULL,   986,   316}
+,   {0x9e19db92b4e31ba9ULL,  1013,   324}
+};
+
+// the powers of five for multiplying the big integer, 5^13 is the largest one in 32-bits
+static tb_uint32_t const g_pow5[] =
+{
+    1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125, 9765625, 48828125, 244140625, 1220703125
+};
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static __tb_inline__ tb_uint64_t tb_dtoa_bits(tb_double_t value)
+{
+    tb_ieee_double_t ieee;
+    ieee.d = value;
+    return ((tb_uint64_t)ieee.i.h << 32) | ieee.i.l;
+}
+static __tb_inline__ tb_dtoa_diyfp_t tb_dtoa_diyfp_make(tb_uint64_t f, tb_int_t e)
+{
+    tb_dtoa_diyfp_t x;
+    x.f = f;
+    x.e = e;
+    return x;
+}
+static __tb_inline__ tb_dtoa_diyfp_t tb_dtoa_diyfp_normalize(tb_dtoa_diyfp_t x)
+{
+    tb_size_t shift = tb_bits_cl0_u64_be(x.f);
+    x.f <<= shift;
+    x.e -= (tb_int_t)shift;
+    return x;
+}
+static __tb_inline__ tb_dtoa_diyfp_t tb_dtoa_diyfp_mul(tb_dtoa_diyfp_t x, tb_dtoa_diyfp_t y)
+{
+    // the rounded high 64-bits of the 128-bits product
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 tb_dtoa_uint128_t;
+    tb_dtoa_uint128_t p = (tb_dtoa_uint128_t)x.f * y.f;
+    tb_uint64_t h = (tb_uint64_t)(p >> 64) + (((tb_uint64_t)p) >> 63);
+#else
+    tb_uint64_t a = x.f >> 32;
+    tb_uint64_t b = x.f & 0xffffffff;
+    tb_uint64_t c = y.f >> 32;
+    tb_uint64_t d = y.f & 0xffffffff;
+    tb_uint64_t ac = a * c;
+    tb_uint64_t bc = b * c;
+    tb_uint64_t ad = a * d;
+    tb_uint64_t bd = b * d;
+    tb_uint64_t t = (bd >> 32) + (ad & 0xffffffff) + (bc & 0xffffffff) + (1ULL << 31);
+    tb_uint64_t h = ac + (ad >> 32) + (bc >> 32) + (t >> 32);
+#endif
+    return tb_dtoa_diyfp_make(h, x.e + y.e + 64);
+}
+static tb_void_t tb_dtoa_boundaries(tb_double_t value, tb_bool_t single, tb_dtoa_diyfp_t* w, tb_dtoa_diyfp_t* m_minus, tb_dtoa_diyfp_t* m_plus)
+{
+    // decompose value = f * 2^e
+    tb_uint64_t f;
+    tb_int_t    e;
+    tb_bool_t   lower_closer;
+    if (single)
+    {
+        tb_ieee_float_t ieee;
+        ieee.f = (tb_float_t)value;
+        tb_uint32_t E = (ieee.i >> 23) & 0xff;
+        tb_uint32_t F = ieee.i & 0x7fffff;
+        f = E? (F | 0x800000) : F;
+        e = E? (tb_int_t)E - 150 : -149;
+        lower_closer = !F && E > 1;
+    }
+    else
+    {
+        tb_uint64_t bits = tb_dtoa_bits(value);
+        tb_uint64_t E = (bits >> 52) & 0x7ff;
+        tb_uint64_t F = bits & 0xfffffffffffffULL;
+        f = E? (F | 0x10000000000000ULL) : F;
+        e = E? (tb_int_t)E - 1075 : -1074;
+        lower_closer = !F && E > 1;
+    }
+
+    /* the boundaries are the middle points to the neighbours
+     *
+     * the lower neighbour is closer if the significand is a power of two
+     */
+    *w = tb_dtoa_diyfp_normalize(tb_dtoa_diyfp_make(f, e));
+    *m_plus = tb_dtoa_diyfp_normalize(tb_dtoa_diyfp_make((f << 1) + 1, e - 1));
+    *m_minus = lower_closer? tb_dtoa_diyfp_make((f << 2) - 1, e - 2) : tb_dtoa_diyfp_make((f << 1) - 1, e - 1);
+    m_minus->f <<= m_minus->e - m_plus->e;
+    m_minus->e = m_plus->e;
+}
+static __tb_inline__ tb_dtoa_cached_power_t const* tb_dtoa_cached_power(tb_int_t e)
+{
+    // find the cached power c = 10^k with alpha <= c.e + e + 64 <= gamma
+    tb_int_t f = TB_DTOA_GRISU_ALPHA - e - 1;
+    tb_int_t k = (f * 78913) / (1 << 18) + (f > 0);
+    tb_size_t index = (tb_size_t)(-TB_DTOA_CACHED_POWER_MIN + k + (TB_DTOA_CACHED_POWER_STEP - 1)) / TB_DTOA_CACHED_POWER_STEP;
+    tb_assert(index < tb_arrayn(g_cached_powers));
+    return &g_cached_powers[index];
+}
+static __tb_inline__ tb_uint32_t tb_dtoa_pow10_floor(tb_uint32_t n, tb_size_t* count)
+{
+    // get the largest 10^k <= n and the digits count of n
+    static tb_uint32_t const s_pow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+    tb_size_t k = 9;
+    while (k && s_pow10[k] > n) k--;
+    *count = k + 1;
+    return s_pow10[k];
+}
+static tb_void_t tb_dtoa_grisu2_round(tb_char_t* digits, tb_size_t size, tb_uint64_t dist, tb_uint64_t delta, tb_uint64_t rest, tb_uint64_t ten_k)
+{
+    // move the last digit closer to w while it is still in the range (w-, w+)
+    while (     rest < dist
+            &&  delta - rest >= ten_k
+            &&  (rest + ten_k < dist || dist - rest > rest + ten_k - dist))
+    {
+        digits[size - 1]--;
+        rest += ten_k;
+    }
+}
+static tb_size_t tb_dtoa_grisu2(tb_dtoa_diyfp_t v, tb_dtoa_diyfp_t m_minus, tb_dtoa_diyfp_t m_plus, tb_char_t* digits, tb_int_t* exp10)
+{
+    // scale them by the cached power, the exponent will be in [alpha, gamma]
+    tb_dtoa_cached_power_t const* cached = tb_dtoa_cached_power(m_plus.e);
+    tb_dtoa_diyfp_t c = tb_dtoa_diyfp_make(cached->f, cached->e);
+    tb_dtoa_diyfp_t w = tb_dtoa_diyfp_mul(v, c);
+    tb_dtoa_diyfp_t w_minus = tb_dtoa_diyfp_mul(m_minus, c);
+    tb_dtoa_diyfp_t w_plus = tb_dtoa_diyfp_mul(m_plus, c);
+
+    // the products have one ulp error at most, so we shrink the range conservatively
+    w_minus.f++;
+    w_plus.f--;
+    *exp10 = -cached->k;
+
+    // split w+ = p1 + p2 * 2^e, the integer part p1 has 32-bits at most
+    tb_int_t    shift = -w_plus.e;
+    tb_uint64_t one = 1ULL << shift;
+    tb_uint64_t delta = w_plus.f - w_minus.f;
+    tb_uint64_t dist = w_plus.f - w.f;
+    tb_uint32_t p1 = (tb_uint32_t)(w_plus.f >> shift);
+    tb_uint64_t p2 = w_plus.f & (one - 1);
+
+    // generate the digits of the integer part
+    tb_size_t   n = 0;
+    tb_size_t   count = 0;
+    tb_uint32_t pow10 = tb_dtoa_pow10_floor(p1, &count);
+    while (count > 0)
+    {
+        tb_uint32_t d = p1 / pow10;
+        p1 %= pow10;
+        digits[n++] = (tb_char_t)('0' + d);
+        count--;
+
+        // enough? the rest is in the range now
+        tb_uint64_t rest = ((tb_uint64_t)p1 << shift) + p2;
+        if (rest <= delta)
+        {
+            *exp10 += (tb_int_t)count;
+            tb_dtoa_grisu2_round(digits, n, dist, delta, rest, (tb_uint64_t)pow10 << shift);
+            return n;
+        }
+        pow10 /= 10;
+    }
+
+    // generate the digits of the fractional part
+    tb_int_t m = 0;
+    while (1)
+    {
+        p2 *= 10;
+        digits[n++] = (tb_char_t)('0' + (p2 >> shift));
+        p2 &= one - 1;
+        delta *= 10;
+        dist *= 10;
+        m++;
+        if (p2 <= delta) break;
+    }
+    *exp10 -= m;
+    tb_dtoa_grisu2_round(digits, n, dist, delta, p2, one);
+    return n;
+}
+static tb_void_t tb_dtoa_bigint_mul(tb_uint32_t* limbs, tb_size_t* size, tb_uint32_t mul)
+{
+    tb_size_t   i = 0;
+    tb_size_t   n = *size;
+    tb_uint64_t carry = 0;
+    for (i = 0; i < n; i++)
+    {
+        carry += (tb_uint64_t)limbs[i] * mul;
+        limbs[i] = (tb_uint32_t)(carry % 1000000000);
+        carry /= 1000000000;
+    }
+    while (carry)
+    {
+        tb_assert(n < TB_DTOA_LIMBS_MAXN);
+        limbs[n++] = (tb_uint32_t)(carry % 1000000000);
+        carry /= 1000000000;
+    }
+    *size = n;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_size_t tb_dtoa_shortest(tb_double_t value, tb_bool_t single, tb_char_t* digits, tb_int_t* point)
+{
+    // check
+    tb_assert(value > 0 && digits && point);
+
+    // get the boundaries
+    tb_dtoa_diyfp_t w;
+    tb_dtoa_diyfp_t m_minus;
+    tb_dtoa_diyfp_t m_plus;
+    tb_dtoa_boundaries(value, single, &w, &m_minus, &m_plus);
+
+    // generate digits, value ~= digits * 10^exp10
+    tb_int_t    exp10 = 0;
+    tb_size_t   n = tb_dtoa_grisu2(w, m_minus, m_plus, digits, &exp10);
+
+    // remove the trailing zeros
+    while (n > 1 && digits[n - 1] == '0') 
+    {
+        n--;
+        exp10++;
+    }
+
+    // value = 0.d1d2...dn * 10^point
+    *point = (tb_int_t)n + exp10;
+    return n;
+}
+tb_size_t tb_dtoa_exact(tb_double_t value, tb_bool_t fixed, tb_int_t ndigits, tb_char_t* digits, tb_int_t* point)
+{
+    // check
+    tb_assert(value > 0 && digits && point);
+
+    // decompose value = m * 2^e
+    tb_uint64_t bits = tb_dtoa_bits(value);
+    tb_uint64_t E = (bits >> 52) & 0x7ff;
+    tb_uint64_t m = bits & 0xfffffffffffffULL;
+    tb_int_t    e = E? (tb_int_t)E - 1075 : -1074;
+    if (E) m |= 0x10000000000000ULL;
+
+    // the big integer of base 1e9 in little-endian
+    tb_uint32_t limbs[TB_DTOA_LIMBS_MAXN];
+    tb_size_t   size = 0;
+    while (m)
+    {
+        limbs[size++] = (tb_uint32_t)(m % 1000000000);
+        m /= 1000000000;
+    }
+
+    /* make the exact integer n and the scale s, value = n * 10^-s
+     *
+     * m * 2^e = m * 5^-e / 10^-e if e < 0
+     */
+    tb_int_t scale = 0;
+    if (e >= 0)
+    {
+        while (e > 0)
+        {
+            tb_int_t shift = tb_min(e, 29);
+            tb_dtoa_bigint_mul(limbs, &size, 1U << shift);
+            e -= shift;
+        }
+    }
+    else
+    {
+        scale = -e;
+        while (e < 0)
+        {
+            tb_int_t k = tb_min(-e, 13);
+            tb_dtoa_bigint_mul(limbs, &size, g_pow5[k]);
+            e += k;
+        }
+    }
+
+    // convert the big integer to the decimal digits
+    tb_size_t   n = 0;
+    tb_size_t   i = size - 1;
+    tb_uint32_t limb = limbs[i];
+    tb_char_t   head[10];
+    tb_size_t   head_n = 0;
+    do
+    {
+        head[head_n++] = (tb_char_t)('0' + limb % 10);
+        limb /= 10;
+
+    } while (limb);
+    while (head_n) digits[n++] = head[--head_n];
+    while (i--)
+    {
+        tb_size_t j = 9;
+        limb = limbs[i];
+        while (j--)
+        {
+            digits[n + j] = (tb_char_t)('0' + limb % 10);
+            limb /= 10;
+        }
+        n += 9;
+    }
+    tb_assert(n <= TB_DTOA_EXACT_MAXN);
+    *point = (tb_int_t)n - scale;
+
+    // the kept digits count
+    tb_long_t keep = fixed? (tb_long_t)*point + ndigits : ndigits;
+    if (keep >= (tb_long_t)n) 
+    {
+        // remove the trailing zeros
+        while (n > 1 && digits[n - 1] == '0') n--;
+        return n;
+    }
+
+    // it will be rounded to zero
+    if (keep < 0) return 0;
+
+    // round it, half to even
+    tb_bool_t   up = tb_false;
+    tb_char_t   c = digits[keep];
+    if (c > '5') up = tb_true;
+    else if (c == '5')
+    {
+        for (i = keep + 1; i < n && digits[i] == '0'; i++) ;
+        up = i < n || (keep > 0 && ((digits[keep - 1] - '0') & 1));
+    }
+    n = (tb_size_t)keep;
+    if (up)
+    {
+        // carry, e.g. 0.999 => 1.00
+        while (n && digits[n - 1] == '9') n--;
+        if (n) digits[n - 1]++;
+        else
+        {
+            digits[n++] = '1';
+            (*point)++;
+        }
+    }
+
+    // remove the trailing zeros
+    while (n && digits[n - 1] == '0') n--;
+    return n;
+}
+#endif
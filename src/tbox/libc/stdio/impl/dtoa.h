@@ -0,0 +1,90 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        dtoa.h
+ *
+ */
+#ifndef TB_LIBC_STDIO_IMPL_DTOA_H
+#define TB_LIBC_STDIO_IMPL_DTOA_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the maximum digits count of the shortest representation, 17 for double and 9 for float
+#define TB_DTOA_SHORTEST_MAXN           (32)
+
+/* the maximum digits count of the exact representation
+ *
+ * the exact decimal expansion of the smallest subnormal double has 767 significant digits
+ */
+#define TB_DTOA_EXACT_MAXN              (800)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+
+/* get the shortest decimal digits which will be read back to the same value (grisu2)
+ *
+ * value = 0.d1d2...dn * 10^point, no trailing zeros
+ *
+ * @param value     the positive and finite value
+ * @param single    is single precision? the value will be round-tripped as float
+ * @param digits    the digits buffer, TB_DTOA_SHORTEST_MAXN at least
+ * @param point     the decimal point position
+ *
+ * @return          the digits count
+ */
+tb_size_t           tb_dtoa_shortest(tb_double_t value, tb_bool_t single, tb_char_t* digits, tb_int_t* point);
+
+/* get the exact decimal digits which are correctly rounded (half to even)
+ *
+ * value ~= 0.d1d2...dn * 10^point, the omitted digits after dn are all zeros
+ *
+ * @param value     the positive and finite value
+ * @param fixed     ndigits is the digits count after the decimal point? otherwise it is the significant digits count
+ * @param ndigits   the digits count
+ * @param digits    the digits buffer, TB_DTOA_EXACT_MAXN at least
+ * @param point     the decimal point position
+ *
+ * @return          the digits count, maybe zero if the value is rounded to zero in the fixed mode
+ */
+tb_size_t           tb_dtoa_exact(tb_double_t value, tb_bool_t fixed, tb_int_t ndigits, tb_char_t* digits, tb_int_t* point);
+
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
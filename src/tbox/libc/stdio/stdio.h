@@ -113,6 +113,9 @@ tb_long_t           tb_wputs(tb_wchar_t const* string);
  *     - %#B => add prefix: 0B...
  *     - %#f => add prefix: 0f...
  *     - %#F => add prefix: 0F...
+ *   - ~:       print the shortest digits which will be read back to the same value for %g, the precision is ignored
+ *     - %~g => 0.1 => 0.1, 1e100 => 1e+100, 
+ *              it uses the exponential notation only if the exponent is less than -4 or not less than 17 (9 for float)
  *
  * - width:
  *   - n:       n = 1, 2, 3, ..., fill spaces
@@ -159,14 +162,16 @@ tb_long_t           tb_wputs(tb_wchar_t const* string);
  *              This type differs slightly from fixed-point notation in 
  *              that insignificant zeroes to the right of the decimal point are not included. 
  *              Also, the decimal point is not included on whole numbers.
+ *              If no precision is given, the precision is 6, e.g. 1.0 / 3.0 => 0.333333.
  *   - c:       print a char (character).
  *   - s:       print a character string
  *   - p:       print a void * (pointer to void) in an implementation-defined format.
  *   - n:       print nothing, but write number of characters successfully written so far into an integer pointer parameter.
  *   - %:       %
  *
- * @note support        d, i, u, o, u, x/X, b/B, f/F, c, s
- * @note not support    e/E, g/G, p, n
+ * @note support        d, i, u, o, u, x/X, b/B, f/F, e/E, g/G, c, s
+ * @note not support    n
+ * @note the float and double values are printed exactly and rounded half to even, it's same as glibc
  *
  * @code
  * tb_printf("|hello world|\n");
@@ -183,6 +188,7 @@ tb_long_t           tb_wputs(tb_wchar_t const* string);
  * tb_printf("|%016.9f|\n", 3.14159);
  * tb_printf("|%lf|\n", 1.0 / 6.0);
  * tb_printf("|%lf|\n", 0.0003141596);
+ * tb_printf("|%le|%lg|%.3lg|%~lg|\n", 1e-10, 0.1, 3.1415926, 0.1);
  * tb_printf("|%F|\n", tb_float_to_fixed(3.1415));
  * tb_printf("|%{object_name}|\n", object);
  * @endcode
@@ -34,6 +34,7 @@
 #include "../../utils/utils.h"
 #include "../string/string.h"
 #include "printf_object.h"
+#include "impl/dtoa.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
@@ -64,6 +65,7 @@ typedef enum __tb_printf_extra_t
 ,   TB_PRINTF_EXTRA_UPPER           = 2     // upper case for %X %B
 ,   TB_PRINTF_EXTRA_PERCENT         = 4     // percent char: %
 ,   TB_PRINTF_EXTRA_EXP             = 8     // exponent form: [-]d.ddd e[+/-]ddd
+,   TB_PRINTF_EXTRA_GENERAL         = 16    // general form: %g %G
 
 }tb_printf_extra_t;
 
@@ -89,6 +91,7 @@ typedef enum __tb_printf_flag_t
 ,   TB_PRINTF_FLAG_LEFT             = 2     // -: left-justified
 ,   TB_PRINTF_FLAG_ZERO             = 4     // 0: fill 0 instead of spaces
 ,   TB_PRINTF_FLAG_PFIX             = 8     // #: add prefix 
+,   TB_PRINTF_FLAG_SHORTEST         = 16    // ~: the shortest round-trip digits for %g
 
 }tb_printf_flag_t;
 
@@ -121,6 +124,23 @@ typedef struct __tb_printf_entry_t
 
 }tb_printf_entry_t;
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the two digits table: "00", "01", ..., "99"
+static tb_char_t const g_digits100[] = 
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -259,12 +279,21 @@ static tb_char_t* tb_printf_int64(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_
         }
         else
         {
-            do 
+            // convert two digits at a time, e.g. 1234 => "34", "12"
+            while (num >= 100)
             {
-                digits[digit_i++] = digits_table[num % e.base] | lomask;
-                num /= e.base;
+                tb_size_t i = (tb_size_t)(num % 100) << 1;
+                num /= 100;
+                digits[digit_i++] = g_digits100[i + 1];
+                digits[digit_i++] = g_digits100[i];
             }
-            while (num);
+            if (num >= 10)
+            {
+                tb_size_t i = (tb_size_t)num << 1;
+                digits[digit_i++] = g_digits100[i + 1];
+                digits[digit_i++] = g_digits100[i];
+            }
+            else digits[digit_i++] = (tb_char_t)('0' + num);
         }
 #endif
     }
@@ -400,12 +429,21 @@ static tb_char_t* tb_printf_int32(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_
         }
         else
         {
-            do 
+            // convert two digits at a time, e.g. 1234 => "34", "12"
+            while (num >= 100)
             {
-                digits[digit_i++] = digits_table[num % e.base] | lomask;
-                num /= e.base;
+                tb_size_t i = (tb_size_t)(num % 100) << 1;
+                num /= 100;
+                digits[digit_i++] = g_digits100[i + 1];
+                digits[digit_i++] = g_digits100[i];
             }
-            while (num);
+            if (num >= 10)
+            {
+                tb_size_t i = (tb_size_t)num << 1;
+                digits[digit_i++] = g_digits100[i + 1];
+                digits[digit_i++] = g_digits100[i];
+            }
+            else digits[digit_i++] = (tb_char_t)('0' + num);
         }
 #endif
     }
@@ -487,96 +525,18 @@ static tb_char_t* tb_printf_int32(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_
     return pb;
 }
 #ifdef TB_CONFIG_TYPE_HAVE_FLOAT
-static tb_char_t* tb_printf_float(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_t e, tb_float_t num)
+static tb_char_t* tb_printf_fp_emit(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_t e, tb_char_t sign, tb_char_t const* digits, tb_int_t n, tb_int_t point, tb_bool_t exp, tb_int_t precision)
 {
-    // digits
-    tb_char_t   ints[32] = {0};
-    tb_char_t   decs[32] = {0};
-    tb_int_t    ints_i = 0, decs_i = 0;
-
-    // for inf nan
-    if (tb_isinff(num))
-    {
-        if (pb < pe && num < 0) *pb++ = '-';
-        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'I' : 'i';
-        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'N' : 'n';
-        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'F' : 'f';
-        return pb;
-    }
-    else if (tb_isnanf(num))
-    {
-        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'N' : 'n';
-        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'A' : 'a';
-        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'N' : 'n';
-        return pb;
-    }
-
-    // sign: + -
-    tb_char_t sign = 0;
-    if (e.extra & TB_PRINTF_EXTRA_SIGNED)
-    {
-        if (num < 0) 
-        {
-            sign = '-';
-            --e.width;
-        }
-        else if (e.flags & TB_PRINTF_FLAG_PLUS)
-        {
-            sign = '+';
-            --e.width;
-        }
-    }
-
-    // adjust sign
-    if (num < 0) num = -num;
-
-    // default precision: 6
-    if (e.precision <= 0) e.precision = 6;
-
-    // round? i.dddddddd5 => i.ddddddde
-    tb_uint32_t p = 1;
-    tb_size_t   n = e.precision;
-    while (n--) p *= 10;
-    if (((tb_uint32_t)(num * p * 10) % 10) > 4) 
-        num += 1.0f / (tb_float_t)p;
-
-    // get integer & decimal
-    tb_int32_t integer = (tb_int32_t)num;
-    tb_float_t decimal = num - integer;
-
-    // convert integer => digits string in reverse order
-    if (integer == 0) ints[ints_i++] = '0';
-    else 
-    {
-        if (integer < 0) integer = -integer; 
-        do 
-        {
-            ints[ints_i++] = (integer % 10) + '0';
-            integer /= 10;
-        }
-        while (integer);
-    }
+    // the decimal exponent, value = d.ddd * 10^exp10
+    tb_int_t exp10 = n? point - 1 : 0;
+    tb_int_t exp10_abs = exp10 < 0? -exp10 : exp10;
 
-    // convert decimal => digits string in positive order
-    if (decimal == 0) decs[decs_i++] = '0';
-    else 
-    {
-        tb_long_t d = (tb_long_t)(decimal * 10);
-        do 
-        {
-            decs[decs_i++] = (tb_char_t)(d + (tb_long_t)'0');
-            decimal = decimal * 10 - d;
-            d = (tb_long_t)(decimal * 10);
-        }
-        while (decs_i < e.precision);
-    }
-
-    // adjust precision
-    if (decs_i > e.precision) 
-        decs_i = e.precision;
+    // has the decimal point? e.g. "1", "1.", "1.5"
+    tb_bool_t dot = precision > 0 || (e.flags & TB_PRINTF_FLAG_PFIX);
 
-    // fill spaces at left side, e.g. "   0.31415926"
-    e.width -= (tb_int_t)(ints_i + 1 + e.precision);
+    // fill spaces at left side, e.g. "   3.1415926" or "   3.14e+00"
+    if (exp) e.width -= 1 + (dot? 1 + precision : 0) + 2 + (exp10_abs >= 100? 3 : 2);
+    else e.width -= (point > 0? point : 1) + (dot? 1 + precision : 0);
     if (!(e.flags & (TB_PRINTF_FLAG_LEFT + TB_PRINTF_FLAG_ZERO)))
     {
         while (--e.width >= 0)
@@ -594,21 +554,45 @@ static tb_char_t* tb_printf_float(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_
             if (pb < pe) *pb++ = c;
     }
 
-    // append integer
-    while (--ints_i >= 0) 
-        if (pb < pe) *pb++ = ints[ints_i];
-
-    // append .
-    if (pb < pe) *pb++ = '.';
-
-    // append decimal
-    tb_int_t decs_n = decs_i;
-    while (--decs_i >= 0) 
-        if (pb < pe) *pb++ = decs[decs_n - decs_i - 1];
+    // the omitted digits are all zeros
+    tb_int_t i = 0;
+    if (exp)
+    {
+        // append d.ddd
+        if (pb < pe) *pb++ = n? digits[0] : '0';
+        if (dot && pb < pe) *pb++ = '.';
+        for (i = 1; i <= precision; i++)
+            if (pb < pe) *pb++ = i < n? digits[i] : '0';
+
+        // append e+dd
+        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'E' : 'e';
+        if (pb < pe) *pb++ = exp10 < 0? '-' : '+';
+        if (exp10_abs >= 100)
+        {
+            if (pb < pe) *pb++ = (tb_char_t)('0' + exp10_abs / 100);
+            exp10_abs %= 100;
+        }
+        if (pb < pe) *pb++ = g_digits100[exp10_abs << 1];
+        if (pb < pe) *pb++ = g_digits100[(exp10_abs << 1) + 1];
+    }
+    else
+    {
+        // append integer
+        if (point > 0)
+        {
+            for (i = 0; i < point; i++)
+                if (pb < pe) *pb++ = i < n? digits[i] : '0';
+        }
+        else if (pb < pe) *pb++ = '0';
 
-    // fill 0 if precision is larger, e.g. "0.3140000"
-    while (decs_n <= --e.precision) 
-        if (pb < pe) *pb++ = '0';
+        // append decimal
+        if (dot && pb < pe) *pb++ = '.';
+        for (i = 0; i < precision; i++)
+        {
+            tb_int_t j = point + i;
+            if (pb < pe) *pb++ = (j >= 0 && j < n)? digits[j] : '0';
+        }
+    }
 
     // trailing space padding for left-justified flags, e.g. "0.31415926   "
     while (--e.width >= 0)
@@ -616,13 +600,39 @@ static tb_char_t* tb_printf_float(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_
 
     return pb;
 }
-static tb_char_t* tb_printf_double(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_t e, tb_double_t num)
+static tb_char_t* tb_printf_fp_format(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_t e, tb_char_t sign, tb_char_t const* digits, tb_int_t n, tb_int_t point, tb_bool_t single)
+{
+    // %f or %e?
+    tb_int_t precision = e.precision < 0? 6 : e.precision;
+    if (!(e.extra & TB_PRINTF_EXTRA_GENERAL))
+        return tb_printf_fp_emit(pb, pe, e, sign, digits, n, point, e.extra & TB_PRINTF_EXTRA_EXP, precision);
+
+    /* %g, use the exponent form if the exponent is less than -4 or not less than the precision
+     *
+     * @note "%~g" uses the shortest representation, e.g. 0.1 => "0.1", 1e100 => "1e+100"
+     */
+    tb_int_t  exp10 = n? point - 1 : 0;
+    tb_bool_t shortest = (e.flags & TB_PRINTF_FLAG_SHORTEST)? tb_true : tb_false;
+    if (shortest) precision = single? 9 : 17;
+    else if (!precision) precision = 1;
+    tb_bool_t exp = exp10 < -4 || exp10 >= precision;
+
+    // remove the trailing zeros if no '#'
+    if (shortest || !(e.flags & TB_PRINTF_FLAG_PFIX)) precision = exp? n - 1 : n - point;
+    else precision = exp? precision - 1 : precision - 1 - exp10;
+    if (precision < 0) precision = 0;
+    return tb_printf_fp_emit(pb, pe, e, sign, digits, n, point, exp, precision);
+}
+static tb_char_t* tb_printf_fp_exact(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_t e, tb_char_t sign, tb_double_t num, tb_bool_t fixed, tb_int_t ndigits, tb_bool_t single)
+{
+    // get the exact digits, it is slower and needs the larger digits buffer
+    tb_char_t   digits[TB_DTOA_EXACT_MAXN];
+    tb_int_t    point = 0;
+    tb_int_t    n = (tb_int_t)tb_dtoa_exact(num, fixed, ndigits, digits, &point);
+    return tb_printf_fp_format(pb, pe, e, sign, digits, n, point, single);
+}
+static tb_char_t* tb_printf_fp(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_t e, tb_double_t num, tb_bool_t single)
 {
-    // digits
-    tb_char_t   ints[64] = {0};
-    tb_char_t   decs[64] = {0};
-    tb_int_t    ints_i = 0, decs_i = 0;
-
     // for inf nan
     if (tb_isinf(num))
     {
@@ -640,12 +650,13 @@ static tb_char_t* tb_printf_double(tb_char_t* pb, tb_char_t* pe, tb_printf_entry
         return pb;
     }
 
-
     // sign: + -
+    tb_ieee_double_t ieee;
+    ieee.d = num;
     tb_char_t sign = 0;
     if (e.extra & TB_PRINTF_EXTRA_SIGNED)
     {
-        if (num < 0) 
+        if (ieee.i.h >> 31) 
         {
             sign = '-';
             --e.width;
@@ -660,91 +671,58 @@ static tb_char_t* tb_printf_double(tb_char_t* pb, tb_char_t* pe, tb_printf_entry
     // adjust sign
     if (num < 0) num = -num;
 
-    // default precision: 6
-    if (e.precision <= 0) e.precision = 6;
-
-    // round? i.dddddddd5 => i.ddddddde
-    tb_uint64_t p = 1;
-    tb_size_t   n = e.precision;
-    while (n--) p *= 10;
-    if (((tb_uint64_t)(num * p * 10) % 10) > 4) 
-        num += 1. / (tb_double_t)p;
-
-    // get integer & decimal
-    tb_int64_t integer = (tb_int64_t)num;
-    tb_double_t decimal = num - integer;
-
-    // convert integer => digits string in reverse order
-    if (integer == 0) ints[ints_i++] = '0';
-    else 
-    {
-        if (integer < 0) integer = -integer; 
-        do 
-        {
-            ints[ints_i++] = (integer % 10) + '0';
-            integer /= 10;
-        }
-        while (integer);
-    }
-
-    // convert decimal => digits string in positive order
-    if (decimal == 0) decs[decs_i++] = '0';
-    else 
-    {
-        tb_long_t d = (tb_long_t)(decimal * 10);
-        do 
-        {
-            decs[decs_i++] = (tb_char_t)(d + (tb_long_t)'0');
-            decimal = decimal * 10 - d;
-            d = (tb_long_t)(decimal * 10);
-        }
-        while (decs_i < e.precision);
-    }
-
-    // adjust precision
-    if (decs_i > e.precision) 
-        decs_i = e.precision;
-
-    // fill spaces at left side, e.g. "   0.31415926"
-    e.width -= (tb_int_t)(ints_i + 1 + e.precision);
-    if (!(e.flags & (TB_PRINTF_FLAG_LEFT + TB_PRINTF_FLAG_ZERO)))
+    // zero? 
+    tb_char_t   digits[TB_DTOA_SHORTEST_MAXN];
+    tb_int_t    n = 0;
+    tb_int_t    point = 1;
+    if (num == 0) return tb_printf_fp_format(pb, pe, e, sign, digits, n, point, single);
+
+    // get the shortest digits first, value = 0.d1d2...dn * 10^point
+    n = (tb_int_t)tb_dtoa_shortest(num, single, digits, &point);
+
+    // %~g? use the shortest representation directly
+    if ((e.extra & TB_PRINTF_EXTRA_GENERAL) && (e.flags & TB_PRINTF_FLAG_SHORTEST))
+        return tb_printf_fp_format(pb, pe, e, sign, digits, n, point, single);
+
+    // get the rounding position, fixed: the digits count after the decimal point, otherwise: the significant digits count
+    tb_bool_t fixed = !(e.extra & (TB_PRINTF_EXTRA_EXP | TB_PRINTF_EXTRA_GENERAL));
+    tb_int_t  ndigits = e.precision < 0? 6 : e.precision;
+    if (e.extra & TB_PRINTF_EXTRA_EXP) ndigits++;
+    else if ((e.extra & TB_PRINTF_EXTRA_GENERAL) && !ndigits) ndigits = 1;
+
+    /* the shortest digits are the correctly rounded result if they fit the rounding position
+     * and the ulp is not larger than the rounding unit, it is the most common case, e.g. "%.6f" and 3.14
+     *
+     * otherwise, we need the exact digits, e.g. "%.6f" and 1e23 => "99999999999999991611392.000000"
+     */
+    tb_int64_t keep = fixed? (tb_int64_t)point + ndigits : ndigits;
+    tb_int64_t r = point - keep - 1;
+    tb_int_t   e2;
+    if (single)
     {
-        while (--e.width >= 0)
-            if (pb < pe) *pb++ = ' ';
+        tb_ieee_float_t ieeef;
+        ieeef.f = (tb_float_t)num;
+        tb_uint32_t E = (ieeef.i >> 23) & 0xff;
+        e2 = E? (tb_int_t)E - 150 : -149;
     }
-
-    // append sign: + / -
-    if (sign && (pb < pe)) *pb++ = sign;
-
-    // fill 0 or spaces, e.g. "00003.1415926"
-    if (!(e.flags & TB_PRINTF_FLAG_LEFT))
+    else
     {
-        tb_char_t c = (e.flags & TB_PRINTF_FLAG_ZERO)? '0' : ' ';
-        while (--e.width >= 0)
-            if (pb < pe) *pb++ = c;
+        tb_uint32_t E = (ieee.i.h >> 20) & 0x7ff;
+        e2 = E? (tb_int_t)E - 1075 : -1074;
     }
+    if (n <= keep && (r >= 0? e2 <= 3 * r : (tb_int64_t)e2 * 1000 <= r * 3322))
+        return tb_printf_fp_format(pb, pe, e, sign, digits, n, point, single);
 
-    // append integer
-    while (--ints_i >= 0) 
-        if (pb < pe) *pb++ = ints[ints_i];
-
-    // append .
-    if (pb < pe) *pb++ = '.';
-
-    // append decimal
-    tb_int_t decs_n = decs_i;
-    while (--decs_i >= 0) 
-        if (pb < pe) *pb++ = decs[decs_n - decs_i - 1];
-
-    // fill 0 if precision is larger, e.g. "0.3140000"
-    while (decs_n <= --e.precision) 
-        if (pb < pe) *pb++ = '0';
-
-    // trailing space padding for left-justified flags, e.g. "0.31415926   "
-    while (--e.width >= 0)
-        if (pb < pe) *pb++ = ' ';
-
-    return pb;
+    // get the exact digits
+    return tb_printf_fp_exact(pb, pe, e, sign, num, fixed, ndigits, single);
+}
+static tb_char_t* tb_printf_float(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_t e, tb_float_t num)
+{
+    return tb_printf_fp(pb, pe, e, (tb_double_t)num, tb_true);
+}
+static tb_char_t* tb_printf_double(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_t e, tb_double_t num)
+{
+    return tb_printf_fp(pb, pe, e, num, tb_false);
 }
 #endif
 // get a printf format entry
@@ -797,6 +775,7 @@ static tb_int_t tb_printf_entry(tb_char_t const* fmt, tb_printf_entry_t* e)
         case '-': e->flags |= TB_PRINTF_FLAG_LEFT; break;
         case '0': e->flags |= TB_PRINTF_FLAG_ZERO; break;
         case '#': e->flags |= TB_PRINTF_FLAG_PFIX; break;
+        case '~': e->flags |= TB_PRINTF_FLAG_SHORTEST; break;
         default: is_found = tb_false; break;
         }
         if (is_found == tb_false) break;
@@ -931,6 +910,13 @@ get_qualifier:
         e->extra |= TB_PRINTF_EXTRA_SIGNED;
         e->extra |= TB_PRINTF_EXTRA_EXP;
         break;
+    case 'G':
+        e->extra |= TB_PRINTF_EXTRA_UPPER;
+    case 'g':
+        e->type = TB_PRINTF_TYPE_FLOAT;
+        e->extra |= TB_PRINTF_EXTRA_SIGNED;
+        e->extra |= TB_PRINTF_EXTRA_GENERAL;
+        break;
 #endif
     case '{':
         {
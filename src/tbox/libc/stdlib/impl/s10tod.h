@@ -0,0 +1,62 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        s10tod.h
+ *
+ */
+#ifndef TB_LIBC_STDLIB_IMPL_S10TOD_H
+#define TB_LIBC_STDLIB_IMPL_S10TOD_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+
+/* convert the decimal string to the nearest double 
+ *
+ * it tries the exact fast path of the small values first, 
+ * and then the eisel-lemire algorithm, and falls back to the big decimal for the rare ambiguous cases.
+ *
+ * @param s         the string, e.g. "-1.5e-3"
+ * @param end       the end of the parsed string, optional
+ *
+ * @return          the double number
+ */
+tb_double_t         tb_s10tod_impl(tb_char_t const* s, tb_char_t const** end);
+
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -218,7 +218,15 @@ tb_double_t         tb_s8tod(tb_char_t const* s);
 
 /*! convert the decimal string to double
  *
- * .e.g "9" => 9
+ * <pre>
+ * .e.g 
+ *
+ * "9"          => 9
+ * "-1.5e-3"    => -0.0015
+ * "inf"        => inf
+ * </pre>
+ *
+ * @note it will be rounded to the nearest double correctly
  *
  * @param s         the string
  *
@@ -46,6 +46,114 @@
 // the allocator 
 __tb_extern_c__ tb_allocator_ref_t  g_allocator = tb_null;
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline_force__ tb_void_t tb_allocator_enter(tb_allocator_ref_t allocator)
+{
+    // try entering it first, the contention will be counted if the lock is occupied
+    if (!tb_spinlock_enter_try_without_profiler(&allocator->lock))
+    {
+        tb_spinlock_enter(&allocator->lock);
+        allocator->stat.contention_count++;
+    }
+}
+static __tb_inline_force__ tb_bool_t tb_allocator_sized(tb_allocator_ref_t allocator)
+{
+    // the native and custom allocators have no data head
+    return allocator->type != TB_ALLOCATOR_NATIVE && allocator->type != TB_ALLOCATOR_NONE;
+}
+static __tb_inline_force__ tb_size_t tb_allocator_data_size(tb_allocator_ref_t allocator, tb_cpointer_t data)
+{
+    // get the data size from the data head
+    return (data && tb_allocator_sized(allocator))? ((tb_pool_data_head_t const*)data)[-1].size : 0;
+}
+static __tb_inline_force__ tb_allocator_stat_class_t* tb_allocator_stat_class(tb_allocator_ref_t allocator, tb_size_t size)
+{
+    // compute the size class, <=16B, <=32B, <=64B, ..., <=1MB, >1MB
+    tb_size_t index = 0;
+    if (size > 16) 
+    {
+        tb_uint32_t bits = (tb_uint32_t)tb_min(size - 1, (1 << 21) - 1);
+        index = 31 - tb_bits_cl0_u32_be(bits) - 3;
+        if (index >= TB_ALLOCATOR_STAT_CLASS_MAXN) index = TB_ALLOCATOR_STAT_CLASS_MAXN - 1;
+    }
+    return &allocator->stat.classes[index];
+}
+static __tb_inline_force__ tb_void_t tb_allocator_stat_malloc(tb_allocator_ref_t allocator, tb_pointer_t data, tb_size_t size)
+{
+    // the real size of the sized allocator, it will be same as the freed size
+    if (tb_allocator_sized(allocator)) size = tb_allocator_data_size(allocator, data);
+
+    // update the statistics
+    tb_allocator_stat_ref_t     stat = &allocator->stat;
+    tb_allocator_stat_class_t*  cls = tb_allocator_stat_class(allocator, size);
+    stat->malloc_count++;
+    stat->total_size += size;
+    cls->malloc_count++;
+    if (tb_allocator_sized(allocator))
+    {
+        stat->live_size += size;
+        cls->live_size += size;
+        if (stat->live_size > stat->peak_size) stat->peak_size = stat->live_size;
+    }
+
+    // sample it
+    if (allocator->profiler) tb_heap_profiler_malloc((tb_heap_profiler_ref_t)allocator->profiler, data, size);
+}
+static __tb_inline_force__ tb_void_t tb_allocator_stat_ralloc(tb_allocator_ref_t allocator, tb_pointer_t data, tb_size_t size_old, tb_pointer_t data_new, tb_size_t size)
+{
+    // the real size of the sized allocator, it will be same as the freed size
+    if (tb_allocator_sized(allocator)) size = tb_allocator_data_size(allocator, data_new);
+
+    // update the statistics
+    tb_allocator_stat_ref_t stat = &allocator->stat;
+    stat->ralloc_count++;
+    if (size > size_old) stat->total_size += size - size_old;
+    if (tb_allocator_sized(allocator))
+    {
+        stat->live_size += size - size_old;
+        tb_allocator_stat_class(allocator, size_old)->live_size -= size_old;
+        tb_allocator_stat_class(allocator, size)->live_size += size;
+        if (stat->live_size > stat->peak_size) stat->peak_size = stat->live_size;
+    }
+
+    // sample it again
+    if (allocator->profiler)
+    {
+        tb_heap_profiler_free((tb_heap_profiler_ref_t)allocator->profiler, data);
+        tb_heap_profiler_malloc((tb_heap_profiler_ref_t)allocator->profiler, data_new, size);
+    }
+}
+static __tb_inline_force__ tb_void_t tb_allocator_stat_free(tb_allocator_ref_t allocator, tb_pointer_t data, tb_size_t size)
+{
+    // update the statistics
+    tb_allocator_stat_ref_t stat = &allocator->stat;
+    stat->free_count++;
+    if (tb_allocator_sized(allocator))
+    {
+        tb_allocator_stat_class_t* cls = tb_allocator_stat_class(allocator, size);
+        stat->live_size -= size;
+        cls->live_size -= size;
+        cls->free_count++;
+    }
+
+    // remove the sampled data
+    if (allocator->profiler) tb_heap_profiler_free((tb_heap_profiler_ref_t)allocator->profiler, data);
+}
+static tb_bool_t tb_allocator_profile_writ(tb_file_ref_t file, tb_byte_t const* data, tb_size_t size)
+{
+    // write all data
+    tb_size_t writ = 0;
+    while (writ < size)
+    {
+        tb_long_t real = tb_file_writ(file, data + writ, size - writ);
+        tb_check_break(real > 0);
+        writ += real;
+    }
+    return writ == size;
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -67,13 +175,16 @@ tb_pointer_t tb_allocator_malloc_(tb_allocator_ref_t allocator, tb_size_t size _
     tb_assert_and_check_return_val(allocator, tb_null);
 
     // enter
-    tb_spinlock_enter(&allocator->lock);
+    tb_allocator_enter(allocator);
 
     // malloc it
     tb_pointer_t data = tb_null;
     if (allocator->malloc) data = allocator->malloc(allocator, size __tb_debug_args__);
     else if (allocator->large_malloc) data = allocator->large_malloc(allocator, size, tb_null __tb_debug_args__);
 
+    // update the statistics
+    if (data) tb_allocator_stat_malloc(allocator, data, size);
+
     // trace
     tb_trace_d("malloc(%lu): %p at %s(): %d, %s", size, data __tb_debug_args__);
 
@@ -129,13 +240,23 @@ tb_pointer_t tb_allocator_ralloc_(tb_allocator_ref_t allocator, tb_pointer_t dat
     tb_assert_and_check_return_val(allocator, tb_null);
 
     // enter
-    tb_spinlock_enter(&allocator->lock);
+    tb_allocator_enter(allocator);
+
+    // the old size
+    tb_size_t size_old = tb_allocator_data_size(allocator, data);
 
     // ralloc it
     tb_pointer_t data_new = tb_null;
     if (allocator->ralloc) data_new = allocator->ralloc(allocator, data, size __tb_debug_args__);
     else if (allocator->large_ralloc) data_new = allocator->large_ralloc(allocator, data, size, tb_null __tb_debug_args__);
 
+    // update the statistics
+    if (data_new)
+    {
+        if (data) tb_allocator_stat_ralloc(allocator, data, size_old, data_new, size);
+        else tb_allocator_stat_malloc(allocator, data_new, size);
+    }
+
     // trace
     tb_trace_d("ralloc(%p, %lu): %p at %s(): %d, %s", data, size, data_new __tb_debug_args__);
 
@@ -169,16 +290,22 @@ tb_bool_t tb_allocator_free_(tb_allocator_ref_t allocator, tb_pointer_t data __t
     tb_assert_and_check_return_val(allocator, tb_false);
 
     // enter
-    tb_spinlock_enter(&allocator->lock);
+    tb_allocator_enter(allocator);
 
     // trace
     tb_trace_d("free(%p): at %s(): %d, %s", data __tb_debug_args__);
 
+    // the data size
+    tb_size_t size = tb_allocator_data_size(allocator, data);
+
     // free it
     tb_bool_t ok = tb_false;
     if (allocator->free) ok = allocator->free(allocator, data __tb_debug_args__);
     else if (allocator->large_free) ok = allocator->large_free(allocator, data __tb_debug_args__);
 
+    // update the statistics
+    if (ok) tb_allocator_stat_free(allocator, data, size);
+
     // failed? dump it
 #ifdef __tb_debug__
     if (!ok) 
@@ -206,7 +333,7 @@ tb_pointer_t tb_allocator_large_malloc_(tb_allocator_ref_t allocator, tb_size_t
     tb_assert_and_check_return_val(allocator, tb_null);
 
     // enter
-    tb_spinlock_enter(&allocator->lock);
+    tb_allocator_enter(allocator);
 
     // malloc it
     tb_pointer_t data = tb_null;
@@ -218,6 +345,9 @@ tb_pointer_t tb_allocator_large_malloc_(tb_allocator_ref_t allocator, tb_size_t
         data = allocator->malloc(allocator, size __tb_debug_args__);
     }
 
+    // update the statistics
+    if (data) tb_allocator_stat_malloc(allocator, data, real? *real : size);
+
     // trace
     tb_trace_d("large_malloc(%lu): %p at %s(): %d, %s", size, data __tb_debug_args__);
 
@@ -274,7 +404,10 @@ tb_pointer_t tb_allocator_large_ralloc_(tb_allocator_ref_t allocator, tb_pointer
     tb_assert_and_check_return_val(allocator, tb_null);
 
     // enter
-    tb_spinlock_enter(&allocator->lock);
+    tb_allocator_enter(allocator);
+
+    // the old size
+    tb_size_t size_old = tb_allocator_data_size(allocator, data);
 
     // ralloc it
     tb_pointer_t data_new = tb_null;
@@ -286,6 +419,13 @@ tb_pointer_t tb_allocator_large_ralloc_(tb_allocator_ref_t allocator, tb_pointer
         data_new = allocator->ralloc(allocator, data, size __tb_debug_args__);
     }
 
+    // update the statistics
+    if (data_new)
+    {
+        if (data) tb_allocator_stat_ralloc(allocator, data, size_old, data_new, real? *real : size);
+        else tb_allocator_stat_malloc(allocator, data_new, real? *real : size);
+    }
+
     // trace
     tb_trace_d("large_ralloc(%p, %lu): %p at %s(): %d, %s", data, size, data_new __tb_debug_args__);
 
@@ -320,16 +460,22 @@ tb_bool_t tb_allocator_large_free_(tb_allocator_ref_t allocator, tb_pointer_t da
     tb_assert_and_check_return_val(allocator, tb_false);
 
     // enter
-    tb_spinlock_enter(&allocator->lock);
+    tb_allocator_enter(allocator);
 
     // trace
     tb_trace_d("large_free(%p): at %s(): %d, %s", data __tb_debug_args__);
 
+    // the data size
+    tb_size_t size = tb_allocator_data_size(allocator, data);
+
     // free it
     tb_bool_t ok = tb_false;
     if (allocator->large_free) ok = allocator->large_free(allocator, data __tb_debug_args__);
     else if (allocator->free) ok = allocator->free(allocator, data __tb_debug_args__);
 
+    // update the statistics
+    if (ok) tb_allocator_stat_free(allocator, data, size);
+
     // failed? dump it
 #ifdef __tb_debug__
     if (!ok) 
@@ -477,6 +623,12 @@ tb_void_t tb_allocator_clear(tb_allocator_ref_t allocator)
     // clear it
     if (allocator->clear) allocator->clear(allocator);
 
+    // all data have been released
+    tb_size_t i = 0;
+    allocator->stat.live_size = 0;
+    for (i = 0; i < TB_ALLOCATOR_STAT_CLASS_MAXN; i++) allocator->stat.classes[i].live_size = 0;
+    if (allocator->profiler) tb_heap_profiler_clear((tb_heap_profiler_ref_t)allocator->profiler);
+
     // leave
     tb_spinlock_leave(&allocator->lock);
 }
@@ -488,9 +640,155 @@ tb_void_t tb_allocator_exit(tb_allocator_ref_t allocator)
     // clear it first
     tb_allocator_clear(allocator);
 
+    // stop the heap profiler
+    tb_allocator_profile_stop(allocator);
+
     // exit it
     if (allocator->exit) allocator->exit(allocator);
 }
+tb_bool_t tb_allocator_stat(tb_allocator_ref_t allocator, tb_allocator_stat_ref_t stat)
+{
+    // check
+    tb_assert_and_check_return_val(allocator && stat, tb_false);
+
+    // enter
+    tb_spinlock_enter(&allocator->lock);
+
+    // get the statistics
+    *stat = allocator->stat;
+
+    // leave
+    tb_spinlock_leave(&allocator->lock);
+
+    // ok
+    return tb_true;
+}
+tb_void_t tb_allocator_stat_dump(tb_allocator_ref_t allocator)
+{
+    // get the statistics, we cannot trace it in the lock because the trace may allocate data
+    tb_allocator_stat_t stat;
+    tb_check_return(tb_allocator_stat(allocator, &stat));
+
+    // trace
+    tb_trace_i("allocator: %p, type: %lu", allocator, allocator->type);
+    tb_trace_i("malloc: %lu, ralloc: %lu, free: %lu, contention: %lu", stat.malloc_count, stat.ralloc_count, stat.free_count, stat.contention_count);
+    tb_trace_i("live: %lu, peak: %lu, total: %llu", stat.live_size, stat.peak_size, stat.total_size);
+
+    // trace the size classes
+    tb_size_t i = 0;
+    for (i = 0; i < TB_ALLOCATOR_STAT_CLASS_MAXN; i++)
+    {
+        tb_allocator_stat_class_t const* cls = &stat.classes[i];
+        if (!cls->malloc_count) continue;
+        if (i + 1 < TB_ALLOCATOR_STAT_CLASS_MAXN)
+            tb_trace_i("    [<=%lu]: malloc: %lu, free: %lu, live: %lu", (tb_size_t)16 << i, cls->malloc_count, cls->free_count, cls->live_size);
+        else tb_trace_i("    [>%lu]: malloc: %lu, free: %lu, live: %lu", (tb_size_t)8 << i, cls->malloc_count, cls->free_count, cls->live_size);
+    }
+}
+tb_bool_t tb_allocator_profile_start(tb_allocator_ref_t allocator, tb_size_t rate)
+{
+    // check
+    tb_assert_and_check_return_val(allocator, tb_false);
+
+    // init profiler
+    tb_heap_profiler_ref_t profiler = tb_heap_profiler_init(rate);
+    tb_assert_and_check_return_val(profiler, tb_false);
+
+    // enter
+    tb_spinlock_enter(&allocator->lock);
+
+    // start it if it has been not started
+    tb_bool_t ok = !allocator->profiler;
+    if (ok) allocator->profiler = (tb_pointer_t)profiler;
+
+    // leave
+    tb_spinlock_leave(&allocator->lock);
+
+    // started? exit it
+    if (!ok) tb_heap_profiler_exit(profiler);
+    return ok;
+}
+tb_void_t tb_allocator_profile_stop(tb_allocator_ref_t allocator)
+{
+    // check
+    tb_assert_and_check_return(allocator);
+
+    // enter
+    tb_spinlock_enter(&allocator->lock);
+
+    // stop it
+    tb_heap_profiler_ref_t profiler = (tb_heap_profiler_ref_t)allocator->profiler;
+    allocator->profiler = tb_null;
+
+    // leave
+    tb_spinlock_leave(&allocator->lock);
+
+    // exit profiler
+    if (profiler) tb_heap_profiler_exit(profiler);
+}
+tb_bool_t tb_allocator_profile_dump(tb_allocator_ref_t allocator, tb_char_t const* path)
+{
+    // check
+    tb_assert_and_check_return_val(allocator && path, tb_false);
+
+    // enter
+    tb_spinlock_enter(&allocator->lock);
+
+    // make the profile data, we cannot write it to file in the lock
+    tb_size_t   size = 0;
+    tb_char_t*  data = allocator->profiler? tb_heap_profiler_make((tb_heap_profiler_ref_t)allocator->profiler, &size) : tb_null;
+
+    // leave
+    tb_spinlock_leave(&allocator->lock);
+
+    // no profile?
+    tb_check_return_val(data, tb_false);
+
+    // done
+    tb_bool_t       ok = tb_false;
+    tb_file_ref_t   file = tb_null;
+    tb_file_ref_t   maps = tb_null;
+    do
+    {
+        // init file
+        file = tb_file_init(path, TB_FILE_MODE_RW | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC);
+        tb_assert_and_check_break(file);
+
+        // write the profile data
+        if (!tb_allocator_profile_writ(file, (tb_byte_t const*)data, size)) break;
+
+        // write the mapped libraries for symbolizing the addresses
+        maps = tb_file_init("/proc/self/maps", TB_FILE_MODE_RO);
+        if (maps)
+        {
+            tb_char_t const* head = "\nMAPPED_LIBRARIES:\n";
+            if (!tb_allocator_profile_writ(file, (tb_byte_t const*)head, tb_strlen(head))) break;
+
+            // the size of the proc file is always zero, so we need read it until the end
+            tb_byte_t   line[4096];
+            tb_long_t   real = 0;
+            while ((real = tb_file_read(maps, line, sizeof(line))) > 0)
+            {
+                if (!tb_allocator_profile_writ(file, line, real)) break;
+            }
+            tb_check_break(real <= 0);
+        }
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // exit files
+    if (maps) tb_file_exit(maps);
+    if (file) tb_file_exit(file);
+
+    // exit data
+    tb_native_memory_free(data);
+
+    // ok?
+    return ok;
+}
 #ifdef __tb_debug__
 tb_void_t tb_allocator_dump(tb_allocator_ref_t allocator)
 {
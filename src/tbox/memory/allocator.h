@@ -67,6 +67,9 @@ __tb_extern_c_enter__
 #define tb_allocator_align_ralloc(allocator, data, size, align)     tb_allocator_align_ralloc_(allocator, (tb_pointer_t)(data), size, align __tb_debug_vals__)
 #define tb_allocator_align_free(allocator, data)                    tb_allocator_align_free_(allocator, (tb_pointer_t)(data) __tb_debug_vals__)
 
+/// the size class count of the allocator statistics, <=16B, <=32B, <=64B, ..., <=1MB, >1MB
+#define TB_ALLOCATOR_STAT_CLASS_MAXN                                (18)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -80,9 +83,57 @@ typedef enum __tb_allocator_type_e
 ,   TB_ALLOCATOR_STATIC     = 4
 ,   TB_ALLOCATOR_LARGE      = 5
 ,   TB_ALLOCATOR_SMALL      = 6
+,   TB_ALLOCATOR_ARENA      = 7
 
 }tb_allocator_type_e;
 
+/// the allocator size class statistics type
+typedef struct __tb_allocator_stat_class_t
+{
+    /// the malloc count
+    tb_size_t               malloc_count;
+
+    /// the free count
+    tb_size_t               free_count;
+
+    /// the live size
+    tb_size_t               live_size;
+
+}tb_allocator_stat_class_t;
+
+/*! the allocator statistics type
+ *
+ * @note the live size and the free counts of the size classes are not tracked for the native and custom allocators, 
+ * because the size of the freed data is unknown.
+ */
+typedef struct __tb_allocator_stat_t
+{
+    /// the malloc count
+    tb_size_t                   malloc_count;
+
+    /// the ralloc count
+    tb_size_t                   ralloc_count;
+
+    /// the free count
+    tb_size_t                   free_count;
+
+    /// the live size
+    tb_size_t                   live_size;
+
+    /// the peak live size
+    tb_size_t                   peak_size;
+
+    /// the total allocated size
+    tb_hize_t                   total_size;
+
+    /// the lock contention count
+    tb_size_t                   contention_count;
+
+    /// the size classes
+    tb_allocator_stat_class_t   classes[TB_ALLOCATOR_STAT_CLASS_MAXN];
+
+}tb_allocator_stat_t, *tb_allocator_stat_ref_t;
+
 /// the allocator type
 typedef struct __tb_allocator_t
 {
@@ -92,6 +143,12 @@ typedef struct __tb_allocator_t
     /// the lock
     tb_spinlock_t           lock;
 
+    /// the statistics, it is always enabled and protected by the lock
+    tb_allocator_stat_t     stat;
+
+    /// the heap profiler
+    tb_pointer_t            profiler;
+
     /*! malloc data
      *
      * @param allocator     the allocator 
@@ -399,6 +456,61 @@ tb_void_t               tb_allocator_clear(tb_allocator_ref_t allocator);
  */
 tb_void_t               tb_allocator_exit(tb_allocator_ref_t allocator);
 
+/*! get the statistics of the allocator
+ *
+ * @param allocator     the allocator 
+ * @param stat          the statistics
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_allocator_stat(tb_allocator_ref_t allocator, tb_allocator_stat_ref_t stat);
+
+/*! dump the statistics of the allocator, it is also available for the release mode
+ *
+ * @param allocator     the allocator 
+ */
+tb_void_t               tb_allocator_stat_dump(tb_allocator_ref_t allocator);
+
+/*! start the sampling heap profiler of the allocator
+ *
+ * records the backtrace of one allocation per the given sample bytes on average,
+ * only the allocations from this allocator will be sampled, not the inner allocators.
+ *
+ * @code
+    // start the profiler of the global allocator
+    tb_allocator_profile_start(tb_allocator(), 0);
+
+    // ...
+
+    // dump the heap profile, and show it by `pprof --text ./app /tmp/app.heap`
+    tb_allocator_profile_dump(tb_allocator(), "/tmp/app.heap");
+
+    // stop it
+    tb_allocator_profile_stop(tb_allocator());
+ * @endcode
+ *
+ * @param allocator     the allocator 
+ * @param rate          the sample rate (bytes), use the default rate (512KB) if be zero
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_allocator_profile_start(tb_allocator_ref_t allocator, tb_size_t rate);
+
+/*! stop the sampling heap profiler of the allocator
+ *
+ * @param allocator     the allocator 
+ */
+tb_void_t               tb_allocator_profile_stop(tb_allocator_ref_t allocator);
+
+/*! dump the pprof-compatible heap profile of the allocator to the given file
+ *
+ * @param allocator     the allocator 
+ * @param path          the profile file path
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_allocator_profile_dump(tb_allocator_ref_t allocator, tb_char_t const* path);
+
 #ifdef __tb_debug__
 /*! dump it
  *
@@ -0,0 +1,538 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        arena_allocator.c
+ * @ingroup     memory
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "arena_allocator"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "arena_allocator.h"
+#include "impl/prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the chunk head size
+#define TB_ARENA_ALLOCATOR_CHUNK_HEAD_SIZE          tb_align(sizeof(tb_arena_allocator_chunk_t), TB_POOL_DATA_ALIGN)
+
+// the allocator size
+#define TB_ARENA_ALLOCATOR_SIZE                     tb_align(sizeof(tb_arena_allocator_t), TB_POOL_DATA_ALIGN)
+
+// the chunk data
+#define tb_arena_allocator_chunk_data(chunk)        ((tb_byte_t*)(chunk) + TB_ARENA_ALLOCATOR_CHUNK_HEAD_SIZE)
+
+// the data patch size for checking underflow
+#ifdef __tb_debug__
+#   define TB_ARENA_ALLOCATOR_DATA_PATCH            (1)
+#else
+#   define TB_ARENA_ALLOCATOR_DATA_PATCH            (0)
+#endif
+
+// the data space, including the data head
+#define tb_arena_allocator_data_space(size)         (sizeof(tb_pool_data_head_t) + tb_align((size) + TB_ARENA_ALLOCATOR_DATA_PATCH, TB_POOL_DATA_ALIGN))
+
+// the magic of the freed data for checking double free
+#define TB_ARENA_ALLOCATOR_DATA_FREE_MAGIC          (0xdefe)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the arena allocator chunk type
+typedef struct __tb_arena_allocator_chunk_t
+{
+    // the previous chunk
+    struct __tb_arena_allocator_chunk_t*    prev;
+
+    // the data size
+    tb_size_t                               size;
+
+    // the used size
+    tb_size_t                               used;
+
+}tb_arena_allocator_chunk_t, *tb_arena_allocator_chunk_ref_t;
+
+// the arena allocator type
+typedef struct __tb_arena_allocator_t
+{
+    // the base
+    tb_allocator_t                  base;
+
+    // the large allocator
+    tb_allocator_ref_t              large_allocator;
+
+    // the chunk size
+    tb_size_t                       chunk_size;
+
+    // the first chunk, it is placed after the allocator and will not be freed until exiting
+    tb_arena_allocator_chunk_ref_t  first;
+
+    // the current chunk
+    tb_arena_allocator_chunk_ref_t  current;
+
+    // the last data of the current chunk, it can be grown, shrunk and freed in place
+    tb_pointer_t                    last;
+
+#ifdef __tb_debug__
+    // the chunk count
+    tb_size_t                       chunk_count;
+
+    // the peak chunk count
+    tb_size_t                       chunk_peak;
+
+    // the malloc count
+    tb_size_t                       malloc_count;
+
+    // the ralloc count
+    tb_size_t                       ralloc_count;
+
+    // the free count
+    tb_size_t                       free_count;
+#endif
+
+}tb_arena_allocator_t, *tb_arena_allocator_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_arena_allocator_chunk_ref_t tb_arena_allocator_chunk_make(tb_arena_allocator_ref_t allocator, tb_size_t space)
+{
+    // check
+    tb_assert(allocator && allocator->large_allocator && allocator->current);
+
+    // make chunk, the too large data will use a dedicated chunk
+    tb_size_t                       real = 0;
+    tb_arena_allocator_chunk_ref_t  chunk = (tb_arena_allocator_chunk_ref_t)tb_allocator_large_malloc(allocator->large_allocator, TB_ARENA_ALLOCATOR_CHUNK_HEAD_SIZE + tb_max(space, allocator->chunk_size), &real);
+    tb_assert_and_check_return_val(chunk && real > TB_ARENA_ALLOCATOR_CHUNK_HEAD_SIZE, tb_null);
+
+    // init chunk
+    chunk->prev = allocator->current;
+    chunk->size = real - TB_ARENA_ALLOCATOR_CHUNK_HEAD_SIZE;
+    chunk->used = 0;
+
+    // switch to the new chunk, the remaining space of the previous chunk will be wasted
+    allocator->current = chunk;
+
+#ifdef __tb_debug__
+    // update the chunk count
+    allocator->chunk_count++;
+    if (allocator->chunk_count > allocator->chunk_peak) allocator->chunk_peak = allocator->chunk_count;
+#endif
+
+    // trace
+    tb_trace_d("make chunk: %p, size: %lu", chunk, chunk->size);
+
+    // ok
+    return chunk;
+}
+static tb_void_t tb_arena_allocator_chunk_free(tb_arena_allocator_ref_t allocator, tb_arena_allocator_chunk_ref_t chunk)
+{
+    // check
+    tb_assert(allocator && allocator->large_allocator && chunk && chunk != allocator->first);
+
+    // trace
+    tb_trace_d("free chunk: %p, size: %lu", chunk, chunk->size);
+
+    // free it
+    tb_allocator_large_free(allocator->large_allocator, chunk);
+
+#ifdef __tb_debug__
+    // update the chunk count
+    allocator->chunk_count--;
+#endif
+}
+static tb_void_t tb_arena_allocator_rewind(tb_arena_allocator_ref_t allocator, tb_arena_allocator_chunk_ref_t chunk, tb_size_t used)
+{
+    // check
+    tb_assert(allocator && allocator->current && chunk);
+
+    // free all chunks after the given chunk
+    while (allocator->current != chunk)
+    {
+        // the previous chunk
+        tb_arena_allocator_chunk_ref_t prev = allocator->current->prev;
+        tb_assertf_and_check_return(prev, "the chunk: %p not belong to allocator: %p", chunk, allocator);
+
+        // free the current chunk
+        tb_arena_allocator_chunk_free(allocator, allocator->current);
+        allocator->current = prev;
+    }
+
+    // rewind the used size
+    tb_assert(used <= chunk->used);
+    chunk->used = used;
+
+    // the last data may have been released
+    allocator->last = tb_null;
+}
+static tb_pointer_t tb_arena_allocator_malloc_done(tb_arena_allocator_ref_t allocator, tb_size_t size __tb_debug_decl__)
+{
+    // check
+    tb_assert(allocator && allocator->current);
+
+    // the need space
+    tb_size_t space = tb_arena_allocator_data_space(size);
+
+    // no enough space in the current chunk? make a new chunk
+    tb_arena_allocator_chunk_ref_t chunk = allocator->current;
+    if (chunk->used + space > chunk->size)
+    {
+        chunk = tb_arena_allocator_chunk_make(allocator, space);
+        tb_check_return_val(chunk, tb_null);
+    }
+
+    // bump the data
+    tb_pool_data_head_t* data_head = (tb_pool_data_head_t*)(tb_arena_allocator_chunk_data(chunk) + chunk->used);
+    chunk->used += space;
+
+    // init the data size
+    data_head->size = size;
+
+#ifdef __tb_debug__
+    // init the debug info
+    data_head->debug.magic     = TB_POOL_DATA_MAGIC;
+    data_head->debug.file      = file_;
+    data_head->debug.func      = func_;
+    data_head->debug.line      = (tb_uint16_t)line_;
+
+    // save backtrace
+    tb_pool_data_save_backtrace(&data_head->debug, 3);
+
+    // make the dirty data and patch 0xcc for checking underflow
+    tb_memset_((tb_pointer_t)&(data_head[1]), TB_POOL_DATA_PATCH, size + TB_ARENA_ALLOCATOR_DATA_PATCH);
+#endif
+
+    // save the last data
+    allocator->last = (tb_pointer_t)&(data_head[1]);
+
+    // ok
+    return allocator->last;
+}
+#ifdef __tb_debug__
+static tb_void_t tb_arena_allocator_data_check(tb_arena_allocator_ref_t allocator, tb_cpointer_t data)
+{
+    // the data head
+    tb_pool_data_head_t* data_head = &(((tb_pool_data_head_t*)data)[-1]);
+
+    // check
+    tb_assertf(data_head->debug.magic != TB_ARENA_ALLOCATOR_DATA_FREE_MAGIC, "double free data: %p", data);
+    tb_assertf(data_head->debug.magic == TB_POOL_DATA_MAGIC, "invalid data: %p", data);
+    tb_assertf(((tb_byte_t const*)data)[data_head->size] == TB_POOL_DATA_PATCH, "data underflow");
+}
+#endif
+static tb_void_t tb_arena_allocator_exit(tb_allocator_ref_t self)
+{
+    // check
+    tb_arena_allocator_ref_t allocator = (tb_arena_allocator_ref_t)self;
+    tb_assert_and_check_return(allocator && allocator->large_allocator);
+
+    // the chunks have been freed when clearing it, only free the first chunk with the allocator together
+    tb_assert(allocator->current == allocator->first);
+
+    // exit lock
+    tb_spinlock_exit(&allocator->base.lock);
+
+    // exit allocator
+    tb_allocator_large_free(allocator->large_allocator, allocator);
+}
+static tb_void_t tb_arena_allocator_clear(tb_allocator_ref_t self)
+{
+    // check
+    tb_arena_allocator_ref_t allocator = (tb_arena_allocator_ref_t)self;
+    tb_assert_and_check_return(allocator && allocator->first);
+
+    // release all data and only keep the first chunk
+    tb_arena_allocator_rewind(allocator, allocator->first, 0);
+}
+static tb_pointer_t tb_arena_allocator_malloc(tb_allocator_ref_t self, tb_size_t size __tb_debug_decl__)
+{
+    // check
+    tb_arena_allocator_ref_t allocator = (tb_arena_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator && size && size <= TB_POOL_DATA_SIZE_MAXN, tb_null);
+
+#ifdef __tb_debug__
+    // update the malloc count
+    allocator->malloc_count++;
+#endif
+
+    // malloc it
+    return tb_arena_allocator_malloc_done(allocator, size __tb_debug_args__);
+}
+static tb_pointer_t tb_arena_allocator_ralloc(tb_allocator_ref_t self, tb_pointer_t data, tb_size_t size __tb_debug_decl__)
+{
+    // check
+    tb_arena_allocator_ref_t allocator = (tb_arena_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator && allocator->current && data && size && size <= TB_POOL_DATA_SIZE_MAXN, tb_null);
+
+#ifdef __tb_debug__
+    // check data
+    tb_arena_allocator_data_check(allocator, data);
+
+    // update the ralloc count
+    allocator->ralloc_count++;
+#endif
+
+    // the data head
+    tb_pool_data_head_t* data_head = &(((tb_pool_data_head_t*)data)[-1]);
+
+    // done
+    tb_pointer_t data_new = tb_null;
+    do
+    {
+        // is the last data? grow or shrink it in place if the current chunk has enough space
+        if (data == allocator->last)
+        {
+            tb_arena_allocator_chunk_ref_t chunk = allocator->current;
+            tb_size_t used = (tb_size_t)((tb_byte_t*)data_head - tb_arena_allocator_chunk_data(chunk)) + tb_arena_allocator_data_space(size);
+            if (used <= chunk->size)
+            {
+                chunk->used = used;
+                data_new = data;
+                break;
+            }
+        }
+        // enough space for the old data? update it in place
+        else if (tb_arena_allocator_data_space(size) <= tb_arena_allocator_data_space(data_head->size))
+        {
+            data_new = data;
+            break;
+        }
+
+        // make the new data
+        data_new = tb_arena_allocator_malloc_done(allocator, size __tb_debug_args__);
+        tb_check_break(data_new);
+
+        // copy the old data, the old space will be released together
+        tb_memcpy_(data_new, data, tb_min(data_head->size, size));
+
+#ifdef __tb_debug__
+        // mark the old data as freed
+        data_head->debug.magic = TB_ARENA_ALLOCATOR_DATA_FREE_MAGIC;
+#endif
+
+    } while (0);
+
+    // update the size in place
+    if (data_new == data)
+    {
+#ifdef __tb_debug__
+        // fill the patch bytes
+        if (size > data_head->size) tb_memset_((tb_byte_t*)data + data_head->size, TB_POOL_DATA_PATCH, size - data_head->size);
+        ((tb_byte_t*)data)[size] = TB_POOL_DATA_PATCH;
+#endif
+        data_head->size = size;
+    }
+
+    // ok?
+    return data_new;
+}
+static tb_bool_t tb_arena_allocator_free(tb_allocator_ref_t self, tb_pointer_t data __tb_debug_decl__)
+{
+    // check
+    tb_arena_allocator_ref_t allocator = (tb_arena_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator && allocator->current && data, tb_false);
+
+#ifdef __tb_debug__
+    // check data
+    tb_arena_allocator_data_check(allocator, data);
+
+    // mark it as freed
+    (((tb_pool_data_head_t*)data)[-1]).debug.magic = TB_ARENA_ALLOCATOR_DATA_FREE_MAGIC;
+
+    // update the free count
+    allocator->free_count++;
+#endif
+
+    // is the last data? give back its space, e.g. the temporary buffer
+    if (data == allocator->last)
+    {
+        allocator->current->used = (tb_size_t)((tb_byte_t*)data - sizeof(tb_pool_data_head_t) - tb_arena_allocator_chunk_data(allocator->current));
+        allocator->last = tb_null;
+    }
+
+    // ok, the other data will be released together
+    return tb_true;
+}
+#ifdef __tb_debug__
+static tb_void_t tb_arena_allocator_dump(tb_allocator_ref_t self)
+{
+    // check
+    tb_arena_allocator_ref_t allocator = (tb_arena_allocator_ref_t)self;
+    tb_assert_and_check_return(allocator && allocator->current);
+
+    // compute the chunk and used size
+    tb_size_t                       chunk_size = 0;
+    tb_size_t                       used_size = 0;
+    tb_arena_allocator_chunk_ref_t  chunk = allocator->current;
+    for (; chunk; chunk = chunk->prev)
+    {
+        chunk_size += chunk->size;
+        used_size += chunk->used;
+    }
+
+    // trace
+    tb_trace_i("");
+    tb_trace_i("chunks: %lu, peak: %lu, size: %lu, used: %lu, used_rate: %lu%%", allocator->chunk_count + 1, allocator->chunk_peak + 1, chunk_size, used_size, chunk_size? (used_size * 100) / chunk_size : 0);
+    tb_trace_i("malloc count: %lu", allocator->malloc_count);
+    tb_trace_i("ralloc count: %lu", allocator->ralloc_count);
+    tb_trace_i("free count: %lu", allocator->free_count);
+}
+static tb_bool_t tb_arena_allocator_have(tb_allocator_ref_t self, tb_cpointer_t data)
+{
+    // check
+    tb_arena_allocator_ref_t allocator = (tb_arena_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator && allocator->current, tb_false);
+
+    // find the chunk of this data
+    tb_arena_allocator_chunk_ref_t chunk = allocator->current;
+    for (; chunk; chunk = chunk->prev)
+    {
+        tb_byte_t const* chunk_data = tb_arena_allocator_chunk_data(chunk);
+        if ((tb_byte_t const*)data >= chunk_data && (tb_byte_t const*)data < chunk_data + chunk->used) return tb_true;
+    }
+
+    // no this data
+    return tb_false;
+}
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_allocator_ref_t tb_arena_allocator_init(tb_allocator_ref_t large_allocator, tb_size_t chunk_size)
+{
+    // done
+    tb_bool_t                   ok = tb_false;
+    tb_arena_allocator_ref_t    allocator = tb_null;
+    do
+    {
+        // no allocator? uses the global allocator
+        if (!large_allocator) large_allocator = tb_allocator();
+        tb_assert_and_check_break(large_allocator);
+
+        // init chunk size
+        if (!chunk_size) chunk_size = TB_ARENA_ALLOCATOR_CHUNK_SIZE;
+
+        // make allocator with the first chunk
+        tb_size_t real = 0;
+        allocator = (tb_arena_allocator_ref_t)tb_allocator_large_malloc0(large_allocator, TB_ARENA_ALLOCATOR_SIZE + TB_ARENA_ALLOCATOR_CHUNK_HEAD_SIZE + chunk_size, &real);
+        tb_assert_and_check_break(allocator && real >= TB_ARENA_ALLOCATOR_SIZE + TB_ARENA_ALLOCATOR_CHUNK_HEAD_SIZE + chunk_size);
+
+        // init allocator
+        allocator->large_allocator      = large_allocator;
+        allocator->chunk_size           = chunk_size;
+
+        // init the first chunk
+        allocator->first                = (tb_arena_allocator_chunk_ref_t)((tb_byte_t*)allocator + TB_ARENA_ALLOCATOR_SIZE);
+        allocator->first->size          = real - TB_ARENA_ALLOCATOR_SIZE - TB_ARENA_ALLOCATOR_CHUNK_HEAD_SIZE;
+        allocator->current              = allocator->first;
+
+        // init base
+        allocator->base.type            = TB_ALLOCATOR_ARENA;
+        allocator->base.malloc          = tb_arena_allocator_malloc;
+        allocator->base.ralloc          = tb_arena_allocator_ralloc;
+        allocator->base.free            = tb_arena_allocator_free;
+        allocator->base.clear           = tb_arena_allocator_clear;
+        allocator->base.exit            = tb_arena_allocator_exit;
+#ifdef __tb_debug__
+        allocator->base.dump            = tb_arena_allocator_dump;
+        allocator->base.have            = tb_arena_allocator_have;
+#endif
+
+        // init lock
+        if (!tb_spinlock_init(&allocator->base.lock)) break;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        if (allocator) tb_arena_allocator_exit((tb_allocator_ref_t)allocator);
+        allocator = tb_null;
+    }
+
+    // ok?
+    return (tb_allocator_ref_t)allocator;
+}
+tb_void_t tb_arena_allocator_save(tb_allocator_ref_t self, tb_arena_allocator_checkpoint_ref_t checkpoint)
+{
+    // check
+    tb_arena_allocator_ref_t allocator = (tb_arena_allocator_ref_t)self;
+    tb_assert_and_check_return(allocator && allocator->base.type == TB_ALLOCATOR_ARENA && checkpoint);
+
+    // enter
+    tb_spinlock_enter(&allocator->base.lock);
+
+    // save the current position
+    checkpoint->chunk   = (tb_pointer_t)allocator->current;
+    checkpoint->used    = allocator->current->used;
+
+    // leave
+    tb_spinlock_leave(&allocator->base.lock);
+}
+tb_void_t tb_arena_allocator_rollback(tb_allocator_ref_t self, tb_arena_allocator_checkpoint_ref_t checkpoint)
+{
+    // check
+    tb_arena_allocator_ref_t allocator = (tb_arena_allocator_ref_t)self;
+    tb_assert_and_check_return(allocator && allocator->base.type == TB_ALLOCATOR_ARENA && checkpoint && checkpoint->chunk);
+
+    // enter
+    tb_spinlock_enter(&allocator->base.lock);
+
+    // rewind to the checkpoint
+    tb_arena_allocator_rewind(allocator, (tb_arena_allocator_chunk_ref_t)checkpoint->chunk, checkpoint->used);
+
+    // leave
+    tb_spinlock_leave(&allocator->base.lock);
+}
+tb_size_t tb_arena_allocator_size(tb_allocator_ref_t self)
+{
+    // check
+    tb_arena_allocator_ref_t allocator = (tb_arena_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator && allocator->base.type == TB_ALLOCATOR_ARENA, 0);
+
+    // enter
+    tb_spinlock_enter(&allocator->base.lock);
+
+    // compute the used size of all chunks
+    tb_size_t                       size = 0;
+    tb_arena_allocator_chunk_ref_t  chunk = allocator->current;
+    for (; chunk; chunk = chunk->prev) size += chunk->used;
+
+    // leave
+    tb_spinlock_leave(&allocator->base.lock);
+
+    // ok?
+    return size;
+}
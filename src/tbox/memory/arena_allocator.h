@@ -0,0 +1,148 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        arena_allocator.h
+ * @ingroup     memory
+ *
+ */
+#ifndef TB_MEMORY_ARENA_ALLOCATOR_H
+#define TB_MEMORY_ARENA_ALLOCATOR_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "allocator.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/// the default chunk size
+#ifdef __tb_small__
+#   define TB_ARENA_ALLOCATOR_CHUNK_SIZE        (16 * 1024)
+#else
+#   define TB_ARENA_ALLOCATOR_CHUNK_SIZE        (64 * 1024)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the arena allocator checkpoint type
+typedef struct __tb_arena_allocator_checkpoint_t
+{
+    /// the chunk
+    tb_pointer_t            chunk;
+
+    /// the used size of this chunk
+    tb_size_t               used;
+
+}tb_arena_allocator_checkpoint_t, *tb_arena_allocator_checkpoint_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the arena allocator
+ *
+ * the data is allocated by bumping the pointer of the current chunk,
+ * tb_allocator_free() does nothing and all data will be released together by tb_allocator_clear() or tb_allocator_exit().
+ *
+ * <pre>
+ *
+ *  -----------------------      --------------------------      --------------------------
+ * | allocator | chunk: 0  | <- |         chunk: 1         | <- |     chunk: 2 (current)   |
+ *  -----------------------      --------------------------      --------------------------
+ *                |                         |                      |       |       |
+ *                |                         |                    data0   data1   data2 ->
+ *                |                         |
+ *  -----------------------------------------------------------------------------------------
+ * |                                    large allocator                                      |
+ *  -----------------------------------------------------------------------------------------
+ *
+ * </pre>
+ *
+ * @code
+    // init allocator
+    tb_allocator_ref_t allocator = tb_arena_allocator_init(tb_null, 0);
+    if (allocator)
+    {
+        // make data
+        tb_pointer_t data = tb_allocator_malloc(allocator, 10);
+
+        // save the checkpoint
+        tb_arena_allocator_checkpoint_t checkpoint;
+        tb_arena_allocator_save(allocator, &checkpoint);
+
+        // make the temporary data
+        tb_pointer_t temp = tb_allocator_malloc(allocator, 100);
+
+        // release the temporary data
+        tb_arena_allocator_rollback(allocator, &checkpoint);
+
+        // release all data
+        tb_allocator_exit(allocator);
+    }
+ * @endcode
+ *
+ * @param large_allocator   the large allocator for the chunks, uses the global allocator if be null
+ * @param chunk_size        the chunk size, uses the default size if be zero
+ *
+ * @return                  the allocator
+ */
+tb_allocator_ref_t          tb_arena_allocator_init(tb_allocator_ref_t large_allocator, tb_size_t chunk_size);
+
+/*! save the current position of the arena allocator
+ *
+ * @param allocator         the arena allocator
+ * @param checkpoint        the checkpoint
+ */
+tb_void_t                   tb_arena_allocator_save(tb_allocator_ref_t allocator, tb_arena_allocator_checkpoint_ref_t checkpoint);
+
+/*! rollback the arena allocator to the given checkpoint
+ *
+ * all data allocated after this checkpoint will be released,
+ * and the checkpoints saved after it will be invalid.
+ *
+ * @param allocator         the arena allocator
+ * @param checkpoint        the checkpoint
+ */
+tb_void_t                   tb_arena_allocator_rollback(tb_allocator_ref_t allocator, tb_arena_allocator_checkpoint_ref_t checkpoint);
+
+/*! the allocated size of the arena allocator
+ *
+ * @param allocator         the arena allocator
+ *
+ * @return                  the allocated size, including the data heads and alignment
+ */
+tb_size_t                   tb_arena_allocator_size(tb_allocator_ref_t allocator);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -43,6 +43,9 @@
 // the item belong to this slot?
 #define tb_fixed_pool_slot_exists(slot, item)               (((tb_byte_t*)(item) > (tb_byte_t*)(slot)) && ((tb_byte_t*)(item) < (tb_byte_t*)slot + (slot)->size))
 
+// the initial entries maxn of the slot map
+#define TB_FIXED_POOL_SLOT_MAP_MAXN                         (64)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -61,6 +64,21 @@ typedef struct __tb_fixed_pool_slot_t
 
 }tb_fixed_pool_slot_t;
 
+/* the fixed pool slot map entry type
+ *
+ * the address space is divided into granules and the granule size is not larger than the slot size,
+ * so one granule intersects with at most two slots and we can find the slot of the given data in O(1)
+ */
+typedef struct __tb_fixed_pool_slot_map_entry_t
+{
+    // the granule index, 0: empty entry
+    tb_size_t                       index;
+
+    // the slots which intersect with this granule
+    tb_fixed_pool_slot_t*           slots[2];
+
+}tb_fixed_pool_slot_map_entry_t;
+
 // the fixed pool type
 typedef struct __tb_fixed_pool_impl_t
 {
@@ -94,15 +112,21 @@ typedef struct __tb_fixed_pool_impl_t
     // the full slot
     tb_list_entry_head_t            full_slots;
 
-    // the slot list
-    tb_fixed_pool_slot_t**          slot_list;
+    // the slot map, granule index => slots
+    tb_fixed_pool_slot_map_entry_t* slot_map;
+
+    // the used entries count of the slot map
+    tb_size_t                       slot_map_size;
+
+    // the entries maxn of the slot map, it must be the power of two
+    tb_size_t                       slot_map_maxn;
+
+    // the granule shift of the slot map, (1 << shift) <= the slot size
+    tb_size_t                       slot_shift;
 
     // the slot count
     tb_size_t                       slot_count;
 
-    // the slot space
-    tb_size_t                       slot_space;
-
     // for small allocator
     tb_bool_t                       for_small;
 
@@ -128,30 +152,172 @@ static tb_bool_t tb_fixed_pool_item_exit(tb_pointer_t data, tb_cpointer_t priv)
     // continue
     return tb_true;
 }
+static __tb_inline__ tb_size_t tb_fixed_pool_slot_map_hash(tb_size_t index, tb_size_t mask)
+{
+    // the adjacent granules will be scattered
+    index *= 0x9e3779b1;
+    return (index ^ (index >> 16)) & mask;
+}
+static tb_fixed_pool_slot_map_entry_t* tb_fixed_pool_slot_map_find(tb_fixed_pool_t* pool, tb_size_t index)
+{
+    // check
+    tb_assert(index);
+    tb_check_return_val(pool->slot_map, tb_null);
+
+    // find it with the linear probing
+    tb_size_t mask = pool->slot_map_maxn - 1;
+    tb_size_t i = tb_fixed_pool_slot_map_hash(index, mask);
+    while (pool->slot_map[i].index)
+    {
+        if (pool->slot_map[i].index == index) return &pool->slot_map[i];
+        i = (i + 1) & mask;
+    }
+    return tb_null;
+}
+static tb_bool_t tb_fixed_pool_slot_map_grow(tb_fixed_pool_t* pool)
+{
+    // make the new map
+    tb_size_t                       maxn = pool->slot_map? (pool->slot_map_maxn << 1) : TB_FIXED_POOL_SLOT_MAP_MAXN;
+    tb_fixed_pool_slot_map_entry_t* map = (tb_fixed_pool_slot_map_entry_t*)tb_allocator_large_nalloc0(pool->large_allocator, maxn, sizeof(tb_fixed_pool_slot_map_entry_t), tb_null);
+    tb_assert_and_check_return_val(map, tb_false);
+
+    // move the entries to the new map
+    if (pool->slot_map)
+    {
+        tb_size_t i = 0;
+        tb_size_t mask = maxn - 1;
+        for (i = 0; i < pool->slot_map_maxn; i++)
+        {
+            // the entry
+            tb_fixed_pool_slot_map_entry_t* entry = &pool->slot_map[i];
+            tb_check_continue(entry->index);
+
+            // insert it
+            tb_size_t j = tb_fixed_pool_slot_map_hash(entry->index, mask);
+            while (map[j].index) j = (j + 1) & mask;
+            map[j] = *entry;
+        }
+
+        // exit the old map
+        tb_allocator_large_free(pool->large_allocator, pool->slot_map);
+    }
+
+    // update the map
+    pool->slot_map      = map;
+    pool->slot_map_maxn = maxn;
+
+    // ok
+    return tb_true;
+}
+static tb_bool_t tb_fixed_pool_slot_map_insert(tb_fixed_pool_t* pool, tb_size_t index, tb_fixed_pool_slot_t* slot)
+{
+    // the granule has been existed? 
+    tb_fixed_pool_slot_map_entry_t* entry = tb_fixed_pool_slot_map_find(pool, index);
+    if (entry)
+    {
+        // save the slot to the free position
+        tb_assert_and_check_return_val(!entry->slots[0] || !entry->slots[1], tb_false);
+        entry->slots[entry->slots[0]? 1 : 0] = slot;
+        return tb_true;
+    }
+
+    // grow the map if the load factor >= 0.5
+    if (!pool->slot_map || ((pool->slot_map_size + 1) << 1) > pool->slot_map_maxn)
+    {
+        if (!tb_fixed_pool_slot_map_grow(pool)) return tb_false;
+    }
+
+    // insert a new entry
+    tb_size_t mask = pool->slot_map_maxn - 1;
+    tb_size_t i = tb_fixed_pool_slot_map_hash(index, mask);
+    while (pool->slot_map[i].index) i = (i + 1) & mask;
+    pool->slot_map[i].index     = index;
+    pool->slot_map[i].slots[0]  = slot;
+    pool->slot_map[i].slots[1]  = tb_null;
+    pool->slot_map_size++;
+
+    // ok
+    return tb_true;
+}
+static tb_void_t tb_fixed_pool_slot_map_remove(tb_fixed_pool_t* pool, tb_size_t index, tb_fixed_pool_slot_t* slot)
+{
+    // find the entry
+    tb_fixed_pool_slot_map_entry_t* entry = tb_fixed_pool_slot_map_find(pool, index);
+    tb_check_return(entry);
+
+    // remove the slot
+    if (entry->slots[0] == slot) entry->slots[0] = tb_null;
+    else if (entry->slots[1] == slot) entry->slots[1] = tb_null;
+
+    // this entry is still used?
+    tb_check_return(!entry->slots[0] && !entry->slots[1]);
+
+    // remove this entry and shift the following entries backward, so we need not the tombstone
+    tb_size_t mask = pool->slot_map_maxn - 1;
+    tb_size_t i = entry - pool->slot_map;
+    tb_size_t j = i;
+    while (1)
+    {
+        // the next entry
+        j = (j + 1) & mask;
+        tb_check_break(pool->slot_map[j].index);
+
+        // the home position of the next entry is cyclically in (i, j]? skip it
+        tb_size_t k = tb_fixed_pool_slot_map_hash(pool->slot_map[j].index, mask);
+        if (i <= j? (i < k && k <= j) : (i < k || k <= j)) continue;
+
+        // move it to the hole
+        pool->slot_map[i] = pool->slot_map[j];
+        i = j;
+    }
+    pool->slot_map[i].index     = 0;
+    pool->slot_map[i].slots[0]  = tb_null;
+    pool->slot_map[i].slots[1]  = tb_null;
+    pool->slot_map_size--;
+}
+static tb_bool_t tb_fixed_pool_slot_bind(tb_fixed_pool_t* pool, tb_fixed_pool_slot_t* slot)
+{
+    // bind all granules of this slot
+    tb_size_t head = (tb_size_t)slot >> pool->slot_shift;
+    tb_size_t tail = ((tb_size_t)slot + slot->size - 1) >> pool->slot_shift;
+    tb_size_t index = head;
+    for (index = head; index <= tail; index++)
+    {
+        if (!tb_fixed_pool_slot_map_insert(pool, index, slot)) break;
+    }
+
+    // failed? unbind the bound granules
+    if (index <= tail)
+    {
+        while (index-- > head) tb_fixed_pool_slot_map_remove(pool, index, slot);
+        return tb_false;
+    }
+
+    // ok
+    return tb_true;
+}
+static tb_void_t tb_fixed_pool_slot_unbind(tb_fixed_pool_t* pool, tb_fixed_pool_slot_t* slot)
+{
+    // unbind all granules of this slot
+    tb_size_t head = (tb_size_t)slot >> pool->slot_shift;
+    tb_size_t tail = ((tb_size_t)slot + slot->size - 1) >> pool->slot_shift;
+    tb_size_t index = head;
+    for (index = head; index <= tail; index++)
+        tb_fixed_pool_slot_map_remove(pool, index, slot);
+}
 static tb_void_t tb_fixed_pool_slot_exit(tb_fixed_pool_t* pool, tb_fixed_pool_slot_t* slot)
 {
     // check
     tb_assert_and_check_return(pool && pool->large_allocator && slot);
-    tb_assert_and_check_return(pool->slot_list && pool->slot_count);
 
     // trace
     tb_trace_d("slot[%lu]: exit: size: %lu", pool->item_size, slot->size);
 
-    // make the iterator
-    tb_array_iterator_t array_iterator;
-    tb_iterator_ref_t   iterator = tb_iterator_make_for_ptr(&array_iterator, (tb_pointer_t*)pool->slot_list, pool->slot_count);
-    tb_assert(iterator);
-
-    // find the slot from the slot list
-    tb_size_t itor = tb_binary_find_all(iterator, (tb_cpointer_t)slot);
-    tb_assert(itor != tb_iterator_tail(iterator) && itor < pool->slot_count && pool->slot_list[itor]);
-    tb_check_return(itor != tb_iterator_tail(iterator) && itor < pool->slot_count && pool->slot_list[itor]);
-    
-    // remove the slot
-    if (itor + 1 < pool->slot_count) tb_memmov_(pool->slot_list + itor, pool->slot_list + itor + 1, (pool->slot_count - itor - 1) * sizeof(tb_fixed_pool_slot_t*));
+    // unbind the slot from the slot map
+    tb_fixed_pool_slot_unbind(pool, slot);
 
     // update the slot count
-    pool->slot_count--;
+    if (pool->slot_count) pool->slot_count--;
 
     // exit slot
     tb_allocator_large_free(pool->large_allocator, slot);
@@ -190,43 +356,17 @@ static tb_fixed_pool_slot_t* tb_fixed_pool_slot_init(tb_fixed_pool_t* pool)
         slot->pool = tb_static_fixed_pool_init((tb_byte_t*)&slot[1], real_space - sizeof(tb_fixed_pool_slot_t), pool->item_size, pool->for_small); 
         tb_assert_and_check_break(slot->pool);
 
-        // no list?
-        if (!pool->slot_list)
-        {
-            // init the slot list
-            tb_size_t size = 0;
-            pool->slot_list = (tb_fixed_pool_slot_t**)tb_allocator_large_nalloc(pool->large_allocator, 64, sizeof(tb_fixed_pool_slot_t*), &size);
-            tb_assert_and_check_break(pool->slot_list && size);
-
-            // init the slot count
-            pool->slot_count = 0;
-
-            // init the slot space
-            pool->slot_space = size / sizeof(tb_fixed_pool_slot_t*);
-            tb_assert_and_check_break(pool->slot_space);
-        }
-        // no enough space?
-        else if (pool->slot_count == pool->slot_space)
+        // init the granule shift, the granule size must be not larger than the slot size
+        if (!pool->slot_shift)
         {
-            // grow the slot list
-            tb_size_t size = 0;
-            pool->slot_list = (tb_fixed_pool_slot_t**)tb_allocator_large_ralloc(pool->large_allocator, pool->slot_list, (pool->slot_space << 1) * sizeof(tb_fixed_pool_slot_t*), &size);
-            tb_assert_and_check_break(pool->slot_list && size);
-
-            // update the slot space
-            pool->slot_space = size / sizeof(tb_fixed_pool_slot_t*);
-            tb_assert_and_check_break(pool->slot_space);
+            tb_size_t shift = 1;
+            while (((tb_size_t)2 << shift) <= need_space) shift++;
+            pool->slot_shift = shift;
         }
+        tb_assert_and_check_break(((tb_size_t)1 << pool->slot_shift) <= real_space);
 
-        // check
-        tb_assert_and_check_break(pool->slot_count < pool->slot_space);
-
-        // insert the slot to the slot list in the increasing order (TODO binary search)
-        tb_size_t i = 0;
-        tb_size_t n = pool->slot_count;
-        for (i = 0; i < n; i++) if (slot <= pool->slot_list[i]) break;
-        if (i < n) tb_memmov_(pool->slot_list + i + 1, pool->slot_list + i, (n - i) * sizeof(tb_fixed_pool_slot_t*));
-        pool->slot_list[i] = slot;
+        // bind the slot to the slot map 
+        if (!tb_fixed_pool_slot_bind(pool, slot)) break;
 
         // update the slot count
         pool->slot_count++;
@@ -242,96 +382,34 @@ static tb_fixed_pool_slot_t* tb_fixed_pool_slot_init(tb_fixed_pool_t* pool)
     // failed?
     if (!ok)
     {
-        // exit it
-        if (slot) tb_fixed_pool_slot_exit(pool, slot);
+        // exit it, it has not been bound
+        if (slot) tb_allocator_large_free(pool->large_allocator, slot);
         slot = tb_null;
     }
 
     // ok?
     return slot;
 }
-#if 0
 static tb_fixed_pool_slot_t* tb_fixed_pool_slot_find(tb_fixed_pool_t* pool, tb_pointer_t data)
 {
     // check
     tb_assert_and_check_return_val(pool && data, tb_null);
 
-    // done
-    tb_fixed_pool_slot_t* slot = tb_null;
-    do
-    {
-        // belong to the current slot?
-        if (pool->current_slot && tb_fixed_pool_slot_exists(pool->current_slot, data))
-        {
-            slot = pool->current_slot;
-            break;
-        }
-            
-        // find the slot from the partial slots
-        tb_for_all_if(tb_fixed_pool_slot_t*, partial_slot, tb_list_entry_itor(&pool->partial_slots), partial_slot)
-        {
-            // is this?
-            if (tb_fixed_pool_slot_exists(partial_slot, data))
-            {
-                slot = partial_slot;
-                break;
-            }
-        }
-        
-        // no found?
-        tb_check_break(!slot);
-
-        // find the slot from the full slots
-        tb_for_all_if(tb_fixed_pool_slot_t*, full_slot, tb_list_entry_itor(&pool->full_slots), full_slot)
-        {
-            // is this?
-            if (tb_fixed_pool_slot_exists(full_slot, data))
-            {
-                slot = full_slot;
-                break;
-            }
-        }
+    // belong to the current slot?
+    if (pool->current_slot && tb_fixed_pool_slot_exists(pool->current_slot, data)) 
+        return pool->current_slot;
 
-    } while (0);
+    // find the granule 
+    tb_fixed_pool_slot_map_entry_t* entry = tb_fixed_pool_slot_map_find(pool, (tb_size_t)data >> pool->slot_shift);
+    tb_check_return_val(entry, tb_null);
 
-    // ok?
-    return slot;
-}
-#else
-static tb_long_t tb_fixed_pool_slot_comp(tb_iterator_ref_t iterator, tb_cpointer_t item, tb_cpointer_t data)
-{
-    // the slot
-    tb_fixed_pool_slot_t* slot = (tb_fixed_pool_slot_t*)item;
-    tb_assert(slot);
+    // find the slot from the intersected slots
+    if (entry->slots[0] && tb_fixed_pool_slot_exists(entry->slots[0], data)) return entry->slots[0];
+    if (entry->slots[1] && tb_fixed_pool_slot_exists(entry->slots[1], data)) return entry->slots[1];
 
-    // comp
-    return (tb_byte_t*)data < (tb_byte_t*)slot? 1 : ((tb_byte_t*)data >= (tb_byte_t*)slot + slot->size? -1 : 0);
+    // not found
+    return tb_null;
 }
-static tb_fixed_pool_slot_t* tb_fixed_pool_slot_find(tb_fixed_pool_t* pool, tb_pointer_t data)
-{
-    // check
-    tb_assert_and_check_return_val(pool && data, tb_null);
-
-    // make the iterator
-    tb_array_iterator_t array_iterator;
-    tb_iterator_ref_t   iterator = tb_iterator_make_for_ptr(&array_iterator, (tb_pointer_t*)pool->slot_list, pool->slot_count);
-    tb_assert(iterator);
-
-    // find it
-    tb_size_t itor = tb_binary_find_all_if(iterator, tb_fixed_pool_slot_comp, data);
-    tb_check_return_val(itor != tb_iterator_tail(iterator), tb_null);
-
-    // the slot
-    tb_fixed_pool_slot_t* slot = pool->slot_list[itor];
-    tb_assert_and_check_return_val(slot, tb_null);
-
-    // check
-    tb_assert(tb_fixed_pool_slot_exists(slot, data));
-
-    // ok?
-    return slot;
-}
-#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -403,11 +481,12 @@ tb_void_t tb_fixed_pool_exit(tb_fixed_pool_ref_t self)
     if (pool->current_slot) tb_fixed_pool_slot_exit(pool, pool->current_slot);
     pool->current_slot = tb_null;
 
-    // exit the slot list
-    if (pool->slot_list) tb_allocator_large_free(pool->large_allocator, pool->slot_list);
-    pool->slot_list = tb_null;
+    // exit the slot map
+    if (pool->slot_map) tb_allocator_large_free(pool->large_allocator, pool->slot_map);
+    pool->slot_map = tb_null;
+    pool->slot_map_size = 0;
+    pool->slot_map_maxn = 0;
     pool->slot_count = 0;
-    pool->slot_space = 0;
 
     // exit it
     tb_allocator_large_free(pool->large_allocator, pool);
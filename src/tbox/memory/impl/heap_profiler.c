@@ -0,0 +1,411 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        heap_profiler.c
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "heap_profiler"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "heap_profiler.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the backtrace frame maxn
+#define TB_HEAP_PROFILER_FRAME_MAXN         (32)
+
+// the stack bucket count, must be power of 2
+#define TB_HEAP_PROFILER_STACK_BUCKETS      (1024)
+
+// the sample bucket count, must be power of 2
+#define TB_HEAP_PROFILER_SAMPLE_BUCKETS     (4096)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the heap profiler stack type
+typedef struct __tb_heap_profiler_stack_t
+{
+    // the next stack in the same bucket
+    struct __tb_heap_profiler_stack_t*  next;
+
+    // the hash
+    tb_size_t                           hash;
+
+    // the frame count
+    tb_size_t                           nframe;
+
+    // the frames
+    tb_pointer_t                        frames[TB_HEAP_PROFILER_FRAME_MAXN];
+
+    // the sampled allocation count
+    tb_size_t                           alloc_count;
+
+    // the sampled allocation size
+    tb_hize_t                           alloc_size;
+
+    // the sampled live count
+    tb_size_t                           live_count;
+
+    // the sampled live size
+    tb_hize_t                           live_size;
+
+}tb_heap_profiler_stack_t, *tb_heap_profiler_stack_ref_t;
+
+// the heap profiler sample type
+typedef struct __tb_heap_profiler_sample_t
+{
+    // the next sample in the same bucket
+    struct __tb_heap_profiler_sample_t* next;
+
+    // the data address
+    tb_cpointer_t                       data;
+
+    // the data size
+    tb_size_t                           size;
+
+    // the stack
+    tb_heap_profiler_stack_ref_t        stack;
+
+}tb_heap_profiler_sample_t, *tb_heap_profiler_sample_ref_t;
+
+// the heap profiler type
+typedef struct __tb_heap_profiler_t
+{
+    // the sample rate
+    tb_size_t                           rate;
+
+    // the left bytes before the next sample
+    tb_long_t                           left;
+
+    // the random seed
+    tb_uint64_t                         seed;
+
+    // the stack count
+    tb_size_t                           stack_count;
+
+    // the stacks
+    tb_heap_profiler_stack_ref_t        stacks[TB_HEAP_PROFILER_STACK_BUCKETS];
+
+    // the live samples
+    tb_heap_profiler_sample_ref_t       samples[TB_HEAP_PROFILER_SAMPLE_BUCKETS];
+
+}tb_heap_profiler_t, *tb_heap_profiler_impl_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_long_t tb_heap_profiler_interval(tb_heap_profiler_impl_ref_t profiler)
+{
+    // xorshift64
+    tb_uint64_t x = profiler->seed;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    profiler->seed = x;
+
+    /* the next sample interval is uniform in [1, rate * 2], its mean is the sample rate
+     *
+     * it avoids sampling the same allocation pattern at every fixed period
+     */
+    return (tb_long_t)(x % (profiler->rate << 1)) + 1;
+}
+static __tb_inline__ tb_size_t tb_heap_profiler_sample_index(tb_cpointer_t data)
+{
+    return (tb_size_t)((((tb_size_t)data >> 4) * 2654435761ul) & (TB_HEAP_PROFILER_SAMPLE_BUCKETS - 1));
+}
+static tb_heap_profiler_stack_ref_t tb_heap_profiler_stack(tb_heap_profiler_impl_ref_t profiler, tb_pointer_t* frames, tb_size_t nframe)
+{
+    // compute the stack hash
+    tb_size_t i = 0;
+    tb_size_t hash = 2166136261ul;
+    for (i = 0; i < nframe; i++) hash = (hash ^ (tb_size_t)frames[i]) * 16777619ul;
+
+    // find the stack
+    tb_size_t                       index = hash & (TB_HEAP_PROFILER_STACK_BUCKETS - 1);
+    tb_heap_profiler_stack_ref_t    stack = profiler->stacks[index];
+    for (; stack; stack = stack->next)
+    {
+        if (stack->hash == hash && stack->nframe == nframe && !tb_memcmp_(stack->frames, frames, nframe * sizeof(tb_pointer_t)))
+            return stack;
+    }
+
+    // make a new stack
+    stack = (tb_heap_profiler_stack_ref_t)tb_native_memory_malloc0(sizeof(tb_heap_profiler_stack_t));
+    tb_assert_and_check_return_val(stack, tb_null);
+
+    // init stack
+    stack->hash     = hash;
+    stack->nframe   = nframe;
+    tb_memcpy_(stack->frames, frames, nframe * sizeof(tb_pointer_t));
+
+    // insert stack
+    stack->next             = profiler->stacks[index];
+    profiler->stacks[index] = stack;
+    profiler->stack_count++;
+
+    // ok
+    return stack;
+}
+static tb_bool_t tb_heap_profiler_append(tb_char_t** pdata, tb_size_t* psize, tb_size_t* pmaxn, tb_char_t const* format, ...)
+{
+    // grow the profile data, one line is always less than 1024 bytes
+    if (*psize + 1024 > *pmaxn)
+    {
+        tb_size_t   maxn = tb_max(*pmaxn << 1, 8192);
+        tb_char_t*  data = (tb_char_t*)tb_native_memory_ralloc(*pdata, maxn);
+        tb_assert_and_check_return_val(data, tb_false);
+
+        // update data
+        *pdata = data;
+        *pmaxn = maxn;
+    }
+
+    // format line
+    tb_long_t size = 0;
+    tb_char_t* line = *pdata + *psize;
+    tb_vsnprintf_format(line, *pmaxn - *psize, format, &size);
+    tb_assert_and_check_return_val(size >= 0, tb_false);
+
+    // ok
+    *psize += size;
+    return tb_true;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_heap_profiler_ref_t tb_heap_profiler_init(tb_size_t rate)
+{
+    // make profiler
+    tb_heap_profiler_impl_ref_t profiler = (tb_heap_profiler_impl_ref_t)tb_native_memory_malloc0(sizeof(tb_heap_profiler_t));
+    tb_assert_and_check_return_val(profiler, tb_null);
+
+    // init profiler
+    profiler->rate  = rate? rate : TB_HEAP_PROFILER_SAMPLE_RATE;
+    profiler->seed  = ((tb_uint64_t)tb_uclock() << 1) | 1;
+    profiler->left  = tb_heap_profiler_interval(profiler);
+
+    // ok
+    return (tb_heap_profiler_ref_t)profiler;
+}
+tb_void_t tb_heap_profiler_exit(tb_heap_profiler_ref_t self)
+{
+    // check
+    tb_heap_profiler_impl_ref_t profiler = (tb_heap_profiler_impl_ref_t)self;
+    tb_assert_and_check_return(profiler);
+
+    // free all live samples
+    tb_heap_profiler_clear(self);
+
+    // free all stacks
+    tb_size_t i = 0;
+    for (i = 0; i < TB_HEAP_PROFILER_STACK_BUCKETS; i++)
+    {
+        tb_heap_profiler_stack_ref_t stack = profiler->stacks[i];
+        while (stack)
+        {
+            tb_heap_profiler_stack_ref_t next = stack->next;
+            tb_native_memory_free(stack);
+            stack = next;
+        }
+    }
+
+    // free it
+    tb_native_memory_free(profiler);
+}
+tb_void_t tb_heap_profiler_malloc(tb_heap_profiler_ref_t self, tb_cpointer_t data, tb_size_t size)
+{
+    // check
+    tb_heap_profiler_impl_ref_t profiler = (tb_heap_profiler_impl_ref_t)self;
+    tb_assert_and_check_return(profiler && data);
+
+    // not sampled? only count down the allocated bytes
+    profiler->left -= (tb_long_t)size;
+    tb_check_return(profiler->left <= 0);
+
+    // compute the next sample interval
+    profiler->left = tb_heap_profiler_interval(profiler);
+
+    // get the backtrace frames, skip the frames of the profiler
+    tb_pointer_t    frames[TB_HEAP_PROFILER_FRAME_MAXN];
+    tb_size_t       nframe = tb_backtrace_frames(frames, TB_HEAP_PROFILER_FRAME_MAXN, 2);
+    tb_check_return(nframe);
+
+    // get the stack
+    tb_heap_profiler_stack_ref_t stack = tb_heap_profiler_stack(profiler, frames, nframe);
+    tb_check_return(stack);
+
+    // make sample
+    tb_heap_profiler_sample_ref_t sample = (tb_heap_profiler_sample_ref_t)tb_native_memory_malloc0(sizeof(tb_heap_profiler_sample_t));
+    tb_assert_and_check_return(sample);
+
+    // init sample
+    sample->data    = data;
+    sample->size    = size;
+    sample->stack   = stack;
+
+    // insert sample
+    tb_size_t index             = tb_heap_profiler_sample_index(data);
+    sample->next                = profiler->samples[index];
+    profiler->samples[index]    = sample;
+
+    // update the stack
+    stack->alloc_count++;
+    stack->alloc_size += size;
+    stack->live_count++;
+    stack->live_size += size;
+}
+tb_void_t tb_heap_profiler_free(tb_heap_profiler_ref_t self, tb_cpointer_t data)
+{
+    // check
+    tb_heap_profiler_impl_ref_t profiler = (tb_heap_profiler_impl_ref_t)self;
+    tb_assert_and_check_return(profiler && data);
+
+    // find the sample
+    tb_heap_profiler_sample_ref_t* psample = &profiler->samples[tb_heap_profiler_sample_index(data)];
+    while (*psample && (*psample)->data != data) psample = &(*psample)->next;
+
+    // not sampled?
+    tb_heap_profiler_sample_ref_t sample = *psample;
+    tb_check_return(sample);
+
+    // update the stack
+    tb_heap_profiler_stack_ref_t stack = sample->stack;
+    stack->live_count--;
+    stack->live_size -= sample->size;
+
+    // remove sample
+    *psample = sample->next;
+    tb_native_memory_free(sample);
+}
+tb_void_t tb_heap_profiler_clear(tb_heap_profiler_ref_t self)
+{
+    // check
+    tb_heap_profiler_impl_ref_t profiler = (tb_heap_profiler_impl_ref_t)self;
+    tb_assert_and_check_return(profiler);
+
+    // free all live samples
+    tb_size_t i = 0;
+    for (i = 0; i < TB_HEAP_PROFILER_SAMPLE_BUCKETS; i++)
+    {
+        tb_heap_profiler_sample_ref_t sample = profiler->samples[i];
+        while (sample)
+        {
+            tb_heap_profiler_sample_ref_t next = sample->next;
+
+            // update the stack
+            sample->stack->live_count--;
+            sample->stack->live_size -= sample->size;
+
+            // free sample
+            tb_native_memory_free(sample);
+            sample = next;
+        }
+        profiler->samples[i] = tb_null;
+    }
+}
+tb_char_t* tb_heap_profiler_make(tb_heap_profiler_ref_t self, tb_size_t* psize)
+{
+    // check
+    tb_heap_profiler_impl_ref_t profiler = (tb_heap_profiler_impl_ref_t)self;
+    tb_assert_and_check_return_val(profiler && psize, tb_null);
+
+    // compute the total counts
+    tb_size_t                       i = 0;
+    tb_size_t                       live_count = 0;
+    tb_hize_t                       live_size = 0;
+    tb_size_t                       alloc_count = 0;
+    tb_hize_t                       alloc_size = 0;
+    tb_heap_profiler_stack_ref_t    stack = tb_null;
+    for (i = 0; i < TB_HEAP_PROFILER_STACK_BUCKETS; i++)
+    {
+        for (stack = profiler->stacks[i]; stack; stack = stack->next)
+        {
+            live_count  += stack->live_count;
+            live_size   += stack->live_size;
+            alloc_count += stack->alloc_count;
+            alloc_size  += stack->alloc_size;
+        }
+    }
+
+    // done
+    tb_bool_t   ok = tb_false;
+    tb_char_t*  data = tb_null;
+    tb_size_t   size = 0;
+    tb_size_t   maxn = 0;
+    do
+    {
+        /* make the legacy heap profile header of pprof, the sampled counts will be scaled by pprof
+         *
+         * heap profile: <live_count>: <live_size> [<alloc_count>: <alloc_size>] @ heap_v2/<rate>
+         */
+        if (!tb_heap_profiler_append(&data, &size, &maxn, "heap profile: %lu: %llu [%lu: %llu] @ heap_v2/%lu\n", live_count, live_size, alloc_count, alloc_size, profiler->rate)) break;
+
+        // make the stack lines, <live_count>: <live_size> [<alloc_count>: <alloc_size>] @ <frame0> <frame1> ...
+        tb_bool_t failed = tb_false;
+        for (i = 0; i < TB_HEAP_PROFILER_STACK_BUCKETS && !failed; i++)
+        {
+            for (stack = profiler->stacks[i]; stack && !failed; stack = stack->next)
+            {
+                // make counts
+                if (!tb_heap_profiler_append(&data, &size, &maxn, "%lu: %llu [%lu: %llu] @", stack->live_count, stack->live_size, stack->alloc_count, stack->alloc_size))
+                {
+                    failed = tb_true;
+                    break;
+                }
+
+                // make frames
+                tb_size_t j = 0;
+                for (j = 0; j < stack->nframe && !failed; j++)
+                    failed = !tb_heap_profiler_append(&data, &size, &maxn, " 0x%lx", (tb_size_t)stack->frames[j]);
+                if (!failed) failed = !tb_heap_profiler_append(&data, &size, &maxn, "\n");
+            }
+        }
+        tb_check_break(!failed);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        if (data) tb_native_memory_free(data);
+        data = tb_null;
+        size = 0;
+    }
+
+    // ok?
+    *psize = size;
+    return data;
+}
@@ -0,0 +1,107 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        heap_profiler.h
+ *
+ */
+#ifndef TB_MEMORY_IMPL_HEAP_PROFILER_H
+#define TB_MEMORY_IMPL_HEAP_PROFILER_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default sample rate, sample one allocation per 512KB allocated bytes on average
+#define TB_HEAP_PROFILER_SAMPLE_RATE        (512 * 1024)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the heap profiler ref type
+typedef __tb_typeref__(heap_profiler);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* init the heap profiler
+ *
+ * @note it uses the native memory and it is not thread-safe, the allocator lock should be held when calling it
+ *
+ * @param rate          the sample rate (bytes), use the default rate if be zero
+ *
+ * @return              the heap profiler
+ */
+tb_heap_profiler_ref_t  tb_heap_profiler_init(tb_size_t rate);
+
+/* exit the heap profiler
+ *
+ * @param profiler      the heap profiler
+ */
+tb_void_t               tb_heap_profiler_exit(tb_heap_profiler_ref_t profiler);
+
+/* record the allocated data, the backtrace will be saved if this data is sampled
+ *
+ * @param profiler      the heap profiler
+ * @param data          the data address
+ * @param size          the data size
+ */
+tb_void_t               tb_heap_profiler_malloc(tb_heap_profiler_ref_t profiler, tb_cpointer_t data, tb_size_t size);
+
+/* record the freed data
+ *
+ * @param profiler      the heap profiler
+ * @param data          the data address
+ */
+tb_void_t               tb_heap_profiler_free(tb_heap_profiler_ref_t profiler, tb_cpointer_t data);
+
+/* clear all live data, e.g. the allocator has been cleared
+ *
+ * @param profiler      the heap profiler
+ */
+tb_void_t               tb_heap_profiler_clear(tb_heap_profiler_ref_t profiler);
+
+/* make the pprof-compatible heap profile
+ *
+ * @param profiler      the heap profiler
+ * @param psize         the profile size
+ *
+ * @return              the profile data, it should be freed by tb_native_memory_free()
+ */
+tb_char_t*              tb_heap_profiler_make(tb_heap_profiler_ref_t profiler, tb_size_t* psize);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
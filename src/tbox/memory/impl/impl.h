@@ -31,6 +31,8 @@
 #include "prefix.h"
 #include "memory.h"
 #include "native_large_allocator.h"
+#include "span_large_allocator.h"
+#include "heap_profiler.h"
 #include "static_large_allocator.h"
 
 
@@ -0,0 +1,963 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        span_large_allocator.c
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "span_large_allocator"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "span_large_allocator.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the arena size, it is two huge pages for the transparent huge pages
+#define TB_SPAN_LARGE_ALLOCATOR_ARENA_SIZE          (4 << 20)
+
+// the maximum page count of the span classes, the larger spans will be mapped directly
+#define TB_SPAN_LARGE_ALLOCATOR_CLASS_PAGES_MAXN    (256)
+
+// the maximum count of the span classes: 1, 2, .., 8, 10, 12, 14, 16, 20, 24, 28, 32, 40, .., 256
+#define TB_SPAN_LARGE_ALLOCATOR_CLASS_MAXN          (28)
+
+// the class index of the directly mapped span
+#define TB_SPAN_LARGE_ALLOCATOR_CLASS_DIRECT        ((tb_uint16_t)-1)
+
+// the default decay time of the idle spans
+#define TB_SPAN_LARGE_ALLOCATOR_DECAY               (10000)
+
+// the maximum interval of the decay checking
+#define TB_SPAN_LARGE_ALLOCATOR_DECAY_INTERVAL      (1000)
+
+// the head size of the span, it contains the data head and the aligned patch for checking underflow
+#ifdef __tb_debug__
+#   define TB_SPAN_LARGE_ALLOCATOR_HEAD_SIZE        (sizeof(tb_span_large_data_head_t) + TB_POOL_DATA_ALIGN)
+#else
+#   define TB_SPAN_LARGE_ALLOCATOR_HEAD_SIZE        (sizeof(tb_span_large_data_head_t))
+#endif
+
+// the span large allocator data base
+#define tb_span_large_allocator_data_base(data_head)   (&(((tb_pool_data_head_t*)((tb_span_large_data_head_t*)(data_head) + 1))[-1]))
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/* the span large data head type, it is placed before the data of the span
+ *
+ * the span in the arena is carved with the data head and the whole data pages, 
+ * so the page-multiple request will not take one more page for the data head
+ */
+typedef __tb_pool_data_aligned__ struct __tb_span_large_data_head_t
+{
+    // the allocator reference
+    tb_pointer_t                    allocator;
+
+    // the entry of the used or free span list
+    tb_list_entry_t                 entry;
+
+    // the freed time
+    tb_hong_t                       time;
+
+    // the page count
+    tb_uint32_t                     pages;
+
+    // the class index
+    tb_uint16_t                     cls;
+
+    // have been purged? only the whole pages in the span data will be purged, the data head will be kept
+    tb_uint16_t                     purged;
+
+    // the data head base
+    tb_byte_t                       base[sizeof(tb_pool_data_head_t)];
+
+}__tb_pool_data_aligned__ tb_span_large_data_head_t;
+
+// the span large arena type
+typedef struct __tb_span_large_arena_t
+{
+    // the entry
+    tb_list_entry_t                 entry;
+
+    // the data
+    tb_byte_t*                      data;
+
+    // the size
+    tb_size_t                       size;
+
+    // the carved size
+    tb_size_t                       used;
+
+}tb_span_large_arena_t;
+
+// the span large class type
+typedef struct __tb_span_large_class_t
+{
+    // the free spans, the most recently freed span is at the head and the purged spans are at the tail
+    tb_list_entry_head_t            free_list;
+
+    // the page count
+    tb_size_t                       pages;
+
+    // the used span count
+    tb_size_t                       used_count;
+
+    // the purged span count
+    tb_size_t                       purged_count;
+
+}tb_span_large_class_t;
+
+/*! the span large allocator type
+ *
+ * <pre>
+ *
+ * arenas:   ----------------------------------------------------------------------      ------------------
+ *          | head | span: 1 page | head | span: 2 pages | head | span: 1 page | ... | <=> |       ...        | 
+ *           ----------------------------------------------------------------------      ------------------
+ *                  |                               |
+ * classes:         |                               |
+ *  [1 page]:  free_list <=> ... <=> (purged) <=> ..`
+ *  [2 pages]: free_list <=> ...
+ *  ...
+ *  [256 pages]: free_list <=> ...
+ *
+ * direct:  |||  mapped span  | <=> |||  mapped span  | <=> ...
+ *
+ * </pre>
+ */
+typedef struct __tb_span_large_allocator_t
+{
+    // the base
+    tb_allocator_t                  base;
+
+    // the flags
+    tb_size_t                       flags;
+
+    // the decay time
+    tb_long_t                       decay;
+
+    // the last decay time
+    tb_hong_t                       decay_time;
+
+    // the page size
+    tb_size_t                       page_size;
+
+    // the arena size
+    tb_size_t                       arena_size;
+
+    // the arenas, the last arena is the current carving arena
+    tb_list_entry_head_t            arenas;
+
+    // the used spans in the arenas
+    tb_list_entry_head_t            used_list;
+
+    // the directly mapped spans
+    tb_list_entry_head_t            direct_list;
+
+    // the span classes
+    tb_span_large_class_t           classes[TB_SPAN_LARGE_ALLOCATOR_CLASS_MAXN];
+
+    // the span class count
+    tb_size_t                       class_count;
+
+    // the mapped size of all arenas
+    tb_size_t                       arena_mapped_size;
+
+    // the mapped size of all direct spans
+    tb_size_t                       direct_mapped_size;
+
+    // the free size of all free spans
+    tb_size_t                       free_size;
+
+    // the purged size of all free spans
+    tb_size_t                       purged_size;
+
+    // the purge count
+    tb_size_t                       purge_count;
+
+#ifdef __tb_debug__
+    // the peak size
+    tb_size_t                       peak_size;
+
+    // the total size
+    tb_size_t                       total_size;
+
+    // the real size
+    tb_size_t                       real_size;
+
+    // the occupied size
+    tb_size_t                       occupied_size;
+
+    // the malloc count
+    tb_size_t                       malloc_count;
+
+    // the ralloc count
+    tb_size_t                       ralloc_count;
+
+    // the free count
+    tb_size_t                       free_count;
+#endif
+
+}tb_span_large_allocator_t, *tb_span_large_allocator_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline__ tb_size_t tb_span_large_allocator_space(tb_span_large_allocator_ref_t allocator, tb_span_large_data_head_t const* data_head)
+{
+    // the directly mapped span contains the data head and patch
+    if (data_head->cls == TB_SPAN_LARGE_ALLOCATOR_CLASS_DIRECT) 
+        return data_head->pages * allocator->page_size - TB_SPAN_LARGE_ALLOCATOR_HEAD_SIZE;
+
+    // the span in the arena has the whole data pages
+    return data_head->pages * allocator->page_size;
+}
+static __tb_inline__ tb_size_t tb_span_large_allocator_span_size(tb_span_large_allocator_ref_t allocator, tb_size_t pages)
+{
+    // the carved size of the span in the arena, it is the data head and the whole data pages
+    return TB_SPAN_LARGE_ALLOCATOR_HEAD_SIZE + pages * allocator->page_size;
+}
+static tb_size_t tb_span_large_allocator_map_flags(tb_span_large_allocator_ref_t allocator)
+{
+    tb_size_t flags = TB_PAGE_MAP_FLAG_NONE;
+    if (allocator->flags & TB_LARGE_ALLOCATOR_FLAG_HUGE_PAGE) flags |= TB_PAGE_MAP_FLAG_HUGE;
+    if (allocator->flags & TB_LARGE_ALLOCATOR_FLAG_HUGE_PAGE_EXPLICIT) flags |= TB_PAGE_MAP_FLAG_HUGE_EXPLICIT;
+    return flags;
+}
+static tb_size_t tb_span_large_allocator_class(tb_span_large_allocator_ref_t allocator, tb_size_t pages)
+{
+    // the small classes are continuous
+    if (pages <= 8) return pages - 1;
+
+    // find the smallest class which contains the given pages
+    tb_size_t i = 8;
+    for (; i < allocator->class_count && allocator->classes[i].pages < pages; i++) ;
+    tb_assert(i < allocator->class_count);
+    return i;
+}
+static tb_void_t tb_span_large_allocator_free_span(tb_span_large_allocator_ref_t allocator, tb_span_large_data_head_t* data_head, tb_hong_t time, tb_bool_t purged)
+{
+    // the class
+    tb_span_large_class_t* cls = &allocator->classes[data_head->cls];
+
+    // init the free span
+    data_head->allocator    = (tb_pointer_t)allocator;
+    data_head->time         = time;
+    data_head->purged       = (tb_uint16_t)purged;
+
+    // the purged span will be placed at the tail, the recently freed span will be reused first
+    if (purged) tb_list_entry_insert_tail(&cls->free_list, &data_head->entry);
+    else tb_list_entry_insert_head(&cls->free_list, &data_head->entry);
+
+    // update the free and purged size
+    allocator->free_size += data_head->pages * allocator->page_size;
+    if (purged)
+    {
+        allocator->purged_size += (data_head->pages - 1) * allocator->page_size;
+        cls->purged_count++;
+    }
+}
+static tb_void_t tb_span_large_allocator_retire(tb_span_large_allocator_ref_t allocator, tb_span_large_arena_t* arena)
+{
+    // split the left space of the arena to the free spans
+    tb_size_t left = arena->size - arena->used;
+    while (left >= tb_span_large_allocator_span_size(allocator, 1))
+    {
+        // find the largest class which can be placed in the left space
+        tb_size_t i = allocator->class_count;
+        while (i && tb_span_large_allocator_span_size(allocator, allocator->classes[i - 1].pages) > left) i--;
+        tb_assert_and_check_break(i);
+
+        // make a free span, it has not been accessed and we need not purge it 
+        tb_span_large_data_head_t* data_head = (tb_span_large_data_head_t*)(arena->data + arena->used);
+        data_head->pages    = (tb_uint32_t)allocator->classes[i - 1].pages;
+        data_head->cls      = (tb_uint16_t)(i - 1);
+        tb_span_large_allocator_free_span(allocator, data_head, 0, tb_true);
+
+        // update the carved size
+        tb_size_t size = tb_span_large_allocator_span_size(allocator, data_head->pages);
+        arena->used += size;
+        left -= size;
+    }
+}
+static tb_span_large_data_head_t* tb_span_large_allocator_carve(tb_span_large_allocator_ref_t allocator, tb_size_t cls)
+{
+    // the span size
+    tb_size_t size = tb_span_large_allocator_span_size(allocator, allocator->classes[cls].pages);
+
+    // the current arena is not enough? retire it
+    tb_span_large_arena_t* arena = tb_null;
+    if (!tb_list_entry_is_null(&allocator->arenas))
+    {
+        arena = (tb_span_large_arena_t*)tb_list_entry(&allocator->arenas, tb_list_entry_last(&allocator->arenas));
+        if (arena->used + size > arena->size)
+        {
+            tb_span_large_allocator_retire(allocator, arena);
+            arena = tb_null;
+        }
+    }
+
+    // map a new arena
+    if (!arena)
+    {
+        // make arena
+        arena = (tb_span_large_arena_t*)tb_native_memory_malloc0(sizeof(tb_span_large_arena_t));
+        tb_assert_and_check_return_val(arena, tb_null);
+
+        // map the arena pages
+        arena->size = allocator->arena_size;
+        arena->data = (tb_byte_t*)tb_page_map(arena->size, tb_span_large_allocator_map_flags(allocator));
+        if (!arena->data)
+        {
+            tb_native_memory_free(arena);
+            return tb_null;
+        }
+
+        // save arena
+        tb_list_entry_insert_tail(&allocator->arenas, &arena->entry);
+        allocator->arena_mapped_size += arena->size;
+
+        // trace
+        tb_trace_d("arena: map %p, size: %lu", arena->data, arena->size);
+    }
+
+    // carve a new span 
+    tb_span_large_data_head_t* data_head = (tb_span_large_data_head_t*)(arena->data + arena->used);
+    data_head->pages    = (tb_uint32_t)allocator->classes[cls].pages;
+    data_head->cls      = (tb_uint16_t)cls;
+    data_head->purged   = 0;
+    arena->used += size;
+    return data_head;
+}
+static tb_void_t tb_span_large_allocator_decay(tb_span_large_allocator_ref_t allocator, tb_hong_t now)
+{
+    // never purge them?
+    tb_check_return(allocator->decay >= 0);
+
+    // check it at most once per interval
+    tb_check_return(now - allocator->decay_time >= tb_min(allocator->decay, TB_SPAN_LARGE_ALLOCATOR_DECAY_INTERVAL));
+    allocator->decay_time = now;
+
+    // no resident idle spans?
+    tb_check_return(allocator->free_size > allocator->purged_size);
+
+    // purge the idle spans which have been freed before the decay time
+    tb_size_t i = 0;
+    tb_size_t page_size = allocator->page_size;
+    tb_bool_t lazy = (allocator->flags & TB_LARGE_ALLOCATOR_FLAG_LAZY_PURGE)? tb_true : tb_false;
+    for (i = 0; i < allocator->class_count; i++)
+    {
+        // walk the free spans from the oldest span
+        tb_span_large_class_t*  cls = &allocator->classes[i];
+        tb_list_entry_ref_t     entry = tb_list_entry_last(&cls->free_list);
+        while (entry != tb_list_entry_tail(&cls->free_list))
+        {
+            // the data head
+            tb_span_large_data_head_t* data_head = (tb_span_large_data_head_t*)tb_list_entry(&cls->free_list, entry);
+            entry = tb_list_entry_prev(entry);
+
+            // skip the purged spans
+            if (data_head->purged) continue;
+
+            // not expired? the newer spans are also not expired
+            if (now - data_head->time < allocator->decay) break;
+
+            /* purge the whole pages in the span data, the span head need be kept in the free list
+             *
+             * the span data is not page-aligned, so there are (pages - 1) whole pages in it at least
+             */
+            if (data_head->pages > 1) 
+            {
+                tb_byte_t* data = (tb_byte_t*)tb_align((tb_size_t)&data_head[1], page_size);
+                tb_page_purge(data, (data_head->pages - 1) * page_size, lazy);
+            }
+            data_head->purged = 1;
+            allocator->purged_size += (data_head->pages - 1) * page_size;
+            cls->purged_count++;
+            allocator->purge_count++;
+        }
+    }
+}
+static tb_span_large_data_head_t* tb_span_large_allocator_malloc_span(tb_span_large_allocator_ref_t allocator, tb_size_t space)
+{
+    // done
+    tb_span_large_data_head_t* data_head = tb_null;
+    tb_size_t page_size = allocator->page_size;
+    tb_size_t pages = (space + page_size - 1) / page_size;
+    if (pages <= TB_SPAN_LARGE_ALLOCATOR_CLASS_PAGES_MAXN)
+    {
+        // the class
+        tb_size_t               index = tb_span_large_allocator_class(allocator, pages);
+        tb_span_large_class_t*  cls = &allocator->classes[index];
+
+        // reuse the most recently freed span first
+        if (!tb_list_entry_is_null(&cls->free_list))
+        {
+            // pop it
+            data_head = (tb_span_large_data_head_t*)tb_list_entry(&cls->free_list, tb_list_entry_head(&cls->free_list));
+            tb_list_entry_remove_head(&cls->free_list);
+
+            // update the free and purged size
+            allocator->free_size -= data_head->pages * page_size;
+            if (data_head->purged)
+            {
+                allocator->purged_size -= (data_head->pages - 1) * page_size;
+                cls->purged_count--;
+                data_head->purged = 0;
+            }
+        }
+        // carve a new span from the arena
+        else data_head = tb_span_large_allocator_carve(allocator, index);
+        tb_check_return_val(data_head, tb_null);
+
+        // save it to the used list
+        tb_list_entry_insert_tail(&allocator->used_list, &data_head->entry);
+        cls->used_count++;
+    }
+    else
+    {
+        // map the large span directly, the data head and patch are placed in the mapped pages
+        pages = (TB_SPAN_LARGE_ALLOCATOR_HEAD_SIZE + space + page_size - 1) / page_size;
+        tb_size_t size = pages * page_size;
+        data_head = (tb_span_large_data_head_t*)tb_page_map(size, tb_span_large_allocator_map_flags(allocator));
+        tb_check_return_val(data_head, tb_null);
+
+        // init it
+        data_head->pages    = (tb_uint32_t)pages;
+        data_head->cls      = TB_SPAN_LARGE_ALLOCATOR_CLASS_DIRECT;
+        data_head->purged   = 0;
+
+        // save it to the direct list
+        tb_list_entry_insert_tail(&allocator->direct_list, &data_head->entry);
+        allocator->direct_mapped_size += size;
+    }
+
+    // save allocator reference for checking data range
+    data_head->allocator = (tb_pointer_t)allocator;
+    return data_head;
+}
+static tb_void_t tb_span_large_allocator_free_done(tb_span_large_allocator_ref_t allocator, tb_span_large_data_head_t* data_head)
+{
+    // the directly mapped span? unmap it
+    if (data_head->cls == TB_SPAN_LARGE_ALLOCATOR_CLASS_DIRECT)
+    {
+        // remove it from the direct list
+        tb_list_entry_remove(&allocator->direct_list, &data_head->entry);
+
+        // unmap it
+        tb_size_t size = data_head->pages * allocator->page_size;
+        allocator->direct_mapped_size -= size;
+        tb_page_unmap(data_head, size);
+    }
+    else
+    {
+        // remove it from the used list
+        tb_list_entry_remove(&allocator->used_list, &data_head->entry);
+        allocator->classes[data_head->cls].used_count--;
+
+        // free it to the class
+        tb_hong_t now = tb_mclock();
+        tb_span_large_allocator_free_span(allocator, data_head, now, tb_false);
+
+        // purge the expired idle spans
+        tb_span_large_allocator_decay(allocator, now);
+    }
+}
+#ifdef __tb_debug__
+static tb_void_t tb_span_large_allocator_check_data(tb_span_large_allocator_ref_t allocator, tb_span_large_data_head_t const* data_head)
+{
+    // check
+    tb_assert_and_check_return(allocator && data_head);
+
+    // done
+    tb_bool_t           ok = tb_false;
+    tb_byte_t const*    data = (tb_byte_t const*)&(data_head[1]);
+    do
+    {
+        // the base head
+        tb_pool_data_head_t* base_head = tb_span_large_allocator_data_base(data_head);
+
+        // check
+        tb_assertf_pass_break(base_head->debug.magic != (tb_uint16_t)~TB_POOL_DATA_MAGIC, "data have been freed: %p", data);
+        tb_assertf_pass_break(base_head->debug.magic == TB_POOL_DATA_MAGIC, "the invalid data: %p", data);
+        tb_assertf_pass_break(((tb_byte_t*)data)[base_head->size] == TB_POOL_DATA_PATCH, "data underflow");
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed? dump it
+    if (!ok) 
+    {
+        // dump data
+        tb_pool_data_dump(data, tb_true, "[span_large_allocator]: [error]: ");
+
+        // abort
+        tb_abort();
+    }
+}
+static tb_void_t tb_span_large_allocator_check_data_head(tb_span_large_allocator_ref_t allocator, tb_span_large_data_head_t const* data_head, tb_pointer_t data)
+{
+    // the base head
+    tb_pool_data_head_t* base_head = tb_span_large_allocator_data_base(data_head);
+
+    // check
+    tb_assertf(base_head->debug.magic != (tb_uint16_t)~TB_POOL_DATA_MAGIC, "the data have been freed: %p", data);
+    tb_assertf(base_head->debug.magic == TB_POOL_DATA_MAGIC, "the invalid data: %p", data);
+    tb_assertf(data_head->allocator == (tb_pointer_t)allocator, "the data: %p not belong to allocator: %p", data, allocator);
+    tb_assertf(((tb_byte_t*)data)[base_head->size] == TB_POOL_DATA_PATCH, "data underflow");
+
+    // check the last data
+    if (!tb_list_entry_is_null(&allocator->used_list))
+        tb_span_large_allocator_check_data(allocator, (tb_span_large_data_head_t*)tb_list_entry(&allocator->used_list, tb_list_entry_last(&allocator->used_list)));
+}
+#endif
+static tb_pointer_t tb_span_large_allocator_malloc_done(tb_span_large_allocator_ref_t allocator, tb_size_t size, tb_size_t space, tb_size_t* real __tb_debug_decl__)
+{
+    // check
+    tb_assert_and_check_return_val(allocator && space >= size, tb_null);
+
+    // make span with the given space
+    tb_span_large_data_head_t* data_head = tb_span_large_allocator_malloc_span(allocator, space);
+    tb_check_return_val(data_head, tb_null);
+
+    // the real size, we can use the whole span
+    tb_size_t size_real = real? tb_span_large_allocator_space(allocator, data_head) : size;
+    if (real) *real = size_real;
+
+    // the base head
+    tb_pool_data_head_t* base_head = tb_span_large_allocator_data_base(data_head);
+    base_head->size = (tb_uint32_t)size_real;
+
+    // the real data
+    tb_byte_t* data_real = (tb_byte_t*)&data_head[1];
+
+#ifdef __tb_debug__
+    base_head->debug.magic     = TB_POOL_DATA_MAGIC;
+    base_head->debug.file      = file_;
+    base_head->debug.func      = func_;
+    base_head->debug.line      = (tb_uint16_t)line_;
+
+    // save backtrace
+    tb_pool_data_save_backtrace(&base_head->debug, 5);
+
+    // make the dirty data and patch 0xcc for checking underflow
+    tb_memset_(data_real, TB_POOL_DATA_PATCH, size_real + 1);
+
+    // update the real size
+    allocator->real_size     += size_real;
+
+    // update the occupied size
+    allocator->occupied_size += data_head->pages * allocator->page_size;
+
+    // update the total size
+    allocator->total_size    += size_real;
+
+    // update the peak size
+    if (allocator->total_size > allocator->peak_size) allocator->peak_size = allocator->total_size;
+
+    // update the malloc count
+    allocator->malloc_count++;
+#endif
+
+    // ok
+    return (tb_pointer_t)data_real;
+}
+static tb_pointer_t tb_span_large_allocator_malloc(tb_allocator_ref_t self, tb_size_t size, tb_size_t* real __tb_debug_decl__)
+{
+    return tb_span_large_allocator_malloc_done((tb_span_large_allocator_ref_t)self, size, size, real __tb_debug_args__);
+}
+static tb_bool_t tb_span_large_allocator_free(tb_allocator_ref_t self, tb_pointer_t data __tb_debug_decl__)
+{
+    // check
+    tb_span_large_allocator_ref_t allocator = (tb_span_large_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator && data, tb_false);
+
+    // the data head
+    tb_span_large_data_head_t* data_head = &(((tb_span_large_data_head_t*)data)[-1]);
+    tb_assertf_and_check_return_val(data_head->allocator == (tb_pointer_t)allocator, tb_false, "the data: %p not belong to allocator: %p", data, allocator);
+
+#ifdef __tb_debug__
+    // check it
+    tb_span_large_allocator_check_data_head(allocator, data_head, data);
+
+    // the base head
+    tb_pool_data_head_t* base_head = tb_span_large_allocator_data_base(data_head);
+
+    // for checking double-free
+    base_head->debug.magic = (tb_uint16_t)~TB_POOL_DATA_MAGIC;
+
+    // update the real size
+    allocator->real_size     -= base_head->size;
+
+    // update the occupied size
+    allocator->occupied_size -= data_head->pages * allocator->page_size;
+
+    // update the total size
+    allocator->total_size    -= base_head->size;
+   
+    // update the free count
+    allocator->free_count++;
+#endif
+
+    // free it
+    tb_span_large_allocator_free_done(allocator, data_head);
+    return tb_true;
+}
+static tb_pointer_t tb_span_large_allocator_ralloc(tb_allocator_ref_t self, tb_pointer_t data, tb_size_t size, tb_size_t* real __tb_debug_decl__)
+{
+    // check
+    tb_span_large_allocator_ref_t allocator = (tb_span_large_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator && data, tb_null);
+
+    // the data head
+    tb_span_large_data_head_t* data_head = &(((tb_span_large_data_head_t*)data)[-1]);
+    tb_assertf_and_check_return_val(data_head->allocator == (tb_pointer_t)allocator, tb_null, "the data: %p not belong to allocator: %p", data, allocator);
+
+    // the base head
+    tb_pool_data_head_t* base_head = tb_span_large_allocator_data_base(data_head);
+
+#ifdef __tb_debug__
+    // check it
+    tb_span_large_allocator_check_data_head(allocator, data_head, data);
+#endif
+
+    // the span space is enough? ralloc it in place
+    tb_size_t space = tb_span_large_allocator_space(allocator, data_head);
+    if (size <= space)
+    {
+        // the real size
+        tb_size_t size_real = real? space : size;
+        if (real) *real = size_real;
+
+#ifdef __tb_debug__
+        // update the base head
+        tb_size_t prev_size = base_head->size;
+        base_head->debug.file      = file_;
+        base_head->debug.func      = func_;
+        base_head->debug.line      = (tb_uint16_t)line_;
+
+        // update backtrace
+        tb_pool_data_save_backtrace(&base_head->debug, 5);
+
+        // make the dirty data 
+        if (size_real > prev_size) tb_memset_((tb_byte_t*)data + prev_size, TB_POOL_DATA_PATCH, size_real - prev_size);
+
+        // patch 0xcc for checking underflow
+        ((tb_byte_t*)data)[size_real] = TB_POOL_DATA_PATCH;
+
+        // update the real and total size
+        allocator->real_size     += size_real;
+        allocator->real_size     -= prev_size;
+        allocator->total_size    += size_real;
+        allocator->total_size    -= prev_size;
+
+        // update the peak size
+        if (allocator->total_size > allocator->peak_size) allocator->peak_size = allocator->total_size;
+
+        // update the ralloc count
+        allocator->ralloc_count++;
+#endif
+
+        // save the real size
+        base_head->size = (tb_uint32_t)size_real;
+        return data;
+    }
+
+    /* make a new larger span
+     *
+     * the directly mapped span is grown geometrically, 
+     * otherwise growing a large block in small steps will map and copy the whole data for each page
+     */
+    tb_size_t prev_size = base_head->size;
+    tb_size_t space_new = size;
+    if (size > TB_SPAN_LARGE_ALLOCATOR_CLASS_PAGES_MAXN * allocator->page_size) 
+        space_new = tb_max(size, space + (space >> 1));
+    tb_pointer_t data_new = tb_span_large_allocator_malloc_done(allocator, size, space_new, real __tb_debug_args__);
+    tb_check_return_val(data_new, tb_null);
+
+    // copy the previous data
+    tb_memcpy_(data_new, data, tb_min(prev_size, size));
+
+    // free the previous span
+    tb_span_large_allocator_free(self, data __tb_debug_args__);
+
+#ifdef __tb_debug__
+    // update the ralloc count, it has been counted as malloc and free
+    allocator->malloc_count--;
+    allocator->free_count--;
+    allocator->ralloc_count++;
+#endif
+
+    // ok
+    return data_new;
+}
+static tb_void_t tb_span_large_allocator_clear(tb_allocator_ref_t self)
+{
+    // check
+    tb_span_large_allocator_ref_t allocator = (tb_span_large_allocator_ref_t)self;
+    tb_assert_and_check_return(allocator);
+
+    // unmap all direct spans
+    while (!tb_list_entry_is_null(&allocator->direct_list))
+    {
+        tb_span_large_data_head_t* data_head = (tb_span_large_data_head_t*)tb_list_entry(&allocator->direct_list, tb_list_entry_head(&allocator->direct_list));
+        tb_list_entry_remove_head(&allocator->direct_list);
+        tb_page_unmap(data_head, data_head->pages * allocator->page_size);
+    }
+
+    // unmap all arenas
+    while (!tb_list_entry_is_null(&allocator->arenas))
+    {
+        tb_span_large_arena_t* arena = (tb_span_large_arena_t*)tb_list_entry(&allocator->arenas, tb_list_entry_head(&allocator->arenas));
+        tb_list_entry_remove_head(&allocator->arenas);
+        tb_page_unmap(arena->data, arena->size);
+        tb_native_memory_free(arena);
+    }
+
+    // clear all spans
+    tb_size_t i = 0;
+    for (i = 0; i < allocator->class_count; i++)
+    {
+        tb_list_entry_clear(&allocator->classes[i].free_list);
+        allocator->classes[i].used_count    = 0;
+        allocator->classes[i].purged_count  = 0;
+    }
+    tb_list_entry_clear(&allocator->used_list);
+
+    // clear info
+    allocator->arena_mapped_size    = 0;
+    allocator->direct_mapped_size   = 0;
+    allocator->free_size            = 0;
+    allocator->purged_size          = 0;
+    allocator->purge_count          = 0;
+#ifdef __tb_debug__
+    allocator->peak_size            = 0;
+    allocator->total_size           = 0;
+    allocator->real_size            = 0;
+    allocator->occupied_size        = 0;
+    allocator->malloc_count         = 0;
+    allocator->ralloc_count         = 0;
+    allocator->free_count           = 0;
+#endif
+}
+static tb_void_t tb_span_large_allocator_exit(tb_allocator_ref_t self)
+{
+    // check
+    tb_span_large_allocator_ref_t allocator = (tb_span_large_allocator_ref_t)self;
+    tb_assert_and_check_return(allocator);
+
+    // clear it
+    tb_span_large_allocator_clear(self);
+
+    // exit lock
+    tb_spinlock_exit(&allocator->base.lock);
+
+    // exit it
+    tb_native_memory_free(allocator);
+}
+#ifdef __tb_debug__
+static tb_void_t tb_span_large_allocator_dump(tb_allocator_ref_t self)
+{
+    // check
+    tb_span_large_allocator_ref_t allocator = (tb_span_large_allocator_ref_t)self;
+    tb_assert_and_check_return(allocator);
+
+    // trace
+    tb_trace_i("");
+
+    // dump the leaks
+    tb_list_entry_head_ref_t    lists[] = {&allocator->used_list, &allocator->direct_list};
+    tb_size_t                   i = 0;
+    for (i = 0; i < tb_arrayn(lists); i++)
+    {
+        tb_for_all_if (tb_span_large_data_head_t*, data_head, tb_list_entry_itor(lists[i]), data_head)
+        {
+            // check it
+            tb_span_large_allocator_check_data(allocator, data_head);
+
+            // trace
+            tb_trace_e("leak: %p", &data_head[1]);
+
+            // dump data
+            tb_pool_data_dump((tb_byte_t const*)&data_head[1], tb_false, "[span_large_allocator]: [error]: ");
+        }
+    }
+
+    // dump the span classes
+    tb_size_t unused_size = 0;
+    for (i = 0; i < allocator->class_count; i++)
+    {
+        tb_span_large_class_t* cls = &allocator->classes[i];
+        tb_size_t free_count = tb_list_entry_size(&cls->free_list);
+        if (cls->used_count || free_count)
+        {
+            tb_trace_i("[%lu]: used: %lu, free: %lu, purged: %lu", cls->pages * allocator->page_size, cls->used_count, free_count, cls->purged_count);
+        }
+    }
+
+    // the uncarved size of the current arena
+    if (!tb_list_entry_is_null(&allocator->arenas))
+    {
+        tb_span_large_arena_t* arena = (tb_span_large_arena_t*)tb_list_entry(&allocator->arenas, tb_list_entry_last(&allocator->arenas));
+        unused_size = arena->size - arena->used;
+    }
+
+    // trace debug info
+    tb_size_t idle_size = allocator->free_size - allocator->purged_size;
+    tb_trace_i("arenas: %lu, arena_size: %lu, direct_size: %lu", tb_list_entry_size(&allocator->arenas), allocator->arena_mapped_size, allocator->direct_mapped_size);
+    tb_trace_i("idle_size: %lu, purged_size: %lu, purge_count: %lu", idle_size, allocator->purged_size, allocator->purge_count);
+    tb_trace_i("frag_rate: %llu/10000",     allocator->arena_mapped_size? (((tb_hize_t)allocator->free_size + unused_size) * 10000) / (tb_hize_t)allocator->arena_mapped_size : 0);
+    tb_trace_i("peak_size: %lu",            allocator->peak_size);
+    tb_trace_i("wast_rate: %llu/10000",     allocator->occupied_size? (((tb_hize_t)allocator->occupied_size - allocator->real_size) * 10000) / (tb_hize_t)allocator->occupied_size : 0);
+    tb_trace_i("free_count: %lu",           allocator->free_count);
+    tb_trace_i("malloc_count: %lu",         allocator->malloc_count);
+    tb_trace_i("ralloc_count: %lu",         allocator->ralloc_count);
+}
+static tb_bool_t tb_span_large_allocator_have(tb_allocator_ref_t self, tb_cpointer_t data)
+{
+    // check
+    tb_span_large_allocator_ref_t allocator = (tb_span_large_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator, tb_false);
+
+    // belong to the arenas?
+    tb_for_all_if (tb_span_large_arena_t*, arena, tb_list_entry_itor(&allocator->arenas), arena)
+    {
+        if ((tb_byte_t const*)data >= arena->data && (tb_byte_t const*)data < arena->data + arena->used) 
+            return tb_true;
+    }
+
+    // belong to the direct spans?
+    tb_for_all_if (tb_span_large_data_head_t*, data_head, tb_list_entry_itor(&allocator->direct_list), data_head)
+    {
+        if ((tb_byte_t const*)data >= (tb_byte_t const*)data_head && (tb_byte_t const*)data < (tb_byte_t const*)data_head + data_head->pages * allocator->page_size) 
+            return tb_true;
+    }
+    return tb_false;
+}
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_allocator_ref_t tb_span_large_allocator_init(tb_size_t flags, tb_long_t decay)
+{
+    // done
+    tb_bool_t                       ok = tb_false;
+    tb_span_large_allocator_ref_t   allocator = tb_null;
+    do
+    {
+        // check
+        tb_assert_static(!(sizeof(tb_span_large_data_head_t) & (TB_POOL_DATA_ALIGN - 1)));
+
+        // init page, it may be called before tb_init()
+        if (!tb_page_init()) break;
+
+        // check the page size
+        tb_size_t page_size = tb_page_size();
+        tb_assert_and_check_break(page_size && tb_ispow2(page_size) && page_size > sizeof(tb_span_large_data_head_t));
+
+        // make allocator
+        allocator = (tb_span_large_allocator_ref_t)tb_native_memory_malloc0(sizeof(tb_span_large_allocator_t));
+        tb_assert_and_check_break(allocator);
+
+        // init base
+        allocator->base.type             = TB_ALLOCATOR_LARGE;
+        allocator->base.large_malloc     = tb_span_large_allocator_malloc;
+        allocator->base.large_ralloc     = tb_span_large_allocator_ralloc;
+        allocator->base.large_free       = tb_span_large_allocator_free;
+        allocator->base.clear            = tb_span_large_allocator_clear;
+        allocator->base.exit             = tb_span_large_allocator_exit;
+#ifdef __tb_debug__
+        allocator->base.dump             = tb_span_large_allocator_dump;
+        allocator->base.have             = tb_span_large_allocator_have;
+#endif
+
+        // init lock
+        if (!tb_spinlock_init(&allocator->base.lock)) break;
+
+        // init info
+        allocator->flags        = flags;
+        allocator->decay        = decay? decay : TB_SPAN_LARGE_ALLOCATOR_DECAY;
+        allocator->page_size    = page_size;
+        allocator->arena_size   = tb_max(TB_SPAN_LARGE_ALLOCATOR_ARENA_SIZE, page_size * TB_SPAN_LARGE_ALLOCATOR_CLASS_PAGES_MAXN * 4);
+
+        // init lists
+        tb_list_entry_init(&allocator->arenas, tb_span_large_arena_t, entry, tb_null);
+        tb_list_entry_init(&allocator->used_list, tb_span_large_data_head_t, entry, tb_null);
+        tb_list_entry_init(&allocator->direct_list, tb_span_large_data_head_t, entry, tb_null);
+
+        // init classes: 1, 2, .., 8 pages, and then there are four classes for each power of two
+        tb_size_t pages = 1;
+        while (pages <= TB_SPAN_LARGE_ALLOCATOR_CLASS_PAGES_MAXN && allocator->class_count < TB_SPAN_LARGE_ALLOCATOR_CLASS_MAXN)
+        {
+            // init class
+            tb_span_large_class_t* cls = &allocator->classes[allocator->class_count++];
+            tb_list_entry_init(&cls->free_list, tb_span_large_data_head_t, entry, tb_null);
+            cls->pages = pages;
+
+            // the next pages
+            if (pages < 8) pages++;
+            else
+            {
+                tb_size_t step = 2;
+                while ((step << 3) <= pages) step <<= 1;
+                pages += step;
+            }
+        }
+        tb_assert_and_check_break(allocator->classes[allocator->class_count - 1].pages == TB_SPAN_LARGE_ALLOCATOR_CLASS_PAGES_MAXN);
+
+        // map the first arena, the pages may be not supported on this platform
+        tb_span_large_data_head_t* data_head = tb_span_large_allocator_carve(allocator, 0);
+        tb_check_break(data_head);
+        tb_span_large_allocator_free_span(allocator, data_head, 0, tb_true);
+
+        // register lock profiler
+#ifdef TB_LOCK_PROFILER_ENABLE
+        tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&allocator->base.lock, TB_TRACE_MODULE_NAME);
+#endif
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (allocator) tb_span_large_allocator_exit((tb_allocator_ref_t)allocator);
+        allocator = tb_null;
+    }
+
+    // ok?
+    return (tb_allocator_ref_t)allocator;
+}
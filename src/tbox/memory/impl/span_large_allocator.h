@@ -0,0 +1,56 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        span_large_allocator.h
+ *
+ */
+#ifndef TB_MEMORY_IMPL_SPAN_LARGE_ALLOCATOR_H
+#define TB_MEMORY_IMPL_SPAN_LARGE_ALLOCATOR_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* init the span large allocator, the spans are carved from the mapped arenas by the page size classes
+ *
+ * @param flags         the flags, e.g. TB_LARGE_ALLOCATOR_FLAG_HUGE_PAGE
+ * @param decay         the decay time (ms) of the idle spans, use the default decay time if be zero, never purge them if be -1
+ * 
+ * @return              the allocator, return tb_null if the pages cannot be mapped on this platform
+ */
+tb_allocator_ref_t      tb_span_large_allocator_init(tb_size_t flags, tb_long_t decay);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
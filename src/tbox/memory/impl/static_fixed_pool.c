@@ -52,6 +52,12 @@
 // find the first free index
 #   define tb_static_fixed_pool_find_free(v)                tb_bits_fb0_be(v)
 
+// find the first used index
+#   define tb_static_fixed_pool_find_used(v)                tb_bits_fb1_be(v)
+
+// clear the used index of the used info word
+#   define tb_static_fixed_pool_word_set0(v, i)             do {(v) &= ~((tb_size_t)1 << (TB_CPU_BITSIZE - 1 - (i)));} while (0)
+
 #else
 
 // allocate the index 
@@ -66,6 +72,12 @@
 // find the first free index
 #   define tb_static_fixed_pool_find_free(v)                tb_bits_fb0_le(v)
 
+// find the first used index
+#   define tb_static_fixed_pool_find_used(v)                tb_bits_fb1_le(v)
+
+// clear the used index of the used info word
+#   define tb_static_fixed_pool_word_set0(v, i)             do {(v) &= ~((tb_size_t)1 << (i));} while (0)
+
 #endif
 
 // cache the predicted index
@@ -681,50 +693,32 @@ tb_void_t tb_static_fixed_pool_walk(tb_static_fixed_pool_ref_t self, tb_fixed_po
     tb_static_fixed_pool_t* pool = (tb_static_fixed_pool_t*)self;
     tb_assert_and_check_return(pool && pool->item_maxn && pool->item_space && func);
 
-    // walk
-    tb_size_t   i = 0;
-    tb_size_t   m = pool->item_maxn;
-    tb_byte_t*  p = pool->used_info;
-    tb_byte_t*  d = pool->data + pool->data_head_size;
-    tb_byte_t   u = *p;
-    tb_byte_t   b = 0;
-    for (i = 0; i < m; ++i)
+    /* walk the used info words and skip the free words quickly
+     *
+     * @note the bits after item_maxn are always zero
+     */
+    tb_size_t           i = 0;
+    tb_size_t           n = pool->info_size / TB_CPU_BITBYTE;
+    tb_size_t const*    p = (tb_size_t const*)pool->used_info;
+    tb_byte_t*          d = pool->data + pool->data_head_size;
+    for (i = 0; i < n; i++)
     {
-        // bit
-        b = i & 0x07;
+        // this word is all free?
+        tb_size_t u = p[i];
+        tb_check_continue(u);
 
-        // u++
-        if (!b) 
+        // walk all used items of this word
+        tb_byte_t* w = d + (i << TB_CPU_SHIFT) * pool->item_space;
+        do
         {
-            u = *p++;
-                
-            // this byte is all occupied?
-            //if (u == 0xff)
-            if (!(u + 1))
-            {
-                // done func
-                func(d + (i + 0) * pool->item_space, priv);
-                func(d + (i + 1) * pool->item_space, priv);
-                func(d + (i + 2) * pool->item_space, priv);
-                func(d + (i + 3) * pool->item_space, priv);
-                func(d + (i + 4) * pool->item_space, priv);
-                func(d + (i + 5) * pool->item_space, priv);
-                func(d + (i + 6) * pool->item_space, priv);
-                func(d + (i + 7) * pool->item_space, priv);
-
-                // skip this byte and continue it
-                i += 7;
-                continue ;
-            }
-        }
+            // the used index
+            tb_size_t b = tb_static_fixed_pool_find_used(u);
+            tb_static_fixed_pool_word_set0(u, b);
 
-        // is occupied?
-        // if (tb_static_fixed_pool_used_bset(pool->used_info, i))
-        if ((u & (0x01 << b)))
-        {
             // done func
-            func(d + i * pool->item_space, priv);
-        }
+            func(w + b * pool->item_space, priv);
+
+        } while (u);
     }
 }
 #ifdef __tb_debug__
@@ -734,13 +728,25 @@ tb_void_t tb_static_fixed_pool_dump(tb_static_fixed_pool_ref_t self)
     tb_static_fixed_pool_t* pool = (tb_static_fixed_pool_t*)self;
     tb_assert_and_check_return(pool && pool->used_info);
 
-    // dump 
-    tb_size_t index = 0;
-    for (index = 0; index < pool->item_maxn; ++index)
+    // dump the used items, skip the free words quickly
+    tb_size_t           i = 0;
+    tb_size_t           n = pool->info_size / TB_CPU_BITBYTE;
+    tb_size_t const*    p = (tb_size_t const*)pool->used_info;
+    for (i = 0; i < n; i++)
     {
-        // leak?
-        if (tb_static_fixed_pool_used_bset(pool->used_info, index)) 
+        // this word is all free?
+        tb_size_t u = p[i];
+        tb_check_continue(u);
+
+        // dump all used items of this word
+        do
         {
+            // the leak index
+            tb_size_t b = tb_static_fixed_pool_find_used(u);
+            tb_size_t index = (i << TB_CPU_SHIFT) + b;
+            tb_static_fixed_pool_word_set0(u, b);
+            tb_assert(tb_static_fixed_pool_used_bset(pool->used_info, index));
+
             // the data head
             tb_pool_data_empty_head_t* data_head = (tb_pool_data_empty_head_t*)(pool->data + index * pool->item_space);
 
@@ -755,7 +761,8 @@ tb_void_t tb_static_fixed_pool_dump(tb_static_fixed_pool_ref_t self)
 
             // dump data
             tb_pool_data_dump(data, tb_false, "[static_fixed_pool]: [error]: ");
-        }
+
+        } while (u);
     }
 
     // trace debug info
@@ -0,0 +1,663 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        iobuf.c
+ * @ingroup     memory
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "iobuf"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "iobuf.h"
+#include "allocator.h"
+#include "../libc/libc.h"
+#include "../container/container.h"
+#include "../platform/platform.h"
+#include "../algorithm/algorithm.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the block data
+#define tb_iobuf_block_data(block)          ((tb_byte_t*)(block) + tb_align8(sizeof(tb_iobuf_block_t)))
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the iobuf block type
+typedef struct __tb_iobuf_block_t
+{
+    // the reference count
+    tb_atomic_t                 refn;
+
+    // the block size
+    tb_size_t                   size;
+
+    // the used size
+    tb_size_t                   used;
+
+}tb_iobuf_block_t;
+
+// the iobuf slice type
+typedef struct __tb_iobuf_slice_t
+{
+    // the list entry
+    tb_list_entry_t             entry;
+
+    // the block
+    tb_iobuf_block_t*           block;
+
+    // the data offset of the block
+    tb_size_t                   offset;
+
+    // the data size
+    tb_size_t                   size;
+
+}tb_iobuf_slice_t;
+
+// the iobuf type
+typedef struct __tb_iobuf_t
+{
+    // the slices
+    tb_list_entry_head_t        slices;
+
+    // the spare slices with the empty blocks for reserving
+    tb_list_entry_head_t        spares;
+
+    // the data size
+    tb_size_t                   size;
+
+    // the block size
+    tb_size_t                   block_size;
+
+}tb_iobuf_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_iobuf_block_t* tb_iobuf_block_init(tb_size_t size)
+{
+    // make block
+    tb_iobuf_block_t* block = (tb_iobuf_block_t*)tb_malloc_bytes(tb_align8(sizeof(tb_iobuf_block_t)) + size);
+    tb_assert_and_check_return_val(block, tb_null);
+
+    // init block
+    block->refn = 1;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+static __tb_inline__ tb_void_t tb_iobuf_block_retain(tb_iobuf_block_t* block)
+{
+    tb_atomic_fetch_and_inc(&block->refn);
+}
+static __tb_inline__ tb_void_t tb_iobuf_block_release(tb_iobuf_block_t* block)
+{
+    // free it if the last slice is released
+    if (tb_atomic_fetch_and_dec(&block->refn) == 1) tb_free(block);
+}
+static tb_iobuf_slice_t* tb_iobuf_slice_init(tb_iobuf_block_t* block, tb_size_t offset, tb_size_t size)
+{
+    // make slice
+    tb_iobuf_slice_t* slice = tb_malloc0_type(tb_iobuf_slice_t);
+    tb_assert_and_check_return_val(slice, tb_null);
+
+    // init slice
+    slice->block  = block;
+    slice->offset = offset;
+    slice->size   = size;
+    return slice;
+}
+static tb_void_t tb_iobuf_slice_exit(tb_iobuf_slice_t* slice)
+{
+    // release block
+    if (slice->block) tb_iobuf_block_release(slice->block);
+    slice->block = tb_null;
+
+    // free slice
+    tb_free(slice);
+}
+static __tb_inline__ tb_byte_t* tb_iobuf_slice_data(tb_iobuf_slice_t* slice)
+{
+    return tb_iobuf_block_data(slice->block) + slice->offset;
+}
+static __tb_inline__ tb_size_t tb_iobuf_slice_left(tb_iobuf_slice_t* slice)
+{
+    /* we can only write data to the free space of the block if it is owned by this slice only
+     * and this slice is at the end of the used data
+     */
+    tb_iobuf_block_t* block = slice->block;
+    return (tb_atomic_get(&block->refn) == 1 && slice->offset + slice->size == block->used)? block->size - block->used : 0;
+}
+static __tb_inline__ tb_iobuf_slice_t* tb_iobuf_slice_head(tb_iobuf_t* iobuf)
+{
+    return tb_list_entry_is_null(&iobuf->slices)? tb_null : (tb_iobuf_slice_t*)tb_list_entry(&iobuf->slices, tb_list_entry_head(&iobuf->slices));
+}
+static __tb_inline__ tb_iobuf_slice_t* tb_iobuf_slice_last(tb_iobuf_t* iobuf)
+{
+    return tb_list_entry_is_null(&iobuf->slices)? tb_null : (tb_iobuf_slice_t*)tb_list_entry(&iobuf->slices, tb_list_entry_last(&iobuf->slices));
+}
+static tb_void_t tb_iobuf_slices_exit(tb_list_entry_head_ref_t slices)
+{
+    while (!tb_list_entry_is_null(slices))
+    {
+        tb_list_entry_ref_t entry = tb_list_entry_head(slices);
+        tb_list_entry_remove_head(slices);
+        tb_iobuf_slice_exit((tb_iobuf_slice_t*)tb_list_entry(slices, entry));
+    }
+}
+static tb_iobuf_slice_t* tb_iobuf_spare_get(tb_iobuf_t* iobuf, tb_size_t size)
+{
+    // get a spare slice first if it is large enough
+    if (!tb_list_entry_is_null(&iobuf->spares))
+    {
+        tb_list_entry_ref_t entry = tb_list_entry_head(&iobuf->spares);
+        tb_iobuf_slice_t*   slice = (tb_iobuf_slice_t*)tb_list_entry(&iobuf->spares, entry);
+        if (slice->block->size >= size)
+        {
+            tb_list_entry_remove_head(&iobuf->spares);
+            return slice;
+        }
+    }
+
+    // make a new empty block
+    tb_iobuf_block_t* block = tb_iobuf_block_init(tb_max(size, iobuf->block_size));
+    tb_assert_and_check_return_val(block, tb_null);
+
+    // make a new slice
+    tb_iobuf_slice_t* slice = tb_iobuf_slice_init(block, 0, 0);
+    if (!slice) tb_iobuf_block_release(block);
+    return slice;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_iobuf_ref_t tb_iobuf_init(tb_size_t block_size)
+{
+    // make iobuf
+    tb_iobuf_t* iobuf = tb_malloc0_type(tb_iobuf_t);
+    tb_assert_and_check_return_val(iobuf, tb_null);
+
+    // init iobuf
+    iobuf->block_size = block_size? block_size : TB_IOBUF_BLOCK_SIZE;
+    tb_list_entry_init(&iobuf->slices, tb_iobuf_slice_t, entry, tb_null);
+    tb_list_entry_init(&iobuf->spares, tb_iobuf_slice_t, entry, tb_null);
+    return (tb_iobuf_ref_t)iobuf;
+}
+tb_void_t tb_iobuf_exit(tb_iobuf_ref_t self)
+{
+    // check
+    tb_iobuf_t* iobuf = (tb_iobuf_t*)self;
+    tb_assert_and_check_return(iobuf);
+
+    // exit all slices
+    tb_iobuf_slices_exit(&iobuf->slices);
+    tb_iobuf_slices_exit(&iobuf->spares);
+    tb_list_entry_exit(&iobuf->slices);
+    tb_list_entry_exit(&iobuf->spares);
+
+    // free it
+    tb_free(iobuf);
+}
+tb_void_t tb_iobuf_clear(tb_iobuf_ref_t self)
+{
+    // check
+    tb_iobuf_t* iobuf = (tb_iobuf_t*)self;
+    tb_assert_and_check_return(iobuf);
+
+    // exit the data slices and keep the spare blocks for reusing
+    tb_iobuf_slices_exit(&iobuf->slices);
+    iobuf->size = 0;
+}
+tb_size_t tb_iobuf_size(tb_iobuf_ref_t self)
+{
+    // check
+    tb_iobuf_t* iobuf = (tb_iobuf_t*)self;
+    tb_assert_and_check_return_val(iobuf, 0);
+
+    return iobuf->size;
+}
+tb_size_t tb_iobuf_slices(tb_iobuf_ref_t self)
+{
+    // check
+    tb_iobuf_t* iobuf = (tb_iobuf_t*)self;
+    tb_assert_and_check_return_val(iobuf, 0);
+
+    return tb_list_entry_size(&iobuf->slices);
+}
+tb_bool_t tb_iobuf_append(tb_iobuf_ref_t self, tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_iobuf_t* iobuf = (tb_iobuf_t*)self;
+    tb_assert_and_check_return_val(iobuf && (data || !size), tb_false);
+
+    // copy data to the free space of the tail block first
+    tb_iobuf_slice_t* last = tb_iobuf_slice_last(iobuf);
+    if (last && size)
+    {
+        tb_size_t left = tb_min(tb_iobuf_slice_left(last), size);
+        if (left)
+        {
+            tb_memcpy(tb_iobuf_slice_data(last) + last->size, data, left);
+            last->block->used += left;
+            last->size += left;
+            iobuf->size += left;
+            data += left;
+            size -= left;
+        }
+    }
+
+    // copy the left data to a new block
+    if (size)
+    {
+        tb_iobuf_slice_t* slice = tb_iobuf_spare_get(iobuf, size);
+        tb_assert_and_check_return_val(slice, tb_false);
+
+        tb_memcpy(tb_iobuf_slice_data(slice), data, size);
+        slice->block->used = size;
+        slice->size = size;
+        tb_list_entry_insert_tail(&iobuf->slices, &slice->entry);
+        iobuf->size += size;
+    }
+
+    // ok
+    return tb_true;
+}
+tb_bool_t tb_iobuf_prepend(tb_iobuf_ref_t self, tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_iobuf_t* iobuf = (tb_iobuf_t*)self;
+    tb_assert_and_check_return_val(iobuf && (data || !size), tb_false);
+
+    // no data?
+    tb_check_return_val(size, tb_true);
+
+    // make a block with the exact size, the prepended data is usually a small protocol header
+    tb_iobuf_block_t* block = tb_iobuf_block_init(size);
+    tb_assert_and_check_return_val(block, tb_false);
+
+    // make slice
+    tb_iobuf_slice_t* slice = tb_iobuf_slice_init(block, 0, size);
+    if (!slice)
+    {
+        tb_iobuf_block_release(block);
+        return tb_false;
+    }
+
+    // insert it to the head
+    tb_memcpy(tb_iobuf_block_data(block), data, size);
+    block->used = size;
+    tb_list_entry_insert_head(&iobuf->slices, &slice->entry);
+    iobuf->size += size;
+    return tb_true;
+}
+tb_bool_t tb_iobuf_append_iobuf(tb_iobuf_ref_t self, tb_iobuf_ref_t other)
+{
+    // check
+    tb_iobuf_t* iobuf = (tb_iobuf_t*)self;
+    tb_iobuf_t* source = (tb_iobuf_t*)other;
+    tb_assert_and_check_return_val(iobuf && source && iobuf != source, tb_false);
+
+    // share all blocks of the other iobuf
+    tb_for_all_if (tb_iobuf_slice_t*, item, tb_list_entry_itor(&source->slices), item)
+    {
+        // make a new slice
+        tb_iobuf_slice_t* slice = tb_iobuf_slice_init(item->block, item->offset, item->size);
+        tb_assert_and_check_return_val(slice, tb_false);
+
+        // retain the shared block and append it
+        tb_iobuf_block_retain(item->block);
+        tb_list_entry_insert_tail(&iobuf->slices, &slice->entry);
+        iobuf->size += item->size;
+    }
+
+    // ok
+    return tb_true;
+}
+tb_size_t tb_iobuf_split(tb_iobuf_ref_t self, tb_iobuf_ref_t head, tb_size_t size)
+{
+    // check
+    tb_iobuf_t* iobuf = (tb_iobuf_t*)self;
+    tb_iobuf_t* target = (tb_iobuf_t*)head;
+    tb_assert_and_check_return_val(iobuf && target && iobuf != target, 0);
+
+    // move the head slices to the target iobuf
+    tb_size_t split = 0;
+    tb_iobuf_slice_t* slice = tb_null;
+    while (split < size && (slice = tb_iobuf_slice_head(iobuf)))
+    {
+        tb_size_t need = size - split;
+        if (slice->size <= need)
+        {
+            // move the whole slice
+            tb_list_entry_remove_head(&iobuf->slices);
+            tb_list_entry_insert_tail(&target->slices, &slice->entry);
+            split += slice->size;
+        }
+        else
+        {
+            // share the block of the partial slice
+            tb_iobuf_slice_t* part = tb_iobuf_slice_init(slice->block, slice->offset, need);
+            tb_assert_and_check_break(part);
+            tb_iobuf_block_retain(slice->block);
+            tb_list_entry_insert_tail(&target->slices, &part->entry);
+
+            // update the remaining slice
+            slice->offset += need;
+            slice->size -= need;
+            split += need;
+        }
+    }
+
+    // update size
+    iobuf->size -= split;
+    target->size += split;
+    return split;
+}
+tb_size_t tb_iobuf_trim_head(tb_iobuf_ref_t self, tb_size_t size)
+{
+    // check
+    tb_iobuf_t* iobuf = (tb_iobuf_t*)self;
+    tb_assert_and_check_return_val(iobuf, 0);
+
+    // trim the head slices
+    tb_size_t trim = 0;
+    tb_iobuf_slice_t* slice = tb_null;
+    while (trim < size && (slice = tb_iobuf_slice_head(iobuf)))
+    {
+        tb_size_t need = size - trim;
+        if (slice->size <= need)
+        {
+            tb_list_entry_remove_head(&iobuf->slices);
+            trim += slice->size;
+            tb_iobuf_slice_exit(slice);
+        }
+        else
+        {
+            slice->offset += need;
+            slice->size -= need;
+            trim += need;
+        }
+    }
+
+    // update size
+    iobuf->size -= trim;
+    return trim;
+}
+tb_size_t tb_iobuf_trim_tail(tb_iobuf_ref_t self, tb_size_t size)
+{
+    // check
+    tb_iobuf_t* iobuf = (tb_iobuf_t*)self;
+    tb_assert_and_check_return_val(iobuf, 0);
+
+    // trim the tail slices
+    tb_size_t trim = 0;
+    tb_iobuf_slice_t* slice = tb_null;
+    while (trim < size && (slice = tb_iobuf_slice_last(iobuf)))
+    {
+        // give back the trimmed space of the block if we own the tail of it
+        tb_size_t         need = tb_min(size - trim, slice->size);
+        tb_iobuf_block_t* block = slice->block;
+        if (tb_atomic_get(&block->refn) == 1 && slice->offset + slice->size == block->used)
+            block->used -= need;
+
+        // trim it
+        slice->size -= need;
+        trim += need;
+        if (!slice->size)
+        {
+            tb_list_entry_remove_last(&iobuf->slices);
+            tb_iobuf_slice_exit(slice);
+        }
+    }
+
+    // update size
+    iobuf->size -= trim;
+    return trim;
+}
+tb_size_t tb_iobuf_peek(tb_iobuf_ref_t self, tb_byte_t* data, tb_size_t size)
+{
+    // check
+    tb_iobuf_t* iobuf = (tb_iobuf_t*)self;
+    tb_assert_and_check_return_val(iobuf && (data || !size), 0);
+
+    // copy the head data
+    tb_size_t read = 0;
+    tb_for_all_if (tb_iobuf_slice_t*, slice, tb_list_entry_itor(&iobuf->slices), slice && read < size)
+    {
+        tb_size_t need = tb_min(size - read, slice->size);
+        tb_memcpy(data + read, tb_iobuf_slice_data(slice), need);
+        read += need;
+    }
+    return read;
+}
+tb_size_t tb_iobuf_pull(tb_iobuf_ref_t self, tb_byte_t* data, tb_size_t size)
+{
+    // copy and trim the head data
+    tb_size_t read = tb_iobuf_peek(self, data, size);
+    if (read) tb_iobuf_trim_head(self, read);
+    return read;
+}
+tb_byte_t const* tb_iobuf_contiguous(tb_iobuf_ref_t self, tb_size_t size)
+{
+    // check
+    tb_iobuf_t* iobuf = (tb_iobuf_t*)self;
+    tb_assert_and_check_return_val(iobuf && size && size <= iobuf->size, tb_null);
+
+    // the head slice is large enough? return it directly
+    tb_iobuf_slice_t* head = tb_iobuf_slice_head(iobuf);
+    tb_assert_and_check_return_val(head, tb_null);
+    if (head->size >= size) return tb_iobuf_slice_data(head);
+
+    // coalesce the head data into a new block
+    tb_iobuf_block_t* block = tb_iobuf_block_init(tb_max(size, iobuf->block_size));
+    tb_assert_and_check_return_val(block, tb_null);
+    tb_iobuf_slice_t* slice = tb_iobuf_slice_init(block, 0, size);
+    if (!slice)
+    {
+        tb_iobuf_block_release(block);
+        return tb_null;
+    }
+    block->used = tb_iobuf_pull(self, tb_iobuf_block_data(block), size);
+    tb_assert(block->used == size);
+
+    // insert it to the head
+    tb_list_entry_insert_head(&iobuf->slices, &slice->entry);
+    iobuf->size += size;
+    return tb_iobuf_block_data(block);
+}
+tb_size_t tb_iobuf_iovec(tb_iobuf_ref_t self, tb_iovec_t* list, tb_size_t maxn)
+{
+    // check
+    tb_iobuf_t* iobuf = (tb_iobuf_t*)self;
+    tb_assert_and_check_return_val(iobuf && list && maxn, 0);
+
+    // fill the iovec list
+    tb_size_t count = 0;
+    tb_for_all_if (tb_iobuf_slice_t*, slice, tb_list_entry_itor(&iobuf->slices), slice && count < maxn)
+    {
+        list[count].data = tb_iobuf_slice_data(slice);
+        list[count].size = (tb_iovec_size_t)slice->size;
+        count++;
+    }
+    return count;
+}
+tb_size_t tb_iobuf_reserve(tb_iobuf_ref_t self, tb_size_t size, tb_iovec_t* list, tb_size_t maxn)
+{
+    // check
+    tb_iobuf_t* iobuf = (tb_iobuf_t*)self;
+    tb_assert_and_check_return_val(iobuf && size && list && maxn, 0);
+
+    // reserve the free space of the tail block first
+    tb_size_t count = 0;
+    tb_size_t reserved = 0;
+    tb_iobuf_slice_t* last = tb_iobuf_slice_last(iobuf);
+    if (last)
+    {
+        tb_size_t left = tb_iobuf_slice_left(last);
+        if (left)
+        {
+            list[count].data = tb_iobuf_slice_data(last) + last->size;
+            list[count].size = (tb_iovec_size_t)tb_min(left, size);
+            reserved += list[count].size;
+            count++;
+        }
+    }
+
+    // reserve the spare blocks
+    tb_for_all_if (tb_iobuf_slice_t*, spare, tb_list_entry_itor(&iobuf->spares), spare && reserved < size && count < maxn)
+    {
+        list[count].data = tb_iobuf_block_data(spare->block);
+        list[count].size = (tb_iovec_size_t)tb_min(spare->block->size, size - reserved);
+        reserved += list[count].size;
+        count++;
+    }
+
+    // make more spare blocks
+    while (reserved < size && count < maxn)
+    {
+        // make a new empty block
+        tb_iobuf_block_t* block = tb_iobuf_block_init(iobuf->block_size);
+        tb_assert_and_check_break(block);
+
+        // make a spare slice
+        tb_iobuf_slice_t* spare = tb_iobuf_slice_init(block, 0, 0);
+        if (!spare)
+        {
+            tb_iobuf_block_release(block);
+            break;
+        }
+        tb_list_entry_insert_tail(&iobuf->spares, &spare->entry);
+
+        list[count].data = tb_iobuf_block_data(block);
+        list[count].size = (tb_iovec_size_t)tb_min(block->size, size - reserved);
+        reserved += list[count].size;
+        count++;
+    }
+    return count;
+}
+tb_bool_t tb_iobuf_commit(tb_iobuf_ref_t self, tb_size_t size)
+{
+    // check
+    tb_iobuf_t* iobuf = (tb_iobuf_t*)self;
+    tb_assert_and_check_return_val(iobuf, tb_false);
+
+    // commit the free space of the tail block first, it is the same order as reserving
+    tb_iobuf_slice_t* last = tb_iobuf_slice_last(iobuf);
+    if (last && size)
+    {
+        tb_size_t left = tb_min(tb_iobuf_slice_left(last), size);
+        last->block->used += left;
+        last->size += left;
+        iobuf->size += left;
+        size -= left;
+    }
+
+    // commit the spare blocks
+    while (size && !tb_list_entry_is_null(&iobuf->spares))
+    {
+        tb_list_entry_ref_t entry = tb_list_entry_head(&iobuf->spares);
+        tb_iobuf_slice_t*   spare = (tb_iobuf_slice_t*)tb_list_entry(&iobuf->spares, entry);
+        tb_size_t           fill  = tb_min(spare->block->size, size);
+
+        // move it to the data slices
+        tb_list_entry_remove_head(&iobuf->spares);
+        spare->block->used = fill;
+        spare->size = fill;
+        tb_list_entry_insert_tail(&iobuf->slices, &spare->entry);
+        iobuf->size += fill;
+        size -= fill;
+    }
+
+    // the committed size must be not larger than the reserved size
+    tb_assert_and_check_return_val(!size, tb_false);
+    return tb_true;
+}
+tb_long_t tb_iobuf_sendv(tb_iobuf_ref_t self, tb_socket_ref_t sock)
+{
+    // check
+    tb_assert_and_check_return_val(self && sock, -1);
+
+    // no data?
+    tb_iovec_t list[TB_IOBUF_IOVEC_MAXN];
+    tb_size_t  count = tb_iobuf_iovec(self, list, tb_arrayn(list));
+    tb_check_return_val(count, 0);
+
+    // send data and remove the sent data
+    tb_long_t real = tb_socket_sendv(sock, list, count);
+    if (real > 0) tb_iobuf_trim_head(self, real);
+    return real;
+}
+tb_long_t tb_iobuf_recvv(tb_iobuf_ref_t self, tb_socket_ref_t sock, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(self && sock && size, -1);
+
+    // reserve space
+    tb_iovec_t list[TB_IOBUF_IOVEC_MAXN];
+    tb_size_t  count = tb_iobuf_reserve(self, size, list, tb_arrayn(list));
+    tb_assert_and_check_return_val(count, -1);
+
+    // recv data and commit it
+    tb_long_t real = tb_socket_recvv(sock, list, count);
+    if (real > 0) tb_iobuf_commit(self, real);
+    return real;
+}
+tb_long_t tb_iobuf_writv(tb_iobuf_ref_t self, tb_file_ref_t file)
+{
+    // check
+    tb_assert_and_check_return_val(self && file, -1);
+
+    // no data?
+    tb_iovec_t list[TB_IOBUF_IOVEC_MAXN];
+    tb_size_t  count = tb_iobuf_iovec(self, list, tb_arrayn(list));
+    tb_check_return_val(count, 0);
+
+    // write data and remove the written data
+    tb_long_t real = tb_file_writv(file, list, count);
+    if (real > 0) tb_iobuf_trim_head(self, real);
+    return real;
+}
+tb_long_t tb_iobuf_readv(tb_iobuf_ref_t self, tb_file_ref_t file, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(self && file && size, -1);
+
+    // reserve space
+    tb_iovec_t list[TB_IOBUF_IOVEC_MAXN];
+    tb_size_t  count = tb_iobuf_reserve(self, size, list, tb_arrayn(list));
+    tb_assert_and_check_return_val(count, -1);
+
+    // read data and commit it
+    tb_long_t real = tb_file_readv(file, list, count);
+    if (real > 0) tb_iobuf_commit(self, real);
+    return real;
+}
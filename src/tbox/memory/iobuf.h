@@ -0,0 +1,300 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        iobuf.h
+ * @ingroup     memory
+ *
+ */
+#ifndef TB_MEMORY_IOBUF_H
+#define TB_MEMORY_IOBUF_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../platform/prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/// the default iobuf block size
+#ifdef __tb_small__
+#   define TB_IOBUF_BLOCK_SIZE          (4096)
+#else
+#   define TB_IOBUF_BLOCK_SIZE          (8192)
+#endif
+
+/// the maximum iovec count for the vectored io of iobuf
+#define TB_IOBUF_IOVEC_MAXN             (16)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the iobuf ref type
+typedef __tb_typeref__(iobuf);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * description
+ */
+
+/*! the chained scatter-gather buffer
+ *
+ * <pre>
+ *
+ * iobuf: [slice] -> [slice] -> [slice] -> ...
+ *           |          |          |
+ *           |          `----------|--------> [block: refn = 2]
+ *           `-----------------------------> [block: refn = 1]
+ *                                 |
+ * other: [slice] -> ...           |
+ *           `---------------------'
+ *
+ * </pre>
+ *
+ * the data is stored in the refcounted blocks and the iobuf only holds a chain of the slices (block, offset, size),
+ * so split, append_iobuf, trim_head and trim_tail only update the slices and never copy the data.
+ *
+ * the block is shared between the slices of the different iobufs after splitting or appending iobuf,
+ * and it will be freed when the last slice is released.
+ *
+ * @note the iobuf is not thread-safe, but the shared blocks can be passed to other threads with the splitted iobuf.
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init iobuf
+ *
+ * @param block_size        the block size, using the default size if be zero
+ *
+ * @return                  the iobuf
+ */
+tb_iobuf_ref_t              tb_iobuf_init(tb_size_t block_size);
+
+/*! exit iobuf
+ *
+ * @param iobuf             the iobuf
+ */
+tb_void_t                   tb_iobuf_exit(tb_iobuf_ref_t iobuf);
+
+/*! clear iobuf
+ *
+ * @param iobuf             the iobuf
+ */
+tb_void_t                   tb_iobuf_clear(tb_iobuf_ref_t iobuf);
+
+/*! the iobuf data size
+ *
+ * @param iobuf             the iobuf
+ *
+ * @return                  the data size
+ */
+tb_size_t                   tb_iobuf_size(tb_iobuf_ref_t iobuf);
+
+/*! the slice count of iobuf
+ *
+ * @param iobuf             the iobuf
+ *
+ * @return                  the slice count
+ */
+tb_size_t                   tb_iobuf_slices(tb_iobuf_ref_t iobuf);
+
+/*! append data to the tail of iobuf
+ *
+ * the data will be copied into the free space of the tail block if it is not shared
+ *
+ * @param iobuf             the iobuf
+ * @param data              the data
+ * @param size              the size
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_iobuf_append(tb_iobuf_ref_t iobuf, tb_byte_t const* data, tb_size_t size);
+
+/*! prepend data to the head of iobuf, e.g. the protocol header
+ *
+ * @param iobuf             the iobuf
+ * @param data              the data
+ * @param size              the size
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_iobuf_prepend(tb_iobuf_ref_t iobuf, tb_byte_t const* data, tb_size_t size);
+
+/*! append all data of the other iobuf to the tail of iobuf without copying
+ *
+ * the blocks will be shared and the other iobuf is not changed
+ *
+ * @param iobuf             the iobuf
+ * @param other             the other iobuf
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_iobuf_append_iobuf(tb_iobuf_ref_t iobuf, tb_iobuf_ref_t other);
+
+/*! split the head data of iobuf and move it to the tail of the given head iobuf without copying
+ *
+ * @param iobuf             the iobuf
+ * @param head              the head iobuf
+ * @param size              the split size
+ *
+ * @return                  the real split size
+ */
+tb_size_t                   tb_iobuf_split(tb_iobuf_ref_t iobuf, tb_iobuf_ref_t head, tb_size_t size);
+
+/*! trim the head data of iobuf
+ *
+ * @param iobuf             the iobuf
+ * @param size              the trimmed size
+ *
+ * @return                  the real trimmed size
+ */
+tb_size_t                   tb_iobuf_trim_head(tb_iobuf_ref_t iobuf, tb_size_t size);
+
+/*! trim the tail data of iobuf
+ *
+ * @param iobuf             the iobuf
+ * @param size              the trimmed size
+ *
+ * @return                  the real trimmed size
+ */
+tb_size_t                   tb_iobuf_trim_tail(tb_iobuf_ref_t iobuf, tb_size_t size);
+
+/*! copy the head data of iobuf and keep it
+ *
+ * @param iobuf             the iobuf
+ * @param data              the data
+ * @param size              the size
+ *
+ * @return                  the real size
+ */
+tb_size_t                   tb_iobuf_peek(tb_iobuf_ref_t iobuf, tb_byte_t* data, tb_size_t size);
+
+/*! copy the head data of iobuf and remove it
+ *
+ * @param iobuf             the iobuf
+ * @param data              the data
+ * @param size              the size
+ *
+ * @return                  the real size
+ */
+tb_size_t                   tb_iobuf_pull(tb_iobuf_ref_t iobuf, tb_byte_t* data, tb_size_t size);
+
+/*! get the contiguous head data of iobuf, e.g. for parsing the protocol header
+ *
+ * it will only coalesce the head slices into a new block if the data spans multiple slices
+ *
+ * @param iobuf             the iobuf
+ * @param size              the size, it must be not larger than the iobuf size
+ *
+ * @return                  the contiguous data
+ */
+tb_byte_t const*            tb_iobuf_contiguous(tb_iobuf_ref_t iobuf, tb_size_t size);
+
+/*! get the iovec list of the iobuf data for sendv, writv and etc.
+ *
+ * @param iobuf             the iobuf
+ * @param list              the iovec list
+ * @param maxn              the iovec list maxn
+ *
+ * @return                  the iovec count
+ */
+tb_size_t                   tb_iobuf_iovec(tb_iobuf_ref_t iobuf, tb_iovec_t* list, tb_size_t maxn);
+
+/*! reserve the free space at the tail of iobuf for recvv, readv and etc.
+ *
+ * @code
+    tb_iovec_t list[TB_IOBUF_IOVEC_MAXN];
+    tb_size_t  count = tb_iobuf_reserve(iobuf, 65536, list, tb_arrayn(list));
+    tb_long_t  real = tb_socket_recvv(sock, list, count);
+    if (real > 0) tb_iobuf_commit(iobuf, real);
+ * @endcode
+ *
+ * @param iobuf             the iobuf
+ * @param size              the reserved size
+ * @param list              the iovec list
+ * @param maxn              the iovec list maxn
+ *
+ * @return                  the iovec count
+ */
+tb_size_t                   tb_iobuf_reserve(tb_iobuf_ref_t iobuf, tb_size_t size, tb_iovec_t* list, tb_size_t maxn);
+
+/*! commit the filled data of the reserved space
+ *
+ * @param iobuf             the iobuf
+ * @param size              the filled size, it must be not larger than the reserved size
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_iobuf_commit(tb_iobuf_ref_t iobuf, tb_size_t size);
+
+/*! send the iobuf data to the socket and remove the sent data
+ *
+ * @param iobuf             the iobuf
+ * @param sock              the socket
+ *
+ * @return                  the real size, no data: 0, failed: -1
+ */
+tb_long_t                   tb_iobuf_sendv(tb_iobuf_ref_t iobuf, tb_socket_ref_t sock);
+
+/*! recv the socket data to the tail of iobuf
+ *
+ * @param iobuf             the iobuf
+ * @param sock              the socket
+ * @param size              the maximum recv size
+ *
+ * @return                  the real size, no data: 0, failed: -1
+ */
+tb_long_t                   tb_iobuf_recvv(tb_iobuf_ref_t iobuf, tb_socket_ref_t sock, tb_size_t size);
+
+/*! write the iobuf data to the file and remove the written data
+ *
+ * @param iobuf             the iobuf
+ * @param file              the file
+ *
+ * @return                  the real size or -1
+ */
+tb_long_t                   tb_iobuf_writv(tb_iobuf_ref_t iobuf, tb_file_ref_t file);
+
+/*! read the file data to the tail of iobuf
+ *
+ * @param iobuf             the iobuf
+ * @param file              the file
+ * @param size              the maximum read size
+ *
+ * @return                  the real size or -1
+ */
+tb_long_t                   tb_iobuf_readv(tb_iobuf_ref_t iobuf, tb_file_ref_t file, tb_size_t size);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
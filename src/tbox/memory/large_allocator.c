@@ -38,7 +38,13 @@
 tb_allocator_ref_t tb_large_allocator_init(tb_byte_t* data, tb_size_t size)
 {
     // init pool
-    return (data && size)? tb_static_large_allocator_init(data, size, tb_page_size()) : tb_native_large_allocator_init();
+    return (data && size)? tb_static_large_allocator_init(data, size, tb_page_size()) : tb_large_allocator_init_with_flags(TB_LARGE_ALLOCATOR_FLAG_NONE, 0);
+}
+tb_allocator_ref_t tb_large_allocator_init_with_flags(tb_size_t flags, tb_long_t decay)
+{
+    // init the span large allocator from the mapped pages, fallback to the native memory if not supported
+    tb_allocator_ref_t allocator = tb_span_large_allocator_init(flags, decay);
+    return allocator? allocator : tb_native_large_allocator_init();
 }
 
 
@@ -36,6 +36,20 @@
  */
 __tb_extern_c_enter__
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the large allocator flag enum
+typedef enum __tb_large_allocator_flag_e
+{
+    TB_LARGE_ALLOCATOR_FLAG_NONE                = 0     //!< none
+,   TB_LARGE_ALLOCATOR_FLAG_HUGE_PAGE           = 1     //!< back the arenas with the transparent huge pages if be supported
+,   TB_LARGE_ALLOCATOR_FLAG_HUGE_PAGE_EXPLICIT  = 2     //!< map the arenas with the explicit huge pages first, e.g. hugetlbfs, fallback to the normal pages
+,   TB_LARGE_ALLOCATOR_FLAG_LAZY_PURGE          = 4     //!< purge the idle spans lazily by MADV_FREE instead of MADV_DONTNEED
+
+}tb_large_allocator_flag_e;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -44,27 +58,54 @@ __tb_extern_c_enter__
  *
  * <pre>
  *
- *  -------------------------      ------------------------
- * |       native memory     |    |         data           |
- *  -------------------------      ------------------------ 
- *              |                             |
- *  -------------------------      ------------------------
- * |  native large allocator |    | static large allocator |
- *  -------------------------      ------------------------
- *              |                             |
- *  ------------------------------------------------------
- * |                     large allocator                  |
- *  ------------------------------------------------------ 
+ *  -------------------------      -------------------------      ------------------------
+ * |       mapped pages      |    |       native memory     |    |         data           |
+ *  -------------------------      -------------------------      ------------------------ 
+ *              |                              |                             |
+ *  -------------------------      -------------------------      ------------------------
+ * |   span large allocator  | or | native large allocator  |    | static large allocator |
+ *  -------------------------      -------------------------      ------------------------
+ *              |                              |                             |
+ *  -------------------------------------------------------------------------------------
+ * |                                   large allocator                                   |
+ *  ------------------------------------------------------------------------------------- 
  *
  * </pre>
  * 
- * @param data          the data, uses the native memory if be null
+ * @param data          the data, uses the mapped pages or the native memory if be null
  * @param size          the size
  *
  * @return              the allocator 
  */
 tb_allocator_ref_t      tb_large_allocator_init(tb_byte_t* data, tb_size_t size);
 
+/*! init the large allocator from the mapped pages
+ *
+ * the spans are carved from the mapped arenas by the page size classes,
+ * and the idle spans will be purged after the decay time for returning the physical memory to the system.
+ *
+ * it will fallback to the native large allocator if the pages cannot be mapped on this platform.
+ *
+ * @code
+ *
+    // init the large allocator with the transparent huge pages and purge the idle spans after 5s
+    tb_allocator_ref_t large_allocator = tb_large_allocator_init_with_flags(TB_LARGE_ALLOCATOR_FLAG_HUGE_PAGE, 5000);
+    if (large_allocator)
+    {
+        // init the default allocator
+        tb_allocator_ref_t allocator = tb_default_allocator_init(large_allocator);
+
+        // ...
+    }
+ * @endcode
+ *
+ * @param flags         the flags, e.g. TB_LARGE_ALLOCATOR_FLAG_HUGE_PAGE | TB_LARGE_ALLOCATOR_FLAG_LAZY_PURGE
+ * @param decay         the decay time (ms) of the idle spans, use the default decay time if be zero, never purge them if be -1
+ *
+ * @return              the allocator 
+ */
+tb_allocator_ref_t      tb_large_allocator_init_with_flags(tb_size_t flags, tb_long_t decay);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -30,12 +30,14 @@
  * includes
  */
 #include "prefix.h"
+#include "iobuf.h"
 #include "buffer.h"
 #include "allocator.h"
 #include "fixed_pool.h"
 #include "string_pool.h"
 #include "queue_buffer.h"
 #include "static_buffer.h"
+#include "arena_allocator.h"
 #include "large_allocator.h"
 #include "small_allocator.h"
 #include "native_allocator.h"
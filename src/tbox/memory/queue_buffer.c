@@ -144,8 +144,8 @@ tb_byte_t* tb_queue_buffer_resize(tb_queue_buffer_ref_t buffer, tb_size_t maxn)
             buffer->head = buffer->data;
         }
 
-        // realloc
-        if (maxn > buffer->maxn)
+        // realloc, the memory will be also released if it is shrunk
+        if (maxn != buffer->maxn)
         {
             // init head
             buffer->head = tb_null;
@@ -149,7 +149,7 @@ tb_void_t           tb_queue_buffer_clear(tb_queue_buffer_ref_t buffer);
 /*! resize buffer size
  *
  * @param buffer    the buffer
- * @param maxn      the buffer maxn
+ * @param maxn      the buffer maxn, it cannot be less than the data size
  *
  * @return          the buffer data
  */
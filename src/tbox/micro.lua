@@ -95,6 +95,8 @@ target("tbox")
         add_files("libm/isinff.c") 
         add_files("libm/isnan.c") 
         add_files("libm/isnanf.c") 
+        add_files("libc/stdio/impl/dtoa.c") 
+        add_files("libc/stdlib/impl/s10tod.c") 
     end
 
     -- add the source for the windows 
@@ -48,10 +48,51 @@
 #include "../algorithm/algorithm.h"
 #include "../container/container.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the maximum size of the response head
+#ifdef __tb_small__
+#   define TB_HTTP_RESPONSE_HEAD_MAXN           (16384)
+#else
+#   define TB_HTTP_RESPONSE_HEAD_MAXN           (65536)
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
 
+// the known response header type enum
+typedef enum __tb_http_response_header_type_e
+{
+    TB_HTTP_RESPONSE_HEADER_TYPE_NONE                   = 0
+,   TB_HTTP_RESPONSE_HEADER_TYPE_CONTENT_LENGTH         = 1
+,   TB_HTTP_RESPONSE_HEADER_TYPE_CONTENT_RANGE          = 2
+,   TB_HTTP_RESPONSE_HEADER_TYPE_CONTENT_TYPE           = 3
+,   TB_HTTP_RESPONSE_HEADER_TYPE_CONTENT_ENCODING       = 4
+,   TB_HTTP_RESPONSE_HEADER_TYPE_ACCEPT_RANGES          = 5
+,   TB_HTTP_RESPONSE_HEADER_TYPE_TRANSFER_ENCODING      = 6
+,   TB_HTTP_RESPONSE_HEADER_TYPE_LOCATION               = 7
+,   TB_HTTP_RESPONSE_HEADER_TYPE_CONNECTION             = 8
+,   TB_HTTP_RESPONSE_HEADER_TYPE_SET_COOKIE             = 9
+
+}tb_http_response_header_type_e;
+
+// the response header type, the offsets are relative to the response head data
+typedef struct __tb_http_response_header_t
+{
+    // the name offset
+    tb_uint32_t         name;
+
+    // the name size
+    tb_uint32_t         name_size;
+
+    // the value offset
+    tb_uint32_t         value;
+
+}tb_http_response_header_t;
+
 // the http type
 typedef struct __tb_http_t
 {
@@ -85,11 +126,108 @@ typedef struct __tb_http_t
     // the cookies
     tb_string_t         cookies;
 
+    // the response head data
+    tb_buffer_t         rhead;
+
+    // the response header count
+    tb_size_t           rheaders_count;
+
+    // the response headers, tb_http_response_header_t[]
+    tb_buffer_t         rheaders;
+
+    // the data stream for the cached response
+    tb_stream_ref_t     dstream;
+
+    // the cached entry of the current request
+    tb_http_cache_entry_t const* centry;
+
+    // the response data to be cached
+    tb_buffer_t         cdata;
+
+    // the expired time of the response to be cached
+    tb_time_t           cexpires;
+
+    // is caching the response data?
+    tb_bool_t           bcaching;
+
 }tb_http_t;
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the content encodings which can be unzipped, sorted by the preference
+#ifdef TB_CONFIG_MODULE_HAVE_ZIP
+static struct
+{
+    // the encoding name
+    tb_char_t const*    name;
+
+    // the zip algorithm
+    tb_size_t           algo;
+
+} g_http_encodings[] =
+{
+    {"zstd",    TB_ZIP_ALGO_ZSTD    }
+,   {"br",      TB_ZIP_ALGO_BROTLI  }
+,   {"gzip",    TB_ZIP_ALGO_GZIP    }
+,   {"deflate", TB_ZIP_ALGO_ZLIBRAW }
+};
+#endif
+
+// the known response header names, indexed by the header type
+static tb_char_t const* g_http_response_headers[] = 
+{
+    tb_null
+,   "Content-Length"
+,   "Content-Range"
+,   "Content-Type"
+,   "Content-Encoding"
+,   "Accept-Ranges"
+,   "Transfer-Encoding"
+,   "Location"
+,   "Connection"
+,   "Set-Cookie"
+};
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
+#ifdef TB_CONFIG_MODULE_HAVE_ZIP
+static tb_size_t tb_http_zip_algo(tb_http_t* http)
+{
+    // check
+    tb_assert(http);
+
+    // the zip algorithm of the content encoding
+    if (http->status.bgzip) return TB_ZIP_ALGO_GZIP;
+    else if (http->status.bdeflate) return TB_ZIP_ALGO_ZLIBRAW;
+    else if (http->status.bbrotli) return TB_ZIP_ALGO_BROTLI;
+    else if (http->status.bzstd) return TB_ZIP_ALGO_ZSTD;
+    return TB_ZIP_ALGO_NONE;
+}
+static tb_char_t const* tb_http_accept_encoding(tb_static_string_ref_t value)
+{
+    // check
+    tb_assert(value);
+
+    // make the supported encodings, .e.g "zstd, br, gzip, deflate"
+    tb_static_string_clear(value);
+    tb_size_t i = 0;
+    for (i = 0; i < tb_arrayn(g_http_encodings); i++)
+    {
+        // supported?
+        if (tb_zip_algo_supported(g_http_encodings[i].algo))
+        {
+            if (tb_static_string_size(value)) tb_static_string_cstrcat(value, ", ");
+            tb_static_string_cstrcat(value, g_http_encodings[i].name);
+        }
+    }
+
+    // ok?
+    return tb_static_string_size(value)? tb_static_string_cstr(value) : tb_null;
+}
+#endif
 static tb_bool_t tb_http_connect(tb_http_t* http)
 {
     // check
@@ -214,6 +352,13 @@ static tb_bool_t tb_http_request(tb_http_t* http)
         // no cookie? remove it
         if (!cookie) tb_hash_map_remove(http->head, "Cookie");
 
+        // revalidate the cached response with the validators
+        tb_http_cache_entry_t const* centry = http->centry;
+        if (centry && centry->etag) tb_hash_map_insert(http->head, "If-None-Match", centry->etag);
+        else tb_hash_map_remove(http->head, "If-None-Match");
+        if (centry && centry->last_modified) tb_hash_map_insert(http->head, "If-Modified-Since", centry->last_modified);
+        else tb_hash_map_remove(http->head, "If-Modified-Since");
+
         // init range
         if (http->option.range.bof && http->option.range.eof >= http->option.range.bof)
             tb_static_string_cstrfcpy(&value, "bytes=%llu-%llu", http->option.range.bof, http->option.range.eof);
@@ -273,6 +418,14 @@ static tb_bool_t tb_http_request(tb_http_t* http)
         // remove post
         else tb_hash_map_remove(http->head, "Content-Length");
 
+        // init accept-encoding if auto unzip
+        tb_char_t const* accept_encoding = tb_null;
+#ifdef TB_CONFIG_MODULE_HAVE_ZIP
+        if (http->option.bunzip) accept_encoding = tb_http_accept_encoding(&value);
+#endif
+        if (accept_encoding) tb_hash_map_insert(http->head, "Accept-Encoding", accept_encoding);
+        else tb_hash_map_remove(http->head, "Accept-Encoding");
+
         // replace the custom head 
         tb_char_t const* head_data = (tb_char_t const*)tb_buffer_data(&http->option.head_data);
         tb_char_t const* head_tail = head_data + tb_buffer_size(&http->option.head_data);
@@ -379,6 +532,77 @@ static tb_bool_t tb_http_request(tb_http_t* http)
     // ok?
     return ok;
 }
+static tb_size_t tb_http_response_header_type(tb_char_t const* name, tb_size_t size)
+{
+    // check
+    tb_check_return_val(size, TB_HTTP_RESPONSE_HEADER_TYPE_NONE);
+
+    /* get the known header type by the perfect hash of the name
+     *
+     * hash = (size * 4 + tolower(first) + tolower(last)) & 31
+     */
+    tb_size_t type = TB_HTTP_RESPONSE_HEADER_TYPE_NONE;
+    switch ((size * 4 + tb_tolower(name[0]) + tb_tolower(name[size - 1])) & 31)
+    {
+    case 0:     type = TB_HTTP_RESPONSE_HEADER_TYPE_SET_COOKIE;         break;
+    case 3:     type = TB_HTTP_RESPONSE_HEADER_TYPE_CONTENT_LENGTH;     break;
+    case 8:     type = TB_HTTP_RESPONSE_HEADER_TYPE_ACCEPT_RANGES;      break;
+    case 10:    type = TB_HTTP_RESPONSE_HEADER_TYPE_CONTENT_ENCODING;   break;
+    case 24:    type = TB_HTTP_RESPONSE_HEADER_TYPE_CONTENT_TYPE;       break;
+    case 25:    type = TB_HTTP_RESPONSE_HEADER_TYPE_CONNECTION;         break;
+    case 26:    type = TB_HTTP_RESPONSE_HEADER_TYPE_LOCATION;           break;
+    case 28:    type = TB_HTTP_RESPONSE_HEADER_TYPE_CONTENT_RANGE;      break;
+    case 31:    type = TB_HTTP_RESPONSE_HEADER_TYPE_TRANSFER_ENCODING;  break;
+    default:    return TB_HTTP_RESPONSE_HEADER_TYPE_NONE;
+    }
+
+    // confirm it
+    tb_char_t const* known = g_http_response_headers[type];
+    return (tb_strlen(known) == size && !tb_strnicmp(name, known, size))? type : TB_HTTP_RESPONSE_HEADER_TYPE_NONE;
+}
+static tb_byte_t const* tb_http_response_line_end(tb_byte_t const* p, tb_byte_t const* e)
+{
+    // find '\n' word by word, (v - 0x01..) & ~v & 0x80.. is non-zero if some bytes of v are zero
+    tb_uint64_t const lo = 0x0101010101010101ULL;
+    tb_uint64_t const hi = 0x8080808080808080ULL;
+    while (p + 8 <= e)
+    {
+        tb_uint64_t v = tb_bits_get_u64_le(p) ^ (lo * '\n');
+        tb_uint64_t m = (v - lo) & ~v & hi;
+        if (m)
+        {
+            // the first zero byte is the lowest marked byte
+            while (*p != '\n') p++;
+            return p;
+        }
+        p += 8;
+    }
+
+    // find the left bytes
+    while (p < e && *p != '\n') p++;
+    return p;
+}
+static tb_size_t tb_http_response_head_find(tb_byte_t const* data, tb_size_t size, tb_size_t* scan)
+{
+    // find the end of head: "\n\n" or "\n\r\n", only scan the new data from the last scanned position
+    tb_byte_t const* p = data + *scan;
+    tb_byte_t const* e = data + size;
+    while ((p = tb_http_response_line_end(p, e)) < e)
+    {
+        // save the scanned position of the last line end, we need rescan it if it is the last byte
+        *scan = p - data;
+
+        // the next line is empty?
+        if (p + 1 < e && p[1] == '\n') return p + 2 - data;
+        else if (p + 2 < e && p[1] == '\r' && p[2] == '\n') return p + 3 - data;
+        else if (p + 2 >= e) return 0;
+        p++;
+    }
+
+    // all data have been scanned
+    *scan = size;
+    return 0;
+}
 /*
  * HTTP/1.1 206 Partial Content
  * Date: Fri, 23 Apr 2010 05:25:45 GMT
@@ -391,7 +615,7 @@ static tb_bool_t tb_http_request(tb_http_t* http)
  * Connection: close
  * Content-Type: application/x-shockwave-flash
  */
-static tb_bool_t tb_http_response_done(tb_http_t* http, tb_char_t const* line, tb_size_t indx)
+static tb_bool_t tb_http_response_done(tb_http_t* http, tb_char_t* line, tb_size_t indx)
 {
     // check
     tb_assert_and_check_return_val(http && http->sstream && line, tb_false);
@@ -445,20 +669,45 @@ static tb_bool_t tb_http_response_done(tb_http_t* http, tb_char_t const* line, t
         // seek to value
         while (*p && *p != ':') p++;
         tb_assert_and_check_return_val(*p, tb_false);
+
+        // the name size
+        tb_char_t* name_end = (tb_char_t*)p;
+        while (name_end > line && tb_isspace(name_end[-1])) name_end--;
+        tb_size_t name_size = name_end - line;
+        tb_assert_and_check_return_val(name_size, tb_false);
+        *name_end = '\0';
+
+        // skip spaces
         p++; while (*p && tb_isspace(*p)) p++;
 
+        // index it as the slice of the response head, the value is terminated by the line end
+        tb_char_t const* head = (tb_char_t const*)tb_buffer_data(&http->rhead);
+        if (head)
+        {
+            tb_http_response_header_t header;
+            header.name         = (tb_uint32_t)(line - head);
+            header.name_size    = (tb_uint32_t)name_size;
+            header.value        = (tb_uint32_t)(p - head);
+            if (tb_buffer_memncpyp(&http->rheaders, http->rheaders_count * sizeof(header), (tb_byte_t const*)&header, sizeof(header)))
+                http->rheaders_count++;
+        }
+
         // no value
         tb_check_return_val(*p, tb_true);
 
+        // parse the known headers
+        switch (tb_http_response_header_type(line, name_size))
+        {
         // parse content size
-        if (!tb_strnicmp(line, "Content-Length", 14))
+        case TB_HTTP_RESPONSE_HEADER_TYPE_CONTENT_LENGTH:
         {
             http->status.content_size = tb_stou64(p);
             if (http->status.document_size < 0) 
                 http->status.document_size = http->status.content_size;
         }
+        break;
         // parse content range: "bytes $from-$to/$document_size"
-        else if (!tb_strnicmp(line, "Content-Range", 13))
+        case TB_HTTP_RESPONSE_HEADER_TYPE_CONTENT_RANGE:
         {
             tb_hize_t from = 0;
             tb_hize_t to = 0;
@@ -483,31 +732,38 @@ static tb_bool_t tb_http_response_done(tb_http_t* http, tb_char_t const* line, t
                 else http->status.content_size = document_size;
             }
         }
+        break;
         // parse accept-ranges: "bytes "
-        else if (!tb_strnicmp(line, "Accept-Ranges", 13))
+        case TB_HTTP_RESPONSE_HEADER_TYPE_ACCEPT_RANGES:
         {
             // no stream, be able to seek
             http->status.bseeked = 1;
         }
+        break;
         // parse content type
-        else if (!tb_strnicmp(line, "Content-Type", 12)) 
+        case TB_HTTP_RESPONSE_HEADER_TYPE_CONTENT_TYPE:
         {
             tb_string_cstrcpy(&http->status.content_type, p);
             tb_assert_and_check_return_val(tb_string_size(&http->status.content_type), tb_false);
         }
+        break;
         // parse transfer encoding
-        else if (!tb_strnicmp(line, "Transfer-Encoding", 17))
+        case TB_HTTP_RESPONSE_HEADER_TYPE_TRANSFER_ENCODING:
         {
             if (!tb_stricmp(p, "chunked")) http->status.bchunked = 1;
         }
+        break;
         // parse content encoding
-        else if (!tb_strnicmp(line, "Content-Encoding", 16))
+        case TB_HTTP_RESPONSE_HEADER_TYPE_CONTENT_ENCODING:
         {
             if (!tb_stricmp(p, "gzip")) http->status.bgzip = 1;
             else if (!tb_stricmp(p, "deflate")) http->status.bdeflate = 1;
+            else if (!tb_stricmp(p, "br")) http->status.bbrotli = 1;
+            else if (!tb_stricmp(p, "zstd")) http->status.bzstd = 1;
         }
+        break;
         // parse location
-        else if (!tb_strnicmp(line, "Location", 8)) 
+        case TB_HTTP_RESPONSE_HEADER_TYPE_LOCATION:
         {
             // redirect? check code: 301 - 307
             tb_assert_and_check_return_val(http->status.code > 300 && http->status.code < 308, tb_false);
@@ -515,8 +771,9 @@ static tb_bool_t tb_http_response_done(tb_http_t* http, tb_char_t const* line, t
             // save location
             tb_string_cstrcpy(&http->status.location, p);
         }
+        break;
         // parse connection
-        else if (!tb_strnicmp(line, "Connection", 10))
+        case TB_HTTP_RESPONSE_HEADER_TYPE_CONNECTION:
         {
             // keep alive?
             http->status.balived = !tb_stricmp(p, "close")? 0 : 1;
@@ -524,9 +781,13 @@ static tb_bool_t tb_http_response_done(tb_http_t* http, tb_char_t const* line, t
             // ctrl stream for sock
             if (!tb_stream_ctrl(http->sstream, TB_STREAM_CTRL_SOCK_KEEP_ALIVE, http->status.balived? tb_true : tb_false)) return tb_false;
         }
+        break;
         // parse cookies
-        else if (http->option.cookies && !tb_strnicmp(line, "Set-Cookie", 10))
+        case TB_HTTP_RESPONSE_HEADER_TYPE_SET_COOKIE:
         {
+            // no cookies?
+            tb_check_break(http->option.cookies);
+
             // the host
             tb_char_t const* host = tb_null;
             tb_http_ctrl((tb_http_ref_t)http, TB_HTTP_OPTION_GET_HOST, &host);
@@ -542,6 +803,10 @@ static tb_bool_t tb_http_response_done(tb_http_t* http, tb_char_t const* line, t
             // set cookies
             tb_cookies_set(http->option.cookies, host, path, bssl, p);
         }
+        break;
+        default:
+            break;
+        }
     }
 
     // ok
@@ -556,12 +821,44 @@ static tb_bool_t tb_http_response(tb_http_t* http)
     tb_bool_t ok = tb_false;
     do
     {
-        // read line
-        tb_char_t line[8192];
-        tb_long_t real = 0;
-        tb_size_t indx = 0;
-        while ((real = tb_stream_bread_line(http->stream, line, sizeof(line) - 1)) >= 0)
+        // clear the response headers
+        http->rheaders_count = 0;
+        tb_buffer_clear(&http->rhead);
+
+        /* peek the response head from the stream cache and find the end of it,
+         * the scanned data need not be rescanned after more data are peeked
+         */
+        tb_byte_t*  data = tb_null;
+        tb_long_t   size = 0;
+        tb_size_t   scan = 0;
+        tb_size_t   head_size = 0;
+        while (!head_size && size < TB_HTTP_RESPONSE_HEAD_MAXN && (size = tb_stream_peek(http->stream, &data, size)) > 0)
+            head_size = tb_http_response_head_find(data, size, &scan);
+        if (!head_size)
+        {
+            // trace
+            tb_trace_e("response: invalid head or too large, size: %ld", size);
+            break;
+        }
+
+        // read the whole head into the head data at once
+        tb_char_t* head = (tb_char_t*)tb_buffer_resize(&http->rhead, head_size + 1);
+        tb_assert_and_check_break(head);
+        if (!tb_stream_bread(http->stream, (tb_byte_t*)head, head_size)) break;
+        head[head_size] = '\0';
+
+        // parse the head lines in place
+        tb_char_t*          line = head;
+        tb_char_t*          line_end = tb_null;
+        tb_char_t const*    head_end = head + head_size;
+        tb_size_t           indx = 0;
+        for (; line < head_end; line = line_end + 1)
         {
+            // terminate this line, the line end always exists in the head
+            line_end = (tb_char_t*)tb_http_response_line_end((tb_byte_t const*)line, (tb_byte_t const*)head_end);
+            *line_end = '\0';
+            if (line_end > line && line_end[-1] == '\r') line_end[-1] = '\0';
+
             // trace
             tb_trace_d("response: %s", line);
  
@@ -569,8 +866,11 @@ static tb_bool_t tb_http_response(tb_http_t* http)
             if (http->option.head_func && !http->option.head_func(line, http->option.head_priv)) break;
             
             // end?
-            if (!real)
+            if (!*line)
             {
+                // check the status line
+                tb_check_break(indx);
+
                 // switch to cstream if chunked
                 if (http->status.bchunked)
                 {
@@ -592,16 +892,28 @@ static tb_bool_t tb_http_response(tb_http_t* http)
                     http->status.bseeked = 0;
                 }
 
-                // switch to zstream if gzip or deflate
-                if (http->option.bunzip && (http->status.bgzip || http->status.bdeflate))
+                // switch to zstream if gzip, deflate, br or zstd
+                if (http->option.bunzip && (http->status.bgzip || http->status.bdeflate || http->status.bbrotli || http->status.bzstd))
                 {
-#if defined(TB_CONFIG_PACKAGE_HAVE_ZLIB) && defined(TB_CONFIG_MODULE_HAVE_ZIP)
+#ifdef TB_CONFIG_MODULE_HAVE_ZIP
+                    // the zip algorithm
+                    tb_size_t algo = tb_http_zip_algo(http);
+                    if (!tb_zip_algo_supported(algo))
+                    {
+                        // trace
+                        tb_trace_w("%s is not supported now! please enable it from config if you need it.", tb_zip_algo_name(algo));
+
+                        // not supported
+                        http->status.state = TB_STATE_HTTP_GZIP_NOT_SUPPORTED;
+                        break;
+                    }
+
                     // init zstream
                     if (http->zstream)
                     {
                         if (!tb_stream_ctrl(http->zstream, TB_STREAM_CTRL_FLTR_SET_STREAM, http->stream)) break;
                     }
-                    else http->zstream = tb_stream_init_filter_from_zip(http->stream, http->status.bgzip? TB_ZIP_ALGO_GZIP : TB_ZIP_ALGO_ZLIB, TB_ZIP_ACTION_INFLATE);
+                    else http->zstream = tb_stream_init_filter_from_zip(http->stream, algo, TB_ZIP_ACTION_INFLATE);
                     tb_assert_and_check_break(http->zstream);
 
                     // the filter
@@ -610,7 +922,8 @@ static tb_bool_t tb_http_response(tb_http_t* http)
                     tb_assert_and_check_break(filter);
 
                     // ctrl filter
-                    if (!tb_filter_ctrl(filter, TB_FILTER_CTRL_ZIP_SET_ALGO, http->status.bgzip? TB_ZIP_ALGO_GZIP : TB_ZIP_ALGO_ZLIB, TB_ZIP_ACTION_INFLATE)) break;
+                    if (!tb_filter_ctrl(filter, TB_FILTER_CTRL_ZIP_SET_ALGO, algo)) break;
+                    if (!tb_filter_ctrl(filter, TB_FILTER_CTRL_ZIP_SET_ACTION, TB_ZIP_ACTION_INFLATE)) break;
 
                     // limit the filter input size
                     if (http->status.content_size > 0) tb_filter_limit(filter, http->status.content_size);
@@ -655,6 +968,99 @@ static tb_bool_t tb_http_response(tb_http_t* http)
     // ok?
     return ok;
 }
+static tb_bool_t tb_http_cache_enabled(tb_http_t* http)
+{
+    // only cache the whole response of GET
+    return http->option.cache && http->option.method == TB_HTTP_METHOD_GET && !http->option.range.bof && !http->option.range.eof;
+}
+static tb_void_t tb_http_cache_release(tb_http_t* http)
+{
+    // release the cached entry
+    if (http->centry) tb_http_cache_put(http->option.cache, http->centry);
+    http->centry = tb_null;
+
+    // stop caching the response data
+    http->bcaching = tb_false;
+    tb_buffer_clear(&http->cdata);
+}
+static tb_bool_t tb_http_cache_serve(tb_http_t* http)
+{
+    // check
+    tb_http_cache_entry_t const* centry = http->centry;
+    tb_assert_and_check_return_val(centry && centry->data && centry->size, tb_false);
+
+    // read the cached data from the data stream
+    if (http->dstream)
+    {
+        if (!tb_stream_ctrl(http->dstream, TB_STREAM_CTRL_DATA_SET_DATA, centry->data, centry->size)) return tb_false;
+    }
+    else http->dstream = tb_stream_init_from_data(centry->data, centry->size);
+    tb_assert_and_check_return_val(http->dstream, tb_false);
+    if (!tb_stream_open(http->dstream)) return tb_false;
+    http->stream = http->dstream;
+
+    // make status
+    tb_http_status_cler(&http->status, tb_false);
+    http->status.code           = 200;
+    http->status.content_size   = centry->size;
+    http->status.document_size  = centry->size;
+    http->status.bseeked        = 1;
+    if (centry->content_type) tb_string_cstrcpy(&http->status.content_type, centry->content_type);
+
+    // trace
+    tb_trace_d("cache: serve %s, size: %lu", centry->url, centry->size);
+    return tb_true;
+}
+static tb_void_t tb_http_cache_prepare(tb_http_t* http)
+{
+    // only cache the plain response data with the known size
+    tb_check_return(http->status.code == 200 && http->stream == http->sstream);
+    tb_check_return(http->status.content_size > 0 && http->status.content_size <= TB_HTTP_CACHE_ENTRY_MAXN);
+
+    // can be stored?
+    if (!tb_http_cache_expires(tb_http_response_header((tb_http_ref_t)http, "Cache-Control")
+        , tb_http_response_header((tb_http_ref_t)http, "Expires")
+        , tb_http_response_header((tb_http_ref_t)http, "Date"), &http->cexpires)) return ;
+
+    // it is useless if it is neither fresh nor able to be revalidated
+    tb_check_return(http->cexpires > tb_time() || tb_http_response_header((tb_http_ref_t)http, "ETag") || tb_http_response_header((tb_http_ref_t)http, "Last-Modified"));
+
+    /* reserve the whole response data and start to cache it, 
+     * because tb_buffer only grows by a fixed size and appending all read data will be quadratic
+     */
+    tb_check_return(tb_buffer_resize(&http->cdata, (tb_size_t)http->status.content_size));
+    tb_buffer_clear(&http->cdata);
+    http->bcaching = tb_true;
+}
+static tb_void_t tb_http_cache_append(tb_http_t* http, tb_byte_t const* data, tb_long_t real)
+{
+    // append data, stop it if it is end, failed or too large
+    tb_size_t size = tb_buffer_size(&http->cdata) + real;
+    if (real < 0 || size > (tb_size_t)http->status.content_size || (real && !tb_buffer_memncat(&http->cdata, data, real)))
+    {
+        http->bcaching = tb_false;
+        tb_buffer_clear(&http->cdata);
+        return ;
+    }
+
+    // finished? save it
+    if (size == (tb_size_t)http->status.content_size)
+    {
+        tb_http_cache_entry_t entry = {0};
+        entry.url           = tb_url_cstr(&http->option.url);
+        entry.etag          = tb_http_response_header((tb_http_ref_t)http, "ETag");
+        entry.last_modified = tb_http_response_header((tb_http_ref_t)http, "Last-Modified");
+        entry.content_type  = tb_string_size(&http->status.content_type)? tb_string_cstr(&http->status.content_type) : tb_null;
+        entry.expires       = http->cexpires;
+        entry.data          = tb_buffer_data(&http->cdata);
+        entry.size          = size;
+        tb_http_cache_save(http->option.cache, &entry);
+
+        // stop it
+        http->bcaching = tb_false;
+        tb_buffer_clear(&http->cdata);
+    }
+}
 static tb_bool_t tb_http_redirect(tb_http_t* http)
 {
     // check
@@ -757,6 +1163,15 @@ tb_http_ref_t tb_http_init()
         // init cookies data
         if (!tb_string_init(&http->cookies)) break;
 
+        // init response head data
+        if (!tb_buffer_init(&http->rhead)) break;
+
+        // init response headers
+        if (!tb_buffer_init(&http->rheaders)) break;
+
+        // init the response data to be cached
+        if (!tb_buffer_init(&http->cdata)) break;
+
         // init option
         if (!tb_http_option_init(&http->option)) break;
 
@@ -808,6 +1223,10 @@ tb_void_t tb_http_exit(tb_http_ref_t self)
     if (http->sstream) tb_stream_exit(http->sstream);
     http->sstream = tb_null;
 
+    // exit dstream
+    if (http->dstream) tb_stream_exit(http->dstream);
+    http->dstream = tb_null;
+
     // exit stream
     http->stream = tb_null;
     
@@ -817,6 +1236,15 @@ tb_void_t tb_http_exit(tb_http_ref_t self)
     // exit option
     tb_http_option_exit(&http->option);
 
+    // exit response head data
+    tb_buffer_exit(&http->rhead);
+
+    // exit response headers
+    tb_buffer_exit(&http->rheaders);
+
+    // exit the response data to be cached
+    tb_buffer_exit(&http->cdata);
+
     // exit cookies data
     tb_string_exit(&http->cookies);
 
@@ -861,18 +1289,50 @@ tb_bool_t tb_http_open(tb_http_ref_t self)
     tb_bool_t ok = tb_false;
     do
     {
+        // get the cached response and serve it directly if it is still fresh
+        tb_time_t cache_expires = 0;
+        tb_bool_t cache_enabled = tb_http_cache_enabled(http);
+        if (cache_enabled && (http->centry = tb_http_cache_get(http->option.cache, tb_url_cstr(&http->option.url), &cache_expires)) && tb_time() < cache_expires)
+        {
+            // no response head
+            http->rheaders_count = 0;
+            tb_buffer_clear(&http->rhead);
+            ok = tb_http_cache_serve(http);
+            break;
+        }
+
         // connect it
         if (!tb_http_connect(http)) break;
 
-        // request it
+        // request it, it will be conditional if the cached response exists
         if (!tb_http_request(http)) break;
 
         // response it
         if (!tb_http_response(http)) break;
 
+        // not modified? refresh and serve the cached response
+        if (http->centry && http->status.code == 304)
+        {
+            // refresh the expired time
+            tb_time_t expires = 0;
+            if (tb_http_cache_expires(tb_http_response_header(self, "Cache-Control"), tb_http_response_header(self, "Expires"), tb_http_response_header(self, "Date"), &expires))
+                tb_http_cache_refresh(http->option.cache, http->centry, expires);
+
+            // close the sock stream and serve it
+            if (!tb_stream_clos(http->stream)) break;
+            ok = tb_http_cache_serve(http);
+            break;
+        }
+
+        // release the cached entry if it is modified
+        tb_http_cache_release(http);
+
         // redirect it
         if (!tb_http_redirect(http)) break;
 
+        // cache the response data when reading it, the redirected response is not cached
+        if (cache_enabled && !tb_string_size(&http->status.location) && http->status.code == 200) tb_http_cache_prepare(http);
+
         // ok
         ok = tb_true;
 
@@ -886,6 +1346,9 @@ tb_bool_t tb_http_open(tb_http_ref_t self)
 
         // switch to sstream
         http->stream = http->sstream;
+
+        // release the cached entry
+        tb_http_cache_release(http);
     }
 
     // is opened?
@@ -909,6 +1372,9 @@ tb_bool_t tb_http_clos(tb_http_ref_t self)
     // switch to sstream
     http->stream = http->sstream;
 
+    // release the cached entry
+    tb_http_cache_release(http);
+
     // clear opened
     http->bopened = tb_false;
 
@@ -927,6 +1393,13 @@ tb_bool_t tb_http_seek(tb_http_ref_t self, tb_hize_t offset)
     // seeked?
     tb_check_return_val(http->status.bseeked, tb_false);
 
+    // seek the cached response directly
+    if (http->stream == http->dstream) return tb_stream_seek(http->dstream, offset);
+
+    // stop caching the response data
+    http->bcaching = tb_false;
+    tb_buffer_clear(&http->cdata);
+
     // done
     tb_bool_t ok = tb_false;
     do
@@ -971,7 +1444,11 @@ tb_long_t tb_http_read(tb_http_ref_t self, tb_byte_t* data, tb_size_t size)
     tb_assert_and_check_return_val(http->bopened, -1);
 
     // read
-    return tb_stream_read(http->stream, data, size);
+    tb_long_t real = tb_stream_read(http->stream, data, size);
+
+    // cache the response data
+    if (http->bcaching) tb_http_cache_append(http, data, real);
+    return real;
 }
 tb_bool_t tb_http_bread(tb_http_ref_t self, tb_byte_t* data, tb_size_t size)
 {   
@@ -987,7 +1464,7 @@ tb_bool_t tb_http_bread(tb_http_ref_t self, tb_byte_t* data, tb_size_t size)
     while (read < size)
     {
         // read data
-        tb_long_t real = tb_stream_read(http->stream, data + read, size - read);
+        tb_long_t real = tb_http_read(self, data + read, size - read);
 
         // update size
         if (real > 0) read += real;
@@ -1046,4 +1523,25 @@ tb_http_status_t const* tb_http_status(tb_http_ref_t self)
     // the status
     return &http->status;
 }
+tb_char_t const* tb_http_response_header(tb_http_ref_t self, tb_char_t const* name)
+{
+    // check
+    tb_http_t* http = (tb_http_t*)self;
+    tb_assert_and_check_return_val(http && name, tb_null);
+
+    // the response head data
+    tb_char_t const* head = (tb_char_t const*)tb_buffer_data(&http->rhead);
+    tb_check_return_val(head, tb_null);
 
+    // find it from the indexed headers, the value is only a slice of the response head data
+    tb_size_t i = 0;
+    tb_size_t n = tb_strlen(name);
+    tb_http_response_header_t const* headers = (tb_http_response_header_t const*)tb_buffer_data(&http->rheaders);
+    for (i = 0; i < http->rheaders_count; i++)
+    {
+        tb_http_response_header_t const* header = &headers[i];
+        if (header->name_size == n && !tb_strnicmp(head + header->name, name, n))
+            return head + header->value;
+    }
+    return tb_null;
+}
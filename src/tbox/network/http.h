@@ -30,6 +30,7 @@
  * includes
  */
 #include "cookies.h"
+#include "http_cache.h"
 #include "url.h"
 #include "../string/string.h"
 #include "../container/container.h"
@@ -154,6 +155,7 @@ typedef enum __tb_http_option_e
 ,   TB_HTTP_OPTION_GET_POST_FUNC        = TB_HTTP_OPTION_CODE_GET(18)
 ,   TB_HTTP_OPTION_GET_POST_PRIV        = TB_HTTP_OPTION_CODE_GET(19)
 ,   TB_HTTP_OPTION_GET_POST_LRATE       = TB_HTTP_OPTION_CODE_GET(20)
+,   TB_HTTP_OPTION_GET_CACHE            = TB_HTTP_OPTION_CODE_GET(21)
 
 ,   TB_HTTP_OPTION_SET_SSL              = TB_HTTP_OPTION_CODE_SET(1)
 ,   TB_HTTP_OPTION_SET_URL              = TB_HTTP_OPTION_CODE_SET(2)
@@ -175,6 +177,7 @@ typedef enum __tb_http_option_e
 ,   TB_HTTP_OPTION_SET_POST_FUNC        = TB_HTTP_OPTION_CODE_SET(18)
 ,   TB_HTTP_OPTION_SET_POST_PRIV        = TB_HTTP_OPTION_CODE_SET(19)
 ,   TB_HTTP_OPTION_SET_POST_LRATE       = TB_HTTP_OPTION_CODE_SET(20)
+,   TB_HTTP_OPTION_SET_CACHE            = TB_HTTP_OPTION_CODE_SET(21)
 
 }tb_http_option_e;
 
@@ -219,7 +222,7 @@ typedef struct __tb_http_option_t
     /// the method
     tb_uint16_t         method      : 4;
 
-    /// auto unzip for gzip encoding?
+    /// auto unzip for gzip, deflate, br and zstd encoding? it will also send the supported Accept-Encoding
     tb_uint16_t         bunzip      : 1;
 
     /// the http version, 0: HTTP/1.0, 1: HTTP/1.1
@@ -240,6 +243,9 @@ typedef struct __tb_http_option_t
     /// the cookies
     tb_cookies_ref_t    cookies;
 
+    /// the response cache, only for GET without range
+    tb_http_cache_ref_t cache;
+
     /// the priv data
     tb_pointer_t        head_priv;
 
@@ -293,6 +299,12 @@ typedef struct __tb_http_status_t
     /// is deflate?
     tb_uint16_t         bdeflate    : 1;
 
+    /// is brotli?
+    tb_uint16_t         bbrotli     : 1;
+
+    /// is zstd?
+    tb_uint16_t         bzstd       : 1;
+
     /// the state
     tb_size_t           state;
 
@@ -407,6 +419,18 @@ tb_bool_t               tb_http_ctrl(tb_http_ref_t http, tb_size_t option, ...);
  */
 tb_http_status_t const* tb_http_status(tb_http_ref_t http);
 
+/*! get the response header value
+ *
+ * the response head is read at once and all headers are only indexed as the slices of it,
+ * so the value will not be copied.
+ *
+ * @param http          the http 
+ * @param name          the header name, case-insensitive
+ *
+ * @return              the header value, it is valid until the http is opened again
+ */
+tb_char_t const*        tb_http_response_header(tb_http_ref_t http, tb_char_t const* name);
+
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
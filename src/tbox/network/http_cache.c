@@ -0,0 +1,588 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ *
+ * @author      ruki
+ * @file        http_cache.c
+ * @ingroup     network
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "http_cache"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "http_cache.h"
+#include "impl/http/date.h"
+#include "../libc/libc.h"
+#include "../hash/xxh3.h"
+#include "../utils/utils.h"
+#include "../platform/platform.h"
+#include "../container/container.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default maximum data size in the memory
+#ifdef __tb_small__
+#   define TB_HTTP_CACHE_MAXN               (4 << 20)
+#else
+#   define TB_HTTP_CACHE_MAXN               (16 << 20)
+#endif
+
+// the maximum size of the entry head in the disk store
+#define TB_HTTP_CACHE_HEAD_MAXN             (16384)
+
+// the magic of the entry file in the disk store
+#define TB_HTTP_CACHE_MAGIC                 "TBHC2"
+
+// the offset of the expired time in the entry file, it is written after the magic with the fixed width
+#define TB_HTTP_CACHE_EXPIRES_OFFSET        (sizeof(TB_HTTP_CACHE_MAGIC))
+
+// the fixed width of the expired time in the entry file
+#define TB_HTTP_CACHE_EXPIRES_SIZE          (20)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the http cache item type
+typedef struct __tb_http_cache_item_t
+{
+    // the entry, the data and strings are allocated after this item
+    tb_http_cache_entry_t   entry;
+
+    // the lru list entry
+    tb_list_entry_t         lru;
+
+    // the reference count
+    tb_size_t               refn;
+
+    // is it still in the memory cache?
+    tb_bool_t               cached;
+
+}tb_http_cache_item_t;
+
+// the http cache type
+typedef struct __tb_http_cache_t
+{
+    // the lock
+    tb_spinlock_t           lock;
+
+    // the items, url => item
+    tb_hash_map_ref_t       items;
+
+    // the lru list, the most recently used item is at the head
+    tb_list_entry_head_t    lru;
+
+    // the maximum data size in the memory
+    tb_size_t               maxn;
+
+    // the stats
+    tb_http_cache_stats_t   stats;
+
+    // the root directory of the disk store
+    tb_char_t               rootdir[TB_PATH_MAXN];
+
+}tb_http_cache_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_http_cache_item_t* tb_http_cache_item_init(tb_http_cache_entry_t const* entry)
+{
+    // check
+    tb_assert_and_check_return_val(entry && entry->url && entry->data && entry->size, tb_null);
+
+    // the string sizes
+    tb_size_t url_size              = tb_strlen(entry->url) + 1;
+    tb_size_t etag_size             = entry->etag? tb_strlen(entry->etag) + 1 : 0;
+    tb_size_t last_modified_size    = entry->last_modified? tb_strlen(entry->last_modified) + 1 : 0;
+    tb_size_t content_type_size     = entry->content_type? tb_strlen(entry->content_type) + 1 : 0;
+
+    // make item with the data and strings at once
+    tb_http_cache_item_t* item = (tb_http_cache_item_t*)tb_malloc0(sizeof(tb_http_cache_item_t) + entry->size + url_size + etag_size + last_modified_size + content_type_size);
+    tb_assert_and_check_return_val(item, tb_null);
+
+    // copy data
+    tb_byte_t* p = (tb_byte_t*)&item[1];
+    tb_memcpy(p, entry->data, entry->size);
+    item->entry.data = p;
+    item->entry.size = entry->size;
+    p += entry->size;
+
+    // copy strings
+    tb_memcpy(p, entry->url, url_size);
+    item->entry.url = (tb_char_t const*)p;
+    p += url_size;
+    if (etag_size)
+    {
+        tb_memcpy(p, entry->etag, etag_size);
+        item->entry.etag = (tb_char_t const*)p;
+        p += etag_size;
+    }
+    if (last_modified_size)
+    {
+        tb_memcpy(p, entry->last_modified, last_modified_size);
+        item->entry.last_modified = (tb_char_t const*)p;
+        p += last_modified_size;
+    }
+    if (content_type_size)
+    {
+        tb_memcpy(p, entry->content_type, content_type_size);
+        item->entry.content_type = (tb_char_t const*)p;
+    }
+    item->entry.expires = entry->expires;
+    return item;
+}
+static tb_void_t tb_http_cache_item_remove(tb_http_cache_t* cache, tb_http_cache_item_t* item)
+{
+    // remove it from the memory cache
+    tb_hash_map_remove(cache->items, item->entry.url);
+    tb_list_entry_remove(&cache->lru, &item->lru);
+    cache->stats.size -= item->entry.size;
+    item->cached = tb_false;
+
+    // exit it if no one is using it
+    if (!item->refn) tb_free(item);
+}
+static tb_void_t tb_http_cache_item_insert(tb_http_cache_t* cache, tb_http_cache_item_t* item)
+{
+    // remove the old item
+    tb_http_cache_item_t* prev = (tb_http_cache_item_t*)tb_hash_map_get(cache->items, item->entry.url);
+    if (prev) tb_http_cache_item_remove(cache, prev);
+
+    // insert it to the head
+    tb_hash_map_insert(cache->items, item->entry.url, item);
+    tb_list_entry_insert_head(&cache->lru, &item->lru);
+    cache->stats.size += item->entry.size;
+    item->cached = tb_true;
+
+    // evict the least recently used items if the memory is full
+    while (cache->stats.size > cache->maxn && tb_list_entry_size(&cache->lru) > 1)
+    {
+        // trace
+        tb_http_cache_item_t* last = (tb_http_cache_item_t*)tb_list_entry(&cache->lru, tb_list_entry_last(&cache->lru));
+        tb_trace_d("evict: %s, size: %lu", last->entry.url, last->entry.size);
+
+        // remove it, it is still in the disk store
+        tb_http_cache_item_remove(cache, last);
+        cache->stats.evictions++;
+    }
+}
+static tb_char_t const* tb_http_cache_path(tb_http_cache_t* cache, tb_char_t const* url, tb_char_t* path, tb_size_t maxn)
+{
+    // check
+    tb_check_return_val(cache->rootdir[0], tb_null);
+
+    // the entry file is named by the url hash, the url is also stored to check the conflict
+    return tb_snprintf(path, maxn, "%s/%016llx.cache", cache->rootdir, tb_xxh3_make_from_cstr(url, 0)) > 0? path : tb_null;
+}
+static tb_void_t tb_http_cache_store(tb_http_cache_t* cache, tb_http_cache_entry_t const* entry)
+{
+    // the entry path
+    tb_char_t path[TB_PATH_MAXN];
+    tb_check_return(tb_http_cache_path(cache, entry->url, path, sizeof(path)));
+
+    // make the entry head
+    tb_char_t head[TB_HTTP_CACHE_HEAD_MAXN];
+    tb_long_t head_size = tb_snprintf(head, sizeof(head), "%s\n%020lld\n%s\n%s\n%s\n%s\n%lu\n", TB_HTTP_CACHE_MAGIC, (tb_hong_t)entry->expires
+        , entry->url, entry->etag? entry->etag : "", entry->last_modified? entry->last_modified : "", entry->content_type? entry->content_type : ""
+        , entry->size);
+    tb_assert_and_check_return(head_size > 0 && head_size < (tb_long_t)sizeof(head) - 1);
+
+    // write it to the temporary file first, and rename it to avoid loading the incomplete entry
+    tb_char_t temp[TB_PATH_MAXN];
+    tb_snprintf(temp, sizeof(temp), "%s.%lx.tmp", path, (tb_size_t)tb_thread_self());
+    tb_file_ref_t file = tb_file_init(temp, TB_FILE_MODE_WO | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC);
+    tb_check_return(file);
+
+    // write head and data
+    tb_iovec_t list[2];
+    list[0].data = (tb_byte_t*)head;
+    list[0].size = head_size;
+    list[1].data = (tb_byte_t*)entry->data;
+    list[1].size = entry->size;
+    tb_bool_t ok = tb_file_writv(file, list, 2) == (tb_long_t)(head_size + entry->size);
+    tb_file_exit(file);
+
+    // rename it
+    if (!ok || !tb_file_rename(temp, path))
+    {
+        // trace
+        tb_trace_e("store %s failed!", path);
+        tb_file_remove(temp);
+    }
+}
+static tb_void_t tb_http_cache_store_expires(tb_http_cache_t* cache, tb_http_cache_entry_t const* entry, tb_time_t expires)
+{
+    // the entry path
+    tb_char_t path[TB_PATH_MAXN];
+    tb_check_return(tb_http_cache_path(cache, entry->url, path, sizeof(path)));
+
+    // open the entry file, store the whole entry if it has been removed
+    tb_file_ref_t file = tb_file_init(path, TB_FILE_MODE_RW);
+    if (!file)
+    {
+        tb_http_cache_store(cache, entry);
+        return ;
+    }
+
+    // make the head prefix: magic, expires and url
+    tb_char_t head[TB_HTTP_CACHE_HEAD_MAXN];
+    tb_long_t head_size = tb_snprintf(head, sizeof(head), "%s\n%020lld\n%s\n", TB_HTTP_CACHE_MAGIC, (tb_hong_t)expires, entry->url);
+
+    /* only update the expired time in the head, the different urls maybe have the same entry file
+     * so we need check the magic and url of the stored entry first
+     */
+    tb_bool_t   ok = tb_false;
+    tb_char_t*  prev = head_size > 0 && head_size < (tb_long_t)sizeof(head) - 1? (tb_char_t*)tb_malloc_bytes(head_size) : tb_null;
+    if (prev && tb_file_pread(file, (tb_byte_t*)prev, head_size, 0) == head_size)
+    {
+        ok = !tb_strncmp(prev, head, TB_HTTP_CACHE_EXPIRES_OFFSET)
+            && !tb_strncmp(prev + TB_HTTP_CACHE_EXPIRES_OFFSET + TB_HTTP_CACHE_EXPIRES_SIZE, head + TB_HTTP_CACHE_EXPIRES_OFFSET + TB_HTTP_CACHE_EXPIRES_SIZE, head_size - TB_HTTP_CACHE_EXPIRES_OFFSET - TB_HTTP_CACHE_EXPIRES_SIZE)
+            && tb_file_pwrit(file, (tb_byte_t const*)head + TB_HTTP_CACHE_EXPIRES_OFFSET, TB_HTTP_CACHE_EXPIRES_SIZE, TB_HTTP_CACHE_EXPIRES_OFFSET) == TB_HTTP_CACHE_EXPIRES_SIZE;
+    }
+    if (prev) tb_free(prev);
+    tb_file_exit(file);
+
+    // store the whole entry if it has been not stored
+    if (!ok) tb_http_cache_store(cache, entry);
+}
+static tb_http_cache_item_t* tb_http_cache_load(tb_http_cache_t* cache, tb_char_t const* url)
+{
+    // the entry path
+    tb_char_t path[TB_PATH_MAXN];
+    tb_check_return_val(tb_http_cache_path(cache, url, path, sizeof(path)), tb_null);
+
+    // done
+    tb_file_ref_t           file = tb_null;
+    tb_byte_t*              data = tb_null;
+    tb_http_cache_item_t*   item = tb_null;
+    do
+    {
+        // open file
+        file = tb_file_init(path, TB_FILE_MODE_RO);
+        tb_check_break(file);
+
+        // read the whole file
+        tb_size_t size = (tb_size_t)tb_file_size(file);
+        tb_check_break(size && size <= TB_HTTP_CACHE_ENTRY_MAXN + TB_HTTP_CACHE_HEAD_MAXN);
+        data = tb_malloc_bytes(size + 1);
+        tb_assert_and_check_break(data);
+        if (tb_file_pread(file, data, size, 0) != size) break;
+        data[size] = '\0';
+
+        // split the head lines: magic, expires, url, etag, last_modified, content_type, size
+        tb_size_t   i = 0;
+        tb_char_t*  lines[7];
+        tb_char_t*  p = (tb_char_t*)data;
+        tb_char_t*  e = (tb_char_t*)data + tb_min(size, TB_HTTP_CACHE_HEAD_MAXN);
+        for (i = 0; i < tb_arrayn(lines) && p < e; i++)
+        {
+            lines[i] = p;
+            while (p < e && *p != '\n') p++;
+            if (p < e) *p++ = '\0';
+        }
+        tb_check_break(i == tb_arrayn(lines) && p < e);
+
+        // check magic and url, the different urls maybe have the same hash
+        if (tb_strcmp(lines[0], TB_HTTP_CACHE_MAGIC) || tb_strcmp(lines[2], url)) break;
+
+        // check size
+        tb_http_cache_entry_t entry = {0};
+        entry.size = tb_stou32(lines[6]);
+        tb_check_break(entry.size && entry.size == size - ((tb_byte_t*)p - data));
+
+        // make item
+        entry.url           = lines[2];
+        entry.etag          = lines[3][0]? lines[3] : tb_null;
+        entry.last_modified = lines[4][0]? lines[4] : tb_null;
+        entry.content_type  = lines[5][0]? lines[5] : tb_null;
+        entry.expires       = (tb_time_t)tb_s10toi64(lines[1]);
+        entry.data          = (tb_byte_t const*)p;
+        item = tb_http_cache_item_init(&entry);
+
+        // trace
+        tb_trace_d("load: %s, size: %lu", url, entry.size);
+
+    } while (0);
+
+    // exit data
+    if (data) tb_free(data);
+
+    // exit file
+    if (file) tb_file_exit(file);
+
+    // ok?
+    return item;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_http_cache_ref_t tb_http_cache_init(tb_char_t const* rootdir, tb_size_t maxn)
+{
+    // done
+    tb_bool_t           ok = tb_false;
+    tb_http_cache_t*    cache = tb_null;
+    do
+    {
+        // make cache
+        cache = tb_malloc0_type(tb_http_cache_t);
+        tb_assert_and_check_break(cache);
+
+        // init lock
+        if (!tb_spinlock_init(&cache->lock)) break;
+
+        // init items
+        cache->items = tb_hash_map_init(TB_HASH_MAP_BUCKET_SIZE_MICRO, tb_element_str(tb_true), tb_element_ptr(tb_null, tb_null));
+        tb_assert_and_check_break(cache->items);
+
+        // init lru list
+        tb_list_entry_init(&cache->lru, tb_http_cache_item_t, lru, tb_null);
+
+        // init maxn
+        cache->maxn = maxn? maxn : TB_HTTP_CACHE_MAXN;
+
+        // init the disk store
+        if (rootdir)
+        {
+            if (!tb_path_absolute(rootdir, cache->rootdir, sizeof(cache->rootdir))) break;
+            if (!tb_file_info(cache->rootdir, tb_null) && !tb_directory_create(cache->rootdir)) break;
+        }
+
+        // register lock profiler
+#ifdef TB_LOCK_PROFILER_ENABLE
+        tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&cache->lock, TB_TRACE_MODULE_NAME);
+#endif
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit cache
+        if (cache) tb_http_cache_exit((tb_http_cache_ref_t)cache);
+        cache = tb_null;
+    }
+
+    // ok?
+    return (tb_http_cache_ref_t)cache;
+}
+tb_void_t tb_http_cache_exit(tb_http_cache_ref_t self)
+{
+    // check
+    tb_http_cache_t* cache = (tb_http_cache_t*)self;
+    tb_assert_and_check_return(cache);
+
+    // exit all items in the memory
+    tb_spinlock_enter(&cache->lock);
+    while (tb_list_entry_size(&cache->lru))
+        tb_http_cache_item_remove(cache, (tb_http_cache_item_t*)tb_list_entry(&cache->lru, tb_list_entry_head(&cache->lru)));
+    tb_spinlock_leave(&cache->lock);
+
+    // exit items
+    if (cache->items) tb_hash_map_exit(cache->items);
+    cache->items = tb_null;
+
+    // exit lock
+    tb_spinlock_exit(&cache->lock);
+
+    // exit it
+    tb_free(cache);
+}
+tb_void_t tb_http_cache_clear(tb_http_cache_ref_t self)
+{
+    // check
+    tb_http_cache_t* cache = (tb_http_cache_t*)self;
+    tb_assert_and_check_return(cache);
+
+    // clear all items in the memory
+    tb_spinlock_enter(&cache->lock);
+    while (tb_list_entry_size(&cache->lru))
+        tb_http_cache_item_remove(cache, (tb_http_cache_item_t*)tb_list_entry(&cache->lru, tb_list_entry_head(&cache->lru)));
+    tb_spinlock_leave(&cache->lock);
+
+    // clear the disk store
+    if (cache->rootdir[0])
+    {
+        tb_directory_remove(cache->rootdir);
+        tb_directory_create(cache->rootdir);
+    }
+}
+tb_void_t tb_http_cache_stats(tb_http_cache_ref_t self, tb_http_cache_stats_t* stats)
+{
+    // check
+    tb_http_cache_t* cache = (tb_http_cache_t*)self;
+    tb_assert_and_check_return(cache && stats);
+
+    // get stats
+    tb_spinlock_enter(&cache->lock);
+    *stats = cache->stats;
+    stats->count = tb_list_entry_size(&cache->lru);
+    tb_spinlock_leave(&cache->lock);
+}
+tb_http_cache_entry_t const* tb_http_cache_get(tb_http_cache_ref_t self, tb_char_t const* url, tb_time_t* pexpires)
+{
+    // check
+    tb_http_cache_t* cache = (tb_http_cache_t*)self;
+    tb_assert_and_check_return_val(cache && url && pexpires, tb_null);
+
+    // get it from the memory and move it to the head
+    tb_spinlock_enter(&cache->lock);
+    tb_http_cache_item_t* item = (tb_http_cache_item_t*)tb_hash_map_get(cache->items, url);
+    if (item)
+    {
+        tb_list_entry_moveto_head(&cache->lru, &item->lru);
+        item->refn++;
+    }
+    tb_spinlock_leave(&cache->lock);
+
+    // load it from the disk store
+    tb_http_cache_item_t* load = item? tb_null : tb_http_cache_load(cache, url);
+
+    // update stats
+    tb_time_t now = tb_time();
+    tb_spinlock_enter(&cache->lock);
+    if (load)
+    {
+        // it may have been loaded by other threads
+        item = (tb_http_cache_item_t*)tb_hash_map_get(cache->items, url);
+        if (item) tb_list_entry_moveto_head(&cache->lru, &item->lru);
+        else tb_http_cache_item_insert(cache, item = load);
+        item->refn++;
+    }
+    if (item && now < item->entry.expires) cache->stats.hits++;
+    else cache->stats.misses++;
+    *pexpires = item? item->entry.expires : 0;
+    tb_spinlock_leave(&cache->lock);
+
+    // exit the loaded item if it is not used
+    if (load && load != item) tb_free(load);
+
+    // ok?
+    return item? &item->entry : tb_null;
+}
+tb_void_t tb_http_cache_put(tb_http_cache_ref_t self, tb_http_cache_entry_t const* entry)
+{
+    // check
+    tb_http_cache_t*        cache = (tb_http_cache_t*)self;
+    tb_http_cache_item_t*   item = (tb_http_cache_item_t*)entry;
+    tb_assert_and_check_return(cache && item);
+
+    // release it
+    tb_spinlock_enter(&cache->lock);
+    tb_assert(item->refn);
+    tb_bool_t removed = !--item->refn && !item->cached;
+    tb_spinlock_leave(&cache->lock);
+
+    // exit it if it has been removed from the memory cache
+    if (removed) tb_free(item);
+}
+tb_bool_t tb_http_cache_save(tb_http_cache_ref_t self, tb_http_cache_entry_t const* entry)
+{
+    // check
+    tb_http_cache_t* cache = (tb_http_cache_t*)self;
+    tb_assert_and_check_return_val(cache && entry && entry->url, tb_false);
+
+    // too large?
+    tb_check_return_val(entry->size && entry->size <= TB_HTTP_CACHE_ENTRY_MAXN && entry->size <= cache->maxn, tb_false);
+
+    // make item
+    tb_http_cache_item_t* item = tb_http_cache_item_init(entry);
+    tb_assert_and_check_return_val(item, tb_false);
+
+    // store it to the disk
+    tb_http_cache_store(cache, &item->entry);
+
+    // trace
+    tb_trace_d("save: %s, size: %lu, expires: %lld", entry->url, entry->size, (tb_hong_t)entry->expires);
+
+    // insert it to the memory
+    tb_spinlock_enter(&cache->lock);
+    tb_http_cache_item_insert(cache, item);
+    cache->stats.stores++;
+    tb_spinlock_leave(&cache->lock);
+    return tb_true;
+}
+tb_void_t tb_http_cache_refresh(tb_http_cache_ref_t self, tb_http_cache_entry_t const* entry, tb_time_t expires)
+{
+    // check
+    tb_http_cache_t*        cache = (tb_http_cache_t*)self;
+    tb_http_cache_item_t*   item = (tb_http_cache_item_t*)entry;
+    tb_assert_and_check_return(cache && item);
+
+    // update the expired time
+    tb_spinlock_enter(&cache->lock);
+    item->entry.expires = expires;
+    cache->stats.revalidations++;
+    tb_spinlock_leave(&cache->lock);
+
+    // only update the expired time in the disk store
+    tb_http_cache_store_expires(cache, &item->entry, expires);
+}
+tb_bool_t tb_http_cache_expires(tb_char_t const* cache_control, tb_char_t const* expires, tb_char_t const* date, tb_time_t* pexpires)
+{
+    // check
+    tb_assert_and_check_return_val(pexpires, tb_false);
+
+    // parse the Cache-Control directives
+    tb_time_t   now = tb_time();
+    tb_long_t   max_age = -1;
+    tb_bool_t   no_cache = tb_false;
+    tb_char_t const* p = cache_control;
+    while (p && *p)
+    {
+        // skip spaces and ','
+        while (*p && (tb_isspace(*p) || *p == ',')) p++;
+
+        // the directive, the trailing spaces are trimmed
+        tb_char_t const* d = p;
+        while (*p && *p != ',') p++;
+        tb_size_t n = p - d;
+        while (n && tb_isspace(d[n - 1])) n--;
+        if (n == 8 && !tb_strnicmp(d, "no-store", 8)) return tb_false;
+        else if ((n == 8 || (n > 8 && d[8] == '=')) && !tb_strnicmp(d, "no-cache", 8)) no_cache = tb_true;
+        else if (n > 8 && !tb_strnicmp(d, "max-age=", 8)) max_age = tb_atoi(d + 8);
+    }
+
+    // compute the expired time, only the response with max-age or Expires is fresh
+    if (no_cache) *pexpires = now;
+    else if (max_age >= 0) *pexpires = now + max_age;
+    else if (expires)
+    {
+        // using the server date to avoid the clock skew
+        tb_time_t e = tb_http_date_from_cstr(expires, tb_strlen(expires));
+        tb_time_t d = date? tb_http_date_from_cstr(date, tb_strlen(date)) : 0;
+        *pexpires = e > 0? now + (e - (d > 0? d : now)) : now;
+    }
+    else *pexpires = now;
+    return tb_true;
+}
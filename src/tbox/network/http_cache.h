@@ -0,0 +1,215 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ *
+ * @author      ruki
+ * @file        http_cache.h
+ * @ingroup     network
+ *
+ */
+#ifndef TB_NETWORK_HTTP_CACHE_H
+#define TB_NETWORK_HTTP_CACHE_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/// the maximum data size of the cached entry
+#ifdef __tb_small__
+#   define TB_HTTP_CACHE_ENTRY_MAXN         (512 << 10)
+#else
+#   define TB_HTTP_CACHE_ENTRY_MAXN         (4 << 20)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the http cache ref type
+typedef __tb_typeref__(http_cache);
+
+/// the http cache entry type
+typedef struct __tb_http_cache_entry_t
+{
+    /// the url
+    tb_char_t const*        url;
+
+    /// the etag, maybe null
+    tb_char_t const*        etag;
+
+    /// the last modified time, maybe null
+    tb_char_t const*        last_modified;
+
+    /// the content type, maybe null
+    tb_char_t const*        content_type;
+
+    /// the expired time, it need be revalidated after it
+    tb_time_t               expires;
+
+    /// the data
+    tb_byte_t const*        data;
+
+    /// the size
+    tb_size_t               size;
+
+}tb_http_cache_entry_t;
+
+/// the http cache stats type
+typedef struct __tb_http_cache_stats_t
+{
+    /// the hit count, these responses are served without the network round-trip
+    tb_size_t               hits;
+
+    /// the miss count, these requests need be sent to the server
+    tb_size_t               misses;
+
+    /// the revalidated count of the misses, the server responds 304 for them
+    tb_size_t               revalidations;
+
+    /// the stored response count
+    tb_size_t               stores;
+
+    /// the evicted entry count from the memory
+    tb_size_t               evictions;
+
+    /// the entry count in the memory
+    tb_size_t               count;
+
+    /// the data size of all entries in the memory
+    tb_size_t               size;
+
+}tb_http_cache_stats_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the http cache 
+ *
+ * the entries are cached in the memory with the LRU order, 
+ * and they will also be stored to the given directory if exists.
+ *
+ * @code
+    tb_http_cache_ref_t cache = tb_http_cache_init("/tmp/cache", 0);
+    if (cache)
+    {
+        tb_http_ctrl(http, TB_HTTP_OPTION_SET_CACHE, cache);
+        // ...
+        tb_http_cache_exit(cache);
+    }
+ * @endcode
+ *
+ * @param rootdir   the root directory of the disk store, only cache them in the memory if be null
+ * @param maxn      the maximum data size in the memory, using the default size if be zero
+ *
+ * @return          the http cache
+ */
+tb_http_cache_ref_t tb_http_cache_init(tb_char_t const* rootdir, tb_size_t maxn);
+
+/*! exit the http cache
+ *
+ * @param cache     the http cache
+ */
+tb_void_t           tb_http_cache_exit(tb_http_cache_ref_t cache);
+
+/*! clear all entries in the memory and the disk store
+ *
+ * @param cache     the http cache
+ */
+tb_void_t           tb_http_cache_clear(tb_http_cache_ref_t cache);
+
+/*! get the http cache stats
+ *
+ * @param cache     the http cache
+ * @param stats     the stats
+ */
+tb_void_t           tb_http_cache_stats(tb_http_cache_ref_t cache, tb_http_cache_stats_t* stats);
+
+/*! get the cached entry of the given url
+ *
+ * it will be loaded from the disk store if it is not in the memory, 
+ * and it is counted as a hit only if it is still fresh.
+ *
+ * @note the expired time of the entry may be refreshed by the other threads, 
+ * so we need use the copied expired time instead of reading entry->expires directly
+ *
+ * @param cache     the http cache
+ * @param url       the url
+ * @param pexpires  the expired time of the entry, it is copied under the cache lock
+ *
+ * @return          the referenced entry, it need be released by tb_http_cache_put()
+ */
+tb_http_cache_entry_t const* tb_http_cache_get(tb_http_cache_ref_t cache, tb_char_t const* url, tb_time_t* pexpires);
+
+/*! release the entry referenced by tb_http_cache_get()
+ *
+ * @param cache     the http cache
+ * @param entry     the entry
+ */
+tb_void_t           tb_http_cache_put(tb_http_cache_ref_t cache, tb_http_cache_entry_t const* entry);
+
+/*! store the response entry, the given data will be copied
+ *
+ * @param cache     the http cache
+ * @param entry     the entry
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_http_cache_save(tb_http_cache_ref_t cache, tb_http_cache_entry_t const* entry);
+
+/*! refresh the expired time of the entry after it has been revalidated
+ *
+ * @param cache     the http cache
+ * @param entry     the entry
+ * @param expires   the new expired time
+ */
+tb_void_t           tb_http_cache_refresh(tb_http_cache_ref_t cache, tb_http_cache_entry_t const* entry, tb_time_t expires);
+
+/*! get the expired time of the response from the Cache-Control, Expires and Date headers
+ *
+ * - no-store: it cannot be stored
+ * - no-cache, must-revalidate without max-age or no freshness info: it need be revalidated before using it, expires is now
+ * - max-age or Expires: it is fresh until now + age
+ *
+ * @param cache_control     the Cache-Control value, maybe null
+ * @param expires           the Expires value, maybe null
+ * @param date              the Date value, maybe null
+ * @param pexpires          the expired time
+ *
+ * @return                  tb_true if it can be stored
+ */
+tb_bool_t           tb_http_cache_expires(tb_char_t const* cache_control, tb_char_t const* expires, tb_char_t const* date, tb_time_t* pexpires);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
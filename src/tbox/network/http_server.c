@@ -0,0 +1,1422 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        http_server.c
+ * @ingroup     network
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "http_server"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "http_server.h"
+#include "impl/http/date.h"
+#include "impl/http/method.h"
+#include "../libc/libc.h"
+#include "../utils/utils.h"
+#include "../platform/platform.h"
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+#   include "../coroutine/coroutine.h"
+#   define TB_HTTP_SERVER_ENABLE
+#endif
+
+#ifdef TB_HTTP_SERVER_ENABLE
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the input and output buffer size of the connection and the maximum cached connections
+#ifdef __tb_small__
+#   define TB_HTTP_SERVER_IBUFF_SIZE        (4096)
+#   define TB_HTTP_SERVER_OBUFF_SIZE        (8192)
+#   define TB_HTTP_SERVER_POOL_MAXN         (64)
+#else
+#   define TB_HTTP_SERVER_IBUFF_SIZE        (8192)
+#   define TB_HTTP_SERVER_OBUFF_SIZE        (16384)
+#   define TB_HTTP_SERVER_POOL_MAXN         (256)
+#endif
+
+// the maximum request body size
+#define TB_HTTP_SERVER_BODY_MAXN            (1 << 20)
+
+// the maximum size of the response headers added by the route function
+#define TB_HTTP_SERVER_HEADERS_SIZE         (1024)
+
+// the idle timeout (ms) of the connection
+#define TB_HTTP_SERVER_TIMEOUT              (30000)
+
+// the interval (ms) of checking the stopped state when waiting the next request
+#define TB_HTTP_SERVER_STOP_INTERVAL        (100)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the route type
+typedef struct __tb_http_server_route_t
+{
+    // the method
+    tb_size_t                       method;
+
+    // the path prefix
+    tb_char_t*                      prefix;
+
+    // the path prefix size
+    tb_size_t                       prefix_size;
+
+    // the route function
+    tb_http_server_func_t           func;
+
+    // the user private data
+    tb_cpointer_t                   priv;
+
+    // the root directory of the static files
+    tb_char_t*                      rootdir;
+
+}tb_http_server_route_t;
+
+// the response state enum
+typedef enum __tb_http_server_response_state_e
+{
+    TB_HTTP_SERVER_RESPONSE_STATE_NONE  = 0
+,   TB_HTTP_SERVER_RESPONSE_STATE_CHUNK = 1
+,   TB_HTTP_SERVER_RESPONSE_STATE_DONE  = 2
+
+}tb_http_server_response_state_e;
+
+// the server type
+struct __tb_http_server_t;
+
+// the connection type
+typedef struct __tb_http_server_conn_t
+{
+    // the next cached connection
+    struct __tb_http_server_conn_t* next;
+
+    // the server
+    struct __tb_http_server_t*      server;
+
+    // the socket
+    tb_socket_ref_t                 sock;
+
+    // the socket io has been failed?
+    tb_bool_t                       failed;
+
+    // the input data, it points to the inline buffer or the grown buffer for the large body
+    tb_byte_t*                      idata;
+
+    // the input data size
+    tb_size_t                       isize;
+
+    // the input data maxn
+    tb_size_t                       imaxn;
+
+    // the head offset of the current request
+    tb_size_t                       ihead;
+
+    // the scanned offset for finding the end of the current request head
+    tb_size_t                       iscan;
+
+    // the head size of the current request, it is zero if the head has not been received
+    tb_size_t                       hsize;
+
+    // the raw body size of the current request
+    tb_size_t                       bsize;
+
+    // the content length of the current request
+    tb_size_t                       clength;
+
+    // expect 100-continue?
+    tb_bool_t                       expect;
+
+    // the current request
+    tb_http_server_request_t        request;
+
+    // the response code
+    tb_size_t                       code;
+
+    // the response state
+    tb_size_t                       state;
+
+    // keep alive after the response?
+    tb_bool_t                       keep_alive;
+
+    // only send the response head?
+    tb_bool_t                       head_only;
+
+    // the response headers size
+    tb_size_t                       headers_size;
+
+    // the response headers
+    tb_char_t                       headers[TB_HTTP_SERVER_HEADERS_SIZE];
+
+    // the time of the cached date
+    tb_time_t                       date_time;
+
+    // the cached date
+    tb_char_t                       date[64];
+
+    // the output data size
+    tb_size_t                       osize;
+
+    // the output buffer for batching the pipelined responses
+    tb_byte_t                       obuff[TB_HTTP_SERVER_OBUFF_SIZE];
+
+    // the inline input buffer
+    tb_byte_t                       ibuff[TB_HTTP_SERVER_IBUFF_SIZE];
+
+}tb_http_server_conn_t;
+
+// the server type
+typedef struct __tb_http_server_t
+{
+    // the listener
+    tb_co_listener_ref_t            listener;
+
+    // the routes, sorted by the prefix size in descending order
+    tb_http_server_route_t*         routes;
+
+    // the route count
+    tb_size_t                       routes_size;
+
+    // the route maxn
+    tb_size_t                       routes_maxn;
+
+    // is stopped?
+    tb_atomic_t                     stopped;
+
+    // the lock of the cached connections
+    tb_spinlock_t                   lock;
+
+    // the cached connections
+    tb_http_server_conn_t*          pool;
+
+    // the cached connection count
+    tb_size_t                       pool_size;
+
+}tb_http_server_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the weeks
+static tb_char_t const* g_weeks[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+
+// the months
+static tb_char_t const* g_months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+// the mime types
+static tb_char_t const* g_mimes[][2] = 
+{
+    {"html",    "text/html"                 }
+,   {"htm",     "text/html"                 }
+,   {"css",     "text/css"                  }
+,   {"txt",     "text/plain"                }
+,   {"xml",     "text/xml"                  }
+,   {"js",      "application/javascript"    }
+,   {"json",    "application/json"          }
+,   {"pdf",     "application/pdf"           }
+,   {"wasm",    "application/wasm"          }
+,   {"png",     "image/png"                 }
+,   {"jpg",     "image/jpeg"                }
+,   {"jpeg",    "image/jpeg"                }
+,   {"gif",     "image/gif"                 }
+,   {"svg",     "image/svg+xml"             }
+,   {"ico",     "image/x-icon"              }
+};
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_char_t const* tb_http_server_code_cstr(tb_size_t code)
+{
+    // done
+    tb_char_t const* cstr = "Unknown";
+    switch (code)
+    {
+    case TB_HTTP_CODE_CONTINUE:                 cstr = "Continue"; break;
+    case TB_HTTP_CODE_OK:                       cstr = "OK"; break;
+    case TB_HTTP_CODE_CREATED:                  cstr = "Created"; break;
+    case TB_HTTP_CODE_ACCEPTED:                 cstr = "Accepted"; break;
+    case TB_HTTP_CODE_NO_CONTENT:               cstr = "No Content"; break;
+    case TB_HTTP_CODE_PARTIAL_CONTENT:          cstr = "Partial Content"; break;
+    case TB_HTTP_CODE_MOVED_PERMANENTLY:        cstr = "Moved Permanently"; break;
+    case TB_HTTP_CODE_MOVED_TEMPORARILY:        cstr = "Found"; break;
+    case TB_HTTP_CODE_SEE_OTHER:                cstr = "See Other"; break;
+    case TB_HTTP_CODE_NOT_MODIFIED:             cstr = "Not Modified"; break;
+    case TB_HTTP_CODE_TEMPORARY_REDIRECT:       cstr = "Temporary Redirect"; break;
+    case TB_HTTP_CODE_BAD_REQUEST:              cstr = "Bad Request"; break;
+    case TB_HTTP_CODE_UNAUTHORIZED:             cstr = "Unauthorized"; break;
+    case TB_HTTP_CODE_FORBIDDEN:                cstr = "Forbidden"; break;
+    case TB_HTTP_CODE_NOT_FOUND:                cstr = "Not Found"; break;
+    case TB_HTTP_CODE_METHOD_NOT_ALLOWED:       cstr = "Method Not Allowed"; break;
+    case TB_HTTP_CODE_REQUEST_TIMEOUT:          cstr = "Request Timeout"; break;
+    case TB_HTTP_CODE_LENGTH_REQUIRED:          cstr = "Length Required"; break;
+    case TB_HTTP_CODE_REQUEST_ENTITY_TOO_LONG:  cstr = "Payload Too Large"; break;
+    case TB_HTTP_CODE_REQUEST_URI_TOO_LONG:     cstr = "URI Too Long"; break;
+    case TB_HTTP_CODE_RANGE_NOT_SATISFIABLE:    cstr = "Range Not Satisfiable"; break;
+    case TB_HTTP_CODE_EXPECTATION_FAILED:       cstr = "Expectation Failed"; break;
+    case TB_HTTP_CODE_INTERNAL_SERVER_ERROR:    cstr = "Internal Server Error"; break;
+    case TB_HTTP_CODE_NOT_IMPLEMENTED:          cstr = "Not Implemented"; break;
+    case TB_HTTP_CODE_SERVICE_UNAVAILABLE:      cstr = "Service Unavailable"; break;
+    default: break;
+    }
+    return cstr;
+}
+static tb_char_t const* tb_http_server_mime(tb_char_t const* path)
+{
+    // get the file extension
+    tb_char_t const* ext = tb_strrchr(path, '.');
+    if (ext && !tb_strchr(ext, '/'))
+    {
+        tb_size_t i = 0;
+        for (i = 0; i < tb_arrayn(g_mimes); i++)
+        {
+            if (!tb_stricmp(ext + 1, g_mimes[i][0])) return g_mimes[i][1];
+        }
+    }
+    return "application/octet-stream";
+}
+static tb_bool_t tb_http_server_date(tb_time_t time, tb_char_t* data, tb_size_t maxn)
+{
+    // e.g. Sun, 06 Nov 1994 08:49:37 GMT
+    tb_tm_t tm = {0};
+    if (!tb_gmtime(time, &tm) || tm.week < 0 || tm.week > 6 || tm.month < 1 || tm.month > 12) return tb_false;
+    tb_snprintf(data, maxn, "%s, %02ld %s %04ld %02ld:%02ld:%02ld GMT", g_weeks[tm.week], tm.mday, g_months[tm.month - 1], tm.year, tm.hour, tm.minute, tm.second);
+    return tb_true;
+}
+static tb_http_server_conn_t* tb_http_server_conn_init(tb_http_server_t* server)
+{
+    // get a cached connection first
+    tb_spinlock_enter(&server->lock);
+    tb_http_server_conn_t* conn = server->pool;
+    if (conn)
+    {
+        server->pool = conn->next;
+        server->pool_size--;
+    }
+    tb_spinlock_leave(&server->lock);
+
+    // make a new connection
+    if (!conn) conn = tb_malloc_type(tb_http_server_conn_t);
+    tb_assert_and_check_return_val(conn, tb_null);
+
+    // init it, the buffers need not be cleared
+    conn->next          = tb_null;
+    conn->server        = server;
+    conn->sock          = tb_null;
+    conn->failed        = tb_false;
+    conn->idata         = conn->ibuff;
+    conn->isize         = 0;
+    conn->imaxn         = sizeof(conn->ibuff);
+    conn->ihead         = 0;
+    conn->iscan         = 0;
+    conn->hsize         = 0;
+    conn->bsize         = 0;
+    conn->osize         = 0;
+    conn->date_time     = 0;
+    conn->date[0]       = '\0';
+    return conn;
+}
+static tb_void_t tb_http_server_conn_exit(tb_http_server_conn_t* conn)
+{
+    // exit the grown input buffer
+    tb_http_server_t* server = conn->server;
+    if (conn->idata != conn->ibuff) tb_free(conn->idata);
+    conn->idata = conn->ibuff;
+
+    // cache it
+    tb_spinlock_enter(&server->lock);
+    if (server->pool_size < TB_HTTP_SERVER_POOL_MAXN)
+    {
+        conn->next = server->pool;
+        server->pool = conn;
+        server->pool_size++;
+        conn = tb_null;
+    }
+    tb_spinlock_leave(&server->lock);
+
+    // exit it if the pool is full
+    if (conn) tb_free(conn);
+}
+static tb_bool_t tb_http_server_conn_send(tb_http_server_conn_t* conn, tb_byte_t const* data, tb_size_t size)
+{
+    // send all data
+    tb_size_t send = 0;
+    tb_bool_t wait = tb_false;
+    while (send < size)
+    {
+        tb_long_t real = tb_socket_send(conn->sock, data + send, size - send);
+        if (real > 0)
+        {
+            send += real;
+            wait = tb_false;
+        }
+        else if (!real && !wait)
+        {
+            if (tb_socket_wait(conn->sock, TB_SOCKET_EVENT_SEND, TB_HTTP_SERVER_TIMEOUT) <= 0) break;
+            wait = tb_true;
+        }
+        else break;
+    }
+
+    // failed?
+    if (send != size) conn->failed = tb_true;
+    return !conn->failed;
+}
+static tb_bool_t tb_http_server_conn_flush(tb_http_server_conn_t* conn)
+{
+    // flush the batched responses
+    tb_check_return_val(conn->osize, !conn->failed);
+    tb_bool_t ok = tb_http_server_conn_send(conn, conn->obuff, conn->osize);
+    conn->osize = 0;
+    return ok;
+}
+static tb_bool_t tb_http_server_conn_write(tb_http_server_conn_t* conn, tb_byte_t const* data, tb_size_t size)
+{
+    // flush it if the output buffer is full
+    if (conn->osize + size > sizeof(conn->obuff) && !tb_http_server_conn_flush(conn)) return tb_false;
+
+    // send the large data directly
+    if (size >= sizeof(conn->obuff)) return tb_http_server_conn_send(conn, data, size);
+
+    // batch it
+    tb_memcpy(conn->obuff + conn->osize, data, size);
+    conn->osize += size;
+    return !conn->failed;
+}
+static tb_void_t tb_http_server_request_rebase(tb_http_server_request_t* request, tb_byte_t const* from, tb_byte_t const* to)
+{
+#define tb_http_server_rebase(p)   (p) = (tb_char_t const*)(to + ((tb_byte_t const*)(p) - from))
+
+    // the slices point to the moved input buffer
+    tb_size_t i = 0;
+    tb_http_server_rebase(request->path);
+    tb_http_server_rebase(request->query);
+    for (i = 0; i < request->headers_count; i++)
+    {
+        tb_http_server_rebase(request->headers[i].name);
+        tb_http_server_rebase(request->headers[i].value);
+    }
+
+#undef tb_http_server_rebase
+}
+static tb_size_t tb_http_server_conn_head_find(tb_http_server_conn_t* conn)
+{
+    /* find the end of the request head from the last scanned position, 
+     * so the received head will be only scanned once
+     */
+    tb_byte_t const* b = conn->idata + conn->ihead;
+    tb_byte_t const* p = conn->idata + conn->iscan;
+    tb_byte_t const* e = conn->idata + conn->isize;
+    while (p < e)
+    {
+        // find the next line end
+        while (p < e && *p != '\n') p++;
+        if (p + 1 >= e) break;
+
+        // "\n\n" or "\n\r\n"?
+        if (p[1] == '\n') return p + 2 - b;
+        if (p[1] == '\r')
+        {
+            if (p + 2 >= e) break;
+            if (p[2] == '\n') return p + 3 - b;
+        }
+        p++;
+    }
+
+    // rescan the incomplete line end next time
+    conn->iscan = p < e? p - conn->idata : conn->isize;
+    return 0;
+}
+static tb_size_t tb_http_server_conn_head_parse(tb_http_server_conn_t* conn)
+{
+    // init request
+    tb_http_server_request_t* request = &conn->request;
+    request->headers_count  = 0;
+    request->chunked        = tb_false;
+    request->body           = tb_null;
+    request->body_size      = 0;
+    conn->clength           = 0;
+    conn->expect            = tb_false;
+
+    // parse the method
+    tb_char_t*  p = (tb_char_t*)conn->idata + conn->ihead;
+    tb_char_t*  e = p + conn->hsize;
+    tb_char_t*  b = p;
+    while (p < e && *p != ' ' && *p != '\n') p++;
+    tb_check_return_val(p < e && *p == ' ', TB_HTTP_CODE_BAD_REQUEST);
+    for (request->method = TB_HTTP_METHOD_GET; request->method <= TB_HTTP_METHOD_CONNECT; request->method++)
+    {
+        tb_char_t const* method = tb_http_method_cstr(request->method);
+        if (!tb_strncmp(method, b, p - b) && !method[p - b]) break;
+    }
+    tb_check_return_val(request->method <= TB_HTTP_METHOD_CONNECT, TB_HTTP_CODE_NOT_IMPLEMENTED);
+
+    // parse the target, e.g. /path?query, * or http://host/path?query
+    b = ++p;
+    while (p < e && *p != ' ' && *p != '\n') p++;
+    tb_check_return_val(p < e && *p == ' ' && p > b, TB_HTTP_CODE_BAD_REQUEST);
+    *p++ = '\0';
+    if (*b != '/' && *b != '*')
+    {
+        // skip the scheme and host of the absolute target
+        tb_char_t* s = tb_strstr(b, "://");
+        tb_check_return_val(s, TB_HTTP_CODE_BAD_REQUEST);
+        b = tb_strchr(s + 3, '/');
+        tb_check_return_val(b, TB_HTTP_CODE_BAD_REQUEST);
+    }
+    tb_char_t* q = tb_strchr(b, '?');
+    if (q)
+    {
+        *q++ = '\0';
+        request->query      = q;
+        request->query_size = p - q - 1;
+    }
+    else
+    {
+        request->query      = p - 1;
+        request->query_size = 0;
+    }
+    request->path       = b;
+    request->path_size  = (q? q - 1 : p - 1) - b;
+
+    // parse the version
+    tb_check_return_val(e - p >= 9 && !tb_strncmp(p, "HTTP/1.", 7) && (p[7] == '0' || p[7] == '1'), TB_HTTP_CODE_BAD_REQUEST);
+    request->version    = p[7] - '0';
+    request->keep_alive = request->version > 0;
+    p += 8;
+    if (*p == '\r') p++;
+    tb_check_return_val(*p == '\n', TB_HTTP_CODE_BAD_REQUEST);
+    p++;
+
+    // parse the headers
+    tb_bool_t has_length = tb_false;
+    while (p < e)
+    {
+        // get the line, the head end has been found, so the line end always exists
+        b = p;
+        while (*p != '\n') p++;
+        tb_char_t* le = p++;
+        if (le > b && le[-1] == '\r') le--;
+
+        // the end of head?
+        if (le == b) break;
+
+        // get the name, the obsolete line folding is not supported
+        tb_char_t* c = b;
+        while (c < le && *c != ':' && !tb_isspace(*c)) c++;
+        tb_check_return_val(c < le && *c == ':' && c > b, TB_HTTP_CODE_BAD_REQUEST);
+        tb_check_return_val(request->headers_count < tb_arrayn(request->headers), TB_HTTP_CODE_BAD_REQUEST);
+        tb_size_t name_size = c - b;
+        *c++ = '\0';
+
+        // get the value
+        while (c < le && (*c == ' ' || *c == '\t')) c++;
+        while (le > c && (le[-1] == ' ' || le[-1] == '\t')) le--;
+        *le = '\0';
+
+        // save it
+        tb_http_server_header_t* header = &request->headers[request->headers_count++];
+        header->name        = b;
+        header->name_size   = name_size;
+        header->value       = c;
+        header->value_size  = le - c;
+
+        // handle the known headers
+        switch (name_size)
+        {
+        case 6:
+            if (!tb_stricmp(b, "Expect"))
+            {
+                tb_check_return_val(!tb_stricmp(c, "100-continue"), TB_HTTP_CODE_EXPECTATION_FAILED);
+                conn->expect = tb_true;
+            }
+            break;
+        case 10:
+            if (!tb_stricmp(b, "Connection"))
+            {
+                if (tb_stristr(c, "close")) request->keep_alive = tb_false;
+                else if (tb_stristr(c, "keep-alive")) request->keep_alive = tb_true;
+            }
+            break;
+        case 14:
+            if (!tb_stricmp(b, "Content-Length"))
+            {
+                // parse it strictly
+                tb_size_t clength = 0;
+                tb_check_return_val(c < le, TB_HTTP_CODE_BAD_REQUEST);
+                for (; c < le; c++)
+                {
+                    tb_check_return_val(tb_isdigit10(*c), TB_HTTP_CODE_BAD_REQUEST);
+                    clength = clength * 10 + (*c - '0');
+                    tb_check_return_val(clength <= TB_HTTP_SERVER_BODY_MAXN, TB_HTTP_CODE_REQUEST_ENTITY_TOO_LONG);
+                }
+                tb_check_return_val(!has_length || clength == conn->clength, TB_HTTP_CODE_BAD_REQUEST);
+                conn->clength = clength;
+                has_length = tb_true;
+            }
+            break;
+        case 17:
+            if (!tb_stricmp(b, "Transfer-Encoding"))
+            {
+                // only the chunked encoding is supported
+                tb_check_return_val(le - c >= 7 && !tb_stricmp(le - 7, "chunked"), TB_HTTP_CODE_NOT_IMPLEMENTED);
+                request->chunked = tb_true;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // the ambiguous body length is not allowed
+    tb_check_return_val(!request->chunked || !has_length, TB_HTTP_CODE_BAD_REQUEST);
+    return 0;
+}
+static tb_long_t tb_http_server_chunked_parse(tb_byte_t* b, tb_byte_t const* e, tb_size_t* praw, tb_size_t* psize, tb_bool_t decode)
+{
+    // parse all chunks, and move the chunk data to the front if decode it
+    tb_byte_t*  p = b;
+    tb_byte_t*  q = b;
+    while (1)
+    {
+        // parse the chunk size
+        tb_size_t size = 0;
+        tb_size_t digits = 0;
+        while (p < e && tb_isdigit16(*p))
+        {
+            size = (size << 4) + (tb_isdigit10(*p)? *p - '0' : (tb_tolower(*p) - 'a' + 10));
+            tb_check_return_val(++digits <= 8, -1);
+            p++;
+        }
+        tb_check_return_val(p < e, 0);
+        tb_check_return_val(digits, -1);
+
+        // skip the chunk extensions
+        while (p < e && *p != '\n') p++;
+        tb_check_return_val(p < e, 0);
+        p++;
+
+        // the last chunk? skip the trailers
+        if (!size)
+        {
+            while (1)
+            {
+                tb_byte_t* l = p;
+                while (p < e && *p != '\n') p++;
+                tb_check_return_val(p < e, 0);
+                p++;
+                if (p - l == 1 || (p - l == 2 && *l == '\r')) break;
+            }
+            break;
+        }
+
+        // get the chunk data
+        tb_check_return_val((tb_size_t)(e - p) >= size + 1, 0);
+        if (decode) tb_memmov(q, p, size);
+        q += size;
+        p += size;
+
+        // skip the chunk end
+        if (*p == '\r') p++;
+        tb_check_return_val(p < e, 0);
+        tb_check_return_val(*p == '\n', -1);
+        p++;
+    }
+
+    // ok
+    *praw   = p - b;
+    *psize  = q - b;
+    return 1;
+}
+static tb_long_t tb_http_server_conn_body(tb_http_server_conn_t* conn, tb_size_t* pcode)
+{
+    // get the received body data
+    tb_http_server_request_t*   request = &conn->request;
+    tb_byte_t*                  b = conn->idata + conn->ihead + conn->hsize;
+    tb_byte_t const*            e = conn->idata + conn->isize;
+
+    // the chunked body?
+    if (request->chunked)
+    {
+        // validate it first, we cannot decode it in place until all chunks are received
+        tb_size_t raw = 0;
+        tb_size_t size = 0;
+        tb_long_t ok = tb_http_server_chunked_parse(b, e, &raw, &size, tb_false);
+        if (ok > 0)
+        {
+            tb_http_server_chunked_parse(b, e, &raw, &size, tb_true);
+            request->body       = b;
+            request->body_size  = size;
+            conn->bsize         = raw;
+        }
+        else if (ok < 0) *pcode = TB_HTTP_CODE_BAD_REQUEST;
+        else if ((tb_size_t)(e - b) > TB_HTTP_SERVER_BODY_MAXN)
+        {
+            *pcode = TB_HTTP_CODE_REQUEST_ENTITY_TOO_LONG;
+            ok = -1;
+        }
+        return ok;
+    }
+
+    // the body with the content length
+    tb_check_return_val((tb_size_t)(e - b) >= conn->clength, 0);
+    request->body       = conn->clength? b : tb_null;
+    request->body_size  = conn->clength;
+    conn->bsize         = conn->clength;
+    return 1;
+}
+static tb_bool_t tb_http_server_conn_ibuff(tb_http_server_conn_t* conn)
+{
+    // move the left data of the current request to the front
+    if (conn->ihead)
+    {
+        tb_size_t left = conn->isize - conn->ihead;
+        if (left) tb_memmov(conn->idata, conn->idata + conn->ihead, left);
+        if (conn->hsize) tb_http_server_request_rebase(&conn->request, conn->idata + conn->ihead, conn->idata);
+        conn->isize = left;
+        conn->iscan -= conn->ihead;
+        conn->ihead = 0;
+    }
+
+    // the free space is enough?
+    tb_check_return_val(conn->isize == conn->imaxn, tb_true);
+
+    // only the body can be larger than the inline buffer
+    tb_check_return_val(conn->hsize, tb_false);
+
+    // grow the input buffer
+    tb_size_t maxn = conn->request.chunked? tb_min(conn->imaxn << 1, conn->hsize + TB_HTTP_SERVER_BODY_MAXN + TB_HTTP_SERVER_IBUFF_SIZE) : conn->hsize + conn->clength;
+    tb_check_return_val(maxn > conn->imaxn, tb_false);
+    tb_byte_t* data = tb_malloc_bytes(maxn);
+    tb_assert_and_check_return_val(data, tb_false);
+    tb_memcpy(data, conn->idata, conn->isize);
+    tb_http_server_request_rebase(&conn->request, conn->idata, data);
+    if (conn->idata != conn->ibuff) tb_free(conn->idata);
+    conn->idata = data;
+    conn->imaxn = maxn;
+    return tb_true;
+}
+static tb_bool_t tb_http_server_conn_recv(tb_http_server_conn_t* conn)
+{
+    // recv data
+    tb_bool_t wait = tb_false;
+    while (1)
+    {
+        tb_long_t real = tb_socket_recv(conn->sock, conn->idata + conn->isize, conn->imaxn - conn->isize);
+        if (real > 0)
+        {
+            conn->isize += real;
+            return tb_true;
+        }
+
+        // closed or failed?
+        tb_check_break(!real && !wait);
+
+        // wait it and close the idle connection if the server has been stopped
+        tb_long_t ok = 0;
+        tb_size_t waited = 0;
+        while (!ok && waited < TB_HTTP_SERVER_TIMEOUT)
+        {
+            if (conn->isize == conn->ihead && tb_atomic_get(&conn->server->stopped)) break;
+            ok = tb_socket_wait(conn->sock, TB_SOCKET_EVENT_RECV, TB_HTTP_SERVER_STOP_INTERVAL);
+            waited += TB_HTTP_SERVER_STOP_INTERVAL;
+        }
+        tb_check_break(ok > 0);
+        wait = tb_true;
+    }
+    return tb_false;
+}
+static tb_bool_t tb_http_server_response_head(tb_http_server_conn_t* conn, tb_hong_t size)
+{
+    // make sure the space of the response head is enough
+    tb_size_t maxn = sizeof(conn->obuff);
+    if (conn->osize + conn->headers_size + 512 > maxn && !tb_http_server_conn_flush(conn)) return tb_false;
+
+    // update the cached date
+    tb_time_t now = tb_time();
+    if (now != conn->date_time && tb_http_server_date(now, conn->date, sizeof(conn->date))) 
+        conn->date_time = now;
+
+    // make the status line and the common headers
+    tb_char_t*  data = (tb_char_t*)conn->obuff + conn->osize;
+    tb_long_t   real = tb_snprintf(data, maxn - conn->osize, "HTTP/1.1 %lu %s\r\nServer: tbox\r\nDate: %s\r\nConnection: %s\r\n"
+                        , conn->code, tb_http_server_code_cstr(conn->code), conn->date, conn->keep_alive? "keep-alive" : "close");
+    tb_assert_and_check_return_val(real > 0, tb_false);
+    data += real;
+
+    // append the user headers
+    tb_memcpy(data, conn->headers, conn->headers_size);
+    data += conn->headers_size;
+
+    // append the body length, the body of 1xx, 204 and 304 has no length
+    if (conn->code < TB_HTTP_CODE_OK || conn->code == TB_HTTP_CODE_NO_CONTENT || conn->code == TB_HTTP_CODE_NOT_MODIFIED)
+        real = tb_snprintf(data, 8, "\r\n");
+    else if (size >= 0)
+        real = tb_snprintf(data, 64, "Content-Length: %lld\r\n\r\n", size);
+    else if (conn->request.version)
+        real = tb_snprintf(data, 64, "Transfer-Encoding: chunked\r\n\r\n");
+    else real = tb_snprintf(data, 8, "\r\n");
+    tb_assert_and_check_return_val(real > 0, tb_false);
+    data += real;
+
+    // ok
+    conn->osize = (tb_byte_t*)data - conn->obuff;
+    return tb_true;
+}
+static tb_void_t tb_http_server_response_init(tb_http_server_conn_t* conn, tb_size_t code)
+{
+    conn->code          = code;
+    conn->state         = TB_HTTP_SERVER_RESPONSE_STATE_NONE;
+    conn->headers_size  = 0;
+    conn->head_only     = conn->hsize && conn->request.method == TB_HTTP_METHOD_HEAD;
+    conn->keep_alive    = conn->hsize && conn->request.keep_alive && !tb_atomic_get(&conn->server->stopped);
+}
+static tb_bool_t tb_http_server_response_error(tb_http_server_conn_t* conn)
+{
+    tb_char_t const* cstr = tb_http_server_code_cstr(conn->code);
+    return tb_http_server_response_header((tb_http_server_response_ref_t)conn, "Content-Type", "text/plain")
+        && tb_http_server_response_body((tb_http_server_response_ref_t)conn, (tb_byte_t const*)cstr, tb_strlen(cstr));
+}
+static tb_http_server_route_t* tb_http_server_route_find(tb_http_server_t* server, tb_http_server_request_t const* request, tb_bool_t* pmatched)
+{
+    // find the route with the longest prefix
+    tb_size_t i = 0;
+    for (i = 0; i < server->routes_size; i++)
+    {
+        // match the prefix with the whole path segments
+        tb_http_server_route_t* route = &server->routes[i];
+        tb_size_t               n = route->prefix_size;
+        if (    request->path_size >= n 
+            &&  !tb_strncmp(request->path, route->prefix, n)
+            &&  (!n || route->prefix[n - 1] == '/' || request->path_size == n || request->path[n] == '/'))
+        {
+            // match the method
+            *pmatched = tb_true;
+            if (    route->method == TB_HTTP_SERVER_METHOD_ANY 
+                ||  route->method == request->method
+                ||  (route->method == TB_HTTP_METHOD_GET && request->method == TB_HTTP_METHOD_HEAD))
+                return route;
+        }
+    }
+    return tb_null;
+}
+static tb_bool_t tb_http_server_route_static_done(tb_http_server_conn_t* conn, tb_http_server_route_t* route)
+{
+    // decode the relative path
+    tb_char_t                       path[TB_PATH_MAXN];
+    tb_http_server_request_t const* request = &conn->request;
+    tb_char_t const*                rel = request->path + route->prefix_size;
+    while (*rel == '/') rel++;
+    tb_size_t                       rootdir_size = tb_strlcpy(path, route->rootdir, sizeof(path));
+    tb_check_return_val(rootdir_size + 1 < sizeof(path), tb_false);
+    path[rootdir_size++] = '/';
+    tb_size_t size = tb_url_decode2(rel, tb_strlen(rel), path + rootdir_size, sizeof(path) - rootdir_size - 1);
+
+    // the parent directory and the decoded null character are forbidden
+    tb_char_t const* p = path + rootdir_size;
+    tb_char_t const* e = p + size;
+    tb_bool_t        forbidden = tb_strlen(p) != size;
+    while (p < e && !forbidden)
+    {
+        tb_char_t const* s = p;
+        while (p < e && *p != '/') p++;
+        forbidden = p - s == 2 && s[0] == '.' && s[1] == '.';
+        if (p < e) p++;
+    }
+    if (forbidden)
+    {
+        tb_http_server_response_status((tb_http_server_response_ref_t)conn, TB_HTTP_CODE_FORBIDDEN);
+        return tb_true;
+    }
+
+    // get the index file of the directory
+    tb_file_info_t info;
+    if (!size || path[rootdir_size + size - 1] == '/' || (tb_file_info(path, &info) && info.type == TB_FILE_TYPE_DIRECTORY))
+    {
+        tb_size_t n = rootdir_size + size;
+        if (n && path[n - 1] != '/') path[n++] = '/';
+        tb_strlcpy(path + n, "index.html", sizeof(path) - n);
+    }
+
+    // send the file
+    return tb_http_server_response_header((tb_http_server_response_ref_t)conn, "Content-Type", tb_http_server_mime(path))
+        && tb_http_server_response_file((tb_http_server_response_ref_t)conn, path);
+}
+static tb_void_t tb_http_server_conn_dispatch(tb_http_server_conn_t* conn)
+{
+    // init response
+    tb_http_server_response_init(conn, TB_HTTP_CODE_OK);
+
+    // find the route
+    tb_bool_t               ok = tb_true;
+    tb_bool_t               matched = tb_false;
+    tb_http_server_route_t* route = tb_http_server_route_find(conn->server, &conn->request, &matched);
+    if (route)
+    {
+        // done it
+        if (route->rootdir) ok = tb_http_server_route_static_done(conn, route);
+        else ok = route->func(&conn->request, (tb_http_server_response_ref_t)conn, route->priv);
+    }
+    else conn->code = matched? TB_HTTP_CODE_METHOD_NOT_ALLOWED : TB_HTTP_CODE_NOT_FOUND;
+
+    // failed? close the connection after responding
+    if (!ok)
+    {
+        conn->keep_alive = tb_false;
+        if (conn->code < TB_HTTP_CODE_BAD_REQUEST) conn->code = TB_HTTP_CODE_INTERNAL_SERVER_ERROR;
+    }
+
+    // finish the response
+    switch (conn->state)
+    {
+    case TB_HTTP_SERVER_RESPONSE_STATE_NONE:
+        if (conn->code >= TB_HTTP_CODE_BAD_REQUEST && !conn->headers_size) tb_http_server_response_error(conn);
+        else tb_http_server_response_body((tb_http_server_response_ref_t)conn, tb_null, 0);
+        break;
+    case TB_HTTP_SERVER_RESPONSE_STATE_CHUNK:
+        tb_http_server_response_chunk((tb_http_server_response_ref_t)conn, tb_null, 0);
+        break;
+    default:
+        break;
+    }
+}
+static tb_void_t tb_http_server_conn_done(tb_http_server_conn_t* conn)
+{
+    // done all requests of this connection
+    while (!conn->failed)
+    {
+        tb_size_t code = 0;
+        if (!conn->hsize)
+        {
+            // skip the empty lines between the pipelined requests
+            while (conn->ihead < conn->isize && (conn->idata[conn->ihead] == '\r' || conn->idata[conn->ihead] == '\n')) conn->ihead++;
+            if (conn->iscan < conn->ihead) conn->iscan = conn->ihead;
+
+            // find and parse the request head
+            conn->hsize = tb_http_server_conn_head_find(conn);
+            if (conn->hsize) code = tb_http_server_conn_head_parse(conn);
+            else if (conn->isize - conn->ihead >= TB_HTTP_SERVER_IBUFF_SIZE) code = TB_HTTP_CODE_BAD_REQUEST;
+        }
+        if (!code && conn->hsize)
+        {
+            // the whole request has been received? done it without receiving the next pipelined requests
+            if (tb_http_server_conn_body(conn, &code) > 0)
+            {
+                tb_http_server_conn_dispatch(conn);
+                conn->ihead += conn->hsize + conn->bsize;
+                conn->iscan = conn->ihead;
+                conn->hsize = 0;
+                conn->bsize = 0;
+                conn->expect = tb_false;
+                tb_check_break(conn->keep_alive);
+
+                // free the grown input buffer
+                if (conn->idata != conn->ibuff && conn->ihead == conn->isize)
+                {
+                    tb_free(conn->idata);
+                    conn->idata = conn->ibuff;
+                    conn->imaxn = sizeof(conn->ibuff);
+                    conn->isize = conn->ihead = conn->iscan = 0;
+                }
+                continue;
+            }
+        }
+
+        // respond the error and close the connection
+        if (code)
+        {
+            tb_http_server_response_init(conn, code);
+            conn->keep_alive = tb_false;
+            conn->head_only = tb_false;
+            tb_http_server_response_error(conn);
+            break;
+        }
+
+        // flush the batched responses before waiting the next requests
+        tb_check_break(tb_http_server_conn_flush(conn));
+
+        // the client is waiting for 100-continue?
+        if (conn->hsize && conn->expect)
+        {
+            static tb_char_t const s_continue[] = "HTTP/1.1 100 Continue\r\n\r\n";
+            tb_check_break(tb_http_server_conn_send(conn, (tb_byte_t const*)s_continue, sizeof(s_continue) - 1));
+            conn->expect = tb_false;
+        }
+
+        // recv more data
+        if (!tb_http_server_conn_ibuff(conn))
+        {
+            tb_http_server_response_init(conn, TB_HTTP_CODE_REQUEST_ENTITY_TOO_LONG);
+            conn->keep_alive = tb_false;
+            tb_http_server_response_error(conn);
+            break;
+        }
+        tb_check_break(tb_http_server_conn_recv(conn));
+    }
+
+    // flush the left responses
+    tb_http_server_conn_flush(conn);
+}
+static tb_void_t tb_http_server_conn_func(tb_socket_ref_t sock, tb_cpointer_t priv)
+{
+    // check
+    tb_http_server_t* server = (tb_http_server_t*)priv;
+    tb_assert_and_check_return(server && sock);
+
+    // init connection
+    tb_http_server_conn_t* conn = tb_http_server_conn_init(server);
+    tb_check_return(conn);
+
+    // done it
+    conn->sock = sock;
+    tb_http_server_conn_done(conn);
+
+    // exit connection, the socket will be closed by the listener
+    tb_http_server_conn_exit(conn);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_http_server_ref_t tb_http_server_init(tb_ipaddr_ref_t addr, tb_size_t workers)
+{
+    // done
+    tb_bool_t           ok = tb_false;
+    tb_http_server_t*   server = tb_null;
+    do
+    {
+        // make server
+        server = tb_malloc0_type(tb_http_server_t);
+        tb_assert_and_check_break(server);
+
+        // init lock
+        if (!tb_spinlock_init(&server->lock)) break;
+
+        // init listener
+        server->listener = tb_co_listener_init(addr, workers, TB_CO_LISTENER_FLAG_NONE, tb_http_server_conn_func, server);
+        tb_check_break(server->listener);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (server) tb_http_server_exit((tb_http_server_ref_t)server);
+        server = tb_null;
+    }
+    return (tb_http_server_ref_t)server;
+}
+tb_void_t tb_http_server_exit(tb_http_server_ref_t self)
+{
+    // check
+    tb_http_server_t* server = (tb_http_server_t*)self;
+    tb_assert_and_check_return(server);
+
+    // exit listener, it will wait all workers
+    tb_atomic_set(&server->stopped, 1);
+    if (server->listener) tb_co_listener_exit(server->listener);
+    server->listener = tb_null;
+
+    // exit routes
+    tb_size_t i = 0;
+    for (i = 0; i < server->routes_size; i++)
+    {
+        if (server->routes[i].prefix) tb_free(server->routes[i].prefix);
+        if (server->routes[i].rootdir) tb_free(server->routes[i].rootdir);
+    }
+    if (server->routes) tb_free(server->routes);
+    server->routes = tb_null;
+
+    // exit the cached connections
+    while (server->pool)
+    {
+        tb_http_server_conn_t* conn = server->pool;
+        server->pool = conn->next;
+        tb_free(conn);
+    }
+
+    // exit lock
+    tb_spinlock_exit(&server->lock);
+
+    // exit it
+    tb_free(server);
+}
+tb_bool_t tb_http_server_start(tb_http_server_ref_t self)
+{
+    // check
+    tb_http_server_t* server = (tb_http_server_t*)self;
+    tb_assert_and_check_return_val(server && server->listener, tb_false);
+
+    // start it
+    return tb_co_listener_start(server->listener);
+}
+tb_void_t tb_http_server_kill(tb_http_server_ref_t self)
+{
+    // check
+    tb_http_server_t* server = (tb_http_server_t*)self;
+    tb_assert_and_check_return(server && server->listener);
+
+    // kill it
+    tb_atomic_set(&server->stopped, 1);
+    tb_co_listener_kill(server->listener);
+}
+tb_bool_t tb_http_server_addr(tb_http_server_ref_t self, tb_ipaddr_ref_t addr)
+{
+    // check
+    tb_http_server_t* server = (tb_http_server_t*)self;
+    tb_assert_and_check_return_val(server && server->listener, tb_false);
+
+    // get it
+    return tb_co_listener_addr(server->listener, addr);
+}
+static tb_bool_t tb_http_server_route_add(tb_http_server_t* server, tb_size_t method, tb_char_t const* prefix, tb_http_server_func_t func, tb_cpointer_t priv, tb_char_t const* rootdir)
+{
+    // check
+    tb_assert_and_check_return_val(server && prefix && *prefix == '/', tb_false);
+
+    // grow routes
+    if (server->routes_size == server->routes_maxn)
+    {
+        tb_size_t               maxn = server->routes_maxn? server->routes_maxn << 1 : 8;
+        tb_http_server_route_t* routes = tb_ralloc_type(server->routes, maxn, tb_http_server_route_t);
+        tb_assert_and_check_return_val(routes, tb_false);
+        server->routes      = routes;
+        server->routes_maxn = maxn;
+    }
+
+    // make route
+    tb_http_server_route_t route;
+    route.method        = method;
+    route.prefix        = tb_strdup(prefix);
+    route.prefix_size   = tb_strlen(prefix);
+    route.func          = func;
+    route.priv          = priv;
+    route.rootdir       = rootdir? tb_strdup(rootdir) : tb_null;
+    if (!route.prefix || (rootdir && !route.rootdir))
+    {
+        if (route.prefix) tb_free(route.prefix);
+        if (route.rootdir) tb_free(route.rootdir);
+        return tb_false;
+    }
+
+    // insert it by the prefix size in descending order
+    tb_size_t i = server->routes_size;
+    while (i && server->routes[i - 1].prefix_size < route.prefix_size)
+    {
+        server->routes[i] = server->routes[i - 1];
+        i--;
+    }
+    server->routes[i] = route;
+    server->routes_size++;
+    return tb_true;
+}
+tb_bool_t tb_http_server_route(tb_http_server_ref_t self, tb_size_t method, tb_char_t const* prefix, tb_http_server_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(func, tb_false);
+
+    // add it
+    return tb_http_server_route_add((tb_http_server_t*)self, method, prefix, func, priv, tb_null);
+}
+tb_bool_t tb_http_server_route_static(tb_http_server_ref_t self, tb_char_t const* prefix, tb_char_t const* rootdir)
+{
+    // check
+    tb_assert_and_check_return_val(rootdir, tb_false);
+
+    // add it
+    return tb_http_server_route_add((tb_http_server_t*)self, TB_HTTP_METHOD_GET, prefix, tb_null, tb_null, rootdir);
+}
+tb_char_t const* tb_http_server_request_header(tb_http_server_request_t const* request, tb_char_t const* name)
+{
+    // check
+    tb_assert_and_check_return_val(request && name, tb_null);
+
+    // find it
+    tb_size_t i = 0;
+    tb_size_t n = tb_strlen(name);
+    for (i = 0; i < request->headers_count; i++)
+    {
+        tb_http_server_header_t const* header = &request->headers[i];
+        if (header->name_size == n && !tb_stricmp(header->name, name)) return header->value;
+    }
+    return tb_null;
+}
+tb_void_t tb_http_server_response_status(tb_http_server_response_ref_t response, tb_size_t code)
+{
+    // check
+    tb_http_server_conn_t* conn = (tb_http_server_conn_t*)response;
+    tb_assert_and_check_return(conn && conn->state == TB_HTTP_SERVER_RESPONSE_STATE_NONE);
+
+    // set it
+    conn->code = code;
+}
+tb_bool_t tb_http_server_response_header(tb_http_server_response_ref_t response, tb_char_t const* name, tb_char_t const* value)
+{
+    // check
+    tb_http_server_conn_t* conn = (tb_http_server_conn_t*)response;
+    tb_assert_and_check_return_val(conn && name && value && conn->state == TB_HTTP_SERVER_RESPONSE_STATE_NONE, tb_false);
+
+    // append it
+    tb_size_t maxn = sizeof(conn->headers) - conn->headers_size;
+    tb_long_t real = tb_snprintf(conn->headers + conn->headers_size, maxn, "%s: %s\r\n", name, value);
+    tb_check_return_val(real > 0 && (tb_size_t)real < maxn, tb_false);
+    conn->headers_size += real;
+    return tb_true;
+}
+tb_bool_t tb_http_server_response_body(tb_http_server_response_ref_t response, tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_http_server_conn_t* conn = (tb_http_server_conn_t*)response;
+    tb_assert_and_check_return_val(conn && (data || !size) && conn->state == TB_HTTP_SERVER_RESPONSE_STATE_NONE, tb_false);
+
+    // send it
+    conn->state = TB_HTTP_SERVER_RESPONSE_STATE_DONE;
+    if (!tb_http_server_response_head(conn, size)) return tb_false;
+    return conn->head_only || !size || tb_http_server_conn_write(conn, data, size);
+}
+tb_bool_t tb_http_server_response_file(tb_http_server_response_ref_t response, tb_char_t const* path)
+{
+    // check
+    tb_http_server_conn_t* conn = (tb_http_server_conn_t*)response;
+    tb_assert_and_check_return_val(conn && path && conn->state == TB_HTTP_SERVER_RESPONSE_STATE_NONE, tb_false);
+
+    // not found?
+    tb_file_info_t  info;
+    tb_file_ref_t   file = tb_null;
+    if (!tb_file_info(path, &info) || info.type != TB_FILE_TYPE_FILE || !(file = tb_file_init(path, TB_FILE_MODE_RO)))
+    {
+        conn->code          = TB_HTTP_CODE_NOT_FOUND;
+        conn->headers_size  = 0;
+        return tb_http_server_response_error(conn);
+    }
+
+    // not modified?
+    tb_char_t const* since = tb_http_server_request_header(&conn->request, "If-Modified-Since");
+    if (since && conn->code == TB_HTTP_CODE_OK && info.mtime <= tb_http_date_from_cstr(since, tb_strlen(since))) 
+        conn->code = TB_HTTP_CODE_NOT_MODIFIED;
+
+    // get the requested range: "bytes=$bof-$last" or "bytes=-$suffix", the multiple ranges are not supported and we send the whole file
+    tb_hize_t           bof = 0;
+    tb_hize_t           eof = info.size;
+    tb_char_t           content_range[128];
+    tb_char_t const*    range = tb_http_server_request_header(&conn->request, "Range");
+    content_range[0] = '\0';
+    if (range && conn->code == TB_HTTP_CODE_OK && !tb_strnicmp(range, "bytes=", 6) && !tb_strchr(range, ','))
+    {
+        // parse the range spec
+        tb_bool_t           parsed = tb_false;
+        tb_hize_t           first = 0;
+        tb_hize_t           last = info.size;
+        tb_char_t const*    p = range + 6;
+        if (*p == '-' && tb_isdigit10(p[1])) 
+        {
+            tb_hize_t suffix = tb_stou64(++p);
+            while (tb_isdigit10(*p)) p++;
+            first = suffix < info.size? info.size - suffix : 0;
+            parsed = tb_true;
+        }
+        else if (tb_isdigit10(*p))
+        {
+            first = tb_stou64(p);
+            while (tb_isdigit10(*p)) p++;
+            if (*p == '-')
+            {
+                p++;
+                parsed = tb_true;
+                if (tb_isdigit10(*p))
+                {
+                    tb_hize_t pos = tb_stou64(p);
+                    while (tb_isdigit10(*p)) p++;
+
+                    // the last position cannot be less than the first position
+                    if (pos >= first) last = tb_min(pos + 1, info.size);
+                    else parsed = tb_false;
+                }
+            }
+        }
+        while (tb_isspace(*p)) p++;
+        if (*p) parsed = tb_false;
+
+        // satisfiable? the invalid range will be ignored and we send the whole file with 200
+        if (parsed && first < last)
+        {
+            bof = first;
+            eof = last;
+            conn->code = TB_HTTP_CODE_PARTIAL_CONTENT;
+            tb_snprintf(content_range, sizeof(content_range), "bytes %llu-%llu/%llu", bof, eof - 1, info.size);
+        }
+        else if (parsed)
+        {
+            tb_file_exit(file);
+            tb_snprintf(content_range, sizeof(content_range), "bytes */%llu", info.size);
+            conn->code          = TB_HTTP_CODE_RANGE_NOT_SATISFIABLE;
+            conn->headers_size  = 0;
+            return tb_http_server_response_header(response, "Content-Range", content_range) && tb_http_server_response_error(conn);
+        }
+    }
+
+    // send the response head
+    tb_bool_t ok = tb_false;
+    tb_char_t date[64];
+    if (    tb_http_server_date(info.mtime, date, sizeof(date))
+        &&  tb_http_server_response_header(response, "Last-Modified", date)
+        &&  tb_http_server_response_header(response, "Accept-Ranges", "bytes")
+        &&  (!content_range[0] || tb_http_server_response_header(response, "Content-Range", content_range)))
+    {
+        conn->state = TB_HTTP_SERVER_RESPONSE_STATE_DONE;
+        ok = tb_http_server_response_head(conn, (tb_hong_t)(eof - bof));
+    }
+
+    // send the file with sendfile after the response head
+    if (ok && !conn->head_only && conn->code != TB_HTTP_CODE_NOT_MODIFIED && eof > bof && tb_http_server_conn_flush(conn))
+    {
+        tb_hize_t send = bof;
+        tb_bool_t wait = tb_false;
+        while (send < eof)
+        {
+            tb_hong_t real = tb_socket_sendf(conn->sock, file, send, eof - send);
+            if (real > 0)
+            {
+                send += real;
+                wait = tb_false;
+            }
+            else if (!real && !wait)
+            {
+                if (tb_socket_wait(conn->sock, TB_SOCKET_EVENT_SEND, TB_HTTP_SERVER_TIMEOUT) <= 0) break;
+                wait = tb_true;
+            }
+            else break;
+        }
+
+        // the file may be truncated, we cannot respond the other status now
+        if (send != eof) conn->failed = tb_true;
+    }
+
+    // exit file
+    tb_file_exit(file);
+    return ok && !conn->failed;
+}
+tb_bool_t tb_http_server_response_chunk(tb_http_server_response_ref_t response, tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_http_server_conn_t* conn = (tb_http_server_conn_t*)response;
+    tb_assert_and_check_return_val(conn && (data || !size) && conn->state != TB_HTTP_SERVER_RESPONSE_STATE_DONE, tb_false);
+
+    // send the response head first, the body of HTTP/1.0 will be ended by closing the connection
+    if (conn->state == TB_HTTP_SERVER_RESPONSE_STATE_NONE)
+    {
+        if (!conn->request.version) conn->keep_alive = tb_false;
+        if (!tb_http_server_response_head(conn, -1)) return tb_false;
+        conn->state = TB_HTTP_SERVER_RESPONSE_STATE_CHUNK;
+    }
+
+    // the last chunk?
+    if (!size) conn->state = TB_HTTP_SERVER_RESPONSE_STATE_DONE;
+    tb_check_return_val(!conn->head_only, tb_true);
+
+    // send the chunk data without framing for HTTP/1.0
+    if (!conn->request.version) return !size || tb_http_server_conn_write(conn, data, size);
+
+    // send the chunk size, data and end
+    tb_char_t line[32];
+    tb_long_t real = tb_snprintf(line, sizeof(line), size? "%lx\r\n" : "0\r\n\r\n", size);
+    return real > 0 
+        && tb_http_server_conn_write(conn, (tb_byte_t const*)line, real)
+        && (!size || (tb_http_server_conn_write(conn, data, size) && tb_http_server_conn_write(conn, (tb_byte_t const*)"\r\n", 2)));
+}
+#else
+tb_http_server_ref_t tb_http_server_init(tb_ipaddr_ref_t addr, tb_size_t workers)
+{
+    tb_trace_noimpl();
+    return tb_null;
+}
+tb_void_t tb_http_server_exit(tb_http_server_ref_t server)
+{
+    tb_trace_noimpl();
+}
+tb_bool_t tb_http_server_start(tb_http_server_ref_t server)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+tb_void_t tb_http_server_kill(tb_http_server_ref_t server)
+{
+    tb_trace_noimpl();
+}
+tb_bool_t tb_http_server_addr(tb_http_server_ref_t server, tb_ipaddr_ref_t addr)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+tb_bool_t tb_http_server_route(tb_http_server_ref_t server, tb_size_t method, tb_char_t const* prefix, tb_http_server_func_t func, tb_cpointer_t priv)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+tb_bool_t tb_http_server_route_static(tb_http_server_ref_t server, tb_char_t const* prefix, tb_char_t const* rootdir)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+tb_char_t const* tb_http_server_request_header(tb_http_server_request_t const* request, tb_char_t const* name)
+{
+    tb_trace_noimpl();
+    return tb_null;
+}
+tb_void_t tb_http_server_response_status(tb_http_server_response_ref_t response, tb_size_t code)
+{
+    tb_trace_noimpl();
+}
+tb_bool_t tb_http_server_response_header(tb_http_server_response_ref_t response, tb_char_t const* name, tb_char_t const* value)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+tb_bool_t tb_http_server_response_body(tb_http_server_response_ref_t response, tb_byte_t const* data, tb_size_t size)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+tb_bool_t tb_http_server_response_file(tb_http_server_response_ref_t response, tb_char_t const* path)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+tb_bool_t tb_http_server_response_chunk(tb_http_server_response_ref_t response, tb_byte_t const* data, tb_size_t size)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+#endif
@@ -0,0 +1,294 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        http_server.h
+ * @ingroup     network
+ *
+ */
+#ifndef TB_NETWORK_HTTP_SERVER_H
+#define TB_NETWORK_HTTP_SERVER_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "http.h"
+#include "ipaddr.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/// the maximum header count of the request
+#define TB_HTTP_SERVER_HEADERS_MAXN         (32)
+
+/// the route method for matching all methods
+#define TB_HTTP_SERVER_METHOD_ANY           ((tb_size_t)-1)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the http server header type
+typedef struct __tb_http_server_header_t
+{
+    /// the header name, it is a null-terminated string in the connection buffer
+    tb_char_t const*            name;
+
+    /// the header name size
+    tb_size_t                   name_size;
+
+    /// the header value, it is a null-terminated string in the connection buffer
+    tb_char_t const*            value;
+
+    /// the header value size
+    tb_size_t                   value_size;
+
+}tb_http_server_header_t;
+
+/*! the http server request type
+ *
+ * all strings and the body point to the connection buffer directly, 
+ * so they are only valid in the route function
+ */
+typedef struct __tb_http_server_request_t
+{
+    /// the method, @see tb_http_method_e
+    tb_size_t                   method;
+
+    /// the minor version, 0: HTTP/1.0, 1: HTTP/1.1
+    tb_size_t                   version;
+
+    /// keep alive?
+    tb_bool_t                   keep_alive;
+
+    /// is chunked body?
+    tb_bool_t                   chunked;
+
+    /// the path, not decoded
+    tb_char_t const*            path;
+
+    /// the path size
+    tb_size_t                   path_size;
+
+    /// the query string without '?', it will be empty if no query
+    tb_char_t const*            query;
+
+    /// the query size
+    tb_size_t                   query_size;
+
+    /// the headers
+    tb_http_server_header_t     headers[TB_HTTP_SERVER_HEADERS_MAXN];
+
+    /// the header count
+    tb_size_t                   headers_count;
+
+    /// the body, the chunked body has been decoded
+    tb_byte_t const*            body;
+
+    /// the body size
+    tb_size_t                   body_size;
+
+}tb_http_server_request_t;
+
+/// the http server ref type
+typedef __tb_typeref__(http_server);
+
+/// the http server response ref type
+typedef __tb_typeref__(http_server_response);
+
+/*! the route function type
+ *
+ * it will be called in the connection coroutine of the worker scheduler, 
+ * so the socket io will only suspend the current connection.
+ *
+ * an empty response with the current status will be sent if no body is given after returning,
+ * and the connection will be closed if it returns tb_false.
+ *
+ * @param request       the request
+ * @param response      the response
+ * @param priv          the user private data
+ *
+ * @return              tb_true or tb_false
+ */
+typedef tb_bool_t       (*tb_http_server_func_t)(tb_http_server_request_t const* request, tb_http_server_response_ref_t response, tb_cpointer_t priv);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the http server
+ *
+ * it serves the HTTP/1.1 connections with keep-alive and pipelining on the coroutine listener,
+ * the pipelined responses will be batched and sent together.
+ *
+ * @param addr          the listening address, it will bind a random port if the port is zero
+ * @param workers       the worker count, using the processor count if be zero
+ *
+ * @return              the server
+ */
+tb_http_server_ref_t    tb_http_server_init(tb_ipaddr_ref_t addr, tb_size_t workers);
+
+/*! exit the http server
+ *
+ * it will stop and wait all workers if the server has been started
+ *
+ * @param server        the server
+ */
+tb_void_t               tb_http_server_exit(tb_http_server_ref_t server);
+
+/*! start the http server
+ *
+ * @note all routes need be added before starting it
+ *
+ * @param server        the server
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_http_server_start(tb_http_server_ref_t server);
+
+/*! stop the http server
+ *
+ * it stops accepting the new connections and closes the idle keep-alive connections
+ *
+ * @param server        the server
+ */
+tb_void_t               tb_http_server_kill(tb_http_server_ref_t server);
+
+/*! get the listening address
+ *
+ * @param server        the server
+ * @param addr          the bound address
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_http_server_addr(tb_http_server_ref_t server, tb_ipaddr_ref_t addr);
+
+/*! add a route
+ *
+ * the route with the longest matched path prefix will be used, 
+ * and the GET route will also match the HEAD request.
+ *
+ * @code
+ *
+    static tb_bool_t tb_hello_func(tb_http_server_request_t const* request, tb_http_server_response_ref_t response, tb_cpointer_t priv)
+    {
+        tb_http_server_response_header(response, "Content-Type", "text/plain");
+        return tb_http_server_response_body(response, (tb_byte_t const*)"hello", 5);
+    }
+
+    tb_http_server_route(server, TB_HTTP_METHOD_GET, "/hello", tb_hello_func, tb_null);
+ * @endcode
+ *
+ * @param server        the server
+ * @param method        the method, matching all methods if be TB_HTTP_SERVER_METHOD_ANY
+ * @param prefix        the path prefix, it only matches the whole path segments
+ * @param func          the route function
+ * @param priv          the user private data
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_http_server_route(tb_http_server_ref_t server, tb_size_t method, tb_char_t const* prefix, tb_http_server_func_t func, tb_cpointer_t priv);
+
+/*! add a static files route
+ *
+ * serve the files in the root directory with sendfile, e.g. /static/a/b.html => rootdir/a/b.html
+ *
+ * @param server        the server
+ * @param prefix        the path prefix
+ * @param rootdir       the root directory
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_http_server_route_static(tb_http_server_ref_t server, tb_char_t const* prefix, tb_char_t const* rootdir);
+
+/*! get the request header value
+ *
+ * @param request       the request
+ * @param name          the header name, case-insensitive
+ *
+ * @return              the header value or tb_null
+ */
+tb_char_t const*        tb_http_server_request_header(tb_http_server_request_t const* request, tb_char_t const* name);
+
+/*! set the response status code, it is TB_HTTP_CODE_OK by default
+ *
+ * @param response      the response
+ * @param code          the status code, @see tb_http_code_e
+ */
+tb_void_t               tb_http_server_response_status(tb_http_server_response_ref_t response, tb_size_t code);
+
+/*! add the response header
+ *
+ * @note it need be called before sending the body
+ *
+ * @param response      the response
+ * @param name          the header name
+ * @param value         the header value
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_http_server_response_header(tb_http_server_response_ref_t response, tb_char_t const* name, tb_char_t const* value);
+
+/*! send the whole response body with the content length
+ *
+ * @param response      the response
+ * @param data          the body data
+ * @param size          the body size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_http_server_response_body(tb_http_server_response_ref_t response, tb_byte_t const* data, tb_size_t size);
+
+/*! send the file as the response body with sendfile
+ *
+ * it will respond 404 if the file does not exist, 
+ * 304 if it has not been modified since the If-Modified-Since date of the request,
+ * and 206 or 416 for the single byte range of the Range header
+ *
+ * @param response      the response
+ * @param path          the file path
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_http_server_response_file(tb_http_server_response_ref_t response, tb_char_t const* path);
+
+/*! send the response body chunk with the chunked transfer encoding
+ *
+ * @param response      the response
+ * @param data          the chunk data
+ * @param size          the chunk size, finish the body if be zero
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_http_server_response_chunk(tb_http_server_response_ref_t response, tb_byte_t const* data, tb_size_t size);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
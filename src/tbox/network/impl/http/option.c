@@ -49,6 +49,7 @@ tb_bool_t tb_http_option_init(tb_http_option_t* option)
     option->version    = 1; // HTTP/1.1
     option->bunzip     = 0;
     option->cookies    = tb_null;
+    option->cache      = tb_null;
 
     // init url
     if (!tb_url_init(&option->url)) return tb_false;
@@ -78,6 +79,9 @@ tb_void_t tb_http_option_exit(tb_http_option_t* option)
 
     // clear cookies
     option->cookies = tb_null;
+
+    // clear cache
+    option->cache = tb_null;
 }
 tb_bool_t tb_http_option_ctrl(tb_http_option_t* option, tb_size_t code, tb_va_list_t args)
 {
@@ -416,6 +420,24 @@ tb_bool_t tb_http_option_ctrl(tb_http_option_t* option, tb_size_t code, tb_va_li
             return tb_true;
         }
         break;
+    case TB_HTTP_OPTION_SET_CACHE:
+        {   
+            // set cache
+            option->cache = (tb_http_cache_ref_t)tb_va_arg(args, tb_http_cache_ref_t);
+            return tb_true;
+        }
+        break;
+    case TB_HTTP_OPTION_GET_CACHE:
+        {
+            // pcache
+            tb_http_cache_ref_t* pcache = (tb_http_cache_ref_t*)tb_va_arg(args, tb_http_cache_ref_t*);
+            tb_assert_and_check_return_val(pcache, tb_false);
+
+            // get cache
+            *pcache = option->cache;
+            return tb_true;
+        }
+        break;
     case TB_HTTP_OPTION_SET_POST_URL:
         {
             // url
@@ -74,6 +74,8 @@ tb_void_t tb_http_status_cler(tb_http_status_t* status, tb_bool_t host_changed)
     status->code = 0;
     status->bgzip = 0;
     status->bdeflate = 0;
+    status->bbrotli = 0;
+    status->bzstd = 0;
     status->bchunked = 0;
     status->content_size = -1;
     status->document_size = -1;
@@ -111,6 +113,8 @@ tb_void_t tb_http_status_dump(tb_http_status_t* status)
     tb_trace_i("status: location: %s", tb_string_cstr(&status->location));
     tb_trace_i("status: bgzip: %s", status->bgzip? "true" : "false");
     tb_trace_i("status: bdeflate: %s", status->bdeflate? "true" : "false");
+    tb_trace_i("status: bbrotli: %s", status->bbrotli? "true" : "false");
+    tb_trace_i("status: bzstd: %s", status->bzstd? "true" : "false");
     tb_trace_i("status: balived: %s", status->balived? "true" : "false");
     tb_trace_i("status: bseeked: %s", status->bseeked? "true" : "false");
     tb_trace_i("status: bchunked: %s", status->bchunked? "true" : "false");
@@ -52,6 +52,12 @@ typedef struct __tb_oc_array_t
     // is increase refn?
     tb_bool_t           incr;
 
+    // the lazy item count
+    tb_size_t           lazy_size;
+
+    // the lazy loader, the array is lazy if the load func exists
+    tb_oc_array_loader_t loader;
+
 }tb_oc_array_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -65,12 +71,74 @@ static __tb_inline__ tb_oc_array_t* tb_oc_array_cast(tb_object_ref_t object)
     // cast
     return (tb_oc_array_t*)object;
 }
+static tb_void_t tb_oc_array_lazy_exit(tb_oc_array_t* array)
+{
+    // exit the loader
+    if (array->loader.exit) array->loader.exit(array->loader.priv);
+    tb_memset(&array->loader, 0, sizeof(tb_oc_array_loader_t));
+    array->lazy_size = 0;
+}
+static tb_object_ref_t tb_oc_array_lazy_item(tb_oc_array_t* array, tb_size_t index)
+{
+    // check
+    tb_assert_and_check_return_val(array->vector && index < array->lazy_size, tb_null);
+
+    // reserve the empty slots for all items first
+    if (!tb_vector_size(array->vector)) tb_vector_ninsert_tail(array->vector, tb_null, array->lazy_size);
+    tb_assert_and_check_return_val(tb_vector_size(array->vector) == array->lazy_size, tb_null);
+
+    // load it if not cached
+    tb_object_ref_t item = (tb_object_ref_t)tb_iterator_item(array->vector, index);
+    if (!item)
+    {
+        item = array->loader.load(index, array->loader.priv);
+        if (item)
+        {
+            tb_vector_replace(array->vector, index, item);
+            tb_object_exit(item);
+        }
+    }
+    return item;
+}
+static tb_void_t tb_oc_array_lazy_load(tb_oc_array_t* array)
+{
+    // not lazy?
+    tb_check_return(array->loader.load);
+
+    // load all items
+    tb_size_t i = 0;
+    tb_size_t n = array->lazy_size;
+    tb_size_t failed = 0;
+    for (i = 0; i < n; i++)
+    {
+        if (!tb_oc_array_lazy_item(array, i)) failed++;
+    }
+
+    // remove the empty slots of the broken items
+    if (failed)
+    {
+        // trace
+        tb_trace_e("load %lu broken items!", failed);
+
+        // remove them
+        for (i = tb_vector_size(array->vector); i > 0; i--)
+        {
+            if (!tb_iterator_item(array->vector, i - 1)) tb_vector_remove(array->vector, i - 1);
+        }
+    }
+
+    // it is a normal array now
+    tb_oc_array_lazy_exit(array);
+}
 static tb_object_ref_t tb_oc_array_copy(tb_object_ref_t object)
 {
     // check
     tb_oc_array_t* array = tb_oc_array_cast(object);
     tb_assert_and_check_return_val(array && array->vector, tb_null);
 
+    // load all items
+    tb_oc_array_lazy_load(array);
+
     // init copy
     tb_oc_array_t* copy = (tb_oc_array_t*)tb_oc_array_init(tb_vector_grow(array->vector), array->incr);
     tb_assert_and_check_return_val(copy && copy->vector, tb_null);
@@ -97,6 +165,9 @@ static tb_void_t tb_oc_array_exit(tb_object_ref_t object)
     if (array->vector) tb_vector_exit(array->vector);
     array->vector = tb_null;
 
+    // exit the lazy loader
+    tb_oc_array_lazy_exit(array);
+
     // exit it
     tb_free(array);
 }
@@ -107,6 +178,9 @@ static tb_void_t tb_oc_array_clear(tb_object_ref_t object)
 
     // clear vector
     tb_vector_clear(array->vector);
+
+    // clear the lazy items
+    tb_oc_array_lazy_exit(array);
 }
 static tb_oc_array_t* tb_oc_array_init_base()
 {
@@ -184,6 +258,28 @@ tb_object_ref_t tb_oc_array_init(tb_size_t grow, tb_bool_t incr)
     // ok?
     return (tb_object_ref_t)array;
 }
+tb_object_ref_t tb_oc_array_init_lazy(tb_size_t size, tb_oc_array_loader_t const* loader)
+{
+    // check
+    tb_assert_and_check_return_val(loader && loader->load, tb_null);
+
+    // init array
+    tb_oc_array_t* array = (tb_oc_array_t*)tb_oc_array_init(0, tb_false);
+    if (array)
+    {
+        // init the lazy loader, the empty array need not be loaded
+        if (size)
+        {
+            array->loader       = *loader;
+            array->lazy_size    = size;
+        }
+        else if (loader->exit) loader->exit(loader->priv);
+    }
+    else if (loader->exit) loader->exit(loader->priv);
+
+    // ok?
+    return (tb_object_ref_t)array;
+}
 tb_size_t tb_oc_array_size(tb_object_ref_t object)
 {
     // check
@@ -191,7 +287,7 @@ tb_size_t tb_oc_array_size(tb_object_ref_t object)
     tb_assert_and_check_return_val(array && array->vector, 0);
 
     // size
-    return tb_vector_size(array->vector);
+    return array->loader.load? array->lazy_size : tb_vector_size(array->vector);
 }
 tb_object_ref_t tb_oc_array_item(tb_object_ref_t object, tb_size_t index)
 {
@@ -199,6 +295,9 @@ tb_object_ref_t tb_oc_array_item(tb_object_ref_t object, tb_size_t index)
     tb_oc_array_t* array = tb_oc_array_cast(object);
     tb_assert_and_check_return_val(array && array->vector, tb_null);
 
+    // load the lazy item
+    if (array->loader.load) return tb_oc_array_lazy_item(array, index);
+
     // item
     return (tb_object_ref_t)tb_iterator_item(array->vector, index);
 }
@@ -208,6 +307,9 @@ tb_iterator_ref_t tb_oc_array_itor(tb_object_ref_t object)
     tb_oc_array_t* array = tb_oc_array_cast(object);
     tb_assert_and_check_return_val(array, tb_null);
 
+    // load all items
+    tb_oc_array_lazy_load(array);
+
     // iterator
     return (tb_iterator_ref_t)array->vector;
 }
@@ -217,6 +319,9 @@ tb_void_t tb_oc_array_remove(tb_object_ref_t object, tb_size_t index)
     tb_oc_array_t* array = tb_oc_array_cast(object);
     tb_assert_and_check_return(array && array->vector);
 
+    // load all items
+    tb_oc_array_lazy_load(array);
+
     // remove
     tb_vector_remove(array->vector, index);
 }
@@ -226,6 +331,9 @@ tb_void_t tb_oc_array_append(tb_object_ref_t object, tb_object_ref_t item)
     tb_oc_array_t* array = tb_oc_array_cast(object);
     tb_assert_and_check_return(array && array->vector && item);
 
+    // load all items
+    tb_oc_array_lazy_load(array);
+
     // insert
     tb_vector_insert_tail(array->vector, item);
 
@@ -238,6 +346,9 @@ tb_void_t tb_oc_array_insert(tb_object_ref_t object, tb_size_t index, tb_object_
     tb_oc_array_t* array = tb_oc_array_cast(object);
     tb_assert_and_check_return(array && array->vector && item);
 
+    // load all items
+    tb_oc_array_lazy_load(array);
+
     // insert
     tb_vector_insert_prev(array->vector, index, item);
 
@@ -250,6 +361,9 @@ tb_void_t tb_oc_array_replace(tb_object_ref_t object, tb_size_t index, tb_object
     tb_oc_array_t* array = tb_oc_array_cast(object);
     tb_assert_and_check_return(array && array->vector && item);
 
+    // load all items
+    tb_oc_array_lazy_load(array);
+
     // replace
     tb_vector_replace(array->vector, index, item);
 
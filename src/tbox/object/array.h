@@ -36,6 +36,24 @@
  */
 __tb_extern_c_enter__
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the array loader type for the lazy array
+typedef struct __tb_oc_array_loader_t
+{
+    /// load the item at the given index, return a new object
+    tb_object_ref_t     (*load)(tb_size_t index, tb_cpointer_t priv);
+
+    /// exit the private data, optional
+    tb_void_t           (*exit)(tb_cpointer_t priv);
+
+    /// the private data
+    tb_cpointer_t       priv;
+
+}tb_oc_array_loader_t;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -49,6 +67,18 @@ __tb_extern_c_enter__
  */
 tb_object_ref_t     tb_oc_array_init(tb_size_t grow, tb_bool_t incr);
 
+/*! init the lazy array
+ *
+ * the item will be loaded and cached when it is accessed first,
+ * and all items will be loaded before iterating or modifying it.
+ *
+ * @param size      the item count
+ * @param loader    the item loader
+ *
+ * @return          the array object
+ */
+tb_object_ref_t     tb_oc_array_init_lazy(tb_size_t size, tb_oc_array_loader_t const* loader);
+
 /*! the array size
  *
  * @param array     the array object
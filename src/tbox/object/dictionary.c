@@ -65,6 +65,12 @@ typedef struct __tb_oc_dictionary_t
     // increase refn?
     tb_bool_t           incr;
 
+    // the lazy item count
+    tb_size_t           lazy_size;
+
+    // the lazy loader, the dictionary is lazy if the load func exists
+    tb_oc_dictionary_loader_t loader;
+
 }tb_oc_dictionary_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -78,12 +84,57 @@ static __tb_inline__ tb_oc_dictionary_t* tb_oc_dictionary_cast(tb_object_ref_t o
     // cast
     return (tb_oc_dictionary_t*)object;
 }
+static tb_void_t tb_oc_dictionary_lazy_exit(tb_oc_dictionary_t* dictionary)
+{
+    // exit the loader
+    if (dictionary->loader.exit) dictionary->loader.exit(dictionary->loader.priv);
+    tb_memset(&dictionary->loader, 0, sizeof(tb_oc_dictionary_loader_t));
+    dictionary->lazy_size = 0;
+}
+static tb_void_t tb_oc_dictionary_lazy_load(tb_oc_dictionary_t* dictionary)
+{
+    // not lazy?
+    tb_check_return(dictionary->loader.load && dictionary->hash);
+
+    // load all the values which have been not cached
+    tb_size_t i = 0;
+    tb_size_t n = dictionary->lazy_size;
+    tb_size_t failed = 0;
+    for (i = 0; i < n; i++)
+    {
+        // this value has been cached? skip it
+        if (dictionary->loader.key)
+        {
+            tb_char_t const* key = dictionary->loader.key(i, dictionary->loader.priv);
+            if (key && tb_hash_map_get(dictionary->hash, key)) continue;
+        }
+
+        // load the key and value
+        tb_char_t const*    key = tb_null;
+        tb_object_ref_t     val = dictionary->loader.load(i, &key, dictionary->loader.priv);
+        if (val && key)
+        {
+            if (!tb_hash_map_get(dictionary->hash, key)) tb_hash_map_insert(dictionary->hash, key, val);
+        }
+        else failed++;
+        if (val) tb_object_exit(val);
+    }
+
+    // trace
+    if (failed) tb_trace_e("load %lu broken items!", failed);
+
+    // it is a normal dictionary now
+    tb_oc_dictionary_lazy_exit(dictionary);
+}
 static tb_object_ref_t tb_oc_dictionary_copy(tb_object_ref_t object)
 {
     // check
     tb_oc_dictionary_t* dictionary = tb_oc_dictionary_cast(object);
     tb_assert_and_check_return_val(dictionary, tb_null);
 
+    // load all items
+    tb_oc_dictionary_lazy_load(dictionary);
+
     // init copy
     tb_oc_dictionary_t* copy = (tb_oc_dictionary_t*)tb_oc_dictionary_init(dictionary->size, dictionary->incr);
     tb_assert_and_check_return_val(copy, tb_null);
@@ -114,6 +165,9 @@ static tb_void_t tb_oc_dictionary_exit(tb_object_ref_t object)
     if (dictionary->hash) tb_hash_map_exit(dictionary->hash);
     dictionary->hash = tb_null;
 
+    // exit the lazy loader
+    tb_oc_dictionary_lazy_exit(dictionary);
+
     // exit it
     tb_free(dictionary);
 }
@@ -124,6 +178,9 @@ static tb_void_t tb_oc_dictionary_clear(tb_object_ref_t object)
 
     // clear
     if (dictionary->hash) tb_hash_map_clear(dictionary->hash);
+
+    // clear the lazy items
+    tb_oc_dictionary_lazy_exit(dictionary);
 }
 static tb_oc_dictionary_t* tb_oc_dictionary_init_base()
 {
@@ -202,6 +259,31 @@ tb_object_ref_t tb_oc_dictionary_init(tb_size_t size, tb_bool_t incr)
     // ok?
     return (tb_object_ref_t)dictionary;
 }
+tb_object_ref_t tb_oc_dictionary_init_lazy(tb_size_t size, tb_oc_dictionary_loader_t const* loader)
+{
+    // check
+    tb_assert_and_check_return_val(loader && loader->value && loader->load, tb_null);
+
+    // init dictionary, the hash size depends on the item count
+    tb_size_t hash_size = TB_OC_DICTIONARY_SIZE_LARGE;
+    if (size <= TB_OC_DICTIONARY_SIZE_MICRO) hash_size = TB_OC_DICTIONARY_SIZE_MICRO;
+    else if (size <= TB_OC_DICTIONARY_SIZE_SMALL) hash_size = TB_OC_DICTIONARY_SIZE_SMALL;
+    tb_oc_dictionary_t* dictionary = (tb_oc_dictionary_t*)tb_oc_dictionary_init(hash_size, tb_false);
+    if (dictionary)
+    {
+        // init the lazy loader, the empty dictionary need not be loaded
+        if (size)
+        {
+            dictionary->loader      = *loader;
+            dictionary->lazy_size   = size;
+        }
+        else if (loader->exit) loader->exit(loader->priv);
+    }
+    else if (loader->exit) loader->exit(loader->priv);
+
+    // ok?
+    return (tb_object_ref_t)dictionary;
+}
 tb_size_t tb_oc_dictionary_size(tb_object_ref_t object)
 {
     // check
@@ -209,13 +291,16 @@ tb_size_t tb_oc_dictionary_size(tb_object_ref_t object)
     tb_assert_and_check_return_val(dictionary && dictionary->hash, 0);
 
     // size
-    return tb_hash_map_size(dictionary->hash);
+    return dictionary->loader.load? dictionary->lazy_size : tb_hash_map_size(dictionary->hash);
 }
 tb_iterator_ref_t tb_oc_dictionary_itor(tb_object_ref_t object)
 {
     tb_oc_dictionary_t* dictionary = tb_oc_dictionary_cast(object);
     tb_assert_and_check_return_val(dictionary, tb_null);
 
+    // load all items
+    tb_oc_dictionary_lazy_load(dictionary);
+
     // iterator
     return (tb_iterator_ref_t)dictionary->hash;
 }
@@ -225,8 +310,22 @@ tb_object_ref_t tb_oc_dictionary_value(tb_object_ref_t object, tb_char_t const*
     tb_oc_dictionary_t* dictionary = tb_oc_dictionary_cast(object);
     tb_assert_and_check_return_val(dictionary && dictionary->hash && key, tb_null);
 
-    // value
-    return (tb_object_ref_t)tb_hash_map_get(dictionary->hash, key);
+    // the cached value
+    tb_object_ref_t val = (tb_object_ref_t)tb_hash_map_get(dictionary->hash, key);
+
+    // load and cache the lazy value
+    if (!val && dictionary->loader.load)
+    {
+        val = dictionary->loader.value(key, dictionary->loader.priv);
+        if (val)
+        {
+            tb_hash_map_insert(dictionary->hash, key, val);
+            tb_object_exit(val);
+        }
+    }
+
+    // ok?
+    return val;
 }
 tb_void_t tb_oc_dictionary_remove(tb_object_ref_t object, tb_char_t const* key)
 {
@@ -234,6 +333,9 @@ tb_void_t tb_oc_dictionary_remove(tb_object_ref_t object, tb_char_t const* key)
     tb_oc_dictionary_t* dictionary = tb_oc_dictionary_cast(object);
     tb_assert_and_check_return(dictionary && dictionary->hash && key);
 
+    // load all items
+    tb_oc_dictionary_lazy_load(dictionary);
+
     // del
     return tb_hash_map_remove(dictionary->hash, key);
 }
@@ -243,6 +345,9 @@ tb_void_t tb_oc_dictionary_insert(tb_object_ref_t object, tb_char_t const* key,
     tb_oc_dictionary_t* dictionary = tb_oc_dictionary_cast(object);
     tb_assert_and_check_return(dictionary && dictionary->hash && key && val);
 
+    // load all items
+    tb_oc_dictionary_lazy_load(dictionary);
+
     // add
     tb_hash_map_insert(dictionary->hash, key, val);
 
@@ -58,6 +58,26 @@ typedef struct __tb_oc_dictionary_item_t
 
 }tb_oc_dictionary_item_t;
 
+/// the dictionary loader type for the lazy dictionary
+typedef struct __tb_oc_dictionary_loader_t
+{
+    /// load the value of the given key, return a new object or tb_null if not found
+    tb_object_ref_t     (*value)(tb_char_t const* key, tb_cpointer_t priv);
+
+    /// load the key and value at the given index, return a new object
+    tb_object_ref_t     (*load)(tb_size_t index, tb_char_t const** pkey, tb_cpointer_t priv);
+
+    /// load the key only at the given index, optional, the cached values will not be loaded again if it exists
+    tb_char_t const*    (*key)(tb_size_t index, tb_cpointer_t priv);
+
+    /// exit the private data, optional
+    tb_void_t           (*exit)(tb_cpointer_t priv);
+
+    /// the private data
+    tb_cpointer_t       priv;
+
+}tb_oc_dictionary_loader_t;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -94,6 +114,18 @@ typedef struct __tb_oc_dictionary_item_t
  */
 tb_object_ref_t         tb_oc_dictionary_init(tb_size_t size, tb_bool_t incr);
 
+/*! init the lazy dictionary
+ *
+ * the value will be loaded and cached when it is accessed first,
+ * and all items will be loaded before iterating or modifying it.
+ *
+ * @param size          the item count
+ * @param loader        the item loader
+ *
+ * @return              the dictionary object
+ */
+tb_object_ref_t         tb_oc_dictionary_init_lazy(tb_size_t size, tb_oc_dictionary_loader_t const* loader);
+
 /*! the dictionary size
  *
  * @param dictionary    the dictionary object
@@ -46,11 +46,13 @@ tb_bool_t tb_object_init_env()
     if (!tb_oc_reader_set(TB_OBJECT_FORMAT_BIN, tb_oc_bin_reader())) return tb_false;
     if (!tb_oc_reader_set(TB_OBJECT_FORMAT_JSON, tb_oc_json_reader())) return tb_false;
     if (!tb_oc_reader_set(TB_OBJECT_FORMAT_BPLIST, tb_oc_bplist_reader())) return tb_false;
+    if (!tb_oc_reader_set(TB_OBJECT_FORMAT_MBIN, tb_oc_mbin_reader())) return tb_false;
  
     // register writer
     if (!tb_oc_writer_set(TB_OBJECT_FORMAT_BIN, tb_oc_bin_writer())) return tb_false;
     if (!tb_oc_writer_set(TB_OBJECT_FORMAT_JSON, tb_oc_json_writer())) return tb_false;
     if (!tb_oc_writer_set(TB_OBJECT_FORMAT_BPLIST, tb_oc_bplist_writer())) return tb_false;
+    if (!tb_oc_writer_set(TB_OBJECT_FORMAT_MBIN, tb_oc_mbin_writer())) return tb_false;
 
     // register reader and writer for xml
 #ifdef TB_CONFIG_MODULE_HAVE_XML
@@ -69,11 +71,13 @@ tb_void_t tb_object_exit_env()
     tb_oc_reader_remove(TB_OBJECT_FORMAT_BIN);
     tb_oc_reader_remove(TB_OBJECT_FORMAT_JSON);
     tb_oc_reader_remove(TB_OBJECT_FORMAT_BPLIST);
+    tb_oc_reader_remove(TB_OBJECT_FORMAT_MBIN);
 
     // remove writer
     tb_oc_writer_remove(TB_OBJECT_FORMAT_BIN);
     tb_oc_writer_remove(TB_OBJECT_FORMAT_JSON);
     tb_oc_writer_remove(TB_OBJECT_FORMAT_BPLIST);
+    tb_oc_writer_remove(TB_OBJECT_FORMAT_MBIN);
 
     // remove reader and writer for xml
 #ifdef TB_CONFIG_MODULE_HAVE_XML
@@ -45,6 +45,30 @@
                                     (((tb_uint64_t)(x)) < (1ull << 16) ? 2 : \
                                     (((tb_uint64_t)(x)) < (1ull << 32) ? 4 : 8)))
 
+/* the mbin format, all integers are little-endian and all nodes are aligned by 8 bytes
+ *
+ * head:        "tbmb" u32(version)
+ * nodes:       u32(type) u32(size) payload, the children are written before their parent
+ *              - string:       size = length, payload = cstr with '\0'
+ *              - data:         size = length, payload = data
+ *              - date:         payload = s64(time)
+ *              - number:       size = number type, payload = u64(integer) or double
+ *              - array:        size = count, payload = slot[count]
+ *              - dictionary:   size = count, payload = (u64(key string node), slot)[count] sorted by key
+ * tail:        slot(root) u64(total size)
+ *
+ * the slot is an u64 value, the node offset or the inline scalar: tag: 3 bits, extra: 5 bits, value: 56 bits
+ */
+#define TB_OC_MBIN_MAGIC                    "tbmb"
+#define TB_OC_MBIN_VERSION                  (1)
+#define TB_OC_MBIN_SLOT_NODE                (0)     //!< the node offset
+#define TB_OC_MBIN_SLOT_NULL                (1)     //!< the inline null
+#define TB_OC_MBIN_SLOT_BOOLEAN             (2)     //!< the inline boolean, extra: value
+#define TB_OC_MBIN_SLOT_NUMBER              (3)     //!< the inline integer or float, extra: number type
+#define TB_OC_MBIN_SLOT_TAG(slot)           ((tb_size_t)((slot) & 0x07))
+#define TB_OC_MBIN_SLOT_EXTRA(slot)         ((tb_size_t)(((slot) >> 3) & 0x1f))
+#define TB_OC_MBIN_SLOT_MAKE(tag, extra, value) ((tb_uint64_t)(tag) | ((tb_uint64_t)(extra) << 3) | ((tb_uint64_t)(value) << 8))
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -0,0 +1,420 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ *
+ * @author      ruki
+ * @file        mbin.c
+ * @ingroup     object
+ *
+ */
+ 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME        "oc_reader_mbin"
+#define TB_TRACE_MODULE_DEBUG       (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "mbin.h"
+#include "reader.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the head and tail size
+#define TB_OC_MBIN_READER_HEAD_SIZE         (8)
+#define TB_OC_MBIN_READER_TAIL_SIZE         (16)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the mbin buffer type, it is referenced by all lazy nodes
+typedef struct __tb_oc_mbin_buffer_t
+{
+    // the refn
+    tb_size_t                       refn;
+
+    // the data
+    tb_byte_t const*                data;
+
+    // the data size
+    tb_size_t                       size;
+
+    // the nodes limit, all nodes are before the tail
+    tb_size_t                       limit;
+
+    // the exit func
+    tb_oc_mbin_reader_exit_func_t   func;
+
+    // the exit func private data
+    tb_cpointer_t                   priv;
+
+}tb_oc_mbin_buffer_t;
+
+// the mbin lazy node type for array and dictionary
+typedef struct __tb_oc_mbin_node_t
+{
+    // the buffer
+    tb_oc_mbin_buffer_t*            buffer;
+
+    // the item table
+    tb_byte_t const*                items;
+
+    // the item count
+    tb_size_t                       count;
+
+    // the node offset, all children are before it
+    tb_uint64_t                     offset;
+
+}tb_oc_mbin_node_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * declaration
+ */
+static tb_object_ref_t tb_oc_mbin_reader_load(tb_oc_mbin_buffer_t* buffer, tb_uint64_t slot, tb_uint64_t parent);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_oc_mbin_buffer_exit(tb_oc_mbin_buffer_t* buffer)
+{
+    // refn--
+    tb_assert_and_check_return(buffer && buffer->refn);
+    if (--buffer->refn) return;
+
+    // exit data
+    if (buffer->func) buffer->func(buffer->data, buffer->size, buffer->priv);
+    tb_free(buffer);
+}
+static tb_void_t tb_oc_mbin_buffer_exit_data(tb_byte_t const* data, tb_size_t size, tb_cpointer_t priv)
+{
+    if (data) tb_free((tb_pointer_t)data);
+}
+static tb_byte_t const* tb_oc_mbin_reader_node(tb_oc_mbin_buffer_t* buffer, tb_uint64_t offset, tb_size_t* ptype, tb_size_t* psize, tb_size_t* pleft)
+{
+    // check
+    tb_assert_and_check_return_val(!(offset & 7) && offset >= TB_OC_MBIN_READER_HEAD_SIZE && offset <= buffer->limit - 8, tb_null);
+
+    // get type, size and the left payload size
+    tb_byte_t const* p = buffer->data + (tb_size_t)offset;
+    *ptype = tb_bits_get_u32_le(p);
+    *psize = tb_bits_get_u32_le(p + 4);
+    *pleft = buffer->limit - (tb_size_t)offset - 8;
+    return p + 8;
+}
+static tb_char_t const* tb_oc_mbin_reader_cstr(tb_oc_mbin_buffer_t* buffer, tb_uint64_t offset)
+{
+    // get string node
+    tb_size_t type = 0;
+    tb_size_t size = 0;
+    tb_size_t left = 0;
+    tb_byte_t const* p = tb_oc_mbin_reader_node(buffer, offset, &type, &size, &left);
+    tb_assert_and_check_return_val(p && type == TB_OBJECT_TYPE_STRING && size < left && !p[size], tb_null);
+
+    // the cstr is referenced from the buffer directly
+    return (tb_char_t const*)p;
+}
+static tb_object_ref_t tb_oc_mbin_reader_number(tb_size_t type, tb_uint64_t value)
+{
+    switch (type)
+    {
+    case TB_OC_NUMBER_TYPE_UINT64:
+        return tb_oc_number_init_from_uint64(value);
+    case TB_OC_NUMBER_TYPE_SINT64:
+        return tb_oc_number_init_from_sint64((tb_sint64_t)value);
+    case TB_OC_NUMBER_TYPE_UINT32:
+        return tb_oc_number_init_from_uint32((tb_uint32_t)value);
+    case TB_OC_NUMBER_TYPE_SINT32:
+        return tb_oc_number_init_from_sint32((tb_sint32_t)value);
+    case TB_OC_NUMBER_TYPE_UINT16:
+        return tb_oc_number_init_from_uint16((tb_uint16_t)value);
+    case TB_OC_NUMBER_TYPE_SINT16:
+        return tb_oc_number_init_from_sint16((tb_sint16_t)value);
+    case TB_OC_NUMBER_TYPE_UINT8:
+        return tb_oc_number_init_from_uint8((tb_uint8_t)value);
+    case TB_OC_NUMBER_TYPE_SINT8:
+        return tb_oc_number_init_from_sint8((tb_sint8_t)value);
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+    case TB_OC_NUMBER_TYPE_FLOAT:
+        {
+            tb_byte_t data[4];
+            tb_bits_set_u32_le(data, (tb_uint32_t)value);
+            return tb_oc_number_init_from_float(tb_bits_get_float_le(data));
+        }
+    case TB_OC_NUMBER_TYPE_DOUBLE:
+        {
+            tb_byte_t data[8];
+            tb_bits_set_u64_le(data, value);
+            return tb_oc_number_init_from_double(tb_bits_get_double_lle(data));
+        }
+#endif
+    default:
+        break;
+    }
+
+    // trace
+    tb_trace_e("invalid number type: %lu", type);
+    return tb_null;
+}
+static tb_void_t tb_oc_mbin_reader_node_exit(tb_cpointer_t priv)
+{
+    // exit node
+    tb_oc_mbin_node_t* node = (tb_oc_mbin_node_t*)priv;
+    if (node)
+    {
+        tb_oc_mbin_buffer_exit(node->buffer);
+        tb_free(node);
+    }
+}
+static tb_object_ref_t tb_oc_mbin_reader_array_load(tb_size_t index, tb_cpointer_t priv)
+{
+    // check
+    tb_oc_mbin_node_t* node = (tb_oc_mbin_node_t*)priv;
+    tb_assert_and_check_return_val(node && index < node->count, tb_null);
+
+    // load the item slot
+    return tb_oc_mbin_reader_load(node->buffer, tb_bits_get_u64_le(node->items + (index << 3)), node->offset);
+}
+static tb_object_ref_t tb_oc_mbin_reader_dictionary_value(tb_char_t const* key, tb_cpointer_t priv)
+{
+    // check
+    tb_oc_mbin_node_t* node = (tb_oc_mbin_node_t*)priv;
+    tb_assert_and_check_return_val(node && key, tb_null);
+
+    // find the sorted key
+    tb_size_t l = 0;
+    tb_size_t r = node->count;
+    while (l < r)
+    {
+        // the middle key
+        tb_size_t           m = (l + r) >> 1;
+        tb_byte_t const*    p = node->items + (m << 4);
+        tb_char_t const*    k = tb_oc_mbin_reader_cstr(node->buffer, tb_bits_get_u64_le(p));
+        tb_assert_and_check_break(k);
+
+        // compare it
+        tb_long_t c = tb_strcmp(key, k);
+        if (!c) return tb_oc_mbin_reader_load(node->buffer, tb_bits_get_u64_le(p + 8), node->offset);
+        else if (c > 0) l = m + 1;
+        else r = m;
+    }
+
+    // not found
+    return tb_null;
+}
+static tb_object_ref_t tb_oc_mbin_reader_dictionary_load(tb_size_t index, tb_char_t const** pkey, tb_cpointer_t priv)
+{
+    // check
+    tb_oc_mbin_node_t* node = (tb_oc_mbin_node_t*)priv;
+    tb_assert_and_check_return_val(node && index < node->count && pkey, tb_null);
+
+    // load the key and value
+    tb_byte_t const* p = node->items + (index << 4);
+    *pkey = tb_oc_mbin_reader_cstr(node->buffer, tb_bits_get_u64_le(p));
+    return *pkey? tb_oc_mbin_reader_load(node->buffer, tb_bits_get_u64_le(p + 8), node->offset) : tb_null;
+}
+static tb_char_t const* tb_oc_mbin_reader_dictionary_key(tb_size_t index, tb_cpointer_t priv)
+{
+    // check
+    tb_oc_mbin_node_t* node = (tb_oc_mbin_node_t*)priv;
+    tb_assert_and_check_return_val(node && index < node->count, tb_null);
+
+    // load the key only
+    return tb_oc_mbin_reader_cstr(node->buffer, tb_bits_get_u64_le(node->items + (index << 4)));
+}
+static tb_object_ref_t tb_oc_mbin_reader_lazy(tb_oc_mbin_buffer_t* buffer, tb_uint64_t offset, tb_size_t type, tb_byte_t const* items, tb_size_t count)
+{
+    // init node
+    tb_oc_mbin_node_t* node = tb_malloc0_type(tb_oc_mbin_node_t);
+    tb_assert_and_check_return_val(node, tb_null);
+
+    // the node references the buffer
+    node->buffer    = buffer;
+    node->items     = items;
+    node->count     = count;
+    node->offset    = offset;
+    buffer->refn++;
+
+    // init the lazy array or dictionary, the node will be exited by them
+    if (type == TB_OBJECT_TYPE_ARRAY)
+    {
+        tb_oc_array_loader_t loader = {0};
+        loader.load     = tb_oc_mbin_reader_array_load;
+        loader.exit     = tb_oc_mbin_reader_node_exit;
+        loader.priv     = node;
+        return tb_oc_array_init_lazy(count, &loader);
+    }
+    else
+    {
+        tb_oc_dictionary_loader_t loader = {0};
+        loader.value    = tb_oc_mbin_reader_dictionary_value;
+        loader.key      = tb_oc_mbin_reader_dictionary_key;
+        loader.load     = tb_oc_mbin_reader_dictionary_load;
+        loader.exit     = tb_oc_mbin_reader_node_exit;
+        loader.priv     = node;
+        return tb_oc_dictionary_init_lazy(count, &loader);
+    }
+}
+static tb_object_ref_t tb_oc_mbin_reader_load(tb_oc_mbin_buffer_t* buffer, tb_uint64_t slot, tb_uint64_t parent)
+{
+    // the inline scalars
+    switch (TB_OC_MBIN_SLOT_TAG(slot))
+    {
+    case TB_OC_MBIN_SLOT_NODE:
+        break;
+    case TB_OC_MBIN_SLOT_NULL:
+        return tb_oc_null_init();
+    case TB_OC_MBIN_SLOT_BOOLEAN:
+        return tb_oc_boolean_init(TB_OC_MBIN_SLOT_EXTRA(slot)? tb_true : tb_false);
+    case TB_OC_MBIN_SLOT_NUMBER:
+        return tb_oc_mbin_reader_number(TB_OC_MBIN_SLOT_EXTRA(slot), (tb_uint64_t)((tb_sint64_t)slot >> 8));
+    default:
+        tb_trace_e("invalid slot: %llx", slot);
+        return tb_null;
+    }
+
+    /* the children are always written before their parents,
+     * so a node pointing to itself or a later node is corrupt and may recurse without bound
+     */
+    tb_assert_and_check_return_val(slot < parent, tb_null);
+
+    // get node
+    tb_size_t type = 0;
+    tb_size_t size = 0;
+    tb_size_t left = 0;
+    tb_byte_t const* p = tb_oc_mbin_reader_node(buffer, slot, &type, &size, &left);
+    tb_check_return_val(p, tb_null);
+
+    // load node
+    switch (type)
+    {
+    case TB_OBJECT_TYPE_STRING:
+        {
+            tb_char_t const* cstr = tb_oc_mbin_reader_cstr(buffer, slot);
+            return cstr? tb_oc_string_init_from_cstr(cstr) : tb_null;
+        }
+    case TB_OBJECT_TYPE_DATA:
+        tb_assert_and_check_break(size <= left);
+        return tb_oc_data_init_from_data((tb_pointer_t)p, size);
+    case TB_OBJECT_TYPE_DATE:
+        tb_assert_and_check_break(left >= 8);
+        return tb_oc_date_init_from_time((tb_time_t)(tb_sint64_t)tb_bits_get_u64_le(p));
+    case TB_OBJECT_TYPE_NUMBER:
+        tb_assert_and_check_break(left >= 8);
+        return tb_oc_mbin_reader_number(size, tb_bits_get_u64_le(p));
+    case TB_OBJECT_TYPE_ARRAY:
+        tb_assert_and_check_break(size <= (left >> 3));
+        return tb_oc_mbin_reader_lazy(buffer, slot, type, p, size);
+    case TB_OBJECT_TYPE_DICTIONARY:
+        tb_assert_and_check_break(size <= (left >> 4));
+        return tb_oc_mbin_reader_lazy(buffer, slot, type, p, size);
+    default:
+        tb_trace_e("invalid node type: %lu", type);
+        break;
+    }
+
+    // failed
+    return tb_null;
+}
+static tb_object_ref_t tb_oc_mbin_reader_done(tb_stream_ref_t stream)
+{
+    // read all data, it will be referenced by the lazy nodes
+    tb_size_t   size = 0;
+    tb_byte_t*  data = tb_stream_bread_all(stream, tb_false, &size);
+    tb_check_return_val(data, tb_null);
+
+    // read it
+    return tb_oc_mbin_reader_done_data(data, size, tb_oc_mbin_buffer_exit_data, tb_null);
+}
+static tb_size_t tb_oc_mbin_reader_probe(tb_stream_ref_t stream)
+{
+    // check
+    tb_assert_and_check_return_val(stream, 0);
+
+    // need it
+    tb_byte_t* p = tb_null;
+    if (!tb_stream_need(stream, &p, 4)) return 0;
+    tb_assert_and_check_return_val(p, 0);
+
+    // ok?
+    return !tb_strncmp((tb_char_t const*)p, TB_OC_MBIN_MAGIC, 4)? 80 : 0;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_oc_reader_t* tb_oc_mbin_reader()
+{
+    // the reader
+    static tb_oc_reader_t s_reader = {0};
+
+    // init reader
+    s_reader.read   = tb_oc_mbin_reader_done;
+    s_reader.probe  = tb_oc_mbin_reader_probe;
+
+    // ok
+    return &s_reader;
+}
+tb_bool_t tb_oc_mbin_reader_probe_data(tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(data, tb_false);
+
+    // check the head, version and total size
+    return size >= TB_OC_MBIN_READER_HEAD_SIZE + TB_OC_MBIN_READER_TAIL_SIZE
+        && !tb_strncmp((tb_char_t const*)data, TB_OC_MBIN_MAGIC, 4)
+        && tb_bits_get_u32_le(data + 4) == TB_OC_MBIN_VERSION
+        && tb_bits_get_u64_le(data + size - 8) == (tb_uint64_t)size;
+}
+tb_object_ref_t tb_oc_mbin_reader_done_data(tb_byte_t const* data, tb_size_t size, tb_oc_mbin_reader_exit_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(data, tb_null);
+
+    // init buffer
+    tb_oc_mbin_buffer_t* buffer = tb_malloc0_type(tb_oc_mbin_buffer_t);
+    if (!buffer)
+    {
+        if (func) func(data, size, priv);
+        return tb_null;
+    }
+    buffer->refn    = 1;
+    buffer->data    = data;
+    buffer->size    = size;
+    buffer->func    = func;
+    buffer->priv    = priv;
+
+    // load the root object
+    tb_object_ref_t object = tb_null;
+    if (tb_oc_mbin_reader_probe_data(data, size))
+    {
+        buffer->limit = size - TB_OC_MBIN_READER_TAIL_SIZE;
+        object = tb_oc_mbin_reader_load(buffer, tb_bits_get_u64_le(data + buffer->limit), buffer->limit);
+    }
+    else tb_trace_e("invalid mbin data!");
+
+    // exit buffer, it is still referenced by the lazy root object
+    tb_oc_mbin_buffer_exit(buffer);
+    return object;
+}
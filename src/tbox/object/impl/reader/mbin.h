@@ -0,0 +1,86 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ *
+ * @author      ruki
+ * @file        mbin.h
+ * @ingroup     object
+ *
+ */
+#ifndef TB_OBJECT_IMPL_READER_MBIN_H
+#define TB_OBJECT_IMPL_READER_MBIN_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the mbin data exit func type
+typedef tb_void_t               (*tb_oc_mbin_reader_exit_func_t)(tb_byte_t const* data, tb_size_t size, tb_cpointer_t priv);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! the mbin reader
+ *
+ * @return                      the mbin object reader
+ */
+tb_oc_reader_t*                 tb_oc_mbin_reader(tb_noarg_t);
+
+/*! probe the mbin data
+ *
+ * @param data                  the data
+ * @param size                  the size
+ *
+ * @return                      tb_true or tb_false
+ */
+tb_bool_t                       tb_oc_mbin_reader_probe_data(tb_byte_t const* data, tb_size_t size);
+
+/*! read the mbin object from the given data without copying it
+ *
+ * the arrays and dictionaries are lazy and reference the data directly, only the accessed items will be decoded.
+ * the exit func will be called after the data is no longer referenced, even if it is failed.
+ *
+ * @param data                  the data, e.g. the mapped file data
+ * @param size                  the size
+ * @param func                  the data exit func, optional
+ * @param priv                  the private data of the exit func
+ *
+ * @return                      the object
+ */
+tb_object_ref_t                 tb_oc_mbin_reader_done_data(tb_byte_t const* data, tb_size_t size, tb_oc_mbin_reader_exit_func_t func, tb_cpointer_t priv);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
+
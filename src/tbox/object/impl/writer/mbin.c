@@ -0,0 +1,382 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ *
+ * @author      ruki
+ * @file        mbin.c
+ * @ingroup     object
+ *
+ */
+ 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME        "oc_writer_mbin"
+#define TB_TRACE_MODULE_DEBUG       (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "mbin.h"
+#include "writer.h"
+#include "../../../algorithm/algorithm.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the maximum inline integer
+#define TB_OC_MBIN_WRITER_INLINE_MAXN       ((tb_sint64_t)1 << 55)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * declaration
+ */
+static tb_bool_t tb_oc_mbin_writer_slot(tb_oc_mbin_writer_t* writer, tb_object_ref_t object, tb_uint64_t* pslot);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static __tb_inline__ tb_uint64_t tb_oc_mbin_writer_offset(tb_oc_mbin_writer_t* writer)
+{
+    return (tb_uint64_t)(tb_stream_offset(writer->stream) - writer->bof);
+}
+static tb_bool_t tb_oc_mbin_writer_pad(tb_oc_mbin_writer_t* writer)
+{
+    // align the next node by 8 bytes
+    static tb_byte_t const s_zero[8] = {0};
+    tb_size_t size = (tb_size_t)(tb_oc_mbin_writer_offset(writer) & 7);
+    return size? tb_stream_bwrit(writer->stream, s_zero, 8 - size) : tb_true;
+}
+static tb_bool_t tb_oc_mbin_writer_head(tb_oc_mbin_writer_t* writer, tb_size_t type, tb_uint64_t size, tb_uint64_t* poffset)
+{
+    // check
+    tb_assert_and_check_return_val(size <= TB_MAXU32, tb_false);
+
+    // the node offset, it has been aligned after the previous node
+    *poffset = tb_oc_mbin_writer_offset(writer);
+    tb_assert(!(*poffset & 7));
+
+    // writ type & size
+    return tb_stream_bwrit_u32_le(writer->stream, (tb_uint32_t)type) && tb_stream_bwrit_u32_le(writer->stream, (tb_uint32_t)size);
+}
+static tb_bool_t tb_oc_mbin_writer_cstr(tb_oc_mbin_writer_t* writer, tb_char_t const* cstr, tb_uint64_t* poffset)
+{
+    // the same string has been written?
+    tb_size_t offset = (tb_size_t)tb_hash_map_get(writer->shash, cstr);
+    if (offset)
+    {
+        *poffset = offset;
+        return tb_true;
+    }
+
+    // writ string with '\0'
+    tb_size_t size = tb_strlen(cstr);
+    if (!tb_oc_mbin_writer_head(writer, TB_OBJECT_TYPE_STRING, size, poffset)) return tb_false;
+    if (!tb_stream_bwrit(writer->stream, (tb_byte_t const*)cstr, size + 1)) return tb_false;
+
+    // save it
+    tb_hash_map_insert(writer->shash, cstr, (tb_cpointer_t)(tb_size_t)*poffset);
+    return tb_oc_mbin_writer_pad(writer);
+}
+static tb_bool_t tb_oc_mbin_writer_number(tb_oc_mbin_writer_t* writer, tb_object_ref_t object, tb_uint64_t* pslot)
+{
+    // the integer value
+    tb_bool_t   integer = tb_true;
+    tb_sint64_t value = 0;
+    tb_size_t   type = tb_oc_number_type(object);
+    switch (type)
+    {
+    case TB_OC_NUMBER_TYPE_UINT64:
+        {
+            // too large? writ the node
+            tb_uint64_t u64 = tb_oc_number_uint64(object);
+            value = u64 < (tb_uint64_t)TB_OC_MBIN_WRITER_INLINE_MAXN? (tb_sint64_t)u64 : TB_OC_MBIN_WRITER_INLINE_MAXN;
+        }
+        break;
+    case TB_OC_NUMBER_TYPE_SINT64:
+    case TB_OC_NUMBER_TYPE_UINT32:
+    case TB_OC_NUMBER_TYPE_SINT32:
+    case TB_OC_NUMBER_TYPE_UINT16:
+    case TB_OC_NUMBER_TYPE_SINT16:
+    case TB_OC_NUMBER_TYPE_UINT8:
+    case TB_OC_NUMBER_TYPE_SINT8:
+        value = tb_oc_number_sint64(object);
+        break;
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+    case TB_OC_NUMBER_TYPE_FLOAT:
+        {
+            // inline the float bits
+            tb_byte_t data[4];
+            tb_bits_set_float_le(data, tb_oc_number_float(object));
+            *pslot = TB_OC_MBIN_SLOT_MAKE(TB_OC_MBIN_SLOT_NUMBER, type, tb_bits_get_u32_le(data));
+            return tb_true;
+        }
+    case TB_OC_NUMBER_TYPE_DOUBLE:
+        integer = tb_false;
+        break;
+#endif
+    default:
+        tb_assert_and_check_return_val(0, tb_false);
+        break;
+    }
+
+    // inline the small integer
+    if (integer && value >= -TB_OC_MBIN_WRITER_INLINE_MAXN && value < TB_OC_MBIN_WRITER_INLINE_MAXN)
+    {
+        *pslot = TB_OC_MBIN_SLOT_MAKE(TB_OC_MBIN_SLOT_NUMBER, type, (tb_uint64_t)value & ((1ull << 56) - 1));
+        return tb_true;
+    }
+
+    // writ the number node
+    if (!tb_oc_mbin_writer_head(writer, TB_OBJECT_TYPE_NUMBER, type, pslot)) return tb_false;
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+    if (!integer)
+    {
+        tb_byte_t data[8];
+        tb_bits_set_double_lle(data, tb_oc_number_double(object));
+        return tb_stream_bwrit(writer->stream, data, 8);
+    }
+#endif
+    return tb_stream_bwrit_u64_le(writer->stream, type == TB_OC_NUMBER_TYPE_UINT64? tb_oc_number_uint64(object) : (tb_uint64_t)tb_oc_number_sint64(object));
+}
+static tb_bool_t tb_oc_mbin_writer_array(tb_oc_mbin_writer_t* writer, tb_object_ref_t object, tb_uint64_t* poffset)
+{
+    // the count
+    tb_size_t count = tb_oc_array_size(object);
+
+    // writ items first
+    tb_bool_t   ok = tb_false;
+    tb_byte_t*  slots = count? tb_malloc_bytes(count << 3) : tb_null;
+    do
+    {
+        // check
+        tb_assert_and_check_break(!count || slots);
+
+        // writ items
+        tb_size_t i = 0;
+        tb_for_all (tb_object_ref_t, item, tb_oc_array_itor(object))
+        {
+            // check
+            tb_uint64_t slot = 0;
+            tb_assert_and_check_break(i < count);
+
+            // writ it
+            if (!item || !tb_oc_mbin_writer_slot(writer, item, &slot)) break;
+            tb_bits_set_u64_le(slots + (i << 3), slot);
+            i++;
+        }
+        tb_assert_and_check_break(i == count);
+
+        // writ the offset table
+        if (!tb_oc_mbin_writer_head(writer, TB_OBJECT_TYPE_ARRAY, count, poffset)) break;
+        if (count && !tb_stream_bwrit(writer->stream, slots, count << 3)) break;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // exit slots
+    if (slots) tb_free(slots);
+    return ok;
+}
+static tb_long_t tb_oc_mbin_writer_comp(tb_iterator_ref_t iterator, tb_cpointer_t litem, tb_cpointer_t ritem)
+{
+    return tb_strcmp((tb_char_t const*)litem, (tb_char_t const*)ritem);
+}
+static tb_bool_t tb_oc_mbin_writer_dictionary(tb_oc_mbin_writer_t* writer, tb_object_ref_t object, tb_uint64_t* poffset)
+{
+    // done
+    tb_bool_t       ok = tb_false;
+    tb_byte_t*      items = tb_null;
+    tb_vector_ref_t keys = tb_null;
+    do
+    {
+        // sort keys for the binary searching
+        tb_size_t count = tb_oc_dictionary_size(object);
+        keys = tb_vector_init(count, tb_element_ptr(tb_null, tb_null));
+        tb_assert_and_check_break(keys);
+        tb_for_all (tb_oc_dictionary_item_t*, item, tb_oc_dictionary_itor(object))
+        {
+            if (item && item->key && item->val) tb_vector_insert_tail(keys, item->key);
+        }
+        tb_sort_all(keys, tb_oc_mbin_writer_comp);
+
+        // writ keys and values first
+        count = tb_vector_size(keys);
+        items = count? tb_malloc_bytes(count << 4) : tb_null;
+        tb_assert_and_check_break(!count || items);
+
+        tb_size_t i = 0;
+        tb_for_all_if (tb_char_t const*, key, keys, key)
+        {
+            tb_uint64_t offset = 0;
+            tb_uint64_t slot = 0;
+            if (!tb_oc_mbin_writer_cstr(writer, key, &offset)) break;
+            if (!tb_oc_mbin_writer_slot(writer, tb_oc_dictionary_value(object, key), &slot)) break;
+            tb_bits_set_u64_le(items + (i << 4), offset);
+            tb_bits_set_u64_le(items + (i << 4) + 8, slot);
+            i++;
+        }
+        tb_assert_and_check_break(i == count);
+
+        // writ the sorted item table
+        if (!tb_oc_mbin_writer_head(writer, TB_OBJECT_TYPE_DICTIONARY, count, poffset)) break;
+        if (count && !tb_stream_bwrit(writer->stream, items, count << 4)) break;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // exit keys and items
+    if (keys) tb_vector_exit(keys);
+    if (items) tb_free(items);
+    return ok;
+}
+static tb_bool_t tb_oc_mbin_writer_node(tb_oc_mbin_writer_t* writer, tb_object_ref_t object, tb_uint64_t* poffset)
+{
+    // writ node
+    switch (object->type)
+    {
+    case TB_OBJECT_TYPE_STRING:
+        return tb_oc_mbin_writer_cstr(writer, tb_oc_string_cstr(object)? tb_oc_string_cstr(object) : "", poffset);
+    case TB_OBJECT_TYPE_DATA:
+        {
+            tb_size_t size = tb_oc_data_size(object);
+            if (!tb_oc_mbin_writer_head(writer, object->type, size, poffset)) return tb_false;
+            if (size && !tb_stream_bwrit(writer->stream, (tb_byte_t const*)tb_oc_data_getp(object), size)) return tb_false;
+            return tb_oc_mbin_writer_pad(writer);
+        }
+    case TB_OBJECT_TYPE_DATE:
+        if (!tb_oc_mbin_writer_head(writer, object->type, 0, poffset)) return tb_false;
+        return tb_stream_bwrit_s64_le(writer->stream, (tb_sint64_t)tb_oc_date_time(object));
+    case TB_OBJECT_TYPE_ARRAY:
+        return tb_oc_mbin_writer_array(writer, object, poffset);
+    case TB_OBJECT_TYPE_DICTIONARY:
+        return tb_oc_mbin_writer_dictionary(writer, object, poffset);
+    default:
+        break;
+    }
+
+    // trace
+    tb_trace_e("unsupported object type: %lu", (tb_size_t)object->type);
+    return tb_false;
+}
+static tb_bool_t tb_oc_mbin_writer_slot(tb_oc_mbin_writer_t* writer, tb_object_ref_t object, tb_uint64_t* pslot)
+{
+    // check
+    tb_assert_and_check_return_val(writer && writer->stream && object && pslot, tb_false);
+
+    // inline scalars
+    switch (object->type)
+    {
+    case TB_OBJECT_TYPE_NULL:
+        *pslot = TB_OC_MBIN_SLOT_MAKE(TB_OC_MBIN_SLOT_NULL, 0, 0);
+        return tb_true;
+    case TB_OBJECT_TYPE_BOOLEAN:
+        *pslot = TB_OC_MBIN_SLOT_MAKE(TB_OC_MBIN_SLOT_BOOLEAN, tb_oc_boolean_bool(object)? 1 : 0, 0);
+        return tb_true;
+    case TB_OBJECT_TYPE_NUMBER:
+        return tb_oc_mbin_writer_number(writer, object, pslot);
+    default:
+        break;
+    }
+
+    // the same object has been written?
+    tb_size_t offset = (tb_size_t)tb_hash_map_get(writer->ohash, object);
+    if (offset)
+    {
+        *pslot = offset;
+        return tb_true;
+    }
+
+    // writ node
+    if (!tb_oc_mbin_writer_node(writer, object, pslot)) return tb_false;
+
+    // save it
+    tb_hash_map_insert(writer->ohash, object, (tb_cpointer_t)(tb_size_t)*pslot);
+    return tb_true;
+}
+static tb_long_t tb_oc_mbin_writer_done(tb_stream_ref_t stream, tb_object_ref_t object, tb_bool_t deflate)
+{
+    // check
+    tb_assert_and_check_return_val(object && stream, -1);
+
+    // the begin offset
+    tb_hize_t bof = tb_stream_offset(stream);
+
+    // writ mbin header
+    if (!tb_stream_bwrit(stream, (tb_byte_t const*)TB_OC_MBIN_MAGIC, 4)) return -1;
+    if (!tb_stream_bwrit_u32_le(stream, TB_OC_MBIN_VERSION)) return -1;
+
+    // done
+    tb_bool_t           ok = tb_false;
+    tb_oc_mbin_writer_t writer = {0};
+    do
+    {
+        // init writer
+        writer.stream   = stream;
+        writer.bof      = bof;
+        writer.ohash    = tb_hash_map_init(TB_HASH_MAP_BUCKET_SIZE_SMALL, tb_element_ptr(tb_null, tb_null), tb_element_size());
+        writer.shash    = tb_hash_map_init(TB_HASH_MAP_BUCKET_SIZE_SMALL, tb_element_str(tb_true), tb_element_size());
+        tb_assert_and_check_break(writer.ohash && writer.shash);
+
+        // writ nodes
+        tb_uint64_t root = 0;
+        if (!tb_oc_mbin_writer_slot(&writer, object, &root)) break;
+
+        // writ tail
+        if (!tb_stream_bwrit_u64_le(stream, root)) break;
+        if (!tb_stream_bwrit_u64_le(stream, tb_oc_mbin_writer_offset(&writer) + 8)) break;
+
+        // sync
+        if (!tb_stream_sync(stream, tb_true)) break;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // exit the hash
+    if (writer.ohash) tb_hash_map_exit(writer.ohash);
+    if (writer.shash) tb_hash_map_exit(writer.shash);
+
+    // the end offset
+    tb_hize_t eof = tb_stream_offset(stream);
+
+    // ok?
+    return ok && eof >= bof? (tb_long_t)(eof - bof) : -1;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_oc_writer_t* tb_oc_mbin_writer()
+{
+    // the writer
+    static tb_oc_writer_t s_writer = {0};
+  
+    // init writer, the deflate flag is ignored because the nodes need be accessed directly
+    s_writer.writ = tb_oc_mbin_writer_done;
+
+    // ok
+    return &s_writer;
+}
@@ -0,0 +1,77 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ *
+ * @author      ruki
+ * @file        mbin.h
+ * @ingroup     object
+ *
+ */
+#ifndef TB_OBJECT_IMPL_WRITER_MBIN_H
+#define TB_OBJECT_IMPL_WRITER_MBIN_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the object mbin writer type
+typedef struct __tb_oc_mbin_writer_t
+{
+    /// the stream
+    tb_stream_ref_t             stream;
+
+    /// the begin offset of the stream
+    tb_hize_t                   bof;
+
+    /// the object hash, object => node offset
+    tb_hash_map_ref_t           ohash;
+
+    /// the string hash, cstr => node offset
+    tb_hash_map_ref_t           shash;
+
+}tb_oc_mbin_writer_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! the mbin object writer
+ *
+ * @return                      the mbin object writer
+ */
+tb_oc_writer_t*                 tb_oc_mbin_writer(tb_noarg_t);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
+
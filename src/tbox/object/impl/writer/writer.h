@@ -34,6 +34,7 @@
 #include "json.h"
 #include "xplist.h"
 #include "bplist.h"
+#include "mbin.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
@@ -36,6 +36,14 @@
 #include "object.h"
 #include "impl/impl.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_object_read_from_map_exit(tb_byte_t const* data, tb_size_t size, tb_cpointer_t priv)
+{
+    if (data) tb_file_unmap((tb_pointer_t)data, size);
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -345,6 +353,32 @@ tb_object_ref_t tb_object_read_from_data(tb_byte_t const* data, tb_size_t size)
     // ok?
     return object;
 }
+tb_object_ref_t tb_object_read_from_map(tb_char_t const* path)
+{
+    // check
+    tb_assert_and_check_return_val(path, tb_null);
+
+    // init file
+    tb_file_ref_t file = tb_file_init(path, TB_FILE_MODE_RO);
+    tb_check_return_val(file, tb_null);
+
+    // map it, the mapped data is still valid after exiting file
+    tb_hize_t       size = tb_file_size(file);
+    tb_byte_t*      data = (size && size <= TB_MAXS32)? (tb_byte_t*)tb_file_map(file, (tb_size_t)size) : tb_null;
+    tb_file_exit(file);
+
+    // map failed? read it from the file stream
+    if (!data) return tb_object_read_from_url(path);
+
+    // the mbin object will unmap it after all lazy objects are exited
+    if (tb_oc_mbin_reader_probe_data(data, (tb_size_t)size))
+        return tb_oc_mbin_reader_done_data(data, (tb_size_t)size, tb_object_read_from_map_exit, tb_null);
+
+    // read the other formats from the mapped data
+    tb_object_ref_t object = tb_object_read_from_data(data, (tb_size_t)size);
+    tb_file_unmap(data, (tb_size_t)size);
+    return object;
+}
 tb_long_t tb_object_writ(tb_object_ref_t object, tb_stream_ref_t stream, tb_size_t format)
 {
     // check
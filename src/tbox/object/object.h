@@ -116,6 +116,17 @@ tb_object_ref_t     tb_object_read_from_url(tb_char_t const* url);
  */
 tb_object_ref_t     tb_object_read_from_data(tb_byte_t const* data, tb_size_t size);
 
+/*! read object from the mapped file
+ *
+ * the mbin object will reference the mapped file directly and only the accessed items will be decoded,
+ * and the other formats will be read from the mapped data.
+ *
+ * @param path      the file path
+ *
+ * @return          the object
+ */
+tb_object_ref_t     tb_object_read_from_map(tb_char_t const* path);
+
 /*! writ object
  *
  * @param object    the object
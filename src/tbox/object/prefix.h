@@ -70,6 +70,7 @@ typedef enum __tb_object_format_e
 ,   TB_OBJECT_FORMAT_XPLIST     = 0x0003    //!< the xplist format for apple
 ,   TB_OBJECT_FORMAT_XML        = 0x0004    //!< the xml format
 ,   TB_OBJECT_FORMAT_JSON       = 0x0005    //!< the json format
+,   TB_OBJECT_FORMAT_MBIN       = 0x0006    //!< the tbox mappable binary format with the lazy random access
 ,   TB_OBJECT_FORMAT_MAXN       = 0x000f    //!< the format maxn
 ,   TB_OBJECT_FORMAT_DEFLATE    = 0x0100    //!< deflate?
 
@@ -70,6 +70,11 @@ tb_void_t tb_directory_walk(tb_char_t const* path, tb_bool_t recursion, tb_bool_
 {
     tb_trace_noimpl();
 }
+tb_bool_t tb_directory_walk_parallel(tb_char_t const* path, tb_size_t flags, tb_size_t workers, tb_directory_walk_func_t func, tb_cpointer_t priv)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
 tb_bool_t tb_directory_copy(tb_char_t const* path, tb_char_t const* dest)
 {
     tb_trace_noimpl();
@@ -41,6 +41,17 @@ __tb_extern_c_enter__
  * types
  */
 
+/// the directory walk flag type
+typedef enum __tb_directory_walk_flag_t
+{
+    TB_DIRECTORY_WALK_FLAG_NONE         = 0
+,   TB_DIRECTORY_WALK_FLAG_RECURSION    = 1     //!< walk the subdirectories recursively
+,   TB_DIRECTORY_WALK_FLAG_PREFIX       = 2     //!< prefix recursion, the directory is the first item
+,   TB_DIRECTORY_WALK_FLAG_TYPEONLY     = 4     //!< only get the file type from the directory entry if possible and skip stat, the size and times will be zero
+,   TB_DIRECTORY_WALK_FLAG_ORDERED      = 8     //!< call func serially in the calling thread with the same order as tb_directory_walk()
+
+}tb_directory_walk_flag_t;
+
 /*! the directory walk func type
  *
  * @param path          the file path
@@ -117,6 +128,24 @@ tb_size_t               tb_directory_temporary(tb_char_t* path, tb_size_t maxn);
  */
 tb_void_t               tb_directory_walk(tb_char_t const* path, tb_bool_t recursion, tb_bool_t prefix, tb_directory_walk_func_t func, tb_cpointer_t priv);
 
+/*! walk the directory in parallel
+ *
+ * the subdirectories will be read by the worker threads, 
+ * and func will be called concurrently from the worker threads if TB_DIRECTORY_WALK_FLAG_ORDERED is not set.
+ *
+ * the postfix callback of a directory is always called after all items in it have been walked, 
+ * so it can be used to remove the directory tree.
+ *
+ * @param path          the directory path
+ * @param flags         the walk flags, e.g. TB_DIRECTORY_WALK_FLAG_RECURSION | TB_DIRECTORY_WALK_FLAG_TYPEONLY
+ * @param workers       the worker count, uses the processor count if be zero
+ * @param func          the callback func
+ * @param priv          the callback data
+ *
+ * @return              tb_true if all items have been walked, tb_false if it was broken or failed
+ */
+tb_bool_t               tb_directory_walk_parallel(tb_char_t const* path, tb_size_t flags, tb_size_t workers, tb_directory_walk_func_t func, tb_cpointer_t priv);
+
 /*! copy directory
  * 
  * @param path          the directory path
@@ -147,4 +147,14 @@ tb_bool_t tb_file_link(tb_char_t const* path, tb_char_t const* dest)
     tb_trace_noimpl();
     return tb_false;
 }
+tb_pointer_t tb_file_map(tb_file_ref_t file, tb_size_t size)
+{
+    tb_trace_noimpl();
+    return tb_null;
+}
+tb_bool_t tb_file_unmap(tb_pointer_t data, tb_size_t size)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
 #endif
@@ -107,6 +107,29 @@ typedef struct __tb_file_info_t
 
 }tb_file_info_t;
 
+/// the file offload statistics type
+typedef struct __tb_file_offload_stats_t
+{
+    /// the io worker count
+    tb_size_t               workers;
+
+    /// the queued requests
+    tb_size_t               queue;
+
+    /// the peak queue depth
+    tb_size_t               queue_peak;
+
+    /// the finished requests
+    tb_hize_t               total;
+
+    /// the total latency (us) from posting to completion
+    tb_hize_t               latency;
+
+    /// the peak latency (us)
+    tb_hize_t               latency_peak;
+
+}tb_file_offload_stats_t;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -307,6 +330,38 @@ tb_bool_t               tb_file_rename(tb_char_t const* path, tb_char_t const* d
  */
 tb_bool_t               tb_file_link(tb_char_t const* path, tb_char_t const* dest);
 
+/*! map the file data to the readonly memory
+ *
+ * the file can be exited after mapping it, and the mapped pages will be loaded on demand
+ *
+ * @param file          the file
+ * @param size          the mapped size from the file head, e.g. tb_file_size(file)
+ *
+ * @return              the mapped data, tb_null if failed or not supported
+ */
+tb_pointer_t            tb_file_map(tb_file_ref_t file, tb_size_t size);
+
+/*! unmap the mapped file data
+ *
+ * @param data          the mapped data
+ * @param size          the mapped size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_file_unmap(tb_pointer_t data, tb_size_t size);
+
+/*! get the statistics of the offloaded file io
+ *
+ * the regular file cannot be waited by the poller, so the blocking file io (read, writ, sync ..)
+ * called in coroutine will be offloaded to the io worker threads, and only the current coroutine
+ * will be suspended until it is finished.
+ *
+ * @param stats         the statistics
+ *
+ * @return              tb_true or tb_false (not supported)
+ */
+tb_bool_t               tb_file_offload_stats(tb_file_offload_stats_t* stats);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -0,0 +1,554 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        file_offload.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "file_offload"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "file_offload.h"
+#ifdef TB_FILE_OFFLOAD_ENABLE
+#   include "../time.h"
+#   include "../thread.h"
+#   include "../socket.h"
+#   include "../spinlock.h"
+#   include "../semaphore.h"
+#   include "../../utils/singleton.h"
+#   include "../../container/list_entry.h"
+#   include "../../coroutine/coroutine.h"
+#   include <sys/eventfd.h>
+#   include <unistd.h>
+#   include <errno.h>
+#   include <poll.h>
+#endif
+
+#ifdef TB_FILE_OFFLOAD_ENABLE
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the io worker maxn
+#ifdef __tb_small__
+#   define TB_FILE_OFFLOAD_WORKER_MAXN      (4)
+#else
+#   define TB_FILE_OFFLOAD_WORKER_MAXN      (16)
+#endif
+
+// the cached eventfd maxn
+#ifdef __tb_small__
+#   define TB_FILE_OFFLOAD_EVFD_MAXN        (16)
+#else
+#   define TB_FILE_OFFLOAD_EVFD_MAXN        (64)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the file offload job type, it is on the stack of the waiting coroutine
+typedef struct __tb_file_offload_job_t
+{
+    // the list entry
+    tb_list_entry_t         entry;
+
+    // the operation
+    tb_size_t               op;
+
+    // the file
+    tb_file_ref_t           file;
+
+    // the data or iovec list
+    tb_cpointer_t           data;
+
+    // the data size or iovec count
+    tb_size_t               size;
+
+    // the file offset
+    tb_hize_t               offset;
+
+    // the real size
+    tb_long_t               real;
+
+    // the errno of the worker
+    tb_int_t                error;
+
+    // the eventfd for resuming the waiting coroutine
+    tb_int_t                evfd;
+
+    // the posted time (us)
+    tb_hong_t               time;
+
+}tb_file_offload_job_t;
+
+// the file offload type
+typedef struct __tb_file_offload_t
+{
+    // the lock
+    tb_spinlock_t           lock;
+
+    // the pending jobs
+    tb_list_entry_head_t    jobs;
+
+    // the semaphore for the idle workers
+    tb_semaphore_ref_t      semaphore;
+
+    // the workers
+    tb_thread_ref_t         workers[TB_FILE_OFFLOAD_WORKER_MAXN];
+
+    // the worker count
+    tb_size_t               workers_count;
+
+    // the running jobs
+    tb_size_t               busy;
+
+    // the cached eventfds
+    tb_int_t                evfds[TB_FILE_OFFLOAD_EVFD_MAXN];
+
+    // the cached eventfd count
+    tb_size_t               evfds_count;
+
+    // is stopped?
+    tb_bool_t               stopped;
+
+    // the statistics
+    tb_file_offload_stats_t stats;
+
+}tb_file_offload_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+/* the direct mode count of the current thread, the file io will not be offloaded if it is not zero
+ *
+ * @note the exclusive coroutine scheduler is visible from all threads, so we need mark the io workers too
+ */
+static __tb_thread_local__ tb_size_t g_direct = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_long_t tb_file_offload_call(tb_file_offload_job_t* job)
+{
+    // check
+    tb_assert(job && job->file);
+
+    // do it directly, it will not be offloaded again in the io worker
+
+    switch (job->op)
+    {
+    case TB_FILE_OFFLOAD_OP_READ:
+        return tb_file_read(job->file, (tb_byte_t*)job->data, job->size);
+    case TB_FILE_OFFLOAD_OP_WRIT:
+        return tb_file_writ(job->file, (tb_byte_t const*)job->data, job->size);
+    case TB_FILE_OFFLOAD_OP_PREAD:
+        return tb_file_pread(job->file, (tb_byte_t*)job->data, job->size, job->offset);
+    case TB_FILE_OFFLOAD_OP_PWRIT:
+        return tb_file_pwrit(job->file, (tb_byte_t const*)job->data, job->size, job->offset);
+    case TB_FILE_OFFLOAD_OP_READV:
+        return tb_file_readv(job->file, (tb_iovec_t const*)job->data, job->size);
+    case TB_FILE_OFFLOAD_OP_WRITV:
+        return tb_file_writv(job->file, (tb_iovec_t const*)job->data, job->size);
+    case TB_FILE_OFFLOAD_OP_PREADV:
+        return tb_file_preadv(job->file, (tb_iovec_t const*)job->data, job->size, job->offset);
+    case TB_FILE_OFFLOAD_OP_PWRITV:
+        return tb_file_pwritv(job->file, (tb_iovec_t const*)job->data, job->size, job->offset);
+    case TB_FILE_OFFLOAD_OP_SYNC:
+        return tb_file_sync(job->file)? 0 : -1;
+    default:
+        tb_assert(0);
+        break;
+    }
+    return -1;
+}
+static tb_int_t tb_file_offload_worker(tb_cpointer_t priv)
+{
+    // check
+    tb_file_offload_t* offload = (tb_file_offload_t*)priv;
+    tb_assert_and_check_return_val(offload && offload->semaphore, -1);
+
+    // trace
+    tb_trace_d("worker: init");
+
+    // the io worker always do the file io directly
+    g_direct = 1;
+
+    // do jobs
+    while (1)
+    {
+        // wait jobs
+        if (tb_semaphore_wait(offload->semaphore, -1) < 0) break;
+
+        // pull a job
+        tb_bool_t               stopped = tb_false;
+        tb_file_offload_job_t*  job = tb_null;
+        tb_spinlock_enter(&offload->lock);
+        if (tb_list_entry_size(&offload->jobs))
+        {
+            job = (tb_file_offload_job_t*)tb_list_entry(&offload->jobs, tb_list_entry_head(&offload->jobs));
+            tb_list_entry_remove_head(&offload->jobs);
+            offload->stats.queue--;
+            offload->busy++;
+        }
+        else stopped = offload->stopped;
+        tb_spinlock_leave(&offload->lock);
+
+        // stopped?
+        tb_check_break(!stopped);
+        tb_check_continue(job);
+
+        // do job
+        job->real = tb_file_offload_call(job);
+        job->error = job->real < 0? errno : 0;
+
+        // update the statistics
+        tb_hize_t latency = (tb_hize_t)(tb_uclock() - job->time);
+        tb_spinlock_enter(&offload->lock);
+        offload->busy--;
+        offload->stats.total++;
+        offload->stats.latency += latency;
+        if (latency > offload->stats.latency_peak) offload->stats.latency_peak = latency;
+        tb_spinlock_leave(&offload->lock);
+
+        /* resume the waiting coroutine
+         *
+         * @note we cannot access this job after notifying it, because it is on the stack of the waiting coroutine
+         */
+        tb_uint64_t value = 1;
+        if (write(job->evfd, &value, sizeof(value)) != sizeof(value))
+        {
+            // trace
+            tb_trace_e("notify job(%p) failed, errno: %d", job, errno);
+        }
+    }
+
+    // trace
+    tb_trace_d("worker: exit");
+    return 0;
+}
+static tb_int_t tb_file_offload_evfd_get(tb_file_offload_t* offload)
+{
+    // get a cached eventfd
+    tb_int_t evfd = -1;
+    tb_spinlock_enter(&offload->lock);
+    if (offload->evfds_count) evfd = offload->evfds[--offload->evfds_count];
+    tb_spinlock_leave(&offload->lock);
+
+    // make a new eventfd
+    if (evfd < 0) evfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    return evfd;
+}
+static tb_void_t tb_file_offload_evfd_put(tb_file_offload_t* offload, tb_int_t evfd)
+{
+    // cache it
+    tb_bool_t cached = tb_false;
+    tb_spinlock_enter(&offload->lock);
+    if (!offload->stopped && offload->evfds_count < tb_arrayn(offload->evfds))
+    {
+        offload->evfds[offload->evfds_count++] = evfd;
+        cached = tb_true;
+    }
+    tb_spinlock_leave(&offload->lock);
+
+    // close it if the cache is full
+    if (!cached) close(evfd);
+}
+static tb_bool_t tb_file_offload_post(tb_file_offload_t* offload, tb_file_offload_job_t* job)
+{
+    // post job
+    tb_bool_t   ok = tb_false;
+    tb_bool_t   spawn = tb_false;
+    tb_spinlock_enter(&offload->lock);
+    if (!offload->stopped)
+    {
+        // insert job
+        tb_list_entry_insert_tail(&offload->jobs, &job->entry);
+
+        // update the queue depth
+        offload->stats.queue++;
+        if (offload->stats.queue > offload->stats.queue_peak) offload->stats.queue_peak = offload->stats.queue;
+
+        // need more workers? all workers are busy now
+        if (offload->stats.queue + offload->busy > offload->workers_count && offload->workers_count < tb_arrayn(offload->workers))
+        {
+            // reserve a worker slot, it will be started after leaving the lock
+            offload->workers_count++;
+            spawn = tb_true;
+        }
+        ok = tb_true;
+    }
+    tb_spinlock_leave(&offload->lock);
+    tb_check_return_val(ok, tb_false);
+
+    // start a new worker
+    if (spawn)
+    {
+        tb_thread_ref_t worker = tb_thread_init("file_offload", tb_file_offload_worker, offload, 0);
+        tb_spinlock_enter(&offload->lock);
+        if (worker)
+        {
+            // the workers are only exited after all offloading coroutines have been finished, so we find a free slot
+            tb_size_t i = 0;
+            for (i = 0; i < tb_arrayn(offload->workers) && offload->workers[i]; i++) ;
+            tb_assert(i < tb_arrayn(offload->workers));
+            if (i < tb_arrayn(offload->workers)) offload->workers[i] = worker;
+            offload->stats.workers++;
+        }
+        else offload->workers_count--;
+        tb_spinlock_leave(&offload->lock);
+
+        // trace
+        tb_trace_d("spawn worker: %s", worker? "ok" : "failed");
+    }
+
+    // notify workers
+    tb_semaphore_post(offload->semaphore, 1);
+    return tb_true;
+}
+static tb_void_t tb_file_offload_wait(tb_file_offload_job_t* job)
+{
+    // wait the job until it is finished
+    tb_uint64_t value = 0;
+    tb_bool_t   waited = tb_false;
+    while (read(job->evfd, &value, sizeof(value)) != sizeof(value))
+    {
+        // check
+        tb_assert_and_check_break(errno == EAGAIN || errno == EINTR);
+
+        // only suspend the current coroutine
+        if (tb_coroutine_waitfd(job->evfd, TB_SOCKET_EVENT_RECV, -1) > 0) waited = tb_true;
+        else
+        {
+            /* the scheduler has been stopped? we must wait it in the current thread,
+             * because the job is on our stack and it will be accessed by the worker
+             */
+            struct pollfd pfd = {0};
+            pfd.fd      = job->evfd;
+            pfd.events  = POLLIN;
+            poll(&pfd, 1, -1);
+        }
+    }
+
+    // remove this eventfd from the poller, it will be reused by the other coroutines
+    if (waited) tb_coroutine_cancelfd(job->evfd);
+}
+static tb_handle_t tb_file_offload_instance_init(tb_cpointer_t* ppriv)
+{
+    // done
+    tb_bool_t           ok = tb_false;
+    tb_file_offload_t*  offload = tb_null;
+    do
+    {
+        // make offload
+        offload = tb_malloc0_type(tb_file_offload_t);
+        tb_assert_and_check_break(offload);
+
+        // init lock
+        if (!tb_spinlock_init(&offload->lock)) break;
+
+        // init jobs
+        tb_list_entry_init(&offload->jobs, tb_file_offload_job_t, entry, tb_null);
+
+        // init semaphore
+        offload->semaphore = tb_semaphore_init(0);
+        tb_assert_and_check_break(offload->semaphore);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok && offload)
+    {
+        if (offload->semaphore) tb_semaphore_exit(offload->semaphore);
+        tb_spinlock_exit(&offload->lock);
+        tb_free(offload);
+        offload = tb_null;
+    }
+    return (tb_handle_t)offload;
+}
+static tb_void_t tb_file_offload_instance_kill(tb_handle_t handle, tb_cpointer_t priv)
+{
+    // check
+    tb_file_offload_t* offload = (tb_file_offload_t*)handle;
+    tb_assert_and_check_return(offload);
+
+    // stop it
+    tb_spinlock_enter(&offload->lock);
+    offload->stopped = tb_true;
+    tb_size_t workers_count = offload->workers_count;
+    tb_spinlock_leave(&offload->lock);
+
+    // notify all workers
+    if (workers_count) tb_semaphore_post(offload->semaphore, workers_count);
+}
+static tb_void_t tb_file_offload_instance_exit(tb_handle_t handle, tb_cpointer_t priv)
+{
+    // check
+    tb_file_offload_t* offload = (tb_file_offload_t*)handle;
+    tb_assert_and_check_return(offload);
+
+    // kill it first
+    tb_file_offload_instance_kill(handle, priv);
+
+    // exit workers
+    tb_size_t i = 0;
+    for (i = 0; i < tb_arrayn(offload->workers); i++)
+    {
+        tb_thread_ref_t worker = offload->workers[i];
+        if (worker)
+        {
+            if (tb_thread_wait(worker, -1, tb_null) <= 0)
+            {
+                // trace
+                tb_trace_e("wait worker(%p) failed!", worker);
+            }
+            tb_thread_exit(worker);
+            offload->workers[i] = tb_null;
+        }
+    }
+
+    // trace
+    tb_trace_d("exit: workers: %lu, total: %llu, queue_peak: %lu, latency_peak: %llu us", offload->stats.workers, offload->stats.total, offload->stats.queue_peak, offload->stats.latency_peak);
+
+    // exit the cached eventfds
+    for (i = 0; i < offload->evfds_count; i++) close(offload->evfds[i]);
+    offload->evfds_count = 0;
+
+    // exit semaphore
+    if (offload->semaphore) tb_semaphore_exit(offload->semaphore);
+    offload->semaphore = tb_null;
+
+    // exit lock
+    tb_spinlock_exit(&offload->lock);
+
+    // exit it
+    tb_free(offload);
+}
+static tb_file_offload_t* tb_file_offload()
+{
+    return (tb_file_offload_t*)tb_singleton_instance(TB_SINGLETON_TYPE_FILE_OFFLOAD, tb_file_offload_instance_init, tb_file_offload_instance_exit, tb_file_offload_instance_kill, tb_null);
+}
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+#ifdef TB_FILE_OFFLOAD_ENABLE
+tb_bool_t tb_file_offload_need()
+{
+    // only offload it in the stackful coroutine
+    return (!g_direct && tb_coroutine_self())? tb_true : tb_false;
+}
+tb_void_t tb_file_offload_enter_direct()
+{
+    g_direct++;
+}
+tb_void_t tb_file_offload_leave_direct()
+{
+    tb_assert(g_direct);
+    g_direct--;
+}
+tb_bool_t tb_file_offload_done(tb_size_t op, tb_file_ref_t file, tb_cpointer_t data, tb_size_t size, tb_hize_t offset, tb_long_t* preal)
+{
+    // check
+    tb_assert_and_check_return_val(op && file && preal, tb_false);
+
+    // get the file offload
+    tb_file_offload_t* offload = tb_file_offload();
+    tb_check_return_val(offload, tb_false);
+
+    // init job
+    tb_file_offload_job_t job;
+    job.op      = op;
+    job.file    = file;
+    job.data    = data;
+    job.size    = size;
+    job.offset  = offset;
+    job.real    = -1;
+    job.error   = 0;
+    job.time    = tb_uclock();
+    job.evfd    = tb_file_offload_evfd_get(offload);
+    tb_check_return_val(job.evfd >= 0, tb_false);
+
+    // post it
+    if (!tb_file_offload_post(offload, &job))
+    {
+        tb_file_offload_evfd_put(offload, job.evfd);
+        return tb_false;
+    }
+
+    // wait it
+    tb_file_offload_wait(&job);
+    tb_file_offload_evfd_put(offload, job.evfd);
+
+    // save the real size and errno
+    *preal = job.real;
+    if (job.real < 0) errno = job.error;
+    return tb_true;
+}
+tb_bool_t tb_file_offload_stats(tb_file_offload_stats_t* stats)
+{
+    // check
+    tb_assert_and_check_return_val(stats, tb_false);
+
+    // get the file offload
+    tb_file_offload_t* offload = tb_file_offload();
+    tb_check_return_val(offload, tb_false);
+
+    // get the statistics
+    tb_spinlock_enter(&offload->lock);
+    *stats = offload->stats;
+    tb_spinlock_leave(&offload->lock);
+    return tb_true;
+}
+#else
+tb_bool_t tb_file_offload_need()
+{
+    return tb_false;
+}
+tb_void_t tb_file_offload_enter_direct()
+{
+}
+tb_void_t tb_file_offload_leave_direct()
+{
+}
+tb_bool_t tb_file_offload_done(tb_size_t op, tb_file_ref_t file, tb_cpointer_t data, tb_size_t size, tb_hize_t offset, tb_long_t* preal)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+tb_bool_t tb_file_offload_stats(tb_file_offload_stats_t* stats)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+#endif
@@ -0,0 +1,114 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        file_offload.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_IMPL_FILE_OFFLOAD_H
+#define TB_PLATFORM_IMPL_FILE_OFFLOAD_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../file.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/* enable the file offload?
+ *
+ * it need the stackful coroutine and eventfd for resuming it,
+ * and the thread local for marking the io workers and direct mode
+ */
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+    && !defined(TB_CONFIG_MICRO_ENABLE) \
+    && !defined(TB_CONFIG_OS_WINDOWS) \
+    && defined(TB_CONFIG_POSIX_HAVE_EVENTFD) \
+    && defined(__tb_thread_local__)
+#   define TB_FILE_OFFLOAD_ENABLE
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the file offload operation enum
+typedef enum __tb_file_offload_op_e
+{
+    TB_FILE_OFFLOAD_OP_NONE     = 0
+,   TB_FILE_OFFLOAD_OP_READ     = 1
+,   TB_FILE_OFFLOAD_OP_WRIT     = 2
+,   TB_FILE_OFFLOAD_OP_PREAD    = 3
+,   TB_FILE_OFFLOAD_OP_PWRIT    = 4
+,   TB_FILE_OFFLOAD_OP_READV    = 5
+,   TB_FILE_OFFLOAD_OP_WRITV    = 6
+,   TB_FILE_OFFLOAD_OP_PREADV   = 7
+,   TB_FILE_OFFLOAD_OP_PWRITV   = 8
+,   TB_FILE_OFFLOAD_OP_SYNC     = 9
+
+}tb_file_offload_op_e;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* need offload the file io? only for the current coroutine
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_file_offload_need(tb_noarg_t);
+
+/* enter the direct mode for the current thread, the file io will not be offloaded
+ *
+ * e.g. writing the trace file with the locked spinlock, we cannot suspend the current coroutine
+ */
+tb_void_t           tb_file_offload_enter_direct(tb_noarg_t);
+
+// leave the direct mode for the current thread
+tb_void_t           tb_file_offload_leave_direct(tb_noarg_t);
+
+/* offload the file io to the io workers and suspend the current coroutine until it is finished
+ *
+ * @param op        the operation
+ * @param file      the file
+ * @param data      the data or iovec list
+ * @param size      the data size or iovec count
+ * @param offset    the file offset for pread, pwrit ..
+ * @param preal     the real size or -1, the errno will also be restored
+ *
+ * @return          tb_true if it has been offloaded, otherwise we need do it directly
+ */
+tb_bool_t           tb_file_offload_done(tb_size_t op, tb_file_ref_t file, tb_cpointer_t data, tb_size_t size, tb_hize_t offset, tb_long_t* preal);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
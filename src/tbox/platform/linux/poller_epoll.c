@@ -26,6 +26,7 @@
  * includes
  */
 #include "prefix.h"
+#include "../atomic.h"
 #include <sys/epoll.h>
 #include <fcntl.h>
 #include <errno.h>
@@ -35,6 +36,18 @@
 #ifdef TB_CONFIG_POSIX_HAVE_GETRLIMIT
 #   include <sys/resource.h>
 #endif
+#ifdef TB_CONFIG_POSIX_HAVE_EVENTFD
+#   include <sys/eventfd.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// use eventfd for spak and kill if be supported
+#if defined(TB_CONFIG_POSIX_HAVE_EVENTFD) && defined(EFD_NONBLOCK) && defined(EFD_CLOEXEC)
+#   define TB_POLLER_HAVE_EVENTFD
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
@@ -49,8 +62,19 @@ typedef struct __tb_poller_epoll_t
     // the user private data
     tb_cpointer_t           priv;
 
+#ifdef TB_POLLER_HAVE_EVENTFD
+    /* the eventfd for spak, kill ..
+     *
+     * all pending wakeups are coalesced into one counter, so spak() never blocks or fills a socket buffer
+     */
+    tb_long_t               evfd;
+
+    // the killed flag, it will be consumed by tb_poller_wait()
+    tb_atomic_t             killed;
+#else
     // the pair sockets for spak, kill ..
     tb_socket_ref_t         pair[2];
+#endif
 
     // the epoll fd
     tb_long_t               epfd;
@@ -96,7 +120,7 @@ static tb_size_t tb_poller_maxfds()
 static tb_void_t tb_poller_hash_set(tb_poller_epoll_ref_t poller, tb_long_t fd, tb_cpointer_t priv)
 {
     // check
-    tb_assert(poller && fd > 0 && fd < TB_MAXS32);
+    tb_assert(poller && fd >= 0 && fd < TB_MAXS32);
 
     // not null?
     if (priv)
@@ -133,7 +157,7 @@ static __tb_inline__ tb_cpointer_t tb_poller_hash_get(tb_poller_epoll_ref_t poll
 {
     // check
     tb_assert(poller && poller->hash);
-    tb_assert(fd > 0 && fd < TB_MAXS32);
+    tb_assert(fd >= 0 && fd < TB_MAXS32);
 
     // get the user private data
     return fd < poller->hash_size? poller->hash[fd] : tb_null;
@@ -142,12 +166,95 @@ static __tb_inline__ tb_void_t tb_poller_hash_del(tb_poller_epoll_ref_t poller,
 {
     // check
     tb_assert(poller && poller->hash);
-    tb_assert(fd > 0 && fd < TB_MAXS32);
+    tb_assert(fd >= 0 && fd < TB_MAXS32);
 
     // remove the user private data
     if (fd < poller->hash_size) poller->hash[fd] = tb_null;
 }
 
+static tb_bool_t tb_poller_wakeup_init(tb_poller_epoll_ref_t poller)
+{
+    // check
+    tb_assert(poller);
+
+#ifdef TB_POLLER_HAVE_EVENTFD
+    // init eventfd
+    poller->evfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    tb_assert_and_check_return_val(poller->evfd >= 0, tb_false);
+    return tb_true;
+#else
+    // init pair sockets
+    return tb_socket_pair(TB_SOCKET_TYPE_TCP, poller->pair);
+#endif
+}
+static tb_void_t tb_poller_wakeup_exit(tb_poller_epoll_ref_t poller)
+{
+    // check
+    tb_assert(poller);
+
+#ifdef TB_POLLER_HAVE_EVENTFD
+    // exit eventfd
+    if (poller->evfd >= 0) close(poller->evfd);
+    poller->evfd = -1;
+#else
+    // exit pair sockets
+    if (poller->pair[0]) tb_socket_exit(poller->pair[0]);
+    if (poller->pair[1]) tb_socket_exit(poller->pair[1]);
+    poller->pair[0] = tb_null;
+    poller->pair[1] = tb_null;
+#endif
+}
+static __tb_inline__ tb_socket_ref_t tb_poller_wakeup_sock(tb_poller_epoll_ref_t poller)
+{
+#ifdef TB_POLLER_HAVE_EVENTFD
+    return tb_fd2sock(poller->evfd);
+#else
+    return poller->pair[1];
+#endif
+}
+static tb_void_t tb_poller_wakeup_post(tb_poller_epoll_ref_t poller, tb_bool_t kill)
+{
+    // check
+    tb_assert(poller);
+
+#ifdef TB_POLLER_HAVE_EVENTFD
+    // mark it as killed first
+    if (kill) tb_atomic_set(&poller->killed, 1);
+
+    // post it, the counter will only be accumulated if it has not been read
+    tb_uint64_t value = 1;
+    if (poller->evfd >= 0 && write(poller->evfd, &value, sizeof(value)) != sizeof(value))
+    {
+        // it will be failed with EAGAIN only if the counter is overflow, but the poller has been waked up already
+        tb_assert(errno == EAGAIN);
+    }
+#else
+    // post it
+    if (poller->pair[0]) tb_socket_send(poller->pair[0], (tb_byte_t const*)(kill? "k" : "p"), 1);
+#endif
+}
+static tb_bool_t tb_poller_wakeup_read(tb_poller_epoll_ref_t poller)
+{
+    // check
+    tb_assert(poller);
+
+#ifdef TB_POLLER_HAVE_EVENTFD
+    // read and reset the counter, it may be read already if the events are waited by the other threads
+    tb_uint64_t value = 0;
+    if (read(poller->evfd, &value, sizeof(value)) < 0 && errno != EAGAIN) return tb_false;
+
+    // killed?
+    return !tb_atomic_fetch_and_set(&poller->killed, 0);
+#else
+    // read spak
+    tb_char_t spak = '\0';
+    if (1 != tb_socket_recv(poller->pair[1], (tb_byte_t*)&spak, 1)) return tb_false;
+
+    // killed?
+    return spak != 'k';
+#endif
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -162,6 +269,11 @@ tb_poller_ref_t tb_poller_init(tb_cpointer_t priv)
         poller = tb_malloc0_type(tb_poller_epoll_t);
         tb_assert_and_check_break(poller);
 
+#ifdef TB_POLLER_HAVE_EVENTFD
+        // init eventfd
+        poller->evfd = -1;
+#endif
+
         // init maxn
         poller->maxn = tb_poller_maxfds();
         tb_assert_and_check_break(poller->maxn);
@@ -173,11 +285,11 @@ tb_poller_ref_t tb_poller_init(tb_cpointer_t priv)
         // init user private data
         poller->priv = priv;
 
-        // init pair sockets
-        if (!tb_socket_pair(TB_SOCKET_TYPE_TCP, poller->pair)) break;
+        // init the wakeup object for spak and kill
+        if (!tb_poller_wakeup_init(poller)) break;
 
-        // insert pair socket first
-        if (!tb_poller_insert((tb_poller_ref_t)poller, poller->pair[1], TB_POLLER_EVENT_RECV, tb_null)) break;  
+        // insert the wakeup object first
+        if (!tb_poller_insert((tb_poller_ref_t)poller, tb_poller_wakeup_sock(poller), TB_POLLER_EVENT_RECV, tb_null)) break;
 
         // ok
         ok = tb_true;
@@ -201,11 +313,8 @@ tb_void_t tb_poller_exit(tb_poller_ref_t self)
     tb_poller_epoll_ref_t poller = (tb_poller_epoll_ref_t)self;
     tb_assert_and_check_return(poller);
 
-    // exit pair sockets
-    if (poller->pair[0]) tb_socket_exit(poller->pair[0]);
-    if (poller->pair[1]) tb_socket_exit(poller->pair[1]);
-    poller->pair[0] = tb_null;
-    poller->pair[1] = tb_null;
+    // exit the wakeup object
+    tb_poller_wakeup_exit(poller);
 
     // exit hash
     if (poller->hash) tb_free(poller->hash);
@@ -235,7 +344,17 @@ tb_void_t tb_poller_clear(tb_poller_ref_t self)
 
     // recreate a new epoll
     poller->epfd = epoll_create(poller->maxn);
-    tb_assert(poller->epfd > 0);
+    tb_assert_and_check_return(poller->epfd > 0);
+
+    // clear the user private data
+    if (poller->hash) tb_memset(poller->hash, 0, poller->hash_size * sizeof(tb_cpointer_t));
+
+    // re-insert the wakeup object, otherwise spak() and kill() will not work
+    if (!tb_poller_insert(self, tb_poller_wakeup_sock(poller), TB_POLLER_EVENT_RECV, tb_null))
+    {
+        // trace
+        tb_trace_e("re-insert the wakeup object failed!");
+    }
 }
 tb_cpointer_t tb_poller_priv(tb_poller_ref_t self)
 {
@@ -253,7 +372,7 @@ tb_void_t tb_poller_kill(tb_poller_ref_t self)
     tb_assert_and_check_return(poller);
 
     // kill it
-    if (poller->pair[0]) tb_socket_send(poller->pair[0], (tb_byte_t const*)"k", 1);
+    tb_poller_wakeup_post(poller, tb_true);
 }
 tb_void_t tb_poller_spak(tb_poller_ref_t self)
 {
@@ -262,7 +381,7 @@ tb_void_t tb_poller_spak(tb_poller_ref_t self)
     tb_assert_and_check_return(poller);
 
     // post it
-    if (poller->pair[0]) tb_socket_send(poller->pair[0], (tb_byte_t const*)"p", 1);
+    tb_poller_wakeup_post(poller, tb_false);
 }
 tb_bool_t tb_poller_support(tb_poller_ref_t self, tb_size_t events)
 {
@@ -433,7 +552,7 @@ tb_long_t tb_poller_wait(tb_poller_ref_t self, tb_poller_event_func_t func, tb_l
     tb_size_t           i = 0;
     tb_size_t           wait = 0; 
     struct epoll_event* e = tb_null;
-    tb_socket_ref_t     pair = poller->pair[1];
+    tb_socket_ref_t     pair = tb_poller_wakeup_sock(poller);
     for (i = 0; i < events_count; i++)
     {
         // the epoll event
@@ -449,12 +568,8 @@ tb_long_t tb_poller_wait(tb_poller_ref_t self, tb_poller_event_func_t func, tb_l
         // spak?
         if (sock == pair && (epoll_events & EPOLLIN)) 
         {
-            // read spak
-            tb_char_t spak = '\0';
-            if (1 != tb_socket_recv(pair, (tb_byte_t*)&spak, 1)) return -1;
-
-            // killed?
-            if (spak == 'k') return -1;
+            // read spak, killed?
+            if (!tb_poller_wakeup_read(poller)) return -1;
 
             // continue it
             continue ;
@@ -129,7 +129,7 @@ static tb_void_t tb_poller_hash_set(tb_poller_kqueue_ref_t poller, tb_socket_ref
 
     // the socket fd
     tb_long_t fd = tb_sock2fd(sock);
-    tb_assert(fd > 0 && fd < TB_MAXS32);
+    tb_assert(fd >= 0 && fd < TB_MAXS32);
 
     // not empty events?
     if (events)
@@ -169,7 +169,7 @@ static __tb_inline__ tb_size_t tb_poller_hash_get(tb_poller_kqueue_ref_t poller,
 
     // the socket fd
     tb_long_t fd = tb_sock2fd(sock);
-    tb_assert(fd > 0 && fd < TB_MAXS32);
+    tb_assert(fd >= 0 && fd < TB_MAXS32);
 
     // get the user private data
     return fd < poller->hash_size? poller->hash[fd] : 0;
@@ -181,7 +181,7 @@ static __tb_inline__ tb_void_t tb_poller_hash_del(tb_poller_kqueue_ref_t poller,
 
     // the socket fd
     tb_long_t fd = tb_sock2fd(sock);
-    tb_assert(fd > 0 && fd < TB_MAXS32);
+    tb_assert(fd >= 0 && fd < TB_MAXS32);
 
     // remove the user private data
     if (fd < poller->hash_size) poller->hash[fd] = 0;
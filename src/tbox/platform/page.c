@@ -52,4 +52,19 @@ tb_size_t tb_page_size()
     // default: 4KB
     return 4096;
 }
+tb_pointer_t tb_page_map(tb_size_t size, tb_size_t flags)
+{
+    tb_trace_noimpl();
+    return tb_null;
+}
+tb_bool_t tb_page_unmap(tb_pointer_t data, tb_size_t size)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+tb_bool_t tb_page_purge(tb_pointer_t data, tb_size_t size, tb_bool_t lazy)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
 #endif
@@ -36,6 +36,19 @@
  */
 __tb_extern_c_enter__
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the page map flag enum
+typedef enum __tb_page_map_flag_e
+{
+    TB_PAGE_MAP_FLAG_NONE           = 0     //!< map the normal pages
+,   TB_PAGE_MAP_FLAG_HUGE           = 1     //!< align the mapped pages and hint the system to back them with the transparent huge pages
+,   TB_PAGE_MAP_FLAG_HUGE_EXPLICIT  = 2     //!< map the explicit huge pages (e.g. hugetlbfs) first, fallback to the normal pages if failed
+
+}tb_page_map_flag_e;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -61,6 +74,34 @@ tb_void_t               tb_page_exit(tb_noarg_t);
  */
 tb_size_t               tb_page_size(tb_noarg_t);
 
+/*! map the anonymous pages from the system directly
+ *
+ * @param size          the size, it will be aligned by the page size
+ * @param flags         the map flags, e.g. TB_PAGE_MAP_FLAG_HUGE
+ *
+ * @return              the page-aligned data address, return tb_null if failed or not supported
+ */
+tb_pointer_t            tb_page_map(tb_size_t size, tb_size_t flags);
+
+/*! unmap the pages 
+ *
+ * @param data          the data address returned by tb_page_map()
+ * @param size          the mapped size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_page_unmap(tb_pointer_t data, tb_size_t size);
+
+/*! purge the pages and return the physical memory to the system, but keep the address range
+ *
+ * @param data          the page-aligned data address
+ * @param size          the size, it will be aligned by the page size
+ * @param lazy          purge them lazily (e.g. MADV_FREE), the system will reclaim them only under memory pressure
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_page_purge(tb_pointer_t data, tb_size_t size, tb_bool_t lazy);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
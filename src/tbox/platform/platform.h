@@ -44,6 +44,7 @@
 #include "atomic.h"
 #include "memory.h"
 #include "poller.h"
+#include "shaper.h"
 #include "context.h"
 #include "ifaddrs.h"
 #include "barrier.h"
@@ -97,3 +97,45 @@ tb_long_t tb_poller_wait(tb_poller_ref_t poller, tb_poller_event_func_t func, tb
 }
 #endif
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_bool_t tb_poller_insert_fd(tb_poller_ref_t poller, tb_int_t fd, tb_size_t events, tb_cpointer_t priv)
+{
+#ifdef TB_CONFIG_OS_WINDOWS
+    tb_trace_noimpl();
+    return tb_false;
+#else
+    // check
+    tb_assert_and_check_return_val(poller && fd >= 0, tb_false);
+
+    // insert it, the file descriptor and socket are the same handle on posix
+    return tb_poller_insert(poller, tb_fd2sock(fd), events, priv);
+#endif
+}
+tb_bool_t tb_poller_remove_fd(tb_poller_ref_t poller, tb_int_t fd)
+{
+#ifdef TB_CONFIG_OS_WINDOWS
+    tb_trace_noimpl();
+    return tb_false;
+#else
+    // check
+    tb_assert_and_check_return_val(poller && fd >= 0, tb_false);
+
+    // remove it
+    return tb_poller_remove(poller, tb_fd2sock(fd));
+#endif
+}
+tb_bool_t tb_poller_modify_fd(tb_poller_ref_t poller, tb_int_t fd, tb_size_t events, tb_cpointer_t priv)
+{
+#ifdef TB_CONFIG_OS_WINDOWS
+    tb_trace_noimpl();
+    return tb_false;
+#else
+    // check
+    tb_assert_and_check_return_val(poller && fd >= 0, tb_false);
+
+    // modify it
+    return tb_poller_modify(poller, tb_fd2sock(fd), events, priv);
+#endif
+}
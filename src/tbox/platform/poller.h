@@ -159,6 +159,42 @@ tb_bool_t           tb_poller_remove(tb_poller_ref_t poller, tb_socket_ref_t soc
  */
 tb_bool_t           tb_poller_modify(tb_poller_ref_t poller, tb_socket_ref_t sock, tb_size_t events, tb_cpointer_t priv);
 
+/*! insert the file descriptor to poller
+ *
+ * it can be used to wait the other readiness-based file descriptors, e.g. pipe, eventfd, timerfd, signalfd and inotify.
+ * the event func will be called with tb_fd2sock(fd) as the socket, we can get the fd back by tb_sock2fd(sock)
+ *
+ * @note it is not supported on windows
+ *
+ * @param poller    the poller
+ * @param fd        the file descriptor
+ * @param events    the poller events, only recv and send
+ * @param priv      the private data
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_poller_insert_fd(tb_poller_ref_t poller, tb_int_t fd, tb_size_t events, tb_cpointer_t priv);
+
+/*! remove the file descriptor from poller
+ *
+ * @param poller    the poller
+ * @param fd        the file descriptor
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_poller_remove_fd(tb_poller_ref_t poller, tb_int_t fd);
+
+/*! modify events for the given file descriptor
+ *
+ * @param poller    the poller
+ * @param fd        the file descriptor
+ * @param events    the poller events, only recv and send
+ * @param priv      the private data
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_poller_modify_fd(tb_poller_ref_t poller, tb_int_t fd, tb_size_t events, tb_cpointer_t priv);
+
 /*! wait all sockets
  *
  * @param poller    the poller
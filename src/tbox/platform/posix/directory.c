@@ -31,12 +31,182 @@
 #include "../path.h"
 #include "../directory.h"
 #include "../environment.h"
+#include "../atomic.h"
+#include "../semaphore.h"
+#include "../processor.h"
+#include "../spinlock.h"
+#include "../thread_pool.h"
+#include "../../container/list_entry.h"
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <dirent.h>
 #include <unistd.h>
+#ifdef TB_CONFIG_OS_LINUX
+#   include <sys/syscall.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// read the directory entries in large batches by getdents64 and stat them by fstatat on linux
+#if defined(TB_CONFIG_OS_LINUX) && defined(SYS_getdents64)
+#   define TB_DIRECTORY_HAVE_GETDENTS64
+#endif
+
+// the getdents64 buffer size
+#ifdef __tb_small__
+#   define TB_DIRECTORY_DENTS_SIZE          (16384)
+#else
+#   define TB_DIRECTORY_DENTS_SIZE          (65536)
+#endif
+
+// the maximum worker count of the parallel walker
+#define TB_DIRECTORY_WALK_WORKER_MAXN       (32)
+
+// the worker private index of the getdents64 buffer
+#define TB_DIRECTORY_WALK_WORKER_PRIV_DENTS (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+#ifdef TB_DIRECTORY_HAVE_GETDENTS64
+// the linux dirent64 type, it is not exported by the old libc
+typedef struct __tb_directory_dirent64_t
+{
+    // the inode number
+    tb_uint64_t                         d_ino;
+
+    // the offset to the next entry
+    tb_int64_t                          d_off;
+
+    // the entry size
+    tb_uint16_t                         d_reclen;
+
+    // the file type
+    tb_uint8_t                          d_type;
+
+    // the file name
+    tb_char_t                           d_name[1];
+
+}tb_directory_dirent64_t;
+#endif
+
+// the directory reader type
+typedef struct __tb_directory_reader_t
+{
+#ifdef TB_DIRECTORY_HAVE_GETDENTS64
+    // the directory fd
+    tb_int_t                            fd;
+
+    // the entries buffer
+    tb_byte_t*                          data;
+
+    // the entries size
+    tb_long_t                           size;
+
+    // the entries offset
+    tb_long_t                           offset;
+#else
+    // the directory
+    DIR*                                directory;
+#endif
+
+}tb_directory_reader_t;
+
+// the parallel directory walker type
+typedef struct __tb_directory_walker_t
+{
+    // the reference count, the walker will be freed after the calling thread and all tasks have released it
+    tb_atomic_t                         refn;
+
+    // the lock
+    tb_spinlock_t                       lock;
+
+    // the waiting nodes
+    tb_list_entry_head_t                nodes;
+
+    // the running tasks count in the thread pool
+    tb_size_t                           tasks;
+
+    // the maximum running tasks count
+    tb_size_t                           workers;
+
+    // the semaphore for notifying the calling thread
+    tb_semaphore_ref_t                  semaphore;
+
+    // the walk flags
+    tb_size_t                           flags;
+
+    // is stopped?
+    tb_atomic_t                         stopped;
+
+    // is finished? only for the unordered mode
+    tb_atomic_t                         finished;
+
+    // the callback func
+    tb_directory_walk_func_t            func;
+
+    // the callback data
+    tb_cpointer_t                       priv;
+
+}tb_directory_walker_t;
+
+// the walked item type for the ordered mode
+typedef struct __tb_directory_walk_item_t
+{
+    // the name offset 
+    tb_size_t                           name;
+
+    // the file info
+    tb_file_info_t                      info;
+
+    // the subdirectory node
+    struct __tb_directory_walk_node_t*  node;
+
+}tb_directory_walk_item_t;
+
+// the directory node type
+typedef struct __tb_directory_walk_node_t
+{
+    // the list entry of the waiting nodes
+    tb_list_entry_t                     entry;
+
+    // the walker
+    tb_directory_walker_t*              walker;
+
+    // the parent node, only for the unordered mode
+    struct __tb_directory_walk_node_t*  parent;
+
+    // the pending count of itself and the unfinished subdirectories, only for the unordered mode
+    tb_atomic_t                         pending;
+
+    // is ready? all items have been read, only for the ordered mode
+    tb_atomic_t                         ready;
+
+    // the directory info
+    tb_file_info_t                      info;
+
+    // the items, only for the ordered mode
+    tb_directory_walk_item_t*           items;
+    tb_size_t                           items_size;
+    tb_size_t                           items_maxn;
+
+    // the item names, only for the ordered mode
+    tb_char_t*                          names;
+    tb_size_t                           names_size;
+    tb_size_t                           names_maxn;
+
+    // the path size
+    tb_size_t                           size;
+
+    // the path
+    tb_char_t                           path[1];
+
+}tb_directory_walk_node_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
@@ -80,14 +250,14 @@ static tb_bool_t tb_directory_walk_copy(tb_char_t const* path, tb_file_info_t co
             tb_directory_remove(dpath);
     }
 
-    // copy 
+    // copy, @note it may be called by the parallel workers, so the failed flag is atomic
     switch (info->type)
     {
     case TB_FILE_TYPE_FILE:
-        if (!tb_file_copy(path, dpath)) tuple[2].b = tb_false;
+        if (!tb_file_copy(path, dpath)) tb_atomic_set(&tuple[2].a, 1);
         break;
     case TB_FILE_TYPE_DIRECTORY:
-        if (!tb_directory_create(dpath)) tuple[2].b = tb_false;
+        if (!tb_directory_create(dpath)) tb_atomic_set(&tuple[2].a, 1);
         break;
     default:
         break;
@@ -152,6 +322,467 @@ static tb_bool_t tb_directory_walk_impl(tb_char_t const* path, tb_bool_t recursi
     // continue ?
     return ok;
 }
+static __tb_inline__ tb_size_t tb_directory_reader_type(tb_size_t d_type)
+{
+#ifdef DT_DIR
+    // only trust the directory and regular file, we need stat the symbol link and unknown entry
+    if (d_type == DT_DIR) return TB_FILE_TYPE_DIRECTORY;
+    else if (d_type == DT_REG) return TB_FILE_TYPE_FILE;
+#endif
+    return TB_FILE_TYPE_NONE;
+}
+static tb_bool_t tb_directory_reader_init(tb_directory_reader_t* reader, tb_char_t const* path, tb_byte_t* data)
+{
+    // check
+    tb_assert_and_check_return_val(reader && path, tb_false);
+
+#ifdef TB_DIRECTORY_HAVE_GETDENTS64
+    // check
+    tb_assert_and_check_return_val(data, tb_false);
+
+    // init reader
+    reader->data    = data;
+    reader->size    = 0;
+    reader->offset  = 0;
+
+    // open directory
+    reader->fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    return reader->fd >= 0;
+#else
+    // open directory
+    tb_used(data);
+    reader->directory = opendir(path);
+    return reader->directory != tb_null;
+#endif
+}
+static tb_void_t tb_directory_reader_exit(tb_directory_reader_t* reader)
+{
+#ifdef TB_DIRECTORY_HAVE_GETDENTS64
+    if (reader->fd >= 0) close(reader->fd);
+    reader->fd = -1;
+#else
+    if (reader->directory) closedir(reader->directory);
+    reader->directory = tb_null;
+#endif
+}
+static tb_char_t const* tb_directory_reader_next(tb_directory_reader_t* reader, tb_size_t* ptype)
+{
+    // check
+    tb_assert_and_check_return_val(reader && ptype, tb_null);
+
+    // read the next entry
+    tb_char_t const* name = tb_null;
+    while (1)
+    {
+#ifdef TB_DIRECTORY_HAVE_GETDENTS64
+        // read the next batch of entries
+        if (reader->offset >= reader->size)
+        {
+            reader->size    = (tb_long_t)syscall(SYS_getdents64, reader->fd, reader->data, TB_DIRECTORY_DENTS_SIZE);
+            reader->offset  = 0;
+            tb_check_return_val(reader->size > 0, tb_null);
+        }
+
+        // get the entry
+        tb_directory_dirent64_t* item = (tb_directory_dirent64_t*)(reader->data + reader->offset);
+        tb_assert_and_check_return_val(item->d_reclen, tb_null);
+        reader->offset += item->d_reclen;
+#else
+        // get the entry
+        struct dirent* item = readdir(reader->directory);
+        tb_check_return_val(item, tb_null);
+#endif
+
+        // skip "." and ".."
+        name = item->d_name;
+        if (name[0] == '.' && (!name[1] || (name[1] == '.' && !name[2]))) continue;
+
+        // get the file type
+#ifdef DT_DIR
+        *ptype = tb_directory_reader_type(item->d_type);
+#else
+        *ptype = TB_FILE_TYPE_NONE;
+#endif
+        break;
+    }
+
+    // ok
+    return name;
+}
+static tb_void_t tb_directory_reader_info(tb_directory_reader_t* reader, tb_char_t const* path, tb_char_t const* name, tb_size_t type, tb_size_t flags, tb_file_info_t* info)
+{
+    // init info
+    tb_memset(info, 0, sizeof(tb_file_info_t));
+
+    // only get the file type? we need not stat it
+    if ((flags & TB_DIRECTORY_WALK_FLAG_TYPEONLY) && type != TB_FILE_TYPE_NONE)
+    {
+        info->type = type;
+        return ;
+    }
+
+    // get stat (file maybe not exists, dead symbol link)
+    struct stat st = {0};
+#ifdef TB_DIRECTORY_HAVE_GETDENTS64
+    tb_used(path);
+    if (!fstatat(reader->fd, name, &st, 0))
+#else
+    tb_used(reader);
+    tb_used(name);
+    if (!stat(path, &st))
+#endif
+    {
+        info->type  = S_ISDIR(st.st_mode)? TB_FILE_TYPE_DIRECTORY : TB_FILE_TYPE_FILE;
+        info->size  = st.st_size >= 0? (tb_hize_t)st.st_size : 0;
+        info->atime = (tb_time_t)st.st_atime;
+        info->mtime = (tb_time_t)st.st_mtime;
+    }
+}
+static tb_directory_walk_node_t* tb_directory_walk_node_init(tb_directory_walker_t* walker, tb_directory_walk_node_t* parent, tb_char_t const* path, tb_size_t size, tb_file_info_t const* info)
+{
+    // make node
+    tb_directory_walk_node_t* node = (tb_directory_walk_node_t*)tb_malloc0(sizeof(tb_directory_walk_node_t) + size);
+    tb_assert_and_check_return_val(node, tb_null);
+
+    // init node
+    node->walker    = walker;
+    node->parent    = parent;
+    node->pending   = 1;
+    node->ready     = 0;
+    node->size      = size;
+    if (info) node->info = *info;
+    tb_memcpy(node->path, path, size);
+    node->path[size] = '\0';
+    return node;
+}
+static tb_void_t tb_directory_walk_node_free(tb_directory_walk_node_t* node)
+{
+    if (node->items) tb_free(node->items);
+    if (node->names) tb_free(node->names);
+    tb_free(node);
+}
+static tb_bool_t tb_directory_walk_node_save(tb_directory_walk_node_t* node, tb_char_t const* name, tb_size_t size, tb_file_info_t const* info, tb_directory_walk_node_t* child)
+{
+    // grow items
+    if (node->items_size >= node->items_maxn)
+    {
+        tb_size_t maxn = node->items_maxn? (node->items_maxn << 1) : 16;
+        tb_directory_walk_item_t* items = (tb_directory_walk_item_t*)tb_ralloc(node->items, maxn * sizeof(tb_directory_walk_item_t));
+        tb_assert_and_check_return_val(items, tb_false);
+        node->items         = items;
+        node->items_maxn    = maxn;
+    }
+
+    // grow names
+    if (node->names_size + size + 1 > node->names_maxn)
+    {
+        tb_size_t maxn = tb_max(node->names_maxn << 1, node->names_size + size + 256);
+        tb_char_t* names = (tb_char_t*)tb_ralloc(node->names, maxn);
+        tb_assert_and_check_return_val(names, tb_false);
+        node->names         = names;
+        node->names_maxn    = maxn;
+    }
+
+    // save item
+    tb_directory_walk_item_t* item = &node->items[node->items_size++];
+    item->name  = node->names_size;
+    item->info  = *info;
+    item->node  = child;
+    tb_memcpy(node->names + node->names_size, name, size + 1);
+    node->names_size += size + 1;
+    return tb_true;
+}
+static tb_bool_t tb_directory_walk_call(tb_directory_walker_t* walker, tb_char_t const* path, tb_file_info_t const* info)
+{
+    // do callback
+    if (!walker->func(path, info, walker->priv))
+    {
+        tb_atomic_set(&walker->stopped, 1);
+        return tb_false;
+    }
+    return tb_true;
+}
+static tb_void_t tb_directory_walk_node_done(tb_directory_walk_node_t* node)
+{
+    // finish this node and all parent nodes which have no pending subdirectories
+    while (node && tb_atomic_fetch_and_dec(&node->pending) == 1)
+    {
+        // the root node? notify the calling thread
+        tb_directory_walker_t*      walker = node->walker;
+        tb_directory_walk_node_t*   parent = node->parent;
+        if (!parent)
+        {
+            tb_atomic_set(&walker->finished, 1);
+            tb_semaphore_post(walker->semaphore, 1);
+            break;
+        }
+
+        // do the postfix callback for this directory after all items in it have been walked
+        if (!(walker->flags & TB_DIRECTORY_WALK_FLAG_PREFIX) && !tb_atomic_get(&walker->stopped))
+            tb_directory_walk_call(walker, node->path, &node->info);
+
+        // exit this node
+        tb_directory_walk_node_free(node);
+
+        // finish the parent node
+        node = parent;
+    }
+}
+static tb_void_t tb_directory_walker_exit(tb_directory_walker_t* walker)
+{
+    // release it
+    if (tb_atomic_fetch_and_dec(&walker->refn) == 1)
+    {
+        // exit semaphore
+        if (walker->semaphore) tb_semaphore_exit(walker->semaphore);
+        walker->semaphore = tb_null;
+
+        // exit lock
+        tb_spinlock_exit(&walker->lock);
+
+        // exit it
+        tb_free(walker);
+    }
+}
+static tb_directory_walk_node_t* tb_directory_walker_pull(tb_directory_walker_t* walker)
+{
+    // pull the next waiting node
+    tb_directory_walk_node_t* node = tb_null;
+    tb_spinlock_enter(&walker->lock);
+    if (tb_list_entry_size(&walker->nodes))
+    {
+        node = (tb_directory_walk_node_t*)tb_list_entry(&walker->nodes, tb_list_entry_head(&walker->nodes));
+        tb_list_entry_remove_head(&walker->nodes);
+    }
+    tb_spinlock_leave(&walker->lock);
+    return node;
+}
+static tb_void_t tb_directory_walk_node_read(tb_directory_walk_node_t* node, tb_byte_t* data);
+static tb_void_t tb_directory_walker_task_exit(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // exit the entries buffer of this worker
+    if (priv) tb_free((tb_pointer_t)priv);
+}
+static tb_void_t tb_directory_walker_task_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_directory_walker_t* walker = (tb_directory_walker_t*)priv;
+    tb_assert_and_check_return(walker);
+
+    // get the entries buffer of this worker
+    tb_byte_t* data = tb_null;
+#ifdef TB_DIRECTORY_HAVE_GETDENTS64
+    data = (tb_byte_t*)tb_thread_pool_worker_getp(worker, TB_DIRECTORY_WALK_WORKER_PRIV_DENTS);
+    if (!data && (data = (tb_byte_t*)tb_malloc(TB_DIRECTORY_DENTS_SIZE)))
+        tb_thread_pool_worker_setp(worker, TB_DIRECTORY_WALK_WORKER_PRIV_DENTS, tb_directory_walker_task_exit, data);
+#endif
+
+    // read all waiting nodes
+    while (1)
+    {
+        // pull the next node, this task will be finished if there are no waiting nodes
+        tb_directory_walk_node_t* node = tb_null;
+        tb_spinlock_enter(&walker->lock);
+        if (tb_list_entry_size(&walker->nodes))
+        {
+            node = (tb_directory_walk_node_t*)tb_list_entry(&walker->nodes, tb_list_entry_head(&walker->nodes));
+            tb_list_entry_remove_head(&walker->nodes);
+        }
+        else walker->tasks--;
+        tb_spinlock_leave(&walker->lock);
+        tb_check_break(node);
+
+        // read it
+        tb_directory_walk_node_read(node, data);
+    }
+
+    // notify the calling thread and release the walker
+    tb_semaphore_post(walker->semaphore, 1);
+    tb_directory_walker_exit(walker);
+}
+static tb_void_t tb_directory_walker_post(tb_directory_walker_t* walker, tb_directory_walk_node_t* node)
+{
+    // add this node to the waiting nodes and start a new task if the running tasks are not enough
+    tb_bool_t post = tb_false;
+    tb_spinlock_enter(&walker->lock);
+    tb_list_entry_insert_tail(&walker->nodes, &node->entry);
+    if (walker->tasks < walker->workers)
+    {
+        walker->tasks++;
+        post = tb_true;
+    }
+    tb_spinlock_leave(&walker->lock);
+
+    // post the task to the thread pool, the waiting node will be read by the calling thread if it fails
+    if (post)
+    {
+        tb_atomic_fetch_and_inc(&walker->refn);
+        if (!tb_thread_pool_task_post(tb_thread_pool(), "directory_walk", tb_directory_walker_task_done, tb_null, walker, tb_false))
+        {
+            tb_spinlock_enter(&walker->lock);
+            walker->tasks--;
+            tb_spinlock_leave(&walker->lock);
+            tb_directory_walker_exit(walker);
+        }
+    }
+}
+static tb_void_t tb_directory_walk_node_read(tb_directory_walk_node_t* node, tb_byte_t* data)
+{
+    // check
+    tb_directory_walker_t* walker = node->walker;
+    tb_assert(walker);
+
+    // the walk flags
+    tb_size_t flags     = walker->flags;
+    tb_bool_t prefix    = (flags & TB_DIRECTORY_WALK_FLAG_PREFIX)? tb_true : tb_false;
+    tb_bool_t ordered   = (flags & TB_DIRECTORY_WALK_FLAG_ORDERED)? tb_true : tb_false;
+    tb_bool_t recursion = (flags & TB_DIRECTORY_WALK_FLAG_RECURSION)? tb_true : tb_false;
+
+    // read directory
+    tb_directory_reader_t reader;
+    if (!tb_atomic_get(&walker->stopped) && tb_directory_reader_init(&reader, node->path, data))
+    {
+        // init the path prefix
+        tb_char_t path[TB_PATH_MAXN];
+        tb_size_t size = tb_min(node->size, sizeof(path) - 2);
+        tb_memcpy(path, node->path, size);
+        if (!size || path[size - 1] != '/') path[size++] = '/';
+
+        // walk entries
+        tb_size_t           type = TB_FILE_TYPE_NONE;
+        tb_char_t const*    name = tb_null;
+        while (!tb_atomic_get(&walker->stopped) && (name = tb_directory_reader_next(&reader, &type)))
+        {
+            // make the item path
+            tb_size_t n = tb_strlen(name);
+            tb_check_continue(size + n < sizeof(path));
+            tb_memcpy(path + size, name, n + 1);
+
+            // get the file info
+            tb_file_info_t info;
+            tb_directory_reader_info(&reader, path, name, type, flags, &info);
+
+            // ordered? save this item and the callback will be done in the calling thread
+            if (ordered)
+            {
+                // make the subdirectory node
+                tb_directory_walk_node_t* child = tb_null;
+                if (info.type == TB_FILE_TYPE_DIRECTORY && recursion)
+                    child = tb_directory_walk_node_init(walker, tb_null, path, size + n, &info);
+
+                // save it
+                if (!tb_directory_walk_node_save(node, name, n, &info, child))
+                {
+                    if (child) tb_directory_walk_node_free(child);
+                    break;
+                }
+
+                // read the subdirectory in parallel
+                if (child) tb_directory_walker_post(walker, child);
+                continue;
+            }
+
+            // do the prefix callback
+            if (prefix && !tb_directory_walk_call(walker, path, &info)) break;
+
+            // walk the subdirectory in parallel, the postfix callback will be done after it is finished
+            tb_directory_walk_node_t* child = tb_null;
+            if (info.type == TB_FILE_TYPE_DIRECTORY && recursion && (child = tb_directory_walk_node_init(walker, node, path, size + n, &info)))
+            {
+                tb_atomic_fetch_and_inc(&node->pending);
+                tb_directory_walker_post(walker, child);
+            }
+            // do the postfix callback
+            else if (!prefix && !tb_directory_walk_call(walker, path, &info)) break;
+        }
+
+        // exit reader
+        tb_directory_reader_exit(&reader);
+    }
+
+    // ordered? mark this node as ready, @note it may be freed by the calling thread after it
+    if (ordered)
+    {
+        tb_atomic_set(&node->ready, 1);
+        tb_semaphore_post(walker->semaphore, 1);
+    }
+    // finish this node
+    else tb_directory_walk_node_done(node);
+}
+static tb_void_t tb_directory_walker_wait(tb_directory_walker_t* walker, tb_atomic_t* pdone, tb_byte_t* data)
+{
+    // wait it in the calling thread and help reading the waiting nodes
+    while (!tb_atomic_get(pdone))
+    {
+        tb_directory_walk_node_t* node = tb_directory_walker_pull(walker);
+        if (node) tb_directory_walk_node_read(node, data);
+        else if (tb_semaphore_wait(walker->semaphore, -1) < 0) break;
+    }
+}
+static tb_void_t tb_directory_walk_node_exit(tb_directory_walk_node_t* node, tb_byte_t* data)
+{
+    // wait it
+    tb_directory_walker_wait(node->walker, &node->ready, data);
+
+    // exit all subdirectory nodes
+    tb_size_t i = 0;
+    for (i = 0; i < node->items_size; i++)
+    {
+        if (node->items[i].node) tb_directory_walk_node_exit(node->items[i].node, data);
+    }
+
+    // exit it
+    tb_directory_walk_node_free(node);
+}
+static tb_bool_t tb_directory_walk_node_walk(tb_directory_walk_node_t* node, tb_byte_t* data)
+{
+    // wait it
+    tb_directory_walker_t* walker = node->walker;
+    tb_directory_walker_wait(walker, &node->ready, data);
+
+    // init the path prefix
+    tb_char_t path[TB_PATH_MAXN];
+    tb_size_t size = tb_min(node->size, sizeof(path) - 2);
+    tb_memcpy(path, node->path, size);
+    if (!size || path[size - 1] != '/') path[size++] = '/';
+
+    // walk all items with the same order as tb_directory_walk()
+    tb_bool_t ok = tb_true;
+    tb_bool_t prefix = (walker->flags & TB_DIRECTORY_WALK_FLAG_PREFIX)? tb_true : tb_false;
+    tb_size_t i = 0;
+    for (i = 0; i < node->items_size; i++)
+    {
+        // the item
+        tb_directory_walk_item_t*   item = &node->items[i];
+        tb_directory_walk_node_t*   child = item->node;
+        item->node = tb_null;
+        if (ok)
+        {
+            // make the item path
+            tb_strlcpy(path + size, node->names + item->name, sizeof(path) - size);
+
+            // do callback
+            if (prefix) ok = tb_directory_walk_call(walker, path, &item->info);
+
+            // walk the subdirectory, it will exit the child node
+            if (ok && child) 
+            {
+                ok = tb_directory_walk_node_walk(child, data);
+                child = tb_null;
+            }
+
+            // do callback
+            if (ok && !prefix) ok = tb_directory_walk_call(walker, path, &item->info);
+        }
+
+        // exit the unwalked subdirectory node if be stopped
+        if (child) tb_directory_walk_node_exit(child, data);
+    }
+
+    // exit this node
+    tb_directory_walk_node_free(node);
+    return ok;
+}
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -202,8 +833,8 @@ tb_bool_t tb_directory_remove(tb_char_t const* path)
     path = tb_path_absolute(path, full, TB_PATH_MAXN);
     tb_assert_and_check_return_val(path, tb_false);
 
-    // walk remove
-    tb_directory_walk_impl(path, tb_true, tb_false, tb_directory_walk_remove, tb_null);
+    // walk remove in parallel, the subdirectory will be removed after all items in it have been removed
+    tb_directory_walk_parallel(path, TB_DIRECTORY_WALK_FLAG_RECURSION | TB_DIRECTORY_WALK_FLAG_TYPEONLY, 0, tb_directory_walk_remove, tb_null);
 
     // remove it
     return !remove(path)? tb_true : tb_false;
@@ -273,6 +904,92 @@ tb_void_t tb_directory_walk(tb_char_t const* path, tb_bool_t recursion, tb_bool_
         tb_directory_walk_impl(path, recursion, prefix, func, priv);
     }
 }
+tb_bool_t tb_directory_walk_parallel(tb_char_t const* path, tb_size_t flags, tb_size_t workers, tb_directory_walk_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(path && func, tb_false);
+
+    // the absolute path (translate "~/")
+    tb_char_t full[TB_PATH_MAXN];
+    path = tb_path_absolute(path, full, TB_PATH_MAXN);
+    tb_assert_and_check_return_val(path, tb_false);
+
+    // the worker count
+    if (!workers) workers = tb_processor_count();
+    workers = tb_min(tb_max(workers, 1), TB_DIRECTORY_WALK_WORKER_MAXN);
+
+    // done
+    tb_bool_t                   ok = tb_false;
+    tb_byte_t*                  data = tb_null;
+    tb_directory_walk_node_t*   root = tb_null;
+    tb_directory_walker_t*      walker = tb_null;
+    do
+    {
+        // make walker
+        walker = tb_malloc0_type(tb_directory_walker_t);
+        tb_assert_and_check_break(walker);
+
+        // init walker
+        walker->refn        = 1;
+        walker->tasks       = 0;
+        walker->workers     = workers;
+        walker->flags       = flags;
+        walker->func        = func;
+        walker->priv        = priv;
+        walker->stopped     = 0;
+        walker->finished    = 0;
+        tb_list_entry_init(&walker->nodes, tb_directory_walk_node_t, entry, tb_null);
+
+        // init lock
+        if (!tb_spinlock_init(&walker->lock)) break;
+
+        // init semaphore
+        walker->semaphore = tb_semaphore_init(0);
+        tb_assert_and_check_break(walker->semaphore);
+
+        // init the entries buffer for the calling thread
+#ifdef TB_DIRECTORY_HAVE_GETDENTS64
+        data = (tb_byte_t*)tb_malloc(TB_DIRECTORY_DENTS_SIZE);
+        tb_assert_and_check_break(data);
+#endif
+
+        // init the root node
+        root = tb_directory_walk_node_init(walker, tb_null, path, tb_strlen(path), tb_null);
+        tb_assert_and_check_break(root);
+
+        /* read the root directory in the calling thread, 
+         * and the subdirectories will be read by the thread pool and the calling thread
+         */
+        tb_directory_walk_node_read(root, data);
+        if (flags & TB_DIRECTORY_WALK_FLAG_ORDERED)
+        {
+            // walk all items in the calling thread, it will exit all nodes
+            tb_directory_walk_node_walk(root, data);
+            root = tb_null;
+        }
+        // wait all subdirectories to be finished
+        else tb_directory_walker_wait(walker, &walker->finished, data);
+
+        // ok
+        ok = !tb_atomic_get(&walker->stopped);
+
+    } while (0);
+
+    // exit the root node
+    if (root) tb_directory_walk_node_free(root);
+    root = tb_null;
+
+    // exit the entries buffer
+    if (data) tb_free(data);
+    data = tb_null;
+
+    // release walker, the running tasks may still hold it
+    if (walker) tb_directory_walker_exit(walker);
+    walker = tb_null;
+
+    // ok?
+    return ok;
+}
 tb_bool_t tb_directory_copy(tb_char_t const* path, tb_char_t const* dest)
 {
     // the absolute path
@@ -289,11 +1006,11 @@ tb_bool_t tb_directory_copy(tb_char_t const* path, tb_char_t const* dest)
     tb_value_t tuple[3];
     tuple[0].cstr = dest;
     tuple[1].ul = tb_strlen(path);
-    tuple[2].b = tb_true;
-    tb_directory_walk_impl(path, tb_true, tb_true, tb_directory_walk_copy, tuple);
+    tb_atomic_set0(&tuple[2].a);
+    tb_directory_walk_parallel(path, TB_DIRECTORY_WALK_FLAG_RECURSION | TB_DIRECTORY_WALK_FLAG_PREFIX | TB_DIRECTORY_WALK_FLAG_TYPEONLY, 0, tb_directory_walk_copy, tuple);
 
     // ok?
-    tb_bool_t ok = tuple[2].b;
+    tb_bool_t ok = !tb_atomic_get(&tuple[2].a);
 
     // copy empty directory?
     if (ok && !tb_file_info(dest, tb_null)) 
@@ -30,6 +30,7 @@
 #include "../file.h"
 #include "../path.h"
 #include "../directory.h"
+#include "../impl/file_offload.h"
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -44,6 +45,9 @@
 #ifdef TB_CONFIG_POSIX_HAVE_SENDFILE
 #   include <sys/sendfile.h>
 #endif
+#ifdef TB_CONFIG_POSIX_HAVE_MMAP
+#   include <sys/mman.h>
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -131,6 +135,12 @@ tb_long_t tb_file_read(tb_file_ref_t file, tb_byte_t* data, tb_size_t size)
     // check
     tb_assert_and_check_return_val(file, -1);
 
+#ifdef TB_FILE_OFFLOAD_ENABLE
+    // offload it to the io workers if be called in coroutine, the regular file cannot be waited by the poller
+    tb_long_t real = -1;
+    if (tb_file_offload_need() && tb_file_offload_done(TB_FILE_OFFLOAD_OP_READ, file, data, size, 0, &real)) return real;
+#endif
+
     // read it
     return read(tb_file2fd(file), data, size);
 }
@@ -139,6 +149,12 @@ tb_long_t tb_file_writ(tb_file_ref_t file, tb_byte_t const* data, tb_size_t size
     // check
     tb_assert_and_check_return_val(file, -1);
 
+#ifdef TB_FILE_OFFLOAD_ENABLE
+    // offload it to the io workers if be called in coroutine
+    tb_long_t real = -1;
+    if (tb_file_offload_need() && tb_file_offload_done(TB_FILE_OFFLOAD_OP_WRIT, file, data, size, 0, &real)) return real;
+#endif
+
     // writ it
     return write(tb_file2fd(file), data, size);
 }
@@ -147,6 +163,12 @@ tb_bool_t tb_file_sync(tb_file_ref_t file)
     // check
     tb_assert_and_check_return_val(file, tb_false);
 
+#ifdef TB_FILE_OFFLOAD_ENABLE
+    // offload it to the io workers if be called in coroutine
+    tb_long_t real = -1;
+    if (tb_file_offload_need() && tb_file_offload_done(TB_FILE_OFFLOAD_OP_SYNC, file, tb_null, 0, 0, &real)) return !real? tb_true : tb_false;
+#endif
+
     // sync
 #ifdef TB_CONFIG_POSIX_HAVE_FDATASYNC
     return !fdatasync(tb_file2fd(file))? tb_true : tb_false;
@@ -236,6 +258,12 @@ tb_long_t tb_file_pread(tb_file_ref_t file, tb_byte_t* data, tb_size_t size, tb_
     // check
     tb_assert_and_check_return_val(file, -1);
 
+#ifdef TB_FILE_OFFLOAD_ENABLE
+    // offload it to the io workers if be called in coroutine
+    tb_long_t real = -1;
+    if (tb_file_offload_need() && tb_file_offload_done(TB_FILE_OFFLOAD_OP_PREAD, file, data, size, offset, &real)) return real;
+#endif
+
     // read it
 #ifdef TB_CONFIG_POSIX_HAVE_PREAD64
     return pread64(tb_file2fd(file), data, (size_t)size, offset);
@@ -248,6 +276,12 @@ tb_long_t tb_file_pwrit(tb_file_ref_t file, tb_byte_t const* data, tb_size_t siz
     // check
     tb_assert_and_check_return_val(file, -1);
 
+#ifdef TB_FILE_OFFLOAD_ENABLE
+    // offload it to the io workers if be called in coroutine
+    tb_long_t real = -1;
+    if (tb_file_offload_need() && tb_file_offload_done(TB_FILE_OFFLOAD_OP_PWRIT, file, data, size, offset, &real)) return real;
+#endif
+
     // writ it
 #ifdef TB_CONFIG_POSIX_HAVE_PWRITE64
     return pwrite64(tb_file2fd(file), data, (size_t)size, offset);
@@ -260,6 +294,12 @@ tb_long_t tb_file_readv(tb_file_ref_t file, tb_iovec_t const* list, tb_size_t si
     // check
     tb_assert_and_check_return_val(file && list && size, -1);
 
+#ifdef TB_FILE_OFFLOAD_ENABLE
+    // offload it to the io workers if be called in coroutine
+    tb_long_t real = -1;
+    if (tb_file_offload_need() && tb_file_offload_done(TB_FILE_OFFLOAD_OP_READV, file, list, size, 0, &real)) return real;
+#endif
+
     // check iovec
     tb_assert_static(sizeof(tb_iovec_t) == sizeof(struct iovec));
     tb_assert(tb_memberof_eq(tb_iovec_t, data, struct iovec, iov_base));
@@ -273,6 +313,12 @@ tb_long_t tb_file_writv(tb_file_ref_t file, tb_iovec_t const* list, tb_size_t si
     // check
     tb_assert_and_check_return_val(file && list && size, -1);
 
+#ifdef TB_FILE_OFFLOAD_ENABLE
+    // offload it to the io workers if be called in coroutine
+    tb_long_t real = -1;
+    if (tb_file_offload_need() && tb_file_offload_done(TB_FILE_OFFLOAD_OP_WRITV, file, list, size, 0, &real)) return real;
+#endif
+
     // check iovec
     tb_assert_static(sizeof(tb_iovec_t) == sizeof(struct iovec));
     tb_assert(tb_memberof_eq(tb_iovec_t, data, struct iovec, iov_base));
@@ -326,6 +372,12 @@ tb_long_t tb_file_preadv(tb_file_ref_t file, tb_iovec_t const* list, tb_size_t s
     // check
     tb_assert_and_check_return_val(file && list && size, -1);
 
+#ifdef TB_FILE_OFFLOAD_ENABLE
+    // offload it to the io workers if be called in coroutine
+    tb_long_t real = -1;
+    if (tb_file_offload_need() && tb_file_offload_done(TB_FILE_OFFLOAD_OP_PREADV, file, list, size, offset, &real)) return real;
+#endif
+
     // check iovec
     tb_assert_static(sizeof(tb_iovec_t) == sizeof(struct iovec));
     tb_assert(tb_memberof_eq(tb_iovec_t, data, struct iovec, iov_base));
@@ -360,6 +412,12 @@ tb_long_t tb_file_pwritv(tb_file_ref_t file, tb_iovec_t const* list, tb_size_t s
     // check
     tb_assert_and_check_return_val(file && list && size, -1);
 
+#ifdef TB_FILE_OFFLOAD_ENABLE
+    // offload it to the io workers if be called in coroutine
+    tb_long_t real = -1;
+    if (tb_file_offload_need() && tb_file_offload_done(TB_FILE_OFFLOAD_OP_PWRITV, file, list, size, offset, &real)) return real;
+#endif
+
     // check iovec
     tb_assert_static(sizeof(tb_iovec_t) == sizeof(struct iovec));
     tb_assert(tb_memberof_eq(tb_iovec_t, data, struct iovec, iov_base));
@@ -583,3 +641,32 @@ tb_bool_t tb_file_link(tb_char_t const* path, tb_char_t const* dest)
     return !symlink(path, dest)? tb_true : tb_false;
 }
 #endif
+tb_pointer_t tb_file_map(tb_file_ref_t file, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(file && size, tb_null);
+
+#ifdef TB_CONFIG_POSIX_HAVE_MMAP
+    // map it
+    tb_pointer_t data = mmap(tb_null, size, PROT_READ, MAP_SHARED, tb_file2fd(file), 0);
+    tb_check_return_val(data != MAP_FAILED, tb_null);
+
+    // ok
+    return data;
+#else
+    tb_trace_noimpl();
+    return tb_null;
+#endif
+}
+tb_bool_t tb_file_unmap(tb_pointer_t data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(data && size, tb_false);
+
+#ifdef TB_CONFIG_POSIX_HAVE_MMAP
+    return !munmap(data, size)? tb_true : tb_false;
+#else
+    tb_trace_noimpl();
+    return tb_false;
+#endif
+}
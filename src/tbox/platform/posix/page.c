@@ -29,6 +29,23 @@
 #include "prefix.h"
 #include "../platform.h"
 #include <unistd.h>
+#ifdef TB_CONFIG_POSIX_HAVE_MMAP
+#   include <sys/mman.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the alignment of the huge pages, the transparent huge pages can be used only for the aligned ranges
+#define TB_PAGE_HUGE_ALIGN          (2 << 20)
+
+// the anonymous map flag
+#if defined(MAP_ANONYMOUS)
+#   define TB_PAGE_MAP_ANONYMOUS    MAP_ANONYMOUS
+#elif defined(MAP_ANON)
+#   define TB_PAGE_MAP_ANONYMOUS    MAP_ANON
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * globals
@@ -62,5 +79,91 @@ tb_size_t tb_page_size()
 {
     return g_page_size;
 }
+#if defined(TB_CONFIG_POSIX_HAVE_MMAP) && defined(TB_PAGE_MAP_ANONYMOUS)
+tb_pointer_t tb_page_map(tb_size_t size, tb_size_t flags)
+{
+    // check
+    tb_assert_and_check_return_val(g_page_size && size, tb_null);
+
+    // align size
+    size = tb_align(size, g_page_size);
+
+    // map the explicit huge pages first
+    tb_pointer_t data = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if ((flags & TB_PAGE_MAP_FLAG_HUGE_EXPLICIT) && !(size & (TB_PAGE_HUGE_ALIGN - 1)))
+        data = mmap(tb_null, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | TB_PAGE_MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (data != MAP_FAILED) return data;
+
+    // map the normal pages
+    if (flags & (TB_PAGE_MAP_FLAG_HUGE | TB_PAGE_MAP_FLAG_HUGE_EXPLICIT))
+    {
+        // map more pages for aligning it by the huge page size
+        tb_size_t   maxn = size + TB_PAGE_HUGE_ALIGN;
+        tb_byte_t*  base = (tb_byte_t*)mmap(tb_null, maxn, PROT_READ | PROT_WRITE, MAP_PRIVATE | TB_PAGE_MAP_ANONYMOUS, -1, 0);
+        tb_check_return_val(base != (tb_byte_t*)MAP_FAILED, tb_null);
+
+        // unmap the unaligned head and tail pages
+        tb_byte_t* head = (tb_byte_t*)tb_align((tb_size_t)base, TB_PAGE_HUGE_ALIGN);
+        if (head > base) munmap(base, head - base);
+        if (head + size < base + maxn) munmap(head + size, (base + maxn) - (head + size));
+        data = (tb_pointer_t)head;
+
+#ifdef MADV_HUGEPAGE
+        // hint the system to back them with the transparent huge pages
+        madvise(data, size, MADV_HUGEPAGE);
+#endif
+    }
+    else data = mmap(tb_null, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | TB_PAGE_MAP_ANONYMOUS, -1, 0);
+
+    // ok?
+    return data != MAP_FAILED? data : tb_null;
+}
+tb_bool_t tb_page_unmap(tb_pointer_t data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(g_page_size && data && size, tb_false);
 
+    // unmap it
+    return !munmap(data, tb_align(size, g_page_size));
+}
+tb_bool_t tb_page_purge(tb_pointer_t data, tb_size_t size, tb_bool_t lazy)
+{
+    // check
+    tb_assert_and_check_return_val(g_page_size && data && !((tb_size_t)data & (g_page_size - 1)), tb_false);
+
+    // no size?
+    size = tb_align(size, g_page_size);
+    tb_check_return_val(size, tb_true);
 
+#ifdef TB_CONFIG_POSIX_HAVE_MADVISE
+    // free them lazily? it may be not supported by the old kernel, fallback to MADV_DONTNEED
+#   ifdef MADV_FREE
+    if (lazy && !madvise(data, size, MADV_FREE)) return tb_true;
+#   endif
+
+    // free them now
+#   ifdef MADV_DONTNEED
+    return !madvise(data, size, MADV_DONTNEED);
+#   else
+    return tb_false;
+#   endif
+#else
+    return tb_false;
+#endif
+}
+#else
+tb_pointer_t tb_page_map(tb_size_t size, tb_size_t flags)
+{
+    return tb_null;
+}
+tb_bool_t tb_page_unmap(tb_pointer_t data, tb_size_t size)
+{
+    return tb_false;
+}
+tb_bool_t tb_page_purge(tb_pointer_t data, tb_size_t size, tb_bool_t lazy)
+{
+    return tb_false;
+}
+#endif
@@ -114,7 +114,7 @@ static tb_void_t tb_poller_hash_set(tb_poller_poll_ref_t poller, tb_socket_ref_t
 
     // the socket fd
     tb_long_t fd = tb_sock2fd(sock);
-    tb_assert(fd > 0 && fd < TB_MAXS32);
+    tb_assert(fd >= 0 && fd < TB_MAXS32);
 
     // not null?
     if (priv)
@@ -154,7 +154,7 @@ static __tb_inline__ tb_cpointer_t tb_poller_hash_get(tb_poller_poll_ref_t polle
 
     // the socket fd
     tb_long_t fd = tb_sock2fd(sock);
-    tb_assert(fd > 0 && fd < TB_MAXS32);
+    tb_assert(fd >= 0 && fd < TB_MAXS32);
 
     // get the user private data
     return fd < poller->hash_size? poller->hash[fd] : tb_null;
@@ -166,7 +166,7 @@ static __tb_inline__ tb_void_t tb_poller_hash_del(tb_poller_poll_ref_t poller, t
 
     // the socket fd
     tb_long_t fd = tb_sock2fd(sock);
-    tb_assert(fd > 0 && fd < TB_MAXS32);
+    tb_assert(fd >= 0 && fd < TB_MAXS32);
 
     // remove the user private data
     if (fd < poller->hash_size) poller->hash[fd] = tb_null;
@@ -40,6 +40,33 @@
 #   include <signal.h>
 #   include <sys/types.h>
 #endif
+#ifdef TB_CONFIG_OS_LINUX
+#   include <poll.h>
+#   include <sys/syscall.h>
+#endif
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+#   include "../../coroutine/coroutine.h"
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/* we can wait the process exit precisely by polling the process fd on linux >= 5.3
+ *
+ * and it will be registered to the io poller of the current coroutine scheduler if be in coroutine
+ */
+#if defined(TB_CONFIG_OS_LINUX) && defined(SYS_pidfd_open)
+#   define TB_PROCESS_HAVE_PIDFD
+#endif
+
+// the maximum count of the process fds for waitlist
+#ifdef __tb_small__
+#   define TB_PROCESS_PIDFD_MAXN        (64)
+#else
+#   define TB_PROCESS_PIDFD_MAXN        (256)
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
@@ -54,6 +81,11 @@ typedef struct __tb_process_t
     // the attributes
     tb_process_attr_t           attr;
 
+#ifdef TB_PROCESS_HAVE_PIDFD
+    // the process fd, it will be -1 if the kernel does not support it
+    tb_int_t                    pidfd;
+#endif
+
 #ifdef TB_CONFIG_POSIX_HAVE_POSIX_SPAWNP
     // the spawn attributes
     posix_spawnattr_t           spawn_attr;
@@ -109,6 +141,112 @@ static tb_int_t tb_process_file_modes(tb_size_t mode)
     // ok?
     return modes;
 }
+static tb_void_t tb_process_pidfd_open(tb_process_t* process)
+{
+#ifdef TB_PROCESS_HAVE_PIDFD
+    // open the process fd, it will fail with ENOSYS on the older kernel
+    process->pidfd = (tb_int_t)syscall(SYS_pidfd_open, process->pid, 0);
+    if (process->pidfd >= 0) fcntl(process->pidfd, F_SETFD, FD_CLOEXEC);
+    else process->pidfd = -1;
+#else
+    tb_used(process);
+#endif
+}
+static tb_long_t tb_process_waitpid(tb_process_t* process, tb_long_t* pstatus, tb_int_t options)
+{
+    // wait it
+    tb_int_t    status = -1;
+    tb_long_t   result = waitpid(process->pid, &status, options);
+    tb_check_return_val(result != -1, -1);
+
+    // not exited?
+    tb_check_return_val(result, 0);
+
+    /* save status, only get 8bits retval
+     *
+     * tt's limited to 8-bits, which means 1 byte, 
+     * which means the int from WEXITSTATUS can only range from 0-255. 
+     *
+     * in fact, any unix program will only ever return a max of 255.
+     */
+    if (pstatus) *pstatus = WIFEXITED(status)? WEXITSTATUS(status) : -1;
+
+    // clear pid
+    process->pid = 0;
+
+    // exited
+    return 1;
+}
+#ifdef TB_PROCESS_HAVE_PIDFD
+static tb_long_t tb_process_waitlist_pidfd(tb_process_ref_t const* processes, tb_process_waitinfo_ref_t infolist, tb_size_t infomaxn, tb_long_t timeout)
+{
+    // init the process fds 
+    struct pollfd   pfds[TB_PROCESS_PIDFD_MAXN];
+    tb_size_t       pfdn = 0;
+    tb_process_t const** pprocess = (tb_process_t const**)processes;
+    for (; *pprocess; pprocess++)
+    {
+        // too many processes or no process fd? we cannot wait them by polling
+        tb_check_return_val(pfdn < tb_arrayn(pfds) && (*pprocess)->pidfd >= 0, -2);
+
+        // the exited processes will not be waited again
+        if ((*pprocess)->pid <= 0) continue;
+
+        // add it
+        pfds[pfdn].fd       = (*pprocess)->pidfd;
+        pfds[pfdn].events   = POLLIN;
+        pfds[pfdn].revents  = 0;
+        pfdn++;
+    }
+    tb_check_return_val(pfdn, 0);
+
+    // done
+    tb_long_t infosize = 0;
+    tb_hong_t time = tb_mclock();
+    while (1)
+    {
+        // reap all exited processes in the given list, we do not reap other children like waitpid(-1)
+        for (pprocess = (tb_process_t const**)processes; *pprocess && infosize < infomaxn; pprocess++)
+        {
+            // exited?
+            tb_process_t* process = (tb_process_t*)*pprocess;
+            tb_check_continue(process->pid > 0);
+
+            // attempt to wait it
+            tb_long_t status = -1;
+            tb_long_t result = tb_process_waitpid(process, &status, WNOHANG | WUNTRACED);
+            tb_check_return_val(result >= 0, -1);
+            if (result > 0)
+            {
+                // save process info
+                infolist[infosize].index    = (tb_process_ref_t const*)pprocess - processes;
+                infolist[infosize].process  = (tb_process_ref_t)process;
+                infolist[infosize].status   = status;
+                infosize++;
+            }
+        }
+
+        // end or timeout?
+        tb_check_break(!infosize && timeout);
+
+        // compute the left timeout
+        tb_long_t left = -1;
+        if (timeout >= 0)
+        {
+            left = timeout - (tb_long_t)(tb_mclock() - time);
+            tb_check_break(left > 0);
+        }
+
+        // wait the process fds until one of them exits 
+        tb_long_t r = poll(pfds, pfdn, left);
+        tb_assert_and_check_return_val(r >= 0 || errno == EINTR, -1);
+        tb_check_break(r);
+    }
+
+    // ok?
+    return infosize;
+}
+#endif
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -127,6 +265,11 @@ tb_process_ref_t tb_process_init(tb_char_t const* pathname, tb_char_t const* arg
         process = tb_malloc0_type(tb_process_t);
         tb_assert_and_check_break(process);
 
+#ifdef TB_PROCESS_HAVE_PIDFD
+        // init the process fd
+        process->pidfd = -1;
+#endif
+
         // init attributes
         if (attr)
         {
@@ -180,6 +323,9 @@ tb_process_ref_t tb_process_init(tb_char_t const* pathname, tb_char_t const* arg
         // check pid
         tb_assert_and_check_break(process->pid > 0);
 
+        // open the process fd for waiting it
+        tb_process_pidfd_open(process);
+
         // ok
         ok = tb_true;
 
@@ -211,6 +357,11 @@ tb_process_ref_t tb_process_init(tb_char_t const* pathname, tb_char_t const* arg
         process = tb_malloc0_type(tb_process_t);
         tb_assert_and_check_break(process);
 
+#ifdef TB_PROCESS_HAVE_PIDFD
+        // init the process fd
+        process->pidfd = -1;
+#endif
+
         // init attributes
         if (attr)
         {
@@ -321,6 +472,9 @@ tb_process_ref_t tb_process_init(tb_char_t const* pathname, tb_char_t const* arg
         // check pid
         tb_assert_and_check_break(process->pid > 0);
 
+        // open the process fd for waiting it
+        tb_process_pidfd_open(process);
+
         // ok
         ok = tb_true;
 
@@ -506,6 +660,12 @@ tb_void_t tb_process_exit(tb_process_ref_t self)
     process->errfd = 0;
 #endif
 
+#ifdef TB_PROCESS_HAVE_PIDFD
+    // close the process fd, it will also cancel the waiting from the coroutine scheduler
+    if (process->pidfd >= 0) tb_socket_exit(tb_fd2sock(process->pidfd));
+    process->pidfd = -1;
+#endif
+
     // exit it
     tb_free(process);
 }
@@ -566,37 +726,34 @@ tb_long_t tb_process_wait(tb_process_ref_t self, tb_long_t* pstatus, tb_long_t t
     tb_process_t* process = (tb_process_t*)self;
     tb_assert_and_check_return_val(process, -1);
 
+#ifdef TB_PROCESS_HAVE_PIDFD
+    // wait the process fd precisely instead of polling it
+    if (process->pidfd >= 0 && process->pid > 0)
+    {
+        // attempt to wait it first
+        tb_long_t ok = tb_process_waitpid(process, pstatus, WNOHANG | WUNTRACED);
+        tb_check_return_val(!ok && timeout, ok);
+
+        /* wait the process fd until it exits
+         *
+         * we will suspend the current coroutine instead of blocking the scheduler if be in coroutine
+         */
+        ok = tb_socket_wait(tb_fd2sock(process->pidfd), TB_SOCKET_EVENT_RECV, timeout);
+        tb_check_return_val(ok > 0, ok);
+
+        // reap it
+        return tb_process_waitpid(process, pstatus, WNOHANG | WUNTRACED);
+    }
+#endif
+
     // done
     tb_long_t ok = 0;
     tb_hong_t time = tb_mclock();
     do
     {
         // wait it
-        tb_int_t    status = -1;
-        tb_long_t   result = waitpid(process->pid, &status, timeout < 0? 0 : WNOHANG | WUNTRACED);
-        tb_check_return_val(result != -1, -1);
-
-        // exited?
-        if (result != 0)
-        {
-            /* save status, only get 8bits retval
-             *
-             * tt's limited to 8-bits, which means 1 byte, 
-             * which means the int from WEXITSTATUS can only range from 0-255. 
-             *
-             * in fact, any unix program will only ever return a max of 255.
-             */
-            if (pstatus) *pstatus = WIFEXITED(status)? WEXITSTATUS(status) : -1;
-
-            // clear pid
-            process->pid = 0;
-
-            // wait ok
-            ok = 1;
-
-            // end
-            break;
-        }
+        ok = tb_process_waitpid(process, pstatus, timeout < 0? 0 : WNOHANG | WUNTRACED);
+        tb_check_break(!ok);
 
         // wait some time
         if (timeout > 0) tb_msleep(tb_min(timeout, 60));
@@ -611,6 +768,20 @@ tb_long_t tb_process_waitlist(tb_process_ref_t const* processes, tb_process_wait
     // check
     tb_assert_and_check_return_val(processes && infolist && infomaxn, -1);
 
+#ifdef TB_PROCESS_HAVE_PIDFD
+    /* wait all process fds precisely by poll() if be not in coroutine, 
+     * otherwise we use tb_msleep() to poll them and it will only suspend the current coroutine
+     */
+#   if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+    if (!tb_coroutine_self())
+#   endif
+    {
+        tb_long_t ok = tb_process_waitlist_pidfd(processes, infolist, infomaxn, timeout);
+        if (ok != -2) return ok;
+    }
+#endif
+
     // done
     tb_long_t infosize = 0;
     tb_hong_t time = tb_mclock();
@@ -37,11 +37,15 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
+#include <netinet/udp.h>
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <errno.h>
 #include <signal.h>
 #include <sys/uio.h>
+#ifdef TB_CONFIG_OS_LINUX
+#   include <linux/filter.h>
+#endif
 #ifdef TB_CONFIG_POSIX_HAVE_SENDFILE
 #   include <sys/sendfile.h>
 #endif
@@ -304,6 +308,156 @@ tb_bool_t tb_socket_ctrl(tb_socket_ref_t sock, tb_size_t ctrl, ...)
             else *pbuff_size = 0;
         }
         break;
+    case TB_SOCKET_CTRL_SET_UDP_GSO:
+        {
+            // the segment size
+            tb_size_t segsize = (tb_size_t)tb_va_arg(args, tb_size_t);
+
+#ifdef UDP_SEGMENT
+            // set the gso segment size, the kernel will split the sent data into the datagrams of this size
+            tb_int_t real = (tb_int_t)segsize;
+            if (!setsockopt(fd, IPPROTO_UDP, UDP_SEGMENT, (tb_char_t*)&real, sizeof(real)))
+            {
+                // ok
+                ok = tb_true;
+            }
+#else
+            tb_used(segsize);
+#endif
+        }
+        break;
+    case TB_SOCKET_CTRL_GET_UDP_GSO:
+        {
+            // the psegsize
+            tb_size_t* psegsize = (tb_size_t*)tb_va_arg(args, tb_size_t*);
+            tb_assert_and_check_return_val(psegsize, tb_false);
+
+            // get the gso segment size
+            *psegsize = 0;
+#ifdef UDP_SEGMENT
+            tb_int_t    real = 0;
+            socklen_t   size = sizeof(real);
+            if (!getsockopt(fd, IPPROTO_UDP, UDP_SEGMENT, (tb_char_t*)&real, &size))
+            {
+                // save it
+                *psegsize = real;
+
+                // ok
+                ok = tb_true;
+            }
+#endif
+        }
+        break;
+    case TB_SOCKET_CTRL_SET_UDP_GRO:
+        {
+            // enable gro?
+            tb_int_t enable = (tb_int_t)tb_va_arg(args, tb_bool_t);
+
+#ifdef UDP_GRO
+            // receive the coalesced datagrams, the segment size will be passed by the control message
+            if (!setsockopt(fd, IPPROTO_UDP, UDP_GRO, (tb_char_t*)&enable, sizeof(enable)))
+            {
+                // ok
+                ok = tb_true;
+            }
+#else
+            tb_used(enable);
+#endif
+        }
+        break;
+    case TB_SOCKET_CTRL_GET_UDP_GRO:
+        {
+            // the penable
+            tb_bool_t* penable = (tb_bool_t*)tb_va_arg(args, tb_bool_t*);
+            tb_assert_and_check_return_val(penable, tb_false);
+
+            // gro is enabled?
+            *penable = tb_false;
+#ifdef UDP_GRO
+            tb_int_t    enable = 0;
+            socklen_t   size = sizeof(enable);
+            if (!getsockopt(fd, IPPROTO_UDP, UDP_GRO, (tb_char_t*)&enable, &size))
+            {
+                // save it
+                *penable = (tb_bool_t)enable;
+
+                // ok
+                ok = tb_true;
+            }
+#endif
+        }
+        break;
+    case TB_SOCKET_CTRL_SET_REUSEPORT:
+        {
+            // enable reuseport?
+            tb_int_t enable = (tb_int_t)tb_va_arg(args, tb_bool_t);
+
+#ifdef SO_REUSEPORT
+            // the multiple sockets can bind the same port and the kernel will balance the connections between them
+            if (!setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, (tb_char_t*)&enable, sizeof(enable)))
+            {
+                // ok
+                ok = tb_true;
+            }
+#else
+            tb_used(enable);
+#endif
+        }
+        break;
+    case TB_SOCKET_CTRL_GET_REUSEPORT:
+        {
+            // the penable
+            tb_bool_t* penable = (tb_bool_t*)tb_va_arg(args, tb_bool_t*);
+            tb_assert_and_check_return_val(penable, tb_false);
+
+            // reuseport is enabled?
+            *penable = tb_false;
+#ifdef SO_REUSEPORT
+            tb_int_t    enable = 0;
+            socklen_t   size = sizeof(enable);
+            if (!getsockopt(fd, SOL_SOCKET, SO_REUSEPORT, (tb_char_t*)&enable, &size))
+            {
+                // save it
+                *penable = (tb_bool_t)enable;
+
+                // ok
+                ok = tb_true;
+            }
+#endif
+        }
+        break;
+    case TB_SOCKET_CTRL_SET_REUSEPORT_CPU:
+        {
+            // the socket count of the reuseport group
+            tb_size_t count = (tb_size_t)tb_va_arg(args, tb_size_t);
+            tb_assert_and_check_break(count);
+
+#if defined(TB_CONFIG_OS_LINUX) && defined(SO_ATTACH_REUSEPORT_CBPF)
+            /* attach the cbpf program to the reuseport group
+             *
+             * A = cpu
+             * A = A % count
+             * return A
+             *
+             * it selects the group socket by the returned index, the first bound socket is 0
+             */
+            struct sock_filter code[] = 
+            {
+                { BPF_LD  | BPF_W   | BPF_ABS,  0, 0, SKF_AD_OFF + SKF_AD_CPU }
+            ,   { BPF_ALU | BPF_MOD | BPF_K,    0, 0, (tb_uint32_t)count     }
+            ,   { BPF_RET | BPF_A,              0, 0, 0                      }
+            };
+            struct sock_fprog prog;
+            prog.len    = (tb_uint16_t)tb_arrayn(code);
+            prog.filter = code;
+            if (!setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, (tb_char_t*)&prog, sizeof(prog)))
+            {
+                // ok
+                ok = tb_true;
+            }
+#endif
+        }
+        break;
     default:
         {
             // trace
@@ -780,3 +934,164 @@ tb_long_t tb_socket_usendv(tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_iovec_
     return -1;
 }
 #endif
+#if defined(TB_CONFIG_POSIX_HAVE_RECVMMSG) && !defined(TB_CONFIG_MICRO_ENABLE)
+tb_long_t tb_socket_urecv_batch(tb_socket_ref_t sock, tb_socket_msg_ref_t msgs, tb_size_t count)
+{
+    // check
+    tb_assert_and_check_return_val(sock && msgs && count, -1);
+
+    // recv messages
+    tb_size_t recv = 0;
+    while (recv < count)
+    {
+        // init the message headers
+        struct mmsghdr          hdrs[TB_SOCKET_BATCH_MAXN];
+        struct sockaddr_storage addrs[TB_SOCKET_BATCH_MAXN];
+#ifdef UDP_GRO
+        union
+        {
+            struct cmsghdr      align;
+            tb_byte_t           data[CMSG_SPACE(sizeof(tb_int_t))];
+
+        }                       ctrls[TB_SOCKET_BATCH_MAXN];
+#endif
+        tb_size_t               i = 0;
+        tb_size_t               n = tb_min(count - recv, TB_SOCKET_BATCH_MAXN);
+        tb_memset(hdrs, 0, n * sizeof(struct mmsghdr));
+        for (i = 0; i < n; i++)
+        {
+            tb_socket_msg_ref_t msg = &msgs[recv + i];
+            struct msghdr*      hdr = &hdrs[i].msg_hdr;
+            hdr->msg_name       = (tb_pointer_t)&addrs[i];
+            hdr->msg_namelen    = sizeof(addrs[i]);
+            hdr->msg_iov        = (struct iovec*)msg->list;
+            hdr->msg_iovlen     = (size_t)msg->size;
+#ifdef UDP_GRO
+            hdr->msg_control    = ctrls[i].data;
+            hdr->msg_controllen = sizeof(ctrls[i].data);
+#endif
+        }
+
+        // recv them
+        tb_long_t r = recvmmsg(tb_sock2fd(sock), hdrs, (tb_uint_t)n, 0, tb_null);
+        if (r < 0)
+        {
+            // continue? or return the received messages first
+            if (errno == EINTR || errno == EAGAIN || recv) break;
+
+            // error
+            return -1;
+        }
+
+        // save the addresses, sizes and segment sizes
+        for (i = 0; i < (tb_size_t)r; i++)
+        {
+            tb_socket_msg_ref_t msg = &msgs[recv + i];
+            tb_sockaddr_save(&msg->addr, &addrs[i]);
+            msg->real       = hdrs[i].msg_len;
+            msg->segsize    = 0;
+#ifdef UDP_GRO
+            struct msghdr*  hdr = &hdrs[i].msg_hdr;
+            struct cmsghdr* cmsg = tb_null;
+            for (cmsg = CMSG_FIRSTHDR(hdr); cmsg; cmsg = CMSG_NXTHDR(hdr, cmsg))
+            {
+                if (cmsg->cmsg_level == IPPROTO_UDP && cmsg->cmsg_type == UDP_GRO)
+                {
+                    tb_int_t segsize = 0;
+                    tb_memcpy(&segsize, CMSG_DATA(cmsg), sizeof(segsize));
+                    msg->segsize = segsize;
+                }
+            }
+#endif
+        }
+        recv += r;
+
+        // no more data?
+        if ((tb_size_t)r < n) break;
+    }
+
+    // ok
+    return recv;
+}
+#endif
+#if defined(TB_CONFIG_POSIX_HAVE_SENDMMSG) && !defined(TB_CONFIG_MICRO_ENABLE)
+tb_long_t tb_socket_usend_batch(tb_socket_ref_t sock, tb_socket_msg_ref_t msgs, tb_size_t count)
+{
+    // check
+    tb_assert_and_check_return_val(sock && msgs && count, -1);
+
+    // send messages
+    tb_size_t sent = 0;
+    while (sent < count)
+    {
+        // init the message headers
+        struct mmsghdr          hdrs[TB_SOCKET_BATCH_MAXN];
+        struct sockaddr_storage addrs[TB_SOCKET_BATCH_MAXN];
+#ifdef UDP_SEGMENT
+        union
+        {
+            struct cmsghdr      align;
+            tb_byte_t           data[CMSG_SPACE(sizeof(tb_uint16_t))];
+
+        }                       ctrls[TB_SOCKET_BATCH_MAXN];
+#endif
+        tb_size_t               i = 0;
+        tb_size_t               n = tb_min(count - sent, TB_SOCKET_BATCH_MAXN);
+        tb_memset(hdrs, 0, n * sizeof(struct mmsghdr));
+        for (i = 0; i < n; i++)
+        {
+            // load the address
+            tb_socket_msg_ref_t msg = &msgs[sent + i];
+            struct msghdr*      hdr = &hdrs[i].msg_hdr;
+            tb_size_t           addrlen = tb_sockaddr_load(&addrs[i], &msg->addr);
+            tb_assert_and_check_return_val(addrlen, -1);
+
+            // init the message header
+            hdr->msg_name       = (tb_pointer_t)&addrs[i];
+            hdr->msg_namelen    = (socklen_t)addrlen;
+            hdr->msg_iov        = (struct iovec*)msg->list;
+            hdr->msg_iovlen     = (size_t)msg->size;
+
+            // split it into the multiple datagrams by the kernel (gso)?
+            if (msg->segsize)
+            {
+#ifdef UDP_SEGMENT
+                tb_uint16_t     segsize = (tb_uint16_t)msg->segsize;
+                hdr->msg_control    = ctrls[i].data;
+                hdr->msg_controllen = sizeof(ctrls[i].data);
+                struct cmsghdr* cmsg = CMSG_FIRSTHDR(hdr);
+                cmsg->cmsg_level    = IPPROTO_UDP;
+                cmsg->cmsg_type     = UDP_SEGMENT;
+                cmsg->cmsg_len      = CMSG_LEN(sizeof(segsize));
+                tb_memcpy(CMSG_DATA(cmsg), &segsize, sizeof(segsize));
+#else
+                // gso is not supported
+                tb_trace_e("udp gso is not supported!");
+                return -1;
+#endif
+            }
+        }
+
+        // send them
+        tb_long_t r = sendmmsg(tb_sock2fd(sock), hdrs, (tb_uint_t)n, 0);
+        if (r < 0)
+        {
+            // continue? or return the sent messages first
+            if (errno == EINTR || errno == EAGAIN || sent) break;
+
+            // error
+            return -1;
+        }
+
+        // save the sent sizes
+        for (i = 0; i < (tb_size_t)r; i++) msgs[sent + i].real = hdrs[i].msg_len;
+        sent += r;
+
+        // no more space?
+        if ((tb_size_t)r < n) break;
+    }
+
+    // ok
+    return sent;
+}
+#endif
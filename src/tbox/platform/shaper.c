@@ -0,0 +1,211 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ *
+ * @author      ruki
+ * @file        shaper.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "shaper"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "shaper.h"
+#include "time.h"
+#include "spinlock.h"
+#include "../memory/memory.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the maximum refilling interval (us), avoid to overflow the tokens after idling for a long time
+#define TB_SHAPER_REFILL_MAXN               (60000000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the shaper type
+typedef struct __tb_shaper_t
+{
+    // the parent shaper
+    struct __tb_shaper_t*   parent;
+
+    // the lock
+    tb_spinlock_t           lock;
+
+    // the rate, bytes/s
+    tb_size_t               rate;
+
+    // the bucket size
+    tb_size_t               burst;
+
+    // the tokens, it will be negative if the tokens have been overdrawn
+    tb_hong_t               tokens;
+
+    // the last refilling time, us
+    tb_hong_t               time;
+
+}tb_shaper_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_shaper_refill(tb_shaper_t* shaper, tb_hong_t now)
+{
+    // the elapsed time
+    tb_hong_t elapsed = now - shaper->time;
+    tb_check_return(elapsed > 0);
+
+    // it has been idle for a long time? the bucket must be full
+    if (elapsed > TB_SHAPER_REFILL_MAXN)
+    {
+        shaper->tokens  = (tb_hong_t)shaper->burst;
+        shaper->time    = now;
+        return ;
+    }
+
+    // refill the tokens of the elapsed time
+    tb_hong_t tokens = elapsed * (tb_hong_t)shaper->rate / 1000000;
+    tb_check_return(tokens > 0);
+    shaper->tokens += tokens;
+    if (shaper->tokens >= (tb_hong_t)shaper->burst)
+    {
+        shaper->tokens  = (tb_hong_t)shaper->burst;
+        shaper->time    = now;
+    }
+    // we only move the time forward by the refilled tokens, so the remainder of the small interval will not be lost
+    else shaper->time += tokens * 1000000 / (tb_hong_t)shaper->rate;
+}
+static tb_size_t tb_shaper_burst(tb_size_t rate, tb_size_t burst)
+{
+    // the default bucket can be filled in 100ms, it is small enough for smoothing the traffic
+    if (!burst) burst = rate / 10;
+    return tb_max(burst, 1);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_shaper_ref_t tb_shaper_init(tb_size_t rate, tb_size_t burst, tb_shaper_ref_t parent)
+{
+    // make shaper
+    tb_shaper_t* shaper = tb_malloc0_type(tb_shaper_t);
+    tb_assert_and_check_return_val(shaper, tb_null);
+
+    // init shaper, the bucket is full at first
+    tb_spinlock_init(&shaper->lock);
+    shaper->parent  = (tb_shaper_t*)parent;
+    shaper->rate    = rate;
+    shaper->burst   = tb_shaper_burst(rate, burst);
+    shaper->tokens  = (tb_hong_t)shaper->burst;
+    shaper->time    = tb_uclock();
+    return (tb_shaper_ref_t)shaper;
+}
+tb_void_t tb_shaper_exit(tb_shaper_ref_t self)
+{
+    // check
+    tb_shaper_t* shaper = (tb_shaper_t*)self;
+    tb_assert_and_check_return(shaper);
+
+    // exit it
+    tb_spinlock_exit(&shaper->lock);
+    tb_free(shaper);
+}
+tb_void_t tb_shaper_rate_set(tb_shaper_ref_t self, tb_size_t rate, tb_size_t burst)
+{
+    // check
+    tb_shaper_t* shaper = (tb_shaper_t*)self;
+    tb_assert_and_check_return(shaper);
+
+    // refill the tokens with the old rate and update it
+    tb_spinlock_enter(&shaper->lock);
+    tb_shaper_refill(shaper, tb_uclock());
+    shaper->rate    = rate;
+    shaper->burst   = tb_shaper_burst(rate, burst);
+    if (shaper->tokens > (tb_hong_t)shaper->burst) shaper->tokens = (tb_hong_t)shaper->burst;
+    tb_spinlock_leave(&shaper->lock);
+}
+tb_size_t tb_shaper_rate(tb_shaper_ref_t self)
+{
+    // check
+    tb_shaper_t* shaper = (tb_shaper_t*)self;
+    tb_assert_and_check_return_val(shaper, 0);
+
+    return shaper->rate;
+}
+tb_size_t tb_shaper_quota(tb_shaper_ref_t self, tb_size_t size)
+{
+    // clip it by the burst size of all limited shapers
+    tb_shaper_t* shaper = (tb_shaper_t*)self;
+    for (; shaper; shaper = shaper->parent)
+    {
+        if (shaper->rate && size > shaper->burst) size = shaper->burst;
+    }
+    return size;
+}
+tb_long_t tb_shaper_take(tb_shaper_ref_t self, tb_size_t size)
+{
+    // take tokens from all shapers and we need wait the longest delay
+    tb_hong_t       now = tb_uclock();
+    tb_hong_t       delay = 0;
+    tb_shaper_t*    shaper = (tb_shaper_t*)self;
+    for (; shaper; shaper = shaper->parent)
+    {
+        // enter
+        tb_spinlock_enter(&shaper->lock);
+
+        // take it
+        if (shaper->rate)
+        {
+            tb_shaper_refill(shaper, now);
+            shaper->tokens -= size;
+
+            // the overdrawn tokens need be refilled before the next data
+            if (shaper->tokens < 0)
+            {
+                tb_hong_t wait = -shaper->tokens * 1000000 / (tb_hong_t)shaper->rate;
+                if (wait > delay) delay = wait;
+            }
+        }
+
+        // leave
+        tb_spinlock_leave(&shaper->lock);
+    }
+
+    /* the delay less than 1ms will be ignored, 
+     * but the overdrawn tokens will be kept and delay the next data
+     */
+    return (tb_long_t)(delay / 1000);
+}
+tb_void_t tb_shaper_wait(tb_shaper_ref_t shaper, tb_size_t size)
+{
+    // take it and sleep, tb_msleep will only suspend the current coroutine
+    tb_long_t delay = tb_shaper_take(shaper, size);
+    if (delay > 0) tb_msleep(delay);
+}
@@ -0,0 +1,135 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ *
+ * @author      ruki
+ * @file        shaper.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_SHAPER_H
+#define TB_PLATFORM_SHAPER_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the shaper ref type
+typedef __tb_typeref__(shaper);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the token bucket shaper
+ *
+ * the shaper can be shared by many streams, sockets and threads, 
+ * and it can be linked to the parent shaper for the global, per-host and per-tenant limits.
+ *
+ * @code
+    // the global limit: 10MB/s, and each tenant: 2MB/s
+    tb_shaper_ref_t global = tb_shaper_init(10 << 20, 0, tb_null);
+    tb_shaper_ref_t tenant = tb_shaper_init(2 << 20, 0, global);
+
+    // shape the stream of this tenant
+    tb_stream_ctrl(stream, TB_STREAM_CTRL_SET_SHAPER, tenant);
+
+    // or shape the socket directly
+    tb_long_t real = tb_socket_send(sock, data, tb_shaper_quota(tenant, size));
+    if (real > 0) tb_shaper_wait(tenant, real);
+ * @endcode
+ *
+ * @param rate      the rate, bytes/s, no limit: 0
+ * @param burst     the bucket size, it will be rate / 10 if be zero
+ * @param parent    the parent shaper, optional
+ *
+ * @return          the shaper
+ */
+tb_shaper_ref_t     tb_shaper_init(tb_size_t rate, tb_size_t burst, tb_shaper_ref_t parent);
+
+/*! exit the shaper, the parent shaper must be exited after all children
+ *
+ * @param shaper    the shaper
+ */
+tb_void_t           tb_shaper_exit(tb_shaper_ref_t shaper);
+
+/*! set the rate and the burst size
+ *
+ * @param shaper    the shaper
+ * @param rate      the rate, bytes/s, no limit: 0
+ * @param burst     the bucket size, it will be rate / 10 if be zero
+ */
+tb_void_t           tb_shaper_rate_set(tb_shaper_ref_t shaper, tb_size_t rate, tb_size_t burst);
+
+/*! get the rate
+ *
+ * @param shaper    the shaper
+ *
+ * @return          the rate, bytes/s
+ */
+tb_size_t           tb_shaper_rate(tb_shaper_ref_t shaper);
+
+/*! get the maximum size which can be sent or received at once
+ *
+ * it will be clipped by the burst size of the shaper and all parents for smoothing the traffic
+ *
+ * @param shaper    the shaper
+ * @param size      the need size
+ *
+ * @return          the clipped size
+ */
+tb_size_t           tb_shaper_quota(tb_shaper_ref_t shaper, tb_size_t size);
+
+/*! take the tokens of the transferred data, it will not block
+ *
+ * the tokens may be overdrawn, and the next data need wait the returned delay
+ *
+ * @param shaper    the shaper
+ * @param size      the transferred size
+ *
+ * @return          the delay for the next data, ms
+ */
+tb_long_t           tb_shaper_take(tb_shaper_ref_t shaper, tb_size_t size);
+
+/*! take the tokens of the transferred data and wait the delay
+ *
+ * only the current coroutine will be suspended if it is called in the coroutine
+ *
+ * @param shaper    the shaper
+ * @param size      the transferred size
+ */
+tb_void_t           tb_shaper_wait(tb_shaper_ref_t shaper, tb_size_t size);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -159,3 +159,103 @@ tb_long_t tb_socket_wait(tb_socket_ref_t sock, tb_size_t events, tb_long_t timeo
     return -1;
 }
 #endif
+
+#if !defined(TB_CONFIG_POSIX_HAVE_RECVMMSG) || defined(TB_CONFIG_MICRO_ENABLE) || defined(TB_CONFIG_OS_WINDOWS)
+tb_long_t tb_socket_urecv_batch(tb_socket_ref_t sock, tb_socket_msg_ref_t msgs, tb_size_t count)
+{
+    // check
+    tb_assert_and_check_return_val(sock && msgs && count, -1);
+
+    // recv messages one by one
+    tb_size_t recv = 0;
+    for (recv = 0; recv < count; recv++)
+    {
+        // recv it
+        tb_socket_msg_ref_t msg = &msgs[recv];
+        tb_long_t           real = tb_socket_urecvv(sock, &msg->addr, msg->list, msg->size);
+
+        // no data? or return the received messages first if failed
+        if (real <= 0) return (!real || recv)? (tb_long_t)recv : -1;
+
+        // save it
+        msg->real       = real;
+        msg->segsize    = 0;
+    }
+
+    // ok
+    return recv;
+}
+#endif
+
+#if !defined(TB_CONFIG_POSIX_HAVE_SENDMMSG) || defined(TB_CONFIG_MICRO_ENABLE) || defined(TB_CONFIG_OS_WINDOWS)
+tb_long_t tb_socket_usend_batch(tb_socket_ref_t sock, tb_socket_msg_ref_t msgs, tb_size_t count)
+{
+    // check
+    tb_assert_and_check_return_val(sock && msgs && count, -1);
+
+    // send messages one by one
+    tb_size_t sent = 0;
+    for (sent = 0; sent < count; sent++)
+    {
+        // gso is not supported
+        tb_socket_msg_ref_t msg = &msgs[sent];
+        tb_assertf_and_check_return_val(!msg->segsize, -1, "udp gso is not supported!");
+
+        // send it
+        tb_long_t real = tb_socket_usendv(sock, &msg->addr, msg->list, msg->size);
+
+        // no space? or return the sent messages first if failed
+        if (real <= 0) return (!real || sent)? (tb_long_t)sent : -1;
+
+        // save it
+        msg->real = real;
+    }
+
+    // ok
+    return sent;
+}
+#endif
+
+tb_long_t tb_socket_urecv_batch_wait(tb_socket_ref_t sock, tb_socket_msg_ref_t msgs, tb_size_t count, tb_long_t timeout)
+{
+    // recv messages
+    tb_long_t recv = 0;
+    while (!(recv = tb_socket_urecv_batch(sock, msgs, count)))
+    {
+        // wait it, it will be suspended if we are in the coroutine
+        tb_long_t wait = tb_socket_wait(sock, TB_SOCKET_EVENT_RECV, timeout);
+
+        // timeout or failed?
+        tb_check_return_val(wait > 0, wait);
+    }
+
+    // ok?
+    return recv;
+}
+tb_long_t tb_socket_usend_batch_wait(tb_socket_ref_t sock, tb_socket_msg_ref_t msgs, tb_size_t count, tb_long_t timeout)
+{
+    // send all messages
+    tb_size_t sent = 0;
+    while (sent < count)
+    {
+        // send them
+        tb_long_t real = tb_socket_usend_batch(sock, msgs + sent, count - sent);
+        if (real > 0) 
+        {
+            sent += real;
+            continue;
+        }
+
+        // failed? 
+        if (real < 0) return sent? (tb_long_t)sent : -1;
+
+        // wait it, it will be suspended if we are in the coroutine
+        tb_long_t wait = tb_socket_wait(sock, TB_SOCKET_EVENT_SEND, timeout);
+
+        // timeout or failed?
+        if (wait <= 0) return (sent || !wait)? (tb_long_t)sent : -1;
+    }
+
+    // ok
+    return sent;
+}
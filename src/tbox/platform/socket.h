@@ -37,6 +37,17 @@
  */
 __tb_extern_c_enter__
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/// the maximum message count of the batched udp io per system call
+#ifdef __tb_small__
+#   define TB_SOCKET_BATCH_MAXN                 (8)
+#else
+#   define TB_SOCKET_BATCH_MAXN                 (16)
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -92,6 +103,13 @@ typedef enum __tb_socket_ctrl_e
 ,   TB_SOCKET_CTRL_GET_SEND_BUFF_SIZE   = 5
 ,   TB_SOCKET_CTRL_SET_TCP_NODELAY      = 6
 ,   TB_SOCKET_CTRL_GET_TCP_NODELAY      = 7
+,   TB_SOCKET_CTRL_SET_UDP_GSO          = 8     //!< set the udp gso segment size, disable it if be zero
+,   TB_SOCKET_CTRL_GET_UDP_GSO          = 9
+,   TB_SOCKET_CTRL_SET_UDP_GRO          = 10    //!< enable or disable to receive the coalesced udp datagrams
+,   TB_SOCKET_CTRL_GET_UDP_GRO          = 11
+,   TB_SOCKET_CTRL_SET_REUSEPORT        = 12    //!< enable or disable SO_REUSEPORT, it must be set before binding
+,   TB_SOCKET_CTRL_GET_REUSEPORT        = 13
+,   TB_SOCKET_CTRL_SET_REUSEPORT_CPU    = 14    //!< steer the new connections to the group socket of the current cpu index modulo the given socket count
 
 }tb_socket_ctrl_e;
 
@@ -107,6 +125,30 @@ typedef enum __tb_socket_event_e
 
 }tb_socket_event_e;
 
+/// the socket message type for the batched udp io
+typedef struct __tb_socket_msg_t
+{
+    /// the peer address, it will be saved after receiving and must be given for sending
+    tb_ipaddr_t                         addr;
+
+    /// the iovec list
+    tb_iovec_t const*                   list;
+
+    /// the iovec count
+    tb_size_t                           size;
+
+    /// the real size after receiving or sending
+    tb_size_t                           real;
+
+    /*! the udp segment size
+     *
+     * send: the kernel will split the data into the datagrams of this size if be not zero (gso)
+     * recv: the datagram size of the coalesced data if the socket enables gro, otherwise zero
+     */
+    tb_size_t                           segsize;
+
+}tb_socket_msg_t, *tb_socket_msg_ref_t;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -296,6 +338,56 @@ tb_long_t           tb_socket_urecvv(tb_socket_ref_t sock, tb_ipaddr_ref_t addr,
  */
 tb_long_t           tb_socket_usendv(tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_iovec_t const* list, tb_size_t size);
 
+/*! recv the multiple datagrams for udp
+ *
+ * it will recv them using only one system call per TB_SOCKET_BATCH_MAXN messages if recvmmsg() is supported
+ *
+ * @param sock          the sock
+ * @param msgs          the messages, the addr, real and segsize fields will be saved
+ * @param count         the message count
+ *
+ * @return              the received message count, no data: 0, failed: -1
+ */
+tb_long_t           tb_socket_urecv_batch(tb_socket_ref_t sock, tb_socket_msg_ref_t msgs, tb_size_t count);
+
+/*! send the multiple datagrams for udp
+ *
+ * it will send them using only one system call per TB_SOCKET_BATCH_MAXN messages if sendmmsg() is supported
+ *
+ * @param sock          the sock
+ * @param msgs          the messages, the real field will be saved
+ * @param count         the message count
+ *
+ * @return              the sent message count, no space: 0, failed: -1
+ */
+tb_long_t           tb_socket_usend_batch(tb_socket_ref_t sock, tb_socket_msg_ref_t msgs, tb_size_t count);
+
+/*! recv the multiple datagrams for udp and wait them if no data
+ *
+ * it will wait the socket in the coroutine if be called in the coroutine, @see tb_socket_wait
+ *
+ * @param sock          the sock
+ * @param msgs          the messages
+ * @param count         the message count
+ * @param timeout       the timeout, infinity: -1
+ *
+ * @return              the received message count, timeout: 0, failed: -1
+ */
+tb_long_t           tb_socket_urecv_batch_wait(tb_socket_ref_t sock, tb_socket_msg_ref_t msgs, tb_size_t count, tb_long_t timeout);
+
+/*! send all datagrams for udp and wait the socket if no space
+ *
+ * it will wait the socket in the coroutine if be called in the coroutine, @see tb_socket_wait
+ *
+ * @param sock          the sock
+ * @param msgs          the messages
+ * @param count         the message count
+ * @param timeout       the timeout of every waiting, infinity: -1
+ *
+ * @return              the sent message count, it will be less than count if timeout, failed: -1
+ */
+tb_long_t           tb_socket_usend_batch_wait(tb_socket_ref_t sock, tb_socket_msg_ref_t msgs, tb_size_t count, tb_long_t timeout);
+
 /*! wait socket events
  *
  * @param sock      the sock 
@@ -646,18 +646,8 @@ static tb_bool_t tb_thread_pool_jobs_walk_dump_all(tb_pointer_t item, tb_cpointe
     tb_thread_pool_job_t* job = (tb_thread_pool_job_t*)item;
     tb_assert_and_check_return_val(job, tb_false);
 
-    // the state string
-    static tb_char_t const* s_state_cstr[] = 
-    {
-        "waiting"
-    ,   "working"
-    ,   "killed"
-    ,   "finished"
-    };
-    tb_assert_and_check_return_val(job->state < tb_arrayn(s_state_cstr), tb_false);
-
     // trace
-    tb_trace_d("    task[%p:%s]: refn: %lu, state: %s", job->task.done, job->task.name, job->refn, s_state_cstr[job->state]);
+    tb_trace_d("    task[%p:%s]: refn: %lu, state: %s", job->task.done, job->task.name, job->refn, tb_state_cstr(tb_atomic_get(&job->state)));
 
     // ok
     return tb_true;
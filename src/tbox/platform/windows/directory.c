@@ -310,6 +310,21 @@ tb_void_t tb_directory_walk(tb_char_t const* path, tb_bool_t recursion, tb_bool_
             tb_directory_walk_impl(full_w, recursion, prefix, func, priv);
     }
 }
+tb_bool_t tb_directory_walk_parallel(tb_char_t const* path, tb_size_t flags, tb_size_t workers, tb_directory_walk_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(path && func, tb_false);
+
+    // TODO walk it in parallel, we only walk it serially now
+    tb_used(workers);
+
+    // the absolute path (translate "~/")
+    tb_wchar_t full_w[TB_PATH_MAXN];
+    tb_check_return_val(tb_path_absolute_w(path, full_w, TB_PATH_MAXN), tb_false);
+
+    // walk it
+    return tb_directory_walk_impl(full_w, (flags & TB_DIRECTORY_WALK_FLAG_RECURSION)? tb_true : tb_false, (flags & TB_DIRECTORY_WALK_FLAG_PREFIX)? tb_true : tb_false, func, priv);
+}
 tb_bool_t tb_directory_copy(tb_char_t const* path, tb_char_t const* dest)
 {
     // the absolute path
@@ -518,3 +518,27 @@ tb_bool_t tb_file_link(tb_char_t const* path, tb_char_t const* dest)
     return tb_false;
 #endif
 }
+tb_pointer_t tb_file_map(tb_file_ref_t file, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(file && size, tb_null);
+
+    // init the file mapping
+    HANDLE mapping = CreateFileMappingW((HANDLE)file, tb_null, PAGE_READONLY, 0, 0, tb_null);
+    tb_check_return_val(mapping, tb_null);
+
+    // map it, the view will keep the mapping alive
+    tb_pointer_t data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+    CloseHandle(mapping);
+
+    // ok?
+    return data;
+}
+tb_bool_t tb_file_unmap(tb_pointer_t data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(data, tb_false);
+
+    // unmap it
+    return UnmapViewOfFile(data)? tb_true : tb_false;
+}
@@ -59,5 +59,47 @@ tb_size_t tb_page_size()
 {
     return g_page_size;
 }
+tb_pointer_t tb_page_map(tb_size_t size, tb_size_t flags)
+{
+    // check
+    tb_assert_and_check_return_val(g_page_size && size, tb_null);
+
+    // align size
+    size = tb_align(size, g_page_size);
+
+    // map the large pages first, it need the SeLockMemoryPrivilege
+    tb_pointer_t data = tb_null;
+#ifdef MEM_LARGE_PAGES
+    tb_size_t large_size = (flags & TB_PAGE_MAP_FLAG_HUGE_EXPLICIT)? (tb_size_t)GetLargePageMinimum() : 0;
+    if (large_size && !(size & (large_size - 1)))
+        data = VirtualAlloc(tb_null, (SIZE_T)size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+#endif
 
+    // map the normal pages, windows has no transparent huge pages
+    if (!data) data = VirtualAlloc(tb_null, (SIZE_T)size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    return data;
+}
+tb_bool_t tb_page_unmap(tb_pointer_t data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(data, tb_false);
 
+    // unmap it
+    return VirtualFree(data, 0, MEM_RELEASE)? tb_true : tb_false;
+}
+tb_bool_t tb_page_purge(tb_pointer_t data, tb_size_t size, tb_bool_t lazy)
+{
+    // check
+    tb_assert_and_check_return_val(g_page_size && data && !((tb_size_t)data & (g_page_size - 1)), tb_false);
+
+    // no size?
+    size = tb_align(size, g_page_size);
+    tb_check_return_val(size, tb_true);
+
+    // reset them lazily? the content will be discarded only under memory pressure
+    if (lazy) return VirtualAlloc(data, (SIZE_T)size, MEM_RESET, PAGE_READWRITE)? tb_true : tb_false;
+
+    // decommit and commit them again, the pages will be zero-filled on next access
+    if (!VirtualFree(data, (SIZE_T)size, MEM_DECOMMIT)) return tb_false;
+    return VirtualAlloc(data, (SIZE_T)size, MEM_COMMIT, PAGE_READWRITE)? tb_true : tb_false;
+}
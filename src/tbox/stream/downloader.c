@@ -0,0 +1,949 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ *
+ * @author      ruki
+ * @file        downloader.c
+ * @ingroup     stream
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "downloader"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "downloader.h"
+#include "../network/network.h"
+#include "../libc/libc.h"
+#include "../utils/utils.h"
+#include "../platform/platform.h"
+#include "../container/container.h"
+#include "../algorithm/algorithm.h"
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+#   include "../coroutine/coroutine.h"
+#   define TB_DOWNLOADER_ENABLE
+#endif
+
+#ifdef TB_DOWNLOADER_ENABLE
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default connections
+#define TB_DOWNLOADER_CONNECTIONS           (16)
+#define TB_DOWNLOADER_HOST_CONNECTIONS      (8)
+#define TB_DOWNLOADER_TASK_CONNECTIONS      (4)
+
+// the default segment size
+#define TB_DOWNLOADER_SEGMENT_SIZE          (4 << 20)
+
+// the read block size
+#ifdef __tb_small__
+#   define TB_DOWNLOADER_BLOCK_SIZE         (16384)
+#else
+#   define TB_DOWNLOADER_BLOCK_SIZE         (65536)
+#endif
+
+// the coroutine stack size, the http connection need a larger stack
+#ifdef __tb_small__
+#   define TB_DOWNLOADER_STACKSIZE          (8192 << 3)
+#else
+#   define TB_DOWNLOADER_STACKSIZE          (8192 << 4)
+#endif
+
+// the maximum retry count of one segment
+#define TB_DOWNLOADER_RETRY_MAXN            (3)
+
+// the progress will be saved after downloading this size of the segment
+#define TB_DOWNLOADER_SAVE_STEP             (1 << 20)
+
+// the progress file suffix
+#define TB_DOWNLOADER_META_SUFFIX           ".tbdl"
+
+// the wait slice (ms) of reading data, the killed state will be checked between the slices
+#define TB_DOWNLOADER_WAIT_SLICE            (1000)
+
+/* the progress file head
+ *
+ * magic:       u32, "TBDL"
+ * version:     u32
+ * size:        u64, the file size
+ * segsize:     u64, the segment size
+ * count:       u64, the segment count
+ * validator:   char x 256, the strong etag or last-modified of the remote file, zero-terminated
+ * ...
+ * done:        u64 x count, the downloaded size of each segment
+ */
+#define TB_DOWNLOADER_META_MAGIC            (0x4c444254)
+#define TB_DOWNLOADER_META_VERSION          (2)
+#define TB_DOWNLOADER_META_VALIDATOR_SIZE   (256)
+#define TB_DOWNLOADER_META_HEAD_SIZE        (32 + TB_DOWNLOADER_META_VALIDATOR_SIZE)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the downloader type
+typedef struct __tb_downloader_t
+{
+    // the option
+    tb_downloader_option_t      option;
+
+    // the tasks
+    tb_list_entry_head_t        tasks;
+
+    // the host semaphores, host => tb_co_semaphore_ref_t
+    tb_hash_map_ref_t           hosts;
+
+    // the semaphore of all connections
+    tb_co_semaphore_ref_t       connections;
+
+    // is killed?
+    tb_atomic_t                 killed;
+
+    // is running?
+    tb_bool_t                   running;
+
+    // the shaper of all tasks
+    tb_shaper_ref_t             shaper;
+
+}tb_downloader_t;
+
+// the downloader task type
+typedef struct __tb_downloader_task_t
+{
+    // the list entry
+    tb_list_entry_t             entry;
+
+    // the downloader
+    tb_downloader_t*            downloader;
+
+    // the url
+    tb_char_t const*            url;
+
+    // the file path
+    tb_char_t const*            path;
+
+    // the func
+    tb_downloader_func_t        func;
+
+    // the func private data
+    tb_cpointer_t               priv;
+
+    // the host semaphore
+    tb_co_semaphore_ref_t       host;
+
+    // the semaphore for waiting the workers
+    tb_co_semaphore_ref_t       finished;
+
+    // the file
+    tb_file_ref_t               file;
+
+    // the progress file
+    tb_file_ref_t               meta;
+
+    // the file size, -1 if unknown
+    tb_hong_t                   size;
+
+    // the segment size
+    tb_hize_t                   segsize;
+
+    // the segment count
+    tb_size_t                   count;
+
+    // the downloaded size of each segment
+    tb_hize_t*                  done;
+
+    // the saved size of each segment in the progress file
+    tb_hize_t*                  saved;
+
+    // the next segment index
+    tb_size_t                   next;
+
+    // the running workers, not including the task coroutine
+    tb_size_t                   workers;
+
+    // the downloaded size in this time
+    tb_hize_t                   save;
+
+    // the state
+    tb_size_t                   state;
+
+    // the validator of the remote file for resuming it, the strong etag or last-modified, empty if unknown
+    tb_char_t                   validator[TB_DOWNLOADER_META_VALIDATOR_SIZE];
+
+}tb_downloader_task_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_downloader_host_exit(tb_element_ref_t element, tb_pointer_t buff)
+{
+    tb_co_semaphore_ref_t semaphore = buff? *((tb_co_semaphore_ref_t*)buff) : tb_null;
+    if (semaphore) tb_co_semaphore_exit(semaphore);
+}
+static tb_bool_t tb_downloader_killed(tb_downloader_t* downloader)
+{
+    return tb_atomic_get(&downloader->killed)? tb_true : tb_false;
+}
+static tb_hize_t tb_downloader_task_segment_size(tb_downloader_task_t* task, tb_size_t index)
+{
+    tb_hize_t offset = task->segsize * index;
+    return tb_min(task->segsize, (tb_hize_t)task->size - offset);
+}
+static tb_char_t const* tb_downloader_task_validator(tb_http_ref_t http)
+{
+    // the weak etag cannot be used for the range request, so we use the last-modified for it
+    tb_char_t const* etag = tb_http_response_header(http, "ETag");
+    if (etag && tb_strnicmp(etag, "W/", 2)) return etag;
+    return tb_http_response_header(http, "Last-Modified");
+}
+static tb_bool_t tb_downloader_task_layout(tb_downloader_task_t* task, tb_hong_t size, tb_hize_t segsize)
+{
+    // check
+    tb_assert_and_check_return_val(size > 0 && segsize, tb_false);
+
+    // init the segments
+    tb_size_t count = (tb_size_t)(((tb_hize_t)size + segsize - 1) / segsize);
+    task->done = (tb_hize_t*)tb_ralloc(task->done, (count << 1) * sizeof(tb_hize_t));
+    tb_assert_and_check_return_val(task->done, tb_false);
+    tb_memset(task->done, 0, (count << 1) * sizeof(tb_hize_t));
+
+    // init layout
+    task->saved     = task->done + count;
+    task->size      = size;
+    task->segsize   = segsize;
+    task->count     = count;
+    task->next      = 0;
+    return tb_true;
+}
+static tb_bool_t tb_downloader_task_meta_save(tb_downloader_task_t* task, tb_size_t index)
+{
+    // save the progress of this segment
+    tb_byte_t data[8];
+    tb_bits_set_u64_le(data, task->done[index]);
+    if (tb_file_pwrit(task->meta, data, sizeof(data), TB_DOWNLOADER_META_HEAD_SIZE + (tb_hize_t)index * 8) != sizeof(data)) return tb_false;
+    task->saved[index] = task->done[index];
+    return tb_true;
+}
+static tb_bool_t tb_downloader_task_meta_init(tb_downloader_task_t* task)
+{
+    // init path
+    tb_char_t path[TB_PATH_MAXN];
+    tb_long_t size = tb_snprintf(path, sizeof(path), "%s" TB_DOWNLOADER_META_SUFFIX, task->path);
+    tb_assert_and_check_return_val(size > 0 && size < sizeof(path), tb_false);
+
+    // init meta file
+    task->meta = tb_file_init(path, TB_FILE_MODE_RW | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC);
+    tb_assert_and_check_return_val(task->meta, tb_false);
+
+    // save the head
+    tb_byte_t head[TB_DOWNLOADER_META_HEAD_SIZE];
+    tb_bits_set_u32_le(head, TB_DOWNLOADER_META_MAGIC);
+    tb_bits_set_u32_le(head + 4, TB_DOWNLOADER_META_VERSION);
+    tb_bits_set_u64_le(head + 8, (tb_uint64_t)task->size);
+    tb_bits_set_u64_le(head + 16, task->segsize);
+    tb_bits_set_u64_le(head + 24, task->count);
+    tb_memset(head + 32, 0, TB_DOWNLOADER_META_VALIDATOR_SIZE);
+    tb_strlcpy((tb_char_t*)head + 32, task->validator, TB_DOWNLOADER_META_VALIDATOR_SIZE);
+    if (tb_file_writ(task->meta, head, sizeof(head)) != sizeof(head)) return tb_false;
+
+    // save the progress of all segments
+    tb_size_t i = 0;
+    for (i = 0; i < task->count; i++)
+    {
+        if (!tb_downloader_task_meta_save(task, i)) return tb_false;
+    }
+    return tb_true;
+}
+static tb_bool_t tb_downloader_task_meta_load(tb_downloader_task_t* task)
+{
+    // init path
+    tb_char_t path[TB_PATH_MAXN];
+    tb_long_t size = tb_snprintf(path, sizeof(path), "%s" TB_DOWNLOADER_META_SUFFIX, task->path);
+    tb_assert_and_check_return_val(size > 0 && size < sizeof(path), tb_false);
+
+    // no progress file?
+    tb_check_return_val(tb_file_info(path, tb_null), tb_false);
+
+    // done
+    tb_bool_t ok = tb_false;
+    tb_byte_t* data = tb_null;
+    do
+    {
+        // open it
+        task->meta = tb_file_init(path, TB_FILE_MODE_RW);
+        tb_check_break(task->meta);
+
+        // load the head
+        tb_byte_t head[TB_DOWNLOADER_META_HEAD_SIZE];
+        if (tb_file_pread(task->meta, head, sizeof(head), 0) != sizeof(head)) break;
+        tb_check_break(tb_bits_get_u32_le(head) == TB_DOWNLOADER_META_MAGIC);
+        tb_check_break(tb_bits_get_u32_le(head + 4) == TB_DOWNLOADER_META_VERSION);
+
+        // init layout
+        tb_hong_t fsize     = (tb_hong_t)tb_bits_get_u64_le(head + 8);
+        tb_hize_t segsize   = tb_bits_get_u64_le(head + 16);
+        tb_hize_t count     = tb_bits_get_u64_le(head + 24);
+        if (!tb_downloader_task_layout(task, fsize, segsize)) break;
+        tb_check_break(count == task->count);
+
+        // load the validator, it will be sent with If-Range for resuming it
+        head[sizeof(head) - 1] = 0;
+        tb_strlcpy(task->validator, (tb_char_t const*)head + 32, sizeof(task->validator));
+
+        // load the progress
+        tb_size_t dsize = task->count * 8;
+        data = tb_malloc_bytes(dsize);
+        tb_assert_and_check_break(data);
+        if (tb_file_pread(task->meta, data, dsize, TB_DOWNLOADER_META_HEAD_SIZE) != dsize) break;
+
+        // the file may be larger than the saved progress, but not smaller
+        tb_file_info_t info;
+        if (!tb_file_info(task->path, &info)) break;
+
+        // init progress
+        tb_size_t i = 0;
+        for (i = 0; i < task->count; i++)
+        {
+            tb_hize_t done = tb_bits_get_u64_le(data + i * 8);
+            if (done > tb_downloader_task_segment_size(task, i)) break;
+            if (done && task->segsize * i + done > info.size) break;
+            task->done[i]   = done;
+            task->saved[i]  = done;
+        }
+        tb_check_break(i == task->count);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // exit data
+    if (data) tb_free(data);
+    data = tb_null;
+
+    // failed? discard it
+    if (!ok)
+    {
+        if (task->meta) tb_file_exit(task->meta);
+        task->meta = tb_null;
+        task->count = 0;
+        task->validator[0] = '\0';
+    }
+    return ok;
+}
+static tb_void_t tb_downloader_task_meta_exit(tb_downloader_task_t* task, tb_bool_t remove)
+{
+    // exit meta file
+    if (task->meta) tb_file_exit(task->meta);
+    task->meta = tb_null;
+
+    // remove it if the task has been finished
+    if (remove)
+    {
+        tb_char_t path[TB_PATH_MAXN];
+        tb_long_t size = tb_snprintf(path, sizeof(path), "%s" TB_DOWNLOADER_META_SUFFIX, task->path);
+        if (size > 0 && size < sizeof(path)) tb_file_remove(path);
+    }
+}
+static tb_bool_t tb_downloader_task_acquire(tb_downloader_task_t* task)
+{
+    // acquire the global connection first and the host connection next
+    if (tb_co_semaphore_wait(task->downloader->connections, -1) <= 0) return tb_false;
+    if (tb_co_semaphore_wait(task->host, -1) <= 0)
+    {
+        tb_co_semaphore_post(task->downloader->connections, 1);
+        return tb_false;
+    }
+    return tb_true;
+}
+static tb_void_t tb_downloader_task_release(tb_downloader_task_t* task)
+{
+    tb_co_semaphore_post(task->host, 1);
+    tb_co_semaphore_post(task->downloader->connections, 1);
+}
+static tb_http_ref_t tb_downloader_task_http(tb_downloader_task_t* task)
+{
+    // init http
+    tb_http_ref_t http = tb_http_init();
+    tb_assert_and_check_return_val(http, tb_null);
+
+    // init option
+    tb_bool_t ok = tb_http_ctrl(http, TB_HTTP_OPTION_SET_URL, task->url);
+    if (ok && task->downloader->option.timeout)
+        ok = tb_http_ctrl(http, TB_HTTP_OPTION_SET_TIMEOUT, task->downloader->option.timeout);
+    if (!ok)
+    {
+        tb_http_exit(http);
+        http = tb_null;
+    }
+    return http;
+}
+static tb_bool_t tb_downloader_task_reconnect(tb_downloader_task_t* task, tb_http_ref_t* phttp)
+{
+    // the broken connection may be kept alive with the left response data, so we use a new connection
+    if (*phttp) tb_http_exit(*phttp);
+    *phttp = tb_downloader_task_http(task);
+    return *phttp? tb_true : tb_false;
+}
+static tb_long_t tb_downloader_task_read(tb_downloader_task_t* task, tb_http_ref_t http, tb_byte_t* data, tb_size_t size)
+{
+    // read data
+    tb_long_t real = 0;
+    tb_long_t left = task->downloader->option.timeout;
+    while (!(real = tb_http_read(http, data, size)))
+    {
+        // wait it with the bounded slice, so the stalled connection can be killed
+        if (tb_downloader_killed(task->downloader)) return -1;
+        tb_long_t slice = left > 0? tb_min(left, TB_DOWNLOADER_WAIT_SLICE) : TB_DOWNLOADER_WAIT_SLICE;
+        tb_long_t wait = tb_http_wait(http, TB_SOCKET_EVENT_RECV, slice);
+        if (wait < 0) return -1;
+
+        // timeout? only the current coroutine has been suspended
+        if (!wait && left > 0 && (left -= slice) <= 0) return -1;
+    }
+    return real;
+}
+static tb_bool_t tb_downloader_task_open(tb_downloader_task_t* task, tb_http_ref_t http, tb_size_t index)
+{
+    // close the previous response, the keep-alive connection will be reused
+    tb_http_clos(http);
+
+    // request the left range of this segment
+    tb_hize_t bof = task->segsize * index + task->done[index];
+    tb_hize_t eof = task->segsize * index + tb_downloader_task_segment_size(task, index) - 1;
+    if (!tb_http_ctrl(http, TB_HTTP_OPTION_SET_RANGE, bof, eof)) return tb_false;
+
+    // the server will return the whole file instead of the range if the remote file has been changed
+    if (task->validator[0] && !tb_http_ctrl(http, TB_HTTP_OPTION_SET_HEAD, "If-Range", task->validator)) return tb_false;
+    tb_bool_t ok = tb_http_open(http);
+
+    // the remote file has been changed or the range is not supported?
+    tb_http_status_t const* status = tb_http_status(http);
+    if (!ok && status->code != 416) return tb_false;
+    tb_char_t const* validator = ok? tb_downloader_task_validator(http) : tb_null;
+    if (!ok || status->code != 206 || status->document_size != task->size || (task->validator[0] && validator && tb_strcmp(validator, task->validator)))
+    {
+        tb_trace_e("%s: invalid range response: %u, size: %lld != %lld, validator: %s != %s", task->url, status->code, status->document_size, task->size, validator, task->validator);
+        task->state = TB_STATE_HTTP_RANGE_INVALID;
+        return tb_false;
+    }
+    return tb_true;
+}
+static tb_bool_t tb_downloader_task_pump(tb_downloader_task_t* task, tb_http_ref_t http, tb_size_t index, tb_byte_t* data)
+{
+    // read the opened segment
+    tb_hize_t           offset = task->segsize * index;
+    tb_hize_t           size = tb_downloader_task_segment_size(task, index);
+    tb_downloader_t*    downloader = task->downloader;
+    while (task->done[index] < size && !tb_downloader_killed(downloader))
+    {
+        // read data
+        tb_size_t need = (tb_size_t)tb_min(size - task->done[index], TB_DOWNLOADER_BLOCK_SIZE);
+        tb_long_t real = tb_downloader_task_read(task, http, data, tb_shaper_quota(downloader->shaper, need));
+        tb_check_break(real > 0);
+
+        // writ data
+        if (tb_file_pwrit(task->file, data, real, offset + task->done[index]) != real)
+        {
+            task->state = TB_STATE_FAILED;
+            break;
+        }
+        task->done[index] += real;
+        task->save += real;
+
+        // save progress
+        if (task->meta && (task->done[index] == size || task->done[index] - task->saved[index] >= TB_DOWNLOADER_SAVE_STEP))
+            tb_downloader_task_meta_save(task, index);
+
+        // limit rate, only the current coroutine will be suspended
+        tb_shaper_wait(downloader->shaper, real);
+    }
+
+    // save the left progress if it has been killed or broken
+    if (task->meta && task->done[index] != task->saved[index]) tb_downloader_task_meta_save(task, index);
+    return task->done[index] == size;
+}
+static tb_bool_t tb_downloader_task_segment(tb_downloader_task_t* task, tb_http_ref_t* phttp, tb_size_t index, tb_byte_t* data, tb_bool_t opened)
+{
+    // download it, we will retry it from the breakpoint if the connection is broken
+    tb_size_t retry = 0;
+    for (retry = 0; retry < TB_DOWNLOADER_RETRY_MAXN && task->state == TB_STATE_OK; retry++)
+    {
+        if ((opened || tb_downloader_task_open(task, *phttp, index)) && tb_downloader_task_pump(task, *phttp, index, data)) return tb_true;
+        if (tb_downloader_killed(task->downloader) || !tb_downloader_task_reconnect(task, phttp)) break;
+        tb_trace_d("%s: segment: %lu, retry: %lu", task->url, index, retry + 1);
+        opened = tb_false;
+    }
+
+    // failed
+    if (task->state == TB_STATE_OK && !tb_downloader_killed(task->downloader)) task->state = TB_STATE_FAILED;
+    return tb_false;
+}
+static tb_void_t tb_downloader_task_work(tb_downloader_task_t* task, tb_http_ref_t* phttp, tb_byte_t* data)
+{
+    // download the left segments
+    while (task->state == TB_STATE_OK && !tb_downloader_killed(task->downloader))
+    {
+        // get the next unfinished segment
+        while (task->next < task->count && task->done[task->next] == tb_downloader_task_segment_size(task, task->next)) task->next++;
+        tb_check_break(task->next < task->count);
+
+        // download it
+        if (!tb_downloader_task_segment(task, phttp, task->next++, data, tb_false)) break;
+    }
+}
+static tb_void_t tb_downloader_task_worker(tb_cpointer_t priv)
+{
+    // check
+    tb_downloader_task_t* task = (tb_downloader_task_t*)priv;
+    tb_assert(task);
+
+    // done
+    tb_http_ref_t   http = tb_null;
+    tb_byte_t*      data = tb_null;
+    if (tb_downloader_task_acquire(task))
+    {
+        // download segments
+        http = tb_downloader_task_http(task);
+        data = tb_malloc_bytes(TB_DOWNLOADER_BLOCK_SIZE);
+        if (http && data) tb_downloader_task_work(task, &http, data);
+        tb_downloader_task_release(task);
+    }
+
+    // exit http and data
+    if (http) tb_http_exit(http);
+    if (data) tb_free(data);
+
+    // notify the task coroutine
+    task->workers--;
+    tb_co_semaphore_post(task->finished, 1);
+}
+static tb_bool_t tb_downloader_task_sequential(tb_downloader_task_t* task, tb_http_ref_t http, tb_byte_t* data)
+{
+    // the range is not supported, we can only read the whole file in one stream
+    tb_hize_t               writ = 0;
+    tb_http_status_t const* status = tb_http_status(http);
+    tb_hong_t               size = status->document_size;
+
+    // the partial response without the document size? we do not know the size and read it to the end
+    if (status->code == 206 && size <= 0) size = -1;
+    while (size < 0 || writ < (tb_hize_t)size)
+    {
+        // killed?
+        if (tb_downloader_killed(task->downloader)) return tb_false;
+
+        // read data
+        tb_long_t real = tb_downloader_task_read(task, http, data, tb_shaper_quota(task->downloader->shaper, TB_DOWNLOADER_BLOCK_SIZE));
+        if (real < 0)
+        {
+            if (size < 0 && !tb_downloader_killed(task->downloader)) break;
+            return tb_false;
+        }
+
+        // writ data
+        if (tb_file_pwrit(task->file, data, real, writ) != real) return tb_false;
+        writ += real;
+        task->save += real;
+
+        // limit rate
+        tb_shaper_wait(task->downloader->shaper, real);
+    }
+    task->size = (tb_hong_t)writ;
+    return tb_true;
+}
+static tb_void_t tb_downloader_task_func(tb_cpointer_t priv)
+{
+    // check
+    tb_downloader_task_t* task = (tb_downloader_task_t*)priv;
+    tb_assert_and_check_return(task && task->downloader);
+
+    // done
+    tb_bool_t           ok = tb_false;
+    tb_bool_t           acquired = tb_false;
+    tb_http_ref_t       http = tb_null;
+    tb_byte_t*          data = tb_null;
+    tb_downloader_t*    downloader = task->downloader;
+    do
+    {
+        // init http and data
+        http = tb_downloader_task_http(task);
+        data = tb_malloc_bytes(TB_DOWNLOADER_BLOCK_SIZE);
+        tb_assert_and_check_break(http && data);
+
+        // acquire connection
+        acquired = tb_downloader_task_acquire(task);
+        tb_check_break(acquired);
+
+        // resume it from the progress file
+        tb_bool_t segmented = tb_false;
+        if (tb_downloader_task_meta_load(task))
+        {
+            // the first unfinished segment will be opened by the task coroutine
+            while (task->next < task->count && task->done[task->next] == tb_downloader_task_segment_size(task, task->next)) task->next++;
+            if (task->next == task->count || tb_downloader_task_open(task, http, task->next)) segmented = tb_true;
+            else if (task->state != TB_STATE_HTTP_RANGE_INVALID) break;
+            else
+            {
+                // the remote file has been changed? download it again
+                tb_trace_d("%s: discard the progress", task->url);
+                tb_downloader_task_meta_exit(task, tb_true);
+                task->count = 0;
+                task->state = TB_STATE_OK;
+                task->validator[0] = '\0';
+                if (!tb_downloader_task_reconnect(task, &http)) break;
+            }
+        }
+
+        // init file, we only truncate it if it cannot be resumed
+        task->file = tb_file_init(task->path, TB_FILE_MODE_RW | TB_FILE_MODE_CREAT | (segmented? 0 : TB_FILE_MODE_TRUNC));
+        tb_assert_and_check_break(task->file);
+
+        // probe the range support with the first segment
+        if (!segmented)
+        {
+            tb_hize_t segsize = downloader->option.segment_size;
+            if (!tb_http_ctrl(http, TB_HTTP_OPTION_SET_RANGE, (tb_hize_t)0, segsize - 1)) break;
+            if (!tb_http_open(http)) break;
+
+            // the range is supported? init the segments
+            tb_http_status_t const* status = tb_http_status(http);
+            if (status->code == 206 && status->document_size > 0)
+            {
+                // save the validator for resuming it, it will be ignored if it is too long
+                tb_char_t const* validator = tb_downloader_task_validator(http);
+                if (validator && tb_strlen(validator) < sizeof(task->validator)) tb_strlcpy(task->validator, validator, sizeof(task->validator));
+                if (!tb_downloader_task_layout(task, status->document_size, segsize)) break;
+                if (!tb_downloader_task_meta_init(task)) break;
+                segmented = tb_true;
+            }
+            // the total size is unknown, e.g. "Content-Range: bytes 0-N/*"? reopen it without the range and read it to the end
+            else if (status->code == 206)
+            {
+                tb_trace_d("%s: the document size is unknown", task->url);
+                if (!tb_downloader_task_reconnect(task, &http)) break;
+                if (!tb_http_open(http)) break;
+            }
+        }
+
+        // download it sequentially?
+        if (!segmented)
+        {
+            tb_trace_d("%s: the range is not supported, download it sequentially", task->url);
+            if (!tb_downloader_task_sequential(task, http, data)) break;
+            ok = tb_true;
+            break;
+        }
+
+        // start the other workers for the left segments
+        if (task->next < task->count)
+        {
+            tb_size_t left = task->count - task->next - 1;
+            tb_size_t maxn = tb_max(downloader->option.task_connections, 1) - 1;
+            tb_size_t i = 0;
+            for (i = 0; i < left && i < maxn; i++)
+            {
+                if (tb_coroutine_start(tb_null, tb_downloader_task_worker, task, TB_DOWNLOADER_STACKSIZE)) task->workers++;
+            }
+
+            // download the opened segment and the left segments as a worker
+            if (tb_downloader_task_segment(task, &http, task->next++, data, tb_true))
+                tb_downloader_task_work(task, &http, data);
+        }
+
+        // release connection before waiting the other workers
+        tb_downloader_task_release(task);
+        acquired = tb_false;
+
+        // wait all workers
+        while (task->workers) tb_co_semaphore_wait(task->finished, -1);
+
+        // all segments have been finished?
+        tb_size_t i = 0;
+        for (i = 0; i < task->count && task->done[i] == tb_downloader_task_segment_size(task, i); i++) ;
+        ok = (i == task->count);
+
+    } while (0);
+
+    // release connection
+    if (acquired) tb_downloader_task_release(task);
+
+    // exit http and data
+    if (http) tb_http_exit(http);
+    if (data) tb_free(data);
+    http = tb_null;
+    data = tb_null;
+
+    // exit file
+    if (task->file) 
+    {
+        if (ok) tb_file_sync(task->file);
+        tb_file_exit(task->file);
+    }
+    task->file = tb_null;
+
+    // exit the progress file and remove it if ok
+    tb_downloader_task_meta_exit(task, ok);
+
+    // update state
+    if (ok) task->state = TB_STATE_OK;
+    else if (tb_downloader_killed(downloader)) task->state = TB_STATE_KILLED;
+    else if (task->state == TB_STATE_OK) task->state = TB_STATE_FAILED;
+
+    // trace
+    tb_trace_d("%s: %s, size: %lld, save: %llu", task->url, tb_state_cstr(task->state), task->size, task->save);
+
+    // done func
+    if (task->func) task->func(task->state, task->url, task->path, task->size, task->save, task->priv);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_downloader_ref_t tb_downloader_init(tb_downloader_option_t const* option)
+{
+    // done
+    tb_bool_t           ok = tb_false;
+    tb_downloader_t*    downloader = tb_null;
+    do
+    {
+        // make downloader
+        downloader = tb_malloc0_type(tb_downloader_t);
+        tb_assert_and_check_break(downloader);
+
+        // init option
+        if (option) downloader->option = *option;
+        if (!downloader->option.connections) downloader->option.connections = TB_DOWNLOADER_CONNECTIONS;
+        if (!downloader->option.host_connections) downloader->option.host_connections = TB_DOWNLOADER_HOST_CONNECTIONS;
+        if (!downloader->option.task_connections) downloader->option.task_connections = TB_DOWNLOADER_TASK_CONNECTIONS;
+        if (!downloader->option.segment_size) downloader->option.segment_size = TB_DOWNLOADER_SEGMENT_SIZE;
+
+        // init tasks
+        tb_list_entry_init(&downloader->tasks, tb_downloader_task_t, entry, tb_null);
+
+        // init hosts
+        downloader->hosts = tb_hash_map_init(TB_HASH_MAP_BUCKET_SIZE_MICRO, tb_element_str(tb_true), tb_element_ptr(tb_downloader_host_exit, tb_null));
+        tb_assert_and_check_break(downloader->hosts);
+
+        // init connections
+        downloader->connections = tb_co_semaphore_init(downloader->option.connections);
+        tb_assert_and_check_break(downloader->connections);
+
+        // init shaper, all tasks share it and it may be limited by the parent shaper
+        downloader->shaper = tb_shaper_init(downloader->option.limitrate, 0, downloader->option.shaper);
+        tb_assert_and_check_break(downloader->shaper);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (downloader) tb_downloader_exit((tb_downloader_ref_t)downloader);
+        downloader = tb_null;
+    }
+    return (tb_downloader_ref_t)downloader;
+}
+tb_void_t tb_downloader_exit(tb_downloader_ref_t self)
+{
+    // check
+    tb_downloader_t* downloader = (tb_downloader_t*)self;
+    tb_assert_and_check_return(downloader && !downloader->running);
+
+    // exit tasks
+    while (tb_list_entry_size(&downloader->tasks))
+    {
+        tb_list_entry_ref_t entry = tb_list_entry_head(&downloader->tasks);
+        tb_list_entry_remove_head(&downloader->tasks);
+
+        tb_downloader_task_t* task = (tb_downloader_task_t*)tb_list_entry(&downloader->tasks, entry);
+        if (task->finished) tb_co_semaphore_exit(task->finished);
+        if (task->done) tb_free(task->done);
+        tb_free(task);
+    }
+    tb_list_entry_exit(&downloader->tasks);
+
+    // exit hosts
+    if (downloader->hosts) tb_hash_map_exit(downloader->hosts);
+    downloader->hosts = tb_null;
+
+    // exit connections
+    if (downloader->connections) tb_co_semaphore_exit(downloader->connections);
+    downloader->connections = tb_null;
+
+    // exit shaper
+    if (downloader->shaper) tb_shaper_exit(downloader->shaper);
+    downloader->shaper = tb_null;
+
+    // exit it
+    tb_free(downloader);
+}
+tb_void_t tb_downloader_kill(tb_downloader_ref_t self)
+{
+    // check
+    tb_downloader_t* downloader = (tb_downloader_t*)self;
+    tb_assert_and_check_return(downloader);
+
+    // kill it
+    tb_atomic_set(&downloader->killed, 1);
+}
+tb_bool_t tb_downloader_add(tb_downloader_ref_t self, tb_char_t const* url, tb_char_t const* path, tb_downloader_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_downloader_t* downloader = (tb_downloader_t*)self;
+    tb_assert_and_check_return_val(downloader && url && path && !downloader->running, tb_false);
+
+    // done
+    tb_bool_t               ok = tb_false;
+    tb_downloader_task_t*   task = tb_null;
+    do
+    {
+        // get the host
+        tb_url_t u;
+        if (!tb_url_init(&u)) break;
+        tb_char_t const* host = tb_url_cstr_set(&u, url)? tb_url_host(&u) : tb_null;
+
+        // get or init the host semaphore
+        tb_co_semaphore_ref_t semaphore = host? (tb_co_semaphore_ref_t)tb_hash_map_get(downloader->hosts, host) : tb_null;
+        if (host && !semaphore)
+        {
+            semaphore = tb_co_semaphore_init(downloader->option.host_connections);
+            if (semaphore) tb_hash_map_insert(downloader->hosts, host, semaphore);
+        }
+        tb_url_exit(&u);
+        if (!semaphore)
+        {
+            tb_trace_e("invalid url: %s", url);
+            break;
+        }
+
+        // make task with the url and path
+        tb_size_t un = tb_strlen(url) + 1;
+        tb_size_t pn = tb_strlen(path) + 1;
+        task = (tb_downloader_task_t*)tb_malloc0(sizeof(tb_downloader_task_t) + un + pn);
+        tb_assert_and_check_break(task);
+
+        // init task
+        tb_char_t* p = (tb_char_t*)(task + 1);
+        tb_memcpy(p, url, un);
+        tb_memcpy(p + un, path, pn);
+        task->url           = p;
+        task->path          = p + un;
+        task->func          = func;
+        task->priv          = priv;
+        task->host          = semaphore;
+        task->downloader    = downloader;
+        task->size          = -1;
+        task->state         = TB_STATE_OK;
+
+        // init the finished semaphore
+        task->finished = tb_co_semaphore_init(0);
+        tb_assert_and_check_break(task->finished);
+
+        // add task
+        tb_list_entry_insert_tail(&downloader->tasks, &task->entry);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok && task)
+    {
+        if (task->finished) tb_co_semaphore_exit(task->finished);
+        tb_free(task);
+    }
+    return ok;
+}
+tb_bool_t tb_downloader_done(tb_downloader_ref_t self)
+{
+    // check
+    tb_downloader_t* downloader = (tb_downloader_t*)self;
+    tb_assert_and_check_return_val(downloader && !downloader->running, tb_false);
+
+    // cannot be called in the coroutine, the scheduler loop will block it
+    tb_assert_and_check_return_val(!tb_coroutine_self(), tb_false);
+
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    tb_assert_and_check_return_val(scheduler, tb_false);
+
+    // start all tasks
+    tb_for_all_if (tb_downloader_task_t*, task, tb_list_entry_itor(&downloader->tasks), task)
+    {
+        task->state = TB_STATE_OK;
+        task->save  = 0;
+        tb_coroutine_start(scheduler, tb_downloader_task_func, task, TB_DOWNLOADER_STACKSIZE);
+    }
+
+    /* run scheduler, it is not exclusive because the downloader may be killed from the other threads
+     * and the other threads cannot see this scheduler as their own
+     */
+    downloader->running = tb_true;
+    tb_co_scheduler_loop(scheduler, tb_false);
+    downloader->running = tb_false;
+
+    // exit scheduler
+    tb_co_scheduler_exit(scheduler);
+
+    // all tasks are ok?
+    tb_bool_t ok = tb_true;
+    tb_for_all_if (tb_downloader_task_t*, item, tb_list_entry_itor(&downloader->tasks), item)
+    {
+        if (item->state != TB_STATE_OK) ok = tb_false;
+    }
+    return ok;
+}
+#else
+tb_downloader_ref_t tb_downloader_init(tb_downloader_option_t const* option)
+{
+    tb_trace_noimpl();
+    return tb_null;
+}
+tb_void_t tb_downloader_exit(tb_downloader_ref_t downloader)
+{
+    tb_trace_noimpl();
+}
+tb_void_t tb_downloader_kill(tb_downloader_ref_t downloader)
+{
+    tb_trace_noimpl();
+}
+tb_bool_t tb_downloader_add(tb_downloader_ref_t downloader, tb_char_t const* url, tb_char_t const* path, tb_downloader_func_t func, tb_cpointer_t priv)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+tb_bool_t tb_downloader_done(tb_downloader_ref_t downloader)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+#endif
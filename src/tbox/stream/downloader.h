@@ -0,0 +1,147 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ *
+ * @author      ruki
+ * @file        downloader.h
+ * @ingroup     stream
+ *
+ */
+#ifndef TB_STREAM_DOWNLOADER_H
+#define TB_STREAM_DOWNLOADER_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the downloader ref type
+typedef __tb_typeref__(downloader);
+
+/// the downloader option type
+typedef struct __tb_downloader_option_t
+{
+    /// the maximum connections of all tasks, default: 16
+    tb_size_t               connections;
+
+    /// the maximum connections of the same host, default: 8
+    tb_size_t               host_connections;
+
+    /// the maximum connections of one task, default: 4
+    tb_size_t               task_connections;
+
+    /// the segment size of the ranged requests, default: 4MB
+    tb_size_t               segment_size;
+
+    /// the limit rate of all tasks, bytes/s, no limit: 0
+    tb_size_t               limitrate;
+
+    /// the parent shaper of the limit rate, it can be shared with the other downloaders and streams, optional
+    tb_shaper_ref_t         shaper;
+
+    /// the timeout of the connection, ms
+    tb_long_t               timeout;
+
+}tb_downloader_option_t;
+
+/*! the downloader task func type, it will be called after the task has been finished
+ *
+ * @param state     the state, TB_STATE_OK if it has been downloaded completely
+ * @param url       the url
+ * @param path      the file path
+ * @param size      the file size
+ * @param save      the downloaded size in this time, not including the resumed data
+ * @param priv      the func private data
+ */
+typedef tb_void_t   (*tb_downloader_func_t)(tb_size_t state, tb_char_t const* url, tb_char_t const* path, tb_hong_t size, tb_hize_t save, tb_cpointer_t priv);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the downloader
+ *
+ * the large file will be split into the fixed-size segments and fetched concurrently by the http ranged requests,
+ * and the progress of all segments is saved to the "$path.tbdl" file, so it can be resumed after breaking it.
+ *
+ * @code
+    tb_downloader_ref_t downloader = tb_downloader_init(tb_null);
+    if (downloader)
+    {
+        tb_downloader_add(downloader, "http://xxx.com/a.zip", "/tmp/a.zip", tb_null, tb_null);
+        tb_downloader_add(downloader, "http://xxx.com/b.zip", "/tmp/b.zip", tb_null, tb_null);
+        tb_downloader_done(downloader);
+        tb_downloader_exit(downloader);
+    }
+ * @endcode
+ *
+ * @param option    the option, using the default option if be null
+ *
+ * @return          the downloader
+ */
+tb_downloader_ref_t tb_downloader_init(tb_downloader_option_t const* option);
+
+/*! exit the downloader
+ *
+ * @param downloader    the downloader
+ */
+tb_void_t           tb_downloader_exit(tb_downloader_ref_t downloader);
+
+/*! kill the downloader, it will break all downloading tasks and keep their progress
+ *
+ * @param downloader    the downloader
+ */
+tb_void_t           tb_downloader_kill(tb_downloader_ref_t downloader);
+
+/*! add a download task
+ *
+ * @param downloader    the downloader
+ * @param url           the url
+ * @param path          the file path
+ * @param func          the func, optional
+ * @param priv          the func private data
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t           tb_downloader_add(tb_downloader_ref_t downloader, tb_char_t const* url, tb_char_t const* path, tb_downloader_func_t func, tb_cpointer_t priv);
+
+/*! download all added tasks in coroutines and wait them, it cannot be called in the coroutine
+ *
+ * @param downloader    the downloader
+ *
+ * @return              tb_true if all tasks have been downloaded completely
+ */
+tb_bool_t           tb_downloader_done(tb_downloader_ref_t downloader);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
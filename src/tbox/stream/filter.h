@@ -67,6 +67,11 @@ typedef enum __tb_filter_ctrl_e
 ,   TB_FILTER_CTRL_ZIP_GET_ACTION        = TB_FILTER_CTRL(TB_FILTER_TYPE_ZIP, 2)
 ,   TB_FILTER_CTRL_ZIP_SET_ALGO          = TB_FILTER_CTRL(TB_FILTER_TYPE_ZIP, 3)
 ,   TB_FILTER_CTRL_ZIP_SET_ACTION        = TB_FILTER_CTRL(TB_FILTER_TYPE_ZIP, 4)
+,   TB_FILTER_CTRL_ZIP_GET_LEVEL         = TB_FILTER_CTRL(TB_FILTER_TYPE_ZIP, 5)
+,   TB_FILTER_CTRL_ZIP_SET_LEVEL         = TB_FILTER_CTRL(TB_FILTER_TYPE_ZIP, 6)
+,   TB_FILTER_CTRL_ZIP_SET_DICT          = TB_FILTER_CTRL(TB_FILTER_TYPE_ZIP, 7)
+,   TB_FILTER_CTRL_ZIP_GET_PARALLEL      = TB_FILTER_CTRL(TB_FILTER_TYPE_ZIP, 8)
+,   TB_FILTER_CTRL_ZIP_SET_PARALLEL      = TB_FILTER_CTRL(TB_FILTER_TYPE_ZIP, 9)
 
 ,   TB_FILTER_CTRL_CHARSET_GET_FTYPE     = TB_FILTER_CTRL(TB_FILTER_TYPE_CHARSET, 1)
 ,   TB_FILTER_CTRL_CHARSET_GET_TTYPE     = TB_FILTER_CTRL(TB_FILTER_TYPE_CHARSET, 2)
@@ -45,6 +45,9 @@ typedef struct __tb_filter_zip_t
     // the action
     tb_size_t                   action;
 
+    // the option, @note the dictionary data is not owned by the filter
+    tb_zip_option_t             option;
+
     // the zip 
     tb_zip_ref_t                zip;
 
@@ -66,7 +69,7 @@ static tb_bool_t tb_filter_zip_open(tb_filter_t* filter)
     tb_assert_and_check_return_val(zfilter && !zfilter->zip, tb_false);
 
     // init zip
-    zfilter->zip = tb_zip_init(zfilter->algo, zfilter->action);
+    zfilter->zip = tb_zip_init_with_option(zfilter->algo, zfilter->action, &zfilter->option);
     tb_assert_and_check_return_val(zfilter->zip, tb_false);
 
     // ok
@@ -147,6 +150,58 @@ static tb_bool_t tb_filter_zip_ctrl(tb_filter_t* filter, tb_size_t ctrl, tb_va_l
             // set action
             zfilter->action = (tb_size_t)tb_va_arg(args, tb_size_t);
 
+            // ok
+            return tb_true;
+        }
+    case TB_FILTER_CTRL_ZIP_GET_LEVEL:
+        {
+            // the plevel
+            tb_long_t* plevel = (tb_long_t*)tb_va_arg(args, tb_long_t*);
+            tb_assert_and_check_break(plevel);
+
+            // get level
+            *plevel = zfilter->option.level;
+
+            // ok
+            return tb_true;
+        }
+    case TB_FILTER_CTRL_ZIP_SET_LEVEL:
+        {
+            // set level
+            zfilter->option.level = (tb_long_t)tb_va_arg(args, tb_long_t);
+
+            // ok
+            return tb_true;
+        }
+    case TB_FILTER_CTRL_ZIP_SET_DICT:
+        {
+            // set dictionary
+            zfilter->option.dict        = (tb_byte_t const*)tb_va_arg(args, tb_byte_t const*);
+            zfilter->option.dict_size   = (tb_size_t)tb_va_arg(args, tb_size_t);
+
+            // ok
+            return tb_true;
+        }
+    case TB_FILTER_CTRL_ZIP_GET_PARALLEL:
+        {
+            // the pworkers and pblock_size
+            tb_size_t* pworkers     = (tb_size_t*)tb_va_arg(args, tb_size_t*);
+            tb_size_t* pblock_size  = (tb_size_t*)tb_va_arg(args, tb_size_t*);
+            tb_assert_and_check_break(pworkers);
+
+            // get the worker count and block size
+            *pworkers = zfilter->option.workers;
+            if (pblock_size) *pblock_size = zfilter->option.block_size? zfilter->option.block_size : TB_ZIP_BLOCK_SIZE_DEFAULT;
+
+            // ok
+            return tb_true;
+        }
+    case TB_FILTER_CTRL_ZIP_SET_PARALLEL:
+        {
+            // set the worker count and block size, only for deflating zlibraw, zlib and gzip
+            zfilter->option.workers     = (tb_size_t)tb_va_arg(args, tb_size_t);
+            zfilter->option.block_size  = (tb_size_t)tb_va_arg(args, tb_size_t);
+
             // ok
             return tb_true;
         }
@@ -180,6 +235,9 @@ tb_filter_ref_t tb_filter_init_from_zip(tb_size_t algo, tb_size_t action)
         filter->algo        = algo;
         filter->action      = action;
 
+        // init the default level
+        filter->option.level = TB_ZIP_LEVEL_DEFAULT;
+
         // ok
         ok = tb_true;
 
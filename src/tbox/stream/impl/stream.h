@@ -68,6 +68,9 @@ typedef struct __tb_stream_t
     // the timeout
     tb_long_t           timeout;
 
+    // the shaper for limiting the rate of reading and writing
+    tb_shaper_ref_t     shaper;
+
     /* the stream state
      *
      * <pre>
@@ -83,6 +86,9 @@ typedef struct __tb_stream_t
     // the cache
     tb_queue_buffer_t   cache;
 
+    // the initial cache size, the grown cache will be shrunk back to it after it has been drained
+    tb_size_t           cache_maxn;
+
     // wait 
     tb_long_t           (*wait)(tb_stream_ref_t stream, tb_size_t wait, tb_long_t timeout);
 
@@ -564,6 +564,25 @@ static tb_bool_t tb_stream_http_ctrl(tb_stream_ref_t stream, tb_size_t ctrl, tb_
             return tb_http_ctrl(stream_http->http, TB_HTTP_OPTION_GET_COOKIES, pcookies);
         }
         break;
+    case TB_STREAM_CTRL_HTTP_SET_CACHE:
+        {
+            // cache
+            tb_http_cache_ref_t cache = (tb_http_cache_ref_t)tb_va_arg(args, tb_http_cache_ref_t);
+
+            // set cache
+            return tb_http_ctrl(stream_http->http, TB_HTTP_OPTION_SET_CACHE, cache);
+        }
+        break;
+    case TB_STREAM_CTRL_HTTP_GET_CACHE:
+        {
+            // pcache
+            tb_http_cache_ref_t* pcache = (tb_http_cache_ref_t*)tb_va_arg(args, tb_http_cache_ref_t*);
+            tb_assert_and_check_return_val(pcache, tb_false);
+
+            // get cache
+            return tb_http_ctrl(stream_http->http, TB_HTTP_OPTION_GET_CACHE, pcache);
+        }
+        break;
     default:
         break;
     }
@@ -33,6 +33,7 @@
 #include "../network/url.h"
 #include "../memory/memory.h"
 #include "../platform/socket.h"
+#include "../platform/shaper.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
@@ -95,6 +96,7 @@ typedef enum __tb_stream_ctrl_e
 ,   TB_STREAM_CTRL_GET_TIMEOUT              = TB_STREAM_CTRL(TB_STREAM_TYPE_NONE, 6)
 ,   TB_STREAM_CTRL_GET_SIZE                 = TB_STREAM_CTRL(TB_STREAM_TYPE_NONE, 7)
 ,   TB_STREAM_CTRL_GET_OFFSET               = TB_STREAM_CTRL(TB_STREAM_TYPE_NONE, 8)
+,   TB_STREAM_CTRL_GET_SHAPER               = TB_STREAM_CTRL(TB_STREAM_TYPE_NONE, 9)
 
 ,   TB_STREAM_CTRL_SET_URL                  = TB_STREAM_CTRL(TB_STREAM_TYPE_NONE, 11)
 ,   TB_STREAM_CTRL_SET_HOST                 = TB_STREAM_CTRL(TB_STREAM_TYPE_NONE, 12)
@@ -102,6 +104,7 @@ typedef enum __tb_stream_ctrl_e
 ,   TB_STREAM_CTRL_SET_PATH                 = TB_STREAM_CTRL(TB_STREAM_TYPE_NONE, 14)
 ,   TB_STREAM_CTRL_SET_SSL                  = TB_STREAM_CTRL(TB_STREAM_TYPE_NONE, 15)
 ,   TB_STREAM_CTRL_SET_TIMEOUT              = TB_STREAM_CTRL(TB_STREAM_TYPE_NONE, 16)
+,   TB_STREAM_CTRL_SET_SHAPER               = TB_STREAM_CTRL(TB_STREAM_TYPE_NONE, 17)
 
     // the stream for data
 ,   TB_STREAM_CTRL_DATA_SET_DATA            = TB_STREAM_CTRL(TB_STREAM_TYPE_DATA, 1)
@@ -131,6 +134,7 @@ typedef enum __tb_stream_ctrl_e
 ,   TB_STREAM_CTRL_HTTP_GET_POST_FUNC       = TB_STREAM_CTRL(TB_STREAM_TYPE_HTTP, 12)
 ,   TB_STREAM_CTRL_HTTP_GET_POST_PRIV       = TB_STREAM_CTRL(TB_STREAM_TYPE_HTTP, 13)
 ,   TB_STREAM_CTRL_HTTP_GET_POST_LRATE      = TB_STREAM_CTRL(TB_STREAM_TYPE_HTTP, 14)
+,   TB_STREAM_CTRL_HTTP_GET_CACHE           = TB_STREAM_CTRL(TB_STREAM_TYPE_HTTP, 15)
 
 ,   TB_STREAM_CTRL_HTTP_SET_HEAD            = TB_STREAM_CTRL(TB_STREAM_TYPE_HTTP, 20)
 ,   TB_STREAM_CTRL_HTTP_SET_RANGE           = TB_STREAM_CTRL(TB_STREAM_TYPE_HTTP, 21)
@@ -146,6 +150,7 @@ typedef enum __tb_stream_ctrl_e
 ,   TB_STREAM_CTRL_HTTP_SET_POST_FUNC       = TB_STREAM_CTRL(TB_STREAM_TYPE_HTTP, 31)
 ,   TB_STREAM_CTRL_HTTP_SET_POST_PRIV       = TB_STREAM_CTRL(TB_STREAM_TYPE_HTTP, 32)
 ,   TB_STREAM_CTRL_HTTP_SET_POST_LRATE      = TB_STREAM_CTRL(TB_STREAM_TYPE_HTTP, 33)
+,   TB_STREAM_CTRL_HTTP_SET_CACHE           = TB_STREAM_CTRL(TB_STREAM_TYPE_HTTP, 34)
 
     // the stream for filter
 ,   TB_STREAM_CTRL_FLTR_GET_STREAM          = TB_STREAM_CTRL(TB_STREAM_TYPE_FLTR, 1)
@@ -91,6 +91,7 @@ tb_stream_ref_t tb_stream_init(     tb_size_t type
 
         // init cache
         if (!tb_queue_buffer_init(&stream->cache, cache)) break;
+        stream->cache_maxn = cache;
 
         // init func
         stream->open = open;
@@ -561,6 +562,24 @@ tb_bool_t tb_stream_ctrl_with_args(tb_stream_ref_t self, tb_size_t ctrl, tb_va_l
             }
         }
         break;
+    case TB_STREAM_CTRL_SET_SHAPER:
+        {
+            // set shaper, it can be shared by the other streams
+            stream->shaper = (tb_shaper_ref_t)tb_va_arg(args, tb_shaper_ref_t);
+            ok = tb_true;
+        }
+        break;
+    case TB_STREAM_CTRL_GET_SHAPER:
+        {
+            // get shaper
+            tb_shaper_ref_t* pshaper = (tb_shaper_ref_t*)tb_va_arg(args, tb_shaper_ref_t*);
+            if (pshaper)
+            {
+                *pshaper = stream->shaper;
+                ok = tb_true;
+            }
+        }
+        break;
     default:
         break;
     }
@@ -750,6 +769,69 @@ tb_bool_t tb_stream_need(tb_stream_ref_t self, tb_byte_t** data, tb_size_t size)
     // ok
     return tb_true;
 }
+tb_long_t tb_stream_peek(tb_stream_ref_t self, tb_byte_t** data, tb_size_t size)
+{
+    // check 
+    tb_stream_t* stream = tb_stream_cast(self);
+    tb_assert_and_check_return_val(data, -1);
+
+    // check self
+    tb_assert_and_check_return_val(stream && tb_stream_is_opened(self) && stream->read && stream->wait, -1);
+
+    // stoped?
+    tb_check_return_val(TB_STATE_OPENED == tb_atomic_get(&stream->istate), -1);
+
+    // have writed cache? sync first
+    if (stream->bwrited && !tb_queue_buffer_null(&stream->cache) && !tb_stream_sync(self, tb_false)) return -1;
+
+    // switch to the read cache mode
+    if (stream->bwrited && tb_queue_buffer_null(&stream->cache)) stream->bwrited = 0;
+
+    // check the cache mode, must be read cache
+    tb_assert_and_check_return_val(!stream->bwrited, -1);
+
+    // not enough? read more data
+    if (size >= tb_queue_buffer_size(&stream->cache))
+    {
+        // the cache is full? grow it
+        tb_size_t maxn = tb_queue_buffer_maxn(&stream->cache);
+        if (size >= maxn && !tb_queue_buffer_resize(&stream->cache, tb_max(maxn << 1, size + 1))) return -1;
+
+        // enter cache for push
+        tb_size_t   push = 0;
+        tb_byte_t*  tail = tb_queue_buffer_push_init(&stream->cache, &push);
+        tb_assert_and_check_return_val(tail && push, -1);
+
+        // read the available data
+        tb_long_t real = 0;
+        while (TB_STATE_OPENED == tb_atomic_get(&stream->istate))
+        {
+            // read data
+            real = stream->read(self, tail, push);
+            tb_check_break(!real);
+
+            // no data? wait it
+            real = stream->wait(self, TB_STREAM_WAIT_READ, tb_stream_timeout(self));
+            tb_check_break(real > 0);
+        }
+
+        // leave cache for push
+        tb_queue_buffer_push_exit(&stream->cache, real > 0? real : 0);
+
+        // not enough?
+        if (size >= tb_queue_buffer_size(&stream->cache))
+        {
+            // killed? save state
+            if (!stream->state && (TB_STATE_KILLING == tb_atomic_get(&stream->istate)))
+                stream->state = TB_STATE_KILLED;
+            return -1;
+        }
+    }
+
+    // save data
+    *data = tb_queue_buffer_head(&stream->cache);
+    return tb_queue_buffer_size(&stream->cache);
+}
 tb_long_t tb_stream_read(tb_stream_ref_t self, tb_byte_t* data, tb_size_t size)
 {
     // check 
@@ -762,6 +844,9 @@ tb_long_t tb_stream_read(tb_stream_ref_t self, tb_byte_t* data, tb_size_t size)
     // check self
     tb_assert_and_check_return_val(stream && tb_stream_is_opened(self) && stream->read, -1);
 
+    // clip the size by the burst size of the shaper
+    if (stream->shaper) size = tb_shaper_quota(stream->shaper, size);
+
     // done
     tb_long_t read = 0;
     do
@@ -784,6 +869,10 @@ tb_long_t tb_stream_read(tb_stream_ref_t self, tb_byte_t* data, tb_size_t size)
             // cache is null now.
             tb_assert_and_check_return_val(tb_queue_buffer_null(&stream->cache), -1);
 
+            // the cache has been grown by peeking or needing the large data? shrink it back
+            if (tb_queue_buffer_maxn(&stream->cache) > stream->cache_maxn && stream->cache_maxn)
+                tb_queue_buffer_resize(&stream->cache, stream->cache_maxn);
+
             // enter cache for push
             tb_size_t   push = 0;
             tb_byte_t*  tail = tb_queue_buffer_push_init(&stream->cache, &push);
@@ -820,6 +909,9 @@ tb_long_t tb_stream_read(tb_stream_ref_t self, tb_byte_t* data, tb_size_t size)
     // update offset
     stream->offset += read;
 
+    // limit rate
+    if (stream->shaper && read > 0) tb_shaper_wait(stream->shaper, read);
+
 //  tb_trace_d("read: %d", read);
     return read;
 }
@@ -835,6 +927,9 @@ tb_long_t tb_stream_writ(tb_stream_ref_t self, tb_byte_t const* data, tb_size_t
     // check self
     tb_assert_and_check_return_val(stream && tb_stream_is_opened(self) && stream->writ, -1);
 
+    // clip the size by the burst size of the shaper
+    if (stream->shaper) size = tb_shaper_quota(stream->shaper, size);
+
     // done
     tb_long_t writ = 0;
     do
@@ -892,6 +987,9 @@ tb_long_t tb_stream_writ(tb_stream_ref_t self, tb_byte_t const* data, tb_size_t
     // update offset
     stream->offset += writ;
 
+    // limit rate
+    if (stream->shaper && writ > 0) tb_shaper_wait(stream->shaper, writ);
+
 //  tb_trace_d("writ: %d", writ);
     return writ;
 }
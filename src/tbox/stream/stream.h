@@ -32,6 +32,7 @@
 #include "prefix.h"
 #include "filter.h"
 #include "transfer.h"
+#include "downloader.h"
 #include "static_stream.h"
 #ifdef TB_CONFIG_API_HAVE_DEPRECATED
 #   include "deprecated/deprecated.h"
@@ -677,6 +678,31 @@ tb_bool_t               tb_stream_sync(tb_stream_ref_t stream, tb_bool_t bclosin
  */
 tb_bool_t               tb_stream_need(tb_stream_ref_t stream, tb_byte_t** data, tb_size_t size);
 
+/*! peek the cached data, and read more data to the cache if the cached data is not larger than the given size
+ *
+ * it only reads the available data once, so we can scan the incremental data
+ * from the given size without consuming it, e.g. finding the end of the http head.
+ *
+ * @code
+ 
+    tb_byte_t*  data = tb_null;
+    tb_long_t   size = 0;
+    while ((size = tb_stream_peek(stream, &data, size)) > 0)
+    {
+        // scan the new data: data[scanned, size)
+        // ..
+    }
+
+ * @endcode
+ *
+ * @param stream        the stream
+ * @param data          the cached data
+ * @param size          the scanned data size
+ *
+ * @return              the cached data size which is larger than the given size, return -1 if failed or end
+ */
+tb_long_t               tb_stream_peek(tb_stream_ref_t stream, tb_byte_t** data, tb_size_t size);
+
 /*! seek stream
  *
  * @param stream        the stream
@@ -55,6 +55,11 @@ tb_hong_t tb_transfer(tb_stream_ref_t istream, tb_stream_ref_t ostream, tb_size_
     // done func
     if (func) func(TB_STATE_OK, tb_stream_offset(istream), tb_stream_size(istream), 0, 0, priv);
 
+    /* init the token bucket shaper for the limit rate, it will smooth the bursts 
+     * and the shared shaper can be also set to the streams by TB_STREAM_CTRL_SET_SHAPER
+     */
+    tb_shaper_ref_t shaper = lrate? tb_shaper_init(lrate, 0, tb_null) : tb_null;
+
     // writ data
     tb_byte_t data[TB_STREAM_BLOCK_MAXN];
     tb_hize_t writ = 0;
@@ -63,12 +68,11 @@ tb_hong_t tb_transfer(tb_stream_ref_t istream, tb_stream_ref_t ostream, tb_size_
     tb_hong_t base1s = base;
     tb_hong_t time = 0;
     tb_size_t crate = 0;
-    tb_long_t delay = 0;
     tb_size_t writ1s = 0;
     do
     {
-        // the need
-        tb_size_t need = lrate? tb_min(lrate, TB_STREAM_BLOCK_MAXN) : TB_STREAM_BLOCK_MAXN;
+        // the need, it is clipped by the burst size of the shaper
+        tb_size_t need = shaper? tb_shaper_quota(shaper, TB_STREAM_BLOCK_MAXN) : TB_STREAM_BLOCK_MAXN;
 
         // read data
         tb_long_t real = tb_stream_read(istream, data, need);
@@ -80,8 +84,11 @@ tb_hong_t tb_transfer(tb_stream_ref_t istream, tb_stream_ref_t ostream, tb_size_
             // save writ
             writ += real;
 
-            // has func or limit rate?
-            if (func || lrate) 
+            // wait some time for limit rate
+            if (shaper) tb_shaper_wait(shaper, real);
+
+            // has func?
+            if (func) 
             {
                 // the time
                 time = tb_cache_time_spak();
@@ -94,9 +101,6 @@ tb_hong_t tb_transfer(tb_stream_ref_t istream, tb_stream_ref_t ostream, tb_size_
 
                     // save current rate if < 1s from base
                     if (time < base + 1000) crate = writ1s;
-                
-                    // compute the delay for limit rate
-                    if (lrate) delay = writ1s >= lrate? (tb_size_t)(base1s + 1000 - time) : 0;
                 }
                 else
                 {
@@ -109,15 +113,9 @@ tb_hong_t tb_transfer(tb_stream_ref_t istream, tb_stream_ref_t ostream, tb_size_
                     // reset writ1s
                     writ1s = 0;
 
-                    // reset delay
-                    delay = 0;
-
                     // done func
-                    if (func) func(TB_STATE_OK, tb_stream_offset(istream), tb_stream_size(istream), writ, crate, priv);
+                    func(TB_STATE_OK, tb_stream_offset(istream), tb_stream_size(istream), writ, crate, priv);
                 }
-
-                // wait some time for limit rate
-                if (delay) tb_msleep(delay);
             }
         }
         else if (!real) 
@@ -139,6 +137,10 @@ tb_hong_t tb_transfer(tb_stream_ref_t istream, tb_stream_ref_t ostream, tb_size_
 
     } while(1);
 
+    // exit shaper
+    if (shaper) tb_shaper_exit(shaper);
+    shaper = tb_null;
+
     // sync the ostream
     if (!tb_stream_sync(ostream, tb_true)) return -1;
 
@@ -89,8 +89,11 @@ typedef enum __tb_singleton_type_e
     /// the cookies type
 ,   TB_SINGLETON_TYPE_COOKIES               = 12
 
+    /// the file offload type
+,   TB_SINGLETON_TYPE_FILE_OFFLOAD          = 13
+
     /// the user defined type
-,   TB_SINGLETON_TYPE_USER                  = 13
+,   TB_SINGLETON_TYPE_USER                  = 14
 
 #endif
 
@@ -30,6 +30,7 @@
 #include "trace.h"
 #include "../libc/libc.h"
 #include "../platform/platform.h"
+#include "../platform/impl/file_offload.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
@@ -241,9 +242,10 @@ tb_void_t tb_trace_done_with_args(tb_char_t const* prefix, tb_char_t const* modu
 #ifndef TB_CONFIG_MICRO_ENABLE
         if ((g_mode & TB_TRACE_MODE_FILE) && g_file) 
         {
-            // done
+            // done, we cannot suspend the current coroutine with the locked spinlock
             tb_size_t size = p - g_line;
             tb_size_t writ = 0;
+            tb_file_offload_enter_direct();
             while (writ < size)
             {
                 // writ it
@@ -253,6 +255,7 @@ tb_void_t tb_trace_done_with_args(tb_char_t const* prefix, tb_char_t const* modu
                 // save size
                 writ += real;
             }
+            tb_file_offload_leave_direct();
         }
 #endif
 
@@ -313,6 +316,7 @@ tb_void_t tb_trace_tail(tb_char_t const* format, ...)
             // done
             tb_size_t size = p - g_line;
             tb_size_t writ = 0;
+            tb_file_offload_enter_direct();
             while (writ < size)
             {
                 // writ it
@@ -322,6 +326,7 @@ tb_void_t tb_trace_tail(tb_char_t const* format, ...)
                 // save size
                 writ += real;
             }
+            tb_file_offload_leave_direct();
         }
 #endif
 
@@ -343,7 +348,12 @@ tb_void_t tb_trace_sync()
 
     // sync it to file
 #ifndef TB_CONFIG_MICRO_ENABLE
-    if ((g_mode & TB_TRACE_MODE_FILE) && g_file) tb_file_sync(g_file);
+    if ((g_mode & TB_TRACE_MODE_FILE) && g_file)
+    {
+        tb_file_offload_enter_direct();
+        tb_file_sync(g_file);
+        tb_file_offload_leave_direct();
+    }
 #endif
 
     // leave
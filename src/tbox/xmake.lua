@@ -21,7 +21,7 @@ target("tbox")
     add_headers("../(tbox/utils/impl/*.h)")
 
     -- add packages
-    add_options("zlib", "mysql", "sqlite3", "openssl", "polarssl", "mbedtls", "pcre2", "pcre")
+    add_options("zlib", "zstd", "lz4", "brotli", "mysql", "sqlite3", "openssl", "polarssl", "mbedtls", "pcre2", "pcre")
 
     -- add options
     add_options("info", "float", "wchar", "exception", "deprecated")
@@ -31,7 +31,7 @@ target("tbox")
 
     -- add the common source files
     add_files("*.c") 
-    add_files("hash/bkdr.c", "hash/fnv32.c", "hash/adler32.c")
+    add_files("hash/bkdr.c", "hash/fnv32.c", "hash/adler32.c", "hash/xxh3.c")
     add_files("math/**.c") 
     add_files("libc/**.c|string/impl/**.c") 
     add_files("utils/*.c|option.c") 
@@ -115,13 +115,17 @@ target("tbox")
 
     -- add the source files for the zip module
     if is_option("zip") then 
-        add_files("zip/**.c|gzip.c|zlib.c|zlibraw.c|lzsw.c")
+        add_files("zip/**.c|gzip.c|zlib.c|zlibraw.c|pdeflate.c|zstd.c|lz4.c|brotli.c|lzsw.c")
         add_files("stream/impl/filter/zip.c")
         if is_option("zlib") then 
             add_files("zip/gzip.c") 
             add_files("zip/zlib.c") 
             add_files("zip/zlibraw.c") 
+            add_files("zip/pdeflate.c") 
         end
+        if is_option("zstd") then add_files("zip/zstd.c") end
+        if is_option("lz4") then add_files("zip/lz4.c") end
+        if is_option("brotli") then add_files("zip/brotli.c") end
     end
 
     -- add the source files for the database module
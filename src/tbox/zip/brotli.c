@@ -0,0 +1,227 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        brotli.c
+ * @ingroup     zip
+ *
+ */
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "brotli"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "brotli.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implements
+ */
+static __tb_inline__ tb_zip_brotli_t* tb_zip_brotli_cast(tb_zip_ref_t zip)
+{
+    // check
+    tb_assert_and_check_return_val(zip && zip->algo == TB_ZIP_ALGO_BROTLI, tb_null);
+
+    // cast it
+    return (tb_zip_brotli_t*)zip;
+}
+static tb_long_t tb_zip_brotli_spak_deflate(tb_zip_ref_t zip, tb_static_stream_ref_t ist, tb_static_stream_ref_t ost, tb_long_t sync)
+{
+    // check
+    tb_zip_brotli_t* brotli = tb_zip_brotli_cast(zip);
+    tb_assert_and_check_return_val(brotli && brotli->encoder && ist && ost, -1);
+
+    // ended? 
+    tb_check_return_val(!BrotliEncoderIsFinished(brotli->encoder), -1);
+
+    // the input stream, @note maybe null for flush the end data
+    tb_byte_t* ip = ist->p;
+    tb_byte_t* ie = ist->e;
+    tb_size_t  in = ip? (tb_size_t)(ie - ip) : 0;
+
+    // the output stream
+    tb_byte_t* op = ost->p;
+    tb_byte_t* oe = ost->e;
+    tb_assert_and_check_return_val(op && oe, -1);
+
+    /* the operation
+     *
+     * @note the operation and the input data must not be changed until the previous flush is completed
+     */
+    BrotliEncoderOperation operation = BROTLI_OPERATION_PROCESS;
+    if (brotli->bflushing)
+    {
+        operation = BROTLI_OPERATION_FLUSH;
+        in = tb_min(in, brotli->flush_left);
+    }
+    else if (sync > 0) operation = BROTLI_OPERATION_FLUSH;
+    else if (sync < 0) operation = BROTLI_OPERATION_FINISH;
+
+    // attach buffers
+    tb_size_t           available_in = in;
+    tb_byte_t const*    next_in = ip;
+    tb_size_t           available_out = (tb_size_t)(oe - op);
+    tb_byte_t*          next_out = op;
+
+    // deflate 
+    tb_bool_t ok = BrotliEncoderCompressStream(brotli->encoder, operation, &available_in, &next_in, &available_out, &next_out, tb_null)? tb_true : tb_false;
+    tb_assertf_and_check_return_val(ok, -1, "sync: %ld, deflate failed!", sync);
+    tb_trace_d("deflate: %lu => %lu, sync: %ld", in - available_in, (tb_size_t)(next_out - op), sync);
+
+    // update the flush state
+    if (operation == BROTLI_OPERATION_FLUSH)
+    {
+        brotli->bflushing   = (available_in || BrotliEncoderHasMoreOutput(brotli->encoder))? tb_true : tb_false;
+        brotli->flush_left  = available_in;
+    }
+
+    // update 
+    if (ip) ist->p = (tb_byte_t*)next_in;
+    ost->p = next_out;
+
+    // end?
+    tb_check_return_val(!BrotliEncoderIsFinished(brotli->encoder) || ost->p > op, -1);
+
+    // ok?
+    return (ost->p - op);
+}
+static tb_long_t tb_zip_brotli_spak_inflate(tb_zip_ref_t zip, tb_static_stream_ref_t ist, tb_static_stream_ref_t ost, tb_long_t sync)
+{
+    // check
+    tb_zip_brotli_t* brotli = tb_zip_brotli_cast(zip);
+    tb_assert_and_check_return_val(brotli && brotli->decoder && ist && ost, -1);
+
+    // the input stream, @note maybe null for flushing the buffered output data if sync
+    tb_byte_t* ip = ist->p;
+    tb_byte_t* ie = ist->e;
+    tb_check_return_val((ip && ip < ie) || sync, 0);
+
+    // the output stream
+    tb_byte_t* op = ost->p;
+    tb_byte_t* oe = ost->e;
+    tb_assert_and_check_return_val(op && oe, -1);
+
+    // attach buffers
+    tb_size_t           available_in = ip? (tb_size_t)(ie - ip) : 0;
+    tb_byte_t const*    next_in = ip;
+    tb_size_t           available_out = (tb_size_t)(oe - op);
+    tb_byte_t*          next_out = op;
+
+    // inflate 
+    BrotliDecoderResult r = BrotliDecoderDecompressStream(brotli->decoder, &available_in, &next_in, &available_out, &next_out, tb_null);
+    tb_assertf_and_check_return_val(r != BROTLI_DECODER_RESULT_ERROR, -1, "sync: %ld, error: %s", sync, BrotliDecoderErrorString(BrotliDecoderGetErrorCode(brotli->decoder)));
+    tb_trace_d("inflate: %lu => %lu, sync: %ld", (tb_size_t)(next_in - ip), (tb_size_t)(next_out - op), sync);
+
+    // update 
+    if (ip) ist->p = (tb_byte_t*)next_in;
+    ost->p = next_out;
+
+    // end?
+    tb_check_return_val(r != BROTLI_DECODER_RESULT_SUCCESS || ost->p > op, -1);
+
+    // ok?
+    return (ost->p - op);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_zip_ref_t tb_zip_brotli_init(tb_size_t action, tb_zip_option_ref_t option)
+{   
+    // done
+    tb_bool_t           ok = tb_false;
+    tb_zip_brotli_t*    zip = tb_null;
+    do
+    {
+        // make zip
+        zip = tb_malloc0_type(tb_zip_brotli_t);
+        tb_assert_and_check_break(zip);
+        
+        // init algo
+        zip->base.algo = TB_ZIP_ALGO_BROTLI;
+
+        // the custom dictionary is not supported
+        if (option && option->dict && option->dict_size)
+            tb_trace_w("the dictionary is not supported for brotli, ignore it!");
+
+        // open stream
+        if (action == TB_ZIP_ACTION_INFLATE)
+        {
+            // init spak
+            zip->base.spak = tb_zip_brotli_spak_inflate;
+
+            // init decoder
+            zip->decoder = BrotliDecoderCreateInstance(tb_null, tb_null, tb_null);
+            tb_assert_and_check_break(zip->decoder);
+        }
+        else if (action == TB_ZIP_ACTION_DEFLATE)
+        {
+            // init spak
+            zip->base.spak = tb_zip_brotli_spak_deflate;
+
+            // init encoder
+            zip->encoder = BrotliEncoderCreateInstance(tb_null, tb_null, tb_null);
+            tb_assert_and_check_break(zip->encoder);
+
+            // init level
+            if (option && option->level != TB_ZIP_LEVEL_DEFAULT)
+            {
+                tb_uint32_t level = (tb_uint32_t)tb_min(tb_max(option->level, BROTLI_MIN_QUALITY), BROTLI_MAX_QUALITY);
+                if (!BrotliEncoderSetParameter(zip->encoder, BROTLI_PARAM_QUALITY, level)) break;
+            }
+        }
+
+        // init action after initializing stream
+        zip->base.action = (tb_uint16_t)action;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (zip) tb_zip_brotli_exit((tb_zip_ref_t)zip);
+        zip = tb_null;
+    }
+
+    // ok?
+    return (tb_zip_ref_t)zip;
+}
+tb_void_t tb_zip_brotli_exit(tb_zip_ref_t zip)
+{
+    // check
+    tb_zip_brotli_t* brotli = tb_zip_brotli_cast(zip);
+    tb_assert_and_check_return(brotli);
+
+    // exit stream
+    if (brotli->encoder) BrotliEncoderDestroyInstance(brotli->encoder);
+    brotli->encoder = tb_null;
+    if (brotli->decoder) BrotliDecoderDestroyInstance(brotli->decoder);
+    brotli->decoder = tb_null;
+
+    // free it
+    tb_free(brotli);
+}
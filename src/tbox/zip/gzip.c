@@ -69,6 +69,9 @@ static tb_long_t tb_zip_gzip_spak_deflate(tb_zip_ref_t zip, tb_static_stream_ref
 
     // deflate 
     tb_int_t r = deflate(&gzip->zstream, sync > 0? Z_SYNC_FLUSH : (sync < 0? Z_FINISH : Z_NO_FLUSH));
+
+    // no progress? it is not fatal if there is nothing to be flushed
+    if (r == Z_BUF_ERROR) r = Z_OK;
     tb_assertf_and_check_return_val(r == Z_OK || r == Z_STREAM_END, -1, "sync: %ld, error: %d", sync, r);
     tb_trace_d("deflate: %u => %u, sync: %ld", (tb_size_t)(ie - ip), (tb_size_t)((tb_byte_t*)gzip->zstream.next_out - op), sync);
 
@@ -124,7 +127,7 @@ static tb_long_t tb_zip_gzip_spak_inflate(tb_zip_ref_t zip, tb_static_stream_ref
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
-tb_zip_ref_t tb_zip_gzip_init(tb_size_t action)
+tb_zip_ref_t tb_zip_gzip_init(tb_size_t action, tb_zip_option_ref_t option)
 {   
     // done
     tb_bool_t       ok = tb_false;
@@ -138,6 +141,10 @@ tb_zip_ref_t tb_zip_gzip_init(tb_size_t action)
         // init algo
         zip->base.algo = TB_ZIP_ALGO_GZIP;
 
+        // init level
+        tb_int_t level = Z_DEFAULT_COMPRESSION;
+        if (option && option->level != TB_ZIP_LEVEL_DEFAULT) level = (tb_int_t)tb_min(tb_max(option->level, Z_NO_COMPRESSION), Z_BEST_COMPRESSION);
+
         // open zstream
         if (action == TB_ZIP_ACTION_INFLATE)
         {
@@ -153,7 +160,7 @@ tb_zip_ref_t tb_zip_gzip_init(tb_size_t action)
             zip->base.spak = tb_zip_gzip_spak_deflate;
 
             // init zstream
-            if (deflateInit2(&((tb_zip_gzip_t*)zip)->zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) break;
+            if (deflateInit2(&((tb_zip_gzip_t*)zip)->zstream, level, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) break;
         }
 
         // init action after initializing zstream
@@ -63,10 +63,11 @@ typedef struct __tb_zip_gzip_t
 /* init gzip 
  *
  * @param action    the action
+ * @param option    the option, maybe null
  *
  * @return          the zip
  */
-tb_zip_ref_t        tb_zip_gzip_init(tb_size_t action);
+tb_zip_ref_t        tb_zip_gzip_init(tb_size_t action, tb_zip_option_ref_t option);
 
 /* exit gzip
  *
@@ -0,0 +1,261 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        lz4.c
+ * @ingroup     zip
+ *
+ */
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "lz4"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "lz4.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the input block size for deflating
+#define TB_ZIP_LZ4_BLOCK_SIZE               (1 << 16)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implements
+ */
+static __tb_inline__ tb_zip_lz4_t* tb_zip_lz4_cast(tb_zip_ref_t zip)
+{
+    // check
+    tb_assert_and_check_return_val(zip && zip->algo == TB_ZIP_ALGO_LZ4, tb_null);
+
+    // cast it
+    return (tb_zip_lz4_t*)zip;
+}
+static tb_long_t tb_zip_lz4_spak_deflate(tb_zip_ref_t zip, tb_static_stream_ref_t ist, tb_static_stream_ref_t ost, tb_long_t sync)
+{
+    // check
+    tb_zip_lz4_t* lz4 = tb_zip_lz4_cast(zip);
+    tb_assert_and_check_return_val(lz4 && lz4->cctx && lz4->data && ist && ost, -1);
+
+    // the input stream, @note maybe null for flush the end data
+    tb_byte_t* ip = ist->p;
+    tb_byte_t* ie = ist->e;
+
+    // the output stream
+    tb_byte_t* ob = ost->p;
+    tb_byte_t* op = ost->p;
+    tb_byte_t* oe = ost->e;
+    tb_assert_and_check_return_val(op && oe, -1);
+
+    // deflate 
+    tb_size_t r = 0;
+    while (op < oe)
+    {
+        // drain the pending data first
+        if (lz4->posi < lz4->size)
+        {
+            tb_size_t n = tb_min(lz4->size - lz4->posi, (tb_size_t)(oe - op));
+            tb_memcpy(op, lz4->data + lz4->posi, n);
+            lz4->posi += n;
+            op += n;
+            continue;
+        }
+
+        // ended?
+        tb_check_break(!lz4->bended);
+
+        // clear the pending data
+        lz4->posi = 0;
+        lz4->size = 0;
+
+        // begin the frame header
+        if (!lz4->bbegun)
+        {
+            r = LZ4F_compressBegin(lz4->cctx, lz4->data, lz4->maxn, &lz4->prefs);
+            lz4->bbegun = 1;
+        }
+        // compress the next input block
+        else if (ip && ip < ie)
+        {
+            tb_size_t n = tb_min((tb_size_t)(ie - ip), TB_ZIP_LZ4_BLOCK_SIZE);
+            r = LZ4F_compressUpdate(lz4->cctx, lz4->data, lz4->maxn, ip, n, tb_null);
+            if (!LZ4F_isError(r)) ip += n;
+        }
+        // end the frame
+        else if (sync < 0)
+        {
+            r = LZ4F_compressEnd(lz4->cctx, lz4->data, lz4->maxn, tb_null);
+            lz4->bended = 1;
+        }
+        // flush the buffered data, no more data if it returns zero
+        else if (sync > 0)
+        {
+            r = LZ4F_flush(lz4->cctx, lz4->data, lz4->maxn, tb_null);
+            tb_check_break(r);
+        }
+        // no more input data
+        else break;
+
+        // failed?
+        tb_assertf_and_check_return_val(!LZ4F_isError(r), -1, "sync: %ld, error: %s", sync, LZ4F_getErrorName(r));
+
+        // save the pending data size
+        lz4->size = r;
+    }
+
+    // trace
+    tb_trace_d("deflate: %lu => %lu, sync: %ld", ip? (tb_size_t)(ip - ist->p) : 0, (tb_size_t)(op - ob), sync);
+
+    // update 
+    if (ip) ist->p = ip;
+    ost->p = op;
+
+    // end?
+    tb_check_return_val(!lz4->bended || lz4->posi < lz4->size || ost->p > ob, -1);
+
+    // ok?
+    return (ost->p - ob);
+}
+static tb_long_t tb_zip_lz4_spak_inflate(tb_zip_ref_t zip, tb_static_stream_ref_t ist, tb_static_stream_ref_t ost, tb_long_t sync)
+{
+    // check
+    tb_zip_lz4_t* lz4 = tb_zip_lz4_cast(zip);
+    tb_assert_and_check_return_val(lz4 && lz4->dctx && ist && ost, -1);
+
+    // the input stream, @note maybe null for flushing the buffered output data if sync
+    tb_byte_t* ip = ist->p;
+    tb_byte_t* ie = ist->e;
+    tb_check_return_val((ip && ip < ie) || sync, 0);
+
+    // the output stream
+    tb_byte_t* op = ost->p;
+    tb_byte_t* oe = ost->e;
+    tb_assert_and_check_return_val(op && oe, -1);
+
+    // inflate 
+    tb_size_t isize = ip? (tb_size_t)(ie - ip) : 0;
+    tb_size_t osize = (tb_size_t)(oe - op);
+    tb_size_t r = LZ4F_decompress(lz4->dctx, op, &osize, ip, &isize, tb_null);
+    tb_assertf_and_check_return_val(!LZ4F_isError(r), -1, "sync: %ld, error: %s", sync, LZ4F_getErrorName(r));
+    tb_trace_d("inflate: %lu => %lu, sync: %ld", isize, osize, sync);
+
+    // update 
+    if (ip) ist->p = ip + isize;
+    ost->p = op + osize;
+
+    // end? the frame has been decoded and flushed completely
+    tb_check_return_val(r || ost->p > op, -1);
+
+    // ok?
+    return (ost->p - op);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_zip_ref_t tb_zip_lz4_init(tb_size_t action, tb_zip_option_ref_t option)
+{   
+    // done
+    tb_bool_t       ok = tb_false;
+    tb_zip_lz4_t*   zip = tb_null;
+    do
+    {
+        // make zip
+        zip = tb_malloc0_type(tb_zip_lz4_t);
+        tb_assert_and_check_break(zip);
+        
+        // init algo
+        zip->base.algo = TB_ZIP_ALGO_LZ4;
+
+        // the custom dictionary is not supported
+        if (option && option->dict && option->dict_size)
+            tb_trace_w("the dictionary is not supported for lz4, ignore it!");
+
+        // open stream
+        if (action == TB_ZIP_ACTION_INFLATE)
+        {
+            // init spak
+            zip->base.spak = tb_zip_lz4_spak_inflate;
+
+            // init dctx
+            if (LZ4F_isError(LZ4F_createDecompressionContext(&zip->dctx, LZ4F_VERSION))) break;
+        }
+        else if (action == TB_ZIP_ACTION_DEFLATE)
+        {
+            // init spak
+            zip->base.spak = tb_zip_lz4_spak_deflate;
+
+            // init cctx
+            if (LZ4F_isError(LZ4F_createCompressionContext(&zip->cctx, LZ4F_VERSION))) break;
+
+            // init preferences
+            tb_memset(&zip->prefs, 0, sizeof(zip->prefs));
+            zip->prefs.frameInfo.blockSizeID = LZ4F_max64KB;
+            if (option && option->level != TB_ZIP_LEVEL_DEFAULT) 
+                zip->prefs.compressionLevel = (tb_int_t)tb_min(option->level, LZ4F_compressionLevel_max());
+
+            // init the pending data, it can hold the output of one input block, the header or the footer
+            zip->maxn = LZ4F_compressBound(TB_ZIP_LZ4_BLOCK_SIZE, &zip->prefs);
+            zip->data = tb_malloc_bytes(zip->maxn);
+            tb_assert_and_check_break(zip->data);
+        }
+
+        // init action after initializing stream
+        zip->base.action = (tb_uint16_t)action;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (zip) tb_zip_lz4_exit((tb_zip_ref_t)zip);
+        zip = tb_null;
+    }
+
+    // ok?
+    return (tb_zip_ref_t)zip;
+}
+tb_void_t tb_zip_lz4_exit(tb_zip_ref_t zip)
+{
+    // check
+    tb_zip_lz4_t* lz4 = tb_zip_lz4_cast(zip);
+    tb_assert_and_check_return(lz4);
+
+    // exit context
+    if (lz4->cctx) LZ4F_freeCompressionContext(lz4->cctx);
+    lz4->cctx = tb_null;
+    if (lz4->dctx) LZ4F_freeDecompressionContext(lz4->dctx);
+    lz4->dctx = tb_null;
+
+    // exit the pending data
+    if (lz4->data) tb_free(lz4->data);
+    lz4->data = tb_null;
+
+    // free it
+    tb_free(lz4);
+}
@@ -0,0 +1,105 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        lz4.h
+ * @ingroup     zip
+ *
+ */
+#ifndef TB_ZIP_LZ4_H
+#define TB_ZIP_LZ4_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#ifdef TB_CONFIG_PACKAGE_HAVE_LZ4
+#   include <lz4frame.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the lz4 zip type
+typedef struct __tb_zip_lz4_t
+{
+    // the zip base
+    tb_zip_t                    base;
+
+    // the compression and decompression context
+#ifdef TB_CONFIG_PACKAGE_HAVE_LZ4
+    LZ4F_cctx*                  cctx;
+    LZ4F_dctx*                  dctx;
+
+    // the preferences for deflating
+    LZ4F_preferences_t          prefs;
+#endif
+
+    /* the pending output data for deflating
+     *
+     * LZ4F_compressUpdate() requires the whole bound size of the output buffer,
+     * so we compress the input block to it first and drain it to the output stream later
+     */
+    tb_byte_t*                  data;
+
+    // the pending data size and position
+    tb_size_t                   size;
+    tb_size_t                   posi;
+
+    // the pending data maxn
+    tb_size_t                   maxn;
+
+    // the frame has been begun or ended?
+    tb_uint8_t                  bbegun : 1;
+    tb_uint8_t                  bended : 1;
+
+}tb_zip_lz4_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* init lz4 
+ *
+ * @param action    the action
+ * @param option    the option, maybe null
+ *
+ * @return          the zip
+ */
+tb_zip_ref_t        tb_zip_lz4_init(tb_size_t action, tb_zip_option_ref_t option);
+
+/* exit lz4
+ *
+ * @param zip       the zip
+ */
+tb_void_t           tb_zip_lz4_exit(tb_zip_ref_t zip);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -0,0 +1,626 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        pdeflate.c
+ * @ingroup     zip
+ *
+ */
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "pdeflate"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "pdeflate.h"
+#include "../platform/atomic.h"
+#include "../platform/semaphore.h"
+#include "../platform/thread_pool.h"
+#include "../utils/bits.h"
+#include <zlib.h>
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the window size of the deflate
+#define TB_ZIP_PDEFLATE_WINDOW_SIZE         (32 * 1024)
+
+// the minimum block size
+#define TB_ZIP_PDEFLATE_BLOCK_SIZE_MIN      (32 * 1024)
+
+// the maximum worker count
+#define TB_ZIP_PDEFLATE_WORKERS_MAXN        (64)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the parallel deflater type
+struct __tb_zip_pdeflate_t;
+
+// the parallel deflater block type
+typedef struct __tb_zip_pdeflate_block_t
+{
+    // the deflater
+    struct __tb_zip_pdeflate_t*     pdeflate;
+
+    // the input data, the dictionary data + the block data
+    tb_byte_t*                      data;
+
+    // the dictionary size
+    tb_size_t                       dict_size;
+
+    // the block data size
+    tb_size_t                       size;
+
+    // the output data
+    tb_byte_t*                      odata;
+
+    // the output size
+    tb_size_t                       osize;
+
+    // the output position
+    tb_size_t                       oposi;
+
+    // the check sum of the block data, crc32 for gzip and adler32 for zlibraw
+    tb_uint32_t                     check;
+
+    // is the last block?
+    tb_uint8_t                      blast   : 1;
+
+    // compress ok?
+    tb_uint8_t                      bok     : 1;
+
+    // is finished? it will be set by the worker
+    tb_atomic_t                     finished;
+
+}tb_zip_pdeflate_block_t;
+
+// the parallel deflater type
+typedef struct __tb_zip_pdeflate_t
+{
+    // the zip base
+    tb_zip_t                        base;
+
+    // the actual algorithm
+    tb_size_t                       algo;
+
+    // the compression level
+    tb_int_t                        level;
+
+    // the block size
+    tb_size_t                       block_size;
+
+    // the output maxn of the block
+    tb_size_t                       block_omaxn;
+
+    // the blocks, only the posted and filling blocks are used
+    tb_zip_pdeflate_block_t*        blocks;
+
+    // the blocks maxn
+    tb_size_t                       blocks_maxn;
+
+    // the head index of the posted blocks
+    tb_size_t                       blocks_head;
+
+    // the posted blocks count
+    tb_size_t                       blocks_size;
+
+    // the finished semaphore
+    tb_semaphore_ref_t              semaphore;
+
+    // the semaphore posts which have not been waited, each posted block will post it once
+    tb_size_t                       semaphore_posts;
+
+    // the last window data of the posted input data
+    tb_byte_t                       window[TB_ZIP_PDEFLATE_WINDOW_SIZE];
+
+    // the window size
+    tb_size_t                       window_size;
+
+    // the check sum of all drained blocks
+    tb_uint32_t                     check;
+
+    // the input size of all drained blocks, modulo 2^32 for the gzip trailer
+    tb_uint32_t                     isize;
+
+    // the header or trailer data
+    tb_byte_t                       extra[16];
+
+    // the extra size
+    tb_size_t                       extra_size;
+
+    // the extra position
+    tb_size_t                       extra_posi;
+
+    // is filling block?
+    tb_uint8_t                      bfilling    : 1;
+
+    // the last block has been posted?
+    tb_uint8_t                      bfinished   : 1;
+
+    // all data has been outputed?
+    tb_uint8_t                      bended      : 1;
+
+    // failed?
+    tb_uint8_t                      bfailed     : 1;
+
+}tb_zip_pdeflate_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static __tb_inline__ tb_zip_pdeflate_t* tb_zip_pdeflate_cast(tb_zip_ref_t zip)
+{
+    // check
+    tb_assert_and_check_return_val(zip && zip->bparallel && zip->action == TB_ZIP_ACTION_DEFLATE, tb_null);
+
+    // cast it
+    return (tb_zip_pdeflate_t*)zip;
+}
+static tb_void_t tb_zip_pdeflate_block_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_zip_pdeflate_block_t* block = (tb_zip_pdeflate_block_t*)priv;
+    tb_assert_and_check_return(block && block->pdeflate && block->data && block->odata);
+
+    // the deflater
+    tb_zip_pdeflate_t* pdeflate = block->pdeflate;
+
+    // done
+    z_stream    zstream;
+    tb_bool_t   binited = tb_false;
+    block->bok   = 0;
+    block->osize = 0;
+    block->oposi = 0;
+    do
+    {
+        // init zstream, the raw deflate data without header
+        tb_memset(&zstream, 0, sizeof(z_stream));
+        if (deflateInit2(&zstream, pdeflate->level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) break;
+        binited = tb_true;
+
+        // set the last window data of the previous block as the dictionary 
+        if (block->dict_size && deflateSetDictionary(&zstream, (Bytef const*)block->data, (uInt)block->dict_size) != Z_OK) break;
+
+        // attach zstream
+        zstream.next_in     = (Bytef*)block->data + block->dict_size;
+        zstream.avail_in    = (uInt)block->size;
+        zstream.next_out    = (Bytef*)block->odata;
+        zstream.avail_out   = (uInt)pdeflate->block_omaxn;
+
+        /* deflate it
+         *
+         * the sync flush will align the non-last block to the byte boundary without the final bit,
+         * so we can concatenate them directly
+         */
+        tb_int_t r = deflate(&zstream, block->blast? Z_FINISH : Z_SYNC_FLUSH);
+        tb_assertf_and_check_break(block->blast? r == Z_STREAM_END : (r == Z_OK && !zstream.avail_in && zstream.avail_out), "block: %lu, error: %d", block->size, r);
+
+        // save the output size
+        block->osize = (tb_size_t)((tb_byte_t*)zstream.next_out - block->odata);
+
+        // compute the check sum of the block data
+        if (pdeflate->algo == TB_ZIP_ALGO_GZIP) 
+            block->check = (tb_uint32_t)crc32(0, (Bytef const*)block->data + block->dict_size, (uInt)block->size);
+        else 
+            block->check = (tb_uint32_t)adler32(1, (Bytef const*)block->data + block->dict_size, (uInt)block->size);
+
+        // ok
+        block->bok = 1;
+
+    } while (0);
+
+    // exit zstream
+    if (binited) deflateEnd(&zstream);
+
+    // trace
+    tb_trace_d("block: %lu => %lu, last: %d, ok: %d", block->size, block->osize, block->blast, block->bok);
+
+    /* finished, @note the block may be reused by the deflater after this
+     *
+     * and the deflater may be exited after the block has been finished, 
+     * so it will wait all semaphore posts of the posted blocks before exiting
+     */
+    tb_atomic_set(&block->finished, 1);
+    tb_semaphore_post(pdeflate->semaphore, 1);
+}
+static tb_void_t tb_zip_pdeflate_post(tb_zip_pdeflate_t* pdeflate, tb_bool_t blast)
+{
+    // check
+    tb_assert_and_check_return(pdeflate && pdeflate->bfilling && pdeflate->blocks_size < pdeflate->blocks_maxn);
+
+    // the filling block
+    tb_zip_pdeflate_block_t* block = &pdeflate->blocks[(pdeflate->blocks_head + pdeflate->blocks_size) % pdeflate->blocks_maxn];
+
+    // save the last window data for the next block
+    tb_size_t size = block->dict_size + block->size;
+    tb_size_t tail = tb_min(size, TB_ZIP_PDEFLATE_WINDOW_SIZE);
+    tb_memcpy(pdeflate->window, block->data + size - tail, tail);
+    pdeflate->window_size = tail;
+
+    // post it
+    block->blast = blast? 1 : 0;
+    tb_atomic_set0(&block->finished);
+    pdeflate->blocks_size++;
+    pdeflate->bfilling = 0;
+    if (blast) pdeflate->bfinished = 1;
+    pdeflate->semaphore_posts++;
+    if (!tb_thread_pool_task_post(tb_thread_pool(), "pdeflate", tb_zip_pdeflate_block_done, tb_null, block, tb_false))
+    {
+        // post failed? compress it directly
+        tb_zip_pdeflate_block_done(tb_null, block);
+    }
+}
+static tb_bool_t tb_zip_pdeflate_fill(tb_zip_pdeflate_t* pdeflate)
+{
+    // check
+    tb_assert_and_check_return_val(pdeflate && !pdeflate->bfinished, tb_false);
+
+    // filling now?
+    tb_check_return_val(!pdeflate->bfilling, tb_true);
+
+    // no free blocks?
+    tb_check_return_val(pdeflate->blocks_size < pdeflate->blocks_maxn, tb_false);
+
+    // init the filling block with the last window data
+    tb_zip_pdeflate_block_t* block = &pdeflate->blocks[(pdeflate->blocks_head + pdeflate->blocks_size) % pdeflate->blocks_maxn];
+    if (pdeflate->window_size) tb_memcpy(block->data, pdeflate->window, pdeflate->window_size);
+    block->dict_size    = pdeflate->window_size;
+    block->size         = 0;
+    pdeflate->bfilling  = 1;
+
+    // ok
+    return tb_true;
+}
+static tb_void_t tb_zip_pdeflate_wait(tb_zip_pdeflate_t* pdeflate)
+{
+    // check
+    tb_assert_and_check_return(pdeflate && pdeflate->blocks_size);
+
+    // wait the head block 
+    tb_zip_pdeflate_block_t* block = &pdeflate->blocks[pdeflate->blocks_head];
+    while (!tb_atomic_get(&block->finished))
+    {
+        if (tb_semaphore_wait(pdeflate->semaphore, -1) <= 0) break;
+        pdeflate->semaphore_posts--;
+    }
+}
+static tb_void_t tb_zip_pdeflate_drain(tb_zip_pdeflate_t* pdeflate, tb_byte_t** pop, tb_byte_t* oe)
+{
+    // check
+    tb_assert_and_check_return(pdeflate && pop && *pop && oe);
+
+    // drain all finished blocks in order
+    tb_byte_t* op = *pop;
+    while (op < oe)
+    {
+        // write the header or trailer data first
+        if (pdeflate->extra_posi < pdeflate->extra_size)
+        {
+            tb_size_t size = tb_min(pdeflate->extra_size - pdeflate->extra_posi, (tb_size_t)(oe - op));
+            tb_memcpy(op, pdeflate->extra + pdeflate->extra_posi, size);
+            pdeflate->extra_posi += size;
+            op += size;
+            continue;
+        }
+
+        // no posted blocks? 
+        tb_check_break(pdeflate->blocks_size);
+
+        // the head block is not finished?
+        tb_zip_pdeflate_block_t* block = &pdeflate->blocks[pdeflate->blocks_head];
+        tb_check_break(tb_atomic_get(&block->finished));
+
+        // failed?
+        if (!block->bok)
+        {
+            pdeflate->bfailed = 1;
+            break;
+        }
+
+        // write the output data of this block
+        if (block->oposi < block->osize)
+        {
+            tb_size_t size = tb_min(block->osize - block->oposi, (tb_size_t)(oe - op));
+            tb_memcpy(op, block->odata + block->oposi, size);
+            block->oposi += size;
+            op += size;
+        }
+
+        // this block has been drained?
+        if (block->oposi == block->osize)
+        {
+            // combine the check sum
+            if (pdeflate->algo == TB_ZIP_ALGO_GZIP) 
+                pdeflate->check = (tb_uint32_t)crc32_combine(pdeflate->check, block->check, (z_off_t)block->size);
+            else 
+                pdeflate->check = (tb_uint32_t)adler32_combine(pdeflate->check, block->check, (z_off_t)block->size);
+            pdeflate->isize += (tb_uint32_t)block->size;
+
+            // make the trailer if this block is the last block
+            if (block->blast)
+            {
+                pdeflate->extra_size = 0;
+                pdeflate->extra_posi = 0;
+                if (pdeflate->algo == TB_ZIP_ALGO_GZIP)
+                {
+                    tb_bits_set_u32_le(pdeflate->extra, pdeflate->check);
+                    tb_bits_set_u32_le(pdeflate->extra + 4, pdeflate->isize);
+                    pdeflate->extra_size = 8;
+                }
+                else
+                {
+                    tb_bits_set_u32_be(pdeflate->extra, pdeflate->check);
+                    pdeflate->extra_size = 4;
+                }
+            }
+
+            // remove this block
+            pdeflate->blocks_head = (pdeflate->blocks_head + 1) % pdeflate->blocks_maxn;
+            pdeflate->blocks_size--;
+        }
+    }
+
+    // all data has been outputed?
+    if (pdeflate->bfinished && !pdeflate->blocks_size && pdeflate->extra_posi == pdeflate->extra_size)
+        pdeflate->bended = 1;
+
+    // update the output pointer
+    *pop = op;
+}
+static tb_long_t tb_zip_pdeflate_spak(tb_zip_ref_t zip, tb_static_stream_ref_t ist, tb_static_stream_ref_t ost, tb_long_t sync)
+{
+    // check
+    tb_zip_pdeflate_t* pdeflate = tb_zip_pdeflate_cast(zip);
+    tb_assert_and_check_return_val(pdeflate && ist && ost, -1);
+
+    // ended or failed? 
+    tb_check_return_val(!pdeflate->bended && !pdeflate->bfailed, -1);
+
+    // the input stream, @note maybe null for flush the end data
+    tb_byte_t* ip = ist->p;
+    tb_byte_t* ie = ist->e;
+    if (!ip) ie = ip;
+
+    // the output stream
+    tb_byte_t* ob = ost->p;
+    tb_byte_t* op = ost->p;
+    tb_byte_t* oe = ost->e;
+    tb_assert_and_check_return_val(op && oe, -1);
+
+    // done
+    while (1)
+    {
+        // drain the finished blocks
+        tb_zip_pdeflate_drain(pdeflate, &op, oe);
+        tb_assert_and_check_break(!pdeflate->bfailed);
+
+        // fill the input data into blocks
+        while (ip < ie && !pdeflate->bfinished && tb_zip_pdeflate_fill(pdeflate))
+        {
+            // the filling block
+            tb_zip_pdeflate_block_t* block = &pdeflate->blocks[(pdeflate->blocks_head + pdeflate->blocks_size) % pdeflate->blocks_maxn];
+
+            // copy data
+            tb_size_t size = tb_min((tb_size_t)(ie - ip), pdeflate->block_size - block->size);
+            tb_memcpy(block->data + block->dict_size + block->size, ip, size);
+            block->size += size;
+            ip += size;
+
+            // full? post it
+            if (block->size == pdeflate->block_size) tb_zip_pdeflate_post(pdeflate, tb_false);
+        }
+
+        // flush or end? post the filling block after all input data has been filled
+        if (ip == ie && sync && !pdeflate->bfinished)
+        {
+            // end? post the last block even if it is empty
+            if (sync < 0 && tb_zip_pdeflate_fill(pdeflate)) tb_zip_pdeflate_post(pdeflate, tb_true);
+            // flush? post the filling block if it is not empty 
+            else if (sync > 0 && pdeflate->bfilling && pdeflate->blocks[(pdeflate->blocks_head + pdeflate->blocks_size) % pdeflate->blocks_maxn].size)
+                tb_zip_pdeflate_post(pdeflate, tb_false);
+        }
+
+        /* need wait the head block?
+         *
+         * - the blocks are full and the input data has not been filled
+         * - flush or end all blocks 
+         */
+        tb_check_break(op < oe && pdeflate->blocks_size && (ip < ie || sync));
+
+        // wait the head block
+        tb_zip_pdeflate_wait(pdeflate);
+    }
+
+    // update the streams
+    if (ist->p) ist->p = ip;
+    ost->p = op;
+
+    // failed?
+    tb_check_return_val(!pdeflate->bfailed, -1);
+
+    // end?
+    tb_check_return_val(!pdeflate->bended || op > ob, -1);
+
+    // ok?
+    return (op - ob);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_zip_ref_t tb_zip_pdeflate_init(tb_size_t algo, tb_zip_option_ref_t option)
+{
+    // check
+    tb_assert_and_check_return_val(option && (algo == TB_ZIP_ALGO_ZLIBRAW || algo == TB_ZIP_ALGO_ZLIB || algo == TB_ZIP_ALGO_GZIP), tb_null);
+
+    // done
+    tb_bool_t           ok = tb_false;
+    tb_zip_pdeflate_t*  zip = tb_null;
+    do
+    {
+        // make zip
+        zip = tb_malloc0_type(tb_zip_pdeflate_t);
+        tb_assert_and_check_break(zip);
+
+        // init zip
+        zip->base.algo      = (tb_uint16_t)algo;
+        zip->base.action    = TB_ZIP_ACTION_DEFLATE;
+        zip->base.bparallel = 1;
+        zip->base.spak      = tb_zip_pdeflate_spak;
+        zip->algo           = algo;
+
+        // init level
+        zip->level = Z_DEFAULT_COMPRESSION;
+        if (option->level != TB_ZIP_LEVEL_DEFAULT) zip->level = (tb_int_t)tb_min(tb_max(option->level, Z_NO_COMPRESSION), Z_BEST_COMPRESSION);
+
+        // init block size
+        zip->block_size     = option->block_size? tb_max(option->block_size, TB_ZIP_PDEFLATE_BLOCK_SIZE_MIN) : TB_ZIP_BLOCK_SIZE_DEFAULT;
+        zip->block_omaxn    = (tb_size_t)compressBound((uLong)zip->block_size) + 64;
+
+        // init semaphore
+        zip->semaphore = tb_semaphore_init(0);
+        tb_assert_and_check_break(zip->semaphore);
+
+        // init blocks, one more block for filling the input data when all workers are busy
+        zip->blocks_maxn = tb_min(tb_max(option->workers, 1), TB_ZIP_PDEFLATE_WORKERS_MAXN) + 1;
+        zip->blocks = tb_nalloc0_type(zip->blocks_maxn, tb_zip_pdeflate_block_t);
+        tb_assert_and_check_break(zip->blocks);
+
+        // init block buffers
+        tb_size_t i = 0;
+        for (i = 0; i < zip->blocks_maxn; i++)
+        {
+            tb_zip_pdeflate_block_t* block = &zip->blocks[i];
+            block->pdeflate = zip;
+            block->data     = tb_malloc_bytes(TB_ZIP_PDEFLATE_WINDOW_SIZE + zip->block_size);
+            block->odata    = tb_malloc_bytes(zip->block_omaxn);
+            tb_assert_and_check_break(block->data && block->odata);
+        }
+        tb_assert_and_check_break(i == zip->blocks_maxn);
+
+        // the dictionary for zlib and zlibraw, only the last window data is used 
+        tb_byte_t const*    dict = algo != TB_ZIP_ALGO_GZIP? option->dict : tb_null;
+        tb_size_t           dict_size = dict? option->dict_size : 0;
+        if (dict && dict_size)
+        {
+            zip->window_size = tb_min(dict_size, TB_ZIP_PDEFLATE_WINDOW_SIZE);
+            tb_memcpy(zip->window, dict + dict_size - zip->window_size, zip->window_size);
+        }
+
+        // make header
+        if (algo == TB_ZIP_ALGO_GZIP)
+        {
+            // the gzip header: magic, deflate, no flags, no mtime, no extra flags, unix
+            static tb_byte_t const s_header[] = {0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03};
+            tb_memcpy(zip->extra, s_header, sizeof(s_header));
+            zip->extra_size = sizeof(s_header);
+
+            // init crc32
+            zip->check = (tb_uint32_t)crc32(0, tb_null, 0);
+        }
+        else
+        {
+            // zlib and zlibraw deflaters both make the zlib format, the compression level flags
+            tb_size_t flevel = 3;
+            if (zip->level == Z_DEFAULT_COMPRESSION || zip->level == 6) flevel = 2;
+            else if (zip->level < 2) flevel = 0;
+            else if (zip->level < 6) flevel = 1;
+
+            // the zlib header: deflate with 32K window, the level flags and the dictionary flag
+            tb_size_t header = (0x78 << 8) | (flevel << 6) | (dict_size? 0x20 : 0);
+            header += 31 - (header % 31);
+            tb_bits_set_u16_be(zip->extra, (tb_uint16_t)header);
+            zip->extra_size = 2;
+
+            // append the dictionary id
+            if (dict_size) 
+            {
+                tb_bits_set_u32_be(zip->extra + 2, (tb_uint32_t)adler32(1, (Bytef const*)dict, (uInt)dict_size));
+                zip->extra_size += 4;
+            }
+
+            // init adler32
+            zip->check = (tb_uint32_t)adler32(0, tb_null, 0);
+        }
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (zip) tb_zip_pdeflate_exit((tb_zip_ref_t)zip);
+        zip = tb_null;
+    }
+
+    // ok?
+    return (tb_zip_ref_t)zip;
+}
+tb_void_t tb_zip_pdeflate_exit(tb_zip_ref_t zip)
+{
+    // check
+    tb_zip_pdeflate_t* pdeflate = tb_zip_pdeflate_cast(zip);
+    tb_assert_and_check_return(pdeflate);
+
+    // wait all posted blocks, because they are being used by the workers
+    while (pdeflate->blocks_size)
+    {
+        tb_zip_pdeflate_wait(pdeflate);
+        pdeflate->blocks_head = (pdeflate->blocks_head + 1) % pdeflate->blocks_maxn;
+        pdeflate->blocks_size--;
+    }
+
+    // wait the remaining semaphore posts, the workers may have finished blocks but not posted the semaphore yet
+    while (pdeflate->semaphore_posts)
+    {
+        if (tb_semaphore_wait(pdeflate->semaphore, -1) <= 0) break;
+        pdeflate->semaphore_posts--;
+    }
+
+    // exit blocks
+    if (pdeflate->blocks)
+    {
+        tb_size_t i = 0;
+        for (i = 0; i < pdeflate->blocks_maxn; i++)
+        {
+            tb_zip_pdeflate_block_t* block = &pdeflate->blocks[i];
+            if (block->data) tb_free(block->data);
+            if (block->odata) tb_free(block->odata);
+        }
+        tb_free(pdeflate->blocks);
+    }
+    pdeflate->blocks = tb_null;
+
+    // exit semaphore
+    if (pdeflate->semaphore) tb_semaphore_exit(pdeflate->semaphore);
+    pdeflate->semaphore = tb_null;
+
+    // free it
+    tb_free(pdeflate);
+}
@@ -0,0 +1,67 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        pdeflate.h
+ * @ingroup     zip
+ *
+ */
+#ifndef TB_ZIP_PDEFLATE_H
+#define TB_ZIP_PDEFLATE_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* init the parallel deflater, like pigz
+ *
+ * the input data will be split into blocks and every block will be compressed on the thread pool,
+ * and the last 32K input data of the previous block is used as the dictionary of the next block,
+ * all blocks are terminated by the sync flush and stitched into one standard zlibraw, zlib or gzip stream in order.
+ *
+ * @param algo      the algorithm, only for zlibraw, zlib and gzip 
+ * @param option    the option
+ *
+ * @return          the zip
+ */
+tb_zip_ref_t        tb_zip_pdeflate_init(tb_size_t algo, tb_zip_option_ref_t option);
+
+/* exit the parallel deflater
+ *
+ * @param zip       the zip
+ */
+tb_void_t           tb_zip_pdeflate_exit(tb_zip_ref_t zip);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
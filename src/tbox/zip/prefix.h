@@ -32,6 +32,16 @@
 #include "../stream/static_stream.h"
 #include "../memory/memory.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/// the default compression level of the zip algorithm
+#define TB_ZIP_LEVEL_DEFAULT        TB_MINS32
+
+/// the default block size of the parallel deflater
+#define TB_ZIP_BLOCK_SIZE_DEFAULT   (128 * 1024)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -52,9 +62,48 @@ typedef enum __tb_zip_algo_t
 ,   TB_ZIP_ALGO_ZLIBRAW     = 1     //!< zlib: raw inflate & deflate
 ,   TB_ZIP_ALGO_ZLIB        = 2     //!< zlib
 ,   TB_ZIP_ALGO_GZIP        = 3     //!< gnu zip
+,   TB_ZIP_ALGO_ZSTD        = 4     //!< zstandard frame
+,   TB_ZIP_ALGO_LZ4         = 5     //!< lz4 frame
+,   TB_ZIP_ALGO_BROTLI      = 6     //!< brotli
 
 }tb_zip_algo_t;
 
+/// the zip option type
+typedef struct __tb_zip_option_t
+{
+    /*! the compression level, using the default level of the algorithm if be TB_ZIP_LEVEL_DEFAULT
+     *
+     * - zlib/zlibraw/gzip: 0 - 9
+     * - zstd: -(1 << 17) - 22, negative levels are the fast modes
+     * - lz4: 0 - 12, levels >= 3 use lz4hc
+     * - brotli: 0 - 11
+     */
+    tb_long_t               level;
+
+    /*! the dictionary data, optional
+     *
+     * @note it must be kept alive until the zip is exited and be same for inflating and deflating,
+     * only zlib, zlibraw and zstd support it now
+     */
+    tb_byte_t const*        dict;
+
+    /// the dictionary size
+    tb_size_t               dict_size;
+
+    /*! the worker count of the parallel deflater, disable it if be 0 or 1
+     *
+     * the input data will be split into blocks and compressed on the thread pool, 
+     * and the compressed blocks will be stitched into a standard stream in order.
+     *
+     * @note only for deflating zlibraw, zlib and gzip
+     */
+    tb_size_t               workers;
+
+    /// the block size of the parallel deflater, using TB_ZIP_BLOCK_SIZE_DEFAULT if be 0
+    tb_size_t               block_size;
+
+}tb_zip_option_t, *tb_zip_option_ref_t;
+
 // the zip type
 typedef struct __tb_zip_t
 {
@@ -64,6 +113,9 @@ typedef struct __tb_zip_t
     // the action
     tb_uint16_t             action;
 
+    // is the parallel deflater?
+    tb_uint16_t             bparallel;
+
     // spak
     tb_long_t               (*spak)(struct __tb_zip_t* zip, tb_static_stream_ref_t ist, tb_static_stream_ref_t ost, tb_long_t sync);
 
@@ -30,15 +30,23 @@
 #include "gzip.h"
 #include "zlib.h"
 #include "zlibraw.h"
+#include "zstd.h"
+#include "lz4.h"
+#include "brotli.h"
+#include "pdeflate.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
 
 tb_zip_ref_t tb_zip_init(tb_size_t algo, tb_size_t action)
+{
+    return tb_zip_init_with_option(algo, action, tb_null);
+}
+tb_zip_ref_t tb_zip_init_with_option(tb_size_t algo, tb_size_t action, tb_zip_option_ref_t option)
 {
     // table
-    static tb_zip_ref_t (*s_init[])(tb_size_t action) =
+    static tb_zip_ref_t (*s_init[])(tb_size_t action, tb_zip_option_ref_t option) =
     {
         tb_null
 #ifdef TB_CONFIG_PACKAGE_HAVE_ZLIB
@@ -49,12 +57,34 @@ tb_zip_ref_t tb_zip_init(tb_size_t algo, tb_size_t action)
     ,   tb_null
     ,   tb_null
     ,   tb_null
+#endif
+#ifdef TB_CONFIG_PACKAGE_HAVE_ZSTD
+    ,   tb_zip_zstd_init
+#else
+    ,   tb_null
+#endif
+#ifdef TB_CONFIG_PACKAGE_HAVE_LZ4
+    ,   tb_zip_lz4_init
+#else
+    ,   tb_null
+#endif
+#ifdef TB_CONFIG_PACKAGE_HAVE_BROTLI
+    ,   tb_zip_brotli_init
+#else
+    ,   tb_null
 #endif
     };
     tb_assert_and_check_return_val(algo < tb_arrayn(s_init) && s_init[algo], tb_null);
 
+#ifdef TB_CONFIG_PACKAGE_HAVE_ZLIB
+    // init the parallel deflater for zlibraw, zlib and gzip?
+    if (    option && option->workers > 1 && action == TB_ZIP_ACTION_DEFLATE
+        &&  (algo == TB_ZIP_ALGO_ZLIBRAW || algo == TB_ZIP_ALGO_ZLIB || algo == TB_ZIP_ALGO_GZIP))
+        return tb_zip_pdeflate_init(algo, option);
+#endif
+
     // init
-    return s_init[algo](action);
+    return s_init[algo](action, option);
 }
 tb_void_t tb_zip_exit(tb_zip_ref_t zip)
 {
@@ -73,10 +103,34 @@ tb_void_t tb_zip_exit(tb_zip_ref_t zip)
     ,   tb_null
     ,   tb_null
     ,   tb_null
+#endif
+#ifdef TB_CONFIG_PACKAGE_HAVE_ZSTD
+    ,   tb_zip_zstd_exit
+#else
+    ,   tb_null
+#endif
+#ifdef TB_CONFIG_PACKAGE_HAVE_LZ4
+    ,   tb_zip_lz4_exit
+#else
+    ,   tb_null
+#endif
+#ifdef TB_CONFIG_PACKAGE_HAVE_BROTLI
+    ,   tb_zip_brotli_exit
+#else
+    ,   tb_null
 #endif
     };
     tb_assert_and_check_return(zip->algo < tb_arrayn(s_exit) && s_exit[zip->algo]);
 
+#ifdef TB_CONFIG_PACKAGE_HAVE_ZLIB
+    // exit the parallel deflater
+    if (zip->bparallel) 
+    {
+        tb_zip_pdeflate_exit(zip);
+        return ;
+    }
+#endif
+
     // exit
     s_exit[zip->algo](zip);
 }
@@ -89,3 +143,48 @@ tb_long_t tb_zip_spak(tb_zip_ref_t zip, tb_static_stream_ref_t ist, tb_static_st
     return zip->spak(zip, ist, ost, sync);
 }
 
+tb_bool_t tb_zip_algo_supported(tb_size_t algo)
+{
+    switch (algo)
+    {
+#ifdef TB_CONFIG_PACKAGE_HAVE_ZLIB
+    case TB_ZIP_ALGO_ZLIBRAW:
+    case TB_ZIP_ALGO_ZLIB:
+    case TB_ZIP_ALGO_GZIP:
+        return tb_true;
+#endif
+#ifdef TB_CONFIG_PACKAGE_HAVE_ZSTD
+    case TB_ZIP_ALGO_ZSTD:
+        return tb_true;
+#endif
+#ifdef TB_CONFIG_PACKAGE_HAVE_LZ4
+    case TB_ZIP_ALGO_LZ4:
+        return tb_true;
+#endif
+#ifdef TB_CONFIG_PACKAGE_HAVE_BROTLI
+    case TB_ZIP_ALGO_BROTLI:
+        return tb_true;
+#endif
+    default:
+        break;
+    }
+    return tb_false;
+}
+tb_char_t const* tb_zip_algo_name(tb_size_t algo)
+{
+    // the names
+    static tb_char_t const* s_names[] =
+    {
+        "none"
+    ,   "zlibraw"
+    ,   "zlib"
+    ,   "gzip"
+    ,   "zstd"
+    ,   "lz4"
+    ,   "brotli"
+    };
+    tb_assert_and_check_return_val(algo < tb_arrayn(s_names), tb_null);
+
+    // the name
+    return s_names[algo];
+}
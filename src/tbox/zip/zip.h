@@ -48,6 +48,38 @@ __tb_extern_c_enter__
  */
 tb_zip_ref_t        tb_zip_init(tb_size_t algo, tb_size_t action);
 
+/*! init zip with the given option
+ *
+ * @code
+    tb_zip_option_t option = {0};
+    option.level = 19;
+    tb_zip_ref_t zip = tb_zip_init_with_option(TB_ZIP_ALGO_ZSTD, TB_ZIP_ACTION_DEFLATE, &option);
+ * @endcode
+ *
+ * @param algo      the zip zlgo
+ * @param action    the zip action
+ * @param option    the zip option, using the default option if be null
+ *
+ * @return          the zip
+ */
+tb_zip_ref_t        tb_zip_init_with_option(tb_size_t algo, tb_size_t action, tb_zip_option_ref_t option);
+
+/*! the zip algorithm is supported in the current build?
+ *
+ * @param algo      the zip zlgo
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_zip_algo_supported(tb_size_t algo);
+
+/*! the algorithm name
+ *
+ * @param algo      the zip zlgo
+ *
+ * @return          the name, .e.g "gzip", "zstd", ...
+ */
+tb_char_t const*    tb_zip_algo_name(tb_size_t algo);
+
 /*! exit zip
  *
  * @param zip       the zip
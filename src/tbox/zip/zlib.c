@@ -48,10 +48,9 @@ static tb_long_t tb_zip_zlib_spak_deflate(tb_zip_ref_t zip, tb_static_stream_ref
     tb_zip_zlib_t* zlib = tb_zip_zlib_cast(zip);
     tb_assert_and_check_return_val(zlib && ist && ost, -1);
 
-    // the input stream
+    // the input stream, @note maybe null for flush the end data
     tb_byte_t* ip = ist->p;
     tb_byte_t* ie = ist->e;
-    tb_check_return_val(ip && ip < ie, 0);
 
     // the output stream
     tb_byte_t* op = ost->p;
@@ -66,9 +65,12 @@ static tb_long_t tb_zip_zlib_spak_deflate(tb_zip_ref_t zip, tb_static_stream_ref
     zlib->zstream.avail_out = (uInt)(oe - op);
 
     // deflate 
-    tb_int_t r = deflate(&zlib->zstream, !sync? Z_NO_FLUSH : Z_SYNC_FLUSH);
+    tb_int_t r = deflate(&zlib->zstream, sync > 0? Z_SYNC_FLUSH : (sync < 0? Z_FINISH : Z_NO_FLUSH));
+
+    // no progress? it is not fatal if there is nothing to be flushed
+    if (r == Z_BUF_ERROR) r = Z_OK;
     tb_assertf_and_check_return_val(r == Z_OK || r == Z_STREAM_END, -1, "sync: %ld, error: %d", sync, r);
-    tb_trace_d("deflate: %u => %u, sync: %ld", ie - ip, (tb_byte_t*)zlib->zstream.next_out - op, sync);
+    tb_trace_d("deflate: %u => %u, sync: %ld", (tb_size_t)(ie - ip), (tb_size_t)((tb_byte_t*)zlib->zstream.next_out - op), sync);
 
     // update 
     ist->p = (tb_byte_t*)zlib->zstream.next_in;
@@ -95,6 +97,27 @@ static tb_long_t tb_zip_zlib_spak_inflate(tb_zip_ref_t zip, tb_static_stream_ref
     tb_byte_t* oe = ost->e;
     tb_assert_and_check_return_val(op && oe, -1);
 
+    /* detect the data format from the first byte
+     *
+     * the zlib deflater makes the zlib format, but we need also inflate the raw deflate data as before.
+     * the zlib header is cmf: 0x?8 (cinfo <= 7), the raw deflate data never starts with it, 
+     * because it will be a stored block with the non-zero padding bits
+     */
+    if (!zlib->detected)
+    {
+        if ((ip[0] & 0x0f) == Z_DEFLATED && (ip[0] >> 4) <= 7)
+        {
+            // reset zstream to inflate the zlib format, the dictionary will be set after inflate returns Z_NEED_DICT
+            if (inflateReset2(&zlib->zstream, MAX_WBITS) != Z_OK) return -1;
+        }
+        else if (zlib->dict)
+        {
+            // init dictionary, the raw inflate need not wait for Z_NEED_DICT
+            if (inflateSetDictionary(&zlib->zstream, (Bytef const*)zlib->dict, (uInt)zlib->dict_size) != Z_OK) return -1;
+        }
+        zlib->detected = tb_true;
+    }
+
     // attach zstream
     zlib->zstream.next_in = (Bytef*)ip;
     zlib->zstream.avail_in = (uInt)(ie - ip);
@@ -104,6 +127,16 @@ static tb_long_t tb_zip_zlib_spak_inflate(tb_zip_ref_t zip, tb_static_stream_ref
 
     // inflate 
     tb_int_t r = inflate(&zlib->zstream, !sync? Z_NO_FLUSH : Z_SYNC_FLUSH);
+
+    // need dictionary? set it and inflate it again
+    if (r == Z_NEED_DICT && zlib->dict)
+    {
+        r = inflateSetDictionary(&zlib->zstream, (Bytef const*)zlib->dict, (uInt)zlib->dict_size);
+        if (r == Z_OK) r = inflate(&zlib->zstream, !sync? Z_NO_FLUSH : Z_SYNC_FLUSH);
+
+        // no more input after the dictionary id? it is not fatal
+        if (r == Z_BUF_ERROR) r = Z_OK;
+    }
     tb_assertf_and_check_return_val(r == Z_OK || r == Z_STREAM_END, -1, "sync: %ld, error: %d", sync, r);
     tb_trace_d("inflate: %u => %u, sync: %ld", ie - ip, (tb_byte_t*)zlib->zstream.next_out - op, sync);
 
@@ -121,7 +154,7 @@ static tb_long_t tb_zip_zlib_spak_inflate(tb_zip_ref_t zip, tb_static_stream_ref
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
-tb_zip_ref_t tb_zip_zlib_init(tb_size_t action)
+tb_zip_ref_t tb_zip_zlib_init(tb_size_t action, tb_zip_option_ref_t option)
 {   
     // done
     tb_bool_t       ok = tb_false;
@@ -135,22 +168,39 @@ tb_zip_ref_t tb_zip_zlib_init(tb_size_t action)
         // init algo
         zip->base.algo = TB_ZIP_ALGO_ZLIB;
 
+        // init level
+        tb_int_t level = Z_DEFAULT_COMPRESSION;
+        if (option && option->level != TB_ZIP_LEVEL_DEFAULT) level = (tb_int_t)tb_min(tb_max(option->level, Z_NO_COMPRESSION), Z_BEST_COMPRESSION);
+
         // open zstream
         if (action == TB_ZIP_ACTION_INFLATE)
         {
             // init spak
             zip->base.spak = tb_zip_zlib_spak_inflate;
 
-            // init zstream, skip zlib header, only inflate raw data
+            // init zstream for the raw data, it will be reset if the zlib header is detected
             if (inflateInit2(&((tb_zip_zlib_t*)zip)->zstream, -MAX_WBITS) != Z_OK) break;
+
+            // save dictionary, it will be set after detecting the data format
+            if (option && option->dict && option->dict_size)
+            {
+                zip->dict       = option->dict;
+                zip->dict_size  = option->dict_size;
+            }
         }
         else if (action == TB_ZIP_ACTION_DEFLATE)
         {
             // init spak
             zip->base.spak = tb_zip_zlib_spak_deflate;
 
-            // init zstream
-            if (deflateInit(&((tb_zip_zlib_t*)zip)->zstream, Z_DEFAULT_COMPRESSION) != Z_OK) break;
+            // init zstream with the zlib header, the same format as the zlibraw deflater and the zlib inflater will detect it
+            if (deflateInit2(&((tb_zip_zlib_t*)zip)->zstream, level, Z_DEFLATED, MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) break;
+
+            // init dictionary
+            if (option && option->dict && option->dict_size)
+            {
+                if (deflateSetDictionary(&((tb_zip_zlib_t*)zip)->zstream, (Bytef const*)option->dict, (uInt)option->dict_size) != Z_OK) break;
+            }
         }
 
         // init action after initializing zstream
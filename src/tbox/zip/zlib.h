@@ -54,6 +54,15 @@ typedef struct __tb_zip_zlib_t
     z_stream        zstream;
 #endif
 
+    // the inflated data format have been detected? 
+    tb_bool_t       detected;
+
+    // the dictionary for inflating
+    tb_byte_t const* dict;
+
+    // the dictionary size
+    tb_size_t       dict_size;
+
 }tb_zip_zlib_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -63,10 +72,11 @@ typedef struct __tb_zip_zlib_t
 /* init zlib 
  *
  * @param action    the action
+ * @param option    the option, maybe null
  *
  * @return          the zip
  */
-tb_zip_ref_t        tb_zip_zlib_init(tb_size_t action);
+tb_zip_ref_t        tb_zip_zlib_init(tb_size_t action, tb_zip_option_ref_t option);
 
 /* exit zlib
  *
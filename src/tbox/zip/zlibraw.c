@@ -47,10 +47,9 @@ static tb_long_t tb_zip_zlibraw_spak_deflate(tb_zip_ref_t zip, tb_static_stream_
     tb_zip_zlibraw_t* zlibraw = tb_zip_zlibraw_cast(zip);
     tb_assert_and_check_return_val(zlibraw && ist && ost, -1);
 
-    // the input stream
+    // the input stream, @note maybe null for flush the end data
     tb_byte_t* ip = ist->p;
     tb_byte_t* ie = ist->e;
-    tb_check_return_val(ip && ip < ie, 0);
 
     // the output stream
     tb_byte_t* op = ost->p;
@@ -65,9 +64,12 @@ static tb_long_t tb_zip_zlibraw_spak_deflate(tb_zip_ref_t zip, tb_static_stream_
     zlibraw->zstream.avail_out = (uInt)(oe - op);
 
     // deflate 
-    tb_int_t r = deflate(&zlibraw->zstream, !sync? Z_NO_FLUSH : Z_SYNC_FLUSH);
+    tb_int_t r = deflate(&zlibraw->zstream, sync > 0? Z_SYNC_FLUSH : (sync < 0? Z_FINISH : Z_NO_FLUSH));
+
+    // no progress? it is not fatal if there is nothing to be flushed
+    if (r == Z_BUF_ERROR) r = Z_OK;
     tb_assertf_and_check_return_val(r == Z_OK || r == Z_STREAM_END, -1, "sync: %ld, error: %d", sync, r);
-    tb_trace_d("deflate: %u => %u, sync: %ld", ie - ip, (tb_byte_t*)zlibraw->zstream.next_out - op, sync);
+    tb_trace_d("deflate: %u => %u, sync: %ld", (tb_size_t)(ie - ip), (tb_size_t)((tb_byte_t*)zlibraw->zstream.next_out - op), sync);
 
     // update 
     ist->p = (tb_byte_t*)zlibraw->zstream.next_in;
@@ -103,6 +105,16 @@ static tb_long_t tb_zip_zlibraw_spak_inflate(tb_zip_ref_t zip, tb_static_stream_
 
     // inflate 
     tb_int_t r = inflate(&zlibraw->zstream, !sync? Z_NO_FLUSH : Z_SYNC_FLUSH);
+
+    // need dictionary? set it and inflate it again
+    if (r == Z_NEED_DICT && zlibraw->dict)
+    {
+        r = inflateSetDictionary(&zlibraw->zstream, (Bytef const*)zlibraw->dict, (uInt)zlibraw->dict_size);
+        if (r == Z_OK) r = inflate(&zlibraw->zstream, !sync? Z_NO_FLUSH : Z_SYNC_FLUSH);
+
+        // no more input after the dictionary id? it is not fatal
+        if (r == Z_BUF_ERROR) r = Z_OK;
+    }
     tb_assertf_and_check_return_val(r == Z_OK || r == Z_STREAM_END, -1, "sync: %ld, error: %d", sync, r);
     tb_trace_d("inflate: %u => %u, sync: %ld", ie - ip, (tb_byte_t*)zlibraw->zstream.next_out - op, sync);
 
@@ -120,7 +132,7 @@ static tb_long_t tb_zip_zlibraw_spak_inflate(tb_zip_ref_t zip, tb_static_stream_
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
-tb_zip_ref_t tb_zip_zlibraw_init(tb_size_t action)
+tb_zip_ref_t tb_zip_zlibraw_init(tb_size_t action, tb_zip_option_ref_t option)
 {   
     // done
     tb_bool_t           ok = tb_false;
@@ -134,6 +146,10 @@ tb_zip_ref_t tb_zip_zlibraw_init(tb_size_t action)
         // init algo
         zip->base.algo = TB_ZIP_ALGO_ZLIBRAW;
 
+        // init level
+        tb_int_t level = Z_DEFAULT_COMPRESSION;
+        if (option && option->level != TB_ZIP_LEVEL_DEFAULT) level = (tb_int_t)tb_min(tb_max(option->level, Z_NO_COMPRESSION), Z_BEST_COMPRESSION);
+
         // open zstream
         if (action == TB_ZIP_ACTION_INFLATE)
         {
@@ -142,6 +158,13 @@ tb_zip_ref_t tb_zip_zlibraw_init(tb_size_t action)
 
             // init zstream, no zlib header
             if (inflateInit(&((tb_zip_zlibraw_t*)zip)->zstream) != Z_OK) break;
+
+            // save dictionary, it will be set after inflate returns Z_NEED_DICT
+            if (option && option->dict && option->dict_size)
+            {
+                zip->dict       = option->dict;
+                zip->dict_size  = option->dict_size;
+            }
         }
         else if (action == TB_ZIP_ACTION_DEFLATE)
         {
@@ -149,7 +172,13 @@ tb_zip_ref_t tb_zip_zlibraw_init(tb_size_t action)
             zip->base.spak = tb_zip_zlibraw_spak_deflate;
 
             // init zstream
-            if (deflateInit(&((tb_zip_zlibraw_t*)zip)->zstream, Z_DEFAULT_COMPRESSION) != Z_OK) break;
+            if (deflateInit(&((tb_zip_zlibraw_t*)zip)->zstream, level) != Z_OK) break;
+
+            // init dictionary
+            if (option && option->dict && option->dict_size)
+            {
+                if (deflateSetDictionary(&((tb_zip_zlibraw_t*)zip)->zstream, (Bytef const*)option->dict, (uInt)option->dict_size) != Z_OK) break;
+            }
         }
 
         // init action after initializing zstream
@@ -54,6 +54,12 @@ typedef struct __tb_zip_zlibraw_t
     z_stream        zstream;
 #endif
 
+    // the dictionary for inflating
+    tb_byte_t const* dict;
+
+    // the dictionary size
+    tb_size_t       dict_size;
+
 }tb_zip_zlibraw_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -63,10 +69,11 @@ typedef struct __tb_zip_zlibraw_t
 /* init zlibraw 
  *
  * @param action    the action
+ * @param option    the option, maybe null
  *
  * @return          the zip
  */
-tb_zip_ref_t        tb_zip_zlibraw_init(tb_size_t action);
+tb_zip_ref_t        tb_zip_zlibraw_init(tb_size_t action, tb_zip_option_ref_t option);
 
 /* exit zlibraw
  *
@@ -0,0 +1,213 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        zstd.c
+ * @ingroup     zip
+ *
+ */
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "zstd"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "zstd.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implements
+ */
+static __tb_inline__ tb_zip_zstd_t* tb_zip_zstd_cast(tb_zip_ref_t zip)
+{
+    // check
+    tb_assert_and_check_return_val(zip && zip->algo == TB_ZIP_ALGO_ZSTD, tb_null);
+
+    // cast it
+    return (tb_zip_zstd_t*)zip;
+}
+static tb_long_t tb_zip_zstd_spak_deflate(tb_zip_ref_t zip, tb_static_stream_ref_t ist, tb_static_stream_ref_t ost, tb_long_t sync)
+{
+    // check
+    tb_zip_zstd_t* zstd = tb_zip_zstd_cast(zip);
+    tb_assert_and_check_return_val(zstd && zstd->cstream && ist && ost, -1);
+
+    // ended? 
+    tb_check_return_val(!zstd->bended, -1);
+
+    // the input stream, @note maybe null for flush the end data
+    tb_byte_t* ip = ist->p;
+    tb_byte_t* ie = ist->e;
+
+    // the output stream
+    tb_byte_t* op = ost->p;
+    tb_byte_t* oe = ost->e;
+    tb_assert_and_check_return_val(op && oe, -1);
+
+    // attach buffers
+    ZSTD_inBuffer  ibuf = {ip, ip? (tb_size_t)(ie - ip) : 0, 0};
+    ZSTD_outBuffer obuf = {op, (tb_size_t)(oe - op), 0};
+
+    // deflate 
+    tb_size_t r = ZSTD_compressStream2(zstd->cstream, &obuf, &ibuf, sync > 0? ZSTD_e_flush : (sync < 0? ZSTD_e_end : ZSTD_e_continue));
+    tb_assertf_and_check_return_val(!ZSTD_isError(r), -1, "sync: %ld, error: %s", sync, ZSTD_getErrorName(r));
+    tb_trace_d("deflate: %lu => %lu, sync: %ld", ibuf.pos, obuf.pos, sync);
+
+    // update 
+    if (ip) ist->p = ip + ibuf.pos;
+    ost->p = op + obuf.pos;
+
+    // the frame has been ended and flushed? 
+    if (sync < 0 && !r) zstd->bended = tb_true;
+
+    // end?
+    tb_check_return_val(!zstd->bended || ost->p > op, -1);
+
+    // ok?
+    return (ost->p - op);
+}
+static tb_long_t tb_zip_zstd_spak_inflate(tb_zip_ref_t zip, tb_static_stream_ref_t ist, tb_static_stream_ref_t ost, tb_long_t sync)
+{
+    // check
+    tb_zip_zstd_t* zstd = tb_zip_zstd_cast(zip);
+    tb_assert_and_check_return_val(zstd && zstd->dstream && ist && ost, -1);
+
+    // the input stream, @note maybe null for flushing the buffered output data if sync
+    tb_byte_t* ip = ist->p;
+    tb_byte_t* ie = ist->e;
+    tb_check_return_val((ip && ip < ie) || sync, 0);
+
+    // the output stream
+    tb_byte_t* op = ost->p;
+    tb_byte_t* oe = ost->e;
+    tb_assert_and_check_return_val(op && oe, -1);
+
+    // attach buffers
+    ZSTD_inBuffer  ibuf = {ip, ip? (tb_size_t)(ie - ip) : 0, 0};
+    ZSTD_outBuffer obuf = {op, (tb_size_t)(oe - op), 0};
+
+    // inflate 
+    tb_size_t r = ZSTD_decompressStream(zstd->dstream, &obuf, &ibuf);
+    tb_assertf_and_check_return_val(!ZSTD_isError(r), -1, "sync: %ld, error: %s", sync, ZSTD_getErrorName(r));
+    tb_trace_d("inflate: %lu => %lu, sync: %ld", ibuf.pos, obuf.pos, sync);
+
+    // update 
+    if (ip) ist->p = ip + ibuf.pos;
+    ost->p = op + obuf.pos;
+
+    // end? the frame has been decoded and flushed completely
+    tb_check_return_val(r || ost->p > op, -1);
+
+    // ok?
+    return (ost->p - op);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_zip_ref_t tb_zip_zstd_init(tb_size_t action, tb_zip_option_ref_t option)
+{   
+    // done
+    tb_bool_t       ok = tb_false;
+    tb_zip_zstd_t*  zip = tb_null;
+    do
+    {
+        // make zip
+        zip = tb_malloc0_type(tb_zip_zstd_t);
+        tb_assert_and_check_break(zip);
+        
+        // init algo
+        zip->base.algo = TB_ZIP_ALGO_ZSTD;
+
+        // open stream
+        if (action == TB_ZIP_ACTION_INFLATE)
+        {
+            // init spak
+            zip->base.spak = tb_zip_zstd_spak_inflate;
+
+            // init dstream
+            zip->dstream = ZSTD_createDStream();
+            tb_assert_and_check_break(zip->dstream);
+
+            // init dictionary
+            if (option && option->dict && option->dict_size)
+            {
+                if (ZSTD_isError(ZSTD_DCtx_loadDictionary(zip->dstream, option->dict, option->dict_size))) break;
+            }
+        }
+        else if (action == TB_ZIP_ACTION_DEFLATE)
+        {
+            // init spak
+            zip->base.spak = tb_zip_zstd_spak_deflate;
+
+            // init cstream
+            zip->cstream = ZSTD_createCStream();
+            tb_assert_and_check_break(zip->cstream);
+
+            // init level
+            if (option && option->level != TB_ZIP_LEVEL_DEFAULT)
+            {
+                tb_int_t level = (tb_int_t)tb_min(tb_max(option->level, ZSTD_minCLevel()), ZSTD_maxCLevel());
+                if (ZSTD_isError(ZSTD_CCtx_setParameter(zip->cstream, ZSTD_c_compressionLevel, level))) break;
+            }
+
+            // init dictionary
+            if (option && option->dict && option->dict_size)
+            {
+                if (ZSTD_isError(ZSTD_CCtx_loadDictionary(zip->cstream, option->dict, option->dict_size))) break;
+            }
+        }
+
+        // init action after initializing stream
+        zip->base.action = (tb_uint16_t)action;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (zip) tb_zip_zstd_exit((tb_zip_ref_t)zip);
+        zip = tb_null;
+    }
+
+    // ok?
+    return (tb_zip_ref_t)zip;
+}
+tb_void_t tb_zip_zstd_exit(tb_zip_ref_t zip)
+{
+    // check
+    tb_zip_zstd_t* zstd = tb_zip_zstd_cast(zip);
+    tb_assert_and_check_return(zstd);
+
+    // exit stream
+    if (zstd->cstream) ZSTD_freeCStream(zstd->cstream);
+    zstd->cstream = tb_null;
+    if (zstd->dstream) ZSTD_freeDStream(zstd->dstream);
+    zstd->dstream = tb_null;
+
+    // free it
+    tb_free(zstd);
+}
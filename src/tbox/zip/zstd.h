@@ -0,0 +1,87 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        zstd.h
+ * @ingroup     zip
+ *
+ */
+#ifndef TB_ZIP_ZSTD_H
+#define TB_ZIP_ZSTD_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#ifdef TB_CONFIG_PACKAGE_HAVE_ZSTD
+#   include <zstd.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the zstd zip type
+typedef struct __tb_zip_zstd_t
+{
+    // the zip base
+    tb_zip_t        base;
+
+    // the cstream and dstream
+#ifdef TB_CONFIG_PACKAGE_HAVE_ZSTD
+    ZSTD_CStream*   cstream;
+    ZSTD_DStream*   dstream;
+#endif
+
+    // the frame has been ended?
+    tb_bool_t       bended;
+
+}tb_zip_zstd_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* init zstd 
+ *
+ * @param action    the action
+ * @param option    the option, maybe null
+ *
+ * @return          the zip
+ */
+tb_zip_ref_t        tb_zip_zstd_init(tb_size_t action, tb_zip_option_ref_t option);
+
+/* exit zstd
+ *
+ * @param zip       the zip
+ */
+tb_void_t           tb_zip_zstd_exit(tb_zip_ref_t zip);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -94,7 +94,7 @@ option("base")
     else add_links("pthread", "dl", "m", "c") end
 
 -- add packages
-for _, name in ipairs({"zlib", "mysql", "sqlite3", "openssl", "polarssl", "mbedtls", "pcre2", "pcre"}) do
+for _, name in ipairs({"zlib", "zstd", "lz4", "brotli", "mysql", "sqlite3", "openssl", "polarssl", "mbedtls", "pcre2", "pcre"}) do
     option(name)
         set_showmenu(true)
         set_category("package")
@@ -199,6 +199,7 @@ function check_interfaces()
     add_cfuncs("posix", nil,        "ifaddrs.h",                        "getifaddrs")
     add_cfuncs("posix", nil,        "semaphore.h",                      "sem_init")
     add_cfuncs("posix", nil,        "unistd.h",                         "getpagesize", "sysconf")
+    add_cfuncs("posix", nil,        "sys/mman.h",                       "mmap", "madvise")
     add_cfuncs("posix", nil,        "sched.h",                          "sched_yield")
     add_cfuncs("posix", nil,        "regex.h",                          "regcomp", "regexec")
     add_cfuncs("posix", nil,        "sys/uio.h",                        "readv", "writev", "preadv", "pwritev")
@@ -206,7 +207,9 @@ function check_interfaces()
     add_cfuncs("posix", nil,        "unistd.h",                         "fdatasync")
     add_cfuncs("posix", nil,        "copyfile.h",                       "copyfile")
     add_cfuncs("posix", nil,        "sys/sendfile.h",                   "sendfile")
+    add_cfuncs("posix", nil,        "sys/socket.h",                     "recvmmsg", "sendmmsg")
     add_cfuncs("posix", nil,        "sys/epoll.h",                      "epoll_create", "epoll_wait")
+    add_cfuncs("posix", nil,        "sys/eventfd.h",                    "eventfd")
     add_cfuncs("posix", nil,        "spawn.h",                          "posix_spawnp")
     add_cfuncs("posix", nil,        "unistd.h",                         "execvp", "execvpe", "fork", "vfork")
     add_cfuncs("posix", nil,        "sys/wait.h",                       "waitpid")